@@ -0,0 +1,97 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2010 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkExtractPlaneCrossingCells.h"
+
+// VTK includes
+#include <vtkCutter.h>
+#include <vtkNew.h>
+#include <vtkPlane.h>
+#include <vtkPolyData.h>
+#include <vtkSphereSource.h>
+
+//----------------------------------------------------------------------------
+namespace
+{
+
+//----------------------------------------------------------------------------
+vtkIdType GetNumberOfIntersectionPoints(vtkAlgorithmOutput* inputConnection, vtkPlane* plane)
+{
+  vtkNew<vtkCutter> cutter;
+  cutter->SetCutFunction(plane);
+  cutter->SetInputConnection(inputConnection);
+  cutter->Update();
+  return cutter->GetOutput()->GetNumberOfPoints();
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkExtractPlaneCrossingCellsTest1(int, char*[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetRadius(50.0);
+  sphere->SetThetaResolution(120);
+  sphere->SetPhiResolution(120);
+  sphere->Update();
+  vtkIdType numberOfSphereCells = sphere->GetOutput()->GetNumberOfCells();
+
+  vtkNew<vtkPlane> plane;
+  plane->SetNormal(0.0, 0.0, 1.0);
+  plane->SetOrigin(0.0, 0.0, 0.0);
+
+  vtkNew<vtkExtractPlaneCrossingCells> extractor;
+  extractor->SetInputConnection(sphere->GetOutputPort());
+  extractor->SetPlane(plane);
+  extractor->Update();
+  CHECK_INT(extractor->GetNumberOfIndexBuilds(), 1);
+  CHECK_BOOL(extractor->GetNumberOfExtractedCells() > 0, true);
+  CHECK_BOOL(extractor->GetNumberOfExtractedCells() < numberOfSphereCells / 10, true);
+  CHECK_INT(GetNumberOfIntersectionPoints(extractor->GetOutputPort(), plane), GetNumberOfIntersectionPoints(sphere->GetOutputPort(), plane));
+
+  // Moving the plane along its normal must not rebuild the index
+  for (double offset = -60.0; offset <= 60.0; offset += 7.5)
+  {
+    plane->SetOrigin(0.0, 0.0, offset);
+    extractor->Update();
+    CHECK_INT(GetNumberOfIntersectionPoints(extractor->GetOutputPort(), plane), GetNumberOfIntersectionPoints(sphere->GetOutputPort(), plane));
+  }
+  CHECK_INT(extractor->GetNumberOfIndexBuilds(), 1);
+
+  // Plane outside the mesh
+  plane->SetOrigin(0.0, 0.0, 100.0);
+  extractor->Update();
+  CHECK_INT(extractor->GetNumberOfExtractedCells(), 0);
+
+  // Rotating the plane rebuilds the index
+  plane->SetNormal(1.0, 1.0, 0.0);
+  plane->SetOrigin(10.0, 5.0, 0.0);
+  extractor->Update();
+  CHECK_INT(extractor->GetNumberOfIndexBuilds(), 2);
+  CHECK_INT(GetNumberOfIntersectionPoints(extractor->GetOutputPort(), plane), GetNumberOfIntersectionPoints(sphere->GetOutputPort(), plane));
+
+  // Modifying the input mesh rebuilds the index
+  sphere->SetCenter(3.0, 0.0, 0.0);
+  extractor->Update();
+  CHECK_INT(extractor->GetNumberOfIndexBuilds(), 3);
+  CHECK_INT(GetNumberOfIntersectionPoints(extractor->GetOutputPort(), plane), GetNumberOfIntersectionPoints(sphere->GetOutputPort(), plane));
+
+  // Without plane the input is passed through
+  extractor->SetPlane(nullptr);
+  extractor->Update();
+  CHECK_INT(extractor->GetNumberOfExtractedCells(), numberOfSphereCells);
+
+  extractor->Print(std::cout);
+  return EXIT_SUCCESS;
+}
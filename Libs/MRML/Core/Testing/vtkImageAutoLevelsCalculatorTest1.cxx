@@ -0,0 +1,398 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkImageAutoLevelsCalculator.h"
+#include "vtkMRMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkImageHistogramStatistics.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Create an image that resembles a CT: air background, body (soft tissue) cylinder with noise and a bright
+/// sphere in it (e.g., contrast-filled heart). Sphere radius varies with frameIndex to simulate cardiac motion.
+vtkSmartPointer<vtkImageData> CreateCTImage(int size[3], int frameIndex, unsigned int seed)
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(size);
+  image->AllocateScalars(VTK_SHORT, 1);
+  short* voxels = static_cast<short*>(image->GetScalarPointer());
+  std::mt19937 noiseGenerator(seed);
+  std::normal_distribution<double> noise(0.0, 20.0);
+  const double bodyRadius = 0.45 * size[0];
+  const double heartRadius = (0.15 + 0.03 * std::sin(frameIndex * 0.3)) * size[0];
+  for (int k = 0; k < size[2]; ++k)
+  {
+    for (int j = 0; j < size[1]; ++j)
+    {
+      for (int i = 0; i < size[0]; ++i)
+      {
+        const double x = i - 0.5 * size[0];
+        const double y = j - 0.5 * size[1];
+        const double z = k - 0.5 * size[2];
+        double value = -1000.0;
+        if (x * x + y * y < bodyRadius * bodyRadius)
+        {
+          value = (x * x + y * y + z * z < heartRadius * heartRadius ? 300.0 : 40.0);
+        }
+        *(voxels++) = static_cast<short>(value + noise(noiseGenerator));
+      }
+    }
+  }
+  return image;
+}
+
+//----------------------------------------------------------------------------
+/// Fraction of voxels that are below and at or below the given value.
+void GetPercentileRank(vtkImageData* image, double value, double& fractionBelow, double& fractionAtOrBelow)
+{
+  vtkDataArray* scalars = image->GetPointData()->GetScalars();
+  vtkIdType below = 0;
+  vtkIdType atOrBelow = 0;
+  vtkIdType count = 0;
+  for (vtkIdType index = 0; index < scalars->GetNumberOfTuples(); ++index)
+  {
+    double voxelValue = scalars->GetComponent(index, 0);
+    if (std::isnan(voxelValue))
+    {
+      continue;
+    }
+    below += (voxelValue < value);
+    atOrBelow += (voxelValue <= value);
+    ++count;
+  }
+  fractionBelow = static_cast<double>(below) / count;
+  fractionAtOrBelow = static_cast<double>(atOrBelow) / count;
+}
+
+//----------------------------------------------------------------------------
+int CheckPercentileError(vtkImageAutoLevelsCalculator* calculator, vtkImageData* image)
+{
+  const double maximumError = calculator->GetMaximumPercentileError() / 100.0;
+  for (int i = 0; i < 2; ++i)
+  {
+    double fractionBelow = 0.0;
+    double fractionAtOrBelow = 0.0;
+    GetPercentileRank(image, calculator->GetAutoRange()[i], fractionBelow, fractionAtOrBelow);
+    const double percentile = calculator->GetAutoRangePercentiles()[i] / 100.0;
+    CHECK_BOOL(fractionBelow <= percentile + maximumError, true);
+    CHECK_BOOL(fractionAtOrBelow >= percentile - maximumError, true);
+  }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestExactPercentiles()
+{
+  // Values 0..999, each occurring 100 times. Image is smaller than the required number of samples,
+  // therefore all voxels are used and the result is the exact nearest-rank percentile.
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(100, 100, 10);
+  image->AllocateScalars(VTK_UNSIGNED_SHORT, 1);
+  unsigned short* voxels = static_cast<unsigned short*>(image->GetScalarPointer());
+  for (vtkIdType index = 0; index < 100000; ++index)
+  {
+    voxels[index] = static_cast<unsigned short>((index * 7919) % 1000);
+  }
+  vtkNew<vtkImageAutoLevelsCalculator> calculator;
+  CHECK_BOOL(calculator->Compute(image), true);
+  CHECK_INT(calculator->GetNumberOfSamples(), 100000);
+  CHECK_DOUBLE(calculator->GetAutoRange()[0], 0.0);
+  CHECK_DOUBLE(calculator->GetAutoRange()[1], 998.0);
+
+  // Floating-point image with NaN values
+  vtkNew<vtkImageData> floatImage;
+  floatImage->SetDimensions(100, 100, 10);
+  floatImage->AllocateScalars(VTK_FLOAT, 1);
+  float* floatVoxels = static_cast<float*>(floatImage->GetScalarPointer());
+  for (vtkIdType index = 0; index < 100000; ++index)
+  {
+    floatVoxels[index] = (index % 10 == 0 ? std::numeric_limits<float>::quiet_NaN() : static_cast<float>(index % 1000) * 0.5f);
+  }
+  CHECK_BOOL(calculator->Compute(floatImage), true);
+  CHECK_EXIT_SUCCESS(CheckPercentileError(calculator, floatImage));
+
+  // Image without scalars
+  vtkNew<vtkImageData> emptyImage;
+  CHECK_BOOL(calculator->Compute(emptyImage), false);
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestSampledPercentilesAndCache()
+{
+  int size[3] = { 256, 256, 128 };
+  vtkSmartPointer<vtkImageData> image = CreateCTImage(size, 0, 1);
+  vtkNew<vtkImageAutoLevelsCalculator> calculator;
+  // Previous result is only reused if requested (e.g., for sequence frames)
+  CHECK_BOOL(calculator->GetReusePreviousResult(), false);
+  calculator->ReusePreviousResultOn();
+  calculator->Compute(image);
+  CHECK_BOOL(calculator->GetNumberOfSamples() < image->GetNumberOfPoints(), true);
+  CHECK_INT(calculator->GetNumberOfSamples(), calculator->GetRequiredNumberOfSamples());
+  CHECK_EXIT_SUCCESS(CheckPercentileError(calculator, image));
+  CHECK_INT(calculator->GetNumberOfHistogramComputations(), 1);
+
+  // Computation is deterministic
+  vtkNew<vtkImageAutoLevelsCalculator> calculator2;
+  calculator2->Compute(image);
+  CHECK_DOUBLE(calculator2->GetAutoRange()[0], calculator->GetAutoRange()[0]);
+  CHECK_DOUBLE(calculator2->GetAutoRange()[1], calculator->GetAutoRange()[1]);
+
+  // Unchanged image: cached result is used
+  calculator->Compute(image);
+  CHECK_INT(calculator->GetNumberOfCachedResults(), 1);
+  CHECK_INT(calculator->GetNumberOfHistogramComputations(), 1);
+
+  // Small change: previous result is reused
+  short* voxels = static_cast<short*>(image->GetScalarPointer());
+  for (vtkIdType index = 0; index < image->GetNumberOfPoints(); index += 1000)
+  {
+    voxels[index] += 5;
+  }
+  image->GetPointData()->GetScalars()->Modified();
+  calculator->Compute(image);
+  CHECK_INT(calculator->GetNumberOfReusedResults(), 1);
+  CHECK_INT(calculator->GetNumberOfHistogramComputations(), 1);
+
+  // Without reuse the result only depends on the image
+  vtkNew<vtkImageAutoLevelsCalculator> calculatorWithoutReuse;
+  calculatorWithoutReuse->Compute(image);
+  for (vtkIdType index = 0; index < image->GetNumberOfPoints(); index += 1000)
+  {
+    voxels[index] -= 5;
+  }
+  image->GetPointData()->GetScalars()->Modified();
+  calculatorWithoutReuse->Compute(image);
+  CHECK_INT(calculatorWithoutReuse->GetNumberOfReusedResults(), 0);
+  CHECK_INT(calculatorWithoutReuse->GetNumberOfHistogramComputations(), 2);
+  calculator2->ResetCache();
+  calculator2->Compute(image);
+  CHECK_DOUBLE(calculatorWithoutReuse->GetAutoRange()[0], calculator2->GetAutoRange()[0]);
+  CHECK_DOUBLE(calculatorWithoutReuse->GetAutoRange()[1], calculator2->GetAutoRange()[1]);
+
+  // Large change: histogram is computed again
+  for (vtkIdType index = 0; index < image->GetNumberOfPoints(); ++index)
+  {
+    voxels[index] = static_cast<short>(voxels[index] / 2);
+  }
+  image->GetPointData()->GetScalars()->Modified();
+  calculator->Compute(image);
+  CHECK_INT(calculator->GetNumberOfHistogramComputations(), 2);
+  CHECK_EXIT_SUCCESS(CheckPercentileError(calculator, image));
+
+  // Changing parameters invalidates the cache
+  calculator->SetAutoRangePercentiles(1.0, 99.0);
+  calculator->Compute(image);
+  CHECK_INT(calculator->GetNumberOfHistogramComputations(), 3);
+  CHECK_EXIT_SUCCESS(CheckPercentileError(calculator, image));
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+/// Check that the range differs from the range computed by vtkImageHistogramStatistics
+/// (that was used for auto window/level before) by at most the allowed percentile error
+/// plus the histogram bin size of vtkImageHistogramStatistics.
+int CheckRangeAgainstHistogramStatistics(vtkImageData* image)
+{
+  vtkNew<vtkImageAutoLevelsCalculator> calculator;
+  CHECK_BOOL(calculator->Compute(image), true);
+
+  vtkNew<vtkImageHistogramStatistics> histogramStatistics;
+  histogramStatistics->SetAutoRangePercentiles(calculator->GetAutoRangePercentiles());
+  histogramStatistics->SetAutoRangeExpansionFactors(0.0, 0.0);
+  histogramStatistics->SetInputData(image);
+  histogramStatistics->Update();
+
+  // Sorted voxel values for computing the exact percentiles
+  vtkDataArray* scalars = image->GetPointData()->GetScalars();
+  std::vector<double> values;
+  values.reserve(scalars->GetNumberOfTuples());
+  for (vtkIdType index = 0; index < scalars->GetNumberOfTuples(); ++index)
+  {
+    values.push_back(scalars->GetComponent(index, 0));
+  }
+  std::sort(values.begin(), values.end());
+  const double lastIndex = static_cast<double>(values.size() - 1);
+
+  for (int i = 0; i < 2; ++i)
+  {
+    const double percentile = calculator->GetAutoRangePercentiles()[i] / 100.0;
+    const double maximumError = calculator->GetMaximumPercentileError() / 100.0;
+    const double lowestValue = values[static_cast<size_t>(std::max(0.0, percentile - maximumError) * lastIndex)];
+    const double highestValue = values[static_cast<size_t>(std::min(1.0, percentile + maximumError) * lastIndex)];
+    const double tolerance = (highestValue - lowestValue) + histogramStatistics->GetBinSpacing();
+    if (std::fabs(calculator->GetAutoRange()[i] - histogramStatistics->GetAutoRange()[i]) > tolerance)
+    {
+      std::cerr << "Auto range " << calculator->GetAutoRange()[i] << " differs from vtkImageHistogramStatistics result "
+                << histogramStatistics->GetAutoRange()[i] << " by more than " << tolerance << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestCompareWithHistogramStatistics()
+{
+  // CT-like image, where the range is computed from a subsample
+  int size[3] = { 128, 128, 128 };
+  vtkSmartPointer<vtkImageData> ctImage = CreateCTImage(size, 0, 3);
+  CHECK_EXIT_SUCCESS(CheckRangeAgainstHistogramStatistics(ctImage));
+
+  // Floating-point image with a skewed distribution
+  vtkNew<vtkImageData> floatImage;
+  floatImage->SetDimensions(128, 128, 64);
+  floatImage->AllocateScalars(VTK_FLOAT, 1);
+  float* floatVoxels = static_cast<float*>(floatImage->GetScalarPointer());
+  std::mt19937 generator(4);
+  std::exponential_distribution<float> distribution(0.01f);
+  for (vtkIdType index = 0; index < floatImage->GetNumberOfPoints(); ++index)
+  {
+    floatVoxels[index] = distribution(generator);
+  }
+  CHECK_EXIT_SUCCESS(CheckRangeAgainstHistogramStatistics(floatImage));
+
+  // Small integer image, where all voxels are used
+  vtkNew<vtkImageData> labelImage;
+  labelImage->SetDimensions(50, 50, 10);
+  labelImage->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  unsigned char* labelVoxels = static_cast<unsigned char*>(labelImage->GetScalarPointer());
+  for (vtkIdType index = 0; index < labelImage->GetNumberOfPoints(); ++index)
+  {
+    labelVoxels[index] = static_cast<unsigned char>((index * 31) % 7);
+  }
+  CHECK_EXIT_SUCCESS(CheckRangeAgainstHistogramStatistics(labelImage));
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestBenchmarkCT(int volumeSize)
+{
+  int size[3] = { volumeSize, volumeSize, volumeSize };
+  vtkSmartPointer<vtkImageData> image = CreateCTImage(size, 0, 2);
+  vtkNew<vtkTimerLog> timer;
+
+  vtkNew<vtkImageHistogramStatistics> histogramStatistics;
+  histogramStatistics->SetAutoRangePercentiles(0.1, 99.9);
+  histogramStatistics->SetAutoRangeExpansionFactors(0.0, 0.0);
+  histogramStatistics->SetInputData(image);
+  timer->StartTimer();
+  histogramStatistics->Update();
+  timer->StopTimer();
+  const double referenceTime = timer->GetElapsedTime();
+
+  vtkNew<vtkImageAutoLevelsCalculator> calculator;
+  timer->StartTimer();
+  calculator->Compute(image);
+  timer->StopTimer();
+  const double sampledTime = timer->GetElapsedTime();
+
+  std::cout << "CT " << volumeSize << "^3: vtkImageHistogramStatistics " << referenceTime * 1000.0 << " ms"
+            << " (range " << histogramStatistics->GetAutoRange()[0] << ", " << histogramStatistics->GetAutoRange()[1] << "),"
+            << " vtkImageAutoLevelsCalculator " << sampledTime * 1000.0 << " ms"
+            << " (range " << calculator->GetAutoRange()[0] << ", " << calculator->GetAutoRange()[1] << ", "
+            << calculator->GetNumberOfSamples() << " samples)" << std::endl;
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestBenchmarkCardiacSequence(int volumeSize)
+{
+  // 4D cardiac CT: 20 frames per cardiac cycle
+  int size[3] = { volumeSize / 2, volumeSize / 2, volumeSize / 4 };
+  const int numberOfFrames = 20;
+  std::vector<vtkSmartPointer<vtkImageData>> frames;
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+  {
+    frames.push_back(CreateCTImage(size, frameIndex, 100 + frameIndex));
+  }
+  vtkNew<vtkTimerLog> timer;
+
+  vtkNew<vtkImageHistogramStatistics> histogramStatistics;
+  histogramStatistics->SetAutoRangePercentiles(0.1, 99.9);
+  histogramStatistics->SetAutoRangeExpansionFactors(0.0, 0.0);
+  timer->StartTimer();
+  for (vtkImageData* frame : frames)
+  {
+    histogramStatistics->SetInputData(frame);
+    histogramStatistics->Update();
+  }
+  timer->StopTimer();
+  const double referenceTime = timer->GetElapsedTime();
+
+  // Playback: the same display node (and so the same calculator) is used for all frames
+  vtkNew<vtkImageAutoLevelsCalculator> calculator;
+  calculator->ReusePreviousResultOn();
+  timer->StartTimer();
+  for (vtkImageData* frame : frames)
+  {
+    calculator->Compute(frame);
+  }
+  timer->StopTimer();
+  const double sampledTime = timer->GetElapsedTime();
+  for (vtkImageData* frame : frames)
+  {
+    calculator->ResetCache();
+    calculator->Compute(frame);
+    CHECK_EXIT_SUCCESS(CheckPercentileError(calculator, frame));
+  }
+
+  std::cout << "Cardiac sequence " << numberOfFrames << " x " << size[0] << "x" << size[1] << "x" << size[2] << ":"
+            << " vtkImageHistogramStatistics " << referenceTime * 1000.0 / numberOfFrames << " ms/frame,"
+            << " vtkImageAutoLevelsCalculator " << sampledTime * 1000.0 / numberOfFrames << " ms/frame"
+            << " (" << calculator->GetNumberOfReusedResults() << " frames reused previous result)" << std::endl;
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkImageAutoLevelsCalculatorTest1(int argc, char* argv[])
+{
+  CHECK_EXIT_SUCCESS(TestExactPercentiles());
+  CHECK_EXIT_SUCCESS(TestSampledPercentilesAndCache());
+  CHECK_EXIT_SUCCESS(TestCompareWithHistogramStatistics());
+
+  // Benchmarks only run if requested by "--benchmark [volumeSize]" arguments.
+  // Default size of the CT volume is 512, frames of the cardiac sequence are half of this size.
+  if (argc > 1 && strcmp(argv[1], "--benchmark") == 0)
+  {
+    int volumeSize = (argc > 2 ? atoi(argv[2]) : 512);
+    CHECK_EXIT_SUCCESS(TestBenchmarkCT(volumeSize));
+    CHECK_EXIT_SUCCESS(TestBenchmarkCardiacSequence(volumeSize));
+  }
+  return EXIT_SUCCESS;
+}
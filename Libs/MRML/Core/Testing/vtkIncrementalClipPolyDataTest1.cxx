@@ -0,0 +1,204 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkImplicitInvertableBoolean.h"
+#include "vtkIncrementalClipPolyData.h"
+#include "vtkMRMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkClipPolyData.h>
+#include <vtkExtractPolyDataGeometry.h>
+#include <vtkImplicitBoolean.h>
+#include <vtkNew.h>
+#include <vtkPlane.h>
+#include <vtkPlaneSource.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkSphere.h>
+#include <vtkSphereSource.h>
+#include <vtkTimerLog.h>
+#include <vtkTransform.h>
+
+//----------------------------------------------------------------------------
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Compare output of vtkIncrementalClipPolyData with the VTK filter that it replaces
+int CheckSameAsReference(vtkIncrementalClipPolyData* clipper, vtkImplicitFunction* function)
+{
+  clipper->SetClipFunction(function);
+  clipper->Update();
+  vtkPolyData* output = clipper->GetOutput();
+
+  vtkSmartPointer<vtkPolyData> referenceOutput;
+  if (clipper->GetClippingMethod() == vtkIncrementalClipPolyData::Straight)
+  {
+    vtkNew<vtkClipPolyData> referenceClipper;
+    referenceClipper->SetInputConnection(clipper->GetInputConnection(0, 0));
+    referenceClipper->SetValue(0.0);
+    referenceClipper->SetClipFunction(function);
+    referenceClipper->Update();
+    referenceOutput = referenceClipper->GetOutput();
+  }
+  else
+  {
+    vtkNew<vtkExtractPolyDataGeometry> referenceExtractor;
+    referenceExtractor->SetInputConnection(clipper->GetInputConnection(0, 0));
+    referenceExtractor->SetImplicitFunction(function);
+    referenceExtractor->ExtractInsideOff();
+    referenceExtractor->SetExtractBoundaryCells(clipper->GetClippingMethod() == vtkIncrementalClipPolyData::WholeCellsWithBoundary);
+    referenceExtractor->Update();
+    referenceOutput = referenceExtractor->GetOutput();
+  }
+
+  CHECK_BOOL(output->GetNumberOfCells() > 0, true);
+  CHECK_INT(output->GetNumberOfPoints(), referenceOutput->GetNumberOfPoints());
+  CHECK_INT(output->GetNumberOfPolys(), referenceOutput->GetNumberOfPolys());
+  CHECK_INT(output->GetNumberOfCells(), referenceOutput->GetNumberOfCells());
+  CHECK_INT(output->GetPointData()->GetNumberOfArrays(), referenceOutput->GetPointData()->GetNumberOfArrays());
+  double bounds[6] = { 0.0 };
+  output->GetBounds(bounds);
+  double referenceBounds[6] = { 0.0 };
+  referenceOutput->GetBounds(referenceBounds);
+  for (int i = 0; i < 6; ++i)
+  {
+    CHECK_DOUBLE_TOLERANCE(bounds[i], referenceBounds[i], 1e-6);
+  }
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkIncrementalClipPolyDataTest1(int, char*[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetRadius(50.0);
+  sphere->SetThetaResolution(400);
+  sphere->SetPhiResolution(400);
+  sphere->Update();
+
+  vtkNew<vtkIncrementalClipPolyData> clipper;
+  clipper->SetInputConnection(sphere->GetOutputPort());
+
+  // No clip function, the input is passed through
+  clipper->Update();
+  CHECK_INT(clipper->GetOutput()->GetNumberOfCells(), sphere->GetOutput()->GetNumberOfCells());
+
+  // Clip function that is set up the same way as in vtkMRMLClipNode:
+  // intersection of invertable booleans containing planes
+  vtkNew<vtkPlane> plane1;
+  plane1->SetNormal(0.0, 0.0, 1.0);
+  plane1->SetOrigin(0.0, 0.0, 10.0);
+  vtkNew<vtkPlane> plane2;
+  plane2->SetNormal(1.0, 1.0, 0.0);
+  plane2->SetOrigin(-5.0, 0.0, 0.0);
+  vtkNew<vtkImplicitInvertableBoolean> plane1Boolean;
+  plane1Boolean->AddFunction(plane1);
+  vtkNew<vtkImplicitInvertableBoolean> plane2Boolean;
+  plane2Boolean->AddFunction(plane2);
+  plane2Boolean->InvertOn();
+  vtkNew<vtkImplicitBoolean> clipFunction;
+  clipFunction->SetOperationTypeToIntersection();
+  clipFunction->AddFunction(plane1Boolean);
+  clipFunction->AddFunction(plane2Boolean);
+
+  // Same result as VTK filters for all clipping methods, also with linear transform
+  const int clippingMethods[] = { vtkIncrementalClipPolyData::Straight, vtkIncrementalClipPolyData::WholeCells, vtkIncrementalClipPolyData::WholeCellsWithBoundary };
+  for (int clippingMethod : clippingMethods)
+  {
+    clipper->SetClippingMethod(clippingMethod);
+    clipFunction->SetTransform(static_cast<vtkAbstractTransform*>(nullptr));
+    CHECK_EXIT_SUCCESS(CheckSameAsReference(clipper, clipFunction));
+    CHECK_BOOL(clipper->GetClipFunctionEvaluated(), false);
+    vtkNew<vtkTransform> transform;
+    transform->Translate(3.0, -2.0, 5.0);
+    transform->RotateX(30.0);
+    transform->Scale(1.0, 2.0, 1.5);
+    clipFunction->SetTransform(transform);
+    CHECK_EXIT_SUCCESS(CheckSameAsReference(clipper, clipFunction));
+    CHECK_BOOL(clipper->GetClipFunctionEvaluated(), false);
+  }
+  clipFunction->SetTransform(static_cast<vtkAbstractTransform*>(nullptr));
+  clipper->SetClippingMethod(vtkIncrementalClipPolyData::Straight);
+
+  // Moving planes along their normals reuses the cached distances
+  clipper->Update();
+  int numberOfPlaneDistanceComputations = clipper->GetNumberOfPlaneDistanceComputations();
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  const int numberOfPlaneMoves = 20;
+  for (int i = 0; i < numberOfPlaneMoves; ++i)
+  {
+    plane1->SetOrigin(0.0, 0.0, -40.0 + i * 4.0);
+    CHECK_EXIT_SUCCESS(CheckSameAsReference(clipper, clipFunction));
+  }
+  timer->StopTimer();
+  CHECK_INT(clipper->GetNumberOfPlaneDistanceComputations(), numberOfPlaneDistanceComputations);
+  std::cout << "Mean time of clipping and reference clipping after moving the plane: " //
+            << timer->GetElapsedTime() * 1000.0 / numberOfPlaneMoves << " ms" << std::endl;
+
+  // Rotating a plane only recomputes distances from that plane
+  plane1->SetNormal(0.0, 1.0, 1.0);
+  CHECK_EXIT_SUCCESS(CheckSameAsReference(clipper, clipFunction));
+  CHECK_INT(clipper->GetNumberOfPlaneDistanceComputations(), numberOfPlaneDistanceComputations + 1);
+
+  // Changing the mesh recomputes all distances
+  sphere->SetCenter(1.0, 2.0, 3.0);
+  CHECK_EXIT_SUCCESS(CheckSameAsReference(clipper, clipFunction));
+  CHECK_INT(clipper->GetNumberOfPlaneDistanceComputations(), numberOfPlaneDistanceComputations + 3);
+
+  // Clip functions that cannot be decomposed into planes are evaluated directly
+  vtkNew<vtkSphere> sphereFunction;
+  sphereFunction->SetRadius(30.0);
+  plane2Boolean->AddFunction(sphereFunction);
+  plane2Boolean->SetOperationTypeToUnion();
+  CHECK_EXIT_SUCCESS(CheckSameAsReference(clipper, clipFunction));
+  CHECK_BOOL(clipper->GetClipFunctionEvaluated(), true);
+
+  // Points exactly on the clipping plane (clip value of 0.0) are classified the same way as by VTK filters.
+  // Grid points are at integer coordinates, so planes at x = 0 and x = 2 go through a row of points.
+  vtkNew<vtkPlaneSource> grid;
+  grid->SetOrigin(-5.0, -5.0, 0.0);
+  grid->SetPoint1(5.0, -5.0, 0.0);
+  grid->SetPoint2(-5.0, 5.0, 0.0);
+  grid->SetResolution(10, 10);
+  vtkNew<vtkIncrementalClipPolyData> gridClipper;
+  gridClipper->SetInputConnection(grid->GetOutputPort());
+  vtkNew<vtkPlane> gridPlane;
+  gridPlane->SetNormal(1.0, 0.0, 0.0);
+  vtkNew<vtkImplicitInvertableBoolean> gridPlaneBoolean;
+  gridPlaneBoolean->AddFunction(gridPlane);
+  for (int clippingMethod : clippingMethods)
+  {
+    gridClipper->SetClippingMethod(clippingMethod);
+    for (bool invert : { false, true })
+    {
+      gridPlaneBoolean->SetInvert(invert);
+      gridPlane->SetOrigin(0.0, 0.0, 0.0);
+      CHECK_EXIT_SUCCESS(CheckSameAsReference(gridClipper, gridPlaneBoolean));
+      CHECK_BOOL(gridClipper->GetClipFunctionEvaluated(), false);
+      gridPlane->SetOrigin(2.0, 0.0, 0.0);
+      CHECK_EXIT_SUCCESS(CheckSameAsReference(gridClipper, gridPlaneBoolean));
+      CHECK_BOOL(gridClipper->GetClipFunctionEvaluated(), false);
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
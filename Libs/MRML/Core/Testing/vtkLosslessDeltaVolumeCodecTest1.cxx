@@ -0,0 +1,237 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkLosslessDeltaVolumeCodec.h"
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLSequenceNode.h"
+#include "vtkMRMLStreamingVolumeNode.h"
+#include "vtkMRMLVolumeSequenceStorageNode.h"
+
+// vtkAddon includes
+#include <vtkStreamingVolumeFrame.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
+// VTKSYS includes
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Create an image that resembles an ultrasound frame: a speckle texture that moves
+/// slowly between frames, with additional per-frame noise.
+vtkSmartPointer<vtkImageData> CreateFrame(int frameIndex, int width, int height, int scalarType, int numberOfComponents)
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(width, height, 1);
+  image->AllocateScalars(scalarType, numberOfComponents);
+  std::mt19937 noiseGenerator(frameIndex);
+  std::normal_distribution<double> noise(0.0, 2.0);
+  for (int y = 0; y < height; ++y)
+  {
+    for (int x = 0; x < width; ++x)
+    {
+      double speckle = 60.0 + 40.0 * std::sin((x + frameIndex) * 0.21) * std::cos(y * 0.13) + 20.0 * std::sin((x * 7 + y * 3) % 17);
+      for (int component = 0; component < numberOfComponents; ++component)
+      {
+        image->SetScalarComponentFromDouble(x, y, 0, component, std::floor(speckle + component * 10 + noise(noiseGenerator)));
+      }
+    }
+  }
+  return image;
+}
+
+//----------------------------------------------------------------------------
+bool IsImageEqual(vtkImageData* image1, vtkImageData* image2)
+{
+  if (!image1 || !image2 || image1->GetScalarType() != image2->GetScalarType() || image1->GetNumberOfScalarComponents() != image2->GetNumberOfScalarComponents())
+  {
+    return false;
+  }
+  int* dimensions1 = image1->GetDimensions();
+  int* dimensions2 = image2->GetDimensions();
+  if (dimensions1[0] != dimensions2[0] || dimensions1[1] != dimensions2[1] || dimensions1[2] != dimensions2[2])
+  {
+    return false;
+  }
+  vtkDataArray* scalars1 = image1->GetPointData()->GetScalars();
+  vtkDataArray* scalars2 = image2->GetPointData()->GetScalars();
+  return memcmp(scalars1->GetVoidPointer(0), scalars2->GetVoidPointer(0), scalars1->GetDataSize() * scalars1->GetDataTypeSize()) == 0;
+}
+
+//----------------------------------------------------------------------------
+int TestEncodeDecode(int scalarType, int numberOfComponents)
+{
+  const int numberOfFrames = 7;
+  std::vector<vtkSmartPointer<vtkImageData>> images;
+  std::vector<vtkSmartPointer<vtkStreamingVolumeFrame>> frames;
+  vtkNew<vtkLosslessDeltaVolumeCodec> encoder;
+  CHECK_BOOL(encoder->SetParameter("KeyFrameInterval", "3"), true);
+  CHECK_INT(encoder->GetKeyFrameInterval(), 3);
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+  {
+    vtkSmartPointer<vtkImageData> image = CreateFrame(frameIndex, 33, 21, scalarType, numberOfComponents);
+    vtkSmartPointer<vtkStreamingVolumeFrame> frame = vtkSmartPointer<vtkStreamingVolumeFrame>::New();
+    CHECK_BOOL(encoder->EncodeImageData(image, frame), true);
+    CHECK_BOOL(frame->IsKeyFrame(), frameIndex % 3 == 0);
+    images.push_back(image);
+    frames.push_back(frame);
+  }
+
+  // Decode in order
+  vtkNew<vtkLosslessDeltaVolumeCodec> decoder;
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+  {
+    vtkNew<vtkImageData> decodedImage;
+    CHECK_BOOL(decoder->DecodeFrame(frames[frameIndex], decodedImage), true);
+    CHECK_BOOL(IsImageEqual(decodedImage, images[frameIndex]), true);
+  }
+
+  // Decode in random order (previous frames must be decoded from the last key frame)
+  vtkNew<vtkLosslessDeltaVolumeCodec> randomAccessDecoder;
+  for (int frameIndex : { 5, 2, 6, 0, 4 })
+  {
+    vtkNew<vtkImageData> decodedImage;
+    CHECK_BOOL(randomAccessDecoder->DecodeFrame(frames[frameIndex], decodedImage), true);
+    CHECK_BOOL(IsImageEqual(decodedImage, images[frameIndex]), true);
+  }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestStreamingVolumeNode()
+{
+  // The scene registers the codec in the streaming volume codec factory
+  vtkNew<vtkMRMLScene> scene;
+  vtkSmartPointer<vtkImageData> image = CreateFrame(0, 40, 30, VTK_UNSIGNED_CHAR, 3);
+
+  vtkNew<vtkMRMLStreamingVolumeNode> encoderNode;
+  encoderNode->SetCodecFourCC("SLDC");
+  encoderNode->SetAndObserveImageData(image);
+  CHECK_BOOL(encoderNode->EncodeImageData(), true);
+  CHECK_NOT_NULL(encoderNode->GetFrame());
+
+  vtkNew<vtkMRMLStreamingVolumeNode> decoderNode;
+  decoderNode->SetAndObserveFrame(encoderNode->GetFrame());
+  CHECK_BOOL(IsImageEqual(decoderNode->GetImageData(), image), true);
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestSequenceStorageBenchmark(const std::string& tempDir)
+{
+  const int numberOfFrames = 40;
+  const int width = 640;
+  const int height = 480;
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLSequenceNode> sequenceNode;
+  sequenceNode->SetName("Ultrasound");
+  scene->AddNode(sequenceNode);
+  sequenceNode->SetIndexName("time");
+  sequenceNode->SetIndexUnit("s");
+  sequenceNode->SetAttribute("Modality", "US probe 1");
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+  {
+    vtkNew<vtkMRMLScalarVolumeNode> frameVolume;
+    frameVolume->SetAndObserveImageData(CreateFrame(frameIndex, width, height, VTK_UNSIGNED_CHAR, 1));
+    frameVolume->SetSpacing(0.2, 0.2, 1.0);
+    sequenceNode->SetDataNodeAtValue(frameVolume, std::to_string(frameIndex * 0.05));
+  }
+  double rawSizeMB = numberOfFrames * width * height / 1.0e6;
+
+  std::cout << "Volume sequence storage benchmark: " << numberOfFrames << " frames of " << width << "x" << height << " unsigned char" << std::endl;
+  for (const std::string& extension : { std::string(".seq.nrrd"), std::string(".seq.sldc") })
+  {
+    std::string fileName = tempDir + "/vtkLosslessDeltaVolumeCodecTest1" + extension;
+    vtkNew<vtkMRMLVolumeSequenceStorageNode> storageNode;
+    scene->AddNode(storageNode);
+    storageNode->SetFileName(fileName.c_str());
+    storageNode->SetUseCompression(1);
+
+    vtkNew<vtkTimerLog> timer;
+    timer->StartTimer();
+    CHECK_INT(storageNode->WriteData(sequenceNode), 1);
+    timer->StopTimer();
+    double writeTimeSec = timer->GetElapsedTime();
+
+    vtkNew<vtkMRMLSequenceNode> readSequenceNode;
+    readSequenceNode->SetName("UltrasoundRead");
+    scene->AddNode(readSequenceNode);
+    timer->StartTimer();
+    CHECK_INT(storageNode->ReadData(readSequenceNode), 1);
+    timer->StopTimer();
+    double readTimeSec = timer->GetElapsedTime();
+
+    double fileSizeMB = vtksys::SystemTools::FileLength(fileName) / 1.0e6;
+    std::cout << "  " << extension << ": size = " << fileSizeMB << " MB (ratio " << rawSizeMB / fileSizeMB << ")" //
+              << ", write = " << rawSizeMB / writeTimeSec << " MB/s, read = " << rawSizeMB / readTimeSec << " MB/s" << std::endl;
+
+    // Verify that content is preserved
+    CHECK_INT(readSequenceNode->GetNumberOfDataNodes(), numberOfFrames);
+    CHECK_STD_STRING(readSequenceNode->GetIndexName(), "time");
+    CHECK_STRING(readSequenceNode->GetAttribute("Modality"), "US probe 1");
+    for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+    {
+      CHECK_STD_STRING(readSequenceNode->GetNthIndexValue(frameIndex), sequenceNode->GetNthIndexValue(frameIndex));
+      vtkMRMLScalarVolumeNode* originalVolume = vtkMRMLScalarVolumeNode::SafeDownCast(sequenceNode->GetNthDataNode(frameIndex));
+      vtkMRMLScalarVolumeNode* readVolume = vtkMRMLScalarVolumeNode::SafeDownCast(readSequenceNode->GetNthDataNode(frameIndex));
+      CHECK_NOT_NULL(readVolume);
+      CHECK_BOOL(IsImageEqual(readVolume->GetImageData(), originalVolume->GetImageData()), true);
+      CHECK_DOUBLE_TOLERANCE(readVolume->GetSpacing()[0], 0.2, 1e-6);
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkLosslessDeltaVolumeCodecTest1(int argc, char* argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  CHECK_EXIT_SUCCESS(TestEncodeDecode(VTK_UNSIGNED_CHAR, 1));
+  CHECK_EXIT_SUCCESS(TestEncodeDecode(VTK_UNSIGNED_CHAR, 3));
+  CHECK_EXIT_SUCCESS(TestEncodeDecode(VTK_SHORT, 1));
+  CHECK_EXIT_SUCCESS(TestEncodeDecode(VTK_FLOAT, 2));
+  CHECK_EXIT_SUCCESS(TestEncodeDecode(VTK_DOUBLE, 1));
+  CHECK_EXIT_SUCCESS(TestStreamingVolumeNode());
+  CHECK_EXIT_SUCCESS(TestSequenceStorageBenchmark(argv[1]));
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,124 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Measures save and load throughput of models in XML formats
+// for each data mode and compressor of the model storage node.
+// A small model is used by default, a large model (about 2 million triangles)
+// is used if "--benchmark" is specified after the temporary directory.
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLModelStorageNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataNormals.h>
+#include <vtkSphereSource.h>
+#include <vtkTimerLog.h>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <cstring>
+#include <string>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+int TestSaveLoad(vtkMRMLScene* scene, vtkPolyData* mesh, int useCompression, const std::string& compressionParameter)
+{
+  std::string fileName = std::string(scene->GetRootDirectory()) + "/vtkMRMLModelStorageNodePerformanceTest1.vtp";
+
+  vtkNew<vtkMRMLModelNode> modelNode;
+  modelNode->SetAndObserveMesh(mesh);
+  scene->AddNode(modelNode);
+  modelNode->AddDefaultStorageNode();
+  vtkMRMLModelStorageNode* storageNode = vtkMRMLModelStorageNode::SafeDownCast(modelNode->GetStorageNode());
+  CHECK_NOT_NULL(storageNode);
+  storageNode->SetFileName(fileName.c_str());
+  storageNode->SetUseCompression(useCompression);
+  storageNode->SetCompressionParameter(compressionParameter);
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  CHECK_BOOL(storageNode->WriteData(modelNode), true);
+  timer->StopTimer();
+  double writeTimeSec = timer->GetElapsedTime();
+
+  modelNode->SetAndObserveMesh(nullptr);
+  timer->StartTimer();
+  CHECK_BOOL(storageNode->ReadData(modelNode), true);
+  timer->StopTimer();
+  double readTimeSec = timer->GetElapsedTime();
+
+  CHECK_NOT_NULL(modelNode->GetMesh());
+  CHECK_INT(modelNode->GetMesh()->GetNumberOfPoints(), mesh->GetNumberOfPoints());
+  CHECK_INT(modelNode->GetMesh()->GetNumberOfCells(), mesh->GetNumberOfCells());
+
+  // Throughput is measured relative to the in-memory size of the mesh
+  double dataSizeMB = mesh->GetActualMemorySize() / 1024.0;
+  double fileSizeMB = vtksys::SystemTools::FileLength(fileName) / (1024.0 * 1024.0);
+  std::cout << (useCompression ? compressionParameter : std::string("uncompressed")) //
+            << ": file size " << fileSizeMB << " MB"
+            << ", save " << dataSizeMB / writeTimeSec << " MB/s"
+            << ", load " << dataSizeMB / readTimeSec << " MB/s" << std::endl;
+
+  scene->RemoveNode(modelNode);
+  vtksys::SystemTools::RemoveFile(fileName);
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLModelStorageNodePerformanceTest1(int argc, char* argv[])
+{
+  if (argc < 2 || argc > 3 || (argc == 3 && strcmp(argv[2], "--benchmark") != 0))
+  {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp [--benchmark]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  bool benchmark = (argc == 3);
+
+  vtkNew<vtkMRMLScene> scene;
+  scene->SetRootDirectory(argv[1]);
+
+  // About 2 million triangles (20 thousand by default), with normals
+  int resolution = (benchmark ? 1000 : 100);
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(resolution);
+  sphere->SetPhiResolution(resolution);
+  vtkNew<vtkPolyDataNormals> normals;
+  normals->SetInputConnection(sphere->GetOutputPort());
+  normals->SplittingOff();
+  normals->Update();
+  vtkPolyData* mesh = normals->GetOutput();
+  std::cout << "Model: " << mesh->GetNumberOfPoints() << " points, " << mesh->GetNumberOfCells() << " cells, " //
+            << mesh->GetActualMemorySize() / 1024.0 << " MB" << std::endl;
+
+  vtkNew<vtkMRMLModelStorageNode> storageNode;
+  CHECK_EXIT_SUCCESS(TestSaveLoad(scene, mesh, 0, ""));
+  CHECK_EXIT_SUCCESS(TestSaveLoad(scene, mesh, 1, storageNode->GetCompressionParameterFastest()));
+  CHECK_EXIT_SUCCESS(TestSaveLoad(scene, mesh, 1, storageNode->GetCompressionParameterNormal()));
+  CHECK_EXIT_SUCCESS(TestSaveLoad(scene, mesh, 1, storageNode->GetCompressionParameterMinimumSize()));
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
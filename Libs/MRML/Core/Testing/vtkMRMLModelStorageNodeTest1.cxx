@@ -25,7 +25,13 @@ Program:   3D Slicer
 #include <array>
 
 //---------------------------------------------------------------------------
-int TestReadWriteData(vtkMRMLScene* scene, const char* extension, vtkPointSet* mesh, int coordinateSystem, bool cellsMayBeSubdivided = false);
+int TestReadWriteData(vtkMRMLScene* scene,
+                      const char* extension,
+                      vtkPointSet* mesh,
+                      int coordinateSystem,
+                      bool cellsMayBeSubdivided = false,
+                      int useCompression = 1,
+                      const std::string& compressionParameter = "");
 void CreateVoxelMeshes(vtkUnstructuredGrid* ug, vtkPolyData* poly);
 
 //---------------------------------------------------------------------------
@@ -58,12 +64,30 @@ int vtkMRMLModelStorageNodeTest1(int argc, char* argv[])
     CHECK_EXIT_SUCCESS(TestReadWriteData(scene.GetPointer(), ".vtu", ug.GetPointer(), coordinateSystem));
   }
 
+  // XML formats: raw binary uncompressed and all compressors
+  CHECK_EXIT_SUCCESS(TestReadWriteData(scene.GetPointer(), ".vtp", poly.GetPointer(), vtkMRMLStorageNode::CoordinateSystemLPS, false, 0));
+  CHECK_EXIT_SUCCESS(TestReadWriteData(scene.GetPointer(), ".vtu", ug.GetPointer(), vtkMRMLStorageNode::CoordinateSystemLPS, false, 0));
+  CHECK_INT(node1->GetNumberOfCompressionPresets(), 3);
+  CHECK_STD_STRING(node1->GetCompressionParameter(), node1->GetCompressionParameterNormal());
+  for (const std::string& compressionParameter :
+       { node1->GetCompressionParameterFastest(), node1->GetCompressionParameterNormal(), node1->GetCompressionParameterMinimumSize() })
+  {
+    CHECK_EXIT_SUCCESS(TestReadWriteData(scene.GetPointer(), ".vtp", poly.GetPointer(), vtkMRMLStorageNode::CoordinateSystemLPS, false, 1, compressionParameter));
+    CHECK_EXIT_SUCCESS(TestReadWriteData(scene.GetPointer(), ".vtu", ug.GetPointer(), vtkMRMLStorageNode::CoordinateSystemLPS, false, 1, compressionParameter));
+  }
+
   std::cout << "Test passed." << std::endl;
   return EXIT_SUCCESS;
 }
 
 //---------------------------------------------------------------------------
-int TestReadWriteData(vtkMRMLScene* scene, const char* extension, vtkPointSet* mesh, int coordinateSystem, bool cellsMayBeSubdivided /*=false*/)
+int TestReadWriteData(vtkMRMLScene* scene,
+                      const char* extension,
+                      vtkPointSet* mesh,
+                      int coordinateSystem,
+                      bool cellsMayBeSubdivided /*=false*/,
+                      int useCompression /*=1*/,
+                      const std::string& compressionParameter /*=""*/)
 {
   std::string fileName = std::string(scene->GetRootDirectory()) + std::string("/vtkMRMLModelNodeTest1") + std::string(extension);
 
@@ -89,6 +113,11 @@ int TestReadWriteData(vtkMRMLScene* scene, const char* extension, vtkPointSet* m
   CHECK_NOT_NULL(storageNode);
   storageNode->SetFileName(fileName.c_str());
   storageNode->SetCoordinateSystem(coordinateSystem);
+  storageNode->SetUseCompression(useCompression);
+  if (!compressionParameter.empty())
+  {
+    storageNode->SetCompressionParameter(compressionParameter);
+  }
 
   // Test writing
   CHECK_BOOL(storageNode->WriteData(modelNode.GetPointer()), true);
@@ -0,0 +1,183 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Measures the per-call cost of node reference accessors that identify the
+// reference role by name and by interned role atom.
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const int NUMBER_OF_CALLS = 1000000;
+const int NUMBER_OF_ROLES = 8;
+
+//----------------------------------------------------------------------------
+std::string GetRoleName(int roleIndex)
+{
+  std::stringstream ss;
+  ss << "performanceTestReferenceRole" << roleIndex;
+  return ss.str();
+}
+
+//----------------------------------------------------------------------------
+void PrintTime(const char* name, double elapsedTimeSec)
+{
+  std::cout << name << ": " << elapsedTimeSec * 1.0e9 / NUMBER_OF_CALLS << " ns/call" << std::endl;
+}
+
+//----------------------------------------------------------------------------
+int TestRoleAtoms()
+{
+  CHECK_INT(vtkMRMLNode::GetReferenceRoleAtom(nullptr), -1);
+  int atom = vtkMRMLNode::GetReferenceRoleAtom("performanceTestAtomRole");
+  CHECK_BOOL(atom >= 0, true);
+  CHECK_INT(vtkMRMLNode::GetReferenceRoleAtom("performanceTestAtomRole"), atom);
+  CHECK_BOOL(vtkMRMLNode::GetReferenceRoleAtom("performanceTestAtomRole2") != atom, true);
+  CHECK_STRING(vtkMRMLNode::GetReferenceRoleFromAtom(atom), "performanceTestAtomRole");
+  CHECK_NULL(vtkMRMLNode::GetReferenceRoleFromAtom(-1));
+  CHECK_NULL(vtkMRMLNode::GetReferenceRoleFromAtom(1000000));
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestRoleOrder()
+{
+  // Roles are kept sorted by name (binary search is used for finding a role by name)
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLModelNode> referencingNode;
+  scene->AddNode(referencingNode);
+  vtkNew<vtkMRMLModelNode> referencedNode;
+  scene->AddNode(referencedNode);
+  const int numberOfRolesBefore = referencingNode->GetNumberOfNodeReferenceRoles();
+  for (const char* role : { "performanceTestOrderC", "performanceTestOrderA", "performanceTestOrderB" })
+  {
+    referencingNode->AddNodeReferenceID(role, referencedNode->GetID());
+  }
+  CHECK_INT(referencingNode->GetNumberOfNodeReferenceRoles(), numberOfRolesBefore + 3);
+  std::vector<std::string> roles;
+  referencingNode->GetNodeReferenceRoles(roles);
+  for (size_t i = 1; i < roles.size(); ++i)
+  {
+    CHECK_BOOL(roles[i - 1] < roles[i], true);
+  }
+  CHECK_STRING(referencingNode->GetNthNodeReferenceID("performanceTestOrderB", 0), referencedNode->GetID());
+  CHECK_NULL(referencingNode->GetNthNodeReferenceID("performanceTestOrder", 0));
+  CHECK_NULL(referencingNode->GetNthNodeReferenceID("performanceTestOrderD", 0));
+  CHECK_INT(referencingNode->GetNumberOfNodeReferenceRoles(), numberOfRolesBefore + 3);
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLNodeReferencePerformanceTest1(int, char*[])
+{
+  CHECK_EXIT_SUCCESS(TestRoleAtoms());
+  CHECK_EXIT_SUCCESS(TestRoleOrder());
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLModelNode> referencingNode;
+  scene->AddNode(referencingNode);
+  vtkNew<vtkMRMLModelNode> referencedNode;
+  scene->AddNode(referencedNode);
+
+  std::vector<std::string> roles;
+  for (int roleIndex = 0; roleIndex < NUMBER_OF_ROLES; ++roleIndex)
+  {
+    roles.push_back(GetRoleName(roleIndex));
+    referencingNode->AddNodeReferenceID(roles.back().c_str(), referencedNode->GetID());
+  }
+  const char* role = roles[NUMBER_OF_ROLES / 2].c_str();
+  int roleAtom = vtkMRMLNode::GetReferenceRoleAtom(role);
+  CHECK_STRING(vtkMRMLNode::GetReferenceRoleFromAtom(roleAtom), role);
+
+  // Accessors by role name and by role atom return the same references
+  CHECK_INT(referencingNode->GetNumberOfNodeReferences(role), 1);
+  CHECK_INT(referencingNode->GetNumberOfNodeReferencesByRoleAtom(roleAtom), 1);
+  CHECK_STRING(referencingNode->GetNthNodeReferenceIDByRoleAtom(roleAtom, 0), referencedNode->GetID());
+  CHECK_POINTER(referencingNode->GetNthNodeReferenceByRoleAtom(roleAtom, 0), referencedNode);
+  CHECK_NULL(referencingNode->GetNthNodeReferenceByRoleAtom(roleAtom, 1));
+  CHECK_NULL(referencingNode->GetNthNodeReferenceByRoleAtom(-1, 0));
+
+  // Querying a role that has no references does not add the role
+  int numberOfRoles = referencingNode->GetNumberOfNodeReferenceRoles();
+  CHECK_INT(referencingNode->GetNumberOfNodeReferences("performanceTestMissingRole"), 0);
+  CHECK_NULL(referencingNode->GetNthNodeReference("performanceTestMissingRole", 0));
+  CHECK_NULL(referencingNode->GetNthNodeReferenceID("performanceTestMissingRole", 0));
+  CHECK_INT(referencingNode->GetNumberOfNodeReferenceRoles(), numberOfRoles);
+
+  vtkNew<vtkTimerLog> timer;
+  int numberOfFoundNodes = 0;
+
+  timer->StartTimer();
+  for (int i = 0; i < NUMBER_OF_CALLS; ++i)
+  {
+    numberOfFoundNodes += referencingNode->GetNumberOfNodeReferences(role);
+  }
+  timer->StopTimer();
+  PrintTime("GetNumberOfNodeReferences(role)", timer->GetElapsedTime());
+
+  timer->StartTimer();
+  for (int i = 0; i < NUMBER_OF_CALLS; ++i)
+  {
+    numberOfFoundNodes += referencingNode->GetNumberOfNodeReferencesByRoleAtom(roleAtom);
+  }
+  timer->StopTimer();
+  PrintTime("GetNumberOfNodeReferencesByRoleAtom(roleAtom)", timer->GetElapsedTime());
+
+  timer->StartTimer();
+  for (int i = 0; i < NUMBER_OF_CALLS; ++i)
+  {
+    numberOfFoundNodes += (referencingNode->GetNthNodeReference(role, 0) != nullptr);
+  }
+  timer->StopTimer();
+  PrintTime("GetNthNodeReference(role, 0)", timer->GetElapsedTime());
+
+  timer->StartTimer();
+  for (int i = 0; i < NUMBER_OF_CALLS; ++i)
+  {
+    numberOfFoundNodes += (referencingNode->GetNthNodeReferenceByRoleAtom(roleAtom, 0) != nullptr);
+  }
+  timer->StopTimer();
+  PrintTime("GetNthNodeReferenceByRoleAtom(roleAtom, 0)", timer->GetElapsedTime());
+
+  timer->StartTimer();
+  for (int i = 0; i < NUMBER_OF_CALLS; ++i)
+  {
+    numberOfFoundNodes += (referencingNode->GetNthNodeReference("performanceTestMissingRole", 0) != nullptr);
+  }
+  timer->StopTimer();
+  PrintTime("GetNthNodeReference(missingRole, 0)", timer->GetElapsedTime());
+
+  CHECK_INT(numberOfFoundNodes, 4 * NUMBER_OF_CALLS);
+  CHECK_INT(referencingNode->GetNumberOfNodeReferenceRoles(), numberOfRoles);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,181 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLStreamingVolumeDecodeCache.h"
+#include "vtkMRMLStreamingVolumeNode.h"
+
+// vtkAddon includes
+#include <vtkStreamingVolumeFrame.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkStreamingVolumeFrame> CreateFrame(int frameIndex)
+{
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(10, 10, 1);
+  imageData->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+  unsigned char* imagePointer = static_cast<unsigned char*>(imageData->GetScalarPointer());
+  for (int i = 0; i < 10 * 10 * 3; ++i)
+  {
+    imagePointer[i] = static_cast<unsigned char>(i + frameIndex);
+  }
+
+  vtkNew<vtkMRMLStreamingVolumeNode> streamingVolumeNode;
+  streamingVolumeNode->SetCodecFourCC("RV24");
+  streamingVolumeNode->SetAndObserveImageData(imageData);
+  streamingVolumeNode->EncodeImageData();
+  return streamingVolumeNode->GetFrame();
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLStreamingVolumeDecodeCacheTest1(int, char*[])
+{
+  vtkMRMLStreamingVolumeDecodeCache* cache = vtkMRMLStreamingVolumeDecodeCache::GetInstance();
+  CHECK_NOT_NULL(cache);
+  cache->SetNumberOfThreads(2);
+
+  const int numberOfFrames = 5;
+  std::vector<vtkSmartPointer<vtkStreamingVolumeFrame>> frames;
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+  {
+    vtkSmartPointer<vtkStreamingVolumeFrame> frame = CreateFrame(frameIndex);
+    CHECK_NOT_NULL(frame);
+    frames.push_back(frame);
+  }
+
+  // Invalid input
+  CHECK_BOOL(cache->PrefetchFrame(nullptr), false);
+  vtkNew<vtkImageData> outputImage;
+  CHECK_BOOL(cache->GetDecodedImage(nullptr, outputImage), false);
+
+  // Prefetch all frames
+  for (vtkStreamingVolumeFrame* frame : frames)
+  {
+    CHECK_BOOL(cache->PrefetchFrame(frame), true);
+  }
+  cache->WaitForPrefetchCompletion();
+  CHECK_INT(cache->GetNumberOfQueuedFrames(), 0);
+  CHECK_INT(cache->GetNumberOfCachedFrames(), numberOfFrames);
+  CHECK_INT(cache->GetNumberOfDecodedFrames(), numberOfFrames);
+  CHECK_BOOL(cache->IsFrameDecoded(frames[2]), true);
+
+  // Prefetching an already decoded frame does not decode it again
+  CHECK_BOOL(cache->PrefetchFrame(frames[2]), true);
+  cache->WaitForPrefetchCompletion();
+  CHECK_INT(cache->GetNumberOfDecodedFrames(), numberOfFrames);
+
+  // Get decoded image from the cache
+  CHECK_BOOL(cache->GetDecodedImage(frames[3], outputImage), true);
+  CHECK_INT(cache->GetNumberOfCacheHits(), 1);
+  int dimensions[3] = { 0, 0, 0 };
+  outputImage->GetDimensions(dimensions);
+  CHECK_INT(dimensions[0], 10);
+  CHECK_INT(dimensions[1], 10);
+  CHECK_INT(outputImage->GetNumberOfScalarComponents(), 3);
+  unsigned char* outputPointer = static_cast<unsigned char*>(outputImage->GetScalarPointer());
+  for (int i = 0; i < 10 * 10 * 3; ++i)
+  {
+    CHECK_INT(outputPointer[i], static_cast<unsigned char>(i + 3));
+  }
+
+  // Streaming volume node uses the cache when decoding its frame
+  vtkNew<vtkMRMLStreamingVolumeNode> streamingVolumeNode;
+  streamingVolumeNode->SetAndObserveFrame(frames[1]);
+  vtkImageData* nodeImage = streamingVolumeNode->GetImageData();
+  CHECK_NOT_NULL(nodeImage);
+  CHECK_INT(cache->GetNumberOfCacheHits(), 2);
+  unsigned char* nodeImagePointer = static_cast<unsigned char*>(nodeImage->GetScalarPointer());
+  CHECK_INT(nodeImagePointer[0], 1);
+
+  // Cache size limit evicts least recently used frames (frames[3] and frames[1] were used most recently)
+  double frameSizeMB = cache->GetCacheSizeMB() / numberOfFrames;
+  cache->SetMaximumCacheSizeMB(frameSizeMB * 2.5);
+  CHECK_INT(cache->GetNumberOfCachedFrames(), 2);
+  CHECK_INT(cache->GetNumberOfEvictedFrames(), 3);
+  CHECK_BOOL(cache->IsFrameDecoded(frames[1]), true);
+  CHECK_BOOL(cache->IsFrameDecoded(frames[3]), true);
+  CHECK_BOOL(cache->IsFrameDecoded(frames[0]), false);
+
+  // Missing frame is reported as a miss
+  CHECK_BOOL(cache->GetDecodedImage(frames[0], outputImage), false);
+  CHECK_INT(cache->GetNumberOfCacheMisses(), 1);
+
+  CHECK_BOOL(cache->GetMeanDecodeTimeMs() >= 0.0, true);
+  CHECK_BOOL(cache->GetMaximumDecodeTimeMs() >= cache->GetMeanDecodeTimeMs(), true);
+
+  // Clear
+  cache->Clear();
+  CHECK_INT(cache->GetNumberOfCachedFrames(), 0);
+  CHECK_DOUBLE_TOLERANCE(cache->GetCacheSizeMB(), 0.0, 1e-6);
+  cache->ResetStatistics();
+  CHECK_INT(cache->GetNumberOfCacheHits(), 0);
+  CHECK_INT(cache->GetNumberOfDecodedFrames(), 0);
+
+  // Changing the number of threads restarts the workers
+  cache->SetMaximumCacheSizeMB(512.0);
+  cache->SetNumberOfThreads(3);
+  CHECK_INT(cache->GetNumberOfThreads(), 3);
+  for (vtkStreamingVolumeFrame* frame : frames)
+  {
+    CHECK_BOOL(cache->PrefetchFrame(frame), true);
+  }
+  cache->WaitForPrefetchCompletion();
+  CHECK_INT(cache->GetNumberOfCachedFrames(), numberOfFrames);
+
+  // Removing a frame only releases the decoded image of that frame
+  cache->RemoveFrame(nullptr);
+  cache->RemoveFrame(frames[2]);
+  CHECK_INT(cache->GetNumberOfCachedFrames(), numberOfFrames - 1);
+  CHECK_BOOL(cache->IsFrameDecoded(frames[2]), false);
+  CHECK_BOOL(cache->IsFrameDecoded(frames[1]), true);
+  CHECK_BOOL(cache->IsFrameDecoded(frames[3]), true);
+  CHECK_BOOL(cache->PrefetchFrame(frames[2]), true);
+  cache->RemoveFrame(frames[2]);
+  cache->WaitForPrefetchCompletion();
+  CHECK_BOOL(cache->IsFrameDecoded(frames[2]), false);
+  CHECK_INT(cache->GetNumberOfCachedFrames(), numberOfFrames - 1);
+  CHECK_BOOL(cache->PrefetchFrame(frames[2]), true);
+  cache->WaitForPrefetchCompletion();
+  CHECK_INT(cache->GetNumberOfCachedFrames(), numberOfFrames);
+
+  // Stopping worker threads keeps decoded images and threads are started again when needed
+  cache->StopWorkerThreads();
+  CHECK_INT(cache->GetNumberOfCachedFrames(), numberOfFrames);
+  CHECK_BOOL(cache->GetDecodedImage(frames[4], outputImage), true);
+  cache->Clear();
+  CHECK_BOOL(cache->PrefetchFrame(frames[0]), true);
+  cache->WaitForPrefetchCompletion();
+  CHECK_BOOL(cache->IsFrameDecoded(frames[0]), true);
+  cache->Clear();
+  cache->StopWorkerThreads();
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,345 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkExtractPlaneCrossingCells.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkIdList.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPlane.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPThreadLocalObject.h>
+#include <vtkSMPTools.h>
+#include <vtkWeakPointer.h>
+
+// STD includes
+#include <algorithm>
+#include <vector>
+
+vtkStandardNewMacro(vtkExtractPlaneCrossingCells);
+
+namespace
+{
+//----------------------------------------------------------------------------
+struct CellExtent
+{
+  double Min;
+  double Max;
+  vtkIdType CellId;
+};
+
+//----------------------------------------------------------------------------
+// Compute extent of a range of cells along the plane normal.
+struct CellExtentFunctor
+{
+  vtkCellArray* Cells{ nullptr };
+  vtkPoints* Points{ nullptr };
+  const double* Normal{ nullptr };
+  CellExtent* Output{ nullptr };
+  vtkIdType CellIdOffset{ 0 };
+  double MaxSpan{ 0.0 };
+
+  vtkSMPThreadLocalObject<vtkIdList> PointIds;
+  vtkSMPThreadLocal<double> LocalMaxSpan;
+
+  void Initialize() { this->LocalMaxSpan.Local() = 0.0; }
+
+  void operator()(vtkIdType beginCellIndex, vtkIdType endCellIndex)
+  {
+    vtkIdList* pointIds = this->PointIds.Local();
+    double& localMaxSpan = this->LocalMaxSpan.Local();
+    double point[3] = { 0.0, 0.0, 0.0 };
+    for (vtkIdType cellIndex = beginCellIndex; cellIndex < endCellIndex; ++cellIndex)
+    {
+      CellExtent& extent = this->Output[cellIndex];
+      extent.CellId = this->CellIdOffset + cellIndex;
+      this->Cells->GetCellAtId(cellIndex, pointIds);
+      vtkIdType numberOfPoints = pointIds->GetNumberOfIds();
+      if (numberOfPoints == 0)
+      {
+        // empty cell, make sure it is never extracted
+        extent.Min = VTK_DOUBLE_MAX;
+        extent.Max = VTK_DOUBLE_MAX;
+        continue;
+      }
+      extent.Min = VTK_DOUBLE_MAX;
+      extent.Max = VTK_DOUBLE_MIN;
+      for (vtkIdType i = 0; i < numberOfPoints; ++i)
+      {
+        this->Points->GetPoint(pointIds->GetId(i), point);
+        double distance = vtkMath::Dot(point, this->Normal);
+        extent.Min = std::min(extent.Min, distance);
+        extent.Max = std::max(extent.Max, distance);
+      }
+      localMaxSpan = std::max(localMaxSpan, extent.Max - extent.Min);
+    }
+  }
+
+  void Reduce()
+  {
+    for (double span : this->LocalMaxSpan)
+    {
+      this->MaxSpan = std::max(this->MaxSpan, span);
+    }
+  }
+};
+} // namespace
+
+//----------------------------------------------------------------------------
+class vtkExtractPlaneCrossingCells::vtkInternal
+{
+public:
+  /// Cell extents along Normal, sorted by minimum
+  std::vector<CellExtent> CellExtents;
+  /// Largest (Max - Min) value in CellExtents
+  double MaxSpan{ 0.0 };
+  double Normal[3]{ 0.0, 0.0, 0.0 };
+  vtkWeakPointer<vtkPolyData> IndexedInput;
+  vtkMTimeType IndexedInputMTime{ 0 };
+};
+
+//----------------------------------------------------------------------------
+vtkExtractPlaneCrossingCells::vtkExtractPlaneCrossingCells()
+{
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkExtractPlaneCrossingCells::~vtkExtractPlaneCrossingCells()
+{
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkExtractPlaneCrossingCells::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Plane: " << this->Plane.GetPointer() << "\n";
+  os << indent << "Tolerance: " << this->Tolerance << "\n";
+  os << indent << "NumberOfIndexBuilds: " << this->NumberOfIndexBuilds << "\n";
+  os << indent << "NumberOfExtractedCells: " << this->NumberOfExtractedCells << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkExtractPlaneCrossingCells::SetPlane(vtkPlane* plane)
+{
+  if (this->Plane == plane)
+  {
+    return;
+  }
+  this->Plane = plane;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkPlane* vtkExtractPlaneCrossingCells::GetPlane()
+{
+  return this->Plane;
+}
+
+//----------------------------------------------------------------------------
+vtkMTimeType vtkExtractPlaneCrossingCells::GetMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetMTime();
+  if (this->Plane)
+  {
+    mTime = std::max(mTime, this->Plane->GetMTime());
+  }
+  return mTime;
+}
+
+//----------------------------------------------------------------------------
+void vtkExtractPlaneCrossingCells::ResetIndex()
+{
+  this->Internal->CellExtents.clear();
+  this->Internal->MaxSpan = 0.0;
+  this->Internal->IndexedInput = nullptr;
+  this->Internal->IndexedInputMTime = 0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkExtractPlaneCrossingCells::IsIndexOutdated(vtkPolyData* input, const double normal[3])
+{
+  return this->Internal->IndexedInput.GetPointer() != input            //
+         || this->Internal->IndexedInputMTime != input->GetMTime()    //
+         || this->Internal->Normal[0] != normal[0]                    //
+         || this->Internal->Normal[1] != normal[1]                    //
+         || this->Internal->Normal[2] != normal[2];
+}
+
+//----------------------------------------------------------------------------
+void vtkExtractPlaneCrossingCells::BuildIndex(vtkPolyData* input, const double normal[3])
+{
+  this->ResetIndex();
+
+  // Cell IDs in a polydata are ordered as verts, lines, polys, strips.
+  // Vertices cannot intersect the plane, therefore they are not indexed.
+  vtkIdType numberOfVerts = input->GetNumberOfVerts();
+  vtkIdType numberOfLines = input->GetNumberOfLines();
+  vtkIdType numberOfPolys = input->GetNumberOfPolys();
+  vtkIdType numberOfStrips = input->GetNumberOfStrips();
+
+  std::vector<CellExtent>& cellExtents = this->Internal->CellExtents;
+  cellExtents.resize(numberOfLines + numberOfPolys + numberOfStrips);
+
+  vtkCellArray* cellArrays[3] = { input->GetLines(), input->GetPolys(), input->GetStrips() };
+  vtkIdType numberOfCells[3] = { numberOfLines, numberOfPolys, numberOfStrips };
+  vtkIdType cellIdOffset = numberOfVerts;
+  vtkIdType extentOffset = 0;
+  for (int cellArrayIndex = 0; cellArrayIndex < 3; ++cellArrayIndex)
+  {
+    if (numberOfCells[cellArrayIndex] > 0)
+    {
+      CellExtentFunctor functor;
+      functor.Cells = cellArrays[cellArrayIndex];
+      functor.Points = input->GetPoints();
+      functor.Normal = normal;
+      functor.Output = cellExtents.data() + extentOffset;
+      functor.CellIdOffset = cellIdOffset;
+      vtkSMPTools::For(0, numberOfCells[cellArrayIndex], functor);
+      this->Internal->MaxSpan = std::max(this->Internal->MaxSpan, functor.MaxSpan);
+    }
+    cellIdOffset += numberOfCells[cellArrayIndex];
+    extentOffset += numberOfCells[cellArrayIndex];
+  }
+
+  vtkSMPTools::Sort(cellExtents.begin(), cellExtents.end(), [](const CellExtent& a, const CellExtent& b) { return a.Min < b.Min; });
+
+  for (int i = 0; i < 3; ++i)
+  {
+    this->Internal->Normal[i] = normal[i];
+  }
+  this->Internal->IndexedInput = input;
+  this->Internal->IndexedInputMTime = input->GetMTime();
+  this->NumberOfIndexBuilds++;
+}
+
+//----------------------------------------------------------------------------
+int vtkExtractPlaneCrossingCells::RequestData(vtkInformation* vtkNotUsed(request), vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkPolyData* input = vtkPolyData::GetData(inputVector[0], 0);
+  vtkPolyData* output = vtkPolyData::GetData(outputVector, 0);
+  if (!input || !output)
+  {
+    vtkErrorMacro("RequestData failed: invalid input or output");
+    return 0;
+  }
+
+  this->NumberOfExtractedCells = 0;
+  if (!this->Plane)
+  {
+    // No plane is specified, there is nothing to restrict the output to
+    output->ShallowCopy(input);
+    this->NumberOfExtractedCells = input->GetNumberOfCells();
+    return 1;
+  }
+  if (!input->GetPoints() || input->GetNumberOfCells() == 0)
+  {
+    this->ResetIndex();
+    output->Initialize();
+    return 1;
+  }
+
+  double normal[3] = { 0.0, 0.0, 1.0 };
+  this->Plane->GetNormal(normal);
+  if (vtkMath::Normalize(normal) == 0.0)
+  {
+    vtkErrorMacro("RequestData failed: invalid plane normal");
+    return 0;
+  }
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  this->Plane->GetOrigin(origin);
+  double planeDistance = vtkMath::Dot(origin, normal);
+
+  if (this->IsIndexOutdated(input, normal))
+  {
+    this->BuildIndex(input, normal);
+  }
+
+  // Cells that straddle the plane have Min <= planeDistance <= Max.
+  // Since Max <= Min + MaxSpan, only cells with Min in [planeDistance - MaxSpan, planeDistance] have to be checked.
+  const std::vector<CellExtent>& cellExtents = this->Internal->CellExtents;
+  double searchMin = planeDistance - this->Internal->MaxSpan - this->Tolerance;
+  double searchMax = planeDistance + this->Tolerance;
+  auto first = std::lower_bound(cellExtents.begin(), cellExtents.end(), searchMin, [](const CellExtent& extent, double value) { return extent.Min < value; });
+  auto last = std::upper_bound(first, cellExtents.end(), searchMax, [](double value, const CellExtent& extent) { return value < extent.Min; });
+
+  std::vector<vtkIdType> cellIds;
+  for (auto extentIt = first; extentIt != last; ++extentIt)
+  {
+    if (extentIt->Max >= planeDistance - this->Tolerance)
+    {
+      cellIds.push_back(extentIt->CellId);
+    }
+  }
+  // Preserve the original cell order (lines, polys, strips; increasing ID within each)
+  std::sort(cellIds.begin(), cellIds.end());
+
+  output->Initialize();
+  output->SetPoints(input->GetPoints());
+  output->GetPointData()->PassData(input->GetPointData());
+
+  vtkIdType firstLineId = input->GetNumberOfVerts();
+  vtkIdType firstPolyId = firstLineId + input->GetNumberOfLines();
+  vtkIdType firstStripId = firstPolyId + input->GetNumberOfPolys();
+
+  vtkNew<vtkCellArray> outputLines;
+  vtkNew<vtkCellArray> outputPolys;
+  vtkNew<vtkCellArray> outputStrips;
+  vtkCellData* inputCellData = input->GetCellData();
+  vtkCellData* outputCellData = output->GetCellData();
+  outputCellData->CopyAllocate(inputCellData, static_cast<vtkIdType>(cellIds.size()));
+
+  vtkNew<vtkIdList> pointIds;
+  vtkIdType outputCellId = 0;
+  for (vtkIdType cellId : cellIds)
+  {
+    if (cellId >= firstStripId)
+    {
+      input->GetStrips()->GetCellAtId(cellId - firstStripId, pointIds);
+      outputStrips->InsertNextCell(pointIds);
+    }
+    else if (cellId >= firstPolyId)
+    {
+      input->GetPolys()->GetCellAtId(cellId - firstPolyId, pointIds);
+      outputPolys->InsertNextCell(pointIds);
+    }
+    else
+    {
+      input->GetLines()->GetCellAtId(cellId - firstLineId, pointIds);
+      outputLines->InsertNextCell(pointIds);
+    }
+    outputCellData->CopyData(inputCellData, cellId, outputCellId++);
+  }
+  output->SetLines(outputLines);
+  output->SetPolys(outputPolys);
+  output->SetStrips(outputStrips);
+  output->Squeeze();
+
+  this->NumberOfExtractedCells = outputCellId;
+  return 1;
+}
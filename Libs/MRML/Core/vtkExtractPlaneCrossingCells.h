@@ -0,0 +1,108 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+/**
+ * @class   vtkExtractPlaneCrossingCells
+ * @brief   Extract the cells of a polydata that may intersect a plane.
+ *
+ * The filter keeps a sorted-extent index of the input cells along the plane normal:
+ * for each line, polygon and triangle strip the minimum and maximum signed distance
+ * of its points along the normal is computed, and the cells are sorted by minimum distance.
+ * The index is only rebuilt when the input mesh or the plane normal changes, therefore
+ * moving the plane along its normal (e.g., scrolling through slices) only requires
+ * a binary search and a scan of the cells that straddle the plane.
+ *
+ * The output shares points and point data with the input and contains only the cells
+ * (and corresponding cell data) that straddle the plane. Cutting the output with the same
+ * plane gives the same intersection as cutting the full input, but it visits only a small
+ * fraction of the cells. Vertices are never included, as they do not generate any intersection.
+ */
+
+#ifndef vtkExtractPlaneCrossingCells_h
+#define vtkExtractPlaneCrossingCells_h
+
+// VTK includes
+#include <vtkPolyDataAlgorithm.h>
+#include <vtkSmartPointer.h>
+
+// MRML includes
+#include "vtkMRML.h"
+
+class vtkPlane;
+
+class VTK_MRML_EXPORT vtkExtractPlaneCrossingCells : public vtkPolyDataAlgorithm
+{
+public:
+  vtkTypeMacro(vtkExtractPlaneCrossingCells, vtkPolyDataAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+  static vtkExtractPlaneCrossingCells* New();
+
+  //@{
+  /**
+   * Plane that the extracted cells must straddle.
+   */
+  void SetPlane(vtkPlane* plane);
+  vtkPlane* GetPlane();
+  //@}
+
+  //@{
+  /**
+   * Distance tolerance (in the input coordinate system) for deciding if a cell touches the plane.
+   * Default is 1e-6.
+   */
+  vtkSetMacro(Tolerance, double);
+  vtkGetMacro(Tolerance, double);
+  //@}
+
+  /// Return the mtime also considering the plane.
+  vtkMTimeType GetMTime() override;
+
+  /// Number of times the cell index was (re)built. Useful for testing and profiling.
+  vtkGetMacro(NumberOfIndexBuilds, int);
+
+  /// Number of cells that were placed in the output during the last update.
+  vtkGetMacro(NumberOfExtractedCells, vtkIdType);
+
+  /// Remove the cell index. It will be rebuilt at the next update.
+  void ResetIndex();
+
+protected:
+  vtkExtractPlaneCrossingCells();
+  ~vtkExtractPlaneCrossingCells() override;
+
+  int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
+
+  /// Returns true if the cell index must be rebuilt for the given input and plane normal.
+  bool IsIndexOutdated(vtkPolyData* input, const double normal[3]);
+
+  /// Compute the extent of each cell along the normal and sort the cells by minimum extent.
+  void BuildIndex(vtkPolyData* input, const double normal[3]);
+
+  vtkSmartPointer<vtkPlane> Plane;
+  double Tolerance{ 1e-6 };
+
+  int NumberOfIndexBuilds{ 0 };
+  vtkIdType NumberOfExtractedCells{ 0 };
+
+private:
+  vtkExtractPlaneCrossingCells(const vtkExtractPlaneCrossingCells&) = delete;
+  void operator=(const vtkExtractPlaneCrossingCells&) = delete;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+};
+
+#endif
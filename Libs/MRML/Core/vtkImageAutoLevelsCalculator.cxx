@@ -0,0 +1,419 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkImageAutoLevelsCalculator.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
+#include <vtkTimeStamp.h>
+#include <vtkWeakPointer.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+vtkStandardNewMacro(vtkImageAutoLevelsCalculator);
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Seeds of the pseudo-random positions within strata. Probe samples use a different seed than
+/// histogram samples so that they are not a subset of the voxels that the previous result was computed from.
+const std::uint64_t HISTOGRAM_SAMPLES_SEED = 0x9E3779B97F4A7C15ull;
+const std::uint64_t PROBE_SAMPLES_SEED = 0xD1B54A32D192ED03ull;
+
+//----------------------------------------------------------------------------
+std::uint64_t Hash(std::uint64_t value)
+{
+  // splitmix64 finalizer
+  value += 0x9E3779B97F4A7C15ull;
+  value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+  value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+  return value ^ (value >> 31);
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+bool IsFiniteValue(T value)
+{
+  if constexpr (std::is_floating_point<T>::value)
+  {
+    return std::isfinite(value);
+  }
+  else
+  {
+    return true;
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Stratified subsample of the voxels of an image: voxels are split into NumberOfSamples
+/// equal-sized strata and one voxel is taken from each stratum at a pseudo-random position.
+struct StratifiedSamples
+{
+  vtkIdType NumberOfTuples{ 0 };
+  vtkIdType NumberOfSamples{ 0 };
+  std::uint64_t Seed{ 0 };
+
+  StratifiedSamples(vtkIdType numberOfTuples, vtkIdType numberOfSamples, std::uint64_t seed)
+    : NumberOfTuples(numberOfTuples)
+    , NumberOfSamples(std::min(numberOfSamples, numberOfTuples))
+    , Seed(seed)
+  {
+  }
+
+  vtkIdType GetTupleIndex(vtkIdType sampleIndex) const
+  {
+    if (this->NumberOfSamples >= this->NumberOfTuples)
+    {
+      return sampleIndex;
+    }
+    const double stratumSize = static_cast<double>(this->NumberOfTuples) / this->NumberOfSamples;
+    const vtkIdType stratumBegin = static_cast<vtkIdType>(sampleIndex * stratumSize);
+    const vtkIdType stratumEnd = std::min(static_cast<vtkIdType>((sampleIndex + 1) * stratumSize), this->NumberOfTuples);
+    const vtkIdType size = std::max<vtkIdType>(stratumEnd - stratumBegin, 1);
+    return stratumBegin + static_cast<vtkIdType>(Hash(static_cast<std::uint64_t>(sampleIndex) ^ this->Seed) % static_cast<std::uint64_t>(size));
+  }
+};
+
+//----------------------------------------------------------------------------
+struct ValueRange
+{
+  double Minimum{ VTK_DOUBLE_MAX };
+  double Maximum{ VTK_DOUBLE_MIN };
+  vtkIdType Count{ 0 };
+};
+
+//----------------------------------------------------------------------------
+template <class T>
+ValueRange ComputeValueRange(const T* values, int numberOfComponents, const StratifiedSamples& samples)
+{
+  vtkSMPThreadLocal<ValueRange> localRanges;
+  vtkSMPTools::For(0,
+                   samples.NumberOfSamples,
+                   [&](vtkIdType begin, vtkIdType end)
+                   {
+                     ValueRange& range = localRanges.Local();
+                     for (vtkIdType sampleIndex = begin; sampleIndex < end; ++sampleIndex)
+                     {
+                       const T value = values[samples.GetTupleIndex(sampleIndex) * numberOfComponents];
+                       if (!IsFiniteValue(value))
+                       {
+                         continue;
+                       }
+                       range.Minimum = std::min(range.Minimum, static_cast<double>(value));
+                       range.Maximum = std::max(range.Maximum, static_cast<double>(value));
+                       ++range.Count;
+                     }
+                   });
+  ValueRange range;
+  for (const ValueRange& localRange : localRanges)
+  {
+    range.Minimum = std::min(range.Minimum, localRange.Minimum);
+    range.Maximum = std::max(range.Maximum, localRange.Maximum);
+    range.Count += localRange.Count;
+  }
+  return range;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void ComputeHistogram(const T* values,
+                      int numberOfComponents,
+                      const StratifiedSamples& samples,
+                      double origin,
+                      double binWidth,
+                      std::vector<vtkIdType>& histogram)
+{
+  const int numberOfBins = static_cast<int>(histogram.size());
+  vtkSMPThreadLocal<std::vector<vtkIdType>> localHistograms;
+  vtkSMPTools::For(0,
+                   samples.NumberOfSamples,
+                   [&](vtkIdType begin, vtkIdType end)
+                   {
+                     std::vector<vtkIdType>& localHistogram = localHistograms.Local();
+                     localHistogram.resize(numberOfBins, 0);
+                     for (vtkIdType sampleIndex = begin; sampleIndex < end; ++sampleIndex)
+                     {
+                       const T value = values[samples.GetTupleIndex(sampleIndex) * numberOfComponents];
+                       if (!IsFiniteValue(value))
+                       {
+                         continue;
+                       }
+                       int bin = static_cast<int>((static_cast<double>(value) - origin) / binWidth);
+                       bin = std::min(std::max(bin, 0), numberOfBins - 1);
+                       ++localHistogram[bin];
+                     }
+                   });
+  std::fill(histogram.begin(), histogram.end(), 0);
+  for (const std::vector<vtkIdType>& localHistogram : localHistograms)
+  {
+    for (int bin = 0; bin < static_cast<int>(localHistogram.size()); ++bin)
+    {
+      histogram[bin] += localHistogram[bin];
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Number of samples below, at or below, above, and at or above the given range.
+struct ProbeCounts
+{
+  vtkIdType Below{ 0 };
+  vtkIdType AtOrBelow{ 0 };
+  vtkIdType Above{ 0 };
+  vtkIdType AtOrAbove{ 0 };
+  vtkIdType Count{ 0 };
+};
+
+//----------------------------------------------------------------------------
+template <class T>
+ProbeCounts CountProbeSamples(const T* values, int numberOfComponents, const StratifiedSamples& samples, const double range[2])
+{
+  vtkSMPThreadLocal<ProbeCounts> localCounts;
+  vtkSMPTools::For(0,
+                   samples.NumberOfSamples,
+                   [&](vtkIdType begin, vtkIdType end)
+                   {
+                     ProbeCounts& counts = localCounts.Local();
+                     for (vtkIdType sampleIndex = begin; sampleIndex < end; ++sampleIndex)
+                     {
+                       const T value = values[samples.GetTupleIndex(sampleIndex) * numberOfComponents];
+                       if (!IsFiniteValue(value))
+                       {
+                         continue;
+                       }
+                       const double doubleValue = static_cast<double>(value);
+                       counts.Below += (doubleValue < range[0]);
+                       counts.AtOrBelow += (doubleValue <= range[0]);
+                       counts.Above += (doubleValue > range[1]);
+                       counts.AtOrAbove += (doubleValue >= range[1]);
+                       ++counts.Count;
+                     }
+                   });
+  ProbeCounts counts;
+  for (const ProbeCounts& localCount : localCounts)
+  {
+    counts.Below += localCount.Below;
+    counts.AtOrBelow += localCount.AtOrBelow;
+    counts.Above += localCount.Above;
+    counts.AtOrAbove += localCount.AtOrAbove;
+    counts.Count += localCount.Count;
+  }
+  return counts;
+}
+
+//----------------------------------------------------------------------------
+/// Index of the histogram bin that contains the sample of the given rank (1-based).
+int FindBinOfRank(const std::vector<vtkIdType>& histogram, vtkIdType rank)
+{
+  vtkIdType cumulativeCount = 0;
+  for (int bin = 0; bin < static_cast<int>(histogram.size()); ++bin)
+  {
+    cumulativeCount += histogram[bin];
+    if (cumulativeCount >= rank)
+    {
+      return bin;
+    }
+  }
+  return static_cast<int>(histogram.size()) - 1;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+class vtkImageAutoLevelsCalculator::vtkInternal
+{
+public:
+  /// Image and its modified time that the current result was computed for
+  vtkWeakPointer<vtkImageData> Image;
+  vtkMTimeType ImageMTime{ 0 };
+  /// Time of the last computation, to detect parameter changes
+  vtkTimeStamp ComputeTime;
+  bool ResultValid{ false };
+  std::vector<vtkIdType> Histogram;
+};
+
+//----------------------------------------------------------------------------
+vtkImageAutoLevelsCalculator::vtkImageAutoLevelsCalculator()
+{
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkImageAutoLevelsCalculator::~vtkImageAutoLevelsCalculator()
+{
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageAutoLevelsCalculator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "AutoRangePercentiles: " << this->AutoRangePercentiles[0] << ", " << this->AutoRangePercentiles[1] << "\n";
+  os << indent << "MaximumPercentileError: " << this->MaximumPercentileError << "\n";
+  os << indent << "ErrorProbability: " << this->ErrorProbability << "\n";
+  os << indent << "MaximumNumberOfBins: " << this->MaximumNumberOfBins << "\n";
+  os << indent << "ReusePreviousResult: " << (this->ReusePreviousResult ? "true" : "false") << "\n";
+  os << indent << "ReuseTolerance: " << this->ReuseTolerance << "\n";
+  os << indent << "NumberOfProbeSamples: " << this->NumberOfProbeSamples << "\n";
+  os << indent << "AutoRange: " << this->AutoRange[0] << ", " << this->AutoRange[1] << "\n";
+  os << indent << "NumberOfSamples: " << this->NumberOfSamples << "\n";
+  os << indent << "NumberOfHistogramComputations: " << this->NumberOfHistogramComputations << "\n";
+  os << indent << "NumberOfReusedResults: " << this->NumberOfReusedResults << "\n";
+  os << indent << "NumberOfCachedResults: " << this->NumberOfCachedResults << "\n";
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkImageAutoLevelsCalculator::GetRequiredNumberOfSamples()
+{
+  if (this->MaximumPercentileError <= 0.0)
+  {
+    return VTK_ID_MAX;
+  }
+  // Hoeffding's inequality for each of the two percentiles: P(|error| > e) <= 2 * exp(-2 * n * e^2)
+  const double error = this->MaximumPercentileError / 100.0;
+  const double numberOfSamples = std::ceil(std::log(4.0 / this->ErrorProbability) / (2.0 * error * error));
+  return numberOfSamples < static_cast<double>(VTK_ID_MAX) ? static_cast<vtkIdType>(numberOfSamples) : VTK_ID_MAX;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageAutoLevelsCalculator::ResetCache()
+{
+  this->Internal->ResultValid = false;
+  this->Internal->Image = nullptr;
+  this->Internal->ImageMTime = 0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkImageAutoLevelsCalculator::Compute(vtkImageData* image)
+{
+  vtkDataArray* scalars = (image && image->GetPointData() ? image->GetPointData()->GetScalars() : nullptr);
+  if (!scalars || scalars->GetNumberOfTuples() == 0 || !scalars->HasStandardMemoryLayout())
+  {
+    vtkDebugMacro("Compute: invalid input image scalars");
+    return false;
+  }
+
+  const bool parametersChanged = (this->GetMTime() > this->Internal->ComputeTime.GetMTime());
+  if (this->Internal->ResultValid && !parametersChanged && this->Internal->Image == image && this->Internal->ImageMTime == image->GetMTime())
+  {
+    this->NumberOfCachedResults++;
+    return true;
+  }
+
+  const vtkIdType numberOfTuples = scalars->GetNumberOfTuples();
+  const int numberOfComponents = scalars->GetNumberOfComponents();
+  void* values = scalars->GetVoidPointer(0);
+  const int dataType = scalars->GetDataType();
+
+  // Check if the previous range is still valid for the new image
+  if (this->ReusePreviousResult && this->Internal->ResultValid && !parametersChanged)
+  {
+    StratifiedSamples probeSamples(numberOfTuples, this->NumberOfProbeSamples, PROBE_SAMPLES_SEED);
+    ProbeCounts counts;
+    switch (dataType)
+    {
+      vtkTemplateMacro(counts = CountProbeSamples(static_cast<VTK_TT*>(values), numberOfComponents, probeSamples, this->AutoRange));
+    }
+    if (counts.Count > 0)
+    {
+      const double tolerance = this->ReuseTolerance / 100.0;
+      const double lowerFraction = this->AutoRangePercentiles[0] / 100.0;
+      const double upperFraction = 1.0 - this->AutoRangePercentiles[1] / 100.0;
+      const double count = static_cast<double>(counts.Count);
+      if (counts.Below / count <= lowerFraction + tolerance && counts.AtOrBelow / count >= lowerFraction - tolerance //
+          && counts.Above / count <= upperFraction + tolerance && counts.AtOrAbove / count >= upperFraction - tolerance)
+      {
+        this->Internal->Image = image;
+        this->Internal->ImageMTime = image->GetMTime();
+        this->Internal->ComputeTime.Modified();
+        this->NumberOfReusedResults++;
+        return true;
+      }
+    }
+  }
+
+  this->Internal->ResultValid = false;
+  StratifiedSamples samples(numberOfTuples, this->GetRequiredNumberOfSamples(), HISTOGRAM_SAMPLES_SEED);
+  ValueRange range;
+  switch (dataType)
+  {
+    vtkTemplateMacro(range = ComputeValueRange(static_cast<VTK_TT*>(values), numberOfComponents, samples));
+  }
+  if (range.Count == 0)
+  {
+    vtkDebugMacro("Compute: input image does not contain finite values");
+    return false;
+  }
+
+  // Integer images with small value range get one bin per value, which gives exact percentile values
+  const bool integerBins = (dataType != VTK_FLOAT && dataType != VTK_DOUBLE && range.Maximum - range.Minimum < this->MaximumNumberOfBins);
+  int numberOfBins = this->MaximumNumberOfBins;
+  double binWidth = (range.Maximum - range.Minimum) / numberOfBins;
+  if (integerBins)
+  {
+    numberOfBins = static_cast<int>(range.Maximum - range.Minimum) + 1;
+    binWidth = 1.0;
+  }
+  else if (binWidth <= 0.0)
+  {
+    numberOfBins = 1;
+    binWidth = 1.0;
+  }
+  std::vector<vtkIdType>& histogram = this->Internal->Histogram;
+  histogram.assign(numberOfBins, 0);
+  switch (dataType)
+  {
+    vtkTemplateMacro(ComputeHistogram(static_cast<VTK_TT*>(values), numberOfComponents, samples, range.Minimum, binWidth, histogram));
+  }
+
+  // Nearest-rank percentiles
+  const double total = static_cast<double>(range.Count);
+  const vtkIdType lowerRank = std::max<vtkIdType>(static_cast<vtkIdType>(std::ceil(this->AutoRangePercentiles[0] / 100.0 * total)), 1);
+  const vtkIdType upperRank = std::max<vtkIdType>(static_cast<vtkIdType>(std::ceil(this->AutoRangePercentiles[1] / 100.0 * total)), 1);
+  const int lowerBin = FindBinOfRank(histogram, lowerRank);
+  const int upperBin = FindBinOfRank(histogram, upperRank);
+  if (integerBins)
+  {
+    this->AutoRange[0] = range.Minimum + lowerBin;
+    this->AutoRange[1] = range.Minimum + upperBin;
+  }
+  else
+  {
+    this->AutoRange[0] = range.Minimum + lowerBin * binWidth;
+    this->AutoRange[1] = std::min(range.Minimum + (upperBin + 1) * binWidth, range.Maximum);
+  }
+
+  this->NumberOfSamples = samples.NumberOfSamples;
+  this->NumberOfHistogramComputations++;
+  this->Internal->Image = image;
+  this->Internal->ImageMTime = image->GetMTime();
+  this->Internal->ComputeTime.Modified();
+  this->Internal->ResultValid = true;
+  return true;
+}
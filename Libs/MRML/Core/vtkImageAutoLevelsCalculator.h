@@ -0,0 +1,142 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+/**
+ * @class   vtkImageAutoLevelsCalculator
+ * @brief   Compute automatic display range (lower and upper percentile) of an image from a voxel subsample.
+ *
+ * Percentiles are computed from a histogram of a deterministic stratified subsample of the voxels:
+ * voxels are split into equal-sized strata and one voxel is taken from each stratum at a pseudo-random
+ * (but reproducible) position. Since the samples are independent and the expected fraction of samples
+ * below any value is the same as the fraction of all voxels, by Hoeffding's inequality the percentile rank
+ * of each computed value differs from the requested percentile by at most MaximumPercentileError
+ * with probability 1 - ErrorProbability. The number of samples is chosen to guarantee this bound.
+ * If the image has fewer voxels than the required number of samples then all voxels are used.
+ * Sampling and histogram computation are multithreaded (vtkSMPTools).
+ *
+ * Results are cached: computation is skipped if the image and its modified time are the same as in
+ * the previous computation.
+ *
+ * If ReusePreviousResult is enabled and the image changes (e.g., next frame of a sequence), a small probe
+ * sample is taken first and if the previous range is still within ReuseTolerance of the requested percentiles
+ * in the probe sample then the previous result is reused and no histogram is computed.
+ *
+ * Only the first component of the image scalars is used. NaN values are ignored.
+ */
+
+#ifndef vtkImageAutoLevelsCalculator_h
+#define vtkImageAutoLevelsCalculator_h
+
+// MRML includes
+#include "vtkMRML.h"
+
+// VTK includes
+#include <vtkObject.h>
+
+class vtkImageData;
+
+class VTK_MRML_EXPORT vtkImageAutoLevelsCalculator : public vtkObject
+{
+public:
+  static vtkImageAutoLevelsCalculator* New();
+  vtkTypeMacro(vtkImageAutoLevelsCalculator, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Lower and upper percentile (0-100) of the automatic range. Default is 0.1 and 99.9.
+  vtkSetVector2Macro(AutoRangePercentiles, double);
+  vtkGetVector2Macro(AutoRangePercentiles, double);
+
+  /// Maximum difference between the requested and the actual percentile rank of the computed range,
+  /// in percent. Default is 0.1. Set to 0 to use all voxels.
+  vtkSetClampMacro(MaximumPercentileError, double, 0.0, 100.0);
+  vtkGetMacro(MaximumPercentileError, double);
+
+  /// Probability that the percentile error is larger than MaximumPercentileError. Default is 0.001.
+  vtkSetClampMacro(ErrorProbability, double, 1e-12, 1.0);
+  vtkGetMacro(ErrorProbability, double);
+
+  /// Maximum number of histogram bins. Integer images with smaller value range use one bin per value.
+  /// Default is 65536.
+  vtkSetClampMacro(MaximumNumberOfBins, int, 2, 1 << 24);
+  vtkGetMacro(MaximumNumberOfBins, int);
+
+  /// Reuse the previous result for a new image if its percentiles are still within ReuseTolerance.
+  /// The result then depends on the previously processed images, therefore it should only be enabled
+  /// when the displayed image changes frequently, for example during sequence playback. Disabled by default.
+  vtkSetMacro(ReusePreviousResult, bool);
+  vtkGetMacro(ReusePreviousResult, bool);
+  vtkBooleanMacro(ReusePreviousResult, bool);
+
+  /// Maximum difference (in percent) between the requested percentiles and the percentile rank of the previous
+  /// range in a new image, for the previous range to be reused. Must be smaller than the distance of the
+  /// percentiles from 0 and 100, otherwise a too wide previous range is always accepted. Default is 0.05.
+  vtkSetClampMacro(ReuseTolerance, double, 0.0, 100.0);
+  vtkGetMacro(ReuseTolerance, double);
+
+  /// Number of voxels that are checked to decide if the previous result can be reused. Default is 65536.
+  vtkSetClampMacro(NumberOfProbeSamples, vtkIdType, 1, VTK_ID_MAX);
+  vtkGetMacro(NumberOfProbeSamples, vtkIdType);
+
+  /// Compute the automatic range of the image. Returns false if the image has no valid scalars.
+  bool Compute(vtkImageData* image);
+
+  /// Automatic range computed by the last Compute() call.
+  vtkGetVector2Macro(AutoRange, double);
+
+  /// Number of samples required to guarantee the error bound.
+  vtkIdType GetRequiredNumberOfSamples();
+
+  /// Number of voxels used in the last histogram computation.
+  vtkGetMacro(NumberOfSamples, vtkIdType);
+
+  //@{
+  /// Number of times the histogram was computed, the previous result was reused for a new image,
+  /// or the cached result was returned for an unchanged image. Useful for testing and profiling.
+  vtkGetMacro(NumberOfHistogramComputations, int);
+  vtkGetMacro(NumberOfReusedResults, int);
+  vtkGetMacro(NumberOfCachedResults, int);
+  //@}
+
+  /// Remove cached result. The next computation will compute the histogram.
+  void ResetCache();
+
+protected:
+  vtkImageAutoLevelsCalculator();
+  ~vtkImageAutoLevelsCalculator() override;
+
+  double AutoRangePercentiles[2]{ 0.1, 99.9 };
+  double MaximumPercentileError{ 0.1 };
+  double ErrorProbability{ 0.001 };
+  int MaximumNumberOfBins{ 65536 };
+  bool ReusePreviousResult{ false };
+  double ReuseTolerance{ 0.05 };
+  vtkIdType NumberOfProbeSamples{ 65536 };
+
+  double AutoRange[2]{ 0.0, 0.0 };
+  vtkIdType NumberOfSamples{ 0 };
+  int NumberOfHistogramComputations{ 0 };
+  int NumberOfReusedResults{ 0 };
+  int NumberOfCachedResults{ 0 };
+
+private:
+  vtkImageAutoLevelsCalculator(const vtkImageAutoLevelsCalculator&) = delete;
+  void operator=(const vtkImageAutoLevelsCalculator&) = delete;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+};
+
+#endif
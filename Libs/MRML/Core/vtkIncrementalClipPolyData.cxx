@@ -0,0 +1,659 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkImplicitInvertableBoolean.h"
+#include "vtkIncrementalClipPolyData.h"
+#include "vtkMRMLTransformNode.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkClipPolyData.h>
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkIdList.h>
+#include <vtkImplicitBoolean.h>
+#include <vtkImplicitFunctionCollection.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPlane.h>
+#include <vtkPlanes.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPThreadLocalObject.h>
+#include <vtkSMPTools.h>
+#include <vtkTransform.h>
+#include <vtkWeakPointer.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+vtkStandardNewMacro(vtkIncrementalClipPolyData);
+
+namespace
+{
+const char* CLIP_VALUES_ARRAY_NAME = "vtkIncrementalClipPolyDataValues";
+
+//----------------------------------------------------------------------------
+// Plane term of the clip function: value(x) = Normal . x + Offset
+struct ClipPlane
+{
+  double Normal[3];
+  double Offset;
+};
+
+//----------------------------------------------------------------------------
+// Instruction of the postfix program that computes the clip function value from the plane terms.
+struct ClipInstruction
+{
+  enum
+  {
+    PlaneTerm,
+    Zero,
+    Union,
+    Intersection,
+    Difference,
+    UnionOfMagnitudes
+  };
+  int Type;
+  int PlaneIndex;
+  int NumberOfOperands;
+  bool Invert;
+};
+
+//----------------------------------------------------------------------------
+// Decompose the implicit function into plane terms and a postfix program that combines them.
+// The matrix transforms points from the input coordinate system to the function's coordinate system.
+// Returns false if the function contains anything else than planes and boolean operations or non-linear transforms.
+bool CompileClipFunction(vtkImplicitFunction* function, vtkMatrix4x4* parentMatrix, std::vector<ClipPlane>& planes, std::vector<ClipInstruction>& instructions)
+{
+  if (!function)
+  {
+    return false;
+  }
+
+  // vtkImplicitFunction::FunctionValue evaluates the function at the transformed point
+  vtkNew<vtkMatrix4x4> matrix;
+  matrix->DeepCopy(parentMatrix);
+  if (function->GetTransform())
+  {
+    vtkNew<vtkTransform> linearTransform;
+    if (!vtkMRMLTransformNode::IsGeneralTransformLinear(function->GetTransform(), linearTransform))
+    {
+      return false;
+    }
+    vtkMatrix4x4* functionMatrix = linearTransform->GetMatrix();
+    if (functionMatrix->GetElement(3, 0) != 0.0 || functionMatrix->GetElement(3, 1) != 0.0 //
+        || functionMatrix->GetElement(3, 2) != 0.0 || functionMatrix->GetElement(3, 3) != 1.0)
+    {
+      // perspective transform
+      return false;
+    }
+    vtkMatrix4x4::Multiply4x4(functionMatrix, parentMatrix, matrix);
+  }
+
+  // Add plane term normal . (M * x) + offset, expressed in the input coordinate system
+  auto addPlaneTerm = [&](const double normal[3], double offset)
+  {
+    ClipPlane plane;
+    for (int j = 0; j < 3; ++j)
+    {
+      plane.Normal[j] = 0.0;
+      for (int i = 0; i < 3; ++i)
+      {
+        plane.Normal[j] += normal[i] * matrix->GetElement(i, j);
+      }
+    }
+    plane.Offset = offset;
+    for (int i = 0; i < 3; ++i)
+    {
+      plane.Offset += normal[i] * matrix->GetElement(i, 3);
+    }
+    ClipInstruction instruction;
+    instruction.Type = ClipInstruction::PlaneTerm;
+    instruction.PlaneIndex = static_cast<int>(planes.size());
+    instruction.NumberOfOperands = 0;
+    instruction.Invert = false;
+    planes.push_back(plane);
+    instructions.push_back(instruction);
+  };
+
+  vtkImplicitBoolean* booleanFunction = vtkImplicitBoolean::SafeDownCast(function);
+  if (booleanFunction)
+  {
+    ClipInstruction instruction;
+    instruction.PlaneIndex = -1;
+    vtkImplicitInvertableBoolean* invertableBooleanFunction = vtkImplicitInvertableBoolean::SafeDownCast(function);
+    instruction.Invert = invertableBooleanFunction && invertableBooleanFunction->GetInvert();
+    vtkImplicitFunctionCollection* functions = booleanFunction->GetFunction();
+    instruction.NumberOfOperands = functions->GetNumberOfItems();
+    if (instruction.NumberOfOperands == 0)
+    {
+      // vtkImplicitBoolean returns 0 if there are no functions
+      instruction.Type = ClipInstruction::Zero;
+      instructions.push_back(instruction);
+      return true;
+    }
+    switch (booleanFunction->GetOperationType())
+    {
+      case vtkImplicitBoolean::VTK_UNION: instruction.Type = ClipInstruction::Union; break;
+      case vtkImplicitBoolean::VTK_INTERSECTION: instruction.Type = ClipInstruction::Intersection; break;
+      case vtkImplicitBoolean::VTK_DIFFERENCE: instruction.Type = ClipInstruction::Difference; break;
+      case vtkImplicitBoolean::VTK_UNION_OF_MAGNITUDES: instruction.Type = ClipInstruction::UnionOfMagnitudes; break;
+      default: return false;
+    }
+    for (int i = 0; i < instruction.NumberOfOperands; ++i)
+    {
+      if (!CompileClipFunction(vtkImplicitFunction::SafeDownCast(functions->GetItemAsObject(i)), matrix, planes, instructions))
+      {
+        return false;
+      }
+    }
+    instructions.push_back(instruction);
+    return true;
+  }
+
+  vtkPlanes* planesFunction = vtkPlanes::SafeDownCast(function);
+  if (planesFunction)
+  {
+    // vtkPlanes value is the maximum of the (not normalized) plane function values
+    vtkDataArray* normals = planesFunction->GetNormals();
+    vtkPoints* points = planesFunction->GetPoints();
+    int numberOfPlanes = planesFunction->GetNumberOfPlanes();
+    if (!normals || !points || numberOfPlanes == 0 || normals->GetNumberOfTuples() < numberOfPlanes)
+    {
+      return false;
+    }
+    for (int i = 0; i < numberOfPlanes; ++i)
+    {
+      double normal[3] = { 0.0, 0.0, 0.0 };
+      normals->GetTuple(i, normal);
+      double point[3] = { 0.0, 0.0, 0.0 };
+      points->GetPoint(i, point);
+      addPlaneTerm(normal, -(normal[0] * point[0] + normal[1] * point[1] + normal[2] * point[2]));
+    }
+    ClipInstruction instruction;
+    instruction.Type = ClipInstruction::Intersection;
+    instruction.PlaneIndex = -1;
+    instruction.NumberOfOperands = numberOfPlanes;
+    instruction.Invert = false;
+    instructions.push_back(instruction);
+    return true;
+  }
+
+  vtkPlane* planeFunction = vtkPlane::SafeDownCast(function);
+  if (planeFunction)
+  {
+    // Plane function is affine, its value at the origin gives the offset
+    double normal[3] = { 0.0, 0.0, 0.0 };
+    planeFunction->GetNormal(normal);
+    double origin[3] = { 0.0, 0.0, 0.0 };
+    addPlaneTerm(normal, planeFunction->EvaluateFunction(origin));
+    return true;
+  }
+
+  return false;
+}
+
+//----------------------------------------------------------------------------
+// Compute dot product of the plane normal and each input point.
+struct PlaneDotFunctor
+{
+  vtkPoints* Points{ nullptr };
+  const double* Normal{ nullptr };
+  double* Output{ nullptr };
+
+  void operator()(vtkIdType beginPointId, vtkIdType endPointId)
+  {
+    double point[3] = { 0.0, 0.0, 0.0 };
+    for (vtkIdType pointId = beginPointId; pointId < endPointId; ++pointId)
+    {
+      this->Points->GetPoint(pointId, point);
+      this->Output[pointId] = this->Normal[0] * point[0] + this->Normal[1] * point[1] + this->Normal[2] * point[2];
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Run the postfix program for each input point.
+struct ClipValueFunctor
+{
+  const std::vector<ClipInstruction>* Instructions{ nullptr };
+  const std::vector<ClipPlane>* Planes{ nullptr };
+  const std::vector<const double*>* PlaneDots{ nullptr };
+  double* Output{ nullptr };
+
+  vtkSMPThreadLocal<std::vector<double>> Stack;
+
+  void operator()(vtkIdType beginPointId, vtkIdType endPointId)
+  {
+    std::vector<double>& stack = this->Stack.Local();
+    stack.resize(this->Instructions->size());
+    const ClipInstruction* instructions = this->Instructions->data();
+    const size_t numberOfInstructions = this->Instructions->size();
+    const ClipPlane* planes = this->Planes->data();
+    const double* const* planeDots = this->PlaneDots->data();
+    for (vtkIdType pointId = beginPointId; pointId < endPointId; ++pointId)
+    {
+      size_t stackSize = 0;
+      for (size_t instructionIndex = 0; instructionIndex < numberOfInstructions; ++instructionIndex)
+      {
+        const ClipInstruction& instruction = instructions[instructionIndex];
+        double value = 0.0;
+        if (instruction.Type == ClipInstruction::PlaneTerm)
+        {
+          value = planeDots[instruction.PlaneIndex][pointId] + planes[instruction.PlaneIndex].Offset;
+        }
+        else if (instruction.Type != ClipInstruction::Zero)
+        {
+          // Same operations as in vtkImplicitBoolean::EvaluateFunction
+          const double* operands = stack.data() + stackSize - instruction.NumberOfOperands;
+          stackSize -= instruction.NumberOfOperands;
+          value = operands[0];
+          switch (instruction.Type)
+          {
+            case ClipInstruction::Union:
+              for (int i = 1; i < instruction.NumberOfOperands; ++i)
+              {
+                value = std::min(value, operands[i]);
+              }
+              break;
+            case ClipInstruction::Intersection:
+              for (int i = 1; i < instruction.NumberOfOperands; ++i)
+              {
+                value = std::max(value, operands[i]);
+              }
+              break;
+            case ClipInstruction::Difference:
+              for (int i = 1; i < instruction.NumberOfOperands; ++i)
+              {
+                value = std::max(value, -operands[i]);
+              }
+              break;
+            case ClipInstruction::UnionOfMagnitudes:
+              value = std::fabs(value);
+              for (int i = 1; i < instruction.NumberOfOperands; ++i)
+              {
+                value = std::min(value, std::fabs(operands[i]));
+              }
+              break;
+          }
+          if (instruction.Invert)
+          {
+            value = -value;
+          }
+        }
+        stack[stackSize++] = value;
+      }
+      this->Output[pointId] = stack[0];
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Determine which cells are kept by whole cell extraction.
+struct KeepCellFunctor
+{
+  vtkCellArray* Cells{ nullptr };
+  const double* ClipValues{ nullptr };
+  bool ExtractBoundaryCells{ false };
+  unsigned char* Output{ nullptr };
+
+  vtkSMPThreadLocalObject<vtkIdList> PointIds;
+
+  void operator()(vtkIdType beginCellIndex, vtkIdType endCellIndex)
+  {
+    vtkIdList* pointIds = this->PointIds.Local();
+    for (vtkIdType cellIndex = beginCellIndex; cellIndex < endCellIndex; ++cellIndex)
+    {
+      this->Cells->GetCellAtId(cellIndex, pointIds);
+      vtkIdType numberOfPoints = pointIds->GetNumberOfIds();
+      bool allOutside = numberOfPoints > 0;
+      bool anyOutside = false;
+      for (vtkIdType i = 0; i < numberOfPoints; ++i)
+      {
+        double value = this->ClipValues[pointIds->GetId(i)];
+        allOutside = allOutside && value > 0.0;
+        anyOutside = anyOutside || value >= 0.0;
+      }
+      this->Output[cellIndex] = (allOutside || (this->ExtractBoundaryCells && anyOutside)) ? 1 : 0;
+    }
+  }
+};
+
+} // namespace
+
+//----------------------------------------------------------------------------
+class vtkIncrementalClipPolyData::vtkInternal
+{
+public:
+  /// Dot product of a plane normal and each input point
+  struct PlaneCache
+  {
+    double Normal[3];
+    std::vector<double> Dots;
+  };
+  std::vector<PlaneCache> PlaneCaches;
+  vtkWeakPointer<vtkPoints> CachedPoints;
+  vtkMTimeType CachedPointsMTime{ 0 };
+
+  vtkNew<vtkClipPolyData> Clipper;
+};
+
+//----------------------------------------------------------------------------
+vtkIncrementalClipPolyData::vtkIncrementalClipPolyData()
+{
+  this->Internal = new vtkInternal;
+  this->Internal->Clipper->SetValue(0.0);
+  this->Internal->Clipper->SetInputArrayToProcess(0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS, CLIP_VALUES_ARRAY_NAME);
+}
+
+//----------------------------------------------------------------------------
+vtkIncrementalClipPolyData::~vtkIncrementalClipPolyData()
+{
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkIncrementalClipPolyData::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "ClipFunction: " << this->ClipFunction.GetPointer() << "\n";
+  os << indent << "ClippingMethod: " << this->ClippingMethod << "\n";
+  os << indent << "NumberOfPlaneDistanceComputations: " << this->NumberOfPlaneDistanceComputations << "\n";
+  os << indent << "ClipFunctionEvaluated: " << (this->ClipFunctionEvaluated ? "true" : "false") << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkIncrementalClipPolyData::SetClipFunction(vtkImplicitFunction* function)
+{
+  if (this->ClipFunction == function)
+  {
+    return;
+  }
+  this->ClipFunction = function;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkImplicitFunction* vtkIncrementalClipPolyData::GetClipFunction()
+{
+  return this->ClipFunction;
+}
+
+//----------------------------------------------------------------------------
+vtkMTimeType vtkIncrementalClipPolyData::GetMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetMTime();
+  if (this->ClipFunction)
+  {
+    mTime = std::max(mTime, this->ClipFunction->GetMTime());
+  }
+  return mTime;
+}
+
+//----------------------------------------------------------------------------
+void vtkIncrementalClipPolyData::ResetCache()
+{
+  this->Internal->PlaneCaches.clear();
+  this->Internal->CachedPoints = nullptr;
+  this->Internal->CachedPointsMTime = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkIncrementalClipPolyData::ComputeClipValues(vtkPolyData* input, double* clipValues)
+{
+  vtkPoints* points = input->GetPoints();
+  vtkIdType numberOfPoints = input->GetNumberOfPoints();
+
+  std::vector<ClipPlane> planes;
+  std::vector<ClipInstruction> instructions;
+  vtkNew<vtkMatrix4x4> identityMatrix;
+  this->ClipFunctionEvaluated = !CompileClipFunction(this->ClipFunction, identityMatrix, planes, instructions);
+  if (this->ClipFunctionEvaluated)
+  {
+    // Implicit functions are not guaranteed to be thread-safe, evaluate on a single thread
+    this->ResetCache();
+    double point[3] = { 0.0, 0.0, 0.0 };
+    for (vtkIdType pointId = 0; pointId < numberOfPoints; ++pointId)
+    {
+      points->GetPoint(pointId, point);
+      clipValues[pointId] = this->ClipFunction->FunctionValue(point);
+    }
+    return;
+  }
+
+  if (this->Internal->CachedPoints.GetPointer() != points || this->Internal->CachedPointsMTime != points->GetMTime())
+  {
+    this->ResetCache();
+  }
+
+  // Reuse the cached dot products of planes that have the same normal as before (only moved along the normal)
+  std::vector<vtkInternal::PlaneCache> planeCaches(planes.size());
+  std::vector<const double*> planeDots(planes.size(), nullptr);
+  for (size_t planeIndex = 0; planeIndex < planes.size(); ++planeIndex)
+  {
+    const double* normal = planes[planeIndex].Normal;
+    vtkInternal::PlaneCache& planeCache = planeCaches[planeIndex];
+    std::copy(normal, normal + 3, planeCache.Normal);
+    auto cachedIt = std::find_if(this->Internal->PlaneCaches.begin(),
+                                 this->Internal->PlaneCaches.end(),
+                                 [normal](const vtkInternal::PlaneCache& cache)
+                                 { return !cache.Dots.empty() && cache.Normal[0] == normal[0] && cache.Normal[1] == normal[1] && cache.Normal[2] == normal[2]; });
+    if (cachedIt != this->Internal->PlaneCaches.end())
+    {
+      planeCache.Dots.swap(cachedIt->Dots);
+    }
+    else
+    {
+      // The same normal may occur multiple times in the clip function
+      for (size_t previousPlaneIndex = 0; previousPlaneIndex < planeIndex; ++previousPlaneIndex)
+      {
+        const double* previousNormal = planeCaches[previousPlaneIndex].Normal;
+        if (previousNormal[0] == normal[0] && previousNormal[1] == normal[1] && previousNormal[2] == normal[2])
+        {
+          planeDots[planeIndex] = planeDots[previousPlaneIndex];
+          break;
+        }
+      }
+      if (planeDots[planeIndex])
+      {
+        continue;
+      }
+      planeCache.Dots.resize(numberOfPoints);
+      PlaneDotFunctor functor;
+      functor.Points = points;
+      functor.Normal = planeCache.Normal;
+      functor.Output = planeCache.Dots.data();
+      vtkSMPTools::For(0, numberOfPoints, functor);
+      this->NumberOfPlaneDistanceComputations++;
+    }
+    planeDots[planeIndex] = planeCache.Dots.data();
+  }
+  this->Internal->PlaneCaches.swap(planeCaches);
+  this->Internal->CachedPoints = points;
+  this->Internal->CachedPointsMTime = points->GetMTime();
+
+  ClipValueFunctor functor;
+  functor.Instructions = &instructions;
+  functor.Planes = &planes;
+  functor.PlaneDots = &planeDots;
+  functor.Output = clipValues;
+  vtkSMPTools::For(0, numberOfPoints, functor);
+}
+
+//----------------------------------------------------------------------------
+void vtkIncrementalClipPolyData::ExtractWholeCells(vtkPolyData* input, const double* clipValues, vtkPolyData* output)
+{
+  // Cell IDs in a polydata are ordered as verts, lines, polys, strips.
+  vtkCellArray* inputCellArrays[4] = { input->GetVerts(), input->GetLines(), input->GetPolys(), input->GetStrips() };
+  vtkIdType numberOfCells[4] = { input->GetNumberOfVerts(), input->GetNumberOfLines(), input->GetNumberOfPolys(), input->GetNumberOfStrips() };
+
+  std::vector<unsigned char> keepCell(input->GetNumberOfCells(), 0);
+  vtkIdType cellIdOffset = 0;
+  for (int cellArrayIndex = 0; cellArrayIndex < 4; ++cellArrayIndex)
+  {
+    if (numberOfCells[cellArrayIndex] > 0)
+    {
+      KeepCellFunctor functor;
+      functor.Cells = inputCellArrays[cellArrayIndex];
+      functor.ClipValues = clipValues;
+      functor.ExtractBoundaryCells = (this->ClippingMethod == WholeCellsWithBoundary);
+      functor.Output = keepCell.data() + cellIdOffset;
+      vtkSMPTools::For(0, numberOfCells[cellArrayIndex], functor);
+    }
+    cellIdOffset += numberOfCells[cellArrayIndex];
+  }
+
+  // Only keep points that are used by the extracted cells
+  vtkIdType numberOfInputPoints = input->GetNumberOfPoints();
+  std::vector<vtkIdType> pointMap(numberOfInputPoints, -1);
+  vtkNew<vtkIdList> pointIds;
+  cellIdOffset = 0;
+  for (int cellArrayIndex = 0; cellArrayIndex < 4; ++cellArrayIndex)
+  {
+    for (vtkIdType cellIndex = 0; cellIndex < numberOfCells[cellArrayIndex]; ++cellIndex)
+    {
+      if (!keepCell[cellIdOffset + cellIndex])
+      {
+        continue;
+      }
+      inputCellArrays[cellArrayIndex]->GetCellAtId(cellIndex, pointIds);
+      for (vtkIdType i = 0; i < pointIds->GetNumberOfIds(); ++i)
+      {
+        pointMap[pointIds->GetId(i)] = 0;
+      }
+    }
+    cellIdOffset += numberOfCells[cellArrayIndex];
+  }
+  vtkIdType numberOfOutputPoints = 0;
+  for (vtkIdType& outputPointId : pointMap)
+  {
+    if (outputPointId == 0)
+    {
+      outputPointId = numberOfOutputPoints++;
+    }
+  }
+
+  vtkPoints* inputPoints = input->GetPoints();
+  vtkNew<vtkPoints> outputPoints;
+  outputPoints->SetDataType(inputPoints->GetDataType());
+  outputPoints->SetNumberOfPoints(numberOfOutputPoints);
+  vtkPointData* inputPointData = input->GetPointData();
+  vtkPointData* outputPointData = output->GetPointData();
+  outputPointData->CopyAllocate(inputPointData, numberOfOutputPoints);
+  for (vtkIdType inputPointId = 0; inputPointId < numberOfInputPoints; ++inputPointId)
+  {
+    vtkIdType outputPointId = pointMap[inputPointId];
+    if (outputPointId >= 0)
+    {
+      outputPoints->SetPoint(outputPointId, inputPoints->GetPoint(inputPointId));
+      outputPointData->CopyData(inputPointData, inputPointId, outputPointId);
+    }
+  }
+  output->SetPoints(outputPoints);
+
+  vtkCellData* inputCellData = input->GetCellData();
+  vtkCellData* outputCellData = output->GetCellData();
+  outputCellData->CopyAllocate(inputCellData, static_cast<vtkIdType>(std::count(keepCell.begin(), keepCell.end(), 1)));
+  vtkSmartPointer<vtkCellArray> outputCellArrays[4];
+  vtkIdType outputCellId = 0;
+  cellIdOffset = 0;
+  for (int cellArrayIndex = 0; cellArrayIndex < 4; ++cellArrayIndex)
+  {
+    outputCellArrays[cellArrayIndex] = vtkSmartPointer<vtkCellArray>::New();
+    for (vtkIdType cellIndex = 0; cellIndex < numberOfCells[cellArrayIndex]; ++cellIndex)
+    {
+      vtkIdType inputCellId = cellIdOffset + cellIndex;
+      if (!keepCell[inputCellId])
+      {
+        continue;
+      }
+      inputCellArrays[cellArrayIndex]->GetCellAtId(cellIndex, pointIds);
+      for (vtkIdType i = 0; i < pointIds->GetNumberOfIds(); ++i)
+      {
+        pointIds->SetId(i, pointMap[pointIds->GetId(i)]);
+      }
+      outputCellArrays[cellArrayIndex]->InsertNextCell(pointIds);
+      outputCellData->CopyData(inputCellData, inputCellId, outputCellId++);
+    }
+    cellIdOffset += numberOfCells[cellArrayIndex];
+  }
+  output->SetVerts(outputCellArrays[0]);
+  output->SetLines(outputCellArrays[1]);
+  output->SetPolys(outputCellArrays[2]);
+  output->SetStrips(outputCellArrays[3]);
+  output->Squeeze();
+}
+
+//----------------------------------------------------------------------------
+int vtkIncrementalClipPolyData::RequestData(vtkInformation* vtkNotUsed(request), vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkPolyData* input = vtkPolyData::GetData(inputVector[0], 0);
+  vtkPolyData* output = vtkPolyData::GetData(outputVector, 0);
+  if (!input || !output)
+  {
+    vtkErrorMacro("RequestData failed: invalid input or output");
+    return 0;
+  }
+
+  if (!this->ClipFunction)
+  {
+    // No clip function is specified, nothing is clipped
+    output->ShallowCopy(input);
+    return 1;
+  }
+  if (!input->GetPoints() || input->GetNumberOfPoints() == 0)
+  {
+    this->ResetCache();
+    output->Initialize();
+    return 1;
+  }
+
+  vtkNew<vtkDoubleArray> clipValues;
+  clipValues->SetName(CLIP_VALUES_ARRAY_NAME);
+  clipValues->SetNumberOfValues(input->GetNumberOfPoints());
+  this->ComputeClipValues(input, clipValues->GetPointer(0));
+
+  output->Initialize();
+  if (this->ClippingMethod == Straight)
+  {
+    // Clip with the computed values as scalars, which gives the same result as clipping with the function
+    vtkNew<vtkPolyData> clipperInput;
+    clipperInput->ShallowCopy(input);
+    clipperInput->GetPointData()->AddArray(clipValues);
+    this->Internal->Clipper->SetInputData(clipperInput);
+    this->Internal->Clipper->Update();
+    output->ShallowCopy(this->Internal->Clipper->GetOutput());
+    output->GetPointData()->RemoveArray(CLIP_VALUES_ARRAY_NAME);
+    this->Internal->Clipper->SetInputData(nullptr);
+  }
+  else
+  {
+    this->ExtractWholeCells(input, clipValues->GetPointer(0), output);
+  }
+
+  return 1;
+}
@@ -0,0 +1,123 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+/**
+ * @class   vtkIncrementalClipPolyData
+ * @brief   Clip a polydata with an implicit function, reusing signed distances computed in previous updates.
+ *
+ * The filter produces the same output as vtkClipPolyData (straight cut) or vtkExtractPolyDataGeometry
+ * (whole cell extraction, with ExtractInside off) but it is optimized for interactive clipping,
+ * when the clip function is modified repeatedly (e.g., a slice plane is moved).
+ *
+ * The clip function is decomposed into planes combined by vtkImplicitBoolean operations
+ * (vtkImplicitInvertableBoolean, vtkPlanes, vtkPlane, with optional linear transforms).
+ * For each plane the dot product of the normal and each input point is cached. If the plane is
+ * moved along its normal then only a constant offset changes, therefore the cached values are reused
+ * and only the boolean combination of the plane distances has to be computed. The cache of a plane is
+ * recomputed only when its normal or the input mesh changes. Computation of distances and
+ * whole cell extraction are multithreaded (vtkSMPTools).
+ *
+ * If the clip function contains any other implicit function (e.g., vtkSphere) or non-linear
+ * transform then the function is evaluated at each point, without caching.
+ */
+
+#ifndef vtkIncrementalClipPolyData_h
+#define vtkIncrementalClipPolyData_h
+
+// VTK includes
+#include <vtkPolyDataAlgorithm.h>
+#include <vtkSmartPointer.h>
+
+// MRML includes
+#include "vtkMRML.h"
+
+class vtkImplicitFunction;
+
+class VTK_MRML_EXPORT vtkIncrementalClipPolyData : public vtkPolyDataAlgorithm
+{
+public:
+  vtkTypeMacro(vtkIncrementalClipPolyData, vtkPolyDataAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+  static vtkIncrementalClipPolyData* New();
+
+  /// Clipping methods. Values are the same as in vtkMRMLClipNode::ClippingMethodType.
+  enum ClippingMethodType
+  {
+    Straight = 0,
+    WholeCells,
+    WholeCellsWithBoundary,
+  };
+
+  //@{
+  /**
+   * Implicit function that the input is clipped with. Parts of the mesh where the function
+   * value is positive are kept.
+   */
+  void SetClipFunction(vtkImplicitFunction* function);
+  vtkImplicitFunction* GetClipFunction();
+  //@}
+
+  //@{
+  /**
+   * Straight cut (default) or extraction of whole cells that are completely outside (or,
+   * with boundary, at least partially outside) of the clip function.
+   * \sa ClippingMethodType
+   */
+  vtkSetClampMacro(ClippingMethod, int, Straight, WholeCellsWithBoundary);
+  vtkGetMacro(ClippingMethod, int);
+  //@}
+
+  /// Return the mtime also considering the clip function.
+  vtkMTimeType GetMTime() override;
+
+  /// Number of times the distances from a plane were computed for all input points.
+  /// Useful for testing and profiling.
+  vtkGetMacro(NumberOfPlaneDistanceComputations, int);
+
+  /// Returns true if the clip function could not be decomposed into planes in the last update
+  /// and so it was evaluated directly at each point.
+  vtkGetMacro(ClipFunctionEvaluated, bool);
+
+  /// Remove all cached plane distances. They will be recomputed at the next update.
+  void ResetCache();
+
+protected:
+  vtkIncrementalClipPolyData();
+  ~vtkIncrementalClipPolyData() override;
+
+  int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
+
+  /// Compute clip function value at each input point.
+  void ComputeClipValues(vtkPolyData* input, double* clipValues);
+
+  /// Copy cells to the output that are outside (or, with boundary, partially outside) the clip function.
+  void ExtractWholeCells(vtkPolyData* input, const double* clipValues, vtkPolyData* output);
+
+  vtkSmartPointer<vtkImplicitFunction> ClipFunction;
+  int ClippingMethod{ Straight };
+
+  int NumberOfPlaneDistanceComputations{ 0 };
+  bool ClipFunctionEvaluated{ false };
+
+private:
+  vtkIncrementalClipPolyData(const vtkIncrementalClipPolyData&) = delete;
+  void operator=(const vtkIncrementalClipPolyData&) = delete;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+};
+
+#endif
@@ -0,0 +1,696 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkLosslessDeltaVolumeCodec.h"
+
+// vtkAddon includes
+#include <vtkStreamingVolumeFrame.h>
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkVariant.h>
+
+// STD includes
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+
+namespace
+{
+
+// Frame data layout:
+//   byte 0: format version
+//   byte 1: 1 for key frame (spatial prediction), 0 for delta frame (temporal prediction)
+//   byte 2: number of bytes per scalar element (= number of byte planes)
+//   byte 3: reserved
+//   bytes 4-7: number of scalar elements (little endian)
+//   byte planes, each starting with a PlaneEncoding byte
+const unsigned char FRAME_DATA_VERSION = 1;
+const size_t FRAME_HEADER_SIZE = 8;
+
+enum PlaneEncoding
+{
+  PlaneRaw = 0,
+  PlaneConstant = 1,
+  PlaneRANS = 2,
+};
+
+// rANS coder parameters: 32-bit states, byte-wise renormalization, 12-bit symbol frequencies
+const uint32_t RANS_SCALE_BITS = 12;
+const uint32_t RANS_SCALE = 1u << RANS_SCALE_BITS;
+const uint32_t RANS_LOWER_BOUND = 1u << 23;
+
+//----------------------------------------------------------------------------
+void AppendUInt32(std::vector<unsigned char>& output, uint32_t value)
+{
+  output.push_back(static_cast<unsigned char>(value));
+  output.push_back(static_cast<unsigned char>(value >> 8));
+  output.push_back(static_cast<unsigned char>(value >> 16));
+  output.push_back(static_cast<unsigned char>(value >> 24));
+}
+
+//----------------------------------------------------------------------------
+uint32_t ReadUInt32(const unsigned char* input)
+{
+  return static_cast<uint32_t>(input[0]) | (static_cast<uint32_t>(input[1]) << 8) | (static_cast<uint32_t>(input[2]) << 16) | (static_cast<uint32_t>(input[3]) << 24);
+}
+
+//----------------------------------------------------------------------------
+/// Scale symbol counts so that the sum of frequencies is RANS_SCALE and each occurring symbol has non-zero frequency.
+void NormalizeFrequencies(const size_t counts[256], size_t total, uint32_t frequencies[256])
+{
+  uint32_t sum = 0;
+  for (int symbol = 0; symbol < 256; ++symbol)
+  {
+    frequencies[symbol] = 0;
+    if (counts[symbol] > 0)
+    {
+      frequencies[symbol] = std::max<uint32_t>(1, static_cast<uint32_t>((static_cast<uint64_t>(counts[symbol]) * RANS_SCALE) / total));
+    }
+    sum += frequencies[symbol];
+  }
+  // Correct rounding errors by adjusting the most frequent symbols
+  while (sum != RANS_SCALE)
+  {
+    int largestSymbol = static_cast<int>(std::max_element(frequencies, frequencies + 256) - frequencies);
+    if (sum < RANS_SCALE)
+    {
+      frequencies[largestSymbol] += RANS_SCALE - sum;
+      sum = RANS_SCALE;
+    }
+    else
+    {
+      uint32_t decrement = std::min(sum - RANS_SCALE, frequencies[largestSymbol] / 2);
+      frequencies[largestSymbol] -= decrement;
+      sum -= decrement;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Precomputed values for encoding a symbol without division (see Fabian Giesen's ryg_rans).
+struct RANSEncoderSymbol
+{
+  uint32_t StateLimit;
+  uint32_t ReciprocalFrequency;
+  uint32_t ReciprocalShift;
+  uint32_t Bias;
+  uint32_t ComplementFrequency;
+};
+
+//----------------------------------------------------------------------------
+void InitializeEncoderSymbol(RANSEncoderSymbol& encoderSymbol, uint32_t start, uint32_t frequency)
+{
+  encoderSymbol.StateLimit = ((RANS_LOWER_BOUND >> RANS_SCALE_BITS) << 8) * frequency;
+  encoderSymbol.ComplementFrequency = RANS_SCALE - frequency;
+  if (frequency < 2)
+  {
+    encoderSymbol.ReciprocalFrequency = ~0u;
+    encoderSymbol.ReciprocalShift = 0;
+    encoderSymbol.Bias = start + RANS_SCALE - 1;
+  }
+  else
+  {
+    uint32_t shift = 0;
+    while (frequency > (1u << shift))
+    {
+      shift++;
+    }
+    encoderSymbol.ReciprocalFrequency = static_cast<uint32_t>(((uint64_t(1) << (shift + 31)) + frequency - 1) / frequency);
+    encoderSymbol.ReciprocalShift = shift - 1;
+    encoderSymbol.Bias = start;
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Decoder lookup table entry for a frequency slot
+struct RANSDecoderSlot
+{
+  uint16_t Frequency;
+  uint16_t Start;
+  unsigned char Symbol;
+};
+
+//----------------------------------------------------------------------------
+void EncodePlane(const unsigned char* data, size_t numberOfValues, std::vector<unsigned char>& output, std::vector<unsigned char>& encodedBuffer)
+{
+  size_t counts[256] = { 0 };
+  for (size_t i = 0; i < numberOfValues; ++i)
+  {
+    counts[data[i]]++;
+  }
+  int numberOfSymbols = 0;
+  int lastSymbol = 0;
+  for (int symbol = 0; symbol < 256; ++symbol)
+  {
+    if (counts[symbol] > 0)
+    {
+      numberOfSymbols++;
+      lastSymbol = symbol;
+    }
+  }
+  if (numberOfSymbols <= 1)
+  {
+    output.push_back(PlaneConstant);
+    output.push_back(static_cast<unsigned char>(lastSymbol));
+    return;
+  }
+
+  uint32_t frequencies[256];
+  NormalizeFrequencies(counts, numberOfValues, frequencies);
+  RANSEncoderSymbol encoderSymbols[256];
+  uint32_t cumulativeFrequency = 0;
+  for (int symbol = 0; symbol < 256; ++symbol)
+  {
+    InitializeEncoderSymbol(encoderSymbols[symbol], cumulativeFrequency, frequencies[symbol]);
+    cumulativeFrequency += frequencies[symbol];
+  }
+
+  // Two interleaved states (even and odd values) to allow instruction-level parallelism in the decoder.
+  // Values are encoded in reverse order so that the decoder can read the bytes in forward order.
+  // Each value emits at most 2 bytes, the worst case is when the plane is not compressible.
+  encodedBuffer.resize(2 * numberOfValues + 8);
+  unsigned char* encodedEnd = encodedBuffer.data();
+  uint32_t states[2] = { RANS_LOWER_BOUND, RANS_LOWER_BOUND };
+  for (size_t i = numberOfValues; i-- > 0;)
+  {
+    uint32_t& state = states[i & 1];
+    const RANSEncoderSymbol& encoderSymbol = encoderSymbols[data[i]];
+    while (state >= encoderSymbol.StateLimit)
+    {
+      *(encodedEnd++) = static_cast<unsigned char>(state & 0xff);
+      state >>= 8;
+    }
+    uint32_t quotient = static_cast<uint32_t>((static_cast<uint64_t>(state) * encoderSymbol.ReciprocalFrequency) >> 32) >> encoderSymbol.ReciprocalShift;
+    state += encoderSymbol.Bias + quotient * encoderSymbol.ComplementFrequency;
+  }
+  for (int stateIndex = 1; stateIndex >= 0; --stateIndex)
+  {
+    for (int shift = 24; shift >= 0; shift -= 8)
+    {
+      *(encodedEnd++) = static_cast<unsigned char>(states[stateIndex] >> shift);
+    }
+  }
+  const size_t encodedSize = encodedEnd - encodedBuffer.data();
+
+  const size_t frequencyTableSize = 32 + 2 * numberOfSymbols;
+  if (frequencyTableSize + 4 + encodedSize >= numberOfValues || encodedSize > std::numeric_limits<uint32_t>::max())
+  {
+    // Incompressible, or encoded size does not fit in the 4-byte size field
+    output.push_back(PlaneRaw);
+    output.insert(output.end(), data, data + numberOfValues);
+    return;
+  }
+
+  output.push_back(PlaneRANS);
+  unsigned char symbolMask[32] = { 0 };
+  for (int symbol = 0; symbol < 256; ++symbol)
+  {
+    if (frequencies[symbol] > 0)
+    {
+      symbolMask[symbol >> 3] |= static_cast<unsigned char>(1 << (symbol & 7));
+    }
+  }
+  output.insert(output.end(), symbolMask, symbolMask + 32);
+  for (int symbol = 0; symbol < 256; ++symbol)
+  {
+    if (frequencies[symbol] > 0)
+    {
+      output.push_back(static_cast<unsigned char>(frequencies[symbol] - 1));
+      output.push_back(static_cast<unsigned char>((frequencies[symbol] - 1) >> 8));
+    }
+  }
+  AppendUInt32(output, static_cast<uint32_t>(encodedSize));
+  output.insert(output.end(), std::reverse_iterator<unsigned char*>(encodedEnd), std::reverse_iterator<unsigned char*>(encodedBuffer.data()));
+}
+
+//----------------------------------------------------------------------------
+bool DecodePlane(const unsigned char*& input, const unsigned char* inputEnd, size_t numberOfValues, unsigned char* output)
+{
+  if (input >= inputEnd)
+  {
+    return false;
+  }
+  unsigned char encoding = *(input++);
+  if (encoding == PlaneRaw)
+  {
+    if (static_cast<size_t>(inputEnd - input) < numberOfValues)
+    {
+      return false;
+    }
+    memcpy(output, input, numberOfValues);
+    input += numberOfValues;
+    return true;
+  }
+  else if (encoding == PlaneConstant)
+  {
+    if (input >= inputEnd)
+    {
+      return false;
+    }
+    memset(output, *input, numberOfValues);
+    input++;
+    return true;
+  }
+  else if (encoding != PlaneRANS)
+  {
+    return false;
+  }
+
+  if (inputEnd - input < 32)
+  {
+    return false;
+  }
+  const unsigned char* symbolMask = input;
+  input += 32;
+  std::array<RANSDecoderSlot, RANS_SCALE> slots;
+  uint32_t cumulativeFrequency = 0;
+  for (int symbol = 0; symbol < 256; ++symbol)
+  {
+    if (!(symbolMask[symbol >> 3] & (1 << (symbol & 7))))
+    {
+      continue;
+    }
+    if (inputEnd - input < 2)
+    {
+      return false;
+    }
+    uint32_t frequency = (static_cast<uint32_t>(input[0]) | (static_cast<uint32_t>(input[1]) << 8)) + 1;
+    input += 2;
+    if (cumulativeFrequency + frequency > RANS_SCALE)
+    {
+      return false;
+    }
+    for (uint32_t slot = cumulativeFrequency; slot < cumulativeFrequency + frequency; ++slot)
+    {
+      slots[slot].Frequency = static_cast<uint16_t>(frequency);
+      slots[slot].Start = static_cast<uint16_t>(cumulativeFrequency);
+      slots[slot].Symbol = static_cast<unsigned char>(symbol);
+    }
+    cumulativeFrequency += frequency;
+  }
+  if (cumulativeFrequency != RANS_SCALE || inputEnd - input < 4)
+  {
+    return false;
+  }
+  uint32_t encodedSize = ReadUInt32(input);
+  input += 4;
+  if (encodedSize < 8 || static_cast<size_t>(inputEnd - input) < encodedSize)
+  {
+    return false;
+  }
+
+  const unsigned char* encoded = input + 8;
+  const unsigned char* encodedEnd = input + encodedSize;
+  uint32_t state0 = ReadUInt32(input);
+  uint32_t state1 = ReadUInt32(input + 4);
+  size_t i = 0;
+  for (; i + 1 < numberOfValues; i += 2)
+  {
+    const RANSDecoderSlot& slot0 = slots[state0 & (RANS_SCALE - 1)];
+    const RANSDecoderSlot& slot1 = slots[state1 & (RANS_SCALE - 1)];
+    output[i] = slot0.Symbol;
+    output[i + 1] = slot1.Symbol;
+    state0 = slot0.Frequency * (state0 >> RANS_SCALE_BITS) + (state0 & (RANS_SCALE - 1)) - slot0.Start;
+    state1 = slot1.Frequency * (state1 >> RANS_SCALE_BITS) + (state1 & (RANS_SCALE - 1)) - slot1.Start;
+    while (state0 < RANS_LOWER_BOUND && encoded < encodedEnd)
+    {
+      state0 = (state0 << 8) | *(encoded++);
+    }
+    while (state1 < RANS_LOWER_BOUND && encoded < encodedEnd)
+    {
+      state1 = (state1 << 8) | *(encoded++);
+    }
+  }
+  if (i < numberOfValues)
+  {
+    output[i] = slots[state0 & (RANS_SCALE - 1)].Symbol;
+  }
+  input = encodedEnd;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+/// Map signed residuals (stored in unsigned type) to unsigned values: 0, -1, 1, -2, 2, ... => 0, 1, 2, 3, 4, ...
+template <typename T>
+inline T ZigZagEncode(T value)
+{
+  return static_cast<T>((value << 1) ^ static_cast<T>(0 - (value >> (sizeof(T) * 8 - 1))));
+}
+
+//----------------------------------------------------------------------------
+template <typename T>
+inline T ZigZagDecode(T value)
+{
+  return static_cast<T>((value >> 1) ^ static_cast<T>(0 - (value & 1)));
+}
+
+//----------------------------------------------------------------------------
+/// Compute prediction residuals and store them in byte planes.
+/// If reference is nullptr then each voxel is predicted from its neighbor in the same frame.
+template <typename T>
+void EncodeResiduals(const T* current, const T* reference, size_t numberOfElements, size_t numberOfComponents, size_t rowLength, std::vector<std::vector<unsigned char>>& planes)
+{
+  unsigned char* planePointers[sizeof(T)];
+  for (size_t planeIndex = 0; planeIndex < sizeof(T); ++planeIndex)
+  {
+    planePointers[planeIndex] = planes[planeIndex].data();
+  }
+  for (size_t rowStart = 0; rowStart < numberOfElements; rowStart += rowLength)
+  {
+    for (size_t i = rowStart; i < rowStart + rowLength; ++i)
+    {
+      T prediction = 0;
+      if (reference)
+      {
+        prediction = reference[i];
+      }
+      else if (i - rowStart >= numberOfComponents)
+      {
+        prediction = current[i - numberOfComponents];
+      }
+      else if (rowStart > 0)
+      {
+        prediction = current[i - rowLength];
+      }
+      T residual = ZigZagEncode<T>(static_cast<T>(current[i] - prediction));
+      for (size_t planeIndex = 0; planeIndex < sizeof(T); ++planeIndex)
+      {
+        planePointers[planeIndex][i] = static_cast<unsigned char>(residual >> (8 * planeIndex));
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Reconstruct voxels from residuals stored in byte planes.
+/// For delta frames output must contain the previous frame.
+template <typename T>
+void DecodeResiduals(const std::vector<std::vector<unsigned char>>& planes, bool keyFrame, size_t numberOfElements, size_t numberOfComponents, size_t rowLength, T* output)
+{
+  const unsigned char* planePointers[sizeof(T)];
+  for (size_t planeIndex = 0; planeIndex < sizeof(T); ++planeIndex)
+  {
+    planePointers[planeIndex] = planes[planeIndex].data();
+  }
+  for (size_t rowStart = 0; rowStart < numberOfElements; rowStart += rowLength)
+  {
+    for (size_t i = rowStart; i < rowStart + rowLength; ++i)
+    {
+      T residual = 0;
+      for (size_t planeIndex = 0; planeIndex < sizeof(T); ++planeIndex)
+      {
+        residual = static_cast<T>(residual | (static_cast<T>(planePointers[planeIndex][i]) << (8 * planeIndex)));
+      }
+      T prediction = 0;
+      if (!keyFrame)
+      {
+        prediction = output[i];
+      }
+      else if (i - rowStart >= numberOfComponents)
+      {
+        prediction = output[i - numberOfComponents];
+      }
+      else if (rowStart > 0)
+      {
+        prediction = output[i - rowLength];
+      }
+      output[i] = static_cast<T>(prediction + ZigZagDecode<T>(residual));
+    }
+  }
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkLosslessDeltaVolumeCodec);
+
+//----------------------------------------------------------------------------
+vtkStreamingVolumeCodec* vtkLosslessDeltaVolumeCodec::CreateCodecInstance()
+{
+  return vtkLosslessDeltaVolumeCodec::New();
+}
+
+//----------------------------------------------------------------------------
+vtkLosslessDeltaVolumeCodec::vtkLosslessDeltaVolumeCodec()
+{
+  this->AvailableParameterNames.push_back("KeyFrameInterval");
+  this->ParameterDescriptions["KeyFrameInterval"] = "Number of frames between key frames. 0 means that only the first frame is a key frame.";
+}
+
+//----------------------------------------------------------------------------
+vtkLosslessDeltaVolumeCodec::~vtkLosslessDeltaVolumeCodec() = default;
+
+//----------------------------------------------------------------------------
+void vtkLosslessDeltaVolumeCodec::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "KeyFrameInterval: " << this->KeyFrameInterval << "\n";
+}
+
+//----------------------------------------------------------------------------
+bool vtkLosslessDeltaVolumeCodec::UpdateParameterInternal(std::string parameterValue, std::string parameterName)
+{
+  if (parameterName == "KeyFrameInterval")
+  {
+    bool valid = false;
+    int keyFrameInterval = vtkVariant(parameterValue).ToInt(&valid);
+    if (!valid || keyFrameInterval < 0)
+    {
+      vtkErrorMacro("UpdateParameterInternal: invalid KeyFrameInterval value: " << parameterValue);
+      return false;
+    }
+    this->KeyFrameInterval = keyFrameInterval;
+    return true;
+  }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+bool vtkLosslessDeltaVolumeCodec::IsKeyFrameData(const unsigned char* frameData, size_t frameDataSize)
+{
+  return frameData && frameDataSize >= FRAME_HEADER_SIZE && frameData[1] != 0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkLosslessDeltaVolumeCodec::EncodeImageDataInternal(vtkImageData* inputImageData, vtkStreamingVolumeFrame* outputFrame, bool forceKeyFrame)
+{
+  if (!inputImageData || !inputImageData->GetPointData() || !inputImageData->GetPointData()->GetScalars() || !outputFrame)
+  {
+    vtkErrorMacro("EncodeImageDataInternal failed: invalid input image or output frame");
+    return false;
+  }
+  int dimensions[3] = { 0, 0, 0 };
+  inputImageData->GetDimensions(dimensions);
+  int scalarType = inputImageData->GetScalarType();
+  int numberOfComponents = inputImageData->GetNumberOfScalarComponents();
+  size_t elementSize = static_cast<size_t>(inputImageData->GetScalarSize());
+  size_t rowLength = static_cast<size_t>(dimensions[0]) * numberOfComponents;
+  size_t numberOfElements = rowLength * dimensions[1] * dimensions[2];
+  if (elementSize != 1 && elementSize != 2 && elementSize != 4 && elementSize != 8)
+  {
+    vtkErrorMacro("EncodeImageDataInternal failed: unsupported scalar type " << inputImageData->GetScalarTypeAsString());
+    return false;
+  }
+  if (numberOfElements == 0 || numberOfElements > std::numeric_limits<uint32_t>::max())
+  {
+    vtkErrorMacro("EncodeImageDataInternal failed: unsupported image size");
+    return false;
+  }
+
+  bool keyFrame = forceKeyFrame || !this->EncodedReferenceFrame || this->EncodedReference.size() != numberOfElements * elementSize;
+  if (!keyFrame)
+  {
+    int referenceDimensions[3] = { 0, 0, 0 };
+    this->EncodedReferenceFrame->GetDimensions(referenceDimensions);
+    keyFrame = referenceDimensions[0] != dimensions[0] || referenceDimensions[1] != dimensions[1] || referenceDimensions[2] != dimensions[2] //
+               || this->EncodedReferenceFrame->GetVTKScalarType() != scalarType                                                           //
+               || this->EncodedReferenceFrame->GetNumberOfComponents() != numberOfComponents                                              //
+               || (this->KeyFrameInterval > 0 && this->NumberOfFramesSinceKeyFrame >= this->KeyFrameInterval);
+  }
+
+  this->Planes.resize(elementSize);
+  for (std::vector<unsigned char>& plane : this->Planes)
+  {
+    plane.resize(numberOfElements);
+  }
+  const void* current = inputImageData->GetScalarPointer();
+  const void* reference = keyFrame ? nullptr : this->EncodedReference.data();
+  switch (elementSize)
+  {
+    case 1:
+      EncodeResiduals<uint8_t>(static_cast<const uint8_t*>(current), static_cast<const uint8_t*>(reference), numberOfElements, numberOfComponents, rowLength, this->Planes);
+      break;
+    case 2:
+      EncodeResiduals<uint16_t>(static_cast<const uint16_t*>(current), static_cast<const uint16_t*>(reference), numberOfElements, numberOfComponents, rowLength, this->Planes);
+      break;
+    case 4:
+      EncodeResiduals<uint32_t>(static_cast<const uint32_t*>(current), static_cast<const uint32_t*>(reference), numberOfElements, numberOfComponents, rowLength, this->Planes);
+      break;
+    default:
+      EncodeResiduals<uint64_t>(static_cast<const uint64_t*>(current), static_cast<const uint64_t*>(reference), numberOfElements, numberOfComponents, rowLength, this->Planes);
+      break;
+  }
+
+  std::vector<unsigned char> encodedFrame;
+  encodedFrame.reserve(numberOfElements * elementSize / 2 + FRAME_HEADER_SIZE);
+  encodedFrame.push_back(FRAME_DATA_VERSION);
+  encodedFrame.push_back(keyFrame ? 1 : 0);
+  encodedFrame.push_back(static_cast<unsigned char>(elementSize));
+  encodedFrame.push_back(0);
+  AppendUInt32(encodedFrame, static_cast<uint32_t>(numberOfElements));
+  std::vector<unsigned char> encodedBuffer;
+  for (const std::vector<unsigned char>& plane : this->Planes)
+  {
+    EncodePlane(plane.data(), numberOfElements, encodedFrame, encodedBuffer);
+  }
+
+  vtkNew<vtkUnsignedCharArray> frameData;
+  frameData->SetNumberOfValues(encodedFrame.size());
+  memcpy(frameData->GetPointer(0), encodedFrame.data(), encodedFrame.size());
+  outputFrame->SetFrameData(frameData);
+  outputFrame->SetFrameType(keyFrame ? vtkStreamingVolumeFrame::IFrame : vtkStreamingVolumeFrame::PFrame);
+  outputFrame->SetPreviousFrame(keyFrame ? nullptr : this->EncodedReferenceFrame.GetPointer());
+  outputFrame->SetDimensions(dimensions);
+  outputFrame->SetNumberOfComponents(numberOfComponents);
+  outputFrame->SetVTKScalarType(scalarType);
+  outputFrame->SetCodecFourCC(this->GetFourCC());
+
+  const unsigned char* currentBytes = static_cast<const unsigned char*>(current);
+  this->EncodedReference.assign(currentBytes, currentBytes + numberOfElements * elementSize);
+  this->EncodedReferenceFrame = outputFrame;
+  this->NumberOfFramesSinceKeyFrame = keyFrame ? 1 : this->NumberOfFramesSinceKeyFrame + 1;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkLosslessDeltaVolumeCodec::DecodeFrameInternal(vtkStreamingVolumeFrame* inputFrame, vtkImageData* outputImageData, bool vtkNotUsed(saveDecodedImage))
+{
+  if (!inputFrame || !outputImageData)
+  {
+    vtkErrorMacro("DecodeFrameInternal failed: invalid input frame or output image");
+    return false;
+  }
+
+  // Delta frames can only be reconstructed from the previous frame, therefore decode
+  // all frames since the last key frame (or since the last decoded frame)
+  std::vector<vtkStreamingVolumeFrame*> framesToDecode;
+  for (vtkStreamingVolumeFrame* frame = inputFrame; frame != this->DecodedReferenceFrame; frame = frame->GetPreviousFrame())
+  {
+    if (!frame)
+    {
+      vtkErrorMacro("DecodeFrameInternal failed: previous frame is not available");
+      return false;
+    }
+    framesToDecode.push_back(frame);
+    vtkUnsignedCharArray* frameData = frame->GetFrameData();
+    if (frameData && vtkLosslessDeltaVolumeCodec::IsKeyFrameData(frameData->GetPointer(0), frameData->GetNumberOfValues()))
+    {
+      break;
+    }
+  }
+  for (std::vector<vtkStreamingVolumeFrame*>::reverse_iterator frameIt = framesToDecode.rbegin(); frameIt != framesToDecode.rend(); ++frameIt)
+  {
+    if (!this->DecodeFrameData(*frameIt))
+    {
+      this->DecodedReferenceFrame = nullptr;
+      return false;
+    }
+    this->DecodedReferenceFrame = *frameIt;
+  }
+
+  int dimensions[3] = { 0, 0, 0 };
+  inputFrame->GetDimensions(dimensions);
+  int scalarType = inputFrame->GetVTKScalarType();
+  int numberOfComponents = inputFrame->GetNumberOfComponents();
+  int* outputDimensions = outputImageData->GetDimensions();
+  if (!outputImageData->GetPointData()->GetScalars()                                                                               //
+      || outputDimensions[0] != dimensions[0] || outputDimensions[1] != dimensions[1] || outputDimensions[2] != dimensions[2] //
+      || outputImageData->GetScalarType() != scalarType || outputImageData->GetNumberOfScalarComponents() != numberOfComponents)
+  {
+    outputImageData->SetDimensions(dimensions);
+    outputImageData->AllocateScalars(scalarType, numberOfComponents);
+  }
+  memcpy(outputImageData->GetScalarPointer(), this->DecodedReference.data(), this->DecodedReference.size());
+  outputImageData->GetPointData()->GetScalars()->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkLosslessDeltaVolumeCodec::DecodeFrameData(vtkStreamingVolumeFrame* frame)
+{
+  vtkUnsignedCharArray* frameData = frame->GetFrameData();
+  if (!frameData || static_cast<size_t>(frameData->GetNumberOfValues()) < FRAME_HEADER_SIZE || frameData->GetValue(0) != FRAME_DATA_VERSION)
+  {
+    vtkErrorMacro("DecodeFrameData failed: unsupported frame data");
+    return false;
+  }
+  const unsigned char* input = frameData->GetPointer(0);
+  const unsigned char* inputEnd = input + frameData->GetNumberOfValues();
+  bool keyFrame = (input[1] != 0);
+  size_t elementSize = input[2];
+  size_t numberOfElements = ReadUInt32(input + 4);
+
+  int dimensions[3] = { 0, 0, 0 };
+  frame->GetDimensions(dimensions);
+  size_t numberOfComponents = static_cast<size_t>(frame->GetNumberOfComponents());
+  size_t rowLength = static_cast<size_t>(dimensions[0]) * numberOfComponents;
+  if (elementSize != static_cast<size_t>(vtkDataArray::GetDataTypeSize(frame->GetVTKScalarType())) //
+      || numberOfElements != rowLength * dimensions[1] * dimensions[2] || numberOfElements == 0)
+  {
+    vtkErrorMacro("DecodeFrameData failed: frame data does not match frame size or scalar type");
+    return false;
+  }
+  if (!keyFrame && this->DecodedReference.size() != numberOfElements * elementSize)
+  {
+    vtkErrorMacro("DecodeFrameData failed: previous frame size does not match");
+    return false;
+  }
+
+  input += FRAME_HEADER_SIZE;
+  this->Planes.resize(elementSize);
+  for (std::vector<unsigned char>& plane : this->Planes)
+  {
+    plane.resize(numberOfElements);
+    if (!DecodePlane(input, inputEnd, numberOfElements, plane.data()))
+    {
+      vtkErrorMacro("DecodeFrameData failed: corrupted frame data");
+      return false;
+    }
+  }
+
+  this->DecodedReference.resize(numberOfElements * elementSize);
+  void* output = this->DecodedReference.data();
+  switch (elementSize)
+  {
+    case 1: DecodeResiduals<uint8_t>(this->Planes, keyFrame, numberOfElements, numberOfComponents, rowLength, static_cast<uint8_t*>(output)); break;
+    case 2: DecodeResiduals<uint16_t>(this->Planes, keyFrame, numberOfElements, numberOfComponents, rowLength, static_cast<uint16_t*>(output)); break;
+    case 4: DecodeResiduals<uint32_t>(this->Planes, keyFrame, numberOfElements, numberOfComponents, rowLength, static_cast<uint32_t*>(output)); break;
+    case 8: DecodeResiduals<uint64_t>(this->Planes, keyFrame, numberOfElements, numberOfComponents, rowLength, static_cast<uint64_t*>(output)); break;
+    default: vtkErrorMacro("DecodeFrameData failed: unsupported scalar size " << elementSize); return false;
+  }
+  return true;
+}
@@ -0,0 +1,101 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+/**
+ * @class   vtkLosslessDeltaVolumeCodec
+ * @brief   Lossless codec for image sequences, using inter-frame delta prediction and rANS entropy coding.
+ *
+ * Key frames are predicted from the previous voxel in the same row (or the voxel in the previous row,
+ * for the first voxel of each row), other frames are predicted from the previous frame.
+ * Prediction residuals are zigzag-mapped to unsigned values, split into byte planes (so that high
+ * bytes of small residuals form long runs of zeros) and each plane is compressed by a static
+ * order-0 range asymmetric numeral system (rANS) coder. Planes that do not compress are stored raw.
+ *
+ * Any scalar type and number of components is supported. Floating-point voxels are predicted
+ * bitwise, which is lossless but compresses less efficiently than integer data.
+ *
+ * The codec FourCC is "SLDC". Parameter "KeyFrameInterval" specifies how often key frames are
+ * inserted (default: 30, 0 means only the first frame is a key frame).
+ */
+
+#ifndef vtkLosslessDeltaVolumeCodec_h
+#define vtkLosslessDeltaVolumeCodec_h
+
+// MRML includes
+#include "vtkMRML.h"
+
+// vtkAddon includes
+#include <vtkStreamingVolumeCodec.h>
+
+// VTK includes
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <string>
+#include <vector>
+
+class vtkImageData;
+class vtkStreamingVolumeFrame;
+
+class VTK_MRML_EXPORT vtkLosslessDeltaVolumeCodec : public vtkStreamingVolumeCodec
+{
+public:
+  static vtkLosslessDeltaVolumeCodec* New();
+  vtkStreamingVolumeCodec* CreateCodecInstance() override;
+  vtkTypeMacro(vtkLosslessDeltaVolumeCodec, vtkStreamingVolumeCodec);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Get the four-character code of the codec ("SLDC")
+  std::string GetFourCC() override { return "SLDC"; };
+
+  /// Number of frames between key frames. 0 means that only the first frame is a key frame.
+  /// Can be set by the "KeyFrameInterval" codec parameter.
+  vtkGetMacro(KeyFrameInterval, int);
+
+  /// Returns true if the encoded frame data is a key frame (can be decoded without previous frames).
+  static bool IsKeyFrameData(const unsigned char* frameData, size_t frameDataSize);
+
+protected:
+  vtkLosslessDeltaVolumeCodec();
+  ~vtkLosslessDeltaVolumeCodec() override;
+
+  bool DecodeFrameInternal(vtkStreamingVolumeFrame* inputFrame, vtkImageData* outputImageData, bool saveDecodedImage = true) override;
+  bool EncodeImageDataInternal(vtkImageData* inputImageData, vtkStreamingVolumeFrame* outputFrame, bool forceKeyFrame) override;
+  bool UpdateParameterInternal(std::string parameterValue, std::string parameterName) override;
+
+  /// Decode a single frame into DecodedReference. The previous frame must be already in DecodedReference if it is not a key frame.
+  bool DecodeFrameData(vtkStreamingVolumeFrame* frame);
+
+  int KeyFrameInterval{ 30 };
+
+  /// Voxels of the last encoded frame, used for predicting the next frame
+  std::vector<unsigned char> EncodedReference;
+  vtkSmartPointer<vtkStreamingVolumeFrame> EncodedReferenceFrame;
+  int NumberOfFramesSinceKeyFrame{ 0 };
+
+  /// Voxels of the last decoded frame, used for reconstructing the next frame
+  std::vector<unsigned char> DecodedReference;
+  vtkSmartPointer<vtkStreamingVolumeFrame> DecodedReferenceFrame;
+
+  /// Reused buffers for byte planes
+  std::vector<std::vector<unsigned char>> Planes;
+
+private:
+  vtkLosslessDeltaVolumeCodec(const vtkLosslessDeltaVolumeCodec&) = delete;
+  void operator=(const vtkLosslessDeltaVolumeCodec&) = delete;
+};
+
+#endif
@@ -488,9 +488,13 @@ void vtkMRMLClipNode::GetPlanes(vtkPlaneCollection* planes)
 //----------------------------------------------------------------------------
 int vtkMRMLClipNode::GetClippingNodeIndex(const char* nodeID)
 {
+  NodeReferenceListType* references = this->NodeReferences.Find(ClippingNodeReferenceRole);
+  if (!references)
+  {
+    return -1;
+  }
   int i = -1;
-  NodeReferenceListType& references = this->NodeReferences[std::string(ClippingNodeReferenceRole)];
-  for (vtkMRMLNodeReference* reference : references)
+  for (vtkMRMLNodeReference* reference : *references)
   {
     ++i;
     if (strcmp(reference->GetReferencedNodeID(), nodeID) == 0)
@@ -520,14 +524,14 @@ int vtkMRMLClipNode::GetClippingNodeState(const char* nodeID)
     return ClipOff;
   }
 
-  NodeReferenceListType& references = this->NodeReferences[std::string(ClippingNodeReferenceRole)];
-  if (references.size() == 0)
+  NodeReferenceListType* references = this->NodeReferences.Find(ClippingNodeReferenceRole);
+  if (!references || references->size() == 0)
   {
     return ClipOff;
   }
 
   int clipState = ClipOff;
-  for (vtkMRMLNodeReference* nodeReference : references)
+  for (vtkMRMLNodeReference* nodeReference : *references)
   {
     if (strcmp(nodeReference->GetReferencedNodeID(), nodeID) == 0)
     {
@@ -545,13 +549,13 @@ int vtkMRMLClipNode::GetClippingNodeState(const char* nodeID)
 //----------------------------------------------------------------------------
 int vtkMRMLClipNode::GetNthClippingNodeState(int n)
 {
-  NodeReferenceListType references = this->NodeReferences[ClippingNodeReferenceRole];
-  if (references.size() <= static_cast<size_t>(n))
+  NodeReferenceListType* references = this->NodeReferences.Find(ClippingNodeReferenceRole);
+  if (!references || n < 0 || references->size() <= static_cast<size_t>(n))
   {
     return ClipOff;
   }
 
-  std::string clipNodeStateString = references[n]->GetProperty(GetClippingNodeStatePropertyName());
+  std::string clipNodeStateString = (*references)[n]->GetProperty(GetClippingNodeStatePropertyName());
   return GetClippingStateFromString(clipNodeStateString.c_str());
 }
 
@@ -593,14 +597,14 @@ void vtkMRMLClipNode::SetClippingNodeState(const char* nodeID, int state)
 //----------------------------------------------------------------------------
 void vtkMRMLClipNode::SetNthClippingNodeState(int n, int state)
 {
-  NodeReferenceListType references = this->NodeReferences[ClippingNodeReferenceRole];
-  if (references.size() <= static_cast<size_t>(n))
+  NodeReferenceListType* references = this->NodeReferences.Find(ClippingNodeReferenceRole);
+  if (!references || n < 0 || references->size() <= static_cast<size_t>(n))
   {
     return;
   }
 
   std::string clipStateString = GetClippingStateAsString(state);
-  if (references[n]->SetProperty(GetClippingNodeStatePropertyName(), clipStateString))
+  if ((*references)[n]->SetProperty(GetClippingNodeStatePropertyName(), clipStateString))
   {
     this->UpdateImplicitFunction();
     this->Modified();
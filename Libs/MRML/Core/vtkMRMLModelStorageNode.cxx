@@ -97,6 +97,13 @@ vtkMRMLModelStorageNode::vtkMRMLModelStorageNode()
 {
   this->DefaultWriteFileExtension = "vtk";
   this->CoordinateSystem = vtkMRMLStorageNode::CoordinateSystemLPS;
+
+  this->CompressionPresets.emplace_back(this->GetCompressionParameterFastest(), "Fastest");
+  this->CompressionPresets.emplace_back(this->GetCompressionParameterNormal(), "Normal");
+  this->CompressionPresets.emplace_back(this->GetCompressionParameterMinimumSize(), "Minimum size");
+
+  // ZLIB can be read by all Slicer versions
+  this->CompressionParameter = this->GetCompressionParameterNormal();
 }
 
 //----------------------------------------------------------------------------
@@ -599,8 +606,10 @@ int vtkMRMLModelStorageNode::WriteDataInternal(vtkMRMLNode* refNode)
     this->GetUserMessages()->SetObservedObject(writer);
     writer->SetInputData(inputData);
     writer->SetFileName(fullName.c_str());
-    writer->SetCompressorType(this->GetUseCompression() ? vtkXMLWriter::ZLIB : vtkXMLWriter::NONE);
-    writer->SetDataMode(this->GetUseCompression() ? vtkXMLWriter::Appended : vtkXMLWriter::Ascii);
+    // Raw binary appended data is much faster to write and read than ASCII or base64 encoded data
+    writer->SetDataMode(vtkXMLWriter::Appended);
+    writer->EncodeAppendedDataOff();
+    writer->SetCompressorType(this->GetUseCompression() ? this->GetXMLCompressorTypeFromCompressionParameter(this->CompressionParameter) : vtkXMLWriter::NONE);
 
     // Write coordinate system space (RAS) to field data
     // In the future (when Slicer switches to VTK8) array metadata may be used instead of separate field data.
@@ -938,3 +947,17 @@ int vtkMRMLModelStorageNode::GetCoordinateSystemFromFieldData(vtkPointSet* mesh)
   }
   return -1;
 }
+
+//----------------------------------------------------------------------------
+int vtkMRMLModelStorageNode::GetXMLCompressorTypeFromCompressionParameter(const std::string& compressionParameter)
+{
+  if (compressionParameter == this->GetCompressionParameterFastest())
+  {
+    return vtkXMLWriter::LZ4;
+  }
+  else if (compressionParameter == this->GetCompressionParameterMinimumSize())
+  {
+    return vtkXMLWriter::LZMA;
+  }
+  return vtkXMLWriter::ZLIB;
+}
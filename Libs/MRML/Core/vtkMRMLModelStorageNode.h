@@ -55,6 +55,13 @@ public:
   /// between RAS and LPS coordinate system.
   static void ConvertBetweenRASAndLPS(vtkPointSet* inputMesh, vtkPointSet* outputMesh);
 
+  /// Compression parameter corresponding to fast compression (LZ4), used for .vtp and .vtu files
+  std::string GetCompressionParameterFastest() { return "lz4"; };
+  /// Compression parameter corresponding to normal compression (ZLIB), used for .vtp and .vtu files
+  std::string GetCompressionParameterNormal() { return "zlib"; };
+  /// Compression parameter corresponding to maximum compression (LZMA, slow), used for .vtp and .vtu files
+  std::string GetCompressionParameterMinimumSize() { return "lzma"; };
+
 protected:
   vtkMRMLModelStorageNode();
   ~vtkMRMLModelStorageNode() override;
@@ -80,6 +87,9 @@ protected:
 
   static int GetCoordinateSystemFromFieldData(vtkPointSet* mesh);
 
+  /// Get VTK XML writer compressor type (vtkXMLWriter::CompressorType) from compression parameter
+  int GetXMLCompressorTypeFromCompressionParameter(const std::string& compressionParameter);
+
   int CoordinateSystem;
 };
 
@@ -29,6 +29,51 @@ Version:   $Revision: 1.11 $
 #include <iostream>
 #include <sstream>
 #include <algorithm> // for std::sort
+#include <deque>
+#include <mutex>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Interned reference role names. Atoms are indices into RoleNames, which is a deque
+/// so that the returned role name pointers remain valid when new roles are added.
+struct vtkMRMLNodeReferenceRoleRegistry
+{
+  std::mutex Mutex;
+  std::map<std::string, int, std::less<>> RoleAtoms;
+  std::deque<std::string> RoleNames;
+};
+
+//----------------------------------------------------------------------------
+vtkMRMLNodeReferenceRoleRegistry& vtkMRMLNodeGetReferenceRoleRegistry()
+{
+  static vtkMRMLNodeReferenceRoleRegistry registry;
+  return registry;
+}
+
+//----------------------------------------------------------------------------
+/// Count references that have a non-empty node ID
+template <class ReferenceListType>
+int vtkMRMLNodeGetNumberOfValidReferences(const ReferenceListType* references)
+{
+  int n = 0;
+  if (!references)
+  {
+    return n;
+  }
+  for (const auto& reference : *references)
+  {
+    const char* referencedNodeID = reference->GetReferencedNodeID();
+    if (referencedNodeID && referencedNodeID[0] != '\0')
+    {
+      n++;
+    }
+  }
+  return n;
+}
+
+} // namespace
 
 //------------------------------------------------------------------------------
 vtkMRMLNode::vtkMRMLNode()
@@ -656,10 +701,11 @@ void vtkMRMLNode::ProcessMRMLEvents(vtkObject* caller, unsigned long event, void
   {
     if (it->first.c_str())
     {
-      NodeReferenceListType references = this->NodeReferences[it->first];
-      for (unsigned int i = 0; i < references.size(); i++)
+      int referenceRoleAtom = this->NodeReferences.GetNthAtom(it.GetIndex());
+      int numberOfReferences = static_cast<int>(it->second.size());
+      for (int i = 0; i < numberOfReferences; i++)
       {
-        vtkMRMLNode* node = this->GetNthNodeReference(it->first.c_str(), i);
+        vtkMRMLNode* node = this->GetNthNodeReferenceByRoleAtom(referenceRoleAtom, i);
         if (node != nullptr && node == vtkMRMLNode::SafeDownCast(caller) && //
             event == vtkCommand::ModifiedEvent)
         {
@@ -1151,6 +1197,38 @@ std::string vtkMRMLNode::NodeReferencePropertyDecodeString(const std::string& in
 
 //// Reference API
 
+//----------------------------------------------------------------------------
+int vtkMRMLNode::GetReferenceRoleAtom(const char* referenceRole)
+{
+  if (!referenceRole)
+  {
+    return -1;
+  }
+  vtkMRMLNodeReferenceRoleRegistry& registry = vtkMRMLNodeGetReferenceRoleRegistry();
+  std::lock_guard<std::mutex> lock(registry.Mutex);
+  auto roleIt = registry.RoleAtoms.find(referenceRole);
+  if (roleIt != registry.RoleAtoms.end())
+  {
+    return roleIt->second;
+  }
+  int referenceRoleAtom = static_cast<int>(registry.RoleNames.size());
+  registry.RoleNames.emplace_back(referenceRole);
+  registry.RoleAtoms[registry.RoleNames.back()] = referenceRoleAtom;
+  return referenceRoleAtom;
+}
+
+//----------------------------------------------------------------------------
+const char* vtkMRMLNode::GetReferenceRoleFromAtom(int referenceRoleAtom)
+{
+  vtkMRMLNodeReferenceRoleRegistry& registry = vtkMRMLNodeGetReferenceRoleRegistry();
+  std::lock_guard<std::mutex> lock(registry.Mutex);
+  if (referenceRoleAtom < 0 || referenceRoleAtom >= static_cast<int>(registry.RoleNames.size()))
+  {
+    return nullptr;
+  }
+  return registry.RoleNames[referenceRoleAtom].c_str();
+}
+
 //-----------------------------------------------------------
 void vtkMRMLNode::UpdateReferences()
 {
@@ -1273,8 +1351,7 @@ const char* vtkMRMLNode::GetNthNodeReferenceRole(int n)
     vtkErrorMacro("vtkMRMLNode::GetNthNodeReferenceRole failed: n=" << n << " is out of range");
     return nullptr;
   }
-  NodeReferencesType::iterator roleIt(this->NodeReferences.begin());
-  std::advance(roleIt, n);
+  NodeReferencesType::iterator roleIt(&this->NodeReferences, n);
   return roleIt->first.c_str();
 }
 
@@ -1284,10 +1361,14 @@ void vtkMRMLNode::GetNodeReferences(const char* referenceRole, std::vector<vtkMR
   if (referenceRole)
   {
     this->UpdateNodeReferences(referenceRole);
-    NodeReferenceListType& references = this->NodeReferences[std::string(referenceRole)];
-    for (unsigned int i = 0; i < references.size(); i++)
+    NodeReferenceListType* references = this->NodeReferences.Find(referenceRole);
+    if (!references)
+    {
+      return;
+    }
+    for (unsigned int i = 0; i < references->size(); i++)
     {
-      nodes.push_back(references[i]->GetReferencedNode());
+      nodes.push_back((*references)[i]->GetReferencedNode());
     }
   }
 }
@@ -1300,10 +1381,14 @@ void vtkMRMLNode::GetNodeReferenceIDs(const char* referenceRole, std::vector<con
     return;
   }
 
-  NodeReferenceListType& references = this->NodeReferences[std::string(referenceRole)];
-  for (unsigned int i = 0; i < references.size(); ++i)
+  NodeReferenceListType* references = this->NodeReferences.Find(referenceRole);
+  if (!references)
   {
-    referencedNodeIDs.push_back(references[i] ? references[i]->GetReferencedNodeID() : nullptr);
+    return;
+  }
+  for (unsigned int i = 0; i < references->size(); ++i)
+  {
+    referencedNodeIDs.push_back((*references)[i] ? (*references)[i]->GetReferencedNodeID() : nullptr);
   }
 }
 
@@ -1314,45 +1399,79 @@ const char* vtkMRMLNode::GetNthNodeReferenceID(const char* referenceRole, int n)
   {
     return nullptr;
   }
+  return this->GetNthNodeReferenceIDFromList(this->NodeReferences.Find(referenceRole), n);
+}
 
-  NodeReferenceListType& references = this->NodeReferences[std::string(referenceRole)];
-  if (n >= static_cast<int>(references.size()))
+//----------------------------------------------------------------------------
+const char* vtkMRMLNode::GetNthNodeReferenceIDByRoleAtom(int referenceRoleAtom, int n)
+{
+  if (n < 0)
+  {
+    return nullptr;
+  }
+  return this->GetNthNodeReferenceIDFromList(this->NodeReferences.FindByAtom(referenceRoleAtom), n);
+}
+
+//----------------------------------------------------------------------------
+const char* vtkMRMLNode::GetNthNodeReferenceIDFromList(NodeReferenceListType* references, int n)
+{
+  if (!references || n >= static_cast<int>(references->size()))
   {
     return nullptr;
   }
-  if (!references[n])
+  if (!(*references)[n])
   {
     vtkErrorMacro(<< "GetNthNodeReferenceID: Reference " << n << "should NOT be nullptr.");
     return nullptr;
   }
-  return references[n]->GetReferencedNodeID();
+  return (*references)[n]->GetReferencedNodeID();
 }
 
 //----------------------------------------------------------------------------
 vtkMRMLNode* vtkMRMLNode::GetNthNodeReference(const char* referenceRole, int n)
 {
-
   if (!referenceRole || n < 0)
   {
     return nullptr;
   }
+  NodeReferenceListType* references = this->NodeReferences.Find(referenceRole);
+  if (!references || n >= static_cast<int>(references->size()))
+  {
+    return nullptr;
+  }
+  return this->GetNthNodeReferenceFromList(*references, n);
+}
 
-  NodeReferenceListType& references = this->NodeReferences[std::string(referenceRole)];
-  if (n >= static_cast<int>(references.size()))
+//----------------------------------------------------------------------------
+vtkMRMLNode* vtkMRMLNode::GetNthNodeReferenceByRoleAtom(int referenceRoleAtom, int n)
+{
+  if (n < 0)
   {
     return nullptr;
   }
+  NodeReferenceListType* references = this->NodeReferences.FindByAtom(referenceRoleAtom);
+  if (!references || n >= static_cast<int>(references->size()))
+  {
+    return nullptr;
+  }
+  return this->GetNthNodeReferenceFromList(*references, n);
+}
 
-  vtkMRMLNode* node = references[n]->GetReferencedNode();
+//----------------------------------------------------------------------------
+vtkMRMLNode* vtkMRMLNode::GetNthNodeReferenceFromList(NodeReferenceListType& references, int n)
+{
+  vtkMRMLNodeReference* reference = references[n];
+  vtkMRMLNode* node = reference->GetReferencedNode();
   // Maybe the node was not yet in the scene when the node ID was set.
   // Check to see if it's now there.
   // Similarly, if the scene is 0, clear the node if not already null.
   if ((!node || node->GetScene() != this->GetScene()) || //
       (node && this->GetScene() == nullptr))
   {
-    this->UpdateNthNodeReference(referenceRole, n);
-    NodeReferenceListType& references = this->NodeReferences[std::string(referenceRole)];
-    node = references[n]->GetReferencedNode();
+    // Keep the reference alive while it is updated, as its role string is used
+    vtkSmartPointer<vtkMRMLNodeReference> referenceToUpdate = reference;
+    this->UpdateNthNodeReference(referenceToUpdate->GetReferenceRole(), n);
+    node = (n < static_cast<int>(references.size()) ? references[n]->GetReferencedNode() : nullptr);
   }
   return node;
 }
@@ -1376,9 +1495,13 @@ void vtkMRMLNode::UpdateNodeReferences(const char* referenceRole)
     return;
   }
 
+  NodeReferenceListType* references = this->NodeReferences.Find(referenceRole);
+  if (!references)
+  {
+    return;
+  }
   int wasModifying = this->StartModify();
-  NodeReferenceListType& references = this->NodeReferences[std::string(referenceRole)];
-  for (unsigned int i = 0; i < references.size(); i++)
+  for (unsigned int i = 0; i < references->size(); i++)
   {
     this->UpdateNthNodeReference(referenceRole, i);
   }
@@ -1394,17 +1517,18 @@ void vtkMRMLNode::UpdateNthNodeReference(const char* referenceRole, int n)
     return;
   }
 
-  NodeReferenceListType& references = this->NodeReferences[std::string(referenceRole)];
-
-  if (n >= static_cast<int>(references.size()))
+  NodeReferenceListType* references = this->NodeReferences.Find(referenceRole);
+  int numberOfReferences = references ? static_cast<int>(references->size()) : 0;
+  if (n >= numberOfReferences)
   {
     vtkErrorMacro(<< "UpdateNthNodeReference: n is " << n << "."
-                  << " Value is expected to be smaller than " << references.size());
+                  << " Value is expected to be smaller than " << numberOfReferences);
     return;
   }
 
+  vtkMRMLNodeReference* reference = (*references)[n];
   this->SetAndObserveNthNodeReferenceID(
-    references[n]->GetReferenceRole(), n, references[n]->GetReferencedNodeID(), references[n]->GetStaticEvents(), references[n]->GetObserveContentModifiedEvents());
+    reference->GetReferenceRole(), n, reference->GetReferencedNodeID(), reference->GetStaticEvents(), reference->GetObserveContentModifiedEvents());
 }
 
 //----------------------------------------------------------------------------
@@ -1835,10 +1959,14 @@ bool vtkMRMLNode::HasNodeReferenceID(const char* referenceRole, const char* refe
     return false;
   }
 
-  NodeReferenceListType& references = this->NodeReferences[std::string(referenceRole)];
+  NodeReferenceListType* references = this->NodeReferences.Find(referenceRole);
+  if (!references)
+  {
+    return false;
+  }
   NodeReferenceListType::iterator it;
   std::string sID(referencedNodeID);
-  for (it = references.begin(); it != references.end(); it++)
+  for (it = references->begin(); it != references->end(); it++)
   {
     vtkMRMLNodeReference* reference = *it;
     if (sID == std::string(reference->GetReferencedNodeID()))
@@ -1921,21 +2049,17 @@ void vtkMRMLNode::RemoveNthNodeReferenceID(const char* referenceRole, int n)
 //----------------------------------------------------------------------------
 int vtkMRMLNode::GetNumberOfNodeReferences(const char* referenceRole)
 {
-  int n = 0;
-  if (referenceRole)
+  if (!referenceRole)
   {
-    NodeReferenceListType& references = this->NodeReferences[std::string(referenceRole)];
-    NodeReferenceListType::iterator it;
-    for (it = references.begin(); it != references.end(); it++)
-    {
-      vtkMRMLNodeReference* reference = *it;
-      if (reference->GetReferencedNodeID() && strlen(reference->GetReferencedNodeID()) > 0)
-      {
-        n++;
-      }
-    }
+    return 0;
   }
-  return n;
+  return vtkMRMLNodeGetNumberOfValidReferences(this->NodeReferences.Find(referenceRole));
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLNode::GetNumberOfNodeReferencesByRoleAtom(int referenceRoleAtom)
+{
+  return vtkMRMLNodeGetNumberOfValidReferences(this->NodeReferences.FindByAtom(referenceRoleAtom));
 }
 
 //----------------------------------------------------------------------------
@@ -2112,13 +2236,13 @@ const vtkMRMLNode::ReferencePropertiesType* vtkMRMLNode::GetNthNodeReferenceProp
     return nullptr;
   }
 
-  NodeReferenceListType& references = this->NodeReferences[std::string(referenceRole)];
-  if (n >= static_cast<int>(references.size()))
+  NodeReferenceListType* references = this->NodeReferences.Find(referenceRole);
+  if (!references || n >= static_cast<int>(references->size()))
   {
     return nullptr;
   }
 
-  return references[n]->GetProperties();
+  return (*references)[n]->GetProperties();
 }
 
 //----------------------------------------------------------------------------
@@ -2141,13 +2265,13 @@ void vtkMRMLNode::SetNthNodeReferenceProperty(const std::string& referenceRole,
     return;
   }
 
-  NodeReferenceListType& references = this->NodeReferences[std::string(referenceRole)];
-  if (n < 0 || static_cast<size_t>(n) >= references.size())
+  NodeReferenceListType* references = this->NodeReferences.Find(referenceRole.c_str());
+  if (!references || n < 0 || static_cast<size_t>(n) >= references->size())
   {
     return;
   }
 
-  if (references[n]->SetProperty(propertyName, value))
+  if ((*references)[n]->SetProperty(propertyName, value))
   {
     this->Modified();
   }
@@ -2167,13 +2291,13 @@ std::string vtkMRMLNode::GetNthNodeReferenceProperty(const std::string& referenc
     return "";
   }
 
-  NodeReferenceListType& references = this->NodeReferences[std::string(referenceRole)];
-  if (n >= static_cast<int>(references.size()))
+  NodeReferenceListType* references = this->NodeReferences.Find(referenceRole.c_str());
+  if (!references || n >= static_cast<int>(references->size()))
   {
     return "";
   }
 
-  return references[n]->GetProperty(propertyName);
+  return (*references)[n]->GetProperty(propertyName);
 }
 
 //----------------------------------------------------------------------------
@@ -2190,13 +2314,13 @@ void vtkMRMLNode::RemoveNthNodeReferenceProperty(const std::string& referenceRol
     return;
   }
 
-  NodeReferenceListType& references = this->NodeReferences[std::string(referenceRole)];
-  if (n >= static_cast<int>(references.size()))
+  NodeReferenceListType* references = this->NodeReferences.Find(referenceRole.c_str());
+  if (!references || n >= static_cast<int>(references->size()))
   {
     return;
   }
 
-  if (references[n]->RemoveProperty(propertyName))
+  if ((*references)[n]->RemoveProperty(propertyName))
   {
     this->Modified();
   }
@@ -2211,8 +2335,12 @@ void vtkMRMLNode::ClearNodeReferenceProperties(const std::string& referenceRole)
   }
 
   bool modified = false;
-  NodeReferenceListType& references = this->NodeReferences[std::string(referenceRole)];
-  for (NodeReferenceListType::iterator it = references.begin(); it != references.end(); ++it)
+  NodeReferenceListType* references = this->NodeReferences.Find(referenceRole.c_str());
+  if (!references)
+  {
+    return;
+  }
+  for (NodeReferenceListType::iterator it = references->begin(); it != references->end(); ++it)
   {
     modified |= (*it)->ClearProperties();
   }
@@ -2231,13 +2359,13 @@ void vtkMRMLNode::ClearNthNodeReferenceProperties(const std::string& referenceRo
     return;
   }
 
-  NodeReferenceListType& references = this->NodeReferences[std::string(referenceRole)];
-  if (n >= static_cast<int>(references.size()))
+  NodeReferenceListType* references = this->NodeReferences.Find(referenceRole.c_str());
+  if (!references || n >= static_cast<int>(references->size()))
   {
     return;
   }
 
-  if (references[n]->ClearProperties())
+  if ((*references)[n]->ClearProperties())
   {
     this->Modified();
   }
@@ -2257,13 +2385,13 @@ int vtkMRMLNode::GetNumberOfNthNodeReferenceProperties(const std::string& refere
     return 0;
   }
 
-  NodeReferenceListType& references = this->NodeReferences[std::string(referenceRole)];
-  if (n >= static_cast<int>(references.size()))
+  NodeReferenceListType* references = this->NodeReferences.Find(referenceRole.c_str());
+  if (!references || n >= static_cast<int>(references->size()))
   {
     return 0;
   }
 
-  return references[n]->GetProperties()->size();
+  return (*references)[n]->GetProperties()->size();
 }
 
 //----------------------------------------------------------------------------
@@ -2280,13 +2408,13 @@ std::string vtkMRMLNode::GetNthNodeReferencePropertyName(const std::string& refe
     return "";
   }
 
-  NodeReferenceListType& references = this->NodeReferences[referenceRole];
-  if (referenceIndex >= static_cast<int>(references.size()))
+  NodeReferenceListType* references = this->NodeReferences.Find(referenceRole.c_str());
+  if (!references || referenceIndex >= static_cast<int>(references->size()))
   {
     return "";
   }
 
-  const vtkMRMLNode::ReferencePropertiesType* properties = references[referenceIndex]->GetProperties();
+  const vtkMRMLNode::ReferencePropertiesType* properties = (*references)[referenceIndex]->GetProperties();
   if (propertyIndex >= static_cast<int>(properties->size()))
   {
     return "";
@@ -38,8 +38,10 @@ class vtkCallbackCommand;
 
 // STD includes
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #ifndef vtkSetMRMLObjectMacro
@@ -842,6 +844,28 @@ public:
   /// \sa GetNodeReferenceRoles(), GetNodeReferenceRoles(), GetNthNodeReferenceRole()
   const char* GetNthNodeReferenceRole(int n);
 
+  //@{
+  /// \brief Get the integer atom that identifies a reference role.
+  ///
+  /// Reference roles are interned when they are first registered (the same
+  /// role name always gets the same atom, in all nodes of all scenes).
+  /// Frequently called code can get the atom once and then use the
+  /// *ByRoleAtom accessors, which do not need to compare role names.
+  /// GetReferenceRoleAtom returns -1 if \a referenceRole is nullptr and
+  /// GetReferenceRoleFromAtom returns nullptr if the atom is invalid.
+  static int GetReferenceRoleAtom(const char* referenceRole);
+  static const char* GetReferenceRoleFromAtom(int referenceRoleAtom);
+  //@}
+
+  //@{
+  /// \brief Faster variants of GetNumberOfNodeReferences, GetNthNodeReferenceID
+  /// and GetNthNodeReference that identify the role by its atom.
+  /// \sa GetReferenceRoleAtom
+  int GetNumberOfNodeReferencesByRoleAtom(int referenceRoleAtom);
+  const char* GetNthNodeReferenceIDByRoleAtom(int referenceRoleAtom, int n);
+  vtkMRMLNode* GetNthNodeReferenceByRoleAtom(int referenceRoleAtom, int n);
+  //@}
+
   /// HierarchyModifiedEvent is generated when the hierarchy node with which
   /// this node is associated changes
   enum
@@ -1133,12 +1157,206 @@ protected:
 
   vtkObserverManager* MRMLObserverManager;
 
-  /// NodeReferences is a map that stores vector of references for each referenceRole,
-  /// the referenceRole can be any unique string, for example "display", "transform" etc.
   typedef std::vector<vtkSmartPointer<vtkMRMLNodeReference>> NodeReferenceListType;
-  typedef std::map<std::string, NodeReferenceListType> NodeReferencesType;
+
+  /// \brief Container of the reference lists of all reference roles.
+  ///
+  /// A node only has a few reference roles, therefore they are stored in a flat
+  /// vector (sorted by role name, as in a std::map) and each role is identified by
+  /// its interned atom. Lookup by atom compares integers, lookup by role name is a binary
+  /// search that does not allocate memory. Unlike std::map::operator[], Find() and
+  /// FindByAtom() do not insert missing roles. The std::map interface that subclasses
+  /// may use (begin, end, find, count, operator[], insert, erase) is provided.
+  /// Reference lists are allocated on the heap, so references to them remain valid
+  /// when new roles are added. Iterators are index based: they are not invalidated
+  /// by adding roles, but a role may be visited again if a role is inserted before it
+  /// during iteration.
+  class NodeReferencesType
+  {
+  public:
+    typedef std::pair<const std::string, NodeReferenceListType> value_type;
+
+    template <class ContainerType, class ValueType>
+    class IteratorBase
+    {
+    public:
+      IteratorBase(ContainerType* container, size_t index)
+        : Container(container)
+        , Index(index)
+      {
+      }
+      /// Allows conversion of iterator to const_iterator
+      template <class OtherContainerType, class OtherValueType>
+      IteratorBase(const IteratorBase<OtherContainerType, OtherValueType>& other)
+        : Container(other.GetContainer())
+        , Index(other.GetIndex())
+      {
+      }
+      ValueType& operator*() const { return *this->Container->Entries[this->Index]; }
+      ValueType* operator->() const { return this->Container->Entries[this->Index].get(); }
+      IteratorBase& operator++()
+      {
+        ++this->Index;
+        return *this;
+      }
+      IteratorBase operator++(int)
+      {
+        IteratorBase previous(*this);
+        ++this->Index;
+        return previous;
+      }
+      bool operator==(const IteratorBase& other) const { return this->Index == other.Index && this->Container == other.Container; }
+      bool operator!=(const IteratorBase& other) const { return !(*this == other); }
+      ContainerType* GetContainer() const { return this->Container; }
+      size_t GetIndex() const { return this->Index; }
+
+    protected:
+      ContainerType* Container;
+      size_t Index;
+    };
+    typedef IteratorBase<NodeReferencesType, value_type> iterator;
+    typedef IteratorBase<const NodeReferencesType, const value_type> const_iterator;
+
+    NodeReferencesType() = default;
+    NodeReferencesType(const NodeReferencesType& other) { *this = other; }
+    NodeReferencesType& operator=(const NodeReferencesType& other)
+    {
+      if (this != &other)
+      {
+        this->clear();
+        for (size_t i = 0; i < other.Entries.size(); ++i)
+        {
+          this->Entries.emplace_back(new value_type(*other.Entries[i]));
+        }
+        this->Atoms = other.Atoms;
+      }
+      return *this;
+    }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, this->Entries.size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, this->Entries.size()); }
+    size_t size() const { return this->Entries.size(); }
+    bool empty() const { return this->Entries.empty(); }
+    void clear()
+    {
+      this->Entries.clear();
+      this->Atoms.clear();
+    }
+
+    /// Get atom of the role at the specified position.
+    int GetNthAtom(size_t n) const { return this->Atoms[n]; }
+
+    /// Get reference list of a role. Returns nullptr if the role is not found.
+    NodeReferenceListType* Find(const char* referenceRole)
+    {
+      size_t index = this->FindIndex(referenceRole);
+      return index < this->Entries.size() ? &this->Entries[index]->second : nullptr;
+    }
+
+    /// Get reference list of a role by its atom. Returns nullptr if the role is not found.
+    NodeReferenceListType* FindByAtom(int referenceRoleAtom)
+    {
+      for (size_t index = 0; index < this->Atoms.size(); ++index)
+      {
+        if (this->Atoms[index] == referenceRoleAtom)
+        {
+          return &this->Entries[index]->second;
+        }
+      }
+      return nullptr;
+    }
+
+    iterator find(const std::string& referenceRole) { return iterator(this, this->FindIndex(referenceRole.c_str())); }
+    const_iterator find(const std::string& referenceRole) const { return const_iterator(this, this->FindIndex(referenceRole.c_str())); }
+    size_t count(const std::string& referenceRole) const { return this->FindIndex(referenceRole.c_str()) < this->Entries.size() ? 1 : 0; }
+
+    /// Get reference list of a role. The role is registered if it is not found.
+    NodeReferenceListType& operator[](const std::string& referenceRole) { return this->insert(value_type(referenceRole, NodeReferenceListType())).first->second; }
+
+    /// Add a role with its reference list, if the role is not present yet.
+    /// Returns iterator to the role and true if the role was added (same as std::map::insert).
+    std::pair<iterator, bool> insert(const value_type& value)
+    {
+      size_t index = this->LowerBound(value.first.c_str());
+      if (index < this->Entries.size() && this->Entries[index]->first == value.first)
+      {
+        return std::make_pair(iterator(this, index), false);
+      }
+      this->Entries.emplace(this->Entries.begin() + index, new value_type(value));
+      this->Atoms.insert(this->Atoms.begin() + index, vtkMRMLNode::GetReferenceRoleAtom(value.first.c_str()));
+      return std::make_pair(iterator(this, index), true);
+    }
+
+    /// Remove a role. Returns the number of removed roles (same as std::map::erase).
+    size_t erase(const std::string& referenceRole)
+    {
+      size_t index = this->FindIndex(referenceRole.c_str());
+      if (index >= this->Entries.size())
+      {
+        return 0;
+      }
+      this->erase(iterator(this, index));
+      return 1;
+    }
+    iterator erase(iterator position)
+    {
+      size_t index = position.GetIndex();
+      this->Entries.erase(this->Entries.begin() + index);
+      this->Atoms.erase(this->Atoms.begin() + index);
+      return iterator(this, index);
+    }
+
+  protected:
+    /// Index of the first role that is not less than \a referenceRole (entries are sorted by role name).
+    size_t LowerBound(const char* referenceRole) const
+    {
+      size_t first = 0;
+      size_t remaining = this->Entries.size();
+      while (remaining > 0)
+      {
+        size_t step = remaining / 2;
+        if (this->Entries[first + step]->first.compare(referenceRole) < 0)
+        {
+          first += step + 1;
+          remaining -= step + 1;
+        }
+        else
+        {
+          remaining = step;
+        }
+      }
+      return first;
+    }
+
+    /// Index of the role, or size() if not found. Binary search, no memory allocation.
+    size_t FindIndex(const char* referenceRole) const
+    {
+      if (referenceRole)
+      {
+        size_t index = this->LowerBound(referenceRole);
+        if (index < this->Entries.size() && this->Entries[index]->first == referenceRole)
+        {
+          return index;
+        }
+      }
+      return this->Entries.size();
+    }
+
+    std::vector<std::unique_ptr<value_type>> Entries;
+    std::vector<int> Atoms;
+  };
+
+  /// NodeReferences stores vector of references for each referenceRole,
+  /// the referenceRole can be any unique string, for example "display", "transform" etc.
   NodeReferencesType NodeReferences;
 
+  /// Helper functions for accessing the Nth reference of a reference list
+  /// (used by both the role name and role atom based accessors).
+  const char* GetNthNodeReferenceIDFromList(NodeReferenceListType* references, int n);
+  vtkMRMLNode* GetNthNodeReferenceFromList(NodeReferenceListType& references, int n);
+
   std::map<std::string, std::string> NodeReferenceMRMLAttributeNames;
 
   struct NodeReferenceEventList
@@ -17,6 +17,7 @@ Version:   $Revision: 1.2 $
 #include "vtkMRMLScene.h"
 #include "vtkMRMLProceduralColorNode.h"
 #include "vtkMRMLVolumeNode.h"
+#include "vtkImageAutoLevelsCalculator.h"
 
 // VTK includes
 #include <vtkAlgorithmOutput.h>
@@ -25,7 +26,6 @@ Version:   $Revision: 1.2 $
 #include <vtkImageCast.h>
 #include <vtkImageData.h>
 #include <vtkImageExtractComponents.h>
-#include <vtkImageHistogramStatistics.h>
 #include <vtkImageLogic.h>
 #include <vtkImageMapToWindowLevelColors.h>
 #include <vtkImageStencil.h>
@@ -103,7 +103,7 @@ vtkMRMLScalarVolumeDisplayNode::vtkMRMLScalarVolumeDisplayNode()
   this->AppendComponents->AddInputConnection(0, this->ExtractRGB->GetOutputPort());
   this->AppendComponents->AddInputConnection(0, this->AlphaLogic->GetOutputPort());
 
-  this->HistogramStatistics = nullptr;
+  this->AutoLevelsCalculator = nullptr;
   this->IsInCalculateAutoLevels = false;
 
   this->MRMLObserverManager->ObserveObject(this, 10000.);
@@ -123,10 +123,10 @@ vtkMRMLScalarVolumeDisplayNode::~vtkMRMLScalarVolumeDisplayNode()
   this->ExtractAlpha->Delete();
   this->MultiplyAlpha->Delete();
 
-  if (this->HistogramStatistics)
+  if (this->AutoLevelsCalculator)
   {
-    this->HistogramStatistics->Delete();
-    this->HistogramStatistics = nullptr;
+    this->AutoLevelsCalculator->Delete();
+    this->AutoLevelsCalculator = nullptr;
   }
 }
 
@@ -823,9 +823,9 @@ void vtkMRMLScalarVolumeDisplayNode::CalculateAutoLevels()
     return;
   }
 
-  if (this->HistogramStatistics == nullptr)
+  if (this->AutoLevelsCalculator == nullptr)
   {
-    this->HistogramStatistics = vtkImageHistogramStatistics::New();
+    this->AutoLevelsCalculator = vtkImageAutoLevelsCalculator::New();
 
     // Set automatic window/level to include the entire intensity range
     // (except top/bottom 0.1%, to not let a very thin tail of the intensity
@@ -838,17 +838,23 @@ void vtkMRMLScalarVolumeDisplayNode::CalculateAutoLevels()
     // Therefore, we choose small, symmetric percentile values here
     // and maybe add modality-specific methods later (e.g., for CT
     // images we could set lower value to -1000HU).
-    this->HistogramStatistics->SetAutoRangePercentiles(0.1, 99.9);
-
-    // Percentiles are very low (0.1%), so there is no need for
-    // range expansion.
-    this->HistogramStatistics->SetAutoRangeExpansionFactors(0.0, 0.0);
+    // Percentiles are estimated from a voxel subsample.
+    this->AutoLevelsCalculator->SetAutoRangePercentiles(0.1, 99.9);
   }
+  // The range of the previous frame is reused while it fits the new frame, for sequence proxy
+  // and streaming volumes only. Otherwise the range only depends on the current image.
+  vtkMRMLNode* volumeNode = this->GetDisplayableNode();
+  bool isFrameOfSequence = volumeNode && (volumeNode->IsA("vtkMRMLStreamingVolumeNode") || volumeNode->GetAttribute("Sequences.BaseName"));
+  this->AutoLevelsCalculator->SetReusePreviousResult(isFrameOfSequence);
 
   this->IsInCalculateAutoLevels = true;
-  this->HistogramStatistics->SetInputData(imageDataScalar);
-  this->HistogramStatistics->Update();
-  double* intensityRange = this->HistogramStatistics->GetAutoRange();
+  if (!this->AutoLevelsCalculator->Compute(imageDataScalar))
+  {
+    vtkDebugMacro("CalculateScalarAutoLevels: failed to compute intensity range");
+    this->IsInCalculateAutoLevels = false;
+    return;
+  }
+  double* intensityRange = this->AutoLevelsCalculator->GetAutoRange();
   vtkDebugMacro("CalculateScalarAutoLevels:" << " lower: " << intensityRange[0] << " upper: " << intensityRange[1]);
 
   int disabledModify = this->StartModify();
@@ -17,11 +17,11 @@
 
 // MRML includes
 #include "vtkMRMLVolumeDisplayNode.h"
+class vtkImageAutoLevelsCalculator;
 
 // VTK includes
 class vtkImageAlgorithm;
 class vtkImageAppendComponents;
-class vtkImageHistogramStatistics;
 class vtkImageCast;
 class vtkImageLogic;
 class vtkImageMapToColors;
@@ -274,8 +274,8 @@ protected:
   std::vector<WindowLevelPreset> WindowLevelPresets;
 
   ///
-  /// Used internally in CalculateScalarAutoLevels and CalculateStatisticsAutoLevels
-  vtkImageHistogramStatistics* HistogramStatistics;
+  /// Used internally in CalculateAutoLevels
+  vtkImageAutoLevelsCalculator* AutoLevelsCalculator;
   bool IsInCalculateAutoLevels;
 };
 
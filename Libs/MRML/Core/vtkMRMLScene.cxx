@@ -18,6 +18,7 @@ Version:   $Revision: 1.18 $
 #include "vtkArchive.h"
 #include "vtkCacheManager.h"
 #include "vtkDataIOManager.h"
+#include "vtkLosslessDeltaVolumeCodec.h"
 #include "vtkMRMLBSplineTransformNode.h"
 #include "vtkMRMLCameraNode.h"
 #include "vtkMRMLClipModelsNode.h"
@@ -96,6 +97,9 @@ Version:   $Revision: 1.18 $
 #include "vtkTagTable.h"
 #include "vtkURIHandler.h"
 
+// vtkAddon includes
+#include <vtkStreamingVolumeCodecFactory.h>
+
 #ifdef MRML_USE_vtkTeem
 # include "vtkMRMLDiffusionTensorVolumeDisplayNode.h"
 # include "vtkMRMLDiffusionTensorVolumeNode.h"
@@ -120,6 +124,7 @@ Version:   $Revision: 1.18 $
 
 // STD includes
 #include <algorithm>
+#include <mutex>
 #include <numeric>
 
 // #define MRMLSCENE_VERBOSE
@@ -269,6 +274,12 @@ vtkMRMLScene::vtkMRMLScene()
   this->RegisterNodeClass(vtkSmartPointer<vtkMRMLVectorVolumeNode>::New());
 #endif
 
+  // Register built-in streaming volume codecs. The codec factory is a singleton, so registration is only needed once,
+  // even if scenes are created in multiple threads.
+  static std::once_flag streamingVolumeCodecsRegistered;
+  std::call_once(streamingVolumeCodecsRegistered,
+                 []() { vtkStreamingVolumeCodecFactory::GetInstance()->RegisterStreamingCodec(vtkSmartPointer<vtkLosslessDeltaVolumeCodec>::New()); });
+
   this->RegisterAbstractNodeClass("vtkMRMLMarkupsNode", "Markup");
   this->RegisterAbstractNodeClass("vtkMRMLVolumeNode", "Volume");
 }
@@ -414,22 +414,77 @@ vtkMRMLNode* vtkMRMLSequenceNode::SetDataNodeAtValue(vtkMRMLNode* node, const st
   this->GetSequenceScene();
   // Add a copy of the node to the sequence's scene
   vtkMRMLNode* newNode = this->DeepCopyNodeToScene(node, this->SequenceScene);
-  vtkMRMLNode* oldNode = nullptr;
-  int seqItemIndex = this->GetItemNumberFromIndexValue(indexValue);
-  if (seqItemIndex >= 0)
+  this->SetAddedDataNodeAtValue(newNode, indexValue);
+  this->Modified();
+  this->StorableModifiedTime.Modified();
+  return newNode;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSequenceNode::AddDataNodesAtValues(const std::vector<vtkMRMLNode*>& nodes, const std::vector<std::string>& indexValues)
+{
+  if (nodes.size() != indexValues.size())
   {
-    oldNode = this->IndexEntries[seqItemIndex].DataNode;
+    vtkErrorMacro("vtkMRMLSequenceNode::AddDataNodesAtValues failed, number of nodes and index values are different");
+    return;
   }
-  else
+  if (nodes.empty())
   {
-    // The sequence item doesn't exist yet
-    seqItemIndex = GetInsertPosition(indexValue);
-    // Create new item
+    return;
+  }
+  MRMLNodeModifyBlocker blocker(this);
+  // Make sure the sequence scene is created
+  this->GetSequenceScene();
+  // Switch do batch process state to prevent unnecessary updates and warning messages
+  this->SequenceScene->StartState(vtkMRMLScene::BatchProcessState);
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    vtkMRMLNode* node = nodes[i];
+    if (node == nullptr || node->GetScene() != nullptr)
+    {
+      vtkErrorMacro("vtkMRMLSequenceNode::AddDataNodesAtValues: invalid node or node is already in a scene at index value " << indexValues[i]);
+      continue;
+    }
+    vtkMRMLNode* addedNode = this->SequenceScene->AddNode(node);
+    this->SetAddedDataNodeAtValue(addedNode, indexValues[i]);
+  }
+  this->SequenceScene->EndState(vtkMRMLScene::BatchProcessState);
+  this->Modified();
+  this->StorableModifiedTime.Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSequenceNode::SetAddedDataNodeAtValue(vtkMRMLNode* addedNode, const std::string& indexValue)
+{
+  vtkMRMLNode* oldNode = nullptr;
+  int seqItemIndex = -1;
+  if (this->IndexType == vtkMRMLSequenceNode::NumericIndex && !this->IndexEntries.empty() //
+      && atof(indexValue.c_str()) > atof(this->IndexEntries.back().IndexValue.c_str()) + this->NumericIndexValueTolerance)
+  {
+    // Item is after the last item (typical when recording), no need to search
     IndexEntryType seqItem;
     seqItem.IndexValue = indexValue;
-    this->IndexEntries.insert(this->IndexEntries.begin() + seqItemIndex, seqItem);
+    this->IndexEntries.push_back(seqItem);
+    seqItemIndex = static_cast<int>(this->IndexEntries.size()) - 1;
   }
-  this->IndexEntries[seqItemIndex].DataNode = newNode;
+  else
+  {
+    seqItemIndex = this->GetItemNumberFromIndexValue(indexValue);
+    if (seqItemIndex >= 0)
+    {
+      oldNode = this->IndexEntries[seqItemIndex].DataNode;
+    }
+    else
+    {
+      // The sequence item doesn't exist yet
+      seqItemIndex = GetInsertPosition(indexValue);
+      // Create new item
+      IndexEntryType seqItem;
+      seqItem.IndexValue = indexValue;
+      this->IndexEntries.insert(this->IndexEntries.begin() + seqItemIndex, seqItem);
+    }
+  }
+  this->IndexEntries[seqItemIndex].DataNode = addedNode;
   this->IndexEntries[seqItemIndex].DataNodeID.clear();
   // Save the sequence data node class name in a node attribute to allow easy access
   // (e.g., for filtering on the GUI). This attribute may be also saved to the sequence file
@@ -444,10 +499,6 @@ vtkMRMLNode* vtkMRMLSequenceNode::SetDataNodeAtValue(vtkMRMLNode* node, const st
     // Remove the old node from the scene
     this->SequenceScene->RemoveNode(oldNode);
   }
-
-  this->Modified();
-  this->StorableModifiedTime.Modified();
-  return newNode;
 }
 
 //----------------------------------------------------------------------------
@@ -800,13 +851,26 @@ int vtkMRMLSequenceNode::GetIndexTypeFromString(const std::string& indexTypeStri
 }
 
 //-----------------------------------------------------------
-vtkMRMLNode* vtkMRMLSequenceNode::DeepCopyNodeToScene(vtkMRMLNode* source, vtkMRMLScene* scene)
+vtkMRMLNode* vtkMRMLSequenceNode::CreateDataNodeCopy(vtkMRMLNode* source)
 {
   if (source == nullptr)
   {
-    vtkGenericWarningMacro("vtkMRMLSequenceNode::DeepCopyNodeToScene failed, invalid node");
+    vtkGenericWarningMacro("vtkMRMLSequenceNode::CreateDataNodeCopy failed, invalid node");
     return nullptr;
   }
+  vtkMRMLNode* target = source->CreateNodeInstance();
+  vtkMRMLSequenceNode::CopyDataNodeContent(target, source, true);
+  return target;
+}
+
+//-----------------------------------------------------------
+void vtkMRMLSequenceNode::CopyDataNodeContent(vtkMRMLNode* target, vtkMRMLNode* source, bool deepCopy /*=true*/)
+{
+  if (target == nullptr || source == nullptr)
+  {
+    vtkGenericWarningMacro("vtkMRMLSequenceNode::CopyDataNodeContent failed, invalid node");
+    return;
+  }
   std::string baseName = "Data";
   if (source->GetAttribute("Sequences.BaseName") != 0)
   {
@@ -818,8 +882,7 @@ vtkMRMLNode* vtkMRMLSequenceNode::DeepCopyNodeToScene(vtkMRMLNode* source, vtkMR
   }
   std::string newNodeName = baseName;
 
-  vtkSmartPointer<vtkMRMLNode> target = vtkSmartPointer<vtkMRMLNode>::Take(source->CreateNodeInstance());
-  target->CopyContent(source); // deep-copy
+  target->CopyContent(source, deepCopy);
 
   // Generating unique node names is slow, and makes adding many nodes to a sequence too slow
   // We will instead ensure that all file names for storable nodes are unique when saving
@@ -830,6 +893,17 @@ vtkMRMLNode* vtkMRMLSequenceNode::DeepCopyNodeToScene(vtkMRMLNode* source, vtkMR
   // We don't want to copy these tags as they would prevent multiple timepoints from being added to the sequences scene for these nodes.
   // Since the singleton tags are not copied with CopyContent, it is safe to disable them here.
   target->SetSingletonOff();
+}
+
+//-----------------------------------------------------------
+vtkMRMLNode* vtkMRMLSequenceNode::DeepCopyNodeToScene(vtkMRMLNode* source, vtkMRMLScene* scene)
+{
+  if (source == nullptr)
+  {
+    vtkGenericWarningMacro("vtkMRMLSequenceNode::DeepCopyNodeToScene failed, invalid node");
+    return nullptr;
+  }
+  vtkSmartPointer<vtkMRMLNode> target = vtkSmartPointer<vtkMRMLNode>::Take(vtkMRMLSequenceNode::CreateDataNodeCopy(source));
 
   // Switch do batch process state to prevent unnecessary updates and warning messages
   // (for example in vtkMRMLLabelMapVolumeDisplayNode::UpdateImageDataPipeline())
@@ -25,6 +25,7 @@
 // std includes
 #include <deque>
 #include <set>
+#include <vector>
 
 /// \brief MRML node for representing a sequence of MRML nodes
 ///
@@ -106,6 +107,26 @@ public:
   /// Returns the data node copy that has just been created.
   vtkMRMLNode* SetDataNodeAtValue(vtkMRMLNode* node, const std::string& indexValue);
 
+  /// Create a deep copy of a node that can be added to a sequence as data node
+  /// (the node name is set to the sequence base name and singleton tag is removed).
+  /// The returned node is not added to any scene. The caller must delete the returned node.
+  VTK_NEWINSTANCE
+  static vtkMRMLNode* CreateDataNodeCopy(vtkMRMLNode* source);
+
+  /// Copy the content of a node into a data node the same way as CreateDataNodeCopy does,
+  /// but without creating a new node.
+  /// If deepCopy is false then the target node may share data objects (e.g., image data) with the source node.
+  static void CopyDataNodeContent(vtkMRMLNode* target, vtkMRMLNode* source, bool deepCopy = true);
+
+  /// Add the provided nodes to this sequence as data nodes, without copying them.
+  /// The nodes must not be in any scene, they are added to the sequence scene.
+  /// If a sequence item already exists at an index value then its data node is replaced.
+  /// This is faster than calling SetDataNodeAtValue for each node (for example, when
+  /// committing recorded frames), because node contents are not copied, the sequence scene
+  /// is put into batch processing state only once, and items that are after the last item
+  /// of a numeric index are appended without searching.
+  void AddDataNodesAtValues(const std::vector<vtkMRMLNode*>& nodes, const std::vector<std::string>& indexValues);
+
   /// Update an existing data node.
   /// Return true if a data node was found by that index.
   bool UpdateDataNodeAtValue(vtkMRMLNode* node, const std::string& indexValue, bool shallowCopy = false);
@@ -182,6 +203,10 @@ protected:
 
   vtkMRMLNode* DeepCopyNodeToScene(vtkMRMLNode* source, vtkMRMLScene* scene);
 
+  /// Set a node that is already added to the sequence scene as data node at the specified index value.
+  /// The previous data node at the same index value is removed from the sequence scene.
+  void SetAddedDataNodeAtValue(vtkMRMLNode* addedNode, const std::string& indexValue);
+
   struct IndexEntryType
   {
     std::string IndexValue;
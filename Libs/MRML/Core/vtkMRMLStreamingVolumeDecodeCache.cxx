@@ -0,0 +1,600 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLStreamingVolumeDecodeCache.h"
+
+// vtkAddon includes
+#include <vtkStreamingVolumeCodec.h>
+#include <vtkStreamingVolumeCodecFactory.h>
+#include <vtkStreamingVolumeFrame.h>
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+//----------------------------------------------------------------------------
+class vtkMRMLStreamingVolumeDecodeCache::vtkInternal
+{
+public:
+  struct CacheEntry
+  {
+    vtkSmartPointer<vtkStreamingVolumeFrame> Frame;
+    vtkSmartPointer<vtkImageData> Image;
+    double SizeMB{ 0.0 };
+    /// Position of the frame in LeastRecentlyUsedFrames
+    std::list<vtkStreamingVolumeFrame*>::iterator UsageIt;
+  };
+
+  struct Worker
+  {
+    std::thread Thread;
+    std::deque<vtkSmartPointer<vtkStreamingVolumeFrame>> Queue;
+    vtkStreamingVolumeFrame* CurrentFrame{ nullptr };
+    /// Codecs are only used by this worker (codecs store the last decoded frame)
+    std::map<std::string, vtkSmartPointer<vtkStreamingVolumeCodec>> Codecs;
+  };
+
+  vtkInternal(vtkMRMLStreamingVolumeDecodeCache* external);
+
+  /// Start worker threads if they are not running yet. Mutex must be locked.
+  void StartWorkers();
+  /// Stop and join all worker threads. Mutex must not be locked.
+  void StopWorkers();
+  void WorkerLoop(Worker* worker);
+
+  /// Decoding of non-key frames must continue from the previous frame, therefore
+  /// all frames since the same key frame are assigned to the same worker.
+  Worker* GetWorkerForFrame(vtkStreamingVolumeFrame* frame);
+
+  bool IsFrameQueued(vtkStreamingVolumeFrame* frame);
+  bool IsFrameBeingDecoded(vtkStreamingVolumeFrame* frame);
+
+  /// Add a decoded image and remove least recently used images if the cache is full. Mutex must be locked.
+  void AddEntry(vtkStreamingVolumeFrame* frame, vtkImageData* image);
+  void EvictEntries(double maximumCacheSizeMB);
+  /// Mark the entry as the most recently used. Mutex must be locked.
+  void TouchEntry(CacheEntry& entry);
+  /// Remove all queued frames and decoded images. Mutex must be locked.
+  void ClearEntries();
+
+  vtkMRMLStreamingVolumeDecodeCache* External;
+
+  std::mutex Mutex;
+  std::condition_variable WorkAvailable;
+  std::condition_variable DecodeFinished;
+  bool StopRequested{ false };
+  /// Incremented when the cache is cleared, to discard results of decoding that was in progress
+  unsigned long Generation{ 0 };
+
+  std::vector<std::unique_ptr<Worker>> Workers;
+  std::map<vtkStreamingVolumeFrame*, CacheEntry> Entries;
+  /// Cached frames ordered from the least to the most recently used
+  std::list<vtkStreamingVolumeFrame*> LeastRecentlyUsedFrames;
+  double CacheSizeMB{ 0.0 };
+
+  int NumberOfCacheHits{ 0 };
+  int NumberOfCacheMisses{ 0 };
+  int NumberOfDecodedFrames{ 0 };
+  int NumberOfEvictedFrames{ 0 };
+  double TotalDecodeTimeMs{ 0.0 };
+  double MaximumDecodeTimeMs{ 0.0 };
+};
+
+//----------------------------------------------------------------------------
+vtkMRMLStreamingVolumeDecodeCache::vtkInternal::vtkInternal(vtkMRMLStreamingVolumeDecodeCache* external)
+  : External(external)
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeDecodeCache::vtkInternal::StartWorkers()
+{
+  if (!this->Workers.empty())
+  {
+    return;
+  }
+  this->StopRequested = false;
+  int numberOfThreads = std::max(1, this->External->NumberOfThreads);
+  for (int i = 0; i < numberOfThreads; ++i)
+  {
+    this->Workers.push_back(std::unique_ptr<Worker>(new Worker));
+  }
+  for (std::unique_ptr<Worker>& worker : this->Workers)
+  {
+    worker->Thread = std::thread(&vtkInternal::WorkerLoop, this, worker.get());
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeDecodeCache::vtkInternal::StopWorkers()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->StopRequested = true;
+  }
+  this->WorkAvailable.notify_all();
+  for (std::unique_ptr<Worker>& worker : this->Workers)
+  {
+    if (worker->Thread.joinable())
+    {
+      worker->Thread.join();
+    }
+  }
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  this->Workers.clear();
+  this->StopRequested = false;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeDecodeCache::vtkInternal::WorkerLoop(Worker* worker)
+{
+  std::unique_lock<std::mutex> lock(this->Mutex);
+  while (true)
+  {
+    this->WorkAvailable.wait(lock, [this, worker] { return this->StopRequested || !worker->Queue.empty(); });
+    if (this->StopRequested)
+    {
+      return;
+    }
+    vtkSmartPointer<vtkStreamingVolumeFrame> frame = worker->Queue.front();
+    worker->Queue.pop_front();
+    worker->CurrentFrame = frame;
+    vtkSmartPointer<vtkStreamingVolumeCodec> codec = worker->Codecs[frame->GetCodecFourCC()];
+    unsigned long generation = this->Generation;
+    lock.unlock();
+
+    // Decode outside of the lock
+    auto startTime = std::chrono::steady_clock::now();
+    vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+    int dimensions[3] = { 0, 0, 0 };
+    frame->GetDimensions(dimensions);
+    image->SetDimensions(dimensions);
+    image->AllocateScalars(frame->GetVTKScalarType(), frame->GetNumberOfComponents());
+    bool success = codec && codec->DecodeFrame(frame, image);
+    double decodeTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+    lock.lock();
+    worker->CurrentFrame = nullptr;
+    if (success && generation == this->Generation)
+    {
+      this->AddEntry(frame, image);
+      this->NumberOfDecodedFrames++;
+      this->TotalDecodeTimeMs += decodeTimeMs;
+      this->MaximumDecodeTimeMs = std::max(this->MaximumDecodeTimeMs, decodeTimeMs);
+    }
+    this->DecodeFinished.notify_all();
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLStreamingVolumeDecodeCache::vtkInternal::Worker* vtkMRMLStreamingVolumeDecodeCache::vtkInternal::GetWorkerForFrame(vtkStreamingVolumeFrame* frame)
+{
+  vtkStreamingVolumeFrame* keyFrame = frame;
+  while (keyFrame && !keyFrame->IsKeyFrame() && keyFrame->GetPreviousFrame())
+  {
+    keyFrame = keyFrame->GetPreviousFrame();
+  }
+  size_t workerIndex = std::hash<vtkStreamingVolumeFrame*>()(keyFrame) % this->Workers.size();
+  return this->Workers[workerIndex].get();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLStreamingVolumeDecodeCache::vtkInternal::IsFrameQueued(vtkStreamingVolumeFrame* frame)
+{
+  for (std::unique_ptr<Worker>& worker : this->Workers)
+  {
+    if (std::find(worker->Queue.begin(), worker->Queue.end(), frame) != worker->Queue.end())
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLStreamingVolumeDecodeCache::vtkInternal::IsFrameBeingDecoded(vtkStreamingVolumeFrame* frame)
+{
+  for (std::unique_ptr<Worker>& worker : this->Workers)
+  {
+    if (worker->CurrentFrame == frame)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeDecodeCache::vtkInternal::AddEntry(vtkStreamingVolumeFrame* frame, vtkImageData* image)
+{
+  auto entryIt = this->Entries.find(frame);
+  if (entryIt == this->Entries.end())
+  {
+    entryIt = this->Entries.insert(std::make_pair(frame, CacheEntry())).first;
+    entryIt->second.UsageIt = this->LeastRecentlyUsedFrames.insert(this->LeastRecentlyUsedFrames.end(), frame);
+  }
+  CacheEntry& entry = entryIt->second;
+  this->CacheSizeMB -= entry.SizeMB;
+  entry.Frame = frame;
+  entry.Image = image;
+  entry.SizeMB = image->GetActualMemorySize() / 1024.0;
+  this->TouchEntry(entry);
+  this->CacheSizeMB += entry.SizeMB;
+  this->EvictEntries(this->External->MaximumCacheSizeMB);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeDecodeCache::vtkInternal::TouchEntry(CacheEntry& entry)
+{
+  this->LeastRecentlyUsedFrames.splice(this->LeastRecentlyUsedFrames.end(), this->LeastRecentlyUsedFrames, entry.UsageIt);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeDecodeCache::vtkInternal::EvictEntries(double maximumCacheSizeMB)
+{
+  while (this->CacheSizeMB > maximumCacheSizeMB && !this->LeastRecentlyUsedFrames.empty())
+  {
+    auto leastRecentlyUsedIt = this->Entries.find(this->LeastRecentlyUsedFrames.front());
+    this->LeastRecentlyUsedFrames.pop_front();
+    this->CacheSizeMB -= leastRecentlyUsedIt->second.SizeMB;
+    this->Entries.erase(leastRecentlyUsedIt);
+    this->NumberOfEvictedFrames++;
+  }
+  if (this->Entries.empty())
+  {
+    this->CacheSizeMB = 0.0;
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeDecodeCache::vtkInternal::ClearEntries()
+{
+  for (std::unique_ptr<Worker>& worker : this->Workers)
+  {
+    worker->Queue.clear();
+  }
+  this->Entries.clear();
+  this->LeastRecentlyUsedFrames.clear();
+  this->CacheSizeMB = 0.0;
+  this->Generation++;
+}
+
+//----------------------------------------------------------------------------
+// vtkMRMLStreamingVolumeDecodeCache methods
+
+//----------------------------------------------------------------------------
+vtkMRMLStreamingVolumeDecodeCache::vtkMRMLStreamingVolumeDecodeCache()
+{
+  this->Internal = new vtkInternal(this);
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLStreamingVolumeDecodeCache::~vtkMRMLStreamingVolumeDecodeCache()
+{
+  this->Internal->StopWorkers();
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeDecodeCache::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "MaximumCacheSizeMB: " << this->MaximumCacheSizeMB << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+  os << indent << "NumberOfPrefetchFrames: " << this->NumberOfPrefetchFrames << "\n";
+  os << indent << "NumberOfCachedFrames: " << this->GetNumberOfCachedFrames() << "\n";
+  os << indent << "CacheSizeMB: " << this->GetCacheSizeMB() << "\n";
+  os << indent << "NumberOfCacheHits: " << this->GetNumberOfCacheHits() << "\n";
+  os << indent << "NumberOfCacheMisses: " << this->GetNumberOfCacheMisses() << "\n";
+  os << indent << "NumberOfDecodedFrames: " << this->GetNumberOfDecodedFrames() << "\n";
+  os << indent << "MeanDecodeTimeMs: " << this->GetMeanDecodeTimeMs() << "\n";
+  os << indent << "MaximumDecodeTimeMs: " << this->GetMaximumDecodeTimeMs() << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeDecodeCache::SetMaximumCacheSizeMB(double sizeMB)
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  if (this->MaximumCacheSizeMB == sizeMB)
+  {
+    return;
+  }
+  this->MaximumCacheSizeMB = sizeMB;
+  this->Internal->EvictEntries(this->MaximumCacheSizeMB);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeDecodeCache::SetNumberOfThreads(int numberOfThreads)
+{
+  numberOfThreads = std::max(1, numberOfThreads);
+  if (this->NumberOfThreads == numberOfThreads)
+  {
+    return;
+  }
+  // Frames are assigned to workers based on the number of threads, therefore all queues are cleared
+  this->Clear();
+  this->Internal->StopWorkers();
+  this->NumberOfThreads = numberOfThreads;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLStreamingVolumeDecodeCache::PrefetchFrame(vtkStreamingVolumeFrame* frame)
+{
+  if (!frame)
+  {
+    return false;
+  }
+  std::unique_lock<std::mutex> lock(this->Internal->Mutex);
+  if (this->Internal->Entries.count(frame) > 0 || this->Internal->IsFrameBeingDecoded(frame) || this->Internal->IsFrameQueued(frame))
+  {
+    return true;
+  }
+  this->Internal->StartWorkers();
+  vtkInternal::Worker* worker = this->Internal->GetWorkerForFrame(frame);
+  std::string fourCC = frame->GetCodecFourCC();
+  vtkSmartPointer<vtkStreamingVolumeCodec>& codec = worker->Codecs[fourCC];
+  if (!codec)
+  {
+    codec = vtkSmartPointer<vtkStreamingVolumeCodec>::Take(vtkStreamingVolumeCodecFactory::GetInstance()->CreateCodecByFourCC(fourCC));
+    if (!codec)
+    {
+      worker->Codecs.erase(fourCC);
+      vtkErrorMacro("PrefetchFrame failed: could not find codec \"" << fourCC << "\"");
+      return false;
+    }
+  }
+  worker->Queue.push_back(frame);
+  lock.unlock();
+  this->Internal->WorkAvailable.notify_all();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLStreamingVolumeDecodeCache::GetDecodedImage(vtkStreamingVolumeFrame* frame, vtkImageData* outputImage)
+{
+  if (!frame || !outputImage)
+  {
+    return false;
+  }
+  vtkSmartPointer<vtkImageData> decodedImage;
+  {
+    std::unique_lock<std::mutex> lock(this->Internal->Mutex);
+    if (this->Internal->Workers.empty() && this->Internal->Entries.empty())
+    {
+      // Prefetching is not used
+      return false;
+    }
+    // Waiting for the worker is faster than decoding the frame again
+    this->Internal->DecodeFinished.wait(lock, [this, frame] { return !this->Internal->IsFrameBeingDecoded(frame); });
+    auto entryIt = this->Internal->Entries.find(frame);
+    if (entryIt == this->Internal->Entries.end())
+    {
+      // Not decoded yet, the caller decodes it now
+      for (std::unique_ptr<vtkInternal::Worker>& worker : this->Internal->Workers)
+      {
+        worker->Queue.erase(std::remove(worker->Queue.begin(), worker->Queue.end(), frame), worker->Queue.end());
+      }
+      this->Internal->NumberOfCacheMisses++;
+      return false;
+    }
+    this->Internal->TouchEntry(entryIt->second);
+    decodedImage = entryIt->second.Image;
+    this->Internal->NumberOfCacheHits++;
+  }
+
+  // Cached images are not modified after decoding, so they can be read without locking
+  vtkDataArray* decodedScalars = decodedImage->GetPointData()->GetScalars();
+  vtkDataArray* outputScalars = outputImage->GetPointData()->GetScalars();
+  int* decodedExtent = decodedImage->GetExtent();
+  int* outputExtent = outputImage->GetExtent();
+  if (decodedScalars && outputScalars && std::equal(decodedExtent, decodedExtent + 6, outputExtent) //
+      && decodedScalars->GetDataType() == outputScalars->GetDataType()                              //
+      && decodedScalars->GetNumberOfComponents() == outputScalars->GetNumberOfComponents()          //
+      && decodedScalars->GetNumberOfTuples() == outputScalars->GetNumberOfTuples())
+  {
+    // Reuse the memory that is already allocated in the output
+    memcpy(outputScalars->GetVoidPointer(0), decodedScalars->GetVoidPointer(0), decodedScalars->GetDataSize() * decodedScalars->GetDataTypeSize());
+    outputScalars->Modified();
+  }
+  else
+  {
+    outputImage->DeepCopy(decodedImage);
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLStreamingVolumeDecodeCache::IsFrameDecoded(vtkStreamingVolumeFrame* frame)
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  return this->Internal->Entries.count(frame) > 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeDecodeCache::WaitForPrefetchCompletion()
+{
+  std::unique_lock<std::mutex> lock(this->Internal->Mutex);
+  this->Internal->DecodeFinished.wait(lock,
+                                      [this]
+                                      {
+                                        for (std::unique_ptr<vtkInternal::Worker>& worker : this->Internal->Workers)
+                                        {
+                                          if (worker->CurrentFrame || !worker->Queue.empty())
+                                          {
+                                            return false;
+                                          }
+                                        }
+                                        return true;
+                                      });
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeDecodeCache::RemoveFrame(vtkStreamingVolumeFrame* frame)
+{
+  if (!frame)
+  {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(this->Internal->Mutex);
+  for (std::unique_ptr<vtkInternal::Worker>& worker : this->Internal->Workers)
+  {
+    worker->Queue.erase(std::remove(worker->Queue.begin(), worker->Queue.end(), frame), worker->Queue.end());
+  }
+  // The decoded image would be added to the cache when decoding is completed
+  this->Internal->DecodeFinished.wait(lock, [this, frame] { return !this->Internal->IsFrameBeingDecoded(frame); });
+  auto entryIt = this->Internal->Entries.find(frame);
+  if (entryIt == this->Internal->Entries.end())
+  {
+    return;
+  }
+  this->Internal->LeastRecentlyUsedFrames.erase(entryIt->second.UsageIt);
+  this->Internal->CacheSizeMB -= entryIt->second.SizeMB;
+  this->Internal->Entries.erase(entryIt);
+  if (this->Internal->Entries.empty())
+  {
+    this->Internal->CacheSizeMB = 0.0;
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeDecodeCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  this->Internal->ClearEntries();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeDecodeCache::StopWorkerThreads()
+{
+  {
+    // Frames that are not decoded yet are not needed anymore
+    std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+    for (std::unique_ptr<vtkInternal::Worker>& worker : this->Internal->Workers)
+    {
+      worker->Queue.clear();
+    }
+  }
+  this->Internal->StopWorkers();
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLStreamingVolumeDecodeCache::GetNumberOfCachedFrames()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  return static_cast<int>(this->Internal->Entries.size());
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLStreamingVolumeDecodeCache::GetCacheSizeMB()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  return this->Internal->CacheSizeMB;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLStreamingVolumeDecodeCache::GetNumberOfQueuedFrames()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  size_t numberOfQueuedFrames = 0;
+  for (std::unique_ptr<vtkInternal::Worker>& worker : this->Internal->Workers)
+  {
+    numberOfQueuedFrames += worker->Queue.size();
+  }
+  return static_cast<int>(numberOfQueuedFrames);
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLStreamingVolumeDecodeCache::GetNumberOfCacheHits()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  return this->Internal->NumberOfCacheHits;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLStreamingVolumeDecodeCache::GetNumberOfCacheMisses()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  return this->Internal->NumberOfCacheMisses;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLStreamingVolumeDecodeCache::GetNumberOfDecodedFrames()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  return this->Internal->NumberOfDecodedFrames;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLStreamingVolumeDecodeCache::GetNumberOfEvictedFrames()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  return this->Internal->NumberOfEvictedFrames;
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLStreamingVolumeDecodeCache::GetMeanDecodeTimeMs()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  if (this->Internal->NumberOfDecodedFrames == 0)
+  {
+    return 0.0;
+  }
+  return this->Internal->TotalDecodeTimeMs / this->Internal->NumberOfDecodedFrames;
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLStreamingVolumeDecodeCache::GetMaximumDecodeTimeMs()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  return this->Internal->MaximumDecodeTimeMs;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeDecodeCache::ResetStatistics()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  this->Internal->NumberOfCacheHits = 0;
+  this->Internal->NumberOfCacheMisses = 0;
+  this->Internal->NumberOfDecodedFrames = 0;
+  this->Internal->NumberOfEvictedFrames = 0;
+  this->Internal->TotalDecodeTimeMs = 0.0;
+  this->Internal->MaximumDecodeTimeMs = 0.0;
+}
+
+VTK_SINGLETON_CXX(vtkMRMLStreamingVolumeDecodeCache);
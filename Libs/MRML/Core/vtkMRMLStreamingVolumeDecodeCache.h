@@ -0,0 +1,139 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkMRMLStreamingVolumeDecodeCache_h
+#define __vtkMRMLStreamingVolumeDecodeCache_h
+
+// MRML includes
+#include "vtkMRML.h"
+
+// VTK includes
+#include <vtkObject.h>
+#include <vtkSingleton.h>
+
+class vtkImageData;
+class vtkStreamingVolumeFrame;
+
+/// \brief Decodes compressed streaming volume frames on worker threads and keeps the decoded images in a bounded cache.
+///
+/// During sequence playback the upcoming frames are requested by PrefetchFrame, which queues them for decoding
+/// on worker threads. When vtkMRMLStreamingVolumeNode needs to decode a frame, it first calls GetDecodedImage
+/// to get the image from the cache (if the frame is being decoded, it waits for the result instead of decoding it again).
+///
+/// Frames that depend on previous frames (non-key frames) are always decoded by the same worker thread as the
+/// other frames since the last key frame, so that the codec can continue decoding from the last decoded frame.
+///
+/// When the total size of the decoded images exceeds MaximumCacheSizeMB, the least recently used images are removed.
+///
+/// \note All methods must be called from the main thread.
+class VTK_MRML_EXPORT vtkMRMLStreamingVolumeDecodeCache : public vtkObject
+{
+public:
+  vtkTypeMacro(vtkMRMLStreamingVolumeDecodeCache, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// This is a singleton pattern New. There will only be ONE
+  /// reference to a vtkMRMLStreamingVolumeDecodeCache object per process. Clients that
+  /// call this must call Delete on the object so that the reference counting will work.
+  /// The single instance will be unreferenced when the program exits.
+  static vtkMRMLStreamingVolumeDecodeCache* New();
+
+  /// Return the singleton instance with no reference counting.
+  static vtkMRMLStreamingVolumeDecodeCache* GetInstance();
+
+  /// Maximum total size of decoded images kept in the cache. Default is 512MB.
+  void SetMaximumCacheSizeMB(double sizeMB);
+  vtkGetMacro(MaximumCacheSizeMB, double);
+
+  /// Number of worker threads that decode frames. Default is 2.
+  /// Changing the number of threads clears the cache.
+  void SetNumberOfThreads(int numberOfThreads);
+  vtkGetMacro(NumberOfThreads, int);
+
+  /// Number of frames that are prefetched ahead of the current frame during sequence playback.
+  /// Set to 0 to disable prefetching. Default is 8.
+  vtkSetClampMacro(NumberOfPrefetchFrames, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfPrefetchFrames, int);
+
+  /// Queue the frame for decoding on a worker thread.
+  /// Returns false if the frame cannot be decoded (e.g., no codec is available).
+  bool PrefetchFrame(vtkStreamingVolumeFrame* frame);
+
+  /// Copy the decoded image of the frame into outputImage.
+  /// If the frame is being decoded then the method waits for completion.
+  /// If the frame is queued for decoding but decoding has not started yet then it is removed from the queue.
+  /// Returns false if the decoded image is not available.
+  bool GetDecodedImage(vtkStreamingVolumeFrame* frame, vtkImageData* outputImage);
+
+  /// Returns true if the decoded image of the frame is in the cache.
+  bool IsFrameDecoded(vtkStreamingVolumeFrame* frame);
+
+  /// Wait until all queued frames are decoded.
+  void WaitForPrefetchCompletion();
+
+  /// Remove the frame from the decoding queue and its decoded image from the cache.
+  /// If the frame is being decoded then the method waits for completion.
+  /// It must be called when a streaming volume frame is removed (for example, when
+  /// a sequence node is removed), to release the decoded image.
+  void RemoveFrame(vtkStreamingVolumeFrame* frame);
+
+  /// Remove all queued frames and decoded images.
+  /// It must be called when all streaming volume frames are removed (for example, when
+  /// the scene is closed), to release the decoded images.
+  void Clear();
+
+  /// Remove all queued frames and stop and join the worker threads.
+  /// Decoded images are kept. Worker threads are started again when a frame is prefetched.
+  void StopWorkerThreads();
+
+  /// Statistics
+  int GetNumberOfCachedFrames();
+  double GetCacheSizeMB();
+  int GetNumberOfQueuedFrames();
+  int GetNumberOfCacheHits();
+  int GetNumberOfCacheMisses();
+  int GetNumberOfDecodedFrames();
+  int GetNumberOfEvictedFrames();
+  double GetMeanDecodeTimeMs();
+  double GetMaximumDecodeTimeMs();
+  void ResetStatistics();
+
+protected:
+  vtkMRMLStreamingVolumeDecodeCache();
+  ~vtkMRMLStreamingVolumeDecodeCache() override;
+
+  VTK_SINGLETON_DECLARE(vtkMRMLStreamingVolumeDecodeCache);
+
+  double MaximumCacheSizeMB{ 512.0 };
+  int NumberOfThreads{ 2 };
+  int NumberOfPrefetchFrames{ 8 };
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkMRMLStreamingVolumeDecodeCache(const vtkMRMLStreamingVolumeDecodeCache&) = delete;
+  void operator=(const vtkMRMLStreamingVolumeDecodeCache&) = delete;
+};
+
+#ifndef __VTK_WRAP__
+// BTX
+VTK_SINGLETON_DECLARE_INITIALIZER(VTK_MRML_EXPORT, vtkMRMLStreamingVolumeDecodeCache);
+// ETX
+#endif // __VTK_WRAP__
+
+#endif
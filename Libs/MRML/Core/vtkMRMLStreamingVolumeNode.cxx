@@ -19,6 +19,7 @@ Care Ontario.
 ==============================================================================*/
 
 // MRML includes
+#include "vtkMRMLStreamingVolumeDecodeCache.h"
 #include "vtkMRMLStreamingVolumeNode.h"
 
 // VTK includes
@@ -243,6 +244,10 @@ bool vtkMRMLStreamingVolumeNode::DecodeFrame()
     vtkErrorMacro("Cannot decode frame. No destination image data!");
     success = false;
   }
+  else if (vtkMRMLStreamingVolumeDecodeCache::GetInstance()->GetDecodedImage(this->Frame, imageData))
+  {
+    // Frame has been already decoded by a prefetch worker thread
+  }
   else if (!this->GetCodec())
   {
     vtkErrorMacro("Could not find codec \"" << this->GetCodecFourCC() << "\"");
@@ -2134,6 +2134,16 @@ void vtkMRMLSubjectHierarchyNode::SetItemDataNode(vtkIdType itemID, vtkMRMLNode*
   this->Internal->AddItemObservers(item);
 }
 
+//----------------------------------------------------------------------------
+bool vtkMRMLSubjectHierarchyNode::HasItem(vtkIdType itemID)
+{
+  if (!itemID)
+  {
+    return false;
+  }
+  return this->Internal->FindItemByID(itemID) != nullptr;
+}
+
 //----------------------------------------------------------------------------
 vtkMRMLNode* vtkMRMLSubjectHierarchyNode::GetItemDataNode(vtkIdType itemID)
 {
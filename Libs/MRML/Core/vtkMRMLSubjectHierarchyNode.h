@@ -130,6 +130,9 @@ public:
 
   /// Get ID of root subject hierarchy item (which can be interpreted as the scene in terms of hierarchy)
   vtkIdType GetSceneItemID();
+  /// Returns true if an item with the given ID exists in the subject hierarchy.
+  /// Unlike the item accessor methods, it does not log an error if the item is not found.
+  bool HasItem(vtkIdType itemID);
   /// Get data node for a subject hierarchy item
   vtkMRMLNode* GetItemDataNode(vtkIdType itemID);
   /// Set name for a subject hierarchy item
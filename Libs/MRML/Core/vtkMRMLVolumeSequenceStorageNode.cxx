@@ -8,9 +8,12 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 =========================================================================auto=*/
 
 #include <algorithm>
+#include <fstream>
 
 #include <vtkAddonMathUtilities.h>
+#include <vtkStreamingVolumeFrame.h>
 
+#include "vtkLosslessDeltaVolumeCodec.h"
 #include "vtkMRMLI18N.h"
 #include "vtkMRMLMessageCollection.h"
 #include "vtkMRMLVolumeSequenceStorageNode.h"
@@ -29,6 +32,7 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 #include "vtkImageExtractComponents.h"
 #include "vtkNew.h"
 #include "vtkStringArray.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtksys/SystemTools.hxx"
 
 //----------------------------------------------------------------------------
@@ -68,6 +72,11 @@ int vtkMRMLVolumeSequenceStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
     return 0;
   }
 
+  if (vtkMRMLVolumeSequenceStorageNode::IsLosslessDeltaFileName(fullName))
+  {
+    return this->ReadLosslessDeltaSequence(volSequenceNode, fullName);
+  }
+
   vtkNew<vtkTeemNRRDReader> reader;
   reader->SetFileName(fullName.c_str());
 
@@ -290,13 +299,9 @@ bool vtkMRMLVolumeSequenceStorageNode::CanWriteFromReferenceNode(vtkMRMLNode* re
   {
     firstFrameVolume->GetImageData()->GetExtent(firstFrameVolumeExtent);
     firstFrameVolumeScalarType = firstFrameVolume->GetImageData()->GetScalarType();
+    // Multi-component volumes can be written into .seq.sldc files, the number of components is checked
+    // in WriteDataInternal when the file format is known.
     firstFrameVolumeNumberOfComponents = firstFrameVolume->GetImageData()->GetNumberOfScalarComponents();
-    // VTK NRRD writer only supports 4D volumes (writing a 3D color volume sequence would require 5D)
-    if (firstFrameVolumeNumberOfComponents != 1)
-    {
-      this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("Only single scalar component volumes can be written in this format."));
-      return false;
-    }
   }
   vtkNew<vtkMatrix4x4> firstVolumeIjkToRas;
   firstFrameVolume->GetIJKToRASMatrix(firstVolumeIjkToRas.GetPointer());
@@ -367,6 +372,11 @@ int vtkMRMLVolumeSequenceStorageNode::WriteDataInternal(vtkMRMLNode* refNode)
     return 0;
   }
 
+  if (vtkMRMLVolumeSequenceStorageNode::IsLosslessDeltaFileName(this->GetFullNameFromFileName()))
+  {
+    return this->WriteLosslessDeltaSequence(volSequenceNode, this->GetFullNameFromFileName());
+  }
+
   vtkNew<vtkMatrix4x4> firstVolumeIjkToRas;
   int frameVolumeDimensions[3] = { 0 };
   int frameVolumeScalarType = VTK_VOID;
@@ -384,6 +394,12 @@ int vtkMRMLVolumeSequenceStorageNode::WriteDataInternal(vtkMRMLNode* refNode)
     {
       frameVolume->GetImageData()->GetDimensions(frameVolumeDimensions);
       frameVolumeScalarType = frameVolume->GetImageData()->GetScalarType();
+      // VTK NRRD writer only supports 4D volumes (writing a 3D color volume sequence would require 5D)
+      if (frameVolume->GetImageData()->GetNumberOfScalarComponents() != 1)
+      {
+        this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("Only single scalar component volumes can be written in this format."));
+        return 0;
+      }
     }
   }
 
@@ -623,6 +639,9 @@ void vtkMRMLVolumeSequenceStorageNode::InitializeSupportedReadFileTypes()
   this->SupportedReadFileTypes->InsertNextValue(fileType + " (.seq.nhdr)");
   this->SupportedReadFileTypes->InsertNextValue(fileType + " (.nrrd)");
   this->SupportedReadFileTypes->InsertNextValue(fileType + " (.nhdr)");
+  //: File format name
+  std::string losslessDeltaFileType = vtkMRMLTr("vtkMRMLVolumeSequenceStorageNode", "Volume Sequence (lossless delta)");
+  this->SupportedReadFileTypes->InsertNextValue(losslessDeltaFileType + " (.seq.sldc)");
 }
 
 //----------------------------------------------------------------------------
@@ -634,6 +653,9 @@ void vtkMRMLVolumeSequenceStorageNode::InitializeSupportedWriteFileTypes()
   this->SupportedWriteFileTypes->InsertNextValue(fileType + " (.seq.nhdr)");
   this->SupportedWriteFileTypes->InsertNextValue(fileType + " (.nrrd)");
   this->SupportedWriteFileTypes->InsertNextValue(fileType + " (.nhdr)");
+  //: File format name
+  std::string losslessDeltaFileType = vtkMRMLTr("vtkMRMLVolumeSequenceStorageNode", "Volume Sequence (lossless delta)");
+  this->SupportedWriteFileTypes->InsertNextValue(losslessDeltaFileType + " (.seq.sldc)");
 }
 
 //----------------------------------------------------------------------------
@@ -641,3 +663,316 @@ const char* vtkMRMLVolumeSequenceStorageNode::GetDefaultWriteFileExtension()
 {
   return "seq.nrrd";
 }
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSequenceStorageNode::IsLosslessDeltaFileName(const std::string& fileName)
+{
+  std::string extension = ".seq.sldc";
+  std::string lowerCaseFileName = vtksys::SystemTools::LowerCase(fileName);
+  return lowerCaseFileName.size() >= extension.size() && lowerCaseFileName.compare(lowerCaseFileName.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLVolumeSequenceStorageNode::WriteLosslessDeltaSequence(vtkMRMLSequenceNode* volSequenceNode, const std::string& fullName)
+{
+  int numberOfFrameVolumes = volSequenceNode->GetNumberOfDataNodes();
+  vtkNew<vtkMatrix4x4> firstVolumeIjkToRas;
+  int frameVolumeDimensions[3] = { 0, 0, 0 };
+  int frameVolumeScalarType = VTK_VOID;
+  int frameVolumeNumberOfComponents = 0;
+  for (int frameIndex = 0; frameIndex < numberOfFrameVolumes; frameIndex++)
+  {
+    vtkMRMLVolumeNode* frameVolume = vtkMRMLVolumeNode::SafeDownCast(volSequenceNode->GetNthDataNode(frameIndex));
+    if (frameVolume == nullptr || frameVolume->GetImageData() == nullptr)
+    {
+      vtkDebugMacro(<< "vtkMRMLVolumeSequenceStorageNode::WriteLosslessDeltaSequence: Data node " << frameIndex << " is not a volume or has no image data");
+      this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("Only volume sequence can be written in this format."));
+      return 0;
+    }
+    int currentFrameVolumeDimensions[3] = { 0, 0, 0 };
+    frameVolume->GetImageData()->GetDimensions(currentFrameVolumeDimensions);
+    vtkNew<vtkMatrix4x4> currentVolumeIjkToRas;
+    frameVolume->GetIJKToRASMatrix(currentVolumeIjkToRas);
+    if (frameIndex == 0)
+    {
+      firstVolumeIjkToRas->DeepCopy(currentVolumeIjkToRas);
+      std::copy(currentFrameVolumeDimensions, currentFrameVolumeDimensions + 3, frameVolumeDimensions);
+      frameVolumeScalarType = frameVolume->GetImageData()->GetScalarType();
+      frameVolumeNumberOfComponents = frameVolume->GetImageData()->GetNumberOfScalarComponents();
+    }
+    else if (!vtkAddonMathUtilities::MatrixAreEqual(currentVolumeIjkToRas, firstVolumeIjkToRas) //
+             || !std::equal(currentFrameVolumeDimensions, currentFrameVolumeDimensions + 3, frameVolumeDimensions) //
+             || frameVolume->GetImageData()->GetScalarType() != frameVolumeScalarType //
+             || frameVolume->GetImageData()->GetNumberOfScalarComponents() != frameVolumeNumberOfComponents)
+    {
+      vtkDebugMacro(<< "vtkMRMLVolumeSequenceStorageNode::WriteLosslessDeltaSequence: Data node " << frameIndex << " geometry, size, or scalar type mismatch");
+      this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("All volumes must be of the same type and geometry."));
+      return 0;
+    }
+  }
+
+  std::ofstream output(fullName.c_str(), std::ios::out | std::ios::binary);
+  if (!output)
+  {
+    this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("Failed to open file for writing: ") + fullName);
+    return 0;
+  }
+
+  // Text header (similar to NRRD header), terminated by an empty line
+  output.precision(17);
+  output << "SLDC volume sequence 1\n";
+  output << "dimensions: " << frameVolumeDimensions[0] << " " << frameVolumeDimensions[1] << " " << frameVolumeDimensions[2] << "\n";
+  output << "scalar type: " << frameVolumeScalarType << "\n";
+  output << "components: " << frameVolumeNumberOfComponents << "\n";
+  output << "ijk to ras:";
+  for (int row = 0; row < 4; ++row)
+  {
+    for (int column = 0; column < 4; ++column)
+    {
+      output << " " << firstVolumeIjkToRas->GetElement(row, column);
+    }
+  }
+  output << "\n";
+  output << "frames: " << numberOfFrameVolumes << "\n";
+  // Encode strings to make sure there are no spaces or line breaks in the serialized values
+  output << "index name: " << vtkMRMLNode::URLEncodeString(volSequenceNode->GetIndexName().c_str()) << "\n";
+  output << "index unit: " << vtkMRMLNode::URLEncodeString(volSequenceNode->GetIndexUnit().c_str()) << "\n";
+  output << "index type: " << vtkMRMLNode::URLEncodeString(volSequenceNode->GetIndexTypeAsString().c_str()) << "\n";
+  output << "index values:";
+  for (int frameIndex = 0; frameIndex < numberOfFrameVolumes; frameIndex++)
+  {
+    output << " " << vtkMRMLNode::URLEncodeString(volSequenceNode->GetNthIndexValue(frameIndex).c_str());
+  }
+  output << "\n";
+  // Pass down all MRML attributes, including "DataNodeClassName", which is used to determine the type of the data node
+  std::vector<std::string> attributeNames = volSequenceNode->GetAttributeNames();
+  for (const std::string& attributeName : attributeNames)
+  {
+    // URLEncodeString returns an internal buffer, therefore the result is copied before encoding the next string
+    std::string encodedAttributeName = vtkMRMLNode::URLEncodeString(attributeName.c_str());
+    std::string encodedAttributeValue = vtkMRMLNode::URLEncodeString(volSequenceNode->GetAttribute(attributeName.c_str()));
+    output << "attribute " << encodedAttributeName << ": " << encodedAttributeValue << "\n";
+  }
+  output << "\n";
+
+  // Frames: 8-byte little endian size followed by frame data
+  vtkNew<vtkLosslessDeltaVolumeCodec> codec;
+  for (int frameIndex = 0; frameIndex < numberOfFrameVolumes; ++frameIndex)
+  {
+    vtkMRMLVolumeNode* frameVolume = vtkMRMLVolumeNode::SafeDownCast(volSequenceNode->GetNthDataNode(frameIndex));
+    vtkNew<vtkStreamingVolumeFrame> frame;
+    if (!codec->EncodeImageData(frameVolume->GetImageData(), frame))
+    {
+      this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("Failed to compress volume sequence frame."));
+      return 0;
+    }
+    vtkUnsignedCharArray* frameData = frame->GetFrameData();
+    vtkIdType frameDataSize = frameData->GetNumberOfValues();
+    unsigned char frameDataSizeBytes[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    for (int byteIndex = 0; byteIndex < 8; ++byteIndex)
+    {
+      frameDataSizeBytes[byteIndex] = static_cast<unsigned char>(static_cast<vtkTypeUInt64>(frameDataSize) >> (8 * byteIndex));
+    }
+    output.write(reinterpret_cast<char*>(frameDataSizeBytes), 8);
+    output.write(reinterpret_cast<char*>(frameData->GetPointer(0)), frameDataSize);
+  }
+  output.close();
+  if (output.fail())
+  {
+    this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("Failed to write file: ") + fullName);
+    return 0;
+  }
+
+  this->StageWriteData(volSequenceNode);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLVolumeSequenceStorageNode::ReadLosslessDeltaSequence(vtkMRMLSequenceNode* volSequenceNode, const std::string& fullName)
+{
+  std::ifstream input(fullName.c_str(), std::ios::in | std::ios::binary);
+  std::string line;
+  if (!input || !std::getline(input, line) || line != "SLDC volume sequence 1")
+  {
+    vtkErrorMacro("vtkMRMLVolumeSequenceStorageNode::ReadLosslessDeltaSequence: " << fullName << " is not a lossless delta compressed volume sequence file");
+    return 0;
+  }
+
+  int dimensions[3] = { 0, 0, 0 };
+  int scalarType = VTK_VOID;
+  int numberOfComponents = 0;
+  int numberOfFrames = 0;
+  vtkNew<vtkMatrix4x4> ijkToRas;
+  std::vector<std::string> indexValues;
+  std::string dataNodeClassName;
+  while (std::getline(input, line) && !line.empty())
+  {
+    size_t separatorPosition = line.find(": ");
+    if (separatorPosition == std::string::npos)
+    {
+      // empty values are written without space after the separator
+      separatorPosition = line.find(':');
+    }
+    if (separatorPosition == std::string::npos)
+    {
+      vtkWarningMacro("vtkMRMLVolumeSequenceStorageNode::ReadLosslessDeltaSequence: invalid header line: " << line);
+      continue;
+    }
+    std::string key = line.substr(0, separatorPosition);
+    std::string value = line.substr(std::min(line.size(), separatorPosition + 2));
+    std::istringstream valueStream(value);
+    if (key == "dimensions")
+    {
+      valueStream >> dimensions[0] >> dimensions[1] >> dimensions[2];
+    }
+    else if (key == "scalar type")
+    {
+      valueStream >> scalarType;
+    }
+    else if (key == "components")
+    {
+      valueStream >> numberOfComponents;
+    }
+    else if (key == "ijk to ras")
+    {
+      for (int i = 0; i < 16; ++i)
+      {
+        double element = 0.0;
+        valueStream >> element;
+        ijkToRas->SetElement(i / 4, i % 4, element);
+      }
+    }
+    else if (key == "frames")
+    {
+      valueStream >> numberOfFrames;
+    }
+    else if (key == "index name")
+    {
+      volSequenceNode->SetIndexName(vtkMRMLNode::URLDecodeString(value.c_str()));
+    }
+    else if (key == "index unit")
+    {
+      volSequenceNode->SetIndexUnit(vtkMRMLNode::URLDecodeString(value.c_str()));
+    }
+    else if (key == "index type")
+    {
+      volSequenceNode->SetIndexTypeFromString(vtkMRMLNode::URLDecodeString(value.c_str()));
+    }
+    else if (key == "index values")
+    {
+      std::string indexValue;
+      while (valueStream >> indexValue)
+      {
+        indexValues.push_back(vtkMRMLNode::URLDecodeString(indexValue.c_str()));
+      }
+    }
+    else if (key.compare(0, 10, "attribute ") == 0)
+    {
+      std::string attributeName = vtkMRMLNode::URLDecodeString(key.substr(10).c_str());
+      std::string attributeValue = vtkMRMLNode::URLDecodeString(value.c_str());
+      if (attributeName == "DataNodeClassName")
+      {
+        dataNodeClassName = attributeValue;
+      }
+      else
+      {
+        volSequenceNode->SetAttribute(attributeName.c_str(), attributeValue.c_str());
+      }
+    }
+  }
+
+  if (dimensions[0] <= 0 || dimensions[1] <= 0 || dimensions[2] <= 0 || scalarType == VTK_VOID || numberOfComponents <= 0)
+  {
+    vtkErrorMacro("vtkMRMLVolumeSequenceStorageNode::ReadLosslessDeltaSequence: invalid image properties in file header");
+    return 0;
+  }
+  if (dataNodeClassName.empty())
+  {
+    dataNodeClassName = "vtkMRMLScalarVolumeNode";
+  }
+
+  // Size of the file is used for validating frame sizes before allocating memory for the frames
+  const std::streamoff framesBegin = input.tellg();
+  input.seekg(0, std::ios::end);
+  const std::streamoff fileSize = input.tellg();
+  input.seekg(framesBegin);
+
+  vtkNew<vtkLosslessDeltaVolumeCodec> codec;
+  vtkSmartPointer<vtkStreamingVolumeFrame> previousFrame;
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+  {
+    unsigned char frameDataSizeBytes[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    input.read(reinterpret_cast<char*>(frameDataSizeBytes), 8);
+    vtkTypeUInt64 frameDataSizeInFile = 0;
+    for (int byteIndex = 7; byteIndex >= 0; --byteIndex)
+    {
+      frameDataSizeInFile = (frameDataSizeInFile << 8) | frameDataSizeBytes[byteIndex];
+    }
+    if (!input || frameDataSizeInFile > static_cast<vtkTypeUInt64>(VTK_ID_MAX) || frameDataSizeInFile > static_cast<vtkTypeUInt64>(fileSize - input.tellg()))
+    {
+      vtkErrorMacro("vtkMRMLVolumeSequenceStorageNode::ReadLosslessDeltaSequence: invalid size of frame " << frameIndex);
+      return 0;
+    }
+    vtkIdType frameDataSize = static_cast<vtkIdType>(frameDataSizeInFile);
+    vtkNew<vtkUnsignedCharArray> frameData;
+    frameData->SetNumberOfValues(frameDataSize);
+    input.read(reinterpret_cast<char*>(frameData->GetPointer(0)), frameDataSize);
+    if (!input)
+    {
+      vtkErrorMacro("vtkMRMLVolumeSequenceStorageNode::ReadLosslessDeltaSequence: unexpected end of file at frame " << frameIndex);
+      return 0;
+    }
+    bool keyFrame = vtkLosslessDeltaVolumeCodec::IsKeyFrameData(frameData->GetPointer(0), frameDataSize);
+
+    vtkSmartPointer<vtkStreamingVolumeFrame> frame = vtkSmartPointer<vtkStreamingVolumeFrame>::New();
+    frame->SetFrameData(frameData);
+    frame->SetFrameType(keyFrame ? vtkStreamingVolumeFrame::IFrame : vtkStreamingVolumeFrame::PFrame);
+    frame->SetPreviousFrame(keyFrame ? nullptr : previousFrame.GetPointer());
+    frame->SetDimensions(dimensions);
+    frame->SetVTKScalarType(scalarType);
+    frame->SetNumberOfComponents(numberOfComponents);
+    frame->SetCodecFourCC(codec->GetFourCC());
+
+    vtkNew<vtkImageData> frameVoxels;
+    if (!codec->DecodeFrame(frame, frameVoxels))
+    {
+      vtkErrorMacro("vtkMRMLVolumeSequenceStorageNode::ReadLosslessDeltaSequence: failed to decode frame " << frameIndex);
+      return 0;
+    }
+    // Frame data is only needed for decoding the next frame
+    if (previousFrame)
+    {
+      previousFrame->SetPreviousFrame(nullptr);
+    }
+    previousFrame = frame;
+
+    vtkSmartPointer<vtkMRMLVolumeNode> frameVolume;
+    if (this->GetScene())
+    {
+      frameVolume = vtkSmartPointer<vtkMRMLVolumeNode>::Take(vtkMRMLVolumeNode::SafeDownCast(this->GetScene()->CreateNodeByClass(dataNodeClassName.c_str())));
+    }
+    else
+    {
+      vtkWarningMacro("vtkMRMLVolumeSequenceStorageNode::ReadLosslessDeltaSequence: Scene is not set.");
+    }
+    if (frameVolume == nullptr)
+    {
+      if (dataNodeClassName != "vtkMRMLScalarVolumeNode")
+      {
+        vtkErrorMacro("Requested DataNodeClass is " << dataNodeClassName << " but volume sequence will be read into vtkMRMLScalarVolumeNode.");
+      }
+      frameVolume = vtkSmartPointer<vtkMRMLScalarVolumeNode>::New();
+    }
+    frameVolume->SetAndObserveImageData(frameVoxels);
+    frameVolume->SetIJKToRASMatrix(ijkToRas);
+
+    std::string indexValue = (static_cast<int>(indexValues.size()) > frameIndex ? indexValues[frameIndex] : std::to_string(frameIndex));
+    std::ostringstream nameStr;
+    nameStr << volSequenceNode->GetName() << "_" << std::setw(4) << std::setfill('0') << frameIndex;
+    frameVolume->SetName(nameStr.str().c_str());
+    volSequenceNode->SetDataNodeAtValue(frameVolume, indexValue);
+  }
+
+  vtkDebugMacro(<< " vtkMRMLVolumeSequenceStorageNode::ReadLosslessDeltaSequence: sequence successfully read. ");
+  return 1;
+}
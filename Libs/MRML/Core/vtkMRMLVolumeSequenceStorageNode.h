@@ -18,6 +18,8 @@
 #include "vtkMRMLNRRDStorageNode.h"
 #include <string>
 
+class vtkMRMLSequenceNode;
+
 class VTK_MRML_EXPORT vtkMRMLVolumeSequenceStorageNode : public vtkMRMLNRRDStorageNode
 {
 public:
@@ -38,6 +40,9 @@ public:
 
   /// Write the data. Returns 1 on success, 0 otherwise.
   ///
+  /// If the file extension is .seq.sldc then frames are compressed with
+  /// vtkLosslessDeltaVolumeCodec (lossless, faster and usually smaller than gzip
+  /// for temporally correlated images). Otherwise:
 #ifdef NRRD_CHUNK_IO_AVAILABLE
   /// The nrrd file will be formatted such as:
   /// "kinds: domain domain domain list"
@@ -73,6 +78,13 @@ protected:
 
   int ReadDataInternal(vtkMRMLNode* refNode) override;
 
+  /// Returns true if the file is a lossless delta compressed volume sequence (.seq.sldc)
+  static bool IsLosslessDeltaFileName(const std::string& fileName);
+
+  /// Read/write volume sequence compressed by vtkLosslessDeltaVolumeCodec. Returns 1 on success, 0 otherwise.
+  int ReadLosslessDeltaSequence(vtkMRMLSequenceNode* volSequenceNode, const std::string& fullName);
+  int WriteLosslessDeltaSequence(vtkMRMLSequenceNode* volSequenceNode, const std::string& fullName);
+
   /// Initialize all the supported write file types
   void InitializeSupportedReadFileTypes() override;
 
@@ -0,0 +1,331 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRMLDisplayableManager includes
+#include <vtkMRMLDisplayableManagerGroup.h>
+#include <vtkMRMLDisplayableManagerProfiler.h>
+#include <vtkMRMLThreeDViewDisplayableManagerFactory.h>
+#include <vtkMRMLAbstractThreeDViewDisplayableManager.h>
+#include <vtkMRMLTestThreeDViewDisplayableManager.h>
+
+// MRMLLogic includes
+#include <vtkMRMLApplicationLogic.h>
+
+// MRML includes
+#include <vtkMRMLCameraNode.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLViewNode.h>
+
+// VTK includes
+#include <vtkAbstractArray.h>
+#include <vtkCommand.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkTable.h>
+#include <vtkTesting.h>
+
+// STD includes
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Displayable manager that spends time processing modified events of an observed node
+class vtkMRMLProfilerTestNodeDisplayableManager : public vtkMRMLAbstractThreeDViewDisplayableManager
+{
+public:
+  static vtkMRMLProfilerTestNodeDisplayableManager* New();
+  vtkTypeMacro(vtkMRMLProfilerTestNodeDisplayableManager, vtkMRMLAbstractThreeDViewDisplayableManager);
+
+  void ObserveNode(vtkMRMLNode* node) { vtkObserveMRMLNodeMacro(node); }
+
+  static constexpr double ProcessingTime = 0.02;
+
+protected:
+  vtkMRMLProfilerTestNodeDisplayableManager() = default;
+  ~vtkMRMLProfilerTestNodeDisplayableManager() override = default;
+
+  void ProcessMRMLNodesEvents(vtkObject* caller, unsigned long event, void* callData) override
+  {
+    if (vtkMRMLCameraNode::SafeDownCast(caller) && event == vtkCommand::ModifiedEvent)
+    {
+      std::this_thread::sleep_for(std::chrono::duration<double>(ProcessingTime));
+    }
+    this->Superclass::ProcessMRMLNodesEvents(caller, event, callData);
+  }
+};
+vtkStandardNewMacro(vtkMRMLProfilerTestNodeDisplayableManager);
+
+//----------------------------------------------------------------------------
+/// Displayable manager that spends time processing node added scene events
+/// and modifies a node meanwhile, which triggers processing in other displayable managers.
+class vtkMRMLProfilerTestSceneDisplayableManager : public vtkMRMLAbstractThreeDViewDisplayableManager
+{
+public:
+  static vtkMRMLProfilerTestSceneDisplayableManager* New();
+  vtkTypeMacro(vtkMRMLProfilerTestSceneDisplayableManager, vtkMRMLAbstractThreeDViewDisplayableManager);
+
+  vtkMRMLNode* NodeToModify{ nullptr };
+
+  static constexpr double ProcessingTime = 0.01;
+
+protected:
+  vtkMRMLProfilerTestSceneDisplayableManager() = default;
+  ~vtkMRMLProfilerTestSceneDisplayableManager() override = default;
+
+  void OnMRMLSceneNodeAdded(vtkMRMLNode* vtkNotUsed(node)) override
+  {
+    if (!this->NodeToModify)
+    {
+      return;
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(ProcessingTime));
+    this->NodeToModify->Modified();
+  }
+};
+vtkStandardNewMacro(vtkMRMLProfilerTestSceneDisplayableManager);
+
+//----------------------------------------------------------------------------
+int TestNestedDisplayableManagerCalls(vtkMRMLScene* scene, vtkMRMLDisplayableManagerGroup* group)
+{
+  vtkMRMLDisplayableManagerProfiler* profiler = vtkMRMLDisplayableManagerProfiler::GetInstance();
+
+  vtkNew<vtkMRMLProfilerTestNodeDisplayableManager> nodeDisplayableManager;
+  group->AddDisplayableManager(nodeDisplayableManager);
+  vtkNew<vtkMRMLProfilerTestSceneDisplayableManager> sceneDisplayableManager;
+  group->AddDisplayableManager(sceneDisplayableManager);
+
+  vtkNew<vtkMRMLCameraNode> observedNode;
+  scene->AddNode(observedNode);
+  nodeDisplayableManager->ObserveNode(observedNode);
+  sceneDisplayableManager->NodeToModify = observedNode;
+
+  // Scene event processing in one displayable manager triggers node event processing in another
+  profiler->Reset();
+  profiler->SetEnabled(true);
+  vtkNew<vtkMRMLCameraNode> addedNode;
+  scene->AddNode(addedNode);
+  profiler->SetEnabled(false);
+  sceneDisplayableManager->NodeToModify = nullptr;
+
+  // Every call is recorded, including the nested one
+  const char* sceneManagerName = "vtkMRMLProfilerTestSceneDisplayableManager";
+  const char* nodeManagerName = "vtkMRMLProfilerTestNodeDisplayableManager";
+  if (profiler->GetNumberOfCalls(sceneManagerName, vtkMRMLDisplayableManagerProfiler::SceneEventCall) != 1 //
+      || profiler->GetNumberOfCalls(nodeManagerName, vtkMRMLDisplayableManagerProfiler::NodeEventCall) != 1)
+  {
+    std::cerr << "Line " << __LINE__ << " - Nested calls must be all recorded" << std::endl;
+    std::cerr << "\tscene event calls: " << profiler->GetNumberOfCalls(sceneManagerName, vtkMRMLDisplayableManagerProfiler::SceneEventCall) << " - expected: 1" << std::endl;
+    std::cerr << "\tnode event calls: " << profiler->GetNumberOfCalls(nodeManagerName, vtkMRMLDisplayableManagerProfiler::NodeEventCall) << " - expected: 1" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Inclusive time of the outer call contains the nested call, its self time does not
+  double sceneManagerTotalTime = profiler->GetTotalTime(sceneManagerName);
+  double sceneManagerSelfTime = profiler->GetTotalSelfTime(sceneManagerName);
+  double nodeManagerTotalTime = profiler->GetTotalTime(nodeManagerName);
+  double nodeManagerSelfTime = profiler->GetTotalSelfTime(nodeManagerName);
+  if (sceneManagerSelfTime < vtkMRMLProfilerTestSceneDisplayableManager::ProcessingTime                        //
+      || sceneManagerTotalTime < sceneManagerSelfTime + vtkMRMLProfilerTestNodeDisplayableManager::ProcessingTime //
+      || nodeManagerSelfTime < vtkMRMLProfilerTestNodeDisplayableManager::ProcessingTime                          //
+      || std::abs(nodeManagerTotalTime - nodeManagerSelfTime) > 1e-9)
+  {
+    std::cerr << "Line " << __LINE__ << " - Problem with inclusive or self time of nested calls" << std::endl;
+    std::cerr << "\tscene displayable manager total: " << sceneManagerTotalTime << " self: " << sceneManagerSelfTime << std::endl;
+    std::cerr << "\tnode displayable manager total: " << nodeManagerTotalTime << " self: " << nodeManagerSelfTime << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  profiler->Reset();
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLDisplayableManagerProfilerTest1(int argc, char* argv[])
+{
+  vtkNew<vtkTesting> testHelper;
+  testHelper->AddArguments(argc, const_cast<const char**>(argv));
+
+  vtkMRMLDisplayableManagerProfiler* profiler = vtkMRMLDisplayableManagerProfiler::GetInstance();
+  if (!profiler || profiler->GetEnabled())
+  {
+    std::cerr << "Line " << __LINE__ << " - Profiler must exist and be disabled by default" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLApplicationLogic> mrmlAppLogic;
+  mrmlAppLogic->SetMRMLScene(scene.GetPointer());
+
+  vtkMRMLThreeDViewDisplayableManagerFactory* factory = vtkMRMLThreeDViewDisplayableManagerFactory::GetInstance();
+  factory->RegisterDisplayableManager("vtkMRMLTestThreeDViewDisplayableManager");
+
+  vtkNew<vtkRenderer> rr;
+  vtkNew<vtkRenderWindow> rw;
+  rw->SetSize(100, 100);
+  rw->AddRenderer(rr.GetPointer());
+
+  vtkMRMLDisplayableManagerGroup* group = factory->InstantiateDisplayableManagers(rr.GetPointer());
+  if (!group)
+  {
+    std::cerr << "Line " << __LINE__ << " - Problem with factory->InstantiateDisplayableManagers() method" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkMRMLViewNode> viewNode;
+  viewNode->SetLayoutName("1");
+  scene->AddNode(viewNode.GetPointer());
+  group->SetMRMLDisplayableNode(viewNode.GetPointer());
+
+  // Nothing is recorded while the profiler is disabled
+  vtkNew<vtkMRMLCameraNode> cameraNode1;
+  scene->AddNode(cameraNode1.GetPointer());
+  group->RequestRender();
+  rw->Render();
+  if (profiler->GetNumberOfCalls("vtkMRMLTestThreeDViewDisplayableManager") != 0 //
+      || profiler->GetNumberOfRenderRequests() != 0                            //
+      || profiler->GetNumberOfRenders() != 0                                   //
+      || profiler->GetNumberOfTraceEvents() != 0)
+  {
+    std::cerr << "Line " << __LINE__ << " - Calls must not be recorded when the profiler is disabled" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Scene events, render requests and renders are recorded when enabled
+  profiler->SetEnabled(true);
+  vtkNew<vtkMRMLCameraNode> cameraNode2;
+  scene->AddNode(cameraNode2.GetPointer());
+  group->RequestRender();
+  group->RequestRender();
+  rw->Render();
+  profiler->SetEnabled(false);
+
+  int numberOfCalls = profiler->GetNumberOfCalls("vtkMRMLTestThreeDViewDisplayableManager");
+  if (numberOfCalls < 1 || profiler->GetTotalTime("vtkMRMLTestThreeDViewDisplayableManager") < 0.0)
+  {
+    std::cerr << "Line " << __LINE__ << " - Problem with GetNumberOfCalls() or GetTotalTime() method" << std::endl;
+    std::cerr << "\tnumberOfCalls: " << numberOfCalls << " - expected: at least 1" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (profiler->GetNumberOfRenderRequests("1") != 2 || profiler->GetNumberOfRenderRequests("NonExistentView") != 0)
+  {
+    std::cerr << "Line " << __LINE__ << " - Problem with GetNumberOfRenderRequests() method" << std::endl;
+    std::cerr << "\tcount: " << profiler->GetNumberOfRenderRequests("1") << " - expected: 2" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (profiler->GetNumberOfRenders("1") != 1)
+  {
+    std::cerr << "Line " << __LINE__ << " - Problem with GetNumberOfRenders() method" << std::endl;
+    std::cerr << "\tcount: " << profiler->GetNumberOfRenders("1") << " - expected: 1" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkTable> statistics;
+  profiler->GetStatistics(statistics.GetPointer());
+  if (statistics->GetNumberOfColumns() != 9 || statistics->GetNumberOfRows() < 2 //
+      || !statistics->GetColumnByName("DisplayableManager")                     //
+      || !statistics->GetColumnByName("TotalTimeMs")                            //
+      || !statistics->GetColumnByName("SelfTimeMs"))
+  {
+    std::cerr << "Line " << __LINE__ << " - Problem with GetStatistics() method" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::string traceFileName = std::string(testHelper->GetTempDirectory()) + "/vtkMRMLDisplayableManagerProfilerTest1.json";
+  if (!profiler->WriteTrace(traceFileName.c_str()))
+  {
+    std::cerr << "Line " << __LINE__ << " - Problem with WriteTrace() method" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::ifstream traceFile(traceFileName.c_str());
+  std::stringstream traceContent;
+  traceContent << traceFile.rdbuf();
+  if (traceContent.str().find("traceEvents") == std::string::npos //
+      || traceContent.str().find("vtkMRMLTestThreeDViewDisplayableManager") == std::string::npos)
+  {
+    std::cerr << "Line " << __LINE__ << " - Trace file content is invalid: " << traceFileName << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Nested calls are recorded, their time is excluded from the self time of the enclosing call
+  profiler->Reset();
+  profiler->SetEnabled(true);
+  double outerStartTime = profiler->StartCall();
+  double innerStartTime = profiler->StartCall();
+  profiler->EndCall(group, nullptr, vtkMRMLDisplayableManagerProfiler::NodeEventCall, vtkCommand::ModifiedEvent, innerStartTime);
+  innerStartTime = profiler->StartCall();
+  profiler->EndCall(group, nullptr, vtkMRMLDisplayableManagerProfiler::RenderCall, 0, innerStartTime);
+  profiler->EndCall(group, nullptr, vtkMRMLDisplayableManagerProfiler::SceneEventCall, vtkMRMLScene::NodeAddedEvent, outerStartTime);
+  profiler->SetEnabled(false);
+  if (profiler->GetNumberOfTraceEvents() != 3 || profiler->GetNumberOfRenders("1") != 1)
+  {
+    std::cerr << "Line " << __LINE__ << " - Nested calls must be all recorded" << std::endl;
+    std::cerr << "\tnumberOfTraceEvents: " << profiler->GetNumberOfTraceEvents() << " - expected: 3" << std::endl;
+    std::cerr << "\tnumberOfRenders: " << profiler->GetNumberOfRenders("1") << " - expected: 1" << std::endl;
+    return EXIT_FAILURE;
+  }
+  profiler->GetStatistics(statistics.GetPointer());
+  if (statistics->GetNumberOfRows() != 3)
+  {
+    std::cerr << "Line " << __LINE__ << " - All nested calls must appear in the statistics" << std::endl;
+    return EXIT_FAILURE;
+  }
+  double sumOfTotalTimes = 0.0;
+  double sumOfSelfTimes = 0.0;
+  double outerTotalTime = 0.0;
+  for (vtkIdType row = 0; row < statistics->GetNumberOfRows(); ++row)
+  {
+    double totalTime = statistics->GetValueByName(row, "TotalTimeMs").ToDouble();
+    sumOfTotalTimes += totalTime;
+    sumOfSelfTimes += statistics->GetValueByName(row, "SelfTimeMs").ToDouble();
+    if (statistics->GetValueByName(row, "Call").ToString() == "SceneEvent")
+    {
+      outerTotalTime = totalTime;
+    }
+  }
+  // Self times of all calls add up to the time of the outermost call
+  if (std::abs(sumOfSelfTimes - outerTotalTime) > 1e-6 || sumOfTotalTimes < outerTotalTime)
+  {
+    std::cerr << "Line " << __LINE__ << " - Problem with self time of nested calls" << std::endl;
+    std::cerr << "\tsum of self times: " << sumOfSelfTimes << " ms - expected: " << outerTotalTime << " ms" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  profiler->Reset();
+  if (profiler->GetNumberOfRenderRequests() != 0 || profiler->GetNumberOfTraceEvents() != 0)
+  {
+    std::cerr << "Line " << __LINE__ << " - Problem with Reset() method" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (TestNestedDisplayableManagerCalls(scene, group) != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+
+  group->Delete();
+  return EXIT_SUCCESS;
+}
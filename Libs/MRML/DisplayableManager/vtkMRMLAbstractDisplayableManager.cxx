@@ -21,6 +21,7 @@
 // MRMLDisplayableManager includes
 #include "vtkMRMLAbstractDisplayableManager.h"
 #include "vtkMRMLDisplayableManagerGroup.h"
+#include "vtkMRMLDisplayableManagerProfiler.h"
 #include <vtkMRMLLightBoxRendererManagerProxy.h>
 
 // MRMLLogic includes
@@ -481,6 +482,10 @@ vtkMRMLAbstractDisplayableManager::vtkMRMLAbstractDisplayableManager()
   widgetsObserver->AssignOwner(this);
   widgetsObserver->GetCallbackCommand()->SetClientData(this);
   widgetsObserver->GetCallbackCommand()->SetCallback(vtkMRMLAbstractDisplayableManager::WidgetsCallback);
+
+  // Relay scene and node events through callbacks that can measure processing time
+  this->GetMRMLSceneCallbackCommand()->SetCallback(vtkMRMLAbstractDisplayableManager::ProfiledMRMLSceneCallback);
+  this->GetMRMLNodesCallbackCommand()->SetCallback(vtkMRMLAbstractDisplayableManager::ProfiledMRMLNodesCallback);
 }
 
 //----------------------------------------------------------------------------
@@ -680,6 +685,36 @@ void vtkMRMLAbstractDisplayableManager::WidgetsCallback(vtkObject* caller, unsig
   self->ProcessWidgetsEvents(caller, eid, callData);
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLAbstractDisplayableManager::ProfiledMRMLSceneCallback(vtkObject* caller, unsigned long eid, void* clientData, void* callData)
+{
+  vtkMRMLDisplayableManagerProfiler* profiler = vtkMRMLDisplayableManagerProfiler::GetInstance();
+  if (!profiler->GetEnabled())
+  {
+    vtkMRMLAbstractLogic::MRMLSceneCallback(caller, eid, clientData, callData);
+    return;
+  }
+  vtkMRMLAbstractDisplayableManager* self = reinterpret_cast<vtkMRMLAbstractDisplayableManager*>(clientData);
+  double startTime = profiler->StartCall();
+  vtkMRMLAbstractLogic::MRMLSceneCallback(caller, eid, clientData, callData);
+  profiler->EndCall(self->GetMRMLDisplayableManagerGroup(), self, vtkMRMLDisplayableManagerProfiler::SceneEventCall, eid, startTime);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLAbstractDisplayableManager::ProfiledMRMLNodesCallback(vtkObject* caller, unsigned long eid, void* clientData, void* callData)
+{
+  vtkMRMLDisplayableManagerProfiler* profiler = vtkMRMLDisplayableManagerProfiler::GetInstance();
+  if (!profiler->GetEnabled())
+  {
+    vtkMRMLAbstractLogic::MRMLNodesCallback(caller, eid, clientData, callData);
+    return;
+  }
+  vtkMRMLAbstractDisplayableManager* self = reinterpret_cast<vtkMRMLAbstractDisplayableManager*>(clientData);
+  double startTime = profiler->StartCall();
+  vtkMRMLAbstractLogic::MRMLNodesCallback(caller, eid, clientData, callData);
+  profiler->EndCall(self ? self->GetMRMLDisplayableManagerGroup() : nullptr, self, vtkMRMLDisplayableManagerProfiler::NodeEventCall, eid, startTime);
+}
+
 //----------------------------------------------------------------------------
 vtkCallbackCommand* vtkMRMLAbstractDisplayableManager::GetWidgetsCallbackCommand()
 {
@@ -780,7 +815,17 @@ void vtkMRMLAbstractDisplayableManager::RequestRender()
 
   if (this->Internal->UpdateFromMRMLRequested)
   {
-    this->UpdateFromMRML();
+    vtkMRMLDisplayableManagerProfiler* profiler = vtkMRMLDisplayableManagerProfiler::GetInstance();
+    if (profiler->GetEnabled())
+    {
+      double startTime = profiler->StartCall();
+      this->UpdateFromMRML();
+      profiler->EndCall(this->Internal->DisplayableManagerGroup, this, vtkMRMLDisplayableManagerProfiler::UpdateFromMRMLCall, 0, startTime);
+    }
+    else
+    {
+      this->UpdateFromMRML();
+    }
   }
 
   this->InvokeEvent(vtkCommand::UpdateEvent);
@@ -158,6 +158,13 @@ protected:
   /// WidgetsCallback is a static function to relay modified events from the vtk widgets
   static void WidgetsCallback(vtkObject* caller, unsigned long eid, void* clientData, void* callData);
 
+  /// Relay MRML scene and node events to the displayable manager (the same way as
+  /// vtkMRMLAbstractLogic::MRMLSceneCallback and MRMLNodesCallback) and record the
+  /// processing time if profiling is enabled.
+  /// \sa vtkMRMLDisplayableManagerProfiler
+  static void ProfiledMRMLSceneCallback(vtkObject* caller, unsigned long eid, void* clientData, void* callData);
+  static void ProfiledMRMLNodesCallback(vtkObject* caller, unsigned long eid, void* clientData, void* callData);
+
   /// Get vtkWidget callbackCommand
   vtkCallbackCommand* GetWidgetsCallbackCommand();
 
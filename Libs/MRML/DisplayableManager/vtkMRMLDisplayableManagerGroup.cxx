@@ -22,6 +22,7 @@
 #include "vtkMRMLAbstractDisplayableManager.h"
 #include "vtkMRMLDisplayableManagerGroup.h"
 #include "vtkMRMLDisplayableManagerFactory.h"
+#include "vtkMRMLDisplayableManagerProfiler.h"
 #include <vtkMRMLLightBoxRendererManagerProxy.h>
 
 #ifdef MRMLDisplayableManager_USE_PYTHON
@@ -68,6 +69,9 @@ public:
   typedef std::map<std::string, vtkMRMLAbstractDisplayableManager*>::iterator NameToDisplayableManagerMapIt;
 
   vtkSmartPointer<vtkCallbackCommand> CallBackCommand;
+  // Observes renderer start/end events to measure render time when profiling is enabled
+  vtkSmartPointer<vtkCallbackCommand> RenderCallBackCommand;
+  double RenderStartTime;
   vtkMRMLDisplayableManagerFactory* DisplayableManagerFactory;
   vtkMRMLNode* MRMLDisplayableNode;
   vtkRenderer* Renderer;
@@ -83,6 +87,8 @@ vtkMRMLDisplayableManagerGroup::vtkInternal::vtkInternal()
   this->MRMLDisplayableNode = nullptr;
   this->Renderer = nullptr;
   this->CallBackCommand = vtkSmartPointer<vtkCallbackCommand>::New();
+  this->RenderCallBackCommand = vtkSmartPointer<vtkCallbackCommand>::New();
+  this->RenderStartTime = -1.0;
   this->DisplayableManagerFactory = nullptr;
   this->LightBoxRendererManagerProxy = nullptr;
 }
@@ -96,6 +102,8 @@ vtkMRMLDisplayableManagerGroup::vtkMRMLDisplayableManagerGroup()
   this->Internal = new vtkInternal;
   this->Internal->CallBackCommand->SetCallback(Self::DoCallback);
   this->Internal->CallBackCommand->SetClientData(this);
+  this->Internal->RenderCallBackCommand->SetCallback(Self::RenderCallback);
+  this->Internal->RenderCallBackCommand->SetClientData(this);
 }
 
 //----------------------------------------------------------------------------
@@ -111,6 +119,7 @@ vtkMRMLDisplayableManagerGroup::~vtkMRMLDisplayableManagerGroup()
 
   if (this->Internal->Renderer)
   {
+    this->Internal->Renderer->RemoveObserver(this->Internal->RenderCallBackCommand);
     this->Internal->Renderer->UnRegister(this);
   }
 
@@ -304,14 +313,23 @@ void vtkMRMLDisplayableManagerGroup::SetRenderer(vtkRenderer* newRenderer)
 
   if (this->Internal->Renderer)
   {
+    this->Internal->Renderer->RemoveObserver(this->Internal->RenderCallBackCommand);
     this->Internal->Renderer->Delete();
   }
 
   this->Internal->Renderer = newRenderer;
+  if (this->Internal->RenderStartTime >= 0.0)
+  {
+    // Renderer is changed during rendering, end the measured call
+    vtkMRMLDisplayableManagerProfiler::GetInstance()->EndCall(this, nullptr, vtkMRMLDisplayableManagerProfiler::RenderCall, 0, this->Internal->RenderStartTime);
+    this->Internal->RenderStartTime = -1.0;
+  }
 
   if (this->Internal->Renderer)
   {
     this->Internal->Renderer->Register(this);
+    this->Internal->Renderer->AddObserver(vtkCommand::StartEvent, this->Internal->RenderCallBackCommand);
+    this->Internal->Renderer->AddObserver(vtkCommand::EndEvent, this->Internal->RenderCallBackCommand);
   }
 
   vtkDebugMacro(<< this->GetClassName() << " (" << this << "): "
@@ -343,6 +361,11 @@ vtkRenderWindowInteractor* vtkMRMLDisplayableManagerGroup::GetInteractor()
 //----------------------------------------------------------------------------
 void vtkMRMLDisplayableManagerGroup::RequestRender()
 {
+  vtkMRMLDisplayableManagerProfiler* profiler = vtkMRMLDisplayableManagerProfiler::GetInstance();
+  if (profiler->GetEnabled())
+  {
+    profiler->RecordRenderRequest(this);
+  }
   this->InvokeEvent(vtkCommand::UpdateEvent);
 }
 
@@ -411,6 +434,25 @@ void vtkMRMLDisplayableManagerGroup::DoCallback(vtkObject* vtk_obj, unsigned lon
   }
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLDisplayableManagerGroup::RenderCallback(vtkObject* vtkNotUsed(vtk_obj), unsigned long event, void* client_data, void* vtkNotUsed(call_data))
+{
+  vtkMRMLDisplayableManagerGroup* self = reinterpret_cast<vtkMRMLDisplayableManagerGroup*>(client_data);
+  assert(self);
+  vtkMRMLDisplayableManagerProfiler* profiler = vtkMRMLDisplayableManagerProfiler::GetInstance();
+  if (event == vtkCommand::StartEvent && profiler->GetEnabled() && self->Internal->RenderStartTime < 0.0)
+  {
+    self->Internal->RenderStartTime = profiler->StartCall();
+  }
+  else if (event == vtkCommand::EndEvent && self->Internal->RenderStartTime >= 0.0)
+  {
+    // A started call is always ended (even if the profiler has been disabled meanwhile)
+    // to keep track of call nesting.
+    profiler->EndCall(self, nullptr, vtkMRMLDisplayableManagerProfiler::RenderCall, 0, self->Internal->RenderStartTime);
+    self->Internal->RenderStartTime = -1.0;
+  }
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLDisplayableManagerGroup::onDisplayableManagerFactoryRegisteredEvent(const char* displayableManagerName)
 {
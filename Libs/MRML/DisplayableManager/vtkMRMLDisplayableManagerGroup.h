@@ -119,6 +119,9 @@ protected:
 
   typedef vtkMRMLDisplayableManagerGroup Self;
   static void DoCallback(vtkObject* vtk_obj, unsigned long event, void* client_data, void* call_data);
+  /// Called when rendering of the renderer starts or ends, to measure render time
+  /// if vtkMRMLDisplayableManagerProfiler is enabled.
+  static void RenderCallback(vtkObject* vtk_obj, unsigned long event, void* client_data, void* call_data);
   /// Trigger upon a DisplayableManager is either registered or unregistered from
   /// the associated factory
   void onDisplayableManagerFactoryRegisteredEvent(const char* displayableManagerName);
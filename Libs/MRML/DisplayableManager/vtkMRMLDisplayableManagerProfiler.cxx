@@ -0,0 +1,564 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRMLDisplayableManager includes
+#include "vtkMRMLAbstractDisplayableManager.h"
+#include "vtkMRMLDisplayableManagerGroup.h"
+#include "vtkMRMLDisplayableManagerProfiler.h"
+
+// MRML includes
+#include <vtkMRMLAbstractViewNode.h>
+
+// VTK includes
+#include <vtkCommand.h>
+#include <vtkDoubleArray.h>
+#include <vtkIntArray.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkStringArray.h>
+#include <vtkTable.h>
+
+// STD includes
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+struct StatisticsKey
+{
+  int ViewIndex;
+  int DisplayableManagerIndex;
+  int CallType;
+  unsigned long Event;
+  bool operator<(const StatisticsKey& other) const
+  {
+    return std::tie(this->ViewIndex, this->DisplayableManagerIndex, this->CallType, this->Event)
+           < std::tie(other.ViewIndex, other.DisplayableManagerIndex, other.CallType, other.Event);
+  }
+};
+
+//----------------------------------------------------------------------------
+struct CallStatistics
+{
+  int Count{ 0 };
+  double TotalTime{ 0.0 };
+  double TotalSelfTime{ 0.0 };
+  double MaximumTime{ 0.0 };
+};
+
+//----------------------------------------------------------------------------
+/// Call that is being measured (between StartCall and EndCall)
+struct ActiveCall
+{
+  double StartTime;
+  /// Sum of inclusive time of calls nested in this call
+  double NestedTime;
+};
+
+//----------------------------------------------------------------------------
+struct RenderStatistics
+{
+  int NumberOfRenderRequests{ 0 };
+  int NumberOfRenders{ 0 };
+};
+
+//----------------------------------------------------------------------------
+/// Individual call or render request (if CallType is -1) stored for the trace file
+struct TraceEvent
+{
+  int ViewIndex;
+  int DisplayableManagerIndex;
+  int CallType;
+  unsigned long Event;
+  double StartTime;
+  double Duration;
+  double SelfDuration;
+};
+
+//----------------------------------------------------------------------------
+std::string GetEventAsString(unsigned long event)
+{
+  if (event == 0)
+  {
+    return "";
+  }
+  if (event < vtkCommand::UserEvent)
+  {
+    return vtkCommand::GetStringFromEventId(event);
+  }
+  std::stringstream ss;
+  ss << "UserEvent+" << (event - vtkCommand::UserEvent);
+  return ss.str();
+}
+
+//----------------------------------------------------------------------------
+std::string EscapeJSONString(const std::string& str)
+{
+  std::string escaped;
+  escaped.reserve(str.size());
+  for (char c : str)
+  {
+    if (c == '"' || c == '\\')
+    {
+      escaped += '\\';
+      escaped += c;
+    }
+    else if (static_cast<unsigned char>(c) < 0x20)
+    {
+      escaped += ' ';
+    }
+    else
+    {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+class vtkMRMLDisplayableManagerProfiler::vtkInternal
+{
+public:
+  int GetViewIndex(vtkMRMLDisplayableManagerGroup* group);
+  int GetDisplayableManagerIndex(vtkMRMLAbstractDisplayableManager* displayableManager);
+
+  std::vector<std::string> ViewNames;
+  std::vector<std::string> DisplayableManagerNames;
+  std::map<StatisticsKey, CallStatistics> Statistics;
+  std::vector<RenderStatistics> ViewRenderStatistics;
+  std::vector<TraceEvent> TraceEvents;
+  /// Calls that are being measured, the innermost call is the last
+  std::vector<ActiveCall> ActiveCalls;
+  /// Time of the first recorded call, trace event times are relative to this
+  double StartTime{ -1.0 };
+};
+
+//----------------------------------------------------------------------------
+int vtkMRMLDisplayableManagerProfiler::vtkInternal::GetViewIndex(vtkMRMLDisplayableManagerGroup* group)
+{
+  std::string viewName;
+  vtkMRMLAbstractViewNode* viewNode = group ? vtkMRMLAbstractViewNode::SafeDownCast(group->GetMRMLDisplayableNode()) : nullptr;
+  if (viewNode)
+  {
+    viewName = viewNode->GetLayoutName() ? viewNode->GetLayoutName() : (viewNode->GetName() ? viewNode->GetName() : "");
+  }
+  if (viewName.empty())
+  {
+    viewName = "(no view)";
+  }
+  std::vector<std::string>::iterator it = std::find(this->ViewNames.begin(), this->ViewNames.end(), viewName);
+  if (it != this->ViewNames.end())
+  {
+    return static_cast<int>(it - this->ViewNames.begin());
+  }
+  this->ViewNames.push_back(viewName);
+  this->ViewRenderStatistics.emplace_back();
+  return static_cast<int>(this->ViewNames.size()) - 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLDisplayableManagerProfiler::vtkInternal::GetDisplayableManagerIndex(vtkMRMLAbstractDisplayableManager* displayableManager)
+{
+  const char* name = displayableManager ? displayableManager->GetClassName() : "";
+  for (size_t index = 0; index < this->DisplayableManagerNames.size(); ++index)
+  {
+    if (this->DisplayableManagerNames[index] == name)
+    {
+      return static_cast<int>(index);
+    }
+  }
+  this->DisplayableManagerNames.emplace_back(name);
+  return static_cast<int>(this->DisplayableManagerNames.size()) - 1;
+}
+
+//----------------------------------------------------------------------------
+// vtkMRMLDisplayableManagerProfiler methods
+
+//----------------------------------------------------------------------------
+vtkMRMLDisplayableManagerProfiler::vtkMRMLDisplayableManagerProfiler()
+{
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLDisplayableManagerProfiler::~vtkMRMLDisplayableManagerProfiler()
+{
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLDisplayableManagerProfiler::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Enabled: " << (this->Enabled ? "true" : "false") << "\n";
+  os << indent << "MaximumNumberOfTraceEvents: " << this->MaximumNumberOfTraceEvents << "\n";
+  os << indent << "NumberOfTraceEvents: " << this->Internal->TraceEvents.size() << "\n";
+  os << indent << "NumberOfRenderRequests: " << this->GetNumberOfRenderRequests() << "\n";
+  os << indent << "NumberOfRenders: " << this->GetNumberOfRenders() << "\n";
+}
+
+//----------------------------------------------------------------------------
+const char* vtkMRMLDisplayableManagerProfiler::GetCallTypeAsString(int callType)
+{
+  switch (callType)
+  {
+    case SceneEventCall: return "SceneEvent";
+    case NodeEventCall: return "NodeEvent";
+    case UpdateFromMRMLCall: return "UpdateFromMRML";
+    case RenderCall: return "Render";
+    default: return "";
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLDisplayableManagerProfiler::Reset()
+{
+  // Keep calls that are being measured, as their EndCall will still be called
+  std::vector<ActiveCall> activeCalls;
+  activeCalls.swap(this->Internal->ActiveCalls);
+  delete this->Internal;
+  this->Internal = new vtkInternal;
+  this->Internal->ActiveCalls.swap(activeCalls);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLDisplayableManagerProfiler::GetTime()
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLDisplayableManagerProfiler::StartCall()
+{
+  double startTime = vtkMRMLDisplayableManagerProfiler::GetTime();
+  this->Internal->ActiveCalls.push_back({ startTime, 0.0 });
+  return startTime;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLDisplayableManagerProfiler::EndCall(vtkMRMLDisplayableManagerGroup* group,
+                                                vtkMRMLAbstractDisplayableManager* displayableManager,
+                                                int callType,
+                                                unsigned long event,
+                                                double startTime)
+{
+  double endTime = vtkMRMLDisplayableManagerProfiler::GetTime();
+  double duration = endTime - startTime;
+  double nestedTime = 0.0;
+  std::vector<ActiveCall>& activeCalls = this->Internal->ActiveCalls;
+  if (!activeCalls.empty())
+  {
+    nestedTime = activeCalls.back().NestedTime;
+    activeCalls.pop_back();
+  }
+  if (!activeCalls.empty())
+  {
+    // Time of this call is not spent in the enclosing call itself
+    activeCalls.back().NestedTime += duration;
+  }
+  this->RecordCall(group, displayableManager, callType, event, startTime, endTime, std::max(0.0, duration - nestedTime));
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLDisplayableManagerProfiler::RecordCall(vtkMRMLDisplayableManagerGroup* group,
+                                                   vtkMRMLAbstractDisplayableManager* displayableManager,
+                                                   int callType,
+                                                   unsigned long event,
+                                                   double startTime,
+                                                   double endTime,
+                                                   double selfTime)
+{
+  if (!this->Enabled)
+  {
+    return;
+  }
+  if (this->Internal->StartTime < 0)
+  {
+    this->Internal->StartTime = startTime;
+  }
+  StatisticsKey key;
+  key.ViewIndex = this->Internal->GetViewIndex(group);
+  key.DisplayableManagerIndex = this->Internal->GetDisplayableManagerIndex(displayableManager);
+  key.CallType = callType;
+  key.Event = event;
+  double duration = endTime - startTime;
+  if (selfTime < 0.0)
+  {
+    selfTime = duration;
+  }
+  CallStatistics& statistics = this->Internal->Statistics[key];
+  statistics.Count++;
+  statistics.TotalTime += duration;
+  statistics.TotalSelfTime += selfTime;
+  statistics.MaximumTime = std::max(statistics.MaximumTime, duration);
+  if (callType == RenderCall)
+  {
+    this->Internal->ViewRenderStatistics[key.ViewIndex].NumberOfRenders++;
+  }
+
+  if (static_cast<int>(this->Internal->TraceEvents.size()) < this->MaximumNumberOfTraceEvents)
+  {
+    this->Internal->TraceEvents.push_back({ key.ViewIndex, key.DisplayableManagerIndex, callType, event, startTime, duration, selfTime });
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLDisplayableManagerProfiler::RecordRenderRequest(vtkMRMLDisplayableManagerGroup* group)
+{
+  if (!this->Enabled)
+  {
+    return;
+  }
+  double time = vtkMRMLDisplayableManagerProfiler::GetTime();
+  if (this->Internal->StartTime < 0)
+  {
+    this->Internal->StartTime = time;
+  }
+  int viewIndex = this->Internal->GetViewIndex(group);
+  this->Internal->ViewRenderStatistics[viewIndex].NumberOfRenderRequests++;
+  if (static_cast<int>(this->Internal->TraceEvents.size()) < this->MaximumNumberOfTraceEvents)
+  {
+    this->Internal->TraceEvents.push_back({ viewIndex, -1, -1, 0, time, 0.0, 0.0 });
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLDisplayableManagerProfiler::GetStatistics(vtkTable* table)
+{
+  if (!table)
+  {
+    vtkErrorMacro("GetStatistics failed: invalid table");
+    return;
+  }
+  table->Initialize();
+
+  std::vector<std::pair<StatisticsKey, CallStatistics>> sortedStatistics(this->Internal->Statistics.begin(), this->Internal->Statistics.end());
+  std::stable_sort(sortedStatistics.begin(),
+                   sortedStatistics.end(),
+                   [](const std::pair<StatisticsKey, CallStatistics>& a, const std::pair<StatisticsKey, CallStatistics>& b) { return a.second.TotalSelfTime > b.second.TotalSelfTime; });
+
+  vtkNew<vtkStringArray> viewColumn;
+  viewColumn->SetName("View");
+  vtkNew<vtkStringArray> displayableManagerColumn;
+  displayableManagerColumn->SetName("DisplayableManager");
+  vtkNew<vtkStringArray> callColumn;
+  callColumn->SetName("Call");
+  vtkNew<vtkStringArray> eventColumn;
+  eventColumn->SetName("Event");
+  vtkNew<vtkIntArray> countColumn;
+  countColumn->SetName("Count");
+  vtkNew<vtkDoubleArray> totalTimeColumn;
+  totalTimeColumn->SetName("TotalTimeMs");
+  vtkNew<vtkDoubleArray> selfTimeColumn;
+  selfTimeColumn->SetName("SelfTimeMs");
+  vtkNew<vtkDoubleArray> meanTimeColumn;
+  meanTimeColumn->SetName("MeanTimeMs");
+  vtkNew<vtkDoubleArray> maximumTimeColumn;
+  maximumTimeColumn->SetName("MaximumTimeMs");
+
+  for (const auto& keyAndStatistics : sortedStatistics)
+  {
+    const StatisticsKey& key = keyAndStatistics.first;
+    const CallStatistics& statistics = keyAndStatistics.second;
+    viewColumn->InsertNextValue(this->Internal->ViewNames[key.ViewIndex]);
+    displayableManagerColumn->InsertNextValue(this->Internal->DisplayableManagerNames[key.DisplayableManagerIndex]);
+    callColumn->InsertNextValue(vtkMRMLDisplayableManagerProfiler::GetCallTypeAsString(key.CallType));
+    eventColumn->InsertNextValue(GetEventAsString(key.Event));
+    countColumn->InsertNextValue(statistics.Count);
+    totalTimeColumn->InsertNextValue(statistics.TotalTime * 1000.0);
+    selfTimeColumn->InsertNextValue(statistics.TotalSelfTime * 1000.0);
+    meanTimeColumn->InsertNextValue(statistics.TotalTime * 1000.0 / statistics.Count);
+    maximumTimeColumn->InsertNextValue(statistics.MaximumTime * 1000.0);
+  }
+
+  table->AddColumn(viewColumn);
+  table->AddColumn(displayableManagerColumn);
+  table->AddColumn(callColumn);
+  table->AddColumn(eventColumn);
+  table->AddColumn(countColumn);
+  table->AddColumn(totalTimeColumn);
+  table->AddColumn(selfTimeColumn);
+  table->AddColumn(meanTimeColumn);
+  table->AddColumn(maximumTimeColumn);
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLDisplayableManagerProfiler::GetTotalTime(const char* displayableManagerClassName)
+{
+  double totalTime = 0.0;
+  if (!displayableManagerClassName)
+  {
+    return totalTime;
+  }
+  for (const auto& keyAndStatistics : this->Internal->Statistics)
+  {
+    if (this->Internal->DisplayableManagerNames[keyAndStatistics.first.DisplayableManagerIndex] == displayableManagerClassName)
+    {
+      totalTime += keyAndStatistics.second.TotalTime;
+    }
+  }
+  return totalTime;
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLDisplayableManagerProfiler::GetTotalSelfTime(const char* displayableManagerClassName)
+{
+  double totalSelfTime = 0.0;
+  if (!displayableManagerClassName)
+  {
+    return totalSelfTime;
+  }
+  for (const auto& keyAndStatistics : this->Internal->Statistics)
+  {
+    if (this->Internal->DisplayableManagerNames[keyAndStatistics.first.DisplayableManagerIndex] == displayableManagerClassName)
+    {
+      totalSelfTime += keyAndStatistics.second.TotalSelfTime;
+    }
+  }
+  return totalSelfTime;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLDisplayableManagerProfiler::GetNumberOfCalls(const char* displayableManagerClassName, int callType)
+{
+  int numberOfCalls = 0;
+  if (!displayableManagerClassName)
+  {
+    return numberOfCalls;
+  }
+  for (const auto& keyAndStatistics : this->Internal->Statistics)
+  {
+    if (this->Internal->DisplayableManagerNames[keyAndStatistics.first.DisplayableManagerIndex] == displayableManagerClassName //
+        && (callType < 0 || keyAndStatistics.first.CallType == callType))
+    {
+      numberOfCalls += keyAndStatistics.second.Count;
+    }
+  }
+  return numberOfCalls;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLDisplayableManagerProfiler::GetNumberOfRenderRequests(const char* viewName)
+{
+  int numberOfRenderRequests = 0;
+  for (size_t viewIndex = 0; viewIndex < this->Internal->ViewNames.size(); ++viewIndex)
+  {
+    if (!viewName || this->Internal->ViewNames[viewIndex] == viewName)
+    {
+      numberOfRenderRequests += this->Internal->ViewRenderStatistics[viewIndex].NumberOfRenderRequests;
+    }
+  }
+  return numberOfRenderRequests;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLDisplayableManagerProfiler::GetNumberOfRenders(const char* viewName)
+{
+  int numberOfRenders = 0;
+  for (size_t viewIndex = 0; viewIndex < this->Internal->ViewNames.size(); ++viewIndex)
+  {
+    if (!viewName || this->Internal->ViewNames[viewIndex] == viewName)
+    {
+      numberOfRenders += this->Internal->ViewRenderStatistics[viewIndex].NumberOfRenders;
+    }
+  }
+  return numberOfRenders;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLDisplayableManagerProfiler::GetNumberOfTraceEvents()
+{
+  return static_cast<int>(this->Internal->TraceEvents.size());
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLDisplayableManagerProfiler::WriteTrace(const char* fileName)
+{
+  if (!fileName)
+  {
+    vtkErrorMacro("WriteTrace failed: invalid file name");
+    return false;
+  }
+  std::ofstream output(fileName);
+  if (!output.is_open())
+  {
+    vtkErrorMacro("WriteTrace failed: cannot open file " << fileName);
+    return false;
+  }
+
+  // Trace Event Format: times are in microseconds, each view is shown as a thread
+  output << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  output << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"MRML displayable managers\"}}";
+  for (size_t viewIndex = 0; viewIndex < this->Internal->ViewNames.size(); ++viewIndex)
+  {
+    output << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << viewIndex + 1 //
+           << ",\"args\":{\"name\":\"" << EscapeJSONString(this->Internal->ViewNames[viewIndex]) << "\"}}";
+  }
+
+  std::vector<int> numberOfRenderRequests(this->Internal->ViewNames.size(), 0);
+  output.precision(3);
+  output << std::fixed;
+  for (const TraceEvent& traceEvent : this->Internal->TraceEvents)
+  {
+    double timeStampUs = (traceEvent.StartTime - this->Internal->StartTime) * 1.0e6;
+    if (traceEvent.CallType < 0)
+    {
+      // Render request, shown as a counter
+      numberOfRenderRequests[traceEvent.ViewIndex]++;
+      output << ",\n{\"name\":\"RenderRequests " << EscapeJSONString(this->Internal->ViewNames[traceEvent.ViewIndex]) << "\",\"ph\":\"C\",\"pid\":1" //
+             << ",\"ts\":" << timeStampUs << ",\"args\":{\"count\":" << numberOfRenderRequests[traceEvent.ViewIndex] << "}}";
+      continue;
+    }
+    std::string name = this->Internal->DisplayableManagerNames[traceEvent.DisplayableManagerIndex];
+    if (name.empty())
+    {
+      name = vtkMRMLDisplayableManagerProfiler::GetCallTypeAsString(traceEvent.CallType);
+    }
+    output << ",\n{\"name\":\"" << EscapeJSONString(name) << "\",\"cat\":\"" << vtkMRMLDisplayableManagerProfiler::GetCallTypeAsString(traceEvent.CallType) << "\""
+           << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << traceEvent.ViewIndex + 1 //
+           << ",\"ts\":" << timeStampUs << ",\"dur\":" << traceEvent.Duration * 1.0e6;
+    output << ",\"args\":{\"selfMs\":" << traceEvent.SelfDuration * 1.0e3;
+    std::string eventName = GetEventAsString(traceEvent.Event);
+    if (!eventName.empty())
+    {
+      output << ",\"event\":\"" << EscapeJSONString(eventName) << "\"";
+    }
+    output << "}";
+    output << "}";
+  }
+  output << "\n]}\n";
+  output.close();
+  if (output.fail())
+  {
+    vtkErrorMacro("WriteTrace failed: error while writing file " << fileName);
+    return false;
+  }
+  return true;
+}
+
+VTK_SINGLETON_CXX(vtkMRMLDisplayableManagerProfiler);
@@ -0,0 +1,192 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkMRMLDisplayableManagerProfiler_h
+#define __vtkMRMLDisplayableManagerProfiler_h
+
+// VTK includes
+#include <vtkObject.h>
+#include <vtkSingleton.h>
+
+#include "vtkMRMLDisplayableManagerExport.h"
+
+class vtkMRMLAbstractDisplayableManager;
+class vtkMRMLDisplayableManagerGroup;
+class vtkTable;
+
+/// \brief Collects timing of displayable manager calls to find the cause of slow view updates.
+///
+/// When enabled, the wall time of each MRML scene and node event processing call and each
+/// pipeline update (UpdateFromMRML) is recorded for every displayable manager, along with
+/// the number of render requests and actual renders of each view. Render requests that
+/// are received between two renders are merged into one render (coalesced) by the views.
+///
+/// Measured calls may be nested (for example, a displayable manager may modify a node while
+/// it processes a scene event, which triggers node event processing in other displayable managers).
+/// Every call is recorded with its inclusive time (wall time between start and end of the call)
+/// and its exclusive (self) time, which is the inclusive time minus the inclusive time of the
+/// measured calls nested in it. The sum of self times therefore equals the total measured time,
+/// without counting nested calls multiple times.
+///
+/// Statistics (call count, total, self, mean and maximum time) are aggregated per view,
+/// displayable manager class, call type, and event. Individual calls are also stored
+/// (up to MaximumNumberOfTraceEvents) and can be written to a JSON file in the
+/// Trace Event Format, which can be loaded into trace viewers, such as Perfetto
+/// (https://ui.perfetto.dev) or chrome://tracing.
+///
+/// Profiling is disabled by default. When disabled, displayable managers only check
+/// the Enabled flag, therefore the overhead is negligible.
+///
+/// Example usage in Python:
+/// \code{.py}
+/// profiler = slicer.vtkMRMLDisplayableManagerProfiler.GetInstance()
+/// profiler.SetEnabled(True)
+/// # ... interact with the views ...
+/// profiler.SetEnabled(False)
+/// table = vtk.vtkTable()
+/// profiler.GetStatistics(table)
+/// profiler.WriteTrace("/tmp/views.json")
+/// \endcode
+///
+/// \note All calls are expected to come from the main thread.
+class VTK_MRML_DISPLAYABLEMANAGER_EXPORT vtkMRMLDisplayableManagerProfiler : public vtkObject
+{
+public:
+  vtkTypeMacro(vtkMRMLDisplayableManagerProfiler, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// This is a singleton pattern New. There will only be ONE
+  /// reference to a vtkMRMLDisplayableManagerProfiler object per process. Clients that
+  /// call this must call Delete on the object so that the reference counting will work.
+  /// The single instance will be unreferenced when the program exits.
+  static vtkMRMLDisplayableManagerProfiler* New();
+
+  /// Return the singleton instance with no reference counting.
+  static vtkMRMLDisplayableManagerProfiler* GetInstance();
+
+  /// Type of the recorded calls
+  enum
+  {
+    SceneEventCall = 0,
+    NodeEventCall,
+    UpdateFromMRMLCall,
+    RenderCall,
+    CallType_Last // must be last
+  };
+
+  /// Convert call type to string. Returns empty string if the type is unknown.
+  static const char* GetCallTypeAsString(int callType);
+
+  /// Enable recording of timing information. Disabled by default.
+  vtkGetMacro(Enabled, bool);
+  vtkSetMacro(Enabled, bool);
+  vtkBooleanMacro(Enabled, bool);
+
+  /// Maximum number of individual calls stored for WriteTrace.
+  /// Calls beyond this limit are still included in the statistics.
+  /// Default is 1000000.
+  vtkGetMacro(MaximumNumberOfTraceEvents, int);
+  vtkSetMacro(MaximumNumberOfTraceEvents, int);
+
+  /// Remove all recorded statistics and trace events.
+  void Reset();
+
+  /// Get current time in seconds, as used in Record... methods.
+  static double GetTime();
+
+  /// Start measuring a call. Returns the start time, which must be passed to EndCall.
+  /// Measured calls may be nested (for example, a node event may be processed while
+  /// a displayable manager processes a scene event, or a render may be triggered from
+  /// an event handler). Each StartCall must be matched by an EndCall, in reverse order.
+  double StartCall();
+
+  /// Finish measuring a call that was started with StartCall and record it (using RecordCall).
+  /// The self time of the call is its inclusive time minus the time of the calls nested in it.
+  void EndCall(vtkMRMLDisplayableManagerGroup* group, vtkMRMLAbstractDisplayableManager* displayableManager, int callType, unsigned long event, double startTime);
+
+  /// Record a call that started at \a startTime and ended at \a endTime.
+  /// \a displayableManager may be nullptr for calls that are not specific to a displayable manager
+  /// (such as rendering). \a event is the MRML event that was processed (0 if not applicable).
+  /// \a selfTime is the time spent in the call excluding nested measured calls, in seconds.
+  /// If negative then the self time is the same as the inclusive time (endTime - startTime).
+  void RecordCall(vtkMRMLDisplayableManagerGroup* group,
+                  vtkMRMLAbstractDisplayableManager* displayableManager,
+                  int callType,
+                  unsigned long event,
+                  double startTime,
+                  double endTime,
+                  double selfTime = -1.0);
+
+  /// Record a render request in a view.
+  void RecordRenderRequest(vtkMRMLDisplayableManagerGroup* group);
+
+  /// Get aggregated statistics. The table is cleared and the following columns are added:
+  /// View, DisplayableManager, Call, Event, Count, TotalTimeMs, SelfTimeMs, MeanTimeMs, MaximumTimeMs.
+  /// TotalTimeMs includes time of nested calls, SelfTimeMs excludes it.
+  /// Rows are sorted by decreasing self time.
+  void GetStatistics(vtkTable* table);
+
+  /// Get total time spent in calls of the specified displayable manager class (in all views), in seconds.
+  /// Time of nested calls is included.
+  double GetTotalTime(const char* displayableManagerClassName);
+
+  /// Get total self time of calls of the specified displayable manager class (in all views), in seconds.
+  /// Time of nested calls is excluded.
+  double GetTotalSelfTime(const char* displayableManagerClassName);
+
+  /// Get number of calls of the specified displayable manager class (in all views).
+  /// If \a callType is specified then only calls of that type are counted.
+  int GetNumberOfCalls(const char* displayableManagerClassName, int callType = -1);
+
+  /// Get number of render requests and renders in a view.
+  /// The difference is the number of coalesced render requests.
+  /// If \a viewName is nullptr then the numbers for all views are returned.
+  int GetNumberOfRenderRequests(const char* viewName = nullptr);
+  int GetNumberOfRenders(const char* viewName = nullptr);
+
+  /// Get number of stored individual calls.
+  int GetNumberOfTraceEvents();
+
+  /// Write stored calls to a JSON file in Trace Event Format.
+  /// Each view is shown as a separate thread, render request counts are shown as counters.
+  /// Returns false if the file cannot be written.
+  bool WriteTrace(const char* fileName);
+
+protected:
+  vtkMRMLDisplayableManagerProfiler();
+  ~vtkMRMLDisplayableManagerProfiler() override;
+
+  VTK_SINGLETON_DECLARE(vtkMRMLDisplayableManagerProfiler);
+
+  bool Enabled{ false };
+  int MaximumNumberOfTraceEvents{ 1000000 };
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkMRMLDisplayableManagerProfiler(const vtkMRMLDisplayableManagerProfiler&) = delete;
+  void operator=(const vtkMRMLDisplayableManagerProfiler&) = delete;
+};
+
+#ifndef __VTK_WRAP__
+// BTX
+VTK_SINGLETON_DECLARE_INITIALIZER(VTK_MRML_DISPLAYABLEMANAGER_EXPORT, vtkMRMLDisplayableManagerProfiler);
+// ETX
+#endif // __VTK_WRAP__
+
+#endif
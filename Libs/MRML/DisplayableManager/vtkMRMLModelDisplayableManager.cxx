@@ -40,13 +40,11 @@
 #include <vtkCallbackCommand.h>
 #include <vtkCellArray.h>
 #include <vtkClipDataSet.h>
-#include <vtkClipPolyData.h>
 #include <vtkColorTransferFunction.h>
 #include <vtkDataSetAttributes.h>
 #include <vtkDataSetMapper.h>
 #include <vtkExtractCells.h>
 #include <vtkExtractGeometry.h>
-#include <vtkExtractPolyDataGeometry.h>
 #include <vtkGeneralTransform.h>
 #include <vtkImageActor.h>
 #include <vtkImageData.h>
@@ -54,6 +52,7 @@
 #include <vtkImplicitBoolean.h>
 #include <vtkImplicitFunction.h>
 #include <vtkImplicitFunctionCollection.h>
+#include <vtkIncrementalClipPolyData.h>
 #include <vtkLookupTable.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
@@ -1944,31 +1943,20 @@ vtkAlgorithm* vtkMRMLModelDisplayableManager::GetClipper(vtkMRMLDisplayNode* dno
   }
   else
   {
-    if (clippingMethod == vtkMRMLClipNode::Straight)
+    // Plane distances are cached in the filter, so that moving a clipping plane
+    // does not require recomputing the clip function for all points of the model.
+    vtkSmartPointer<vtkIncrementalClipPolyData> clipPolyData = vtkIncrementalClipPolyData::SafeDownCast(clipper);
+    if (!clipPolyData)
     {
-      vtkSmartPointer<vtkClipPolyData> clipPolyData = vtkClipPolyData::SafeDownCast(clipper);
-      if (!clipPolyData)
-      {
-        clipPolyData = vtkSmartPointer<vtkClipPolyData>::New();
-        clipper = clipPolyData;
-      }
-      clipPolyData->SetValue(0.0);
-      clipPolyData->SetClipFunction(clipFunction);
+      clipPolyData = vtkSmartPointer<vtkIncrementalClipPolyData>::New();
+      clipper = clipPolyData;
     }
-    else
+    clipPolyData->SetClipFunction(clipFunction);
+    switch (clippingMethod)
     {
-      vtkSmartPointer<vtkExtractPolyDataGeometry> extractPolyDataGeometry = vtkExtractPolyDataGeometry::SafeDownCast(clipper);
-      if (!extractPolyDataGeometry)
-      {
-        extractPolyDataGeometry = vtkSmartPointer<vtkExtractPolyDataGeometry>::New();
-        clipper = extractPolyDataGeometry;
-      }
-      extractPolyDataGeometry->SetImplicitFunction(clipFunction);
-      extractPolyDataGeometry->ExtractInsideOff();
-      if (clippingMethod == vtkMRMLClipNode::WholeCellsWithBoundary)
-      {
-        extractPolyDataGeometry->ExtractBoundaryCellsOn();
-      }
+      case vtkMRMLClipNode::WholeCells: clipPolyData->SetClippingMethod(vtkIncrementalClipPolyData::WholeCells); break;
+      case vtkMRMLClipNode::WholeCellsWithBoundary: clipPolyData->SetClippingMethod(vtkIncrementalClipPolyData::WholeCellsWithBoundary); break;
+      default: clipPolyData->SetClippingMethod(vtkIncrementalClipPolyData::Straight);
     }
   }
 
@@ -33,6 +33,7 @@
 #include <vtkMRMLSliceLogic.h>
 #include <vtkMRMLSliceNode.h>
 #include <vtkMRMLTransformNode.h>
+#include <vtkExtractPlaneCrossingCells.h>
 
 // VTK includes
 #include <vtkActor2D.h>
@@ -48,6 +49,7 @@
 #include <vtkObjectFactory.h>
 #include <vtkPlane.h>
 #include <vtkPointLocator.h>
+#include <vtkPolyData.h>
 #include <vtkPolyDataMapper2D.h>
 #include <vtkProperty2D.h>
 #include <vtkRenderer.h>
@@ -83,6 +85,7 @@ public:
     vtkSmartPointer<vtkDataSetSurfaceFilter> SurfaceExtractor;
     vtkSmartPointer<vtkTransformFilter> ModelWarper;
     vtkSmartPointer<vtkPlane> Plane;
+    vtkSmartPointer<vtkExtractPlaneCrossingCells> CrossingCellsExtractor;
     vtkSmartPointer<vtkPlaneCutter> Cutter;
     vtkSmartPointer<vtkGeometryFilter> GeometryFilter;
     vtkSmartPointer<vtkSampleImplicitFunctionFilter> SliceDistance;
@@ -300,6 +303,7 @@ void vtkMRMLModelSliceDisplayableManager::vtkInternal::AddDisplayNode(vtkMRMLDis
   // Create pipeline
   Pipeline* pipeline = new Pipeline();
   pipeline->Actor = actor.GetPointer();
+  pipeline->CrossingCellsExtractor = vtkSmartPointer<vtkExtractPlaneCrossingCells>::New();
   pipeline->Cutter = vtkSmartPointer<vtkPlaneCutter>::New();
   pipeline->GeometryFilter = vtkSmartPointer<vtkGeometryFilter>::New();
   pipeline->SliceDistance = vtkSmartPointer<vtkSampleImplicitFunctionFilter>::New();
@@ -313,6 +317,8 @@ void vtkMRMLModelSliceDisplayableManager::vtkInternal::AddDisplayNode(vtkMRMLDis
   // Set up pipeline
   pipeline->Transformer->SetTransform(pipeline->TransformToSlice);
   pipeline->Transformer->SetInputConnection(pipeline->GeometryFilter->GetOutputPort());
+  pipeline->CrossingCellsExtractor->SetPlane(pipeline->Plane);
+  pipeline->CrossingCellsExtractor->SetInputConnection(pipeline->ModelWarper->GetOutputPort());
   pipeline->Cutter->SetPlane(pipeline->Plane);
   pipeline->Cutter->BuildTreeOff(); // the cutter crashes for complex geometries if build tree is enabled
   pipeline->Cutter->SetInputConnection(pipeline->ModelWarper->GetOutputPort());
@@ -463,7 +469,16 @@ void vtkMRMLModelSliceDisplayableManager::vtkInternal::UpdateDisplayNodePipeline
     // show intersection in the slice view
     // include clipper in the pipeline
     pipeline->Transformer->SetInputConnection(pipeline->GeometryFilter->GetOutputPort());
-    pipeline->Cutter->SetInputConnection(pipeline->ModelWarper->GetOutputPort());
+    if (vtkPolyData::SafeDownCast(pointSet))
+    {
+      // Only cut cells that straddle the slice plane. The cell index is kept between updates,
+      // so moving the slice along its normal does not require visiting all the cells of the model.
+      pipeline->Cutter->SetInputConnection(pipeline->CrossingCellsExtractor->GetOutputPort());
+    }
+    else
+    {
+      pipeline->Cutter->SetInputConnection(pipeline->ModelWarper->GetOutputPort());
+    }
 
     // If there is no input or if the input has no points, the vtkTransformPolyDataFilter will display an error message
     // on every update: "No input data".
@@ -0,0 +1,179 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRMLLogic includes
+#include "vtkImageCachedReslice.h"
+#include "vtkImageResliceCache.h"
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkGeneralTransform.h>
+#include <vtkImageData.h>
+#include <vtkImageStencilData.h>
+#include <vtkImageReslice.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkTransform.h>
+#include <vtkUnsignedShortArray.h>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+bool AreImagesEqual(vtkImageData* image1, vtkImageData* image2)
+{
+  int* extent1 = image1->GetExtent();
+  int* extent2 = image2->GetExtent();
+  for (int i = 0; i < 6; ++i)
+  {
+    if (extent1[i] != extent2[i])
+    {
+      return false;
+    }
+  }
+  vtkDataArray* scalars1 = image1->GetPointData()->GetScalars();
+  vtkDataArray* scalars2 = image2->GetPointData()->GetScalars();
+  if (!scalars1 || !scalars2 || scalars1->GetNumberOfValues() != scalars2->GetNumberOfValues())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < scalars1->GetNumberOfValues(); ++i)
+  {
+    if (scalars1->GetVariantValue(i) != scalars2->GetVariantValue(i))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void SetupReslice(vtkImageReslice* reslice, vtkImageData* input, vtkTransform* transform)
+{
+  reslice->SetInputData(input);
+  reslice->SetResliceTransform(transform);
+  reslice->SetOutputOrigin(0, 0, 0);
+  reslice->SetOutputSpacing(1, 1, 1);
+  reslice->SetOutputExtent(0, 39, 0, 29, 0, 0);
+  reslice->SetInterpolationModeToLinear();
+  reslice->GenerateStencilOutputOn();
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkImageResliceCacheTest1(int, char*[])
+{
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(32, 32, 16);
+  image->AllocateScalars(VTK_UNSIGNED_SHORT, 1);
+  vtkUnsignedShortArray* scalars = vtkUnsignedShortArray::SafeDownCast(image->GetPointData()->GetScalars());
+  for (vtkIdType i = 0; i < scalars->GetNumberOfValues(); ++i)
+  {
+    scalars->SetValue(i, static_cast<unsigned short>(i % 1000));
+  }
+
+  vtkNew<vtkTransform> transform;
+  transform->Translate(2.5, 1.5, 7.0);
+  transform->RotateZ(10.0);
+
+  vtkNew<vtkImageResliceCache> cache;
+  EXERCISE_BASIC_OBJECT_METHODS(cache.GetPointer());
+
+  // Two filters (e.g., two linked views) with identical geometry
+  vtkNew<vtkImageCachedReslice> reslice1;
+  vtkNew<vtkImageCachedReslice> reslice2;
+  reslice1->SetResliceCache(cache);
+  reslice2->SetResliceCache(cache);
+  SetupReslice(reslice1, image, transform);
+  SetupReslice(reslice2, image, transform);
+  vtkNew<vtkImageReslice> referenceReslice;
+  SetupReslice(referenceReslice, image, transform);
+
+  referenceReslice->Update();
+  reslice1->Update();
+  CHECK_INT(cache->GetNumberOfMisses(), 1);
+  CHECK_INT(cache->GetNumberOfHits(), 0);
+  CHECK_INT(cache->GetNumberOfEntries(), 1);
+  reslice2->Update();
+  CHECK_INT(cache->GetNumberOfHits(), 1);
+  CHECK_BOOL(AreImagesEqual(reslice1->GetOutput(), referenceReslice->GetOutput()), true);
+  CHECK_BOOL(AreImagesEqual(reslice2->GetOutput(), referenceReslice->GetOutput()), true);
+  CHECK_BOOL(reslice2->GetStencilOutput()->GetNumberOfExtentEntries() > 0, true);
+
+  // Moving the slice and then moving it back finds the first result again
+  transform->Translate(0.0, 0.0, 1.0);
+  reslice1->Update();
+  CHECK_INT(cache->GetNumberOfMisses(), 2);
+  transform->Translate(0.0, 0.0, -1.0);
+  reslice1->Update();
+  CHECK_INT(cache->GetNumberOfHits(), 2);
+  CHECK_BOOL(AreImagesEqual(reslice1->GetOutput(), referenceReslice->GetOutput()), true);
+  CHECK_DOUBLE_TOLERANCE(cache->GetHitRate(), 0.5, 1e-6);
+
+  // Changing a reslice parameter invalidates the result
+  reslice2->SetInterpolationModeToNearestNeighbor();
+  reslice2->Update();
+  CHECK_INT(cache->GetNumberOfHits(), 2);
+  CHECK_INT(cache->GetNumberOfMisses(), 3);
+
+  // Modifying the input image invalidates all its results
+  scalars->SetValue(0, 12345);
+  scalars->Modified();
+  referenceReslice->Update();
+  reslice1->Update();
+  CHECK_INT(cache->GetNumberOfHits(), 2);
+  CHECK_INT(cache->GetNumberOfMisses(), 4);
+  CHECK_INT(cache->GetNumberOfEntries(), 1);
+  CHECK_BOOL(AreImagesEqual(reslice1->GetOutput(), referenceReslice->GetOutput()), true);
+
+  // Least recently used entries are removed when the cache is full
+  cache->ResetStatistics();
+  CHECK_INT(cache->GetNumberOfHits(), 0);
+  CHECK_INT(cache->GetNumberOfMisses(), 0);
+  cache->SetMaximumCacheSizeMB(0.01);
+  for (int i = 0; i < 10; ++i)
+  {
+    transform->Translate(0.0, 0.0, 0.5);
+    reslice1->Update();
+  }
+  CHECK_BOOL(cache->GetCacheSizeMB() <= 0.01, true);
+  CHECK_BOOL(cache->GetNumberOfEntries() < 10, true);
+  CHECK_BOOL(cache->GetNumberOfEvictions() > 0, true);
+
+  // Disable caching
+  cache->SetMaximumCacheSizeMB(0);
+  CHECK_INT(cache->GetNumberOfEntries(), 0);
+  transform->Translate(0.0, 0.0, 0.5);
+  reslice1->Update();
+  CHECK_INT(cache->GetNumberOfEntries(), 0);
+
+  // Non-linear transforms are not cached
+  CHECK_BOOL(vtkImageResliceCache::IsCacheable(reslice1), true);
+  vtkNew<vtkGeneralTransform> generalTransform;
+  generalTransform->Concatenate(transform);
+  reslice1->SetResliceTransform(generalTransform);
+  CHECK_BOOL(vtkImageResliceCache::IsCacheable(reslice1), false);
+
+  cache->RemoveAllEntries();
+  CHECK_INT(cache->GetNumberOfEntries(), 0);
+  CHECK_DOUBLE_TOLERANCE(cache->GetCacheSizeMB(), 0.0, 1e-6);
+
+  return EXIT_SUCCESS;
+}
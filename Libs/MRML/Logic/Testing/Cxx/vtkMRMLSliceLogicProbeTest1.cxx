@@ -0,0 +1,212 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Checks the values probed in all slice layers and measures the latency
+// of probing all layers and magnifying the slice view, per mouse move event.
+
+// MRMLLogic includes
+#include "vtkMRMLSliceLayerLogic.h"
+#include "vtkMRMLSliceLogic.h"
+
+// MRML includes
+#include "vtkMRMLColorTableNode.h"
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLLabelMapVolumeDisplayNode.h"
+#include "vtkMRMLLabelMapVolumeNode.h"
+#include "vtkMRMLScalarVolumeDisplayNode.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLSliceCompositeNode.h"
+#include "vtkMRMLVectorVolumeDisplayNode.h"
+#include "vtkMRMLVectorVolumeNode.h"
+
+// VTK includes
+#include <vtkAlgorithm.h>
+#include <vtkAlgorithmOutput.h>
+#include <vtkDoubleArray.h>
+#include <vtkGeneralTransform.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <cmath>
+
+namespace
+{
+
+const int VOLUME_SIZE = 256;
+const int VIEW_SIZE = 512;
+const int MAGNIFIED_IMAGE_SIZE = 200;
+const int NUMBER_OF_EVENTS = 1000;
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkImageData> CreateImage(int numberOfComponents, int scalarType)
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(VOLUME_SIZE, VOLUME_SIZE, VOLUME_SIZE);
+  image->AllocateScalars(scalarType, numberOfComponents);
+  for (int k = 0; k < VOLUME_SIZE; k++)
+  {
+    for (int j = 0; j < VOLUME_SIZE; j++)
+    {
+      for (int i = 0; i < VOLUME_SIZE; i++)
+      {
+        for (int c = 0; c < numberOfComponents; c++)
+        {
+          double value = (numberOfComponents == 1 && scalarType == VTK_UNSIGNED_CHAR) ? (i / 32) % 3 : (i + 2 * j + 3 * k + 100 * c) % 1000;
+          image->SetScalarComponentFromDouble(i, j, k, c, value);
+        }
+      }
+    }
+  }
+  return image;
+}
+
+//----------------------------------------------------------------------------
+void AddVolume(vtkMRMLScene* scene, vtkMRMLVolumeNode* volumeNode, vtkMRMLVolumeDisplayNode* displayNode, vtkImageData* image, vtkMRMLColorNode* colorNode)
+{
+  scene->AddNode(colorNode);
+  displayNode->SetAndObserveColorNodeID(colorNode->GetID());
+  scene->AddNode(displayNode);
+  volumeNode->SetAndObserveImageData(image);
+  scene->AddNode(volumeNode);
+  volumeNode->SetAndObserveDisplayNodeID(displayNode->GetID());
+}
+
+//----------------------------------------------------------------------------
+int CheckLayerProbe(vtkMRMLSliceLayerLogic* layer, const double xyz[3])
+{
+  int ijk[3] = { 0, 0, 0 };
+  layer->GetProbeIJK(ijk);
+  double ijkFloat[3] = { 0.0, 0.0, 0.0 };
+  layer->GetXYToIJKTransform()->TransformPoint(xyz, ijkFloat);
+  for (int i = 0; i < 3; i++)
+  {
+    CHECK_INT(ijk[i], static_cast<int>(std::nearbyint(ijkFloat[i])));
+  }
+  vtkImageData* image = layer->GetVolumeNode()->GetImageData();
+  int* dimensions = image->GetDimensions();
+  if (ijk[0] < 0 || ijk[1] < 0 || ijk[2] < 0 || ijk[0] >= dimensions[0] || ijk[1] >= dimensions[1] || ijk[2] >= dimensions[2])
+  {
+    CHECK_INT(layer->GetProbeStatus(), vtkMRMLSliceLayerLogic::ProbeOutOfFrame);
+    return EXIT_SUCCESS;
+  }
+  CHECK_INT(layer->GetProbeStatus(), vtkMRMLSliceLayerLogic::ProbeValid);
+  CHECK_INT(layer->GetProbeNumberOfComponents(), image->GetNumberOfScalarComponents());
+  for (int c = 0; c < image->GetNumberOfScalarComponents(); c++)
+  {
+    CHECK_DOUBLE(layer->GetProbeValues()->GetValue(c), image->GetScalarComponentAsDouble(ijk[0], ijk[1], ijk[2], c));
+  }
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLSliceLogicProbeTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLSliceNode::AddDefaultSliceOrientationPresets(scene);
+
+  vtkNew<vtkMRMLSliceLogic> sliceLogic;
+  sliceLogic->SetMRMLScene(scene);
+  sliceLogic->AddSliceNode("Red");
+  sliceLogic->ResizeSliceNode(VIEW_SIZE, VIEW_SIZE);
+  vtkNew<vtkMRMLSliceLayerLogic> backgroundLayer;
+  vtkNew<vtkMRMLSliceLayerLogic> foregroundLayer;
+  vtkNew<vtkMRMLSliceLayerLogic> labelLayer;
+  sliceLogic->SetBackgroundLayer(backgroundLayer);
+  sliceLogic->SetForegroundLayer(foregroundLayer);
+  sliceLogic->SetLabelLayer(labelLayer);
+
+  vtkNew<vtkMRMLColorTableNode> greyColorNode;
+  greyColorNode->SetTypeToGrey();
+  vtkNew<vtkMRMLScalarVolumeNode> scalarVolumeNode;
+  vtkNew<vtkMRMLScalarVolumeDisplayNode> scalarDisplayNode;
+  AddVolume(scene, scalarVolumeNode, scalarDisplayNode, CreateImage(1, VTK_SHORT), greyColorNode);
+
+  vtkNew<vtkMRMLColorTableNode> vectorColorNode;
+  vectorColorNode->SetTypeToGrey();
+  vtkNew<vtkMRMLVectorVolumeNode> vectorVolumeNode;
+  vtkNew<vtkMRMLVectorVolumeDisplayNode> vectorDisplayNode;
+  AddVolume(scene, vectorVolumeNode, vectorDisplayNode, CreateImage(3, VTK_UNSIGNED_CHAR), vectorColorNode);
+
+  vtkNew<vtkMRMLColorTableNode> labelColorNode;
+  labelColorNode->SetTypeToUser();
+  labelColorNode->SetNumberOfColors(3);
+  labelColorNode->SetColor(0, "background", 0.0, 0.0, 0.0, 0.0);
+  labelColorNode->SetColor(1, "tissue", 1.0, 0.0, 0.0);
+  labelColorNode->SetColor(2, "bone", 1.0, 1.0, 1.0);
+  vtkNew<vtkMRMLLabelMapVolumeNode> labelVolumeNode;
+  vtkNew<vtkMRMLLabelMapVolumeDisplayNode> labelDisplayNode;
+  AddVolume(scene, labelVolumeNode, labelDisplayNode, CreateImage(1, VTK_UNSIGNED_CHAR), labelColorNode);
+
+  vtkMRMLSliceCompositeNode* compositeNode = sliceLogic->GetSliceCompositeNode();
+  compositeNode->SetBackgroundVolumeID(scalarVolumeNode->GetID());
+  compositeNode->SetForegroundVolumeID(vectorVolumeNode->GetID());
+  compositeNode->SetLabelVolumeID(labelVolumeNode->GetID());
+  sliceLogic->FitSliceToAll();
+
+  // Probed values
+  vtkNew<vtkImageData> magnifiedImage;
+  const double positions[3][3] = { { VIEW_SIZE / 2.0, VIEW_SIZE / 2.0, 0.0 }, { 10.3, 400.7, 0.0 }, { -50.0, -50.0, 0.0 } };
+  for (const double* xyz : positions)
+  {
+    CHECK_BOOL(sliceLogic->ProbeLayersAtXY(xyz, magnifiedImage, MAGNIFIED_IMAGE_SIZE), true);
+    CHECK_EXIT_SUCCESS(CheckLayerProbe(backgroundLayer, xyz));
+    CHECK_EXIT_SUCCESS(CheckLayerProbe(foregroundLayer, xyz));
+    CHECK_EXIT_SUCCESS(CheckLayerProbe(labelLayer, xyz));
+    if (labelLayer->GetProbeStatus() == vtkMRMLSliceLayerLogic::ProbeValid)
+    {
+      int label = static_cast<int>(labelLayer->GetProbeValues()->GetValue(0));
+      CHECK_STD_STRING(labelLayer->GetProbeLabelName(), labelColorNode->GetColorName(label));
+    }
+    int* dimensions = magnifiedImage->GetDimensions();
+    CHECK_INT(dimensions[0], MAGNIFIED_IMAGE_SIZE);
+    CHECK_INT(dimensions[1], MAGNIFIED_IMAGE_SIZE);
+  }
+
+  // Center of the magnified image is the probed slice view pixel
+  const double center[3] = { VIEW_SIZE / 2.0, VIEW_SIZE / 2.0, 0.0 };
+  sliceLogic->ProbeLayersAtXY(center, magnifiedImage, MAGNIFIED_IMAGE_SIZE);
+  vtkImageData* sliceImage = vtkImageData::SafeDownCast(sliceLogic->GetImageDataConnection()->GetProducer()->GetOutputDataObject(0));
+  for (int c = 0; c < sliceImage->GetNumberOfScalarComponents(); c++)
+  {
+    CHECK_DOUBLE(magnifiedImage->GetScalarComponentAsDouble(MAGNIFIED_IMAGE_SIZE / 2, MAGNIFIED_IMAGE_SIZE / 2, 0, c),
+                 sliceImage->GetScalarComponentAsDouble(VIEW_SIZE / 2, VIEW_SIZE / 2, 0, c));
+  }
+
+  // Latency per mouse move event
+  vtkNew<vtkTimerLog> timer;
+  for (vtkImageData* image : { static_cast<vtkImageData*>(nullptr), magnifiedImage.GetPointer() })
+  {
+    timer->StartTimer();
+    for (int eventIndex = 0; eventIndex < NUMBER_OF_EVENTS; eventIndex++)
+    {
+      const double xyz[3] = { static_cast<double>(eventIndex % VIEW_SIZE), static_cast<double>((eventIndex * 7) % VIEW_SIZE), 0.0 };
+      sliceLogic->ProbeLayersAtXY(xyz, image, MAGNIFIED_IMAGE_SIZE);
+    }
+    timer->StopTimer();
+    std::cout << "Probe 3 layers" << (image ? " and magnify slice view" : "") << ": " //
+              << timer->GetElapsedTime() * 1.0e6 / NUMBER_OF_EVENTS << " us/event" << std::endl;
+  }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,74 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "vtkImageCachedReslice.h"
+#include "vtkImageResliceCache.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkImageStencilData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkImageCachedReslice);
+vtkCxxSetObjectMacro(vtkImageCachedReslice, ResliceCache, vtkImageResliceCache);
+
+//----------------------------------------------------------------------------
+vtkImageCachedReslice::vtkImageCachedReslice() = default;
+
+//----------------------------------------------------------------------------
+vtkImageCachedReslice::~vtkImageCachedReslice()
+{
+  this->SetResliceCache(nullptr);
+}
+
+//----------------------------------------------------------------------------
+void vtkImageCachedReslice::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "ResliceCache: " << this->ResliceCache << "\n";
+}
+
+//----------------------------------------------------------------------------
+int vtkImageCachedReslice::RequestData(vtkInformation* request, vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkImageData* input = vtkImageData::GetData(inputVector[0]);
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  vtkImageData* output = vtkImageData::GetData(outInfo);
+  if (!this->ResliceCache || !input || !output)
+  {
+    return this->Superclass::RequestData(request, inputVector, outputVector);
+  }
+  vtkImageStencilData* stencil = this->GetGenerateStencilOutput() ? vtkImageStencilData::GetData(outputVector, 1) : nullptr;
+
+  int outputExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), outputExtent);
+  if (this->ResliceCache->GetCachedOutput(this, input, outputExtent, output, stencil))
+  {
+    return 1;
+  }
+
+  int result = this->Superclass::RequestData(request, inputVector, outputVector);
+  if (result)
+  {
+    this->ResliceCache->AddOutput(this, input, outputExtent, output, stencil);
+  }
+  return result;
+}
@@ -0,0 +1,58 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkImageCachedReslice_h
+#define __vtkImageCachedReslice_h
+
+// VTK includes
+#include <vtkImageReslice.h>
+
+#include "vtkMRMLLogicExport.h"
+
+class vtkImageResliceCache;
+
+/// \brief vtkImageReslice that reuses previously computed outputs.
+///
+/// If a reslice cache is set then the filter looks up its output in the cache before
+/// reslicing and stores the computed output in the cache.
+/// The cache can be shared between multiple filters.
+/// \sa vtkImageResliceCache
+class VTK_MRML_LOGIC_EXPORT vtkImageCachedReslice : public vtkImageReslice
+{
+public:
+  static vtkImageCachedReslice* New();
+  vtkTypeMacro(vtkImageCachedReslice, vtkImageReslice);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Cache of reslice outputs. If nullptr (default) then output is always computed.
+  vtkGetObjectMacro(ResliceCache, vtkImageResliceCache);
+  virtual void SetResliceCache(vtkImageResliceCache*);
+
+protected:
+  vtkImageCachedReslice();
+  ~vtkImageCachedReslice() override;
+
+  int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
+
+  vtkImageResliceCache* ResliceCache{ nullptr };
+
+private:
+  vtkImageCachedReslice(const vtkImageCachedReslice&) = delete;
+  void operator=(const vtkImageCachedReslice&) = delete;
+};
+
+#endif
@@ -0,0 +1,355 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "vtkImageResliceCache.h"
+
+// VTK includes
+#include <vtkAbstractImageInterpolator.h>
+#include <vtkHomogeneousTransform.h>
+#include <vtkImageData.h>
+#include <vtkImageReslice.h>
+#include <vtkImageStencilData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkObjectFactory.h>
+#include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
+
+// STD includes
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <list>
+#include <vector>
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkImageResliceCache);
+
+//----------------------------------------------------------------------------
+class vtkImageResliceCache::vtkInternal
+{
+public:
+  struct CacheKey
+  {
+    // Weak pointer is used so that a new image that is allocated at the address
+    // of a deleted image is not mistaken for the deleted one.
+    vtkWeakPointer<vtkImageData> Input;
+    vtkMTimeType InputMTime{ 0 };
+    int Extent[6]{ 0, -1, 0, -1, 0, -1 };
+    std::vector<double> Parameters;
+
+    bool operator==(const CacheKey& other) const
+    {
+      return this->Input == other.Input                                   //
+             && this->InputMTime == other.InputMTime                      //
+             && std::equal(this->Extent, this->Extent + 6, other.Extent) //
+             && this->Parameters == other.Parameters;
+    }
+  };
+
+  struct CacheEntry
+  {
+    CacheKey Key;
+    vtkSmartPointer<vtkImageData> Image;
+    vtkSmartPointer<vtkImageStencilData> Stencil;
+    unsigned long SizeKB{ 0 };
+  };
+
+  /// Get all reslice parameters that influence the output.
+  /// Returns false if the output cannot be cached.
+  static bool GetKey(vtkImageReslice* reslice, vtkImageData* input, int outputExtent[6], CacheKey& key);
+
+  /// Remove entries that can never be found again (the input was deleted or modified).
+  void RemoveObsoleteEntries();
+
+  void RemoveEntry(std::list<CacheEntry>::iterator it);
+
+  /// Most recently used entry is at the front.
+  std::list<CacheEntry> Entries;
+  unsigned long CacheSizeKB{ 0 };
+};
+
+//----------------------------------------------------------------------------
+bool vtkImageResliceCache::vtkInternal::GetKey(vtkImageReslice* reslice, vtkImageData* input, int outputExtent[6], CacheKey& key)
+{
+  if (!vtkImageResliceCache::IsCacheable(reslice) || !input)
+  {
+    return false;
+  }
+
+  key.Input = input;
+  key.InputMTime = input->GetMTime();
+  std::copy(outputExtent, outputExtent + 6, key.Extent);
+
+  std::vector<double>& parameters = key.Parameters;
+  parameters.clear();
+  parameters.reserve(64);
+
+  vtkHomogeneousTransform* transform = vtkHomogeneousTransform::SafeDownCast(reslice->GetResliceTransform());
+  vtkMatrix4x4* transformMatrix = transform ? transform->GetMatrix() : nullptr;
+  parameters.push_back(transformMatrix ? 1.0 : 0.0);
+  if (transformMatrix)
+  {
+    parameters.insert(parameters.end(), &transformMatrix->Element[0][0], &transformMatrix->Element[0][0] + 16);
+  }
+  vtkMatrix4x4* axes = reslice->GetResliceAxes();
+  parameters.push_back(axes ? 1.0 : 0.0);
+  if (axes)
+  {
+    parameters.insert(parameters.end(), &axes->Element[0][0], &axes->Element[0][0] + 16);
+  }
+
+  double* outputSpacing = reslice->GetOutputSpacing();
+  parameters.insert(parameters.end(), outputSpacing, outputSpacing + 3);
+  double* outputOrigin = reslice->GetOutputOrigin();
+  parameters.insert(parameters.end(), outputOrigin, outputOrigin + 3);
+  parameters.push_back(reslice->GetOutputDimensionality());
+  parameters.push_back(reslice->GetOutputScalarType());
+  parameters.push_back(reslice->GetScalarShift());
+  parameters.push_back(reslice->GetScalarScale());
+  double* backgroundColor = reslice->GetBackgroundColor();
+  parameters.insert(parameters.end(), backgroundColor, backgroundColor + 4);
+
+  parameters.push_back(reslice->GetInterpolationMode());
+  parameters.push_back(reslice->GetWrap());
+  parameters.push_back(reslice->GetMirror());
+  parameters.push_back(reslice->GetBorder());
+  parameters.push_back(reslice->GetBorderThickness());
+  parameters.push_back(reslice->GetTransformInputSampling());
+  parameters.push_back(reslice->GetAutoCropOutput());
+
+  parameters.push_back(reslice->GetSlabMode());
+  parameters.push_back(reslice->GetSlabNumberOfSlices());
+  parameters.push_back(reslice->GetSlabTrapezoidIntegration());
+  parameters.push_back(reslice->GetSlabSliceSpacingFraction());
+
+  parameters.push_back(reslice->GetGenerateStencilOutput());
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageResliceCache::vtkInternal::RemoveEntry(std::list<CacheEntry>::iterator it)
+{
+  this->CacheSizeKB -= it->SizeKB;
+  this->Entries.erase(it);
+}
+
+//----------------------------------------------------------------------------
+void vtkImageResliceCache::vtkInternal::RemoveObsoleteEntries()
+{
+  for (auto it = this->Entries.begin(); it != this->Entries.end();)
+  {
+    vtkImageData* input = it->Key.Input;
+    if (!input || input->GetMTime() != it->Key.InputMTime)
+    {
+      // modification time can only increase, so this entry would never be used again
+      auto obsoleteIt = it++;
+      this->RemoveEntry(obsoleteIt);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkImageResliceCache::vtkImageResliceCache()
+{
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkImageResliceCache::~vtkImageResliceCache()
+{
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageResliceCache::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "MaximumCacheSizeMB: " << this->MaximumCacheSizeMB << "\n";
+  os << indent << "CacheSizeMB: " << this->GetCacheSizeMB() << "\n";
+  os << indent << "NumberOfEntries: " << this->GetNumberOfEntries() << "\n";
+  os << indent << "NumberOfHits: " << this->NumberOfHits << "\n";
+  os << indent << "NumberOfMisses: " << this->NumberOfMisses << "\n";
+  os << indent << "NumberOfEvictions: " << this->NumberOfEvictions << "\n";
+  os << indent << "HitRate: " << this->GetHitRate() << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkImageResliceCache::SetMaximumCacheSizeMB(double sizeMB)
+{
+  sizeMB = std::max(0.0, sizeMB);
+  if (sizeMB == this->MaximumCacheSizeMB)
+  {
+    return;
+  }
+  this->MaximumCacheSizeMB = sizeMB;
+  this->RemoveLeastRecentlyUsedEntries();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+double vtkImageResliceCache::GetCacheSizeMB()
+{
+  return this->Internal->CacheSizeKB / 1024.0;
+}
+
+//----------------------------------------------------------------------------
+int vtkImageResliceCache::GetNumberOfEntries()
+{
+  return static_cast<int>(this->Internal->Entries.size());
+}
+
+//----------------------------------------------------------------------------
+void vtkImageResliceCache::RemoveAllEntries()
+{
+  this->Internal->Entries.clear();
+  this->Internal->CacheSizeKB = 0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkImageResliceCache::IsCacheable(vtkImageReslice* reslice)
+{
+  if (!reslice)
+  {
+    return false;
+  }
+  // Only linear transforms are compared (non-linear transforms may change without
+  // a cheap way to detect it)
+  if (reslice->GetResliceTransform() && !vtkHomogeneousTransform::SafeDownCast(reslice->GetResliceTransform()))
+  {
+    return false;
+  }
+  // Custom interpolators may have additional parameters that are not part of the key
+  vtkAbstractImageInterpolator* interpolator = reslice->GetInterpolator();
+  if (!interpolator || strcmp(interpolator->GetClassName(), "vtkImageInterpolator") != 0)
+  {
+    return false;
+  }
+  if (reslice->GetStencil() || reslice->GetInformationInput())
+  {
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkImageResliceCache::GetCachedOutput(vtkImageReslice* reslice, vtkImageData* input, int outputExtent[6], vtkImageData* outputImage, vtkImageStencilData* outputStencil)
+{
+  if (this->MaximumCacheSizeMB <= 0 || !outputImage)
+  {
+    return false;
+  }
+  vtkInternal::CacheKey key;
+  if (!vtkInternal::GetKey(reslice, input, outputExtent, key))
+  {
+    return false;
+  }
+  this->Internal->RemoveObsoleteEntries();
+  for (auto it = this->Internal->Entries.begin(); it != this->Internal->Entries.end(); ++it)
+  {
+    if (!(it->Key == key) || (outputStencil && !it->Stencil))
+    {
+      continue;
+    }
+    outputImage->ShallowCopy(it->Image);
+    if (outputStencil)
+    {
+      outputStencil->DeepCopy(it->Stencil);
+    }
+    // move to front (most recently used)
+    this->Internal->Entries.splice(this->Internal->Entries.begin(), this->Internal->Entries, it);
+    this->NumberOfHits++;
+    return true;
+  }
+  this->NumberOfMisses++;
+  return false;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageResliceCache::AddOutput(vtkImageReslice* reslice, vtkImageData* input, int outputExtent[6], vtkImageData* outputImage, vtkImageStencilData* outputStencil)
+{
+  if (this->MaximumCacheSizeMB <= 0 || !outputImage)
+  {
+    return;
+  }
+  vtkInternal::CacheEntry entry;
+  if (!vtkInternal::GetKey(reslice, input, outputExtent, entry.Key))
+  {
+    return;
+  }
+  entry.Image = vtkSmartPointer<vtkImageData>::New();
+  entry.Image->ShallowCopy(outputImage);
+  entry.SizeKB = entry.Image->GetActualMemorySize();
+  if (outputStencil)
+  {
+    entry.Stencil = vtkSmartPointer<vtkImageStencilData>::New();
+    entry.Stencil->DeepCopy(outputStencil);
+    entry.SizeKB += entry.Stencil->GetActualMemorySize();
+  }
+  if (entry.SizeKB > this->MaximumCacheSizeMB * 1024.0)
+  {
+    // would not fit into the cache
+    return;
+  }
+
+  // Remove previous entry with the same key (if any)
+  for (auto it = this->Internal->Entries.begin(); it != this->Internal->Entries.end(); ++it)
+  {
+    if (it->Key == entry.Key)
+    {
+      this->Internal->RemoveEntry(it);
+      break;
+    }
+  }
+
+  this->Internal->CacheSizeKB += entry.SizeKB;
+  this->Internal->Entries.push_front(std::move(entry));
+  this->RemoveLeastRecentlyUsedEntries();
+}
+
+//----------------------------------------------------------------------------
+void vtkImageResliceCache::RemoveLeastRecentlyUsedEntries()
+{
+  const double maximumCacheSizeKB = this->MaximumCacheSizeMB * 1024.0;
+  while (!this->Internal->Entries.empty() && this->Internal->CacheSizeKB > maximumCacheSizeKB)
+  {
+    this->Internal->RemoveEntry(std::prev(this->Internal->Entries.end()));
+    this->NumberOfEvictions++;
+  }
+}
+
+//----------------------------------------------------------------------------
+double vtkImageResliceCache::GetHitRate()
+{
+  vtkIdType numberOfLookups = this->NumberOfHits + this->NumberOfMisses;
+  if (numberOfLookups == 0)
+  {
+    return 0.0;
+  }
+  return static_cast<double>(this->NumberOfHits) / numberOfLookups;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageResliceCache::ResetStatistics()
+{
+  this->NumberOfHits = 0;
+  this->NumberOfMisses = 0;
+  this->NumberOfEvictions = 0;
+}
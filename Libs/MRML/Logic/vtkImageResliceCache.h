@@ -0,0 +1,111 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkImageResliceCache_h
+#define __vtkImageResliceCache_h
+
+// VTK includes
+#include <vtkObject.h>
+
+#include "vtkMRMLLogicExport.h"
+
+class vtkImageData;
+class vtkImageReslice;
+class vtkImageStencilData;
+
+/// \brief Bounded least-recently-used cache of vtkImageReslice outputs.
+///
+/// Entries are keyed by the input image (object and modification time), the reslice
+/// transform and axes, the output extent, spacing and origin, and all parameters that
+/// affect the resliced values (interpolation, slab, border, background, etc.).
+/// Reslicing with a non-linear transform, custom interpolator, stencil or information
+/// input is not cached.
+///
+/// A single cache can be shared between multiple vtkImageCachedReslice filters
+/// (for example all slice layer logics of the application), so that identical reslices in
+/// linked views or repeated frames of a looping sequence are computed only once.
+///
+/// Cached images share the scalar arrays of the filter outputs, therefore the memory
+/// is only duplicated for outputs that are not displayed anymore.
+class VTK_MRML_LOGIC_EXPORT vtkImageResliceCache : public vtkObject
+{
+public:
+  static vtkImageResliceCache* New();
+  vtkTypeMacro(vtkImageResliceCache, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Maximum total memory size of the cached images in MB.
+  /// Least recently used entries are removed when the limit is exceeded.
+  /// Setting it to 0 disables caching. Default is 256.
+  void SetMaximumCacheSizeMB(double sizeMB);
+  vtkGetMacro(MaximumCacheSizeMB, double);
+
+  /// Total memory size of the cached images in MB.
+  double GetCacheSizeMB();
+
+  /// Number of cached reslice outputs.
+  int GetNumberOfEntries();
+
+  /// Remove all cached outputs.
+  void RemoveAllEntries();
+
+  /// Returns true if the output of this reslice filter can be cached.
+  static bool IsCacheable(vtkImageReslice* reslice);
+
+  /// Look up the output of the reslice filter for the given input and output extent.
+  /// If found, then the cached image is shallow-copied into outputImage, the cached stencil
+  /// is copied into outputStencil (if not nullptr), and true is returned.
+  bool GetCachedOutput(vtkImageReslice* reslice, vtkImageData* input, int outputExtent[6], vtkImageData* outputImage, vtkImageStencilData* outputStencil);
+
+  /// Store the output of the reslice filter for the given input and output extent.
+  void AddOutput(vtkImageReslice* reslice, vtkImageData* input, int outputExtent[6], vtkImageData* outputImage, vtkImageStencilData* outputStencil);
+
+  ///@{
+  /// Cache lookup statistics.
+  vtkGetMacro(NumberOfHits, vtkIdType);
+  vtkGetMacro(NumberOfMisses, vtkIdType);
+  vtkGetMacro(NumberOfEvictions, vtkIdType);
+  ///@}
+
+  /// Fraction of lookups that were found in the cache (between 0 and 1).
+  double GetHitRate();
+
+  /// Set all statistics counters to zero.
+  void ResetStatistics();
+
+protected:
+  vtkImageResliceCache();
+  ~vtkImageResliceCache() override;
+
+  /// Remove least recently used entries until the cache size is below the maximum.
+  void RemoveLeastRecentlyUsedEntries();
+
+  double MaximumCacheSizeMB{ 256.0 };
+
+  vtkIdType NumberOfHits{ 0 };
+  vtkIdType NumberOfMisses{ 0 };
+  vtkIdType NumberOfEvictions{ 0 };
+
+private:
+  vtkImageResliceCache(const vtkImageResliceCache&) = delete;
+  void operator=(const vtkImageResliceCache&) = delete;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+};
+
+#endif
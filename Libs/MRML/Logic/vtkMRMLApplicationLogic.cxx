@@ -48,6 +48,7 @@
 #include <vtkCallbackCommand.h>
 #include <vtkCollection.h>
 #include <vtkImageData.h>
+#include <vtkImageResliceCache.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkSmartPointer.h>
@@ -94,6 +95,7 @@ public:
   vtkSmartPointer<vtkMRMLSliceLinkLogic> SliceLinkLogic;
   vtkSmartPointer<vtkMRMLViewLinkLogic> ViewLinkLogic;
   vtkSmartPointer<vtkMRMLColorLogic> ColorLogic;
+  vtkSmartPointer<vtkImageResliceCache> ResliceCache;
   std::string TemporaryPath;
   std::map<std::string, vtkWeakPointer<vtkMRMLAbstractLogic>> ModuleLogicMap;
   std::map<int, std::string> FontFileNames;
@@ -109,6 +111,7 @@ vtkMRMLApplicationLogic::vtkInternal::vtkInternal(vtkMRMLApplicationLogic* exter
   this->SliceLinkLogic = vtkSmartPointer<vtkMRMLSliceLinkLogic>::New();
   this->ViewLinkLogic = vtkSmartPointer<vtkMRMLViewLinkLogic>::New();
   this->ColorLogic = vtkSmartPointer<vtkMRMLColorLogic>::New();
+  this->ResliceCache = vtkSmartPointer<vtkImageResliceCache>::New();
 }
 
 //----------------------------------------------------------------------------
@@ -203,6 +206,12 @@ vtkMRMLColorLogic* vtkMRMLApplicationLogic::GetColorLogic() const
   return this->Internal->ColorLogic;
 }
 
+//----------------------------------------------------------------------------
+vtkImageResliceCache* vtkMRMLApplicationLogic::GetResliceCache() const
+{
+  return this->Internal->ResliceCache;
+}
+
 //----------------------------------------------------------------------------
 vtkCollection* vtkMRMLApplicationLogic::GetSliceLogics() const
 {
@@ -27,6 +27,7 @@
 #include "vtkMRMLLogicExport.h"
 #include "vtkMRMLSliceCompositeNode.h"
 
+class vtkImageResliceCache;
 class vtkMRMLColorLogic;
 class vtkMRMLModelDisplayNode;
 class vtkMRMLSliceNode;
@@ -81,6 +82,11 @@ public:
   void SetColorLogic(vtkMRMLColorLogic* newColorLogic);
   vtkMRMLColorLogic* GetColorLogic() const;
 
+  /// Cache of resliced volume layers that is shared by all the slice logics.
+  /// It allows reusing reslice results during sequence playback and in views that show
+  /// the same slice. Hit rate statistics are available in the cache object.
+  vtkImageResliceCache* GetResliceCache() const;
+
   /// Apply the active volumes in the SelectionNode to the slice composite nodes
   /// Perform the default behavior related to selecting a volume
   /// (in this case, making it the background for all SliceCompositeNodes)
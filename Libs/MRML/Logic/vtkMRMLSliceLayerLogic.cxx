@@ -16,6 +16,7 @@
 #include "vtkMRMLSliceLayerLogic.h"
 
 // MRML includes
+#include "vtkMRMLColorNode.h"
 #include "vtkMRMLLabelMapVolumeNode.h"
 #include "vtkMRMLLabelMapVolumeDisplayNode.h"
 #include "vtkMRMLVectorVolumeDisplayNode.h"
@@ -30,6 +31,7 @@
 #include <vtkAlgorithmOutput.h>
 #include <vtkAssignAttribute.h>
 #include <vtkDiffusionTensorMathematics.h>
+#include <vtkDoubleArray.h>
 #include <vtkFloatArray.h>
 #include <vtkGeneralTransform.h>
 #include <vtkImageData.h>
@@ -46,10 +48,13 @@
 #include <vtkAddonMathUtilities.h>
 
 //
+#include "vtkImageCachedReslice.h"
 #include "vtkImageLabelOutline.h"
+#include "vtkImageResliceCache.h"
 
 // STD includes
 #include <algorithm>
+#include <cmath>
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkMRMLSliceLayerLogic);
@@ -122,8 +127,9 @@ vtkMRMLSliceLayerLogic::vtkMRMLSliceLayerLogic()
   this->AssignAttributeScalarsToTensorsUVW->Assign(vtkDataSetAttributes::SCALARS, vtkDataSetAttributes::TENSORS, vtkAssignAttribute::POINT_DATA);
 
   // Create the parts for the scalar layer pipeline
-  this->Reslice = vtkImageReslice::New();
-  this->ResliceUVW = vtkImageReslice::New();
+  this->Reslice = vtkImageCachedReslice::New();
+  this->ResliceUVW = vtkImageCachedReslice::New();
+  this->ResliceCache = nullptr;
   this->LabelOutline = vtkImageLabelOutline::New();
   this->LabelOutlineUVW = vtkImageLabelOutline::New();
 
@@ -149,6 +155,15 @@ vtkMRMLSliceLayerLogic::vtkMRMLSliceLayerLogic()
   this->UpdatingTransforms = 0;
 
   this->InterpolationMode = VTK_RESLICE_LINEAR;
+
+  this->ProbeStatus = ProbeNoVolume;
+  this->ProbeIJK[0] = 0;
+  this->ProbeIJK[1] = 0;
+  this->ProbeIJK[2] = 0;
+  this->ProbeValues = vtkDoubleArray::New();
+  this->ProbeNumberOfComponents = 0;
+  this->ProbeTensorInvariant = 0.0;
+  this->ProbeTensorInvariantValid = false;
 }
 
 //----------------------------------------------------------------------------
@@ -177,6 +192,7 @@ vtkMRMLSliceLayerLogic::~vtkMRMLSliceLayerLogic()
   this->LabelOutline->SetInputConnection(nullptr);
   this->LabelOutlineUVW->SetInputConnection(nullptr);
 
+  this->SetResliceCache(nullptr);
   this->Reslice->Delete();
   this->ResliceUVW->Delete();
 
@@ -187,6 +203,8 @@ vtkMRMLSliceLayerLogic::~vtkMRMLSliceLayerLogic()
   this->AssignAttributeScalarsToTensors->Delete();
   this->AssignAttributeScalarsToTensorsUVW->Delete();
 
+  this->ProbeValues->Delete();
+
   if (this->VolumeDisplayNode)
   {
     this->VolumeDisplayNode->Delete();
@@ -581,6 +599,27 @@ void vtkMRMLSliceLayerLogic::UpdateTransforms()
   }
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLayerLogic::SetResliceCache(vtkImageResliceCache* resliceCache)
+{
+  if (this->ResliceCache == resliceCache)
+  {
+    return;
+  }
+  // Caching does not change the output, therefore this logic is not modified
+  if (this->ResliceCache)
+  {
+    this->ResliceCache->UnRegister(this);
+  }
+  this->ResliceCache = resliceCache;
+  if (this->ResliceCache)
+  {
+    this->ResliceCache->Register(this);
+  }
+  vtkImageCachedReslice::SafeDownCast(this->Reslice)->SetResliceCache(resliceCache);
+  vtkImageCachedReslice::SafeDownCast(this->ResliceUVW)->SetResliceCache(resliceCache);
+}
+
 //----------------------------------------------------------------------------
 vtkImageData* vtkMRMLSliceLayerLogic::GetImageData()
 {
@@ -997,3 +1036,123 @@ void vtkMRMLSliceLayerLogic::PrintSelf(ostream& os, vtkIndent indent)
     os << indent << " (0)\n";
   }
 }
+
+//----------------------------------------------------------------------------
+int vtkMRMLSliceLayerLogic::ProbeAtXY(const double xyz[3])
+{
+  this->ProbeIJK[0] = 0;
+  this->ProbeIJK[1] = 0;
+  this->ProbeIJK[2] = 0;
+  this->ProbeValues->Reset();
+  this->ProbeNumberOfComponents = 0;
+  this->ProbeLabelName.clear();
+  this->ProbeTensorInvariant = 0.0;
+  this->ProbeTensorInvariantValid = false;
+
+  if (!this->VolumeNode)
+  {
+    this->ProbeStatus = ProbeNoVolume;
+    return this->ProbeStatus;
+  }
+  double ijkFloat[3] = { 0.0, 0.0, 0.0 };
+  this->XYToIJKTransform->TransformPoint(xyz, ijkFloat);
+  for (int i = 0; i < 3; i++)
+  {
+    // round half to even, same as the rounding of voxel positions in Python scripts
+    this->ProbeIJK[i] = std::isfinite(ijkFloat[i]) ? static_cast<int>(std::nearbyint(ijkFloat[i])) : 0;
+  }
+
+  vtkImageData* imageData = this->VolumeNode->GetImageData();
+  if (!imageData || !imageData->GetPointData())
+  {
+    this->ProbeStatus = ProbeNoImage;
+    return this->ProbeStatus;
+  }
+  int* extent = imageData->GetExtent();
+  for (int i = 0; i < 3; i++)
+  {
+    if (this->ProbeIJK[i] < extent[2 * i] || this->ProbeIJK[i] > extent[2 * i + 1])
+    {
+      this->ProbeStatus = ProbeOutOfFrame;
+      return this->ProbeStatus;
+    }
+  }
+  vtkIdType pointId = imageData->ComputePointId(this->ProbeIJK);
+
+  if (vtkMRMLDiffusionTensorVolumeNode::SafeDownCast(this->VolumeNode))
+  {
+    vtkDataArray* tensors = imageData->GetPointData()->GetTensors();
+    if (!tensors)
+    {
+      this->ProbeStatus = ProbeNoTensorData;
+      return this->ProbeStatus;
+    }
+    vtkMRMLDiffusionTensorVolumeDisplayNode* displayNode = vtkMRMLDiffusionTensorVolumeDisplayNode::SafeDownCast(this->VolumeNode->GetDisplayNode());
+    int operation = displayNode ? displayNode->GetScalarInvariant() : vtkDiffusionTensorMathematics::VTK_TENS_FRACTIONAL_ANISOTROPY;
+    if (!vtkDiffusionTensorMathematics::IsColorOperation(operation))
+    {
+      // Compute the invariant of the single probed tensor the same way as vtkDiffusionTensorMathematics
+      // (with default settings) does, without running the filter.
+      double tensorValues[9];
+      tensors->GetTuple(pointId, tensorValues);
+      double tensor[3][3];
+      double m0[3], m1[3], m2[3];
+      double* m[3] = { m0, m1, m2 };
+      for (int row = 0; row < 3; row++)
+      {
+        for (int col = 0; col < 3; col++)
+        {
+          tensor[row][col] = tensorValues[row * 3 + col];
+          m[col][row] = tensor[row][col];
+        }
+      }
+      double w[3] = { 0.0, 0.0, 0.0 };
+      double v0[3] = { 1.0, 0.0, 0.0 };
+      double v1[3] = { 0.0, 1.0, 0.0 };
+      double v2[3] = { 0.0, 0.0, 1.0 };
+      double* v[3] = { v0, v1, v2 };
+      if (vtkDiffusionTensorMathematics::IsEigenvalueOperation(operation))
+      {
+        vtkDiffusionTensorMathematics::TeemEigenSolver(m, w, v);
+        // Shift eigenvalues to make them non-negative (same as FixNegativeEigenvalues in the filter)
+        double minEigenvalue = std::min(w[0], std::min(w[1], w[2]));
+        if (minEigenvalue < 0)
+        {
+          const double shift = -minEigenvalue + 1e-16;
+          w[0] += shift;
+          w[1] += shift;
+          w[2] += shift;
+        }
+      }
+      this->ProbeTensorInvariant = vtkDiffusionTensorMathematics::ScalarOperationValue(operation, tensor, w, v);
+      this->ProbeTensorInvariantValid = true;
+    }
+    this->ProbeStatus = ProbeValid;
+    return this->ProbeStatus;
+  }
+
+  vtkDataArray* scalars = imageData->GetPointData()->GetScalars();
+  if (!scalars)
+  {
+    this->ProbeStatus = ProbeNoImage;
+    return this->ProbeStatus;
+  }
+  this->ProbeNumberOfComponents = scalars->GetNumberOfComponents();
+  if (this->ProbeNumberOfComponents <= 4)
+  {
+    this->ProbeValues->SetNumberOfValues(this->ProbeNumberOfComponents);
+    for (int component = 0; component < this->ProbeNumberOfComponents; component++)
+    {
+      this->ProbeValues->SetValue(component, scalars->GetComponent(pointId, component));
+    }
+  }
+  if (vtkMRMLLabelMapVolumeNode::SafeDownCast(this->VolumeNode))
+  {
+    vtkMRMLDisplayNode* displayNode = this->VolumeNode->GetDisplayNode();
+    vtkMRMLColorNode* colorNode = displayNode ? displayNode->GetColorNode() : nullptr;
+    const char* colorName = colorNode ? colorNode->GetColorName(static_cast<int>(scalars->GetComponent(pointId, 0))) : nullptr;
+    this->ProbeLabelName = colorName ? colorName : "";
+  }
+  this->ProbeStatus = ProbeValid;
+  return this->ProbeStatus;
+}
@@ -48,11 +48,14 @@
 #include <vtkVersion.h>
 
 class vtkAssignAttribute;
+class vtkDoubleArray;
 class vtkImageReslice;
+class vtkImageResliceCache;
 class vtkGeneralTransform;
 
 // STL includes
 // #include <cstdlib>
+#include <string>
 
 class vtkImageLabelOutline;
 class vtkTransform;
@@ -87,6 +90,13 @@ public:
   vtkGetObjectMacro(Reslice, vtkImageReslice);
   vtkGetObjectMacro(ResliceUVW, vtkImageReslice);
 
+  ///
+  /// Cache of reslice outputs, typically shared by all slice layer logics
+  /// (see vtkMRMLApplicationLogic::GetResliceCache()).
+  /// If nullptr (default) then reslicing is always performed.
+  vtkGetObjectMacro(ResliceCache, vtkImageResliceCache);
+  void SetResliceCache(vtkImageResliceCache* resliceCache);
+
   ///
   /// Select if this is a label layer or not (it currently determines if we use
   /// the label outline filter)
@@ -132,6 +142,41 @@ public:
   vtkGetMacro(InterpolationMode, int);
   vtkSetMacro(InterpolationMode, int);
 
+  /// Result of probing the layer volume (see ProbeAtXY)
+  enum
+  {
+    ProbeNoVolume = 0,
+    ProbeNoImage,
+    ProbeOutOfFrame,
+    ProbeNoTensorData,
+    ProbeValid
+  };
+
+  ///
+  /// Sample the layer volume at a slice view XY position, without interpolation.
+  /// The voxel is found by transforming the position with XYToIJKTransform and rounding.
+  /// Voxel component values (of scalar or vector volumes), the color name of the label value
+  /// (of labelmap volumes) and the displayed scalar invariant (of diffusion tensor volumes) are
+  /// computed directly from the volume image data and can be retrieved using GetProbe... methods.
+  /// Returns the probe status (ProbeValid if a voxel value is available).
+  int ProbeAtXY(const double xyz[3]);
+
+  ///@{
+  /// Results of the last ProbeAtXY call.
+  vtkGetMacro(ProbeStatus, int);
+  vtkGetVector3Macro(ProbeIJK, int);
+  /// Voxel component values. Not filled if the volume has more than 4 components.
+  vtkGetObjectMacro(ProbeValues, vtkDoubleArray);
+  /// Total number of scalar components of the probed volume.
+  vtkGetMacro(ProbeNumberOfComponents, int);
+  /// Color name of the label value, empty if the volume is not a labelmap or it has no color node.
+  std::string GetProbeLabelName() { return this->ProbeLabelName; }
+  /// Scalar invariant selected in the diffusion tensor display node (fractional anisotropy by default).
+  vtkGetMacro(ProbeTensorInvariant, double);
+  /// True if ProbeTensorInvariant contains a valid value (false for color invariants).
+  vtkGetMacro(ProbeTensorInvariantValid, bool);
+  ///@}
+
 protected:
   vtkMRMLSliceLayerLogic();
   ~vtkMRMLSliceLayerLogic() override;
@@ -166,6 +211,7 @@ protected:
   /// the VTK class instances that implement this Logic's operations
   vtkImageReslice* Reslice;
   vtkImageReslice* ResliceUVW;
+  vtkImageResliceCache* ResliceCache;
   vtkImageLabelOutline* LabelOutline;
   vtkImageLabelOutline* LabelOutlineUVW;
 
@@ -182,6 +228,14 @@ protected:
   int UpdatingTransforms;
 
   int InterpolationMode;
+
+  int ProbeStatus;
+  int ProbeIJK[3];
+  vtkDoubleArray* ProbeValues;
+  int ProbeNumberOfComponents;
+  std::string ProbeLabelName;
+  double ProbeTensorInvariant;
+  bool ProbeTensorInvariantValid;
 };
 
 #endif
@@ -30,6 +30,7 @@
 #include <vtkMRMLSliceDisplayNode.h>
 
 // VTK includes
+#include <vtkAlgorithm.h>
 #include <vtkAlgorithmOutput.h>
 #include <vtkCallbackCommand.h>
 #include <vtkCollection.h>
@@ -40,11 +41,14 @@
 #include <vtkImageCast.h>
 #include <vtkImageData.h>
 #include <vtkImageMathematics.h>
+#include <vtkImageResliceCache.h>
 #include <vtkImageReslice.h>
 #include <vtkMath.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPlaneSource.h>
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
 #include <vtkSmartPointer.h>
 #include <vtkStringArray.h>
 #include <vtkTransform.h>
@@ -54,6 +58,8 @@
 
 // STD includes
 #include <algorithm>
+#include <cmath>
+#include <vector>
 
 //----------------------------------------------------------------------------
 const int vtkMRMLSliceLogic::SLICE_INDEX_ROTATED = -1;
@@ -610,6 +616,16 @@ void vtkMRMLSliceLogic::ProcessMRMLLogicsEvents()
     layer->IsLabelLayerOn();
     this->SetLabelLayer(layer.GetPointer());
   }
+  // Reslice outputs are shared between all slice views of the application
+  vtkImageResliceCache* resliceCache = appLogic ? appLogic->GetResliceCache() : nullptr;
+  for (LayerListIterator iterator = this->Layers.begin(); iterator != this->Layers.end(); ++iterator)
+  {
+    vtkMRMLSliceLayerLogic* layer = *iterator;
+    if (layer != nullptr)
+    {
+      layer->SetResliceCache(resliceCache);
+    }
+  }
   // Update slice plane geometry
   if (this->SliceNode != nullptr                                                     //
       && this->GetSliceModelNode() != nullptr                                        //
@@ -956,6 +972,83 @@ vtkAlgorithmOutput* vtkMRMLSliceLogic::GetImageDataConnection()
   return this->ImageDataConnection;
 }
 
+//----------------------------------------------------------------------------
+bool vtkMRMLSliceLogic::ProbeLayersAtXY(const double xyz[3], vtkImageData* magnifiedImage, int magnifiedImageSize, double magnification)
+{
+  bool hasVolume = false;
+  for (LayerListIterator iterator = this->Layers.begin(); iterator != this->Layers.end(); ++iterator)
+  {
+    vtkMRMLSliceLayerLogic* layer = *iterator;
+    if (layer && layer->ProbeAtXY(xyz) != vtkMRMLSliceLayerLogic::ProbeNoVolume)
+    {
+      hasVolume = true;
+    }
+  }
+  if (!magnifiedImage || !hasVolume || magnifiedImageSize < 1 || magnification <= 0.0 || !this->ImageDataConnection)
+  {
+    return hasVolume;
+  }
+
+  vtkAlgorithm* producer = this->ImageDataConnection->GetProducer();
+  producer->Update();
+  vtkImageData* sliceImage = vtkImageData::SafeDownCast(producer->GetOutputDataObject(this->ImageDataConnection->GetIndex()));
+  if (!sliceImage || !sliceImage->GetPointData() || !sliceImage->GetPointData()->GetScalars())
+  {
+    magnifiedImage->Initialize();
+    return hasVolume;
+  }
+  int sliceExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  sliceImage->GetExtent(sliceExtent);
+  int* sliceDimensions = sliceImage->GetDimensions();
+  int halfSize = static_cast<int>(std::nearbyint(std::min(sliceDimensions[0], sliceDimensions[1]) / magnification / 2.0));
+  int regionSize = 2 * halfSize + 1;
+  int regionOrigin[2] = { static_cast<int>(std::nearbyint(xyz[0])) - halfSize, static_cast<int>(std::nearbyint(xyz[1])) - halfSize };
+
+  magnifiedImage->SetDimensions(magnifiedImageSize, magnifiedImageSize, 1);
+  magnifiedImage->AllocateScalars(sliceImage->GetScalarType(), sliceImage->GetNumberOfScalarComponents());
+  const vtkIdType pixelSize = sliceImage->GetScalarSize() * sliceImage->GetNumberOfScalarComponents();
+  const vtkIdType sliceRowSize = pixelSize * sliceDimensions[0];
+  const unsigned char* slicePixels = static_cast<unsigned char*>(sliceImage->GetScalarPointer(sliceExtent[0], sliceExtent[2], sliceExtent[4]));
+  unsigned char* magnifiedPixels = static_cast<unsigned char*>(magnifiedImage->GetScalarPointer());
+
+  // Source pixel column of each magnified image column (-1 if outside the slice)
+  std::vector<int> sourceColumns(magnifiedImageSize);
+  for (int u = 0; u < magnifiedImageSize; u++)
+  {
+    int x = regionOrigin[0] + static_cast<int>(static_cast<vtkIdType>(u) * regionSize / magnifiedImageSize);
+    sourceColumns[u] = (x >= sliceExtent[0] && x <= sliceExtent[1]) ? x - sliceExtent[0] : -1;
+  }
+  vtkSMPTools::For(0,
+                   magnifiedImageSize,
+                   [&](vtkIdType beginRow, vtkIdType endRow)
+                   {
+                     for (vtkIdType v = beginRow; v < endRow; v++)
+                     {
+                       unsigned char* magnifiedRow = magnifiedPixels + v * magnifiedImageSize * pixelSize;
+                       int y = regionOrigin[1] + static_cast<int>(v * regionSize / magnifiedImageSize);
+                       if (y < sliceExtent[2] || y > sliceExtent[3])
+                       {
+                         std::fill(magnifiedRow, magnifiedRow + magnifiedImageSize * pixelSize, 0);
+                         continue;
+                       }
+                       const unsigned char* sliceRow = slicePixels + (y - sliceExtent[2]) * sliceRowSize;
+                       for (int u = 0; u < magnifiedImageSize; u++)
+                       {
+                         if (sourceColumns[u] < 0)
+                         {
+                           std::fill(magnifiedRow + u * pixelSize, magnifiedRow + (u + 1) * pixelSize, 0);
+                         }
+                         else
+                         {
+                           std::copy(sliceRow + sourceColumns[u] * pixelSize, sliceRow + (sourceColumns[u] + 1) * pixelSize, magnifiedRow + u * pixelSize);
+                         }
+                       }
+                     }
+                   });
+  magnifiedImage->Modified();
+  return hasVolume;
+}
+
 //----------------------------------------------------------------------------
 bool vtkMRMLSliceLogic::HasInputs()
 {
@@ -37,6 +37,7 @@ class vtkMRMLVolumeNode;
 class vtkAlgorithmOutput;
 class vtkCollection;
 class vtkImageBlend;
+class vtkImageData;
 class vtkImageMathematics;
 class vtkImageReslice;
 
@@ -173,6 +174,16 @@ public:
   /// \sa vtkMRMLSliceLayerLogic::GetImageDataConnectionUVW()
   bool HasUVWInputs();
 
+  /// Probe all layers at a slice view XY position in one call.
+  /// Results are available in each layer logic (see vtkMRMLSliceLayerLogic::ProbeAtXY).
+  /// If magnifiedImage is not nullptr then the neighborhood of the position in the blended slice image
+  /// (output of GetImageDataConnection()) is magnified into it, using nearest neighbor interpolation
+  /// on multiple threads: a square of min(view width, view height) / magnification pixels, centered on
+  /// the position, is scaled to magnifiedImageSize x magnifiedImageSize pixels.
+  /// Pixels outside the slice view are set to 0.
+  /// Returns true if at least one layer has a volume.
+  bool ProbeLayersAtXY(const double xyz[3], vtkImageData* magnifiedImage = nullptr, int magnifiedImageSize = 200, double magnification = 10.0);
+
   /// update the pipeline to reflect the current state of the nodes
   void UpdatePipeline();
 
@@ -0,0 +1,353 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFont>
+#include <QScrollBar>
+#include <QSignalSpy>
+
+// CTK includes
+#include <ctkTest.h>
+
+// qMRML includes
+#include "qMRMLTableModel.h"
+#include "qMRMLTableView.h"
+
+// MRML includes
+#include <vtkMRMLTableNode.h>
+
+// VTK includes
+#include <vtkBitArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkNew.h>
+#include <vtkStringArray.h>
+#include <vtkTable.h>
+#include <vtkUnsignedCharArray.h>
+
+// STD includes
+#include <iostream>
+
+// --------------------------------------------------------------------------
+class qMRMLTableModelTester : public QObject
+{
+  Q_OBJECT
+public:
+  // Large tables are tested in testPerformance if enabled
+  bool Benchmark{ false };
+
+private:
+  vtkMRMLTableNode* TableNode;
+  qMRMLTableModel* TableModel;
+
+private slots:
+  void init();
+  void cleanup();
+
+  void testData();
+  void testHeaders();
+  void testTransposed();
+  void testEditing();
+  void testChangeSignals();
+
+  void testPerformance_data();
+  void testPerformance();
+};
+
+// ----------------------------------------------------------------------------
+void qMRMLTableModelTester::init()
+{
+  // Table with a numeric, string, boolean, and unsigned char column, 5 rows
+  this->TableNode = vtkMRMLTableNode::New();
+  vtkTable* table = this->TableNode->GetTable();
+
+  vtkNew<vtkDoubleArray> doubleColumn;
+  doubleColumn->SetName("Volume");
+  table->AddColumn(doubleColumn);
+  vtkNew<vtkStringArray> stringColumn;
+  stringColumn->SetName("Name");
+  table->AddColumn(stringColumn);
+  vtkNew<vtkBitArray> bitColumn;
+  bitColumn->SetName("Visible");
+  table->AddColumn(bitColumn);
+  vtkNew<vtkUnsignedCharArray> charColumn;
+  charColumn->SetName("Label");
+  table->AddColumn(charColumn);
+
+  table->SetNumberOfRows(5);
+  for (int row = 0; row < 5; ++row)
+  {
+    doubleColumn->SetValue(row, row * 1.5);
+    stringColumn->SetValue(row, QString("Segment_%1").arg(row + 1).toStdString());
+    bitColumn->SetValue(row, row % 2);
+    charColumn->SetValue(row, static_cast<unsigned char>(row + 65));
+  }
+  this->TableNode->SetColumnTitle("Volume", "Segment volume");
+  this->TableNode->SetColumnUnitLabel("Volume", "mm3");
+  this->TableNode->SetUseColumnTitleAsColumnHeader(false);
+  this->TableNode->SetUseFirstColumnAsRowHeader(false);
+
+  this->TableModel = new qMRMLTableModel();
+  this->TableModel->setMRMLTableNode(this->TableNode);
+}
+
+// ----------------------------------------------------------------------------
+void qMRMLTableModelTester::cleanup()
+{
+  delete this->TableModel;
+  this->TableModel = nullptr;
+  this->TableNode->Delete();
+  this->TableNode = nullptr;
+}
+
+// ----------------------------------------------------------------------------
+void qMRMLTableModelTester::testData()
+{
+  // First row shows column names
+  QCOMPARE(this->TableModel->rowCount(), 6);
+  QCOMPARE(this->TableModel->columnCount(), 4);
+  QCOMPARE(this->TableModel->data(this->TableModel->index(0, 0)).toString(), QString("Volume"));
+  QVERIFY(this->TableModel->data(this->TableModel->index(0, 0), Qt::FontRole).value<QFont>().bold());
+
+  QCOMPARE(this->TableModel->data(this->TableModel->index(3, 0)).toString(), QString("3"));
+  QCOMPARE(this->TableModel->data(this->TableModel->index(3, 1)).toString(), QString("Segment_3"));
+  QCOMPARE(this->TableModel->data(this->TableModel->index(3, 3)).toString(), QString("67"));
+
+  // Boolean values are shown as checkboxes, without text
+  QCOMPARE(this->TableModel->data(this->TableModel->index(2, 2)).toString(), QString());
+  QCOMPARE(this->TableModel->data(this->TableModel->index(2, 2), Qt::CheckStateRole).toInt(), static_cast<int>(Qt::Checked));
+  QCOMPARE(this->TableModel->data(this->TableModel->index(3, 2), Qt::CheckStateRole).toInt(), static_cast<int>(Qt::Unchecked));
+  QVERIFY(this->TableModel->flags(this->TableModel->index(3, 2)) & Qt::ItemIsUserCheckable);
+  QVERIFY(!(this->TableModel->flags(this->TableModel->index(3, 2)) & Qt::ItemIsEditable));
+
+  QVERIFY(this->TableModel->data(this->TableModel->index(3, 0), Qt::ToolTipRole).toString().contains("Segment volume"));
+
+  // Out of range
+  QVERIFY(!this->TableModel->data(this->TableModel->index(6, 0)).isValid());
+
+  this->TableModel->setMRMLTableNode(nullptr);
+  QCOMPARE(this->TableModel->rowCount(), 0);
+  QCOMPARE(this->TableModel->columnCount(), 0);
+}
+
+// ----------------------------------------------------------------------------
+void qMRMLTableModelTester::testHeaders()
+{
+  QCOMPARE(this->TableModel->headerData(1, Qt::Horizontal).toString(), QString("B"));
+  QCOMPARE(this->TableModel->headerData(1, Qt::Vertical).toString(), QString("2"));
+
+  this->TableNode->SetUseColumnTitleAsColumnHeader(true);
+  QCOMPARE(this->TableModel->rowCount(), 5);
+  QCOMPARE(this->TableModel->headerData(0, Qt::Horizontal).toString(), QString("Segment volume [mm3]"));
+  QCOMPARE(this->TableModel->headerData(1, Qt::Horizontal).toString(), QString("Name"));
+  QCOMPARE(this->TableModel->data(this->TableModel->index(0, 0)).toString(), QString("0"));
+
+  this->TableNode->SetUseFirstColumnAsRowHeader(true);
+  QCOMPARE(this->TableModel->columnCount(), 3);
+  QCOMPARE(this->TableModel->headerData(0, Qt::Horizontal).toString(), QString("Name"));
+  QCOMPARE(this->TableModel->headerData(2, Qt::Vertical).toString(), QString("3"));
+  QCOMPARE(this->TableModel->data(this->TableModel->index(2, 0)).toString(), QString("Segment_3"));
+  QCOMPARE(this->TableModel->mrmlTableColumnIndex(this->TableModel->index(2, 0)), 1);
+  QCOMPARE(this->TableModel->mrmlTableRowIndex(this->TableModel->index(2, 0)), 2);
+}
+
+// ----------------------------------------------------------------------------
+void qMRMLTableModelTester::testTransposed()
+{
+  QSignalSpy resetSpy(this->TableModel, SIGNAL(modelReset()));
+  this->TableModel->setTransposed(true);
+  QCOMPARE(resetSpy.count(), 1);
+  QCOMPARE(this->TableModel->rowCount(), 4);
+  QCOMPARE(this->TableModel->columnCount(), 6);
+  QCOMPARE(this->TableModel->data(this->TableModel->index(1, 0)).toString(), QString("Name"));
+  QCOMPARE(this->TableModel->data(this->TableModel->index(1, 3)).toString(), QString("Segment_3"));
+  QCOMPARE(this->TableModel->headerData(1, Qt::Vertical).toString(), QString("B"));
+  QCOMPARE(this->TableModel->mrmlTableColumnIndex(this->TableModel->index(1, 3)), 1);
+  QCOMPARE(this->TableModel->mrmlTableRowIndex(this->TableModel->index(1, 3)), 2);
+
+  QVERIFY(this->TableModel->setData(this->TableModel->index(1, 3), "Liver"));
+  QCOMPARE(this->TableNode->GetCellText(2, 1), std::string("Liver"));
+}
+
+// ----------------------------------------------------------------------------
+void qMRMLTableModelTester::testEditing()
+{
+  vtkTable* table = this->TableNode->GetTable();
+
+  QVERIFY(this->TableModel->setData(this->TableModel->index(1, 0), "12.5"));
+  QCOMPARE(table->GetValue(0, 0).ToDouble(), 12.5);
+  QCOMPARE(this->TableModel->data(this->TableModel->index(1, 0)).toString(), QString("12.5"));
+
+  // Invalid values are rejected
+  QVERIFY(!this->TableModel->setData(this->TableModel->index(1, 0), "abc"));
+  QCOMPARE(table->GetValue(0, 0).ToDouble(), 12.5);
+  QVERIFY(!this->TableModel->setData(this->TableModel->index(1, 3), "300"));
+  QCOMPARE(table->GetValue(0, 3).ToInt(), 65);
+  QVERIFY(this->TableModel->setData(this->TableModel->index(1, 3), "200"));
+  QCOMPARE(table->GetValue(0, 3).ToInt(), 200);
+
+  QVERIFY(this->TableModel->setData(this->TableModel->index(1, 2), static_cast<int>(Qt::Checked), Qt::CheckStateRole));
+  QCOMPARE(table->GetValue(0, 2).ToInt(), 1);
+
+  // Rename column
+  QVERIFY(this->TableModel->setData(this->TableModel->index(0, 1), "Segment"));
+  QCOMPARE(std::string(table->GetColumnName(1)), std::string("Segment"));
+  QCOMPARE(this->TableModel->data(this->TableModel->index(0, 1)).toString(), QString("Segment"));
+
+  // Locked table cannot be edited
+  this->TableNode->SetLocked(true);
+  QVERIFY(!(this->TableModel->flags(this->TableModel->index(1, 0)) & Qt::ItemIsEditable));
+  QVERIFY(!this->TableModel->setData(this->TableModel->index(1, 0), "1"));
+  QCOMPARE(table->GetValue(0, 0).ToDouble(), 12.5);
+}
+
+// ----------------------------------------------------------------------------
+void qMRMLTableModelTester::testChangeSignals()
+{
+  vtkTable* table = this->TableNode->GetTable();
+  qRegisterMetaType<QVector<int>>();
+  QSignalSpy dataChangedSpy(this->TableModel, SIGNAL(dataChanged(QModelIndex, QModelIndex, QVector<int>)));
+  QSignalSpy resetSpy(this->TableModel, SIGNAL(modelReset()));
+  QSignalSpy rowsInsertedSpy(this->TableModel, SIGNAL(rowsInserted(QModelIndex, int, int)));
+
+  // Editing a cell only updates that cell
+  QModelIndex editedIndex = this->TableModel->index(2, 1);
+  QVERIFY(this->TableModel->setData(editedIndex, "Liver"));
+  QCOMPARE(dataChangedSpy.count(), 1);
+  QCOMPARE(dataChangedSpy.at(0).at(0).value<QModelIndex>(), editedIndex);
+  QCOMPARE(dataChangedSpy.at(0).at(1).value<QModelIndex>(), editedIndex);
+
+  // Modifying a column only updates that column
+  dataChangedSpy.clear();
+  vtkDoubleArray* doubleColumn = vtkDoubleArray::SafeDownCast(table->GetColumn(0));
+  doubleColumn->SetValue(3, 100.0);
+  doubleColumn->Modified();
+  table->Modified();
+  QCOMPARE(dataChangedSpy.count(), 1);
+  QCOMPARE(dataChangedSpy.at(0).at(0).value<QModelIndex>(), this->TableModel->index(0, 0));
+  QCOMPARE(dataChangedSpy.at(0).at(1).value<QModelIndex>(), this->TableModel->index(5, 0));
+  QCOMPARE(this->TableModel->data(this->TableModel->index(4, 0)).toString(), QString("100"));
+
+  // Modifying the table without modifying a column updates all cells
+  dataChangedSpy.clear();
+  doubleColumn->SetValue(4, 200.0);
+  table->Modified();
+  QCOMPARE(dataChangedSpy.count(), 1);
+  QCOMPARE(dataChangedSpy.at(0).at(1).value<QModelIndex>(), this->TableModel->index(5, 3));
+
+  // Adding a row inserts a model row
+  this->TableNode->AddEmptyRow();
+  QCOMPARE(rowsInsertedSpy.count(), 1);
+  QCOMPARE(rowsInsertedSpy.at(0).at(1).toInt(), 6);
+  QCOMPARE(this->TableModel->rowCount(), 7);
+  QCOMPARE(resetSpy.count(), 0);
+}
+
+// ----------------------------------------------------------------------------
+void qMRMLTableModelTester::testPerformance_data()
+{
+  QTest::addColumn<int>("numberOfRows");
+  QTest::addColumn<int>("numberOfColumns");
+  QTest::addColumn<bool>("transposed");
+
+  QTest::newRow("10k cells") << 1000 << 10 << false;
+  QTest::newRow("10k cells transposed") << 1000 << 10 << true;
+
+  // Large tables are only tested if requested by the "--benchmark" argument, as they take long to run
+  if (!this->Benchmark)
+  {
+    return;
+  }
+  QTest::newRow("100k cells") << 10000 << 10 << false;
+  QTest::newRow("1M cells") << 100000 << 10 << false;
+  QTest::newRow("10M cells") << 1000000 << 10 << false;
+  QTest::newRow("1M cells transposed") << 100000 << 10 << true;
+}
+
+// ----------------------------------------------------------------------------
+void qMRMLTableModelTester::testPerformance()
+{
+  QFETCH(int, numberOfRows);
+  QFETCH(int, numberOfColumns);
+  QFETCH(bool, transposed);
+
+  vtkNew<vtkMRMLTableNode> tableNode;
+  vtkTable* table = tableNode->GetTable();
+  for (int col = 0; col < numberOfColumns; ++col)
+  {
+    vtkNew<vtkDoubleArray> column;
+    column->SetName(QString("Feature_%1").arg(col).toStdString().c_str());
+    column->SetNumberOfValues(numberOfRows);
+    for (int row = 0; row < numberOfRows; ++row)
+    {
+      column->SetValue(row, row + col * 0.001);
+    }
+    table->AddColumn(column);
+  }
+
+  qMRMLTableView tableView;
+  tableView.resize(800, 600);
+  tableView.tableModel()->setTransposed(transposed);
+  tableView.show();
+
+  QElapsedTimer timer;
+  timer.start();
+  tableView.setMRMLTableNode(tableNode.GetPointer());
+  QCoreApplication::processEvents();
+  qint64 openTimeMs = timer.elapsed();
+
+  // Scroll through the table in 100 steps, repainting the view in each step
+  QScrollBar* scrollBar = transposed ? tableView.horizontalScrollBar() : tableView.verticalScrollBar();
+  timer.restart();
+  const int numberOfScrollSteps = 100;
+  for (int step = 0; step <= numberOfScrollSteps; ++step)
+  {
+    scrollBar->setValue(scrollBar->minimum() + (scrollBar->maximum() - scrollBar->minimum()) * step / numberOfScrollSteps);
+    tableView.viewport()->repaint();
+  }
+  qint64 scrollTimeMs = timer.elapsed();
+
+  // Modify a single value, as it is done by modules that update a table
+  timer.restart();
+  vtkDoubleArray::SafeDownCast(table->GetColumn(0))->SetValue(numberOfRows - 1, -1.0);
+  table->GetColumn(0)->Modified();
+  table->Modified();
+  tableView.viewport()->repaint();
+  qint64 updateTimeMs = timer.elapsed();
+
+  qMRMLTableModel* tableModel = tableView.tableModel();
+  QModelIndex lastValueIndex = transposed ? tableModel->index(0, numberOfRows) : tableModel->index(numberOfRows, 0);
+  QCOMPARE(tableModel->data(lastValueIndex).toString(), QString("-1"));
+
+  std::cout << numberOfRows * numberOfColumns << " cells" << (transposed ? " (transposed)" : "") << ":" << std::endl;
+  std::cout << "  Open: " << openTimeMs << " ms" << std::endl;
+  std::cout << "  Scroll " << numberOfScrollSteps << " pages: " << scrollTimeMs << " ms" << std::endl;
+  std::cout << "  Update: " << updateTimeMs << " ms" << std::endl;
+}
+
+// ----------------------------------------------------------------------------
+int qMRMLTableModelTest(int argc, char* argv[])
+{
+  QApplication app(argc, argv);
+  qMRMLTableModelTester tc;
+  // "--benchmark" is not a QTest argument, remove it before running the tests
+  QStringList arguments = app.arguments();
+  tc.Benchmark = (arguments.removeAll("--benchmark") > 0);
+  return QTest::qExec(&tc, arguments);
+}
+#include "moc_qMRMLTableModelTest.cxx"
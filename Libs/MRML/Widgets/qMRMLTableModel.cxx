@@ -22,6 +22,7 @@
 
 // Qt includes
 #include <QApplication>
+#include <QFont>
 #include <QPalette>
 
 // qMRML includes
@@ -38,6 +39,10 @@
 #include <vtkStringArray.h>
 #include <vtkTable.h>
 
+// STD includes
+#include <algorithm>
+#include <vector>
+
 static int UserRoleValueType = Qt::UserRole + 1;
 
 //------------------------------------------------------------------------------
@@ -55,15 +60,62 @@ public:
   virtual ~qMRMLTableModelPrivate();
   void init();
 
+  // Returns the table of the MRML table node (nullptr if not available)
+  vtkTable* table() const;
+
   // Returns Excel-style column names from index (A, B, C, ..., Z, AA, AB, AC, ..., AZ, AAA, AAB, ...)
   static QString columnNameFromIndex(int index);
 
   // Generate tooltip text
-  QString columnTooltipText(int tableCol);
+  QString columnTooltipText(int tableCol) const;
+
+  // Get text displayed in a table cell
+  static QString cellText(vtkTable* table, int tableRow, int tableCol);
+
+  // Get MRML table cell from model index. Returns false if the index does not correspond to a valid cell.
+  // tableRow is -1 for the first model row that shows the column names.
+  bool tableCellFromModelIndex(const QModelIndex& index, int& tableRow, int& tableCol) const;
+
+  // Update cached column properties and get the new model size.
+  // columnModified is set to true for each table column that has been modified since the last update.
+  void updateTableProperties(int& rowCount, int& columnCount, std::vector<bool>& columnModified);
+
+  // Emit dataChanged and headerDataChanged signals for a range of table columns (specified by model indices)
+  void emitTableColumnsChanged(int firstModelTableCol, int lastModelTableCol);
+
+  // Cached properties of a table column
+  struct ColumnProperties
+  {
+    QString Name;
+    QString HeaderText;
+    // Array is only used for detecting changes, it may have been deleted already
+    vtkAbstractArray* Array{ nullptr };
+    vtkMTimeType ArrayMTime{ 0 };
+
+    bool operator==(const ColumnProperties& other) const
+    {
+      return this->Name == other.Name && this->HeaderText == other.HeaderText //
+             && this->Array == other.Array && this->ArrayMTime == other.ArrayMTime;
+    }
+  };
 
   vtkSmartPointer<vtkCallbackCommand> CallBack;
   vtkSmartPointer<vtkMRMLTableNode> MRMLTableNode;
   bool Transposed;
+
+  // Model size
+  int RowCount;
+  int ColumnCount;
+
+  // offset: modelIndex = mrmlIndex - offset
+  int TableColOffset;
+  int TableRowOffset;
+
+  // Properties of each table column, indexed by table column index
+  std::vector<ColumnProperties> Columns;
+
+  // Set while the model modifies the table, to prevent updating the entire model
+  bool IsUpdatingMRML;
 };
 
 //------------------------------------------------------------------------------
@@ -72,6 +124,11 @@ qMRMLTableModelPrivate::qMRMLTableModelPrivate(qMRMLTableModel& object)
 {
   this->CallBack = vtkSmartPointer<vtkCallbackCommand>::New();
   this->Transposed = false;
+  this->RowCount = 0;
+  this->ColumnCount = 0;
+  this->TableColOffset = 0;
+  this->TableRowOffset = 0;
+  this->IsUpdatingMRML = false;
 }
 
 //------------------------------------------------------------------------------
@@ -89,8 +146,12 @@ void qMRMLTableModelPrivate::init()
   Q_Q(qMRMLTableModel);
   this->CallBack->SetClientData(q);
   this->CallBack->SetCallback(qMRMLTableModel::onMRMLNodeEvent);
-  q->setColumnCount(0);
-  QObject::connect(q, SIGNAL(itemChanged(QStandardItem*)), q, SLOT(onItemChanged(QStandardItem*)), Qt::UniqueConnection);
+}
+
+//------------------------------------------------------------------------------
+vtkTable* qMRMLTableModelPrivate::table() const
+{
+  return this->MRMLTableNode ? this->MRMLTableNode->GetTable() : nullptr;
 }
 
 //------------------------------------------------------------------------------
@@ -107,9 +168,9 @@ QString qMRMLTableModelPrivate::columnNameFromIndex(int index)
 }
 
 //------------------------------------------------------------------------------
-QString qMRMLTableModelPrivate::columnTooltipText(int tableCol)
+QString qMRMLTableModelPrivate::columnTooltipText(int tableCol) const
 {
-  Q_Q(qMRMLTableModel);
+  Q_Q(const qMRMLTableModel);
   vtkMRMLTableNode* tableNode = q->mrmlTableNode();
   if (tableNode == nullptr)
   {
@@ -176,11 +237,124 @@ QString qMRMLTableModelPrivate::columnTooltipText(int tableCol)
   return textLines.join("<p>");
 }
 
+//------------------------------------------------------------------------------
+QString qMRMLTableModelPrivate::cellText(vtkTable* table, int tableRow, int tableCol)
+{
+  vtkVariant variant = table->GetValue(tableRow, tableCol);
+  int dataType = table->GetColumn(tableCol)->GetDataType();
+  if (dataType == VTK_CHAR || dataType == VTK_UNSIGNED_CHAR || dataType == VTK_SIGNED_CHAR)
+  {
+    // vtkVariant converts char type to string as a single letter, therefore we need to use
+    // custom converter
+    return QString::number(variant.ToInt());
+  }
+  return QString(variant.ToString().c_str());
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLTableModelPrivate::tableCellFromModelIndex(const QModelIndex& index, int& tableRow, int& tableCol) const
+{
+  vtkTable* table = this->table();
+  if (table == nullptr || !index.isValid() || index.row() >= this->RowCount || index.column() >= this->ColumnCount)
+  {
+    return false;
+  }
+  tableRow = (this->Transposed ? index.column() : index.row()) + this->TableRowOffset;
+  tableCol = (this->Transposed ? index.row() : index.column()) + this->TableColOffset;
+  // The table may have been changed since the last model update (e.g., between StartModify/EndModify)
+  return tableCol < table->GetNumberOfColumns() && tableRow < table->GetNumberOfRows() && table->GetColumn(tableCol) != nullptr;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLTableModelPrivate::updateTableProperties(int& rowCount, int& columnCount, std::vector<bool>& columnModified)
+{
+  rowCount = 0;
+  columnCount = 0;
+  int tableColOffset = 0;
+  int tableRowOffset = 0;
+  std::vector<ColumnProperties> columns;
+
+  vtkTable* table = this->table();
+  if (table != nullptr && table->GetNumberOfColumns() > 0)
+  {
+    bool useColumnTitleAsColumnHeader = this->MRMLTableNode->GetUseColumnTitleAsColumnHeader();
+    tableColOffset = this->MRMLTableNode->GetUseFirstColumnAsRowHeader() ? 1 : 0;
+    tableRowOffset = useColumnTitleAsColumnHeader ? 0 : -1;
+
+    int numberOfTableColumns = static_cast<int>(table->GetNumberOfColumns());
+    int numberOfTableRows = static_cast<int>(table->GetNumberOfRows());
+    rowCount = this->Transposed ? numberOfTableColumns - tableColOffset : numberOfTableRows - tableRowOffset;
+    columnCount = this->Transposed ? numberOfTableRows - tableRowOffset : numberOfTableColumns - tableColOffset;
+
+    columns.resize(numberOfTableColumns);
+    for (int tableCol = 0; tableCol < numberOfTableColumns; ++tableCol)
+    {
+      ColumnProperties& column = columns[tableCol];
+      column.Array = table->GetColumn(tableCol);
+      column.ArrayMTime = column.Array ? column.Array->GetMTime() : 0;
+      column.Name = QString(table->GetColumnName(tableCol));
+      // If column title is used as header then the column title is shown in the header,
+      // otherwise the column name is shown in the editable first row of the table.
+      if (useColumnTitleAsColumnHeader)
+      {
+        column.HeaderText = QString::fromStdString(this->MRMLTableNode->GetColumnTitle(column.Name.toStdString()));
+        if (column.HeaderText.isEmpty())
+        {
+          column.HeaderText = column.Name;
+        }
+        QString units = QString::fromStdString(this->MRMLTableNode->GetColumnUnitLabel(column.Name.toStdString()));
+        if (!units.isEmpty())
+        {
+          column.HeaderText += " [" + units + "]";
+        }
+      }
+    }
+  }
+
+  // If the header row or column is added or removed then all cells are moved
+  bool layoutChanged = (tableColOffset != this->TableColOffset || tableRowOffset != this->TableRowOffset);
+  columnModified.assign(columns.size(), true);
+  if (!layoutChanged)
+  {
+    size_t numberOfCommonColumns = std::min(columns.size(), this->Columns.size());
+    for (size_t tableCol = 0; tableCol < numberOfCommonColumns; ++tableCol)
+    {
+      columnModified[tableCol] = !(columns[tableCol] == this->Columns[tableCol]);
+    }
+  }
+
+  this->Columns.swap(columns);
+  this->TableColOffset = tableColOffset;
+  this->TableRowOffset = tableRowOffset;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLTableModelPrivate::emitTableColumnsChanged(int firstModelTableCol, int lastModelTableCol)
+{
+  Q_Q(qMRMLTableModel);
+  if (this->Transposed)
+  {
+    if (this->ColumnCount > 0)
+    {
+      emit q->dataChanged(q->index(firstModelTableCol, 0), q->index(lastModelTableCol, this->ColumnCount - 1));
+    }
+    emit q->headerDataChanged(Qt::Vertical, firstModelTableCol, lastModelTableCol);
+  }
+  else
+  {
+    if (this->RowCount > 0)
+    {
+      emit q->dataChanged(q->index(0, firstModelTableCol), q->index(this->RowCount - 1, lastModelTableCol));
+    }
+    emit q->headerDataChanged(Qt::Horizontal, firstModelTableCol, lastModelTableCol);
+  }
+}
+
 //------------------------------------------------------------------------------
 // qMRMLTableModel
 //------------------------------------------------------------------------------
 qMRMLTableModel::qMRMLTableModel(QObject* _parent)
-  : QStandardItemModel(_parent)
+  : QAbstractTableModel(_parent)
   , d_ptr(new qMRMLTableModelPrivate(*this))
 {
   Q_D(qMRMLTableModel);
@@ -189,7 +363,7 @@ qMRMLTableModel::qMRMLTableModel(QObject* _parent)
 
 //------------------------------------------------------------------------------
 qMRMLTableModel::qMRMLTableModel(qMRMLTableModelPrivate* pimpl, QObject* parentObject)
-  : QStandardItemModel(parentObject)
+  : QAbstractTableModel(parentObject)
   , d_ptr(pimpl)
 {
   Q_D(qMRMLTableModel);
@@ -203,6 +377,11 @@ qMRMLTableModel::~qMRMLTableModel() = default;
 void qMRMLTableModel::setMRMLTableNode(vtkMRMLTableNode* tableNode)
 {
   Q_D(qMRMLTableModel);
+  if (d->MRMLTableNode == tableNode)
+  {
+    this->updateModelFromMRML();
+    return;
+  }
   if (d->MRMLTableNode)
   {
     d->MRMLTableNode->RemoveObserver(d->CallBack);
@@ -211,8 +390,11 @@ void qMRMLTableModel::setMRMLTableNode(vtkMRMLTableNode* tableNode)
   {
     tableNode->AddObserver(vtkCommand::ModifiedEvent, d->CallBack);
   }
+  this->beginResetModel();
   d->MRMLTableNode = tableNode;
-  this->updateModelFromMRML();
+  std::vector<bool> columnModified;
+  d->updateTableProperties(d->RowCount, d->ColumnCount, columnModified);
+  this->endResetModel();
 }
 
 //------------------------------------------------------------------------------
@@ -227,356 +409,316 @@ void qMRMLTableModel::updateModelFromMRML()
 {
   Q_D(qMRMLTableModel);
 
-  QObject::disconnect(this, SIGNAL(itemChanged(QStandardItem*)), this, SLOT(onItemChanged(QStandardItem*)));
+  int newRowCount = 0;
+  int newColumnCount = 0;
+  std::vector<bool> columnModified;
+  d->updateTableProperties(newRowCount, newColumnCount, columnModified);
 
-  vtkMRMLTableNode* tableNode = vtkMRMLTableNode::SafeDownCast(d->MRMLTableNode);
-  vtkTable* table = (tableNode ? tableNode->GetTable() : nullptr);
-  if (table == nullptr || table->GetNumberOfColumns() == 0)
+  if (newRowCount != d->RowCount && newColumnCount != d->ColumnCount)
   {
-    beginResetModel();
-    // setRowCount and setColumnCount to 0 would not be enough, it's necessary to remove the header as well
-    setRowCount(0);
-    setColumnCount(0);
-    endResetModel();
-    QObject::connect(this, SIGNAL(itemChanged(QStandardItem*)), this, SLOT(onItemChanged(QStandardItem*)), Qt::UniqueConnection);
+    // Both dimensions changed, reset the entire model
+    this->beginResetModel();
+    d->RowCount = newRowCount;
+    d->ColumnCount = newColumnCount;
+    this->endResetModel();
     return;
   }
 
-  bool tableLocked = tableNode->GetLocked();
-  bool labelInFirstTableColumn = tableNode->GetUseFirstColumnAsRowHeader();
-  bool useColumnTitleAsColumnHeader = tableNode->GetUseColumnTitleAsColumnHeader();
-
-  vtkIdType numberOfTableColumns = table->GetNumberOfColumns();
-  vtkIdType numberOfTableRows = table->GetNumberOfRows();
-  // offset: modelIndex = mrmlIndex - offset
-  vtkIdType tableColOffset = labelInFirstTableColumn ? 1 : 0;
-  vtkIdType tableRowOffset = useColumnTitleAsColumnHeader ? 0 : -1;
-  if (d->Transposed)
+  if (newRowCount > d->RowCount)
   {
-    setRowCount(static_cast<int>(numberOfTableColumns - tableColOffset));
-    setColumnCount(static_cast<int>(numberOfTableRows - tableRowOffset));
+    this->beginInsertRows(QModelIndex(), d->RowCount, newRowCount - 1);
+    d->RowCount = newRowCount;
+    this->endInsertRows();
   }
-  else
+  else if (newRowCount < d->RowCount)
   {
-    setRowCount(static_cast<int>(numberOfTableRows - tableRowOffset));
-    setColumnCount(static_cast<int>(numberOfTableColumns - tableColOffset));
+    this->beginRemoveRows(QModelIndex(), newRowCount, d->RowCount - 1);
+    d->RowCount = newRowCount;
+    this->endRemoveRows();
   }
-
-  // Setup items for each table column
-  for (vtkIdType tableCol = tableColOffset; tableCol < numberOfTableColumns; ++tableCol)
+  if (newColumnCount > d->ColumnCount)
   {
-    int modelCol = static_cast<int>(tableCol - tableColOffset);
+    this->beginInsertColumns(QModelIndex(), d->ColumnCount, newColumnCount - 1);
+    d->ColumnCount = newColumnCount;
+    this->endInsertColumns();
+  }
+  else if (newColumnCount < d->ColumnCount)
+  {
+    this->beginRemoveColumns(QModelIndex(), newColumnCount, d->ColumnCount - 1);
+    d->ColumnCount = newColumnCount;
+    this->endRemoveColumns();
+  }
 
-    QString columnName(table->GetColumnName(tableCol));
-    vtkAbstractArray* columnArray = table->GetColumn(tableCol);
+  // If the table was modified without modifying any of its columns (e.g., values were set
+  // without calling Modified() on the column array) then it is not known which cells are changed,
+  // so all cells are updated.
+  if (std::find(columnModified.begin(), columnModified.end(), true) == columnModified.end())
+  {
+    std::fill(columnModified.begin(), columnModified.end(), true);
+  }
 
-    // If column title is used as header then the column title is shown in the header,
-    // otherwise the column name is shown in the editable first row of the table.
-    if (useColumnTitleAsColumnHeader)
+  // Notify views about each contiguous range of modified columns
+  int numberOfModelTableColumns = static_cast<int>(columnModified.size()) - d->TableColOffset;
+  int firstModifiedModelTableCol = -1;
+  for (int modelTableCol = 0; modelTableCol <= numberOfModelTableColumns; ++modelTableCol)
+  {
+    bool modified = (modelTableCol < numberOfModelTableColumns && columnModified[modelTableCol + d->TableColOffset]);
+    if (modified && firstModifiedModelTableCol < 0)
     {
-      QString headerText = QString::fromStdString(tableNode->GetColumnTitle(columnName.toStdString()));
-      if (headerText.isEmpty())
-      {
-        headerText = columnName;
-      }
-      QString units = QString::fromStdString(tableNode->GetColumnUnitLabel(columnName.toStdString()));
-      if (!units.isEmpty())
-      {
-        headerText += " [" + units + "]";
-      }
-      setHeaderData(modelCol, d->Transposed ? Qt::Vertical : Qt::Horizontal, headerText);
+      firstModifiedModelTableCol = modelTableCol;
     }
-    else
+    else if (!modified && firstModifiedModelTableCol >= 0)
     {
-      QString autoColumnHeader = d->columnNameFromIndex(modelCol);
-      setHeaderData(modelCol, d->Transposed ? Qt::Vertical : Qt::Horizontal, autoColumnHeader);
+      d->emitTableColumnsChanged(firstModifiedModelTableCol, modelTableCol - 1);
+      firstModifiedModelTableCol = -1;
     }
+  }
 
-    // Go through the rows of the current column
-    for (vtkIdType tableRow = tableRowOffset; tableRow < numberOfTableRows; ++tableRow)
-    {
-      int modelRow = static_cast<int>(tableRow - tableRowOffset);
-
-      // Use existing item if already created
-      QStandardItem* existingItem = nullptr;
-      if (d->Transposed)
-      {
-        existingItem = this->item(modelCol, modelRow);
-      }
-      else
-      {
-        existingItem = this->item(modelRow, modelCol);
-      }
-      QStandardItem* item = existingItem;
-      // Create item if did not exist
-      if (item == nullptr)
-      {
-        item = new QStandardItem();
-      }
-
-      // Items in first row use bold font, the others regular
-      if (tableRow >= 0)
-      {
-        vtkVariant variant = table->GetValue(tableRow, tableCol);
-        if (tableRow == 0)
-        {
-          // the first row might have been bold earlier, make sure
-          // it is reset to non-bold
-          QFont font;
-          item->setData(font, Qt::FontRole);
-        }
-
-        int dataType = columnArray->GetDataType();
+  // Row labels are the values of the first column
+  int numberOfModelTableRows = d->Transposed ? d->ColumnCount : d->RowCount;
+  if (d->TableColOffset > 0 && columnModified[0] && numberOfModelTableRows > 0)
+  {
+    emit headerDataChanged(d->Transposed ? Qt::Horizontal : Qt::Vertical, 0, numberOfModelTableRows - 1);
+  }
+}
 
-        // Set item property for known types.
-        // Special types are defined to be displayed differently, handled by qMRMLTableItemDelegate.
-        // NOTE: The data type itself can be enough, but in future types it will be necessary to define display role
-        //       as well, e.g. double array can be both color and position.
-        if (vtkBitArray::SafeDownCast(columnArray))
-        {
-          // Boolean values indicated by a column of vtkBitArray type are displayed as checkboxes
-          item->setData(VTK_BIT, UserRoleValueType);
-          item->setCheckable(true);
-          item->setCheckState(variant.ToInt() ? Qt::Checked : Qt::Unchecked);
-          item->setText(QString()); // No text is supposed to be in the cell
-        }
-        // Default display as text
-        else
-        {
-          if (dataType == VTK_CHAR || dataType == VTK_UNSIGNED_CHAR || dataType == VTK_SIGNED_CHAR)
-          {
-            // vtkVariant converts char type to string as a single letter, therefore we need to use
-            // custom converter
-            item->setText(QString::number(variant.ToInt()));
-          }
-          else
-          {
-            item->setText(QString(variant.ToString().c_str()));
-          }
-          item->setData(QVariant(), UserRoleValueType);
-          item->setCheckable(false);
-          item->setData(QVariant(), Qt::CheckStateRole);
-        }
-      }
-      else
-      {
-        item->setText(columnName);
-        QFont font;
-        font.setBold(true);
-        item->setData(font, Qt::FontRole);
-      }
+//------------------------------------------------------------------------------
+int qMRMLTableModel::rowCount(const QModelIndex& parent) const
+{
+  Q_D(const qMRMLTableModel);
+  return parent.isValid() ? 0 : d->RowCount;
+}
 
-      // Handle locked flag
-      if (item->isCheckable())
-      {
-        if (tableLocked)
-        {
-          // Item is view-only, clear the ItemIsUserCheckable flag
-          item->setFlags(item->flags() & (~Qt::ItemIsUserCheckable));
-        }
-        else
-        {
-          // Item is editable, set the ItemIsUserCheckable flag
-          item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
-        }
-        // Item text is empty and should not be editable
-        item->setFlags(item->flags() & (~Qt::ItemIsEditable));
-      }
-      else
-      {
-        if (tableLocked)
-        {
-          // Item is view-only, clear the ItemIsEditable flag
-          item->setFlags(item->flags() & (~Qt::ItemIsEditable));
-        }
-        else
-        {
-          // Item is editable, set the ItemIsEditable flag
-          item->setFlags(item->flags() | Qt::ItemIsEditable);
-        }
-      }
+//------------------------------------------------------------------------------
+int qMRMLTableModel::columnCount(const QModelIndex& parent) const
+{
+  Q_D(const qMRMLTableModel);
+  return parent.isValid() ? 0 : d->ColumnCount;
+}
 
-      // Add item if just created
-      if (item != existingItem)
-      {
-        if (d->Transposed)
-        {
-          setItem(modelCol, modelRow, item);
-        }
-        else
-        {
-          setItem(modelRow, modelCol, item);
-        }
-      }
-    }
+//------------------------------------------------------------------------------
+QVariant qMRMLTableModel::data(const QModelIndex& index, int role) const
+{
+  Q_D(const qMRMLTableModel);
+  int tableRow = -1;
+  int tableCol = -1;
+  if (!d->tableCellFromModelIndex(index, tableRow, tableCol))
+  {
+    return QVariant();
+  }
+  if (role == Qt::ToolTipRole)
+  {
+    return d->columnTooltipText(tableCol);
   }
-  // Set row label: either simply 1, 2, ... or values of the first column
-  for (vtkIdType tableRow = tableRowOffset; tableRow < numberOfTableRows; ++tableRow)
+
+  vtkTable* table = d->table();
+  vtkAbstractArray* columnArray = table->GetColumn(tableCol);
+  if (tableRow < 0)
   {
-    int modelRow = static_cast<int>(tableRow - tableRowOffset);
-    QString rowLabel;
-    if (labelInFirstTableColumn)
+    // Column name is displayed in the first row, using bold font
+    if (role == Qt::DisplayRole || role == Qt::EditRole)
     {
-      if (tableRow >= 0)
-      {
-        rowLabel = QString(table->GetValue(tableRow, 0).ToString().c_str());
-      }
-      else
-      {
-        rowLabel = QString(table->GetColumnName(0));
-        ;
-      }
+      return QString(columnArray->GetName());
     }
-    else
+    if (role == Qt::FontRole)
     {
-      rowLabel = QString::number(modelRow + 1);
+      QFont font;
+      font.setBold(true);
+      return font;
     }
-    setHeaderData(modelRow, d->Transposed ? Qt::Horizontal : Qt::Vertical, rowLabel);
+    return QVariant();
+  }
+
+  // Boolean values indicated by a column of vtkBitArray type are displayed as checkboxes
+  bool checkable = (vtkBitArray::SafeDownCast(columnArray) != nullptr);
+  if (role == Qt::DisplayRole || role == Qt::EditRole)
+  {
+    // No text is supposed to be in checkbox cells
+    return checkable ? QString() : d->cellText(table, tableRow, tableCol);
+  }
+  if (role == Qt::CheckStateRole && checkable)
+  {
+    return static_cast<int>(table->GetValue(tableRow, tableCol).ToInt() ? Qt::Checked : Qt::Unchecked);
   }
+  if (role == UserRoleValueType && checkable)
+  {
+    return VTK_BIT;
+  }
+  return QVariant();
+}
 
-  // Add tooltip text
-  for (vtkIdType tableCol = tableColOffset; tableCol < numberOfTableColumns; ++tableCol)
+//------------------------------------------------------------------------------
+QVariant qMRMLTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+  Q_D(const qMRMLTableModel);
+  vtkTable* table = d->table();
+  if (role != Qt::DisplayRole || table == nullptr || section < 0)
   {
-    int modelCol = static_cast<int>(tableCol - tableColOffset);
-    QString tooltipText = d->columnTooltipText(tableCol);
-    for (vtkIdType tableRow = tableRowOffset; tableRow < numberOfTableRows; ++tableRow)
+    return Superclass::headerData(section, orientation, role);
+  }
+
+  if (orientation == (d->Transposed ? Qt::Vertical : Qt::Horizontal))
+  {
+    // Column header: either column title or simply A, B, C, ...
+    int tableCol = section + d->TableColOffset;
+    if (tableCol >= static_cast<int>(d->Columns.size()))
     {
-      int modelRow = static_cast<int>(tableRow - tableRowOffset);
-      QStandardItem* existingItem = nullptr;
-      if (d->Transposed)
-      {
-        existingItem = this->item(modelCol, modelRow);
-      }
-      else
-      {
-        existingItem = this->item(modelRow, modelCol);
-      }
-      existingItem->setToolTip(tooltipText);
+      return QVariant();
     }
+    return d->TableRowOffset == 0 ? d->Columns[tableCol].HeaderText : d->columnNameFromIndex(section);
   }
 
-  QObject::connect(this, SIGNAL(itemChanged(QStandardItem*)), this, SLOT(onItemChanged(QStandardItem*)), Qt::UniqueConnection);
+  // Row label: either simply 1, 2, ... or values of the first column
+  if (d->TableColOffset == 0)
+  {
+    return QString::number(section + 1);
+  }
+  int tableRow = section + d->TableRowOffset;
+  if (table->GetNumberOfColumns() == 0 || tableRow >= table->GetNumberOfRows())
+  {
+    return QVariant();
+  }
+  if (tableRow < 0)
+  {
+    return QString(table->GetColumnName(0));
+  }
+  return QString(table->GetValue(tableRow, 0).ToString().c_str());
 }
 
 //------------------------------------------------------------------------------
-void qMRMLTableModel::updateMRMLFromModel(QStandardItem* item)
+Qt::ItemFlags qMRMLTableModel::flags(const QModelIndex& index) const
 {
-  Q_D(qMRMLTableModel);
-  if (item == nullptr)
+  Q_D(const qMRMLTableModel);
+  int tableRow = -1;
+  int tableCol = -1;
+  if (!d->tableCellFromModelIndex(index, tableRow, tableCol))
   {
-    qCritical("qMRMLTableModel::updateMRMLFromModel failed: item is invalid");
-    return;
+    return Qt::NoItemFlags;
   }
-  vtkMRMLTableNode* tableNode = vtkMRMLTableNode::SafeDownCast(d->MRMLTableNode);
-  if (tableNode == nullptr)
+  Qt::ItemFlags itemFlags = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+  if (d->MRMLTableNode->GetLocked())
   {
-    qCritical("qMRMLTableModel::updateMRMLFromModel failed: tableNode is invalid");
-    return;
+    // Item is view-only
+    return itemFlags;
+  }
+  if (tableRow >= 0 && vtkBitArray::SafeDownCast(d->table()->GetColumn(tableCol)))
+  {
+    // Item text is empty and should not be editable
+    return itemFlags | Qt::ItemIsUserCheckable;
   }
-  vtkTable* table = tableNode->GetTable();
+  return itemFlags | Qt::ItemIsEditable;
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLTableModel::setData(const QModelIndex& index, const QVariant& value, int role)
+{
+  Q_D(qMRMLTableModel);
+  vtkTable* table = d->table();
   if (table == nullptr)
   {
-    qCritical("qMRMLTableModel::updateMRMLFromModel failed: table is invalid");
-    return;
+    qCritical("qMRMLTableModel::setData failed: table is invalid");
+    return false;
+  }
+  int tableRow = -1;
+  int tableCol = -1;
+  if (!d->tableCellFromModelIndex(index, tableRow, tableCol) || d->MRMLTableNode->GetLocked())
+  {
+    return false;
   }
+  vtkAbstractArray* columnArray = table->GetColumn(tableCol);
 
-  int tableRow = mrmlTableRowIndex(item->index());
-  int tableCol = mrmlTableColumnIndex(item->index());
+  if (tableRow < 0)
+  {
+    // Column header changed. The model is updated when the node is modified.
+    if (role != Qt::EditRole)
+    {
+      return false;
+    }
+    QString valueBefore = QString::fromStdString(columnArray->GetName() ? columnArray->GetName() : "");
+    if (valueBefore == value.toString())
+    {
+      return true;
+    }
+    return d->MRMLTableNode->RenameColumn(tableCol, value.toString().toUtf8().constData());
+  }
 
-  if (tableRow >= 0)
+  if (vtkBitArray::SafeDownCast(columnArray))
   {
-    // Get item value according to type
-    int widgetType = item->data(UserRoleValueType).toInt();
-    if (widgetType == VTK_BIT)
+    // Cell bool value changed
+    if (role != Qt::CheckStateRole)
     {
-      // Cell bool value changed
-      int checked = item->checkState();
-      int valueBefore = table->GetValue(tableRow, tableCol).ToInt();
-      if (checked == valueBefore)
-      {
-        // The value is not changed, this means that the table cannot store this value - revert the value in the table
-        this->blockSignals(true);
-        item->setCheckState(valueBefore ? Qt::Checked : Qt::Unchecked);
-        item->setText(QString()); // No text is supposed to be in the cell
-        this->blockSignals(false);
-      }
-      else
-      {
-        table->SetValue(tableRow, tableCol, vtkVariant(checked));
-        table->GetColumn(tableCol)->Modified(); // Enable observation of checked state changed separately
-        table->Modified();
-      }
+      return false;
     }
-    else
+    int checked = (value.toInt() == Qt::Checked ? 1 : 0);
+    if (table->GetValue(tableRow, tableCol).ToInt() == checked)
     {
-      // Cell text value changed
-      int dataType = table->GetColumn(tableCol)->GetDataType();
-      if (dataType == VTK_CHAR || dataType == VTK_UNSIGNED_CHAR || dataType == VTK_SIGNED_CHAR)
+      return true;
+    }
+    table->SetValue(tableRow, tableCol, vtkVariant(checked));
+  }
+  else
+  {
+    // Cell text value changed
+    if (role != Qt::EditRole)
+    {
+      return false;
+    }
+    int dataType = columnArray->GetDataType();
+    if (dataType == VTK_CHAR || dataType == VTK_UNSIGNED_CHAR || dataType == VTK_SIGNED_CHAR)
+    {
+      // vtkVariant would convert char to a letter, so we need custom conversion here
+      bool valid = false;
+      int newValue = value.toString().toInt(&valid);
+      if (dataType == VTK_UNSIGNED_CHAR)
       {
-        // vtkVariant would convert char to a letter, so we need custom conversion here
-        bool valid = false;
-        int newValue = item->text().toInt(&valid);
-        if (dataType == VTK_UNSIGNED_CHAR)
+        if (newValue < VTK_UNSIGNED_CHAR_MIN || newValue > VTK_UNSIGNED_CHAR_MAX)
         {
-          if (newValue < VTK_UNSIGNED_CHAR_MIN || newValue > VTK_UNSIGNED_CHAR_MAX)
-          {
-            valid = false;
-          }
-        }
-        else
-        {
-          if (newValue < VTK_SIGNED_CHAR_MIN || newValue > VTK_SIGNED_CHAR_MAX)
-          {
-            valid = false;
-          }
-        }
-        if (valid)
-        {
-          table->SetValue(tableRow, tableCol, newValue);
-          table->Modified();
-        }
-        else
-        {
-          vtkVariant valueInTableBefore = table->GetValue(tableRow, tableCol); // restore this value if new value is invalid
-          this->blockSignals(true);
-          item->setText(QString::number(valueInTableBefore.ToInt()));
-          this->blockSignals(false);
+          valid = false;
         }
       }
       else
       {
-        vtkVariant valueInTableBefore = table->GetValue(tableRow, tableCol); // restore this value if new value is invalid
-        vtkVariant itemText(item->text().toUtf8().constData());              // the vtkVariant constructor makes a copy of the input buffer, so using constData is safe
-        table->SetValue(tableRow, tableCol, itemText);
-        vtkVariant valueInTableAfter = table->GetValue(tableRow, tableCol);
-        if (valueInTableBefore == valueInTableAfter)
-        {
-          // The value is not changed then it means it is invalid,
-          // restore previous value
-          this->blockSignals(true);
-          item->setText(QString(valueInTableBefore.ToString().c_str()));
-          this->blockSignals(false);
-        }
-        else
+        if (newValue < VTK_SIGNED_CHAR_MIN || newValue > VTK_SIGNED_CHAR_MAX)
         {
-          table->Modified();
+          valid = false;
         }
       }
+      if (!valid)
+      {
+        return false;
+      }
+      table->SetValue(tableRow, tableCol, newValue);
     }
-  }
-  else
-  {
-    // Column header changed
-    vtkAbstractArray* column = table->GetColumn(tableCol);
-    if (column)
+    else
     {
-      QString valueBefore = QString::fromStdString(column->GetName() ? column->GetName() : "");
-      if (valueBefore != item->text())
+      vtkVariant valueInTableBefore = table->GetValue(tableRow, tableCol);
+      vtkVariant itemText(value.toString().toUtf8().constData()); // the vtkVariant constructor makes a copy of the input buffer, so using constData is safe
+      table->SetValue(tableRow, tableCol, itemText);
+      vtkVariant valueInTableAfter = table->GetValue(tableRow, tableCol);
+      if (valueInTableBefore == valueInTableAfter)
       {
-        tableNode->RenameColumn(tableCol, item->text().toUtf8().constData());
+        // The value is not changed then it means it is invalid
+        return false;
       }
     }
   }
+
+  // Only the modified cell is updated in this model. Modifying the column allows other models
+  // and observers to find out which column has changed.
+  d->IsUpdatingMRML = true;
+  columnArray->Modified();
+  table->Modified();
+  d->IsUpdatingMRML = false;
+  d->Columns[tableCol].ArrayMTime = columnArray->GetMTime();
+
+  emit dataChanged(index, index);
+  if (tableCol == 0 && d->TableColOffset > 0)
+  {
+    // Row label is the value of the first column
+    int section = tableRow - d->TableRowOffset;
+    emit headerDataChanged(d->Transposed ? Qt::Horizontal : Qt::Vertical, section, section);
+  }
+  return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -599,19 +741,13 @@ void qMRMLTableModel::onMRMLTableNodeModified(vtkObject* node)
   Q_D(qMRMLTableModel);
   vtkMRMLTableNode* tableNode = vtkMRMLTableNode::SafeDownCast(node);
   Q_UNUSED(tableNode);
-  Q_UNUSED(d);
   Q_ASSERT(tableNode == d->MRMLTableNode);
-  this->updateModelFromMRML();
-}
-
-//------------------------------------------------------------------------------
-void qMRMLTableModel::onItemChanged(QStandardItem* item)
-{
-  if (item == this->invisibleRootItem())
+  if (d->IsUpdatingMRML)
   {
+    // The model has already been updated
     return;
   }
-  this->updateMRMLFromModel(item);
+  this->updateModelFromMRML();
 }
 
 //------------------------------------------------------------------------------
@@ -622,8 +758,11 @@ void qMRMLTableModel::setTransposed(bool transposed)
   {
     return;
   }
+  this->beginResetModel();
   d->Transposed = transposed;
-  this->updateModelFromMRML();
+  std::vector<bool> columnModified;
+  d->updateTableProperties(d->RowCount, d->ColumnCount, columnModified);
+  this->endResetModel();
 }
 
 //------------------------------------------------------------------------------
@@ -24,7 +24,7 @@
 #define __qMRMLTableModel_h
 
 // Qt includes
-#include <QStandardItemModel>
+#include <QAbstractTableModel>
 
 // CTK includes
 #include <ctkPimpl.h>
@@ -40,7 +40,14 @@ class QAction;
 class qMRMLTableModelPrivate;
 
 //------------------------------------------------------------------------------
-class QMRML_WIDGETS_EXPORT qMRMLTableModel : public QStandardItemModel
+/// \brief Table model that shows the content of a MRML table node.
+///
+/// Cell values are not copied into the model but read on demand from the columns of the vtkTable,
+/// therefore showing or updating a table does not require iterating through all the cells.
+/// Only the header text of each column is cached.
+/// When the table is modified then dataChanged signal is only emitted for columns that are changed
+/// (or for all columns if the table was modified without modifying any of its columns).
+class QMRML_WIDGETS_EXPORT qMRMLTableModel : public QAbstractTableModel
 {
   Q_OBJECT
   QVTK_OBJECT
@@ -48,7 +55,7 @@ class QMRML_WIDGETS_EXPORT qMRMLTableModel : public QStandardItemModel
   Q_PROPERTY(bool transposed READ transposed WRITE setTransposed)
 
 public:
-  typedef QAbstractItemModel Superclass;
+  typedef QAbstractTableModel Superclass;
   qMRMLTableModel(QObject* parent = nullptr);
   ~qMRMLTableModel() override;
 
@@ -65,12 +72,21 @@ public:
   void setTransposed(bool transposed);
   bool transposed() const;
 
-  /// Return the VTK table cell associated to the node index.
-  void updateMRMLFromModel(QStandardItem* item);
-
-  /// Update the entire table from the MRML node
+  /// Update the model from the MRML node.
+  /// Model rows and columns are inserted or removed if the size of the table changed
+  /// and dataChanged signal is emitted for the modified table columns.
   void updateModelFromMRML();
 
+  int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+  int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+  QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+  Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+  /// Set value in the MRML table. Values are set using Qt::EditRole
+  /// (Qt::CheckStateRole for boolean columns). Returns false if the value is invalid.
+  bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+
   /// Get MRML table index from model index
   int mrmlTableRowIndex(QModelIndex modelIndex) const;
 
@@ -85,7 +101,6 @@ public:
 
 protected slots:
   void onMRMLTableNodeModified(vtkObject* node);
-  void onItemChanged(QStandardItem* item);
 
 protected:
   qMRMLTableModel(qMRMLTableModelPrivate* pimpl, QObject* parent = nullptr);
@@ -217,7 +217,14 @@ void qMRMLTableView::setMRMLTableNode(vtkMRMLTableNode* node)
   this->sortFilterProxyModel()->invalidate();
 
   this->horizontalHeader()->setMinimumSectionSize(60);
-  this->resizeColumnsToContents();
+  // Resizing all columns would be slow for tables with very many columns
+  // (e.g., transposed tables with many rows), therefore only the first columns are resized.
+  const int maximumNumberOfColumnsToResize = 200;
+  int numberOfColumnsToResize = std::min(this->model()->columnCount(), maximumNumberOfColumnsToResize);
+  for (int columnIndex = 0; columnIndex < numberOfColumnsToResize; ++columnIndex)
+  {
+    this->resizeColumnToContents(columnIndex);
+  }
 
   emit selectionChanged();
 }
@@ -326,14 +333,15 @@ void qMRMLTableView::copySelection()
       {
         textToCopy.append('\t');
       }
-      QStandardItem* item = mrmlModel->item(rowIndex, columnIndex);
-      if (item->isCheckable())
+      QModelIndex index = mrmlModel->index(rowIndex, columnIndex);
+      QVariant checkState = mrmlModel->data(index, Qt::CheckStateRole);
+      if (checkState.isValid())
       {
-        textToCopy.append(item->checkState() == Qt::Checked ? "1" : "0");
+        textToCopy.append(checkState.toInt() == Qt::Checked ? "1" : "0");
       }
       else
       {
-        textToCopy.append(item->text());
+        textToCopy.append(mrmlModel->data(index).toString());
       }
     }
   }
@@ -419,17 +427,17 @@ void qMRMLTableView::pasteSelection()
         }
         mrmlModel->updateModelFromMRML();
       }
-      // Set values in items
-      QStandardItem* item = mrmlModel->item(rowIndex, columnIndex);
-      if (item != nullptr)
+      // Set values in the table
+      QModelIndex index = mrmlModel->index(rowIndex, columnIndex);
+      if (index.isValid())
       {
-        if (item->isCheckable())
+        if (mrmlModel->data(index, Qt::CheckStateRole).isValid())
         {
-          item->setCheckState(cell.toInt() == 0 ? Qt::Unchecked : Qt::Checked);
+          mrmlModel->setData(index, static_cast<int>(cell.toInt() == 0 ? Qt::Unchecked : Qt::Checked), Qt::CheckStateRole);
         }
         else
         {
-          item->setText(cell);
+          mrmlModel->setData(index, cell, Qt::EditRole);
         }
       }
       else
@@ -0,0 +1,423 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Compares the labelmap merge, masking, and extent computation kernels
+// to straightforward voxel-by-voxel implementations, and measures their speed.
+
+// SegmentationCore includes
+#include "vtkOrientedImageData.h"
+#include "vtkOrientedImageDataResample.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Creates an image with sparse random label values in a box
+void CreateLabelmap(vtkOrientedImageData* image, const int extent[6], int scalarType, unsigned int seed, const int box[6], int maximumLabel)
+{
+  image->SetExtent(const_cast<int*>(extent));
+  image->AllocateScalars(scalarType, 1);
+  image->GetPointData()->GetScalars()->Fill(0);
+  std::mt19937 generator(seed);
+  std::uniform_int_distribution<int> labelDistribution(0, maximumLabel);
+  for (int k = box[4]; k <= box[5]; ++k)
+  {
+    for (int j = box[2]; j <= box[3]; ++j)
+    {
+      for (int i = box[0]; i <= box[1]; ++i)
+      {
+        image->SetScalarComponentFromDouble(i, j, k, 0, labelDistribution(generator));
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+bool IsVoxelInExtent(const int extent[6], int i, int j, int k)
+{
+  return i >= extent[0] && i <= extent[1] && j >= extent[2] && j <= extent[3] && k >= extent[4] && k <= extent[5];
+}
+
+//----------------------------------------------------------------------------
+bool AreImagesEqual(vtkOrientedImageData* image, vtkOrientedImageData* expectedImage, const char* name, int line)
+{
+  int* extent = expectedImage->GetExtent();
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      for (int i = extent[0]; i <= extent[1]; ++i)
+      {
+        if (image->GetScalarComponentAsDouble(i, j, k, 0) != expectedImage->GetScalarComponentAsDouble(i, j, k, 0))
+        {
+          std::cerr << "Line " << line << ": " << name << " mismatch at voxel (" << i << ", " << j << ", " << k << ")" << std::endl;
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestModifyImage(int baseScalarType, int modifierScalarType)
+{
+  const int baseExtent[6] = { -3, 40, 2, 30, 0, 17 };
+  const int modifierExtent[6] = { 5, 60, -4, 20, 3, 25 };
+  const int baseBox[6] = { 0, 35, 5, 25, 2, 15 };
+  const int modifierBox[6] = { 10, 50, 0, 12, 5, 10 };
+  const int restrictedExtent[6] = { 7, 38, 1, 19, 4, 20 };
+
+  for (int operation :
+       { vtkOrientedImageDataResample::OPERATION_MAXIMUM, vtkOrientedImageDataResample::OPERATION_MINIMUM, vtkOrientedImageDataResample::OPERATION_MASKING })
+  {
+    for (const int* extent : { static_cast<const int*>(nullptr), restrictedExtent })
+    {
+      vtkNew<vtkOrientedImageData> baseImage;
+      CreateLabelmap(baseImage, baseExtent, baseScalarType, 1, baseBox, 3);
+      vtkNew<vtkOrientedImageData> modifierImage;
+      CreateLabelmap(modifierImage, modifierExtent, modifierScalarType, 2, modifierBox, 3);
+      const double maskThreshold = 1.0;
+      const double fillValue = 5.0;
+
+      // Expected result, computed voxel by voxel
+      vtkNew<vtkOrientedImageData> expectedImage;
+      expectedImage->DeepCopy(baseImage);
+      bool expectedModified = false;
+      for (int k = baseExtent[4]; k <= baseExtent[5]; ++k)
+      {
+        for (int j = baseExtent[2]; j <= baseExtent[3]; ++j)
+        {
+          for (int i = baseExtent[0]; i <= baseExtent[1]; ++i)
+          {
+            if (!IsVoxelInExtent(modifierExtent, i, j, k) || (extent && !IsVoxelInExtent(extent, i, j, k)))
+            {
+              continue;
+            }
+            double base = baseImage->GetScalarComponentAsDouble(i, j, k, 0);
+            double modifier = modifierImage->GetScalarComponentAsDouble(i, j, k, 0);
+            double result = base;
+            if (operation == vtkOrientedImageDataResample::OPERATION_MAXIMUM)
+            {
+              result = std::max(base, modifier);
+            }
+            else if (operation == vtkOrientedImageDataResample::OPERATION_MINIMUM)
+            {
+              result = std::min(base, modifier);
+            }
+            else if (modifier > maskThreshold)
+            {
+              result = fillValue;
+              expectedModified = true;
+            }
+            if (result != base)
+            {
+              expectedModified = true;
+            }
+            expectedImage->SetScalarComponentFromDouble(i, j, k, 0, result);
+          }
+        }
+      }
+
+      vtkMTimeType mtimeBefore = baseImage->GetMTime();
+      if (!vtkOrientedImageDataResample::ModifyImage(baseImage, modifierImage, operation, extent, maskThreshold, fillValue))
+      {
+        std::cerr << "Line " << __LINE__ << ": ModifyImage failed" << std::endl;
+        return false;
+      }
+      if (!AreImagesEqual(baseImage, expectedImage, "ModifyImage", __LINE__))
+      {
+        std::cerr << "Operation " << operation << ", restricted extent: " << (extent != nullptr) << std::endl;
+        return false;
+      }
+      if ((baseImage->GetMTime() > mtimeBefore) != expectedModified)
+      {
+        std::cerr << "Line " << __LINE__ << ": ModifyImage modified state is incorrect for operation " << operation << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestCalculateEffectiveExtent()
+{
+  const int extent[6] = { -5, 70, 3, 40, -2, 20 };
+  vtkNew<vtkOrientedImageData> image;
+  const int boxes[4][6] = { { -5, 70, 3, 40, -2, 20 }, { 0, 0, 10, 10, 5, 5 }, { 10, 64, 4, 4, 0, 19 }, { 70, 70, 40, 40, 20, 20 } };
+  for (const int* box : boxes)
+  {
+    CreateLabelmap(image, extent, VTK_SHORT, 3, box, 1);
+    int expectedExtent[6] = { extent[1] + 1, extent[0] - 1, extent[3] + 1, extent[2] - 1, extent[5] + 1, extent[4] - 1 };
+    for (int k = extent[4]; k <= extent[5]; ++k)
+    {
+      for (int j = extent[2]; j <= extent[3]; ++j)
+      {
+        for (int i = extent[0]; i <= extent[1]; ++i)
+        {
+          if (image->GetScalarComponentAsDouble(i, j, k, 0) > 0)
+          {
+            const int ijk[3] = { i, j, k };
+            for (int axis = 0; axis < 3; ++axis)
+            {
+              expectedExtent[axis * 2] = std::min(expectedExtent[axis * 2], ijk[axis]);
+              expectedExtent[axis * 2 + 1] = std::max(expectedExtent[axis * 2 + 1], ijk[axis]);
+            }
+          }
+        }
+      }
+    }
+    int effectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
+    vtkOrientedImageDataResample::CalculateEffectiveExtent(image, effectiveExtent);
+    for (int i = 0; i < 6; ++i)
+    {
+      if (effectiveExtent[i] != expectedExtent[i])
+      {
+        std::cerr << "Line " << __LINE__ << ": effective extent[" << i << "] is " << effectiveExtent[i] << ", expected " << expectedExtent[i] << std::endl;
+        return false;
+      }
+    }
+  }
+
+  // Empty image
+  image->GetPointData()->GetScalars()->Fill(0);
+  int effectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  if (vtkOrientedImageDataResample::CalculateEffectiveExtent(image, effectiveExtent))
+  {
+    std::cerr << "Line " << __LINE__ << ": effective extent of an empty image must be empty" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestApplyImageMask()
+{
+  const int extent[6] = { 0, 50, 0, 30, 0, 20 };
+  const int maskExtent[6] = { 10, 70, -5, 20, 5, 25 };
+  const int box[6] = { 0, 50, 0, 30, 0, 20 };
+  const int maskBox[6] = { 10, 40, 0, 20, 5, 15 };
+  for (bool notMask : { false, true })
+  {
+    vtkNew<vtkOrientedImageData> image;
+    CreateLabelmap(image, extent, VTK_SHORT, 4, box, 10);
+    vtkNew<vtkOrientedImageData> mask;
+    CreateLabelmap(mask, maskExtent, VTK_UNSIGNED_CHAR, 5, maskBox, 1);
+    const double fillValue = 7.0;
+
+    vtkNew<vtkOrientedImageData> expectedImage;
+    expectedImage->DeepCopy(image);
+    for (int k = extent[4]; k <= extent[5]; ++k)
+    {
+      for (int j = extent[2]; j <= extent[3]; ++j)
+      {
+        for (int i = extent[0]; i <= extent[1]; ++i)
+        {
+          bool inMask = IsVoxelInExtent(maskExtent, i, j, k) && mask->GetScalarComponentAsDouble(i, j, k, 0) != 0;
+          if (inMask == notMask)
+          {
+            expectedImage->SetScalarComponentFromDouble(i, j, k, 0, fillValue);
+          }
+        }
+      }
+    }
+
+    vtkDataArray* originalScalars = image->GetPointData()->GetScalars();
+    originalScalars->Register(nullptr);
+    if (!vtkOrientedImageDataResample::ApplyImageMask(image, mask, fillValue, notMask))
+    {
+      std::cerr << "Line " << __LINE__ << ": ApplyImageMask failed" << std::endl;
+      originalScalars->UnRegister(nullptr);
+      return false;
+    }
+    bool scalarsReplaced = (image->GetPointData()->GetScalars() != originalScalars);
+    originalScalars->UnRegister(nullptr);
+    if (!scalarsReplaced)
+    {
+      std::cerr << "Line " << __LINE__ << ": ApplyImageMask must not modify the input scalars in place" << std::endl;
+      return false;
+    }
+    if (!AreImagesEqual(image, expectedImage, "ApplyImageMask", __LINE__))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestGetLabelValuesInMask(int scalarType)
+{
+  const int extent[6] = { 0, 50, 0, 30, 0, 20 };
+  const int maskExtent[6] = { 10, 70, -5, 20, 5, 25 };
+  const int box[6] = { 0, 50, 0, 30, 0, 20 };
+  const int maskBox[6] = { 10, 12, 0, 2, 5, 6 };
+  vtkNew<vtkOrientedImageData> image;
+  CreateLabelmap(image, extent, scalarType, 6, box, 200);
+  vtkNew<vtkOrientedImageData> mask;
+  CreateLabelmap(mask, maskExtent, VTK_UNSIGNED_CHAR, 7, maskBox, 1);
+
+  std::set<int> expectedValues;
+  for (int k = maskBox[4]; k <= maskBox[5]; ++k)
+  {
+    for (int j = maskBox[2]; j <= maskBox[3]; ++j)
+    {
+      for (int i = maskBox[0]; i <= maskBox[1]; ++i)
+      {
+        int value = static_cast<int>(image->GetScalarComponentAsDouble(i, j, k, 0));
+        if (mask->GetScalarComponentAsDouble(i, j, k, 0) > 0 && value != 0)
+        {
+          expectedValues.insert(value);
+        }
+      }
+    }
+  }
+
+  std::vector<int> labelValues;
+  vtkOrientedImageDataResample::GetLabelValuesInMask(labelValues, image, mask);
+  if (labelValues != std::vector<int>(expectedValues.begin(), expectedValues.end()))
+  {
+    std::cerr << "Line " << __LINE__ << ": GetLabelValuesInMask found " << labelValues.size() << " values, expected " << expectedValues.size() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestPerformance(int minimumSize, int maximumSize)
+{
+  for (int size = minimumSize; size <= maximumSize; size *= 2)
+  {
+    // Labelmap with a few large segments and a small modifier, as it is typical when painting
+    const int extent[6] = { 0, size - 1, 0, size - 1, 0, size - 1 };
+    vtkNew<vtkOrientedImageData> labelmap;
+    labelmap->SetExtent(const_cast<int*>(extent));
+    labelmap->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+    unsigned char* voxels = static_cast<unsigned char*>(labelmap->GetScalarPointer());
+    const vtkIdType numberOfVoxels = static_cast<vtkIdType>(size) * size * size;
+    for (vtkIdType voxelIndex = 0; voxelIndex < numberOfVoxels; ++voxelIndex)
+    {
+      voxels[voxelIndex] = static_cast<unsigned char>((voxelIndex / (numberOfVoxels / 4)) % 4);
+    }
+    vtkNew<vtkOrientedImageData> modifier;
+    modifier->SetExtent(const_cast<int*>(extent));
+    modifier->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+    modifier->GetPointData()->GetScalars()->Fill(0);
+    const int brushBox[6] = { size / 4, size / 2, size / 4, size / 2, size / 4, size / 2 };
+    for (int k = brushBox[4]; k <= brushBox[5]; ++k)
+    {
+      for (int j = brushBox[2]; j <= brushBox[3]; ++j)
+      {
+        unsigned char* row = static_cast<unsigned char*>(modifier->GetScalarPointer(brushBox[0], j, k));
+        std::fill(row, row + brushBox[1] - brushBox[0] + 1, 5);
+      }
+    }
+
+    vtkNew<vtkTimerLog> timer;
+    std::cout << size << "^3 labelmap:" << std::endl;
+
+    timer->StartTimer();
+    vtkOrientedImageDataResample::ModifyImage(labelmap, modifier, vtkOrientedImageDataResample::OPERATION_MAXIMUM);
+    timer->StopTimer();
+    std::cout << "  ModifyImage maximum: " << timer->GetElapsedTime() << " s" << std::endl;
+
+    timer->StartTimer();
+    vtkOrientedImageDataResample::ModifyImage(labelmap, modifier, vtkOrientedImageDataResample::OPERATION_MASKING, nullptr, 0, 0);
+    timer->StopTimer();
+    std::cout << "  ModifyImage masking: " << timer->GetElapsedTime() << " s" << std::endl;
+
+    int effectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
+    timer->StartTimer();
+    vtkOrientedImageDataResample::CalculateEffectiveExtent(modifier, effectiveExtent);
+    timer->StopTimer();
+    std::cout << "  CalculateEffectiveExtent: " << timer->GetElapsedTime() << " s" << std::endl;
+    for (int i = 0; i < 6; ++i)
+    {
+      if (effectiveExtent[i] != brushBox[i])
+      {
+        std::cerr << "Line " << __LINE__ << ": unexpected effective extent" << std::endl;
+        return false;
+      }
+    }
+
+    std::vector<int> labelValues;
+    timer->StartTimer();
+    vtkOrientedImageDataResample::GetLabelValuesInMask(labelValues, labelmap, modifier);
+    timer->StopTimer();
+    std::cout << "  GetLabelValuesInMask: " << timer->GetElapsedTime() << " s" << std::endl;
+
+    timer->StartTimer();
+    vtkOrientedImageDataResample::ApplyImageMask(labelmap, modifier, 0.0);
+    timer->StopTimer();
+    std::cout << "  ApplyImageMask: " << timer->GetElapsedTime() << " s" << std::endl;
+  }
+  return true;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkOrientedImageDataResampleTest1(int argc, char* argv[])
+{
+  // By default performance is only reported for a small labelmap. Large labelmaps (256^3 up to 512^3 or
+  // the largest size specified as argument) are processed if requested by "--benchmark [maximumSize]" arguments.
+  int minimumSize = 64;
+  int maximumSize = 64;
+  if (argc > 1 && strcmp(argv[1], "--benchmark") == 0)
+  {
+    minimumSize = 256;
+    maximumSize = (argc > 2 ? atoi(argv[2]) : 512);
+  }
+
+  if (!TestModifyImage(VTK_UNSIGNED_CHAR, VTK_UNSIGNED_CHAR) //
+      || !TestModifyImage(VTK_SHORT, VTK_UNSIGNED_CHAR)      //
+      || !TestModifyImage(VTK_UNSIGNED_CHAR, VTK_SHORT)      //
+      || !TestModifyImage(VTK_FLOAT, VTK_DOUBLE))
+  {
+    return EXIT_FAILURE;
+  }
+  if (!TestCalculateEffectiveExtent() || !TestApplyImageMask())
+  {
+    return EXIT_FAILURE;
+  }
+  if (!TestGetLabelValuesInMask(VTK_UNSIGNED_CHAR) || !TestGetLabelValuesInMask(VTK_SHORT) || !TestGetLabelValuesInMask(VTK_INT))
+  {
+    return EXIT_FAILURE;
+  }
+  if (!TestPerformance(minimumSize, maximumSize))
+  {
+    return EXIT_FAILURE;
+  }
+  std::cout << "Oriented image data resample test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,266 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// SegmentationCore includes
+#include "vtkOrientedImageData.h"
+#include "vtkSegment.h"
+#include "vtkSegmentation.h"
+#include "vtkSegmentationConverter.h"
+#include "vtkSegmentationStatistics.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+void FillBox(vtkOrientedImageData* image, const int box[6], int value)
+{
+  for (int k = box[4]; k <= box[5]; ++k)
+  {
+    for (int j = box[2]; j <= box[3]; ++j)
+    {
+      for (int i = box[0]; i <= box[1]; ++i)
+      {
+        *static_cast<unsigned char*>(image->GetScalarPointer(i, j, k)) = static_cast<unsigned char>(value);
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+void CreateLabelmap(vtkOrientedImageData* image, int size, double spacing)
+{
+  image->SetDimensions(size, size, size);
+  image->SetSpacing(spacing, spacing, spacing);
+  image->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  image->GetPointData()->GetScalars()->Fill(0);
+}
+
+//----------------------------------------------------------------------------
+void AddSegment(vtkSegmentation* segmentation, const std::string& segmentId, vtkOrientedImageData* labelmap, int labelValue)
+{
+  vtkNew<vtkSegment> segment;
+  segment->SetName(segmentId.c_str());
+  segment->SetLabelValue(labelValue);
+  segment->AddRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName(), labelmap);
+  segmentation->AddSegment(segment, segmentId);
+}
+
+//----------------------------------------------------------------------------
+bool IsEqual(double value, double expected, const char* name, int line)
+{
+  if (fabs(value - expected) > 1e-6)
+  {
+    std::cerr << "Line " << line << ": " << name << " is " << value << ", expected " << expected << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestStatistics()
+{
+  const int size = 20;
+  const double spacing = 0.5;
+
+  // Two segments in a shared layer and one segment in a separate layer
+  vtkNew<vtkOrientedImageData> sharedLabelmap;
+  CreateLabelmap(sharedLabelmap, size, spacing);
+  const int cubeBox[6] = { 2, 5, 2, 5, 2, 5 };
+  FillBox(sharedLabelmap, cubeBox, 1);
+  const int barBox[6] = { 10, 14, 10, 11, 10, 10 };
+  FillBox(sharedLabelmap, barBox, 2);
+  vtkNew<vtkOrientedImageData> separateLabelmap;
+  CreateLabelmap(separateLabelmap, size, spacing);
+  const int overlapBox[6] = { 4, 7, 4, 4, 4, 4 };
+  FillBox(separateLabelmap, overlapBox, 1);
+
+  vtkNew<vtkSegmentation> segmentation;
+  segmentation->SetSourceRepresentationName(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName());
+  AddSegment(segmentation, "cube", sharedLabelmap, 1);
+  AddSegment(segmentation, "bar", sharedLabelmap, 2);
+  AddSegment(segmentation, "overlap", separateLabelmap, 1);
+
+  // Voxel value is the I index
+  vtkNew<vtkOrientedImageData> scalarVolume;
+  scalarVolume->SetDimensions(size, size, size);
+  scalarVolume->SetSpacing(spacing, spacing, spacing);
+  scalarVolume->AllocateScalars(VTK_SHORT, 1);
+  for (int k = 0; k < size; ++k)
+  {
+    for (int j = 0; j < size; ++j)
+    {
+      for (int i = 0; i < size; ++i)
+      {
+        *static_cast<short*>(scalarVolume->GetScalarPointer(i, j, k)) = static_cast<short>(i);
+      }
+    }
+  }
+
+  vtkNew<vtkSegmentationStatistics> statistics;
+  statistics->SetSegmentation(segmentation);
+  statistics->SetScalarVolume(scalarVolume);
+  statistics->ComputeShapeStatisticsOn();
+  if (!statistics->Compute())
+  {
+    std::cerr << "Line " << __LINE__ << ": failed to compute statistics" << std::endl;
+    return false;
+  }
+
+  const double voxelVolume = spacing * spacing * spacing;
+  if (!statistics->HasLabelmapStatistics("cube") || !statistics->HasShapeStatistics("bar") || !statistics->HasScalarStatistics("overlap"))
+  {
+    std::cerr << "Line " << __LINE__ << ": missing statistics" << std::endl;
+    return false;
+  }
+  if (!IsEqual(statistics->GetVoxelCount("cube"), 64, "cube voxel count", __LINE__) //
+      || !IsEqual(statistics->GetVoxelCount("bar"), 10, "bar voxel count", __LINE__)
+      || !IsEqual(statistics->GetVoxelCount("overlap"), 4, "overlap voxel count", __LINE__)
+      || !IsEqual(statistics->GetVolumeMm3("cube"), 64 * voxelVolume, "cube volume", __LINE__))
+  {
+    return false;
+  }
+
+  // Shape
+  double centroid[3] = { 0.0, 0.0, 0.0 };
+  statistics->GetCentroid("cube", centroid);
+  double moments[3] = { 0.0, 0.0, 0.0 };
+  statistics->GetPrincipalMoments("cube", moments);
+  if (!IsEqual(centroid[0], 3.5 * spacing, "cube centroid", __LINE__) || !IsEqual(centroid[2], 3.5 * spacing, "cube centroid", __LINE__)
+      || !IsEqual(moments[0], 1.25 * spacing * spacing, "cube principal moment", __LINE__)
+      || !IsEqual(moments[2], 1.25 * spacing * spacing, "cube principal moment", __LINE__))
+  {
+    return false;
+  }
+  statistics->GetPrincipalMoments("bar", moments);
+  double largestAxis[3] = { 0.0, 0.0, 0.0 };
+  statistics->GetPrincipalAxis("bar", 2, largestAxis);
+  if (!IsEqual(moments[0], 0.0, "bar principal moment", __LINE__) //
+      || !IsEqual(moments[1], 0.25 * spacing * spacing, "bar principal moment", __LINE__)
+      || !IsEqual(moments[2], 2.0 * spacing * spacing, "bar principal moment", __LINE__) //
+      || !IsEqual(fabs(largestAxis[0]), 1.0, "bar principal axis", __LINE__)
+      || !IsEqual(statistics->GetElongation("bar"), sqrt(2.0 / 0.25), "bar elongation", __LINE__))
+  {
+    return false;
+  }
+
+  // Scalar volume
+  if (!IsEqual(statistics->GetScalarVoxelCount("cube"), 64, "cube scalar voxel count", __LINE__) //
+      || !IsEqual(statistics->GetScalarMinimum("cube"), 2, "cube minimum", __LINE__)
+      || !IsEqual(statistics->GetScalarMaximum("cube"), 5, "cube maximum", __LINE__) //
+      || !IsEqual(statistics->GetScalarMean("cube"), 3.5, "cube mean", __LINE__)
+      || !IsEqual(statistics->GetScalarStandardDeviation("cube"), sqrt(1.25 * 64.0 / 63.0), "cube standard deviation", __LINE__)
+      || !IsEqual(statistics->GetScalarMedian("cube"), 3, "cube median", __LINE__)
+      || !IsEqual(statistics->GetScalarPercentile("cube", 90), 5, "cube 90th percentile", __LINE__)
+      || !IsEqual(statistics->GetScalarMean("bar"), 12, "bar mean", __LINE__) //
+      || !IsEqual(statistics->GetScalarMean("overlap"), 5.5, "overlap mean", __LINE__))
+  {
+    return false;
+  }
+
+  // Histogram bins cover only the voxel value range of each segment,
+  // so percentiles remain exact even if the volume has more values than bins.
+  statistics->SetMaximumNumberOfHistogramBins(4);
+  statistics->Compute();
+  if (!IsEqual(statistics->GetScalarMedian("cube"), 3, "cube median with few bins", __LINE__)
+      || !IsEqual(statistics->GetScalarPercentile("cube", 90), 5, "cube 90th percentile with few bins", __LINE__)
+      || !IsEqual(statistics->GetScalarMedian("overlap"), 5, "overlap median with few bins", __LINE__))
+  {
+    return false;
+  }
+
+  // Subset of segments
+  statistics->AddSegmentID("bar");
+  statistics->Compute();
+  if (statistics->HasLabelmapStatistics("cube") || statistics->GetVoxelCount("bar") != 10)
+  {
+    std::cerr << "Line " << __LINE__ << ": statistics must be computed only for the selected segments" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestPerformance()
+{
+  const int size = 256;
+  const int numberOfSegments = 8;
+  vtkNew<vtkOrientedImageData> labelmap;
+  CreateLabelmap(labelmap, size, 1.0);
+  vtkNew<vtkSegmentation> segmentation;
+  segmentation->SetSourceRepresentationName(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName());
+  for (int segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+  {
+    // slabs along the K axis
+    const int slabThickness = size / numberOfSegments;
+    const int box[6] = { 0, size - 1, 0, size - 1, segmentIndex * slabThickness, (segmentIndex + 1) * slabThickness - 1 };
+    FillBox(labelmap, box, segmentIndex + 1);
+    AddSegment(segmentation, "Segment_" + std::to_string(segmentIndex + 1), labelmap, segmentIndex + 1);
+  }
+  vtkNew<vtkOrientedImageData> scalarVolume;
+  scalarVolume->SetDimensions(size, size, size);
+  scalarVolume->AllocateScalars(VTK_SHORT, 1);
+  short* voxels = static_cast<short*>(scalarVolume->GetScalarPointer());
+  for (vtkIdType voxelIndex = 0; voxelIndex < static_cast<vtkIdType>(size) * size * size; ++voxelIndex)
+  {
+    voxels[voxelIndex] = static_cast<short>(voxelIndex % 4096 - 1024);
+  }
+
+  vtkNew<vtkSegmentationStatistics> statistics;
+  statistics->SetSegmentation(segmentation);
+  statistics->SetScalarVolume(scalarVolume);
+  statistics->ComputeShapeStatisticsOn();
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  statistics->Compute();
+  timer->StopTimer();
+  std::cout << "Computed statistics of " << numberOfSegments << " segments on " << size << "^3 volume in " << timer->GetElapsedTime() << " s" << std::endl;
+
+  vtkIdType expectedVoxelCount = static_cast<vtkIdType>(size) * size * (size / numberOfSegments);
+  for (int segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+  {
+    std::string segmentId = "Segment_" + std::to_string(segmentIndex + 1);
+    if (statistics->GetVoxelCount(segmentId) != expectedVoxelCount || statistics->GetScalarVoxelCount(segmentId) != expectedVoxelCount)
+    {
+      std::cerr << "Line " << __LINE__ << ": unexpected voxel count for " << segmentId << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkSegmentationStatisticsTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  if (!TestStatistics() || !TestPerformance())
+  {
+    return EXIT_FAILURE;
+  }
+  std::cout << "Segmentation statistics test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,223 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// SegmentationCore includes
+#include "vtkSegment.h"
+#include "vtkSegmentation.h"
+#include "vtkSegmentationConverter.h"
+#include "vtkSegmentationSurfaceStatistics.h"
+
+// VTK includes
+#include <vtkMassProperties.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkStripper.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkPolyData> CreateSphere(double radius, const double center[3], int resolution)
+{
+  vtkNew<vtkSphereSource> sphereSource;
+  sphereSource->SetRadius(radius);
+  sphereSource->SetCenter(center[0], center[1], center[2]);
+  sphereSource->SetThetaResolution(resolution);
+  sphereSource->SetPhiResolution(resolution);
+  sphereSource->Update();
+  vtkSmartPointer<vtkPolyData> sphere = vtkSmartPointer<vtkPolyData>::New();
+  sphere->DeepCopy(sphereSource->GetOutput());
+  return sphere;
+}
+
+//----------------------------------------------------------------------------
+void AddSegment(vtkSegmentation* segmentation, const std::string& segmentId, vtkPolyData* surface)
+{
+  vtkNew<vtkSegment> segment;
+  segment->SetName(segmentId.c_str());
+  segment->AddRepresentation(vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName(), surface);
+  segmentation->AddSegment(segment, segmentId);
+}
+
+//----------------------------------------------------------------------------
+bool IsEqual(double value, double expected, const char* name, int line)
+{
+  if (fabs(value - expected) > 1e-6 * std::max(1.0, fabs(expected)))
+  {
+    std::cerr << "Line " << line << ": " << name << " is " << value << ", expected " << expected << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestStatistics()
+{
+  vtkNew<vtkSegmentation> segmentation;
+  segmentation->SetSourceRepresentationName(vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName());
+  const double center1[3] = { 10.0, -20.0, 300.0 };
+  vtkSmartPointer<vtkPolyData> sphere = CreateSphere(15.0, center1, 32);
+  AddSegment(segmentation, "sphere", sphere);
+
+  // Same sphere, represented by triangle strips
+  const double center2[3] = { -50.0, 0.0, 0.0 };
+  vtkSmartPointer<vtkPolyData> stripSphereTriangles = CreateSphere(15.0, center2, 32);
+  vtkNew<vtkStripper> stripper;
+  stripper->SetInputData(stripSphereTriangles);
+  stripper->Update();
+  vtkNew<vtkPolyData> stripSphere;
+  stripSphere->DeepCopy(stripper->GetOutput());
+  AddSegment(segmentation, "strips", stripSphere);
+
+  vtkNew<vtkMassProperties> massProperties;
+  massProperties->SetInputData(sphere);
+  massProperties->Update();
+
+  vtkNew<vtkSegmentationSurfaceStatistics> statistics;
+  statistics->SetSegmentation(segmentation);
+  statistics->SetNumberOfCellsPerBlock(100);
+  if (!statistics->Compute())
+  {
+    std::cerr << "Line " << __LINE__ << ": failed to compute statistics" << std::endl;
+    return false;
+  }
+  if (!statistics->HasSurfaceStatistics("sphere") || !statistics->HasSurfaceStatistics("strips"))
+  {
+    std::cerr << "Line " << __LINE__ << ": missing statistics" << std::endl;
+    return false;
+  }
+  if (!IsEqual(statistics->GetSurfaceAreaMm2("sphere"), massProperties->GetSurfaceArea(), "sphere surface area", __LINE__)
+      || !IsEqual(statistics->GetVolumeMm3("sphere"), massProperties->GetVolume(), "sphere volume", __LINE__)
+      || !IsEqual(statistics->GetSurfaceAreaMm2("strips"), massProperties->GetSurfaceArea(), "strips surface area", __LINE__)
+      || !IsEqual(statistics->GetVolumeMm3("strips"), massProperties->GetVolume(), "strips volume", __LINE__))
+  {
+    return false;
+  }
+  if (statistics->GetCachedResultUsed("sphere") || statistics->GetComputationTimeSec("sphere") < 0.0)
+  {
+    std::cerr << "Line " << __LINE__ << ": cached result must not be used in the first computation" << std::endl;
+    return false;
+  }
+
+  // Unchanged surfaces are not processed again
+  statistics->Compute();
+  if (!statistics->GetCachedResultUsed("sphere") || !statistics->GetCachedResultUsed("strips")
+      || !IsEqual(statistics->GetVolumeMm3("sphere"), massProperties->GetVolume(), "cached sphere volume", __LINE__))
+  {
+    std::cerr << "Line " << __LINE__ << ": cached result must be used for unchanged surfaces" << std::endl;
+    return false;
+  }
+
+  // Modified surface is processed again
+  vtkPoints* points = sphere->GetPoints();
+  for (vtkIdType pointIndex = 0; pointIndex < points->GetNumberOfPoints(); ++pointIndex)
+  {
+    double point[3] = { 0.0, 0.0, 0.0 };
+    points->GetPoint(pointIndex, point);
+    points->SetPoint(pointIndex, point[0] * 2.0, point[1], point[2]);
+  }
+  points->Modified();
+  massProperties->Update();
+  statistics->Compute();
+  if (statistics->GetCachedResultUsed("sphere") || !statistics->GetCachedResultUsed("strips")
+      || !IsEqual(statistics->GetVolumeMm3("sphere"), massProperties->GetVolume(), "modified sphere volume", __LINE__))
+  {
+    std::cerr << "Line " << __LINE__ << ": modified surface must be processed again" << std::endl;
+    return false;
+  }
+
+  // Subset of segments
+  statistics->AddSegmentID("strips");
+  statistics->Compute();
+  if (statistics->HasSurfaceStatistics("sphere") || !statistics->HasSurfaceStatistics("strips"))
+  {
+    std::cerr << "Line " << __LINE__ << ": statistics must be available only for the selected segments" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestPerformance()
+{
+  const int numberOfSegments = 300;
+  vtkNew<vtkSegmentation> segmentation;
+  segmentation->SetSourceRepresentationName(vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName());
+  for (int segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+  {
+    const double center[3] = { segmentIndex * 10.0, 0.0, 0.0 };
+    AddSegment(segmentation, "Segment_" + std::to_string(segmentIndex + 1), CreateSphere(4.0, center, 100));
+  }
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  vtkNew<vtkMassProperties> massProperties;
+  double referenceVolume = 0.0;
+  for (int segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+  {
+    std::string segmentId = "Segment_" + std::to_string(segmentIndex + 1);
+    massProperties->SetInputData(segmentation->GetSegment(segmentId)->GetRepresentation(vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName()));
+    massProperties->Update();
+    referenceVolume = massProperties->GetVolume();
+  }
+  timer->StopTimer();
+  std::cout << "vtkMassProperties on " << numberOfSegments << " surfaces: " << timer->GetElapsedTime() << " s" << std::endl;
+
+  vtkNew<vtkSegmentationSurfaceStatistics> statistics;
+  statistics->SetSegmentation(segmentation);
+  timer->StartTimer();
+  statistics->Compute();
+  timer->StopTimer();
+  std::cout << "vtkSegmentationSurfaceStatistics on " << numberOfSegments << " surfaces: " << timer->GetElapsedTime() << " s" << std::endl;
+
+  timer->StartTimer();
+  statistics->Compute();
+  timer->StopTimer();
+  std::cout << "vtkSegmentationSurfaceStatistics on " << numberOfSegments << " unchanged surfaces: " << timer->GetElapsedTime() << " s" << std::endl;
+
+  for (int segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+  {
+    std::string segmentId = "Segment_" + std::to_string(segmentIndex + 1);
+    if (!IsEqual(statistics->GetVolumeMm3(segmentId), referenceVolume, "volume", __LINE__))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkSegmentationSurfaceStatisticsTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  if (!TestStatistics() || !TestPerformance())
+  {
+    return EXIT_FAILURE;
+  }
+  std::cout << "Segmentation surface statistics test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
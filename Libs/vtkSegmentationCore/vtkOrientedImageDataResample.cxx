@@ -29,13 +29,14 @@
 #include <vtkGeneralTransform.h>
 #include <vtkImageCast.h>
 #include <vtkImageConstantPad.h>
-#include <vtkImageMask.h>
 #include <vtkImageReslice.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPlaneSource.h>
 #include <vtkPointData.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
 #include <vtkSmartPointer.h>
 #include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
@@ -44,10 +45,208 @@
 
 // STD includes
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <set>
+#include <type_traits>
 #include <vector>
 
 vtkStandardNewMacro(vtkOrientedImageDataResample);
 
+//----------------------------------------------------------------------------
+// Voxels are processed in blocks of this many scalars. Each block is first only read to decide
+// if anything has to be done with it. The loops within a block are branch-free, so that the compiler
+// can vectorize them, and blocks that need no change (most of a labelmap when painting) are never written.
+const vtkIdType SCALAR_BLOCK_SIZE = 64;
+
+//----------------------------------------------------------------------------
+// Rows of an extent of an image, in the order they are stored in memory.
+// Rows are the unit of work that is distributed between threads.
+struct ImageRows
+{
+  ImageRows(const int extent[6], int numberOfComponents)
+  {
+    for (int i = 0; i < 6; ++i)
+    {
+      this->Extent[i] = extent[i];
+    }
+    this->NumberOfComponents = numberOfComponents;
+    this->RowLength = static_cast<vtkIdType>(extent[1] - extent[0] + 1) * numberOfComponents;
+    this->NumberOfRowsPerSlice = extent[3] - extent[2] + 1;
+    this->NumberOfRows = this->NumberOfRowsPerSlice * (extent[5] - extent[4] + 1);
+  }
+
+  /// Offset of the first scalar of the row, relative to the first scalar of the extent
+  vtkIdType GetRowOffset(vtkIdType rowIndex, const vtkIdType increments[3]) const
+  {
+    return (rowIndex % this->NumberOfRowsPerSlice) * increments[1] + (rowIndex / this->NumberOfRowsPerSlice) * increments[2];
+  }
+  int GetJ(vtkIdType rowIndex) const { return this->Extent[2] + static_cast<int>(rowIndex % this->NumberOfRowsPerSlice); }
+  int GetK(vtkIdType rowIndex) const { return this->Extent[4] + static_cast<int>(rowIndex / this->NumberOfRowsPerSlice); }
+
+  int Extent[6];
+  int NumberOfComponents;
+  /// Number of scalars in a row
+  vtkIdType RowLength;
+  vtkIdType NumberOfRowsPerSlice;
+  vtkIdType NumberOfRows;
+};
+
+//----------------------------------------------------------------------------
+// Returns index of the first scalar in [begin, end) that is above threshold, or end if there is none.
+template <class T>
+vtkIdType FindFirstScalarAboveThreshold(const T* scalars, vtkIdType begin, vtkIdType end, T threshold)
+{
+  for (vtkIdType blockBegin = begin; blockBegin < end; blockBegin += SCALAR_BLOCK_SIZE)
+  {
+    const vtkIdType blockEnd = std::min(blockBegin + SCALAR_BLOCK_SIZE, end);
+    int found = 0;
+    for (vtkIdType i = blockBegin; i < blockEnd; ++i)
+    {
+      found |= (scalars[i] > threshold);
+    }
+    if (!found)
+    {
+      continue;
+    }
+    for (vtkIdType i = blockBegin; i < blockEnd; ++i)
+    {
+      if (scalars[i] > threshold)
+      {
+        return i;
+      }
+    }
+  }
+  return end;
+}
+
+//----------------------------------------------------------------------------
+// Returns index of the last scalar in [begin, end) that is above threshold, or end if there is none.
+template <class T>
+vtkIdType FindLastScalarAboveThreshold(const T* scalars, vtkIdType begin, vtkIdType end, T threshold)
+{
+  for (vtkIdType blockEnd = end; blockEnd > begin; blockEnd -= SCALAR_BLOCK_SIZE)
+  {
+    const vtkIdType blockBegin = std::max(blockEnd - SCALAR_BLOCK_SIZE, begin);
+    int found = 0;
+    for (vtkIdType i = blockBegin; i < blockEnd; ++i)
+    {
+      found |= (scalars[i] > threshold);
+    }
+    if (!found)
+    {
+      continue;
+    }
+    for (vtkIdType i = blockEnd - 1; i >= blockBegin; --i)
+    {
+      if (scalars[i] > threshold)
+      {
+        return i;
+      }
+    }
+  }
+  return end;
+}
+
+//----------------------------------------------------------------------------
+template <class BaseImageScalarType, class ModifierImageScalarType>
+struct MergeMaximumOperation
+{
+  bool IsChanged(BaseImageScalarType base, ModifierImageScalarType modifier) const { return static_cast<BaseImageScalarType>(modifier) > base; }
+  BaseImageScalarType Apply(BaseImageScalarType base, ModifierImageScalarType modifier) const
+  {
+    return this->IsChanged(base, modifier) ? static_cast<BaseImageScalarType>(modifier) : base;
+  }
+};
+
+//----------------------------------------------------------------------------
+template <class BaseImageScalarType, class ModifierImageScalarType>
+struct MergeMinimumOperation
+{
+  bool IsChanged(BaseImageScalarType base, ModifierImageScalarType modifier) const { return static_cast<BaseImageScalarType>(modifier) < base; }
+  BaseImageScalarType Apply(BaseImageScalarType base, ModifierImageScalarType modifier) const
+  {
+    return this->IsChanged(base, modifier) ? static_cast<BaseImageScalarType>(modifier) : base;
+  }
+};
+
+//----------------------------------------------------------------------------
+template <class BaseImageScalarType, class ModifierImageScalarType>
+struct MergeMaskingOperation
+{
+  // Base image is reported as modified wherever the modifier is above the threshold, even if the base already contained the fill value
+  bool IsChanged(BaseImageScalarType vtkNotUsed(base), ModifierImageScalarType modifier) const { return modifier > this->MaskThreshold; }
+  BaseImageScalarType Apply(BaseImageScalarType base, ModifierImageScalarType modifier) const
+  {
+    return modifier > this->MaskThreshold ? this->FillValue : base;
+  }
+
+  ModifierImageScalarType MaskThreshold;
+  BaseImageScalarType FillValue;
+};
+
+//----------------------------------------------------------------------------
+// Merges a row of the modifier image into the base image. Returns true if the base image is modified.
+template <class BaseImageScalarType, class ModifierImageScalarType, class Operation>
+bool MergeRow(BaseImageScalarType* base, const ModifierImageScalarType* modifier, vtkIdType rowLength, const Operation& operation)
+{
+  bool rowModified = false;
+  for (vtkIdType blockBegin = 0; blockBegin < rowLength; blockBegin += SCALAR_BLOCK_SIZE)
+  {
+    const vtkIdType blockEnd = std::min(blockBegin + SCALAR_BLOCK_SIZE, rowLength);
+    int blockChanged = 0;
+    for (vtkIdType i = blockBegin; i < blockEnd; ++i)
+    {
+      blockChanged |= operation.IsChanged(base[i], modifier[i]);
+    }
+    if (!blockChanged)
+    {
+      continue;
+    }
+    for (vtkIdType i = blockBegin; i < blockEnd; ++i)
+    {
+      base[i] = operation.Apply(base[i], modifier[i]);
+    }
+    rowModified = true;
+  }
+  return rowModified;
+}
+
+//----------------------------------------------------------------------------
+// Merges all rows of the modifier image into the base image in parallel. Returns true if the base image is modified.
+template <class BaseImageScalarType, class ModifierImageScalarType, class Operation>
+bool MergeRows(BaseImageScalarType* baseImagePtr,
+               const vtkIdType baseIncrements[3],
+               const ModifierImageScalarType* modifierImagePtr,
+               const vtkIdType modifierIncrements[3],
+               const ImageRows& rows,
+               const Operation& operation)
+{
+  std::atomic<bool> baseImageModified(false);
+  vtkSMPTools::For(0,
+                   rows.NumberOfRows,
+                   [&](vtkIdType beginRow, vtkIdType endRow)
+                   {
+                     bool modified = false;
+                     for (vtkIdType rowIndex = beginRow; rowIndex < endRow; ++rowIndex)
+                     {
+                       if (MergeRow(baseImagePtr + rows.GetRowOffset(rowIndex, baseIncrements),
+                                    modifierImagePtr + rows.GetRowOffset(rowIndex, modifierIncrements),
+                                    rows.RowLength,
+                                    operation))
+                       {
+                         modified = true;
+                       }
+                     }
+                     if (modified)
+                     {
+                       baseImageModified = true;
+                     }
+                   });
+  return baseImageModified;
+}
+
 //----------------------------------------------------------------------------
 // This templated function executes the filter for any type of data.
 template <class BaseImageScalarType, class ModifierImageScalarType>
@@ -83,17 +282,11 @@ void MergeImageGeneric2(vtkImageData* baseImage, vtkImageData* modifierImage, in
   }
 
   // Get increments to march through data
-  vtkIdType baseIncX = 0;
-  vtkIdType baseIncY = 0;
-  vtkIdType baseIncZ = 0;
-  vtkIdType modifierIncX = 0;
-  vtkIdType modifierIncY = 0;
-  vtkIdType modifierIncZ = 0;
-  baseImage->GetContinuousIncrements(updateExt, baseIncX, baseIncY, baseIncZ);
-  modifierImage->GetContinuousIncrements(updateExt, modifierIncX, modifierIncY, modifierIncZ);
-  int maxX = (updateExt[1] - updateExt[0]) * baseImage->GetNumberOfScalarComponents();
-  int maxY = updateExt[3] - updateExt[2];
-  int maxZ = updateExt[5] - updateExt[4];
+  vtkIdType baseIncrements[3] = { 0, 0, 0 };
+  vtkIdType modifierIncrements[3] = { 0, 0, 0 };
+  baseImage->GetIncrements(baseIncrements);
+  modifierImage->GetIncrements(modifierIncrements);
+  ImageRows rows(updateExt, baseImage->GetNumberOfScalarComponents());
   BaseImageScalarType* baseImagePtr = static_cast<BaseImageScalarType*>(baseImage->GetScalarPointerForExtent(updateExt));
   ModifierImageScalarType* modifierImagePtr = static_cast<ModifierImageScalarType*>(modifierImage->GetScalarPointerForExtent(updateExt));
 
@@ -111,110 +304,51 @@ void MergeImageGeneric2(vtkImageData* baseImage, vtkImageData* modifierImage, in
   bool baseImageModified = false;
 
   // Loop through output pixels
-  // There is difference in only one line between min/max computation but the comparison
-  // is performed for each pixel, so it is faster to make the conditional expression in the outer loop.
-  // Looping is performed in two step: first we just check if any of the pixels have to be changed,
-  // if we find any, then we set baseImageModified flag and to the second loop without need to set
-  // baseImageModified flag again (setting a flag in a hot loop may impact speed).
+  // The operation is selected outside the loops, so that the per-voxel loops are specialized for each operation.
+  // Rows are processed in parallel, and within a row only those blocks of voxels are written that actually change.
   if (operation == vtkOrientedImageDataResample::OPERATION_MAXIMUM)
   {
-    for (vtkIdType idxZ = 0; idxZ <= maxZ; idxZ++)
-    {
-      for (vtkIdType idxY = 0; idxY <= maxY; idxY++)
-      {
-        for (vtkIdType idxX = 0; idxX <= maxX; idxX++)
-        {
-          if (static_cast<BaseImageScalarType>(*modifierImagePtr) > *baseImagePtr)
-          {
-            *baseImagePtr = *modifierImagePtr;
-            baseImageModified = true;
-          }
-          baseImagePtr++;
-          modifierImagePtr++;
-        }
-        baseImagePtr += baseIncY;
-        modifierImagePtr += modifierIncY;
-      }
-      baseImagePtr += baseIncZ;
-      modifierImagePtr += modifierIncZ;
-    }
+    MergeMaximumOperation<BaseImageScalarType, ModifierImageScalarType> maximumOperation;
+    baseImageModified = MergeRows(baseImagePtr, baseIncrements, modifierImagePtr, modifierIncrements, rows, maximumOperation);
   }
   else if (operation == vtkOrientedImageDataResample::OPERATION_MINIMUM)
   {
-    for (vtkIdType idxZ = 0; idxZ <= maxZ; idxZ++)
-    {
-      for (vtkIdType idxY = 0; idxY <= maxY; idxY++)
-      {
-        for (vtkIdType idxX = 0; idxX <= maxX; idxX++)
-        {
-          if (static_cast<BaseImageScalarType>(*modifierImagePtr) < *baseImagePtr)
-          {
-            *baseImagePtr = *modifierImagePtr;
-            baseImageModified = true;
-          }
-          baseImagePtr++;
-          modifierImagePtr++;
-        }
-        baseImagePtr += baseIncY;
-        modifierImagePtr += modifierIncY;
-      }
-      baseImagePtr += baseIncZ;
-      modifierImagePtr += modifierIncZ;
-    }
+    MergeMinimumOperation<BaseImageScalarType, ModifierImageScalarType> minimumOperation;
+    baseImageModified = MergeRows(baseImagePtr, baseIncrements, modifierImagePtr, modifierIncrements, rows, minimumOperation);
   }
   else if (operation == vtkOrientedImageDataResample::OPERATION_MASKING)
   {
+    MergeMaskingOperation<BaseImageScalarType, ModifierImageScalarType> maskingOperation;
 
     // Make sure the fill value is valid for the base image scalar range
-    BaseImageScalarType fillValueBaseImageType = 0;
     if (fillValue < baseImage->GetScalarTypeMin())
     {
-      fillValueBaseImageType = static_cast<BaseImageScalarType>(baseImage->GetScalarTypeMin());
+      maskingOperation.FillValue = static_cast<BaseImageScalarType>(baseImage->GetScalarTypeMin());
     }
     else if (fillValue > baseImage->GetScalarTypeMax())
     {
-      fillValueBaseImageType = static_cast<BaseImageScalarType>(baseImage->GetScalarTypeMax());
+      maskingOperation.FillValue = static_cast<BaseImageScalarType>(baseImage->GetScalarTypeMax());
     }
     else
     {
-      fillValueBaseImageType = static_cast<BaseImageScalarType>(fillValue);
+      maskingOperation.FillValue = static_cast<BaseImageScalarType>(fillValue);
     }
 
     // Make sure the threshold is valid for the modifier scalar range
-    ModifierImageScalarType maskThresholdModifierType = 0;
     if (maskThreshold < modifierImage->GetScalarTypeMin())
     {
-      maskThresholdModifierType = static_cast<ModifierImageScalarType>(modifierImage->GetScalarTypeMin());
+      maskingOperation.MaskThreshold = static_cast<ModifierImageScalarType>(modifierImage->GetScalarTypeMin());
     }
     else if (maskThreshold > modifierImage->GetScalarTypeMax())
     {
-      maskThresholdModifierType = static_cast<ModifierImageScalarType>(modifierImage->GetScalarTypeMax());
+      maskingOperation.MaskThreshold = static_cast<ModifierImageScalarType>(modifierImage->GetScalarTypeMax());
     }
     else
     {
-      maskThresholdModifierType = static_cast<ModifierImageScalarType>(maskThreshold);
+      maskingOperation.MaskThreshold = static_cast<ModifierImageScalarType>(maskThreshold);
     }
 
-    for (vtkIdType idxZ = 0; idxZ <= maxZ; idxZ++)
-    {
-      for (vtkIdType idxY = 0; idxY <= maxY; idxY++)
-      {
-        for (vtkIdType idxX = 0; idxX <= maxX; idxX++)
-        {
-          if ((*modifierImagePtr) > maskThresholdModifierType)
-          {
-            *baseImagePtr = fillValueBaseImageType;
-            baseImageModified = true;
-          }
-          baseImagePtr++;
-          modifierImagePtr++;
-        }
-        baseImagePtr += baseIncY;
-        modifierImagePtr += modifierIncY;
-      }
-      baseImagePtr += baseIncZ;
-      modifierImagePtr += modifierIncZ;
-    }
+    baseImageModified = MergeRows(baseImagePtr, baseIncrements, modifierImagePtr, modifierIncrements, rows, maskingOperation);
   }
   if (baseImageModified)
   {
@@ -588,93 +722,73 @@ void CalculateEffectiveExtentGeneric(vtkOrientedImageData* image, int effectiveE
   effectiveExtent[4] = wholeExt[5] + 1;
   effectiveExtent[5] = wholeExt[4] - 1;
 
-  if (image->GetScalarPointer() == nullptr)
+  T* imagePtr = static_cast<T*>(image->GetScalarPointer());
+  if (imagePtr == nullptr || wholeExt[0] > wholeExt[1] || wholeExt[2] > wholeExt[3] || wholeExt[4] > wholeExt[5])
   {
     // no image data is allocated, return with empty extent
     return;
   }
 
-  // Loop through output pixels
-  for (int k = wholeExt[4]; k <= wholeExt[5]; k++)
-  {
-    for (int j = wholeExt[2]; j <= wholeExt[3]; j++)
+  vtkIdType increments[3] = { 0, 0, 0 };
+  image->GetIncrements(increments);
+  ImageRows rows(wholeExt, image->GetNumberOfScalarComponents());
+  const int numberOfComponents = rows.NumberOfComponents;
+
+  // Each thread computes the effective extent of the rows it processes, which are then combined
+  std::array<int, 6> emptyExtent;
+  std::copy(effectiveExtent, effectiveExtent + 6, emptyExtent.begin());
+  vtkSMPThreadLocal<std::array<int, 6>> localEffectiveExtents(emptyExtent);
+  vtkSMPTools::For(0,
+                   rows.NumberOfRows,
+                   [&](vtkIdType beginRow, vtkIdType endRow)
+                   {
+                     std::array<int, 6>& localExtent = localEffectiveExtents.Local();
+                     for (vtkIdType rowIndex = beginRow; rowIndex < endRow; ++rowIndex)
+                     {
+                       const T* rowPtr = imagePtr + rows.GetRowOffset(rowIndex, increments);
+                       const int j = rows.GetJ(rowIndex);
+                       const int k = rows.GetK(rowIndex);
+                       bool currentLineInEffectiveExtent = (k >= localExtent[4] && k <= localExtent[5] && j >= localExtent[2] && j <= localExtent[3]);
+
+                       // If the line is already in the effective extent then only voxels before the current extent need to be checked
+                       const vtkIdType firstSegmentEnd = currentLineInEffectiveExtent //
+                                                           ? static_cast<vtkIdType>(localExtent[0] - wholeExt[0]) * numberOfComponents
+                                                           : rows.RowLength;
+                       const vtkIdType first = FindFirstScalarAboveThreshold(rowPtr, 0, firstSegmentEnd, threshold);
+                       if (first < firstSegmentEnd)
+                       {
+                         const int i = wholeExt[0] + static_cast<int>(first / numberOfComponents);
+                         localExtent[0] = std::min(localExtent[0], i);
+                         localExtent[1] = std::max(localExtent[1], i);
+                         localExtent[2] = std::min(localExtent[2], j);
+                         localExtent[3] = std::max(localExtent[3], j);
+                         localExtent[4] = std::min(localExtent[4], k);
+                         localExtent[5] = std::max(localExtent[5], k);
+                         currentLineInEffectiveExtent = true;
+                       }
+                       if (!currentLineInEffectiveExtent)
+                       {
+                         // We haven't found any non-empty voxel in this line
+                         continue;
+                       }
+
+                       // Now we need to find the other end of the extent: the last non-empty voxel in the line.
+                       // The fastest way to find it is to start backward search from the end of the line.
+                       const vtkIdType lastSegmentBegin = static_cast<vtkIdType>(localExtent[1] - wholeExt[0] + 1) * numberOfComponents;
+                       const vtkIdType last = FindLastScalarAboveThreshold(rowPtr, lastSegmentBegin, rows.RowLength, threshold);
+                       if (last < rows.RowLength)
+                       {
+                         localExtent[1] = std::max(localExtent[1], wholeExt[0] + static_cast<int>(last / numberOfComponents));
+                       }
+                     }
+                   });
+
+  for (const std::array<int, 6>& localExtent : localEffectiveExtents)
+  {
+    for (int axis = 0; axis < 3; ++axis)
     {
-      bool currentLineInEffectiveExtent = (k >= effectiveExtent[4] && k <= effectiveExtent[5] && j >= effectiveExtent[2] && j <= effectiveExtent[3]);
-      int i = wholeExt[0];
-      T* imagePtr = static_cast<T*>(image->GetScalarPointer(i, j, k));
-      int firstSegmentEnd = currentLineInEffectiveExtent ? effectiveExtent[0] : wholeExt[1];
-      for (; i <= firstSegmentEnd; i++)
-      {
-        if (*(imagePtr++) > threshold)
-        {
-          if (i < effectiveExtent[0])
-          {
-            effectiveExtent[0] = i;
-          }
-          if (i > effectiveExtent[1])
-          {
-            effectiveExtent[1] = i;
-          }
-          if (j < effectiveExtent[2])
-          {
-            effectiveExtent[2] = j;
-          }
-          if (j > effectiveExtent[3])
-          {
-            effectiveExtent[3] = j;
-          }
-          if (k < effectiveExtent[4])
-          {
-            effectiveExtent[4] = k;
-          }
-          if (k > effectiveExtent[5])
-          {
-            effectiveExtent[5] = k;
-          }
-          currentLineInEffectiveExtent = true;
-          break;
-        }
-      }
-      if (!currentLineInEffectiveExtent)
-      {
-        // We haven't found any non-empty voxel in this line
-        continue;
-      }
-      // Now we need to find the other end of the extent: the last non-empty voxel in the line.
-      // The fastest way to find it is to start backward search from the end of the line.
-      i = wholeExt[1];
-      imagePtr = static_cast<T*>(image->GetScalarPointer(i, j, k));
-      for (; i > effectiveExtent[1]; i--)
-      {
-        if (*(imagePtr--) > threshold)
-        {
-          if (i < effectiveExtent[0])
-          {
-            effectiveExtent[0] = i;
-          }
-          if (i > effectiveExtent[1])
-          {
-            effectiveExtent[1] = i;
-          }
-          if (j < effectiveExtent[2])
-          {
-            effectiveExtent[2] = j;
-          }
-          if (j > effectiveExtent[3])
-          {
-            effectiveExtent[3] = j;
-          }
-          if (k < effectiveExtent[4])
-          {
-            effectiveExtent[4] = k;
-          }
-          if (k > effectiveExtent[5])
-          {
-            effectiveExtent[5] = k;
-          }
-          break;
-        }
-      }
+      effectiveExtent[axis * 2] = std::min(effectiveExtent[axis * 2], localExtent[axis * 2]);
+      effectiveExtent[axis * 2 + 1] = std::max(effectiveExtent[axis * 2 + 1], localExtent[axis * 2 + 1]);
     }
   }
 }
@@ -1409,6 +1523,124 @@ void vtkOrientedImageDataResample::FillImage(vtkImageData* image, double fillVal
   }
 }
 
+//----------------------------------------------------------------------------
+template <class ImageScalarType, class MaskScalarType>
+void ApplyImageMaskGeneric2(vtkOrientedImageData* input, ImageScalarType* outputPtr, vtkOrientedImageData* mask, double fillValue, bool notMask)
+{
+  const int* inputExt = input->GetExtent();
+  ImageRows rows(inputExt, input->GetNumberOfScalarComponents());
+  const int numberOfComponents = rows.NumberOfComponents;
+  const ImageScalarType* inputPtr = static_cast<ImageScalarType*>(input->GetScalarPointer());
+
+  // Voxels outside of the mask extent are treated as if they were outside the mask
+  int maskedExt[6] = { 0, -1, 0, -1, 0, -1 };
+  const MaskScalarType* maskPtr = static_cast<MaskScalarType*>(mask->GetScalarPointer());
+  vtkIdType maskIncrements[3] = { 0, 0, 0 };
+  if (maskPtr)
+  {
+    const int* maskExt = mask->GetExtent();
+    for (int idx = 0; idx < 3; ++idx)
+    {
+      maskedExt[idx * 2] = std::max(inputExt[idx * 2], maskExt[idx * 2]);
+      maskedExt[idx * 2 + 1] = std::min(inputExt[idx * 2 + 1], maskExt[idx * 2 + 1]);
+    }
+    if (maskedExt[0] > maskedExt[1] || maskedExt[2] > maskedExt[3] || maskedExt[4] > maskedExt[5])
+    {
+      // input and mask images don't intersect, the whole input is outside the mask
+      maskedExt[0] = maskedExt[2] = maskedExt[4] = 0;
+      maskedExt[1] = maskedExt[3] = maskedExt[5] = -1;
+    }
+    else
+    {
+      mask->GetIncrements(maskIncrements);
+      maskPtr = static_cast<MaskScalarType*>(mask->GetScalarPointerForExtent(maskedExt));
+    }
+  }
+
+  // Make sure the fill value is valid for the image scalar range
+  ImageScalarType fillValueImageType = 0;
+  if (fillValue < input->GetScalarTypeMin())
+  {
+    fillValueImageType = static_cast<ImageScalarType>(input->GetScalarTypeMin());
+  }
+  else if (fillValue > input->GetScalarTypeMax())
+  {
+    fillValueImageType = static_cast<ImageScalarType>(input->GetScalarTypeMax());
+  }
+  else
+  {
+    fillValueImageType = static_cast<ImageScalarType>(fillValue);
+  }
+
+  vtkIdType inputIncrements[3] = { 0, 0, 0 };
+  input->GetIncrements(inputIncrements);
+  // Output scalars are contiguous
+  const vtkIdType outputIncrements[3] = { numberOfComponents, rows.RowLength, rows.RowLength * rows.NumberOfRowsPerSlice };
+
+  vtkSMPTools::For(0,
+                   rows.NumberOfRows,
+                   [&](vtkIdType beginRow, vtkIdType endRow)
+                   {
+                     for (vtkIdType rowIndex = beginRow; rowIndex < endRow; ++rowIndex)
+                     {
+                       const ImageScalarType* inputRow = inputPtr + rows.GetRowOffset(rowIndex, inputIncrements);
+                       ImageScalarType* outputRow = outputPtr + rows.GetRowOffset(rowIndex, outputIncrements);
+                       const int j = rows.GetJ(rowIndex);
+                       const int k = rows.GetK(rowIndex);
+
+                       // Voxels outside the mask are filled, unless the mask is inverted
+                       if (notMask)
+                       {
+                         std::copy(inputRow, inputRow + rows.RowLength, outputRow);
+                       }
+                       else
+                       {
+                         std::fill(outputRow, outputRow + rows.RowLength, fillValueImageType);
+                       }
+                       if (j < maskedExt[2] || j > maskedExt[3] || k < maskedExt[4] || k > maskedExt[5])
+                       {
+                         continue;
+                       }
+
+                       // Voxels in the mask extent
+                       const MaskScalarType* maskRow =
+                         maskPtr + (j - maskedExt[2]) * maskIncrements[1] + (k - maskedExt[4]) * maskIncrements[2];
+                       const vtkIdType offset = static_cast<vtkIdType>(maskedExt[0] - inputExt[0]) * numberOfComponents;
+                       const int numberOfMaskedVoxels = maskedExt[1] - maskedExt[0] + 1;
+                       if (numberOfComponents == 1 && maskIncrements[0] == 1)
+                       {
+                         for (int i = 0; i < numberOfMaskedVoxels; ++i)
+                         {
+                           outputRow[offset + i] = ((maskRow[i] != 0) == notMask) ? fillValueImageType : inputRow[offset + i];
+                         }
+                       }
+                       else
+                       {
+                         for (int i = 0; i < numberOfMaskedVoxels; ++i)
+                         {
+                           const bool fill = ((maskRow[i * maskIncrements[0]] != 0) == notMask);
+                           for (int c = 0; c < numberOfComponents; ++c)
+                           {
+                             const vtkIdType scalarIndex = offset + i * numberOfComponents + c;
+                             outputRow[scalarIndex] = fill ? fillValueImageType : inputRow[scalarIndex];
+                           }
+                         }
+                       }
+                     }
+                   });
+}
+
+//----------------------------------------------------------------------------
+template <class ImageScalarType>
+void ApplyImageMaskGeneric(vtkOrientedImageData* input, ImageScalarType* outputPtr, vtkOrientedImageData* mask, double fillValue, bool notMask)
+{
+  switch (mask->GetScalarType())
+  {
+    vtkTemplateMacro((ApplyImageMaskGeneric2<ImageScalarType, VTK_TT>(input, outputPtr, mask, fillValue, notMask)));
+    default: vtkGenericWarningMacro("vtkOrientedImageDataResample::ApplyImageMaskGeneric: Unknown ScalarType");
+  }
+}
+
 //-----------------------------------------------------------------------------
 bool vtkOrientedImageDataResample::ApplyImageMask(vtkOrientedImageData* input, vtkOrientedImageData* mask, double fillValue, bool notMask /*=false*/)
 {
@@ -1425,29 +1657,29 @@ bool vtkOrientedImageDataResample::ApplyImageMask(vtkOrientedImageData* input, v
     return false;
   }
 
-  // Make sure mask has the same extent as the input labelmap
-  vtkSmartPointer<vtkImageConstantPad> padder = vtkSmartPointer<vtkImageConstantPad>::New();
-  padder->SetInputData(mask);
-  padder->SetOutputWholeExtent(input->GetExtent());
-  padder->Update();
-  // mask->DeepCopy(padder->GetOutput());
+  vtkDataArray* inputScalars = input->GetPointData() ? input->GetPointData()->GetScalars() : nullptr;
+  if (!inputScalars || !input->GetScalarPointer())
+  {
+    vtkGenericWarningMacro("vtkOrientedImageDataResample::ApplyImageMask failed: input image has no scalars");
+    return false;
+  }
+
+  // Masked voxels are written into a new scalar array (instead of modifying the input scalars in place),
+  // as the input scalars may be shared with other images.
+  vtkSmartPointer<vtkDataArray> maskedScalars = vtkSmartPointer<vtkDataArray>::Take(inputScalars->NewInstance());
+  maskedScalars->SetName(inputScalars->GetName());
+  maskedScalars->SetNumberOfComponents(inputScalars->GetNumberOfComponents());
+  maskedScalars->SetNumberOfTuples(input->GetNumberOfPoints());
 
   // Apply mask
-  vtkNew<vtkImageMask> masker;
-  masker->SetImageInputData(input);
-  // masker->SetMaskInputData(resampledMask);
-  masker->SetMaskInputData(padder->GetOutput());
-  // masker->SetMaskInputData(mask);
-  masker->SetNotMask(notMask);
-  masker->SetMaskedOutputValue(fillValue);
-  masker->Update();
-
-  // Copy masked input to input
-  vtkNew<vtkMatrix4x4> inputImageToWorldMatrix;
-  input->GetImageToWorldMatrix(inputImageToWorldMatrix.GetPointer());
-  input->ShallowCopy(masker->GetOutput());
-  input->SetGeometryFromImageToWorldMatrix(inputImageToWorldMatrix.GetPointer());
+  switch (input->GetScalarType())
+  {
+    vtkTemplateMacro(ApplyImageMaskGeneric<VTK_TT>(input, static_cast<VTK_TT*>(maskedScalars->GetVoidPointer(0)), mask, fillValue, notMask));
+    default: vtkGenericWarningMacro("vtkOrientedImageDataResample::ApplyImageMask failed: unknown ScalarType"); return false;
+  }
 
+  input->GetPointData()->SetScalars(maskedScalars);
+  input->Modified();
   return true;
 }
 
@@ -1489,19 +1721,17 @@ void GetLabelValuesInMaskGeneric2(std::vector<int>& foundValues,
   }
 
   // Get increments to march through data
-  vtkIdType baseIncX = 0;
-  vtkIdType baseIncY = 0;
-  vtkIdType baseIncZ = 0;
-  vtkIdType maskIncX = 0;
-  vtkIdType maskIncY = 0;
-  vtkIdType maskIncZ = 0;
-  binaryLabelmap->GetContinuousIncrements(updateExt, baseIncX, baseIncY, baseIncZ);
-  mask->GetContinuousIncrements(updateExt, maskIncX, maskIncY, maskIncZ);
-  int maxX = (updateExt[1] - updateExt[0]) * binaryLabelmap->GetNumberOfScalarComponents();
-  int maxY = updateExt[3] - updateExt[2];
-  int maxZ = updateExt[5] - updateExt[4];
+  vtkIdType imageIncrements[3] = { 0, 0, 0 };
+  vtkIdType maskIncrements[3] = { 0, 0, 0 };
+  binaryLabelmap->GetIncrements(imageIncrements);
+  mask->GetIncrements(maskIncrements);
+  ImageRows rows(updateExt, binaryLabelmap->GetNumberOfScalarComponents());
   ImageScalarType* binaryLabelmapPointer = static_cast<ImageScalarType*>(binaryLabelmap->GetScalarPointerForExtent(updateExt));
   MaskScalarType* maskPointer = static_cast<MaskScalarType*>(mask->GetScalarPointerForExtent(updateExt));
+  if (!binaryLabelmapPointer || !maskPointer)
+  {
+    return;
+  }
 
   // Make sure the threshold is valid for the modifier scalar range
   MaskScalarType maskThresholdMaskType = 0;
@@ -1518,40 +1748,44 @@ void GetLabelValuesInMaskGeneric2(std::vector<int>& foundValues,
     maskThresholdMaskType = static_cast<MaskScalarType>(maskThreshold);
   }
 
-  int minimumValue = (int)std::numeric_limits<ImageScalarType>::min();
-  int maximumValue = (int)std::numeric_limits<ImageScalarType>::max();
-  int rangeSize = maximumValue - minimumValue;
-
-  // Faster to preallocate a vector of the potential values between the minimum and maximum than to generate unique values using std::set
-  // Not scalable to any scalar range, so the preallocated array method is only used up to the maximum below.
-  size_t maximumSize = 1024 * 1024;
-  if (rangeSize * sizeof(int) <= maximumSize)
-  {
-    std::vector<int> arrayValues(rangeSize, 0);
-    for (vtkIdType idxZ = 0; idxZ <= maxZ; idxZ++)
+  // Rows are processed in parallel, each thread collects the label values it finds, which are then combined.
+  // Rows are only scanned from the first voxel inside the mask, and rows that are completely outside the mask are skipped.
+  // Faster to preallocate a vector of flags for all the potential values than to generate unique values using std::set,
+  // but it is only scalable to small scalar ranges (8 and 16 bit integer label values).
+  if constexpr (std::is_integral<ImageScalarType>::value && sizeof(ImageScalarType) <= 2)
+  {
+    const int minimumValue = static_cast<int>(std::numeric_limits<ImageScalarType>::min());
+    const int maximumValue = static_cast<int>(std::numeric_limits<ImageScalarType>::max());
+    const int numberOfPossibleValues = maximumValue - minimumValue + 1;
+    vtkSMPThreadLocal<std::vector<unsigned char>> localValueFound;
+    vtkSMPTools::For(0,
+                     rows.NumberOfRows,
+                     [&](vtkIdType beginRow, vtkIdType endRow)
+                     {
+                       std::vector<unsigned char>& valueFound = localValueFound.Local();
+                       valueFound.resize(numberOfPossibleValues, 0);
+                       for (vtkIdType rowIndex = beginRow; rowIndex < endRow; ++rowIndex)
+                       {
+                         const ImageScalarType* imageRow = binaryLabelmapPointer + rows.GetRowOffset(rowIndex, imageIncrements);
+                         const MaskScalarType* maskRow = maskPointer + rows.GetRowOffset(rowIndex, maskIncrements);
+                         for (vtkIdType i = FindFirstScalarAboveThreshold(maskRow, 0, rows.RowLength, maskThresholdMaskType); i < rows.RowLength; ++i)
+                         {
+                           valueFound[static_cast<int>(imageRow[i]) - minimumValue] |= (maskRow[i] > maskThresholdMaskType);
+                         }
+                       }
+                     });
+    std::vector<unsigned char> valueFound(numberOfPossibleValues, 0);
+    for (const std::vector<unsigned char>& localFound : localValueFound)
     {
-      for (vtkIdType idxY = 0; idxY <= maxY; idxY++)
+      for (size_t index = 0; index < localFound.size(); ++index)
       {
-        for (vtkIdType idxX = 0; idxX <= maxX; idxX++)
-        {
-          if ((*maskPointer) > maskThresholdMaskType)
-          {
-            int value = static_cast<int>(*binaryLabelmapPointer);
-            int index = value - minimumValue;
-            arrayValues[index] = value;
-          }
-          binaryLabelmapPointer++;
-          maskPointer++;
-        }
-        binaryLabelmapPointer += baseIncY;
-        maskPointer += maskIncY;
+        valueFound[index] |= localFound[index];
       }
-      binaryLabelmapPointer += baseIncZ;
-      maskPointer += maskIncZ;
     }
-    for (int value : arrayValues)
+    for (int index = 0; index < numberOfPossibleValues; ++index)
     {
-      if (value != 0)
+      int value = index + minimumValue;
+      if (valueFound[index] && value != 0)
       {
         foundValues.push_back(value);
       }
@@ -1559,26 +1793,29 @@ void GetLabelValuesInMaskGeneric2(std::vector<int>& foundValues,
   }
   else
   {
+    vtkSMPThreadLocal<std::set<int>> localSetValues;
+    vtkSMPTools::For(0,
+                     rows.NumberOfRows,
+                     [&](vtkIdType beginRow, vtkIdType endRow)
+                     {
+                       std::set<int>& setValues = localSetValues.Local();
+                       for (vtkIdType rowIndex = beginRow; rowIndex < endRow; ++rowIndex)
+                       {
+                         const ImageScalarType* imageRow = binaryLabelmapPointer + rows.GetRowOffset(rowIndex, imageIncrements);
+                         const MaskScalarType* maskRow = maskPointer + rows.GetRowOffset(rowIndex, maskIncrements);
+                         for (vtkIdType i = FindFirstScalarAboveThreshold(maskRow, 0, rows.RowLength, maskThresholdMaskType); i < rows.RowLength; ++i)
+                         {
+                           if (maskRow[i] > maskThresholdMaskType)
+                           {
+                             setValues.insert(static_cast<int>(imageRow[i]));
+                           }
+                         }
+                       }
+                     });
     std::set<int> setValues;
-    for (vtkIdType idxZ = 0; idxZ <= maxZ; idxZ++)
+    for (const std::set<int>& localValues : localSetValues)
     {
-      for (vtkIdType idxY = 0; idxY <= maxY; idxY++)
-      {
-        for (vtkIdType idxX = 0; idxX <= maxX; idxX++)
-        {
-          if ((*maskPointer) > maskThresholdMaskType)
-          {
-            int value = static_cast<int>(*binaryLabelmapPointer);
-            setValues.insert(value);
-          }
-          binaryLabelmapPointer++;
-          maskPointer++;
-        }
-        binaryLabelmapPointer += baseIncY;
-        maskPointer += maskIncY;
-      }
-      binaryLabelmapPointer += baseIncZ;
-      maskPointer += maskIncZ;
+      setValues.insert(localValues.begin(), localValues.end());
     }
     for (int value : setValues)
     {
@@ -186,6 +186,8 @@ public:
   /// \param notMask If on, the mask is passed through a boolean not before it is used to mask the image.
   ///   The effect is to pass the input pixels where the mask is zero, and replace the pixels where the
   ///   mask is non zero
+  /// Input voxels outside the mask extent are considered to be outside the mask.
+  /// The scalar array of the input image is replaced by a new array, so arrays shared with other images are not modified.
   static bool ApplyImageMask(vtkOrientedImageData* input, vtkOrientedImageData* mask, double fillValue, bool notMask = false);
 
   /// Get the values contained in the labelmap under the mask
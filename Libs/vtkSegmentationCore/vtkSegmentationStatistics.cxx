@@ -0,0 +1,899 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// SegmentationCore includes
+#include "vtkSegmentationStatistics.h"
+#include "vtkOrientedImageData.h"
+#include "vtkOrientedImageDataResample.h"
+#include "vtkSegment.h"
+#include "vtkSegmentation.h"
+#include "vtkSegmentationConverter.h"
+
+// VTK includes
+#include <vtkAbstractTransform.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+#include <vtkStringArray.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkSegmentationStatistics);
+vtkCxxSetObjectMacro(vtkSegmentationStatistics, Segmentation, vtkSegmentation);
+vtkCxxSetObjectMacro(vtkSegmentationStatistics, ScalarVolume, vtkOrientedImageData);
+vtkCxxSetObjectMacro(vtkSegmentationStatistics, SegmentationToScalarVolumeTransform, vtkAbstractTransform);
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Labelmap layer with a lookup table from label value to segment index.
+struct LayerImage
+{
+  vtkSmartPointer<vtkOrientedImageData> Image;
+  int Extent[6];
+  vtkIdType Increments[3];
+  void* Base{ nullptr };
+  int ScalarType{ VTK_UNSIGNED_CHAR };
+  long long MinimumLabel{ 0 };
+  /// Segment index for each label value starting from MinimumLabel (-1 if the label is not a requested segment)
+  std::vector<int> LabelToSegmentIndex;
+
+  //----------------------------------------------------------------------------
+  void SetImage(vtkOrientedImageData* image)
+  {
+    this->Image = image;
+    image->GetExtent(this->Extent);
+    image->GetIncrements(this->Increments);
+    this->Base = image->GetScalarPointerForExtent(this->Extent);
+    this->ScalarType = image->GetScalarType();
+  }
+
+  //----------------------------------------------------------------------------
+  bool Contains(int y, int z) const { return y >= this->Extent[2] && y <= this->Extent[3] && z >= this->Extent[4] && z <= this->Extent[5]; }
+
+  //----------------------------------------------------------------------------
+  template <class T>
+  void GetSegmentIndicesTemplate(const T* labels, int count, int* segmentIndices) const
+  {
+    const long long numberOfLabels = static_cast<long long>(this->LabelToSegmentIndex.size());
+    for (int i = 0; i < count; ++i)
+    {
+      long long labelIndex = static_cast<long long>(labels[i]) - this->MinimumLabel;
+      segmentIndices[i] = (labelIndex >= 0 && labelIndex < numberOfLabels ? this->LabelToSegmentIndex[labelIndex] : -1);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  /// Get segment index of voxels in a row (x0..x1, y, z). Voxels outside the layer extent get -1.
+  void GetSegmentIndices(int x0, int x1, int y, int z, int* segmentIndices) const
+  {
+    int count = x1 - x0 + 1;
+    std::fill(segmentIndices, segmentIndices + count, -1);
+    int xMin = std::max(x0, this->Extent[0]);
+    int xMax = std::min(x1, this->Extent[1]);
+    if (!this->Contains(y, z) || xMin > xMax)
+    {
+      return;
+    }
+    vtkIdType offset = (xMin - this->Extent[0]) * this->Increments[0] //
+                       + (y - this->Extent[2]) * this->Increments[1] //
+                       + (z - this->Extent[4]) * this->Increments[2];
+    switch (this->ScalarType)
+    {
+      vtkTemplateMacro(this->GetSegmentIndicesTemplate(static_cast<VTK_TT*>(this->Base) + offset, xMax - xMin + 1, segmentIndices + (xMin - x0)));
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+struct LabelAccumulator
+{
+  vtkIdType Count{ 0 };
+  /// Sum of voxel indices (relative to extent start)
+  double Sum[3]{ 0.0, 0.0, 0.0 };
+  /// Sum of products of voxel indices: ii, jj, kk, ij, ik, jk
+  double SumProducts[6]{ 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+};
+
+//----------------------------------------------------------------------------
+struct ScalarAccumulator
+{
+  vtkIdType Count{ 0 };
+  double Sum{ 0.0 };
+  double SumSquares{ 0.0 };
+  double Minimum{ VTK_DOUBLE_MAX };
+  double Maximum{ VTK_DOUBLE_MIN };
+  std::vector<unsigned int> Histogram;
+};
+
+//----------------------------------------------------------------------------
+// Histogram bins of a segment, covering the voxel value range of that segment only.
+struct HistogramRange
+{
+  double Origin{ 0.0 };
+  double BinSpacing{ 1.0 };
+  int NumberOfBins{ 0 };
+};
+
+//----------------------------------------------------------------------------
+// Accumulate voxel counts and index moments of all segments of a layer.
+struct LabelmapStatisticsFunctor
+{
+  const LayerImage* Layer{ nullptr };
+  int NumberOfSegments{ 0 };
+  bool ComputeShape{ false };
+
+  vtkSMPThreadLocal<std::vector<LabelAccumulator>> Accumulators;
+  vtkSMPThreadLocal<std::vector<int>> RowSegmentIndices;
+
+  void Initialize()
+  {
+    this->Accumulators.Local().assign(this->NumberOfSegments, LabelAccumulator());
+    this->RowSegmentIndices.Local().resize(this->Layer->Extent[1] - this->Layer->Extent[0] + 1);
+  }
+
+  void operator()(vtkIdType beginZ, vtkIdType endZ)
+  {
+    std::vector<LabelAccumulator>& accumulators = this->Accumulators.Local();
+    std::vector<int>& rowSegmentIndices = this->RowSegmentIndices.Local();
+    const int* extent = this->Layer->Extent;
+    const int rowLength = extent[1] - extent[0] + 1;
+    for (int z = static_cast<int>(beginZ); z < static_cast<int>(endZ); ++z)
+    {
+      const double k = z - extent[4];
+      for (int y = extent[2]; y <= extent[3]; ++y)
+      {
+        const double j = y - extent[2];
+        this->Layer->GetSegmentIndices(extent[0], extent[1], y, z, rowSegmentIndices.data());
+        for (int x = 0; x < rowLength; ++x)
+        {
+          int segmentIndex = rowSegmentIndices[x];
+          if (segmentIndex < 0)
+          {
+            continue;
+          }
+          LabelAccumulator& accumulator = accumulators[segmentIndex];
+          accumulator.Count++;
+          if (this->ComputeShape)
+          {
+            const double i = x;
+            accumulator.Sum[0] += i;
+            accumulator.Sum[1] += j;
+            accumulator.Sum[2] += k;
+            accumulator.SumProducts[0] += i * i;
+            accumulator.SumProducts[1] += j * j;
+            accumulator.SumProducts[2] += k * k;
+            accumulator.SumProducts[3] += i * j;
+            accumulator.SumProducts[4] += i * k;
+            accumulator.SumProducts[5] += j * k;
+          }
+        }
+      }
+    }
+  }
+
+  void Reduce() {}
+};
+
+//----------------------------------------------------------------------------
+template <class T>
+void ReadRowAsDouble(const T* values, int count, int numberOfComponents, double* output)
+{
+  for (int i = 0; i < count; ++i)
+  {
+    output[i] = static_cast<double>(values[i * numberOfComponents]);
+  }
+}
+
+//----------------------------------------------------------------------------
+// Accumulate voxel value statistics of all segments in one traversal of the scalar volume.
+// If histogram ranges are set then only the histograms of the segments are accumulated.
+// Histograms are allocated only for the segments that the thread encounters.
+struct ScalarStatisticsFunctor
+{
+  vtkImageData* Scalars{ nullptr };
+  int Extent[6];
+  const std::vector<LayerImage>* Layers{ nullptr };
+  int NumberOfSegments{ 0 };
+  const std::vector<HistogramRange>* HistogramRanges{ nullptr };
+
+  vtkSMPThreadLocal<std::vector<ScalarAccumulator>> Accumulators;
+  vtkSMPThreadLocal<std::vector<int>> RowSegmentIndices;
+  vtkSMPThreadLocal<std::vector<double>> RowValues;
+
+  void Initialize()
+  {
+    this->Accumulators.Local().assign(this->NumberOfSegments, ScalarAccumulator());
+    this->RowSegmentIndices.Local().resize(this->Extent[1] - this->Extent[0] + 1);
+    this->RowValues.Local().resize(this->Extent[1] - this->Extent[0] + 1);
+  }
+
+  void operator()(vtkIdType beginZ, vtkIdType endZ)
+  {
+    std::vector<ScalarAccumulator>& accumulators = this->Accumulators.Local();
+    std::vector<int>& rowSegmentIndices = this->RowSegmentIndices.Local();
+    std::vector<double>& rowValues = this->RowValues.Local();
+    const int rowLength = this->Extent[1] - this->Extent[0] + 1;
+    const int numberOfComponents = this->Scalars->GetNumberOfScalarComponents();
+    for (int z = static_cast<int>(beginZ); z < static_cast<int>(endZ); ++z)
+    {
+      for (int y = this->Extent[2]; y <= this->Extent[3]; ++y)
+      {
+        bool rowValuesRead = false;
+        for (const LayerImage& layer : *this->Layers)
+        {
+          if (!layer.Contains(y, z))
+          {
+            continue;
+          }
+          layer.GetSegmentIndices(this->Extent[0], this->Extent[1], y, z, rowSegmentIndices.data());
+          for (int x = 0; x < rowLength; ++x)
+          {
+            int segmentIndex = rowSegmentIndices[x];
+            if (segmentIndex < 0)
+            {
+              continue;
+            }
+            if (!rowValuesRead)
+            {
+              void* rowPointer = this->Scalars->GetScalarPointer(this->Extent[0], y, z);
+              switch (this->Scalars->GetScalarType())
+              {
+                vtkTemplateMacro(ReadRowAsDouble(static_cast<VTK_TT*>(rowPointer), rowLength, numberOfComponents, rowValues.data()));
+              }
+              rowValuesRead = true;
+            }
+            const double value = rowValues[x];
+            ScalarAccumulator& accumulator = accumulators[segmentIndex];
+            if (this->HistogramRanges)
+            {
+              const HistogramRange& range = (*this->HistogramRanges)[segmentIndex];
+              if (accumulator.Histogram.empty())
+              {
+                accumulator.Histogram.resize(range.NumberOfBins, 0);
+              }
+              int bin = static_cast<int>(std::floor((value - range.Origin) / range.BinSpacing + 0.5));
+              accumulator.Histogram[std::min(std::max(bin, 0), range.NumberOfBins - 1)]++;
+              continue;
+            }
+            accumulator.Count++;
+            accumulator.Sum += value;
+            accumulator.SumSquares += value * value;
+            accumulator.Minimum = std::min(accumulator.Minimum, value);
+            accumulator.Maximum = std::max(accumulator.Maximum, value);
+          }
+        }
+      }
+    }
+  }
+
+  void Reduce() {}
+};
+
+} // namespace
+
+//----------------------------------------------------------------------------
+class vtkSegmentationStatistics::vtkInternal
+{
+public:
+  struct SegmentStatistics
+  {
+    bool LabelmapValid{ false };
+    vtkIdType VoxelCount{ 0 };
+    double VolumeMm3{ 0.0 };
+
+    bool ShapeValid{ false };
+    double Centroid[3]{ 0.0, 0.0, 0.0 };
+    double PrincipalMoments[3]{ 0.0, 0.0, 0.0 };
+    double PrincipalAxes[3][3]{ { 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 } };
+
+    bool ScalarValid{ false };
+    vtkIdType ScalarVoxelCount{ 0 };
+    double ScalarVolumeMm3{ 0.0 };
+    double Minimum{ 0.0 };
+    double Maximum{ 0.0 };
+    double Mean{ 0.0 };
+    double StandardDeviation{ 0.0 };
+    std::vector<vtkIdType> Histogram;
+    double HistogramOrigin{ 0.0 };
+    double HistogramBinSpacing{ 1.0 };
+  };
+
+  std::map<std::string, SegmentStatistics> Statistics;
+
+  //----------------------------------------------------------------------------
+  SegmentStatistics* GetStatistics(const std::string& segmentId)
+  {
+    auto statisticsIt = this->Statistics.find(segmentId);
+    return (statisticsIt != this->Statistics.end() ? &statisticsIt->second : nullptr);
+  }
+};
+
+//----------------------------------------------------------------------------
+vtkSegmentationStatistics::vtkSegmentationStatistics()
+{
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkSegmentationStatistics::~vtkSegmentationStatistics()
+{
+  this->SetSegmentation(nullptr);
+  this->SetScalarVolume(nullptr);
+  this->SetSegmentationToScalarVolumeTransform(nullptr);
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkSegmentationStatistics::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Segmentation: " << this->Segmentation << "\n";
+  os << indent << "ScalarVolume: " << this->ScalarVolume << "\n";
+  os << indent << "SegmentationToScalarVolumeTransform: " << this->SegmentationToScalarVolumeTransform << "\n";
+  os << indent << "NumberOfSegmentIDs: " << this->SegmentIDs.size() << "\n";
+  os << indent << "ComputeShapeStatistics: " << (this->ComputeShapeStatistics ? "true" : "false") << "\n";
+  os << indent << "ComputeScalarPercentiles: " << (this->ComputeScalarPercentiles ? "true" : "false") << "\n";
+  os << indent << "MaximumNumberOfHistogramBins: " << this->MaximumNumberOfHistogramBins << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkSegmentationStatistics::AddSegmentID(const std::string& segmentId)
+{
+  this->SegmentIDs.push_back(segmentId);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkSegmentationStatistics::SetSegmentIDs(vtkStringArray* segmentIds)
+{
+  this->SegmentIDs.clear();
+  if (segmentIds)
+  {
+    for (vtkIdType index = 0; index < segmentIds->GetNumberOfValues(); ++index)
+    {
+      this->SegmentIDs.push_back(segmentIds->GetValue(index));
+    }
+  }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkSegmentationStatistics::RemoveAllSegmentIDs()
+{
+  this->SegmentIDs.clear();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkSegmentationStatistics::ClearStatistics()
+{
+  this->Internal->Statistics.clear();
+}
+
+//----------------------------------------------------------------------------
+bool vtkSegmentationStatistics::Compute()
+{
+  this->ClearStatistics();
+  if (!this->Segmentation)
+  {
+    vtkErrorMacro("Compute: Invalid segmentation");
+    return false;
+  }
+
+  std::vector<std::string> segmentIds = this->SegmentIDs;
+  if (segmentIds.empty())
+  {
+    this->Segmentation->GetSegmentIDs(segmentIds);
+  }
+
+  // Group segments by labelmap layer
+  std::vector<vtkOrientedImageData*> layerImages;
+  std::vector<std::vector<std::string>> layerSegmentIds;
+  for (const std::string& segmentId : segmentIds)
+  {
+    vtkSegment* segment = this->Segmentation->GetSegment(segmentId);
+    vtkOrientedImageData* labelmap = nullptr;
+    if (segment)
+    {
+      labelmap = vtkOrientedImageData::SafeDownCast(segment->GetRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName()));
+    }
+    if (!labelmap || !labelmap->GetPointData() || !labelmap->GetPointData()->GetScalars())
+    {
+      vtkDebugMacro("Compute: No binary labelmap representation for segment " << segmentId);
+      continue;
+    }
+    if (this->Internal->Statistics.count(segmentId))
+    {
+      // duplicate segment ID
+      continue;
+    }
+    this->Internal->Statistics[segmentId] = vtkInternal::SegmentStatistics();
+    auto layerIt = std::find(layerImages.begin(), layerImages.end(), labelmap);
+    if (layerIt == layerImages.end())
+    {
+      layerImages.push_back(labelmap);
+      layerSegmentIds.emplace_back();
+      layerIt = layerImages.end() - 1;
+    }
+    layerSegmentIds[layerIt - layerImages.begin()].push_back(segmentId);
+  }
+
+  // Labelmap statistics: one traversal of each layer
+  std::vector<LayerImage> layers(layerImages.size());
+  for (size_t layerIndex = 0; layerIndex < layerImages.size(); ++layerIndex)
+  {
+    LayerImage& layer = layers[layerIndex];
+    layer.SetImage(layerImages[layerIndex]);
+
+    // Lookup table from label value to segment index
+    long long minimumLabel = std::numeric_limits<long long>::max();
+    long long maximumLabel = std::numeric_limits<long long>::min();
+    for (const std::string& segmentId : layerSegmentIds[layerIndex])
+    {
+      long long labelValue = this->Segmentation->GetSegment(segmentId)->GetLabelValue();
+      minimumLabel = std::min(minimumLabel, labelValue);
+      maximumLabel = std::max(maximumLabel, labelValue);
+    }
+    layer.MinimumLabel = minimumLabel;
+    layer.LabelToSegmentIndex.assign(static_cast<size_t>(maximumLabel - minimumLabel + 1), -1);
+    for (size_t segmentIndex = 0; segmentIndex < layerSegmentIds[layerIndex].size(); ++segmentIndex)
+    {
+      long long labelValue = this->Segmentation->GetSegment(layerSegmentIds[layerIndex][segmentIndex])->GetLabelValue();
+      layer.LabelToSegmentIndex[labelValue - minimumLabel] = static_cast<int>(segmentIndex);
+    }
+
+    const int numberOfSegments = static_cast<int>(layerSegmentIds[layerIndex].size());
+    std::vector<LabelAccumulator> accumulators(numberOfSegments);
+    if (layer.Extent[0] <= layer.Extent[1] && layer.Extent[2] <= layer.Extent[3] && layer.Extent[4] <= layer.Extent[5])
+    {
+      LabelmapStatisticsFunctor functor;
+      functor.Layer = &layer;
+      functor.NumberOfSegments = numberOfSegments;
+      functor.ComputeShape = this->ComputeShapeStatistics;
+      vtkSMPTools::For(layer.Extent[4], layer.Extent[5] + 1, functor);
+      for (const std::vector<LabelAccumulator>& threadAccumulators : functor.Accumulators)
+      {
+        for (int segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+        {
+          const LabelAccumulator& threadAccumulator = threadAccumulators[segmentIndex];
+          LabelAccumulator& accumulator = accumulators[segmentIndex];
+          accumulator.Count += threadAccumulator.Count;
+          for (int i = 0; i < 3; ++i)
+          {
+            accumulator.Sum[i] += threadAccumulator.Sum[i];
+          }
+          for (int i = 0; i < 6; ++i)
+          {
+            accumulator.SumProducts[i] += threadAccumulator.SumProducts[i];
+          }
+        }
+      }
+    }
+
+    double spacing[3] = { 1.0, 1.0, 1.0 };
+    layer.Image->GetSpacing(spacing);
+    const double voxelVolume = spacing[0] * spacing[1] * spacing[2];
+    vtkNew<vtkMatrix4x4> imageToWorld;
+    layer.Image->GetImageToWorldMatrix(imageToWorld);
+    for (int segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+    {
+      const LabelAccumulator& accumulator = accumulators[segmentIndex];
+      vtkInternal::SegmentStatistics& statistics = this->Internal->Statistics[layerSegmentIds[layerIndex][segmentIndex]];
+      statistics.LabelmapValid = true;
+      statistics.VoxelCount = accumulator.Count;
+      statistics.VolumeMm3 = accumulator.Count * voxelVolume;
+      if (!this->ComputeShapeStatistics || accumulator.Count == 0)
+      {
+        continue;
+      }
+
+      // Centroid and covariance of voxel positions in IJK coordinates
+      const double count = static_cast<double>(accumulator.Count);
+      double meanIjk[3];
+      for (int i = 0; i < 3; ++i)
+      {
+        meanIjk[i] = accumulator.Sum[i] / count;
+      }
+      const int productIndex[3][3] = { { 0, 3, 4 }, { 3, 1, 5 }, { 4, 5, 2 } };
+      double covarianceIjk[3][3];
+      for (int i = 0; i < 3; ++i)
+      {
+        for (int j = 0; j < 3; ++j)
+        {
+          covarianceIjk[i][j] = accumulator.SumProducts[productIndex[i][j]] / count - meanIjk[i] * meanIjk[j];
+        }
+      }
+
+      // Transform to world coordinates
+      double centroidIjk[4] = { meanIjk[0] + layer.Extent[0], meanIjk[1] + layer.Extent[2], meanIjk[2] + layer.Extent[4], 1.0 };
+      double centroidWorld[4] = { 0.0, 0.0, 0.0, 1.0 };
+      imageToWorld->MultiplyPoint(centroidIjk, centroidWorld);
+      double rotation[3][3];
+      for (int i = 0; i < 3; ++i)
+      {
+        statistics.Centroid[i] = centroidWorld[i];
+        for (int j = 0; j < 3; ++j)
+        {
+          rotation[i][j] = imageToWorld->GetElement(i, j);
+        }
+      }
+      double temp[3][3];
+      double covarianceWorld[3][3];
+      vtkMath::Multiply3x3(rotation, covarianceIjk, temp);
+      double rotationTransposed[3][3];
+      vtkMath::Transpose3x3(rotation, rotationTransposed);
+      vtkMath::Multiply3x3(temp, rotationTransposed, covarianceWorld);
+
+      // Principal moments and axes (eigenvalues are returned in decreasing order)
+      double* covarianceRows[3] = { covarianceWorld[0], covarianceWorld[1], covarianceWorld[2] };
+      double eigenvalues[3];
+      double eigenvectorRows[3][3];
+      double* eigenvectors[3] = { eigenvectorRows[0], eigenvectorRows[1], eigenvectorRows[2] };
+      vtkMath::Jacobi(covarianceRows, eigenvalues, eigenvectors);
+      for (int axisIndex = 0; axisIndex < 3; ++axisIndex)
+      {
+        statistics.PrincipalMoments[axisIndex] = std::max(eigenvalues[2 - axisIndex], 0.0);
+        for (int i = 0; i < 3; ++i)
+        {
+          statistics.PrincipalAxes[axisIndex][i] = eigenvectors[i][2 - axisIndex];
+        }
+      }
+      statistics.ShapeValid = true;
+    }
+  }
+
+  // Scalar volume statistics: one traversal of the scalar volume for all layers
+  if (this->ScalarVolume && this->ScalarVolume->GetPointData() && this->ScalarVolume->GetPointData()->GetScalars() && !layers.empty())
+  {
+    std::vector<LayerImage> resampledLayers(layers.size());
+    for (size_t layerIndex = 0; layerIndex < layers.size(); ++layerIndex)
+    {
+      vtkOrientedImageData* layerImage = layers[layerIndex].Image;
+      if (this->SegmentationToScalarVolumeTransform || !vtkOrientedImageDataResample::DoGeometriesMatch(layerImage, this->ScalarVolume))
+      {
+        vtkNew<vtkOrientedImageData> resampledLayerImage;
+        if (!vtkOrientedImageDataResample::ResampleOrientedImageToReferenceOrientedImage(
+              layerImage, this->ScalarVolume, resampledLayerImage, false, false, this->SegmentationToScalarVolumeTransform))
+        {
+          vtkErrorMacro("Compute: Failed to resample labelmap layer to scalar volume geometry");
+          continue;
+        }
+        resampledLayers[layerIndex].SetImage(resampledLayerImage);
+      }
+      else
+      {
+        resampledLayers[layerIndex].SetImage(layerImage);
+      }
+      resampledLayers[layerIndex].MinimumLabel = layers[layerIndex].MinimumLabel;
+      resampledLayers[layerIndex].LabelToSegmentIndex = layers[layerIndex].LabelToSegmentIndex;
+    }
+
+    // Segment indices are unique across layers in the scalar pass
+    std::vector<std::string> scalarSegmentIds;
+    for (size_t layerIndex = 0; layerIndex < resampledLayers.size(); ++layerIndex)
+    {
+      for (int& segmentIndex : resampledLayers[layerIndex].LabelToSegmentIndex)
+      {
+        if (segmentIndex >= 0)
+        {
+          segmentIndex += static_cast<int>(scalarSegmentIds.size());
+        }
+      }
+      scalarSegmentIds.insert(scalarSegmentIds.end(), layerSegmentIds[layerIndex].begin(), layerSegmentIds[layerIndex].end());
+    }
+    // Layers that could not be resampled are not used
+    resampledLayers.erase(std::remove_if(resampledLayers.begin(), resampledLayers.end(), [](const LayerImage& layer) { return layer.Image == nullptr; }), resampledLayers.end());
+
+    ScalarStatisticsFunctor functor;
+    functor.Scalars = this->ScalarVolume;
+    this->ScalarVolume->GetExtent(functor.Extent);
+    functor.Layers = &resampledLayers;
+    functor.NumberOfSegments = static_cast<int>(scalarSegmentIds.size());
+    const bool validExtent = (functor.Extent[0] <= functor.Extent[1] && functor.Extent[2] <= functor.Extent[3] && functor.Extent[4] <= functor.Extent[5]);
+    if (validExtent)
+    {
+      vtkSMPTools::For(functor.Extent[4], functor.Extent[5] + 1, functor);
+    }
+
+    double spacing[3] = { 1.0, 1.0, 1.0 };
+    this->ScalarVolume->GetSpacing(spacing);
+    const double voxelVolume = spacing[0] * spacing[1] * spacing[2];
+    for (int segmentIndex = 0; segmentIndex < functor.NumberOfSegments; ++segmentIndex)
+    {
+      ScalarAccumulator accumulator;
+      for (std::vector<ScalarAccumulator>& threadAccumulators : functor.Accumulators)
+      {
+        const ScalarAccumulator& threadAccumulator = threadAccumulators[segmentIndex];
+        accumulator.Count += threadAccumulator.Count;
+        accumulator.Sum += threadAccumulator.Sum;
+        accumulator.SumSquares += threadAccumulator.SumSquares;
+        accumulator.Minimum = std::min(accumulator.Minimum, threadAccumulator.Minimum);
+        accumulator.Maximum = std::max(accumulator.Maximum, threadAccumulator.Maximum);
+      }
+      vtkInternal::SegmentStatistics& statistics = this->Internal->Statistics[scalarSegmentIds[segmentIndex]];
+      statistics.ScalarValid = true;
+      statistics.ScalarVoxelCount = accumulator.Count;
+      statistics.ScalarVolumeMm3 = accumulator.Count * voxelVolume;
+      if (accumulator.Count > 0)
+      {
+        const double count = static_cast<double>(accumulator.Count);
+        statistics.Minimum = accumulator.Minimum;
+        statistics.Maximum = accumulator.Maximum;
+        statistics.Mean = accumulator.Sum / count;
+        // sample standard deviation, as in vtkImageAccumulate
+        double variance = (accumulator.Count > 1 ? (accumulator.SumSquares - accumulator.Sum * accumulator.Sum / count) / (count - 1.0) : 0.0);
+        statistics.StandardDeviation = std::sqrt(std::max(variance, 0.0));
+      }
+    }
+
+    // Histograms for percentiles: a second traversal, now that the voxel value range of each segment is known.
+    // Bins cover only the value range of the segment, which keeps the per-thread histograms small.
+    if (this->ComputeScalarPercentiles && validExtent)
+    {
+      const int scalarType = this->ScalarVolume->GetScalarType();
+      const bool integerScalars = (scalarType != VTK_FLOAT && scalarType != VTK_DOUBLE);
+      std::vector<HistogramRange> histogramRanges(scalarSegmentIds.size());
+      for (int segmentIndex = 0; segmentIndex < functor.NumberOfSegments; ++segmentIndex)
+      {
+        const vtkInternal::SegmentStatistics& statistics = this->Internal->Statistics[scalarSegmentIds[segmentIndex]];
+        if (statistics.ScalarVoxelCount == 0)
+        {
+          continue;
+        }
+        HistogramRange& range = histogramRanges[segmentIndex];
+        const double rangeWidth = statistics.Maximum - statistics.Minimum;
+        range.Origin = statistics.Minimum;
+        if (rangeWidth <= 0.0)
+        {
+          range.NumberOfBins = 1;
+        }
+        else if (integerScalars && rangeWidth + 1 <= this->MaximumNumberOfHistogramBins)
+        {
+          // integer voxel values: one bin per value, percentiles are exact
+          range.NumberOfBins = static_cast<int>(rangeWidth) + 1;
+        }
+        else
+        {
+          range.NumberOfBins = this->MaximumNumberOfHistogramBins;
+          range.BinSpacing = rangeWidth / (this->MaximumNumberOfHistogramBins - 1);
+        }
+      }
+
+      ScalarStatisticsFunctor histogramFunctor;
+      histogramFunctor.Scalars = this->ScalarVolume;
+      std::copy(functor.Extent, functor.Extent + 6, histogramFunctor.Extent);
+      histogramFunctor.Layers = &resampledLayers;
+      histogramFunctor.NumberOfSegments = functor.NumberOfSegments;
+      histogramFunctor.HistogramRanges = &histogramRanges;
+      vtkSMPTools::For(histogramFunctor.Extent[4], histogramFunctor.Extent[5] + 1, histogramFunctor);
+
+      for (int segmentIndex = 0; segmentIndex < histogramFunctor.NumberOfSegments; ++segmentIndex)
+      {
+        const HistogramRange& range = histogramRanges[segmentIndex];
+        if (range.NumberOfBins == 0)
+        {
+          continue;
+        }
+        vtkInternal::SegmentStatistics& statistics = this->Internal->Statistics[scalarSegmentIds[segmentIndex]];
+        statistics.Histogram.assign(range.NumberOfBins, 0);
+        statistics.HistogramOrigin = range.Origin;
+        statistics.HistogramBinSpacing = range.BinSpacing;
+        for (std::vector<ScalarAccumulator>& threadAccumulators : histogramFunctor.Accumulators)
+        {
+          const std::vector<unsigned int>& threadHistogram = threadAccumulators[segmentIndex].Histogram;
+          for (size_t bin = 0; bin < threadHistogram.size(); ++bin)
+          {
+            statistics.Histogram[bin] += threadHistogram[bin];
+          }
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSegmentationStatistics::HasLabelmapStatistics(const std::string& segmentId)
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetStatistics(segmentId);
+  return statistics && statistics->LabelmapValid;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkSegmentationStatistics::GetVoxelCount(const std::string& segmentId)
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetStatistics(segmentId);
+  return statistics ? statistics->VoxelCount : 0;
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentationStatistics::GetVolumeMm3(const std::string& segmentId)
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetStatistics(segmentId);
+  return statistics ? statistics->VolumeMm3 : 0.0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSegmentationStatistics::HasShapeStatistics(const std::string& segmentId)
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetStatistics(segmentId);
+  return statistics && statistics->ShapeValid;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSegmentationStatistics::GetCentroid(const std::string& segmentId, double centroid[3])
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetStatistics(segmentId);
+  if (!statistics || !statistics->ShapeValid)
+  {
+    return false;
+  }
+  for (int i = 0; i < 3; ++i)
+  {
+    centroid[i] = statistics->Centroid[i];
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSegmentationStatistics::GetPrincipalMoments(const std::string& segmentId, double moments[3])
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetStatistics(segmentId);
+  if (!statistics || !statistics->ShapeValid)
+  {
+    return false;
+  }
+  for (int i = 0; i < 3; ++i)
+  {
+    moments[i] = statistics->PrincipalMoments[i];
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSegmentationStatistics::GetPrincipalAxis(const std::string& segmentId, int axisIndex, double axis[3])
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetStatistics(segmentId);
+  if (!statistics || !statistics->ShapeValid || axisIndex < 0 || axisIndex > 2)
+  {
+    return false;
+  }
+  for (int i = 0; i < 3; ++i)
+  {
+    axis[i] = statistics->PrincipalAxes[axisIndex][i];
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentationStatistics::GetElongation(const std::string& segmentId)
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetStatistics(segmentId);
+  if (!statistics || !statistics->ShapeValid || statistics->PrincipalMoments[1] <= 0.0)
+  {
+    return 0.0;
+  }
+  return std::sqrt(statistics->PrincipalMoments[2] / statistics->PrincipalMoments[1]);
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentationStatistics::GetFlatness(const std::string& segmentId)
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetStatistics(segmentId);
+  if (!statistics || !statistics->ShapeValid || statistics->PrincipalMoments[0] <= 0.0)
+  {
+    return 0.0;
+  }
+  return std::sqrt(statistics->PrincipalMoments[1] / statistics->PrincipalMoments[0]);
+}
+
+//----------------------------------------------------------------------------
+bool vtkSegmentationStatistics::HasScalarStatistics(const std::string& segmentId)
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetStatistics(segmentId);
+  return statistics && statistics->ScalarValid;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkSegmentationStatistics::GetScalarVoxelCount(const std::string& segmentId)
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetStatistics(segmentId);
+  return statistics ? statistics->ScalarVoxelCount : 0;
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentationStatistics::GetScalarVolumeMm3(const std::string& segmentId)
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetStatistics(segmentId);
+  return statistics ? statistics->ScalarVolumeMm3 : 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentationStatistics::GetScalarMinimum(const std::string& segmentId)
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetStatistics(segmentId);
+  return statistics ? statistics->Minimum : 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentationStatistics::GetScalarMaximum(const std::string& segmentId)
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetStatistics(segmentId);
+  return statistics ? statistics->Maximum : 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentationStatistics::GetScalarMean(const std::string& segmentId)
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetStatistics(segmentId);
+  return statistics ? statistics->Mean : 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentationStatistics::GetScalarStandardDeviation(const std::string& segmentId)
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetStatistics(segmentId);
+  return statistics ? statistics->StandardDeviation : 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentationStatistics::GetScalarMedian(const std::string& segmentId)
+{
+  return this->GetScalarPercentile(segmentId, 50.0);
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentationStatistics::GetScalarPercentile(const std::string& segmentId, double percent)
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetStatistics(segmentId);
+  if (!statistics || !statistics->ScalarValid || statistics->ScalarVoxelCount == 0)
+  {
+    return 0.0;
+  }
+  if (statistics->Histogram.empty())
+  {
+    vtkErrorMacro("GetScalarPercentile: Percentiles are not computed, enable ComputeScalarPercentiles");
+    return 0.0;
+  }
+  // Nearest rank: smallest value that is greater than or equal to the requested percent of the voxel values
+  percent = std::min(std::max(percent, 0.0), 100.0);
+  vtkIdType rank = std::max(static_cast<vtkIdType>(std::ceil(percent / 100.0 * statistics->ScalarVoxelCount)), vtkIdType(1));
+  vtkIdType cumulativeCount = 0;
+  for (size_t bin = 0; bin < statistics->Histogram.size(); ++bin)
+  {
+    cumulativeCount += statistics->Histogram[bin];
+    if (cumulativeCount >= rank)
+    {
+      double value = statistics->HistogramOrigin + bin * statistics->HistogramBinSpacing;
+      return std::min(std::max(value, statistics->Minimum), statistics->Maximum);
+    }
+  }
+  return statistics->Maximum;
+}
@@ -0,0 +1,149 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkSegmentationStatistics_h
+#define __vtkSegmentationStatistics_h
+
+// VTK includes
+#include <vtkObject.h>
+
+// STD includes
+#include <string>
+#include <vector>
+
+#include "vtkSegmentationCoreConfigure.h"
+
+class vtkAbstractTransform;
+class vtkOrientedImageData;
+class vtkSegmentation;
+class vtkStringArray;
+
+/// \brief Compute statistics of many segments at once from their binary labelmap representation.
+///
+/// Segments that share a labelmap layer are processed together: each layer is traversed only once
+/// (on multiple threads) to compute voxel count, volume and optionally shape statistics (centroid,
+/// principal moments and axes, elongation, flatness) of all its segments.
+///
+/// If a scalar volume is set then each layer is resampled once into the scalar volume geometry and
+/// the scalar volume is traversed once to compute voxel count, volume, minimum, maximum, mean and
+/// standard deviation of voxel values for all segments.
+/// Median and percentiles are computed from a histogram of each segment, in a second traversal of the
+/// scalar volume. They use the nearest-rank definition: unlike vtkImageHistogramStatistics, values are
+/// not interpolated. The histogram covers the voxel value range of the segment: percentiles are exact for
+/// integer voxel types if this range is smaller than MaximumNumberOfHistogramBins, otherwise within one
+/// bin width.
+class vtkSegmentationCore_EXPORT vtkSegmentationStatistics : public vtkObject
+{
+public:
+  static vtkSegmentationStatistics* New();
+  vtkTypeMacro(vtkSegmentationStatistics, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Segmentation to compute statistics for. Binary labelmap representation of segments is used.
+  virtual void SetSegmentation(vtkSegmentation*);
+  vtkGetObjectMacro(Segmentation, vtkSegmentation);
+
+  /// Segments to compute statistics for. If no segments are specified then all segments are used.
+  void AddSegmentID(const std::string& segmentId);
+  void SetSegmentIDs(vtkStringArray* segmentIds);
+  void RemoveAllSegmentIDs();
+
+  /// Optional scalar volume. Voxel value statistics are computed within each segment.
+  virtual void SetScalarVolume(vtkOrientedImageData*);
+  vtkGetObjectMacro(ScalarVolume, vtkOrientedImageData);
+
+  /// Optional transform from the segmentation coordinate system to the scalar volume coordinate system.
+  virtual void SetSegmentationToScalarVolumeTransform(vtkAbstractTransform*);
+  vtkGetObjectMacro(SegmentationToScalarVolumeTransform, vtkAbstractTransform);
+
+  /// Compute centroid, principal moments and axes, elongation and flatness. Off by default.
+  vtkSetMacro(ComputeShapeStatistics, bool);
+  vtkGetMacro(ComputeShapeStatistics, bool);
+  vtkBooleanMacro(ComputeShapeStatistics, bool);
+
+  /// Compute histogram of voxel values for median and percentiles. On by default.
+  vtkSetMacro(ComputeScalarPercentiles, bool);
+  vtkGetMacro(ComputeScalarPercentiles, bool);
+  vtkBooleanMacro(ComputeScalarPercentiles, bool);
+
+  /// Maximum number of bins of the voxel value histogram of each segment. Default is 65536.
+  /// The histogram of a segment has fewer bins if its range of integer voxel values is smaller.
+  vtkSetClampMacro(MaximumNumberOfHistogramBins, int, 2, 1 << 24);
+  vtkGetMacro(MaximumNumberOfHistogramBins, int);
+
+  /// Compute statistics of all segments. Returns false if inputs are invalid.
+  bool Compute();
+
+  /// Remove all computed statistics.
+  void ClearStatistics();
+
+  /// Returns true if labelmap statistics are available for the segment.
+  bool HasLabelmapStatistics(const std::string& segmentId);
+  /// Number of voxels in the segment.
+  vtkIdType GetVoxelCount(const std::string& segmentId);
+  /// Volume of the segment in cubic millimeters.
+  double GetVolumeMm3(const std::string& segmentId);
+
+  /// Returns true if shape statistics are available for the segment.
+  bool HasShapeStatistics(const std::string& segmentId);
+  /// Centroid of the segment in the segmentation coordinate system.
+  bool GetCentroid(const std::string& segmentId, double centroid[3]);
+  /// Principal moments (variance of voxel positions along the principal axes, in mm^2), in ascending order.
+  bool GetPrincipalMoments(const std::string& segmentId, double moments[3]);
+  /// Unit vector of the principal axis corresponding to the principal moment of the same index.
+  bool GetPrincipalAxis(const std::string& segmentId, int axisIndex, double axis[3]);
+  /// Square root of the ratio of the largest and second largest principal moments.
+  double GetElongation(const std::string& segmentId);
+  /// Square root of the ratio of the second smallest and smallest principal moments.
+  double GetFlatness(const std::string& segmentId);
+
+  /// Returns true if scalar volume statistics are available for the segment.
+  bool HasScalarStatistics(const std::string& segmentId);
+  /// Number of segment voxels in the scalar volume (segment is resampled to the scalar volume geometry).
+  vtkIdType GetScalarVoxelCount(const std::string& segmentId);
+  /// Volume of the segment region that overlaps with the scalar volume, in cubic millimeters.
+  double GetScalarVolumeMm3(const std::string& segmentId);
+  double GetScalarMinimum(const std::string& segmentId);
+  double GetScalarMaximum(const std::string& segmentId);
+  double GetScalarMean(const std::string& segmentId);
+  double GetScalarStandardDeviation(const std::string& segmentId);
+  double GetScalarMedian(const std::string& segmentId);
+  /// Nearest-rank percentile: the smallest voxel value that is greater than or equal to
+  /// the given percent (0-100) of segment voxel values.
+  double GetScalarPercentile(const std::string& segmentId, double percent);
+
+protected:
+  vtkSegmentationStatistics();
+  ~vtkSegmentationStatistics() override;
+
+  vtkSegmentation* Segmentation{ nullptr };
+  vtkOrientedImageData* ScalarVolume{ nullptr };
+  vtkAbstractTransform* SegmentationToScalarVolumeTransform{ nullptr };
+  std::vector<std::string> SegmentIDs;
+  bool ComputeShapeStatistics{ false };
+  bool ComputeScalarPercentiles{ true };
+  int MaximumNumberOfHistogramBins{ 65536 };
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkSegmentationStatistics(const vtkSegmentationStatistics&) = delete;
+  void operator=(const vtkSegmentationStatistics&) = delete;
+};
+
+#endif
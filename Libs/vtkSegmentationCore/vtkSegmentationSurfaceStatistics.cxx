@@ -0,0 +1,390 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// SegmentationCore includes
+#include "vtkSegmentationSurfaceStatistics.h"
+#include "vtkSegment.h"
+#include "vtkSegmentation.h"
+#include "vtkSegmentationConverter.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkIdList.h>
+#include <vtkMath.h>
+#include <vtkObjectFactory.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPThreadLocalObject.h>
+#include <vtkSMPTools.h>
+#include <vtkStringArray.h>
+#include <vtkTimerLog.h>
+#include <vtkWeakPointer.h>
+
+// STD includes
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <set>
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkSegmentationSurfaceStatistics);
+vtkCxxSetObjectMacro(vtkSegmentationSurfaceStatistics, Segmentation, vtkSegmentation);
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Range of polygons or triangle strips of a surface that is processed by one thread.
+struct SurfaceBlock
+{
+  int SurfaceIndex{ 0 };
+  bool Strips{ false };
+  vtkIdType FirstCell{ 0 };
+  vtkIdType EndCell{ 0 };
+  double SurfaceArea{ 0.0 };
+  double SignedVolume{ 0.0 };
+  double ComputationTimeSec{ 0.0 };
+};
+
+//----------------------------------------------------------------------------
+// Surface area and signed volume of a triangle (volume of the tetrahedron formed by the triangle and the origin).
+// Point coordinates are relative to the surface center to reduce rounding errors.
+void AddTriangle(const double p0[3], const double p1[3], const double p2[3], double& surfaceArea, double& signedVolume)
+{
+  double edge1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+  double edge2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+  double normal[3] = { 0.0, 0.0, 0.0 };
+  vtkMath::Cross(edge1, edge2, normal);
+  surfaceArea += 0.5 * vtkMath::Norm(normal);
+  double p1xp2[3] = { 0.0, 0.0, 0.0 };
+  vtkMath::Cross(p1, p2, p1xp2);
+  signedVolume += vtkMath::Dot(p0, p1xp2) / 6.0;
+}
+
+//----------------------------------------------------------------------------
+struct SurfaceStatisticsFunctor
+{
+  const std::vector<vtkPolyData*>* Surfaces{ nullptr };
+  const std::vector<std::array<double, 3>>* Centers{ nullptr };
+  std::vector<SurfaceBlock>* Blocks{ nullptr };
+  vtkSMPThreadLocalObject<vtkIdList> PointIds;
+
+  //----------------------------------------------------------------------------
+  void GetPoint(vtkPoints* points, const double center[3], vtkIdType pointId, double point[3])
+  {
+    points->GetPoint(pointId, point);
+    point[0] -= center[0];
+    point[1] -= center[1];
+    point[2] -= center[2];
+  }
+
+  //----------------------------------------------------------------------------
+  void ProcessBlock(SurfaceBlock& block)
+  {
+    double startTime = vtkTimerLog::GetUniversalTime();
+    vtkPolyData* surface = (*this->Surfaces)[block.SurfaceIndex];
+    const double* center = (*this->Centers)[block.SurfaceIndex].data();
+    vtkPoints* points = surface->GetPoints();
+    vtkCellArray* cells = (block.Strips ? surface->GetStrips() : surface->GetPolys());
+    vtkIdList* pointIds = this->PointIds.Local();
+    double p0[3], p1[3], p2[3];
+    for (vtkIdType cellId = block.FirstCell; cellId < block.EndCell; ++cellId)
+    {
+      cells->GetCellAtId(cellId, pointIds);
+      vtkIdType numberOfPoints = pointIds->GetNumberOfIds();
+      if (numberOfPoints < 3)
+      {
+        continue;
+      }
+      if (block.Strips)
+      {
+        // Every other triangle of a strip has reversed point order
+        for (vtkIdType i = 0; i + 2 < numberOfPoints; ++i)
+        {
+          this->GetPoint(points, center, pointIds->GetId(i % 2 ? i + 1 : i), p0);
+          this->GetPoint(points, center, pointIds->GetId(i % 2 ? i : i + 1), p1);
+          this->GetPoint(points, center, pointIds->GetId(i + 2), p2);
+          AddTriangle(p0, p1, p2, block.SurfaceArea, block.SignedVolume);
+        }
+      }
+      else
+      {
+        // Polygons are split into a triangle fan
+        this->GetPoint(points, center, pointIds->GetId(0), p0);
+        this->GetPoint(points, center, pointIds->GetId(1), p1);
+        for (vtkIdType i = 2; i < numberOfPoints; ++i)
+        {
+          this->GetPoint(points, center, pointIds->GetId(i), p2);
+          AddTriangle(p0, p1, p2, block.SurfaceArea, block.SignedVolume);
+          std::copy(p2, p2 + 3, p1);
+        }
+      }
+    }
+    block.ComputationTimeSec = vtkTimerLog::GetUniversalTime() - startTime;
+  }
+
+  //----------------------------------------------------------------------------
+  void Initialize() {}
+
+  //----------------------------------------------------------------------------
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType blockIndex = begin; blockIndex < end; ++blockIndex)
+    {
+      this->ProcessBlock((*this->Blocks)[blockIndex]);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  void Reduce() {}
+};
+
+} // namespace
+
+//----------------------------------------------------------------------------
+class vtkSegmentationSurfaceStatistics::vtkInternal
+{
+public:
+  struct SegmentStatistics
+  {
+    /// Closed surface that the statistics were computed from and its modified time when the statistics were computed
+    vtkWeakPointer<vtkPolyData> Surface;
+    vtkMTimeType SurfaceMTime{ 0 };
+
+    double SurfaceAreaMm2{ 0.0 };
+    double VolumeMm3{ 0.0 };
+    double ComputationTimeSec{ 0.0 };
+    bool CachedResultUsed{ false };
+  };
+
+  /// Cached statistics of all segments that statistics have been computed for
+  std::map<std::string, SegmentStatistics> Statistics;
+  /// Segments that statistics are available for in the last computation
+  std::set<std::string> ComputedSegmentIDs;
+
+  //----------------------------------------------------------------------------
+  SegmentStatistics* GetStatistics(const std::string& segmentId)
+  {
+    if (!this->ComputedSegmentIDs.count(segmentId))
+    {
+      return nullptr;
+    }
+    auto statisticsIt = this->Statistics.find(segmentId);
+    return (statisticsIt != this->Statistics.end() ? &statisticsIt->second : nullptr);
+  }
+};
+
+//----------------------------------------------------------------------------
+vtkSegmentationSurfaceStatistics::vtkSegmentationSurfaceStatistics()
+{
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkSegmentationSurfaceStatistics::~vtkSegmentationSurfaceStatistics()
+{
+  this->SetSegmentation(nullptr);
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkSegmentationSurfaceStatistics::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Segmentation: " << this->Segmentation << "\n";
+  os << indent << "NumberOfSegmentIDs: " << this->SegmentIDs.size() << "\n";
+  os << indent << "NumberOfCellsPerBlock: " << this->NumberOfCellsPerBlock << "\n";
+  os << indent << "NumberOfCachedSegments: " << this->Internal->Statistics.size() << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkSegmentationSurfaceStatistics::AddSegmentID(const std::string& segmentId)
+{
+  this->SegmentIDs.push_back(segmentId);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkSegmentationSurfaceStatistics::SetSegmentIDs(vtkStringArray* segmentIds)
+{
+  this->SegmentIDs.clear();
+  if (segmentIds)
+  {
+    for (vtkIdType index = 0; index < segmentIds->GetNumberOfValues(); ++index)
+    {
+      this->SegmentIDs.push_back(segmentIds->GetValue(index));
+    }
+  }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkSegmentationSurfaceStatistics::RemoveAllSegmentIDs()
+{
+  this->SegmentIDs.clear();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkSegmentationSurfaceStatistics::ClearStatistics()
+{
+  this->Internal->Statistics.clear();
+  this->Internal->ComputedSegmentIDs.clear();
+}
+
+//----------------------------------------------------------------------------
+bool vtkSegmentationSurfaceStatistics::Compute()
+{
+  this->Internal->ComputedSegmentIDs.clear();
+  if (!this->Segmentation)
+  {
+    vtkErrorMacro("Compute: Invalid segmentation");
+    return false;
+  }
+
+  std::vector<std::string> segmentIds = this->SegmentIDs;
+  if (segmentIds.empty())
+  {
+    this->Segmentation->GetSegmentIDs(segmentIds);
+  }
+
+  // Collect surfaces that have changed since the last computation
+  std::vector<std::string> surfaceSegmentIds;
+  std::vector<vtkPolyData*> surfaces;
+  std::vector<std::array<double, 3>> centers;
+  for (const std::string& segmentId : segmentIds)
+  {
+    vtkSegment* segment = this->Segmentation->GetSegment(segmentId);
+    vtkPolyData* surface = nullptr;
+    if (segment)
+    {
+      surface = vtkPolyData::SafeDownCast(segment->GetRepresentation(vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName()));
+    }
+    if (!surface)
+    {
+      vtkDebugMacro("Compute: No closed surface representation for segment " << segmentId);
+      continue;
+    }
+    if (this->Internal->ComputedSegmentIDs.count(segmentId))
+    {
+      // duplicate segment ID
+      continue;
+    }
+    this->Internal->ComputedSegmentIDs.insert(segmentId);
+    vtkInternal::SegmentStatistics& statistics = this->Internal->Statistics[segmentId];
+    if (statistics.Surface == surface && statistics.SurfaceMTime == surface->GetMTime())
+    {
+      statistics.CachedResultUsed = true;
+      statistics.ComputationTimeSec = 0.0;
+      continue;
+    }
+    statistics = vtkInternal::SegmentStatistics();
+    statistics.Surface = surface;
+    statistics.SurfaceMTime = surface->GetMTime();
+    surfaceSegmentIds.push_back(segmentId);
+    surfaces.push_back(surface);
+    // Computing the center also initializes cached bounds, which must not happen on multiple threads
+    std::array<double, 3> center = { 0.0, 0.0, 0.0 };
+    if (surface->GetNumberOfPoints() > 0)
+    {
+      surface->GetCenter(center.data());
+    }
+    centers.push_back(center);
+  }
+
+  // Split cells of all surfaces into blocks so that large and small surfaces are processed on all threads
+  std::vector<SurfaceBlock> blocks;
+  for (size_t surfaceIndex = 0; surfaceIndex < surfaces.size(); ++surfaceIndex)
+  {
+    vtkPolyData* surface = surfaces[surfaceIndex];
+    if (!surface->GetPoints())
+    {
+      continue;
+    }
+    for (bool strips : { false, true })
+    {
+      vtkIdType numberOfCells = (strips ? surface->GetNumberOfStrips() : surface->GetNumberOfPolys());
+      for (vtkIdType firstCell = 0; firstCell < numberOfCells; firstCell += this->NumberOfCellsPerBlock)
+      {
+        SurfaceBlock block;
+        block.SurfaceIndex = static_cast<int>(surfaceIndex);
+        block.Strips = strips;
+        block.FirstCell = firstCell;
+        block.EndCell = std::min<vtkIdType>(firstCell + this->NumberOfCellsPerBlock, numberOfCells);
+        blocks.push_back(block);
+      }
+    }
+  }
+
+  SurfaceStatisticsFunctor functor;
+  functor.Surfaces = &surfaces;
+  functor.Centers = &centers;
+  functor.Blocks = &blocks;
+  vtkSMPTools::For(0, static_cast<vtkIdType>(blocks.size()), 1, functor);
+
+  // Sum results of blocks of each surface
+  std::vector<double> signedVolumes(surfaces.size(), 0.0);
+  for (const SurfaceBlock& block : blocks)
+  {
+    vtkInternal::SegmentStatistics& statistics = this->Internal->Statistics[surfaceSegmentIds[block.SurfaceIndex]];
+    statistics.SurfaceAreaMm2 += block.SurfaceArea;
+    statistics.ComputationTimeSec += block.ComputationTimeSec;
+    signedVolumes[block.SurfaceIndex] += block.SignedVolume;
+  }
+  for (size_t surfaceIndex = 0; surfaceIndex < surfaces.size(); ++surfaceIndex)
+  {
+    // Volume is positive regardless of the orientation of the surface
+    this->Internal->Statistics[surfaceSegmentIds[surfaceIndex]].VolumeMm3 = std::abs(signedVolumes[surfaceIndex]);
+  }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSegmentationSurfaceStatistics::HasSurfaceStatistics(const std::string& segmentId)
+{
+  return this->Internal->GetStatistics(segmentId) != nullptr;
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentationSurfaceStatistics::GetSurfaceAreaMm2(const std::string& segmentId)
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetStatistics(segmentId);
+  return statistics ? statistics->SurfaceAreaMm2 : 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentationSurfaceStatistics::GetVolumeMm3(const std::string& segmentId)
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetStatistics(segmentId);
+  return statistics ? statistics->VolumeMm3 : 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkSegmentationSurfaceStatistics::GetComputationTimeSec(const std::string& segmentId)
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetStatistics(segmentId);
+  return statistics ? statistics->ComputationTimeSec : 0.0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSegmentationSurfaceStatistics::GetCachedResultUsed(const std::string& segmentId)
+{
+  vtkInternal::SegmentStatistics* statistics = this->Internal->GetStatistics(segmentId);
+  return statistics && statistics->CachedResultUsed;
+}
@@ -0,0 +1,97 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkSegmentationSurfaceStatistics_h
+#define __vtkSegmentationSurfaceStatistics_h
+
+// VTK includes
+#include <vtkObject.h>
+
+// STD includes
+#include <string>
+#include <vector>
+
+#include "vtkSegmentationCoreConfigure.h"
+
+class vtkSegmentation;
+class vtkStringArray;
+
+/// \brief Compute surface area and volume of many segments at once from their closed surface representation.
+///
+/// Surfaces of all segments are processed concurrently: cells of all surfaces are split into blocks
+/// that are processed on multiple threads. Surface area is the sum of polygon areas, volume is computed
+/// from the signed volumes of tetrahedra formed by the polygons and the origin (divergence theorem),
+/// which gives the same result as vtkMassProperties for closed, consistently oriented surfaces.
+///
+/// Results are cached: the surface of a segment is only processed again if its closed surface
+/// representation has been replaced or modified since the last computation.
+class vtkSegmentationCore_EXPORT vtkSegmentationSurfaceStatistics : public vtkObject
+{
+public:
+  static vtkSegmentationSurfaceStatistics* New();
+  vtkTypeMacro(vtkSegmentationSurfaceStatistics, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Segmentation to compute statistics for. Closed surface representation of segments is used,
+  /// it is not created if it does not exist.
+  virtual void SetSegmentation(vtkSegmentation*);
+  vtkGetObjectMacro(Segmentation, vtkSegmentation);
+
+  /// Segments to compute statistics for. If no segments are specified then all segments are used.
+  void AddSegmentID(const std::string& segmentId);
+  void SetSegmentIDs(vtkStringArray* segmentIds);
+  void RemoveAllSegmentIDs();
+
+  /// Maximum number of cells that are processed in one block. Default is 65536.
+  vtkSetClampMacro(NumberOfCellsPerBlock, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfCellsPerBlock, int);
+
+  /// Compute statistics of all segments. Returns false if inputs are invalid.
+  bool Compute();
+
+  /// Remove all cached statistics.
+  void ClearStatistics();
+
+  /// Returns true if closed surface statistics are available for the segment.
+  bool HasSurfaceStatistics(const std::string& segmentId);
+  /// Surface area of the segment in square millimeters.
+  double GetSurfaceAreaMm2(const std::string& segmentId);
+  /// Volume enclosed by the surface of the segment in cubic millimeters.
+  double GetVolumeMm3(const std::string& segmentId);
+  /// Total time spent on processing the surface of the segment (summed over all threads), in seconds.
+  /// Zero if the cached result was used in the last computation.
+  double GetComputationTimeSec(const std::string& segmentId);
+  /// Returns true if the cached result was used for the segment in the last computation.
+  bool GetCachedResultUsed(const std::string& segmentId);
+
+protected:
+  vtkSegmentationSurfaceStatistics();
+  ~vtkSegmentationSurfaceStatistics() override;
+
+  vtkSegmentation* Segmentation{ nullptr };
+  std::vector<std::string> SegmentIDs;
+  int NumberOfCellsPerBlock{ 65536 };
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkSegmentationSurfaceStatistics(const vtkSegmentationSurfaceStatistics&) = delete;
+  void operator=(const vtkSegmentationSurfaceStatistics&) = delete;
+};
+
+#endif
@@ -0,0 +1,280 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkTeem includes
+#include <vtkDiffusionTensorGlyph.h>
+#include <vtkDiffusionTensorMathematics.h>
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkDataArray.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Octahedron with unit radius and normals, used as glyph source.
+void CreateOctahedron(vtkPolyData* octahedron)
+{
+  const double positions[6][3] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+  const vtkIdType triangles[8][3] = { { 0, 2, 4 }, { 2, 1, 4 }, { 1, 3, 4 }, { 3, 0, 4 }, { 2, 0, 5 }, { 1, 2, 5 }, { 3, 1, 5 }, { 0, 3, 5 } };
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkFloatArray> normals;
+  normals->SetNumberOfComponents(3);
+  for (int i = 0; i < 6; ++i)
+  {
+    points->InsertNextPoint(positions[i]);
+    normals->InsertNextTuple(positions[i]);
+  }
+  vtkNew<vtkCellArray> polys;
+  for (int i = 0; i < 8; ++i)
+  {
+    polys->InsertNextCell(3, triangles[i]);
+  }
+  octahedron->SetPoints(points);
+  octahedron->SetPolys(polys);
+  octahedron->GetPointData()->SetNormals(normals);
+}
+
+//----------------------------------------------------------------------------
+// Tensor image: isotropic tensors in the left half, anisotropic tensors aligned
+// with the x axis in the right half, and zero tensors (not glyphed) in the first row.
+void CreateTensorImage(vtkImageData* tensorImage, int size)
+{
+  tensorImage->SetDimensions(size, size, 1);
+  tensorImage->SetSpacing(2.0, 2.0, 2.0);
+  vtkNew<vtkFloatArray> tensors;
+  tensors->SetNumberOfComponents(9);
+  tensors->SetNumberOfTuples(size * size);
+  for (int y = 0; y < size; ++y)
+  {
+    for (int x = 0; x < size; ++x)
+    {
+      float* tensor = tensors->GetPointer(9 * (y * size + x));
+      for (int i = 0; i < 9; ++i)
+      {
+        tensor[i] = 0.f;
+      }
+      if (y == 0)
+      {
+        continue;
+      }
+      tensor[0] = (x < size / 2 ? 1.0e-3f : 1.6e-3f);
+      tensor[4] = (x < size / 2 ? 1.0e-3f : 0.4e-3f);
+      tensor[8] = (x < size / 2 ? 1.0e-3f : 0.1e-3f);
+    }
+  }
+  tensorImage->GetPointData()->SetTensors(tensors);
+}
+
+//----------------------------------------------------------------------------
+bool TestGlyphGeometry()
+{
+  const int size = 8;
+  vtkNew<vtkImageData> tensorImage;
+  CreateTensorImage(tensorImage, size);
+  vtkNew<vtkPolyData> octahedron;
+  CreateOctahedron(octahedron);
+
+  vtkNew<vtkDiffusionTensorGlyph> glyphFilter;
+  glyphFilter->SetInputData(tensorImage);
+  glyphFilter->SetSourceData(octahedron);
+  glyphFilter->SetDimensionResolution(1, 1);
+  glyphFilter->ColorGlyphsByFractionalAnisotropy();
+  glyphFilter->Update();
+  vtkPolyData* output = glyphFilter->GetOutput();
+
+  // all voxels but the first row are glyphed
+  const int numberOfGlyphs = size * (size - 1);
+  if (output->GetNumberOfPoints() != numberOfGlyphs * 6 || output->GetNumberOfPolys() != numberOfGlyphs * 8)
+  {
+    std::cerr << "Line " << __LINE__ << ": unexpected number of glyph points or cells: " //
+              << output->GetNumberOfPoints() << ", " << output->GetNumberOfPolys() << std::endl;
+    return false;
+  }
+  vtkDataArray* scalars = output->GetPointData()->GetScalars();
+  vtkDataArray* normals = output->GetPointData()->GetNormals();
+  if (!scalars || !normals || scalars->GetNumberOfTuples() != output->GetNumberOfPoints())
+  {
+    std::cerr << "Line " << __LINE__ << ": missing glyph scalars or normals" << std::endl;
+    return false;
+  }
+
+  // Glyphs are output in voxel order: first glyph is at voxel (0,1), isotropic,
+  // radius is sqrt(eigenvalue) * scale factor.
+  const double expectedRadius = sqrt(1.0e-3) * 1000.0;
+  for (vtkIdType pointId = 0; pointId < 6; ++pointId)
+  {
+    double point[3];
+    output->GetPoint(pointId, point);
+    double radius = sqrt(point[0] * point[0] + (point[1] - 2.0) * (point[1] - 2.0) + point[2] * point[2]);
+    double normal[3];
+    normals->GetTuple(pointId, normal);
+    if (fabs(radius - expectedRadius) > 1e-3 || fabs(vtkMath::Norm(normal) - 1.0) > 1e-5 || fabs(scalars->GetTuple1(pointId)) > 1e-5)
+    {
+      std::cerr << "Line " << __LINE__ << ": invalid isotropic glyph point " << pointId << std::endl;
+      return false;
+    }
+  }
+
+  // Last glyph is anisotropic: extent along x is sqrt(largest eigenvalue) * scale factor
+  double bounds[6] = { 0.0, -1.0, 0.0, -1.0, 0.0, -1.0 };
+  for (vtkIdType pointId = output->GetNumberOfPoints() - 6; pointId < output->GetNumberOfPoints(); ++pointId)
+  {
+    double point[3];
+    output->GetPoint(pointId, point);
+    bounds[0] = std::min(bounds[0], point[0] - 2.0 * (size - 1));
+    bounds[1] = std::max(bounds[1], point[0] - 2.0 * (size - 1));
+  }
+  double eigenvalues[3] = { 1.6e-3, 0.4e-3, 0.1e-3 };
+  double expectedFA = vtkDiffusionTensorMathematics::FractionalAnisotropy(eigenvalues);
+  if (fabs(bounds[1] - sqrt(1.6e-3) * 1000.0) > 1e-3 || fabs(bounds[0] + sqrt(1.6e-3) * 1000.0) > 1e-3
+      || fabs(scalars->GetTuple1(output->GetNumberOfPoints() - 1) - expectedFA) > 1e-4)
+  {
+    std::cerr << "Line " << __LINE__ << ": invalid anisotropic glyph" << std::endl;
+    return false;
+  }
+
+  // Every other voxel in each direction
+  glyphFilter->SetDimensionResolution(2, 2);
+  glyphFilter->Update();
+  if (glyphFilter->GetOutput()->GetNumberOfPoints() != (size / 2) * (size / 2 - 1) * 6)
+  {
+    std::cerr << "Line " << __LINE__ << ": unexpected number of glyph points: " << glyphFilter->GetOutput()->GetNumberOfPoints() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestGlyphCache()
+{
+  const int size = 256;
+  vtkNew<vtkImageData> tensorImage;
+  CreateTensorImage(tensorImage, size);
+  vtkNew<vtkPolyData> octahedron;
+  CreateOctahedron(octahedron);
+
+  vtkNew<vtkDiffusionTensorGlyph> glyphFilter;
+  glyphFilter->SetInputData(tensorImage);
+  glyphFilter->SetSourceData(octahedron);
+  glyphFilter->SetDimensionResolution(1, 1);
+  if (glyphFilter->GetGlyphCacheSize() != 4)
+  {
+    std::cerr << "Line " << __LINE__ << ": unexpected default glyph cache size: " << glyphFilter->GetGlyphCacheSize() << std::endl;
+    return false;
+  }
+  glyphFilter->SetGlyphCacheSize(2);
+
+  vtkNew<vtkTimerLog> timer;
+  double slicePositions[3] = { 0.0, 10.0, 0.0 };
+  double generateTimeSec = 0.0;
+  for (double slicePosition : slicePositions)
+  {
+    // a new matrix is set at each slice change
+    vtkNew<vtkMatrix4x4> volumePositionMatrix;
+    volumePositionMatrix->SetElement(2, 3, slicePosition);
+    glyphFilter->SetVolumePositionMatrix(volumePositionMatrix);
+    timer->StartTimer();
+    glyphFilter->Update();
+    timer->StopTimer();
+    if (slicePosition == 0.0 && glyphFilter->GetNumberOfGlyphCacheHits() == 0)
+    {
+      generateTimeSec = timer->GetElapsedTime();
+    }
+    // glyphs are symmetric, therefore they are centered on the slice
+    double bounds[6] = { 0.0, -1.0, 0.0, -1.0, 0.0, -1.0 };
+    glyphFilter->GetOutput()->GetBounds(bounds);
+    if (fabs((bounds[4] + bounds[5]) / 2.0 - slicePosition) > 1e-3)
+    {
+      std::cerr << "Line " << __LINE__ << ": glyphs are not at slice position " << slicePosition << std::endl;
+      return false;
+    }
+  }
+  std::cout << "Generated " << size * (size - 1) << " glyphs in " << generateTimeSec << " s, cached glyphs returned in " << timer->GetElapsedTime() << " s" << std::endl;
+  if (glyphFilter->GetNumberOfGlyphCacheHits() != 1 || glyphFilter->GetNumberOfCachedGlyphGeometries() != 2)
+  {
+    std::cerr << "Line " << __LINE__ << ": unexpected cache state: " << glyphFilter->GetNumberOfGlyphCacheHits() << " hits, " //
+              << glyphFilter->GetNumberOfCachedGlyphGeometries() << " cached" << std::endl;
+    return false;
+  }
+
+  // Changing tensor content invalidates cached glyphs
+  vtkFloatArray* tensors = vtkFloatArray::SafeDownCast(tensorImage->GetPointData()->GetTensors());
+  tensors->SetValue(9 * size, 2.0e-3f);
+  tensors->Modified();
+  glyphFilter->Update();
+  if (glyphFilter->GetNumberOfGlyphCacheHits() != 1 || glyphFilter->GetNumberOfCachedGlyphGeometries() != 2)
+  {
+    std::cerr << "Line " << __LINE__ << ": modified tensors must not be found in the cache" << std::endl;
+    return false;
+  }
+
+  // Changing a glyph parameter invalidates cached glyphs
+  glyphFilter->SetScaleFactor(500.0);
+  glyphFilter->Update();
+  if (glyphFilter->GetNumberOfGlyphCacheHits() != 1)
+  {
+    std::cerr << "Line " << __LINE__ << ": modified parameters must not be found in the cache" << std::endl;
+    return false;
+  }
+
+  // A new tensor array is not found in the cache, even if its content is the same
+  vtkNew<vtkFloatArray> tensorsCopy;
+  tensorsCopy->DeepCopy(tensors);
+  tensorImage->GetPointData()->SetTensors(tensorsCopy);
+  glyphFilter->Update();
+  if (glyphFilter->GetNumberOfGlyphCacheHits() != 1)
+  {
+    std::cerr << "Line " << __LINE__ << ": replaced tensor array must not be found in the cache" << std::endl;
+    return false;
+  }
+
+  glyphFilter->ClearGlyphCache();
+  if (glyphFilter->GetNumberOfCachedGlyphGeometries() != 0 || glyphFilter->GetNumberOfGlyphCacheHits() != 0)
+  {
+    std::cerr << "Line " << __LINE__ << ": cache is not cleared" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkDiffusionTensorGlyphTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  if (!TestGlyphGeometry() || !TestGlyphCache())
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
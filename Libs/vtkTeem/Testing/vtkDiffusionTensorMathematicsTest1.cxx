@@ -23,12 +23,240 @@
 
 // VTK includes
 #include <vtkDataArray.h>
+#include <vtkFloatArray.h>
 #include <vtkImageData.h>
 #include <vtkMultiThreader.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
 #include <vtkVersion.h>
 
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Generate a symmetric tensor with eigenvalues in the typical range of diffusion tensors.
+// Some tensors have repeated eigenvalues.
+void GenerateTensor(int index, float* tensor)
+{
+  double eigenvalues[3] = { 1.7e-3, 0.4e-3, 0.3e-3 };
+  switch (index % 4)
+  {
+    case 1: eigenvalues[1] = eigenvalues[0]; break; // oblate
+    case 2: eigenvalues[1] = eigenvalues[2]; break; // prolate
+    case 3: eigenvalues[0] = eigenvalues[1] = eigenvalues[2]; break; // isotropic
+  }
+  // rotation from Euler angles
+  double a = 0.1 * index;
+  double b = 0.37 * index;
+  double c = 0.73 * index;
+  double rotation[3][3] = {
+    { cos(a) * cos(b), cos(a) * sin(b) * sin(c) - sin(a) * cos(c), cos(a) * sin(b) * cos(c) + sin(a) * sin(c) },
+    { sin(a) * cos(b), sin(a) * sin(b) * sin(c) + cos(a) * cos(c), sin(a) * sin(b) * cos(c) - cos(a) * sin(c) },
+    { -sin(b), cos(b) * sin(c), cos(b) * cos(c) },
+  };
+  for (int i = 0; i < 3; ++i)
+  {
+    for (int j = 0; j < 3; ++j)
+    {
+      double value = 0.0;
+      for (int k = 0; k < 3; ++k)
+      {
+        value += rotation[i][k] * eigenvalues[k] * rotation[j][k];
+      }
+      tensor[3 * i + j] = static_cast<float>(value);
+    }
+  }
+  // make the tensor exactly symmetric after rounding
+  tensor[3] = tensor[1];
+  tensor[6] = tensor[2];
+  tensor[7] = tensor[5];
+}
+
+//----------------------------------------------------------------------------
+bool TestBatchEigenSolver()
+{
+  const int numberOfTensors = 1000;
+  std::vector<float> tensors(9 * numberOfTensors);
+  for (int i = 0; i < numberOfTensors; ++i)
+  {
+    GenerateTensor(i, &tensors[9 * i]);
+  }
+  std::vector<double> batchW(3 * numberOfTensors);
+  std::vector<double> batchV(9 * numberOfTensors);
+  vtkDiffusionTensorMathematics::BatchEigenSolver(tensors.data(), numberOfTensors, batchW.data(), batchV.data());
+
+  double m0[3], m1[3], m2[3], v0[3], v1[3], v2[3];
+  double* m[3] = { m0, m1, m2 };
+  double* v[3] = { v0, v1, v2 };
+  double w[3];
+  const double tolerance = 1e-5 * 1.7e-3;
+  for (int t = 0; t < numberOfTensors; ++t)
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      for (int j = 0; j < 3; ++j)
+      {
+        m[i][j] = tensors[9 * t + 3 * j + i];
+      }
+    }
+    vtkDiffusionTensorMathematics::TeemEigenSolver(m, w, v);
+    for (int i = 0; i < 3; ++i)
+    {
+      if (fabs(w[i] - batchW[3 * t + i]) > tolerance)
+      {
+        std::cerr << "Line " << __LINE__ << ": eigenvalue " << i << " of tensor " << t << " mismatch: " //
+                  << batchW[3 * t + i] << " (expected " << w[i] << ")" << std::endl;
+        return false;
+      }
+    }
+    // Eigenvectors are only unique (up to sign) for eigenvalues of multiplicity 1,
+    // otherwise check that they are orthonormal eigenvectors.
+    for (int j = 0; j < 3; ++j)
+    {
+      double batchEigenvector[3] = { batchV[9 * t + j], batchV[9 * t + 3 + j], batchV[9 * t + 6 + j] };
+      double norm = sqrt(batchEigenvector[0] * batchEigenvector[0] + batchEigenvector[1] * batchEigenvector[1] + batchEigenvector[2] * batchEigenvector[2]);
+      double residual = 0.0;
+      for (int i = 0; i < 3; ++i)
+      {
+        double product = 0.0;
+        for (int k = 0; k < 3; ++k)
+        {
+          product += m[i][k] * batchEigenvector[k];
+        }
+        residual = std::max(residual, fabs(product - batchW[3 * t + j] * batchEigenvector[i]));
+      }
+      bool distinctEigenvalue = (j == 0 || fabs(w[j] - w[j - 1]) > 1e-5) && (j == 2 || fabs(w[j] - w[j + 1]) > 1e-5);
+      double dot = fabs(batchEigenvector[0] * v[0][j] + batchEigenvector[1] * v[1][j] + batchEigenvector[2] * v[2][j]);
+      if (fabs(norm - 1.0) > 1e-6 || residual > tolerance || (distinctEigenvalue && dot < 1.0 - 1e-4))
+      {
+        std::cerr << "Line " << __LINE__ << ": eigenvector " << j << " of tensor " << t << " mismatch" << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Compare the eigenvalue operations computed by teem and by the batched solver,
+// separately and in one pass, and report computation times.
+bool TestAdditionalOperations()
+{
+  int dimensions[3] = { 64, 64, 32 };
+  vtkNew<vtkImageData> tensorImage;
+  tensorImage->SetDimensions(dimensions);
+  vtkNew<vtkFloatArray> tensors;
+  tensors->SetNumberOfComponents(9);
+  tensors->SetName("tensors");
+  tensors->SetNumberOfTuples(tensorImage->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < tensorImage->GetNumberOfPoints(); ++i)
+  {
+    GenerateTensor(static_cast<int>(i), tensors->GetPointer(9 * i));
+  }
+  tensorImage->GetPointData()->SetTensors(tensors);
+
+  const int operations[] = { vtkDiffusionTensorMathematics::VTK_TENS_FRACTIONAL_ANISOTROPY, //
+                             vtkDiffusionTensorMathematics::VTK_TENS_MEAN_DIFFUSIVITY,      //
+                             vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE,        //
+                             vtkDiffusionTensorMathematics::VTK_TENS_MIN_EIGENVALUE,        //
+                             vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVEC_PROJX,    //
+                             vtkDiffusionTensorMathematics::VTK_TENS_TRACE };
+  const int numberOfOperations = sizeof(operations) / sizeof(operations[0]);
+
+  vtkNew<vtkTimerLog> timer;
+
+  // Reference: one filter run per operation, using teem eigensolver
+  std::vector<vtkSmartPointer<vtkImageData>> referenceOutputs;
+  vtkNew<vtkDiffusionTensorMathematics> teemFilter;
+  teemFilter->SetInputData(tensorImage);
+  teemFilter->UseTeemEigenSolverOn();
+  timer->StartTimer();
+  for (int op : operations)
+  {
+    teemFilter->SetOperation(op);
+    teemFilter->Update();
+    vtkNew<vtkImageData> output;
+    output->DeepCopy(teemFilter->GetOutput());
+    referenceOutputs.emplace_back(output.GetPointer());
+  }
+  timer->StopTimer();
+  std::cout << "Teem eigensolver, one pass per operation: " << timer->GetElapsedTime() << " s" << std::endl;
+
+  // Batched eigensolver, one filter run per operation
+  vtkNew<vtkDiffusionTensorMathematics> batchFilter;
+  batchFilter->SetInputData(tensorImage);
+  timer->StartTimer();
+  for (int op : operations)
+  {
+    batchFilter->SetOperation(op);
+    batchFilter->Update();
+  }
+  timer->StopTimer();
+  std::cout << "Batched eigensolver, one pass per operation: " << timer->GetElapsedTime() << " s" << std::endl;
+
+  // Batched eigensolver, all operations in one pass
+  vtkNew<vtkDiffusionTensorMathematics> onePassFilter;
+  onePassFilter->SetInputData(tensorImage);
+  onePassFilter->SetOperation(operations[0]);
+  for (int opIndex = 1; opIndex < numberOfOperations; ++opIndex)
+  {
+    onePassFilter->AddAdditionalOperation(operations[opIndex]);
+  }
+  // duplicates are ignored
+  onePassFilter->AddAdditionalOperation(operations[1]);
+  if (onePassFilter->GetNumberOfAdditionalOperations() != numberOfOperations - 1)
+  {
+    std::cerr << "Line " << __LINE__ << ": unexpected number of additional operations: " << onePassFilter->GetNumberOfAdditionalOperations() << std::endl;
+    return false;
+  }
+  timer->StartTimer();
+  onePassFilter->Update();
+  timer->StopTimer();
+  std::cout << "Batched eigensolver, all operations in one pass: " << timer->GetElapsedTime() << " s" << std::endl;
+
+  for (int opIndex = 0; opIndex < numberOfOperations; ++opIndex)
+  {
+    vtkDataArray* referenceArray = referenceOutputs[opIndex]->GetPointData()->GetScalars();
+    vtkDataArray* onePassArray = (opIndex == 0 ? onePassFilter->GetOutput()->GetPointData()->GetScalars()
+                                               : onePassFilter->GetOutput()->GetPointData()->GetArray(vtkDiffusionTensorMathematics::GetOperationName(operations[opIndex])));
+    if (!referenceArray || !onePassArray || onePassArray->GetNumberOfTuples() != referenceArray->GetNumberOfTuples())
+    {
+      std::cerr << "Line " << __LINE__ << ": missing output for operation " << operations[opIndex] << std::endl;
+      return false;
+    }
+    double range[2] = { 0.0, 0.0 };
+    referenceArray->GetRange(range);
+    const double tolerance = 1e-4 * std::max(fabs(range[0]), fabs(range[1]));
+    // Eigenvectors of repeated eigenvalues are not unique, therefore the orientation
+    // of isotropic and oblate tensors is not well defined. Eigenvalue-based outputs
+    // are checked for all tensors.
+    const bool usesEigenvectors = (operations[opIndex] == vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVEC_PROJX);
+    for (vtkIdType i = 0; i < referenceArray->GetNumberOfTuples(); ++i)
+    {
+      if (usesEigenvectors && (i % 4 == 1 || i % 4 == 3))
+      {
+        continue;
+      }
+      if (fabs(referenceArray->GetTuple1(i) - onePassArray->GetTuple1(i)) > tolerance)
+      {
+        std::cerr << "Line " << __LINE__ << ": operation " << operations[opIndex] << " mismatch at voxel " << i << ": " //
+                  << onePassArray->GetTuple1(i) << " (expected " << referenceArray->GetTuple1(i) << ")" << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+} // namespace
+
 //----------------------------------------------------------------------------
 int vtkDiffusionTensorMathematicsTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
 {
@@ -117,5 +345,11 @@ int vtkDiffusionTensorMathematicsTest1(int vtkNotUsed(argc), char* vtkNotUsed(ar
     }
     std::cout << std::endl << std::endl;
   }
+
+  vtkMultiThreader::SetGlobalMaximumNumberOfThreads(0);
+  if (!TestBatchEigenSolver() || !TestAdditionalOperations())
+  {
+    return EXIT_FAILURE;
+  }
   return EXIT_SUCCESS;
 }
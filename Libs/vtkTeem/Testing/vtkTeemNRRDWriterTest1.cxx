@@ -0,0 +1,193 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkTeem includes
+#include <vtkTeemBlockGzip.h>
+#include <vtkTeemNRRDReader.h>
+#include <vtkTeemNRRDWriter.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+// Teem includes
+#include <teem/nrrd.h>
+
+// STD includes
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+bool TestBlockGzipRoundTrip(size_t dataSize, size_t blockSize)
+{
+  std::vector<unsigned char> data(dataSize);
+  for (size_t i = 0; i < dataSize; ++i)
+  {
+    data[i] = static_cast<unsigned char>((i * 7 / 13) % 251);
+  }
+  std::stringstream stream;
+  if (!vtkTeemBlockGzip::Write(stream, data.data(), dataSize, 6, blockSize))
+  {
+    std::cerr << "Line " << __LINE__ << ": failed to compress " << dataSize << " bytes" << std::endl;
+    return false;
+  }
+  std::vector<unsigned char> decompressed(dataSize);
+  stream.seekg(0);
+  if (vtkTeemBlockGzip::Read(stream, decompressed.data(), dataSize) != vtkTeemBlockGzip::ReadSuccess //
+      || memcmp(data.data(), decompressed.data(), dataSize) != 0)
+  {
+    std::cerr << "Line " << __LINE__ << ": failed to decompress " << dataSize << " bytes" << std::endl;
+    return false;
+  }
+  // Size mismatch is reported as non-indexed data
+  stream.seekg(0);
+  if (dataSize > 0 && vtkTeemBlockGzip::Read(stream, decompressed.data(), dataSize / 2) != vtkTeemBlockGzip::ReadNotIndexed)
+  {
+    std::cerr << "Line " << __LINE__ << ": data size mismatch is not detected" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestWriteRead(vtkImageData* image, const std::string& fileName, bool parallelCompression)
+{
+  vtkNew<vtkTeemNRRDWriter> writer;
+  writer->SetInputData(image);
+  writer->SetFileName(fileName.c_str());
+  writer->SetUseCompression(true);
+  writer->SetUseParallelCompression(parallelCompression);
+  writer->Write();
+  if (writer->GetWriteError())
+  {
+    std::cerr << "Line " << __LINE__ << ": failed to write " << fileName << std::endl;
+    return false;
+  }
+
+  vtkNew<vtkTeemNRRDReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->Update();
+  vtkImageData* readImage = reader->GetOutput();
+  int* dims = readImage->GetDimensions();
+  int* expectedDims = image->GetDimensions();
+  if (reader->GetReadStatus() != 0 || dims[0] != expectedDims[0] || dims[1] != expectedDims[1] || dims[2] != expectedDims[2]
+      || readImage->GetScalarType() != image->GetScalarType())
+  {
+    std::cerr << "Line " << __LINE__ << ": failed to read " << fileName << std::endl;
+    return false;
+  }
+  vtkDataArray* scalars = image->GetPointData()->GetScalars();
+  vtkDataArray* readScalars = readImage->GetPointData()->GetScalars();
+  if (!readScalars || memcmp(scalars->GetVoidPointer(0), readScalars->GetVoidPointer(0), scalars->GetDataSize() * scalars->GetDataTypeSize()) != 0)
+  {
+    std::cerr << "Line " << __LINE__ << ": voxel values mismatch in " << fileName << std::endl;
+    return false;
+  }
+
+  // The file must be readable by plain teem, which decompresses it as a regular gzip stream
+  Nrrd* teemNrrd = nrrdNew();
+  if (nrrdLoad(teemNrrd, fileName.c_str(), nullptr) != 0)
+  {
+    char* err = biffGetDone(NRRD);
+    std::cerr << "Line " << __LINE__ << ": teem failed to read " << fileName << ": " << err << std::endl;
+    free(err);
+    nrrdNuke(teemNrrd);
+    return false;
+  }
+  size_t teemDataSize = nrrdElementNumber(teemNrrd) * nrrdElementSize(teemNrrd);
+  bool teemDataMatches = (teemDataSize == static_cast<size_t>(scalars->GetDataSize() * scalars->GetDataTypeSize()) //
+                          && memcmp(scalars->GetVoidPointer(0), teemNrrd->data, teemDataSize) == 0);
+  nrrdNuke(teemNrrd);
+  if (!teemDataMatches)
+  {
+    std::cerr << "Line " << __LINE__ << ": voxel values read by teem mismatch in " << fileName << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkTeemNRRDWriterTest1(int argc, char* argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string tempDir = argv[1];
+
+  if (!TestBlockGzipRoundTrip(0, 1000)            //
+      || !TestBlockGzipRoundTrip(1, 1000)         //
+      || !TestBlockGzipRoundTrip(1000, 1000)      //
+      || !TestBlockGzipRoundTrip(100001, 1000)    //
+      || !TestBlockGzipRoundTrip(3000000, 65536)) //
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Image that is compressed in multiple blocks
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(128, 96, 80);
+  image->AllocateScalars(VTK_SHORT, 1);
+  short* voxels = static_cast<short*>(image->GetScalarPointer());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+  {
+    voxels[i] = static_cast<short>((i % 1531) - (i / 7919));
+  }
+
+  // Block-compressed file, read with parallel decompression
+  if (!TestWriteRead(image, tempDir + "/vtkTeemNRRDWriterTest1_parallel.nrrd", true))
+  {
+    return EXIT_FAILURE;
+  }
+  // Reading the same file again reuses the reader (header is not read again by ExecuteInformation)
+  {
+    vtkNew<vtkTeemNRRDReader> reader;
+    reader->SetFileName((tempDir + "/vtkTeemNRRDWriterTest1_parallel.nrrd").c_str());
+    reader->Update();
+    reader->Modified();
+    reader->Update();
+    vtkDataArray* readScalars = reader->GetOutput()->GetPointData()->GetScalars();
+    if (reader->GetReadStatus() != 0 || !readScalars || readScalars->GetNumberOfTuples() != image->GetNumberOfPoints()
+        || memcmp(voxels, readScalars->GetVoidPointer(0), image->GetNumberOfPoints() * sizeof(short)) != 0)
+    {
+      std::cerr << "Line " << __LINE__ << ": failed to read the file again with the same reader" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  // Single gzip stream written by teem
+  if (!TestWriteRead(image, tempDir + "/vtkTeemNRRDWriterTest1_teem.nrrd", false))
+  {
+    return EXIT_FAILURE;
+  }
+  // Detached header is always written by teem
+  if (!TestWriteRead(image, tempDir + "/vtkTeemNRRDWriterTest1_detached.nhdr", true))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -18,16 +18,31 @@
 #include "vtkMath.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
+#include <vtkMatrix3x3.h>
 #include <vtkNew.h>
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include <vtkPoints.h>
+#include <vtkPointSet.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPThreadLocalObject.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
 #include "vtkTransform.h"
 
 #include "vtkImageData.h"
 #include "vtkDiffusionTensorMathematics.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <ctime>
+#include <list>
+#include <string>
+#include <vector>
 
 vtkCxxSetObjectMacro(vtkDiffusionTensorGlyph, Mask, vtkImageData);
 vtkCxxSetObjectMacro(vtkDiffusionTensorGlyph, VolumePositionMatrix, vtkMatrix4x4);
@@ -35,6 +50,516 @@ vtkCxxSetObjectMacro(vtkDiffusionTensorGlyph, TensorRotationMatrix, vtkMatrix4x4
 
 vtkStandardNewMacro(vtkDiffusionTensorGlyph);
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Cells of one type (verts, lines, polys or strips) of the glyph source.
+struct SourceCellArray
+{
+  /// Output cell array type: 0 = verts, 1 = lines, 2 = polys, 3 = strips
+  int Type{ 0 };
+  /// Start of each source cell in Connectivity (number of cells + 1 values)
+  std::vector<vtkIdType> Offsets;
+  std::vector<vtkIdType> Connectivity;
+
+  vtkIdType GetNumberOfCells() const { return static_cast<vtkIdType>(this->Offsets.size()) - 1; }
+  vtkIdType GetConnectivitySize() const { return static_cast<vtkIdType>(this->Connectivity.size()); }
+};
+
+//----------------------------------------------------------------------------
+// First pass: decide which of the sampled input points are glyphed.
+struct GlyphSelectionFunctor
+{
+  vtkDataArray* Tensors{ nullptr };
+  vtkDataArray* Mask{ nullptr };
+  bool MaskGlyphs{ false };
+  const vtkIdType* SampledPointIds{ nullptr };
+  unsigned char* Selected{ nullptr };
+
+  void operator()(vtkIdType beginSampleIndex, vtkIdType endSampleIndex)
+  {
+    double tensor[3][3];
+    for (vtkIdType sampleIndex = beginSampleIndex; sampleIndex < endSampleIndex; ++sampleIndex)
+    {
+      vtkIdType inPtId = this->SampledPointIds[sampleIndex];
+      // Only display this glyph if either:
+      // a) we are masking and the mask is 1 at this location.
+      // b) the trace is positive and we are not masking (default).
+      bool selected = false;
+      if (this->Mask)
+      {
+        selected = (this->Mask->GetComponent(inPtId, 0) != 0.0);
+      }
+      else if (!this->MaskGlyphs)
+      {
+        this->Tensors->GetTuple(inPtId, &tensor[0][0]);
+        selected = (vtkDiffusionTensorMathematics::Trace(tensor) > 0);
+      }
+      this->Selected[sampleIndex] = (selected ? 1 : 0);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Second pass: write points, normals, scalars and cells of a range of glyphs.
+// Output arrays are allocated for all glyphs before this functor is run,
+// each glyph writes to its own location so no synchronization is needed.
+struct GlyphGeometryFunctor
+{
+  vtkDataSet* Input{ nullptr };
+  vtkDataArray* Tensors{ nullptr };
+  vtkDataArray* InScalars{ nullptr };
+  const vtkIdType* GlyphPointIds{ nullptr };
+
+  // Glyph parameters
+  bool ExtractEigenvalues{ true };
+  bool ColorByScalars{ false };
+  bool ColorByEigenvalues{ false };
+  int ScalarInvariant{ 0 };
+  double ScaleFactor{ 1.0 };
+  bool ClampScaling{ false };
+  double MaxScaleFactor{ 1.0 };
+  bool ThreeGlyphs{ false };
+  int NumberOfDirections{ 1 };
+  double Length{ 1.0 };
+  bool FlipNormals{ false };
+  bool UseVolumePosition{ false };
+  double VolumePosition[16];
+  bool UseTensorRotation{ false };
+  double TensorRotation[16];
+
+  // Glyph source
+  const double* SourcePoints{ nullptr };
+  const double* SourceNormals{ nullptr };
+  vtkIdType NumberOfSourcePoints{ 0 };
+  const std::vector<SourceCellArray>* SourceCells{ nullptr };
+
+  // Output
+  float* OutPoints{ nullptr };
+  float* OutNormals{ nullptr };
+  float* OutScalars{ nullptr };
+  std::vector<vtkIdType*> OutCellOffsets;
+  std::vector<vtkIdType*> OutCellConnectivity;
+
+  vtkSMPThreadLocalObject<vtkTransform> Transforms;
+  vtkSMPThreadLocal<std::vector<float>> TensorBuffers;
+  vtkSMPThreadLocal<std::vector<double>> EigenvalueBuffers;
+  vtkSMPThreadLocal<std::vector<double>> EigenvectorBuffers;
+
+  void operator()(vtkIdType beginGlyphIndex, vtkIdType endGlyphIndex)
+  {
+    vtkTransform* trans = this->Transforms.Local();
+    trans->PreMultiply();
+    const vtkIdType numberOfGlyphs = endGlyphIndex - beginGlyphIndex;
+    const int numDirs = this->NumberOfDirections;
+    const vtkIdType numSourcePts = this->NumberOfSourcePoints;
+
+    double tensor[3][3];
+    double w[3], xv[3], yv[3], zv[3];
+    double x[3], x2[3];
+    double s = 0.0;
+    double matrix[16];
+    double inverseMatrix[16];
+
+    // Compute eigensystems of all tensors of this block at once
+    std::vector<double>& eigenvalues = this->EigenvalueBuffers.Local();
+    std::vector<double>& eigenvectors = this->EigenvectorBuffers.Local();
+    if (this->ExtractEigenvalues)
+    {
+      std::vector<float>& tensors = this->TensorBuffers.Local();
+      tensors.resize(9 * numberOfGlyphs);
+      for (vtkIdType blockIndex = 0; blockIndex < numberOfGlyphs; ++blockIndex)
+      {
+        this->Tensors->GetTuple(this->GlyphPointIds[beginGlyphIndex + blockIndex], &tensor[0][0]);
+        for (int i = 0; i < 9; ++i)
+        {
+          tensors[9 * blockIndex + i] = static_cast<float>((&tensor[0][0])[i]);
+        }
+      }
+      eigenvalues.resize(3 * numberOfGlyphs);
+      eigenvectors.resize(9 * numberOfGlyphs);
+      vtkDiffusionTensorMathematics::BatchEigenSolver(tensors.data(), numberOfGlyphs, eigenvalues.data(), eigenvectors.data());
+    }
+
+    for (vtkIdType glyphIndex = beginGlyphIndex; glyphIndex < endGlyphIndex; ++glyphIndex)
+    {
+      const vtkIdType inPtId = this->GlyphPointIds[glyphIndex];
+      const vtkIdType blockIndex = glyphIndex - beginGlyphIndex;
+
+      // compute orientation vectors and scale factors from tensor
+      if (this->ExtractEigenvalues)
+      {
+        const double* v = &eigenvectors[9 * blockIndex];
+        for (int i = 0; i < 3; i++)
+        {
+          w[i] = eigenvalues[3 * blockIndex + i];
+          xv[i] = v[3 * i];
+          yv[i] = v[3 * i + 1];
+          zv[i] = v[3 * i + 2];
+        }
+      }
+      else // use tensor columns as eigenvectors
+      {
+        this->Tensors->GetTuple(inPtId, &tensor[0][0]);
+        for (int i = 0; i < 3; i++)
+        {
+          xv[i] = tensor[0][i];
+          yv[i] = tensor[1][i];
+          zv[i] = tensor[2][i];
+        }
+        w[0] = vtkMath::Normalize(xv);
+        w[1] = vtkMath::Normalize(yv);
+        w[2] = vtkMath::Normalize(zv);
+      }
+
+      // Calculate output scalars before computing glyph scale factors from eigenvalues.
+      // First, pass through input scalars if requested.
+      if (this->ColorByScalars)
+      {
+        s = this->InScalars->GetComponent(inPtId, 0);
+      }
+      // Output scalar invariants if requested
+      else if (this->ColorByEigenvalues)
+      {
+        // Correct for negative eigenvalues: use logic coded in vtkDiffusionTensorMathematics
+        vtkDiffusionTensorMathematics::FixNegativeEigenvaluesMethod(w);
+        s = this->ComputeScalarInvariant(w, xv);
+      }
+
+      // Use the square root of the eigenvalues for scaling for DTI,
+      // then compute scale factors (this modifies eigenvalues so
+      // scalar invariants were computed already above)
+      for (int i = 0; i < 3; i++)
+      {
+        w[i] = sqrt(w[i]) * this->ScaleFactor;
+      }
+
+      if (this->ClampScaling)
+      {
+        double maxScale = 0.0;
+        for (int i = 0; i < 3; i++)
+        {
+          maxScale = std::max(maxScale, fabs(w[i]));
+        }
+        if (maxScale > this->MaxScaleFactor)
+        {
+          maxScale = this->MaxScaleFactor / maxScale;
+          for (int i = 0; i < 3; i++)
+          {
+            w[i] *= maxScale; // preserve overall shape of glyph
+          }
+        }
+      }
+
+      // make sure scale is okay (non-zero) and scale data
+      // this scale checking is from superclass code
+      double maxScale = 0.0;
+      for (int i = 0; i < 3; i++)
+      {
+        if (w[i] > maxScale)
+        {
+          maxScale = w[i];
+        }
+      }
+      if (maxScale == 0.0)
+      {
+        maxScale = 1.0;
+      }
+      for (int i = 0; i < 3; i++)
+      {
+        if (w[i] == 0.0)
+        {
+          w[i] = maxScale * 1.0e-06;
+        }
+      }
+
+      // translate Source to Input point
+      this->Input->GetPoint(inPtId, x);
+      // If we have a user-specified matrix modifying the output point locations
+      if (this->UseVolumePosition)
+      {
+        for (int i = 0; i < 3; i++)
+        {
+          x2[i] = this->VolumePosition[4 * i] * x[0] + this->VolumePosition[4 * i + 1] * x[1] + this->VolumePosition[4 * i + 2] * x[2] + this->VolumePosition[4 * i + 3];
+        }
+      }
+      else
+      {
+        x2[0] = x[0];
+        x2[1] = x[1];
+        x2[2] = x[2];
+      }
+
+      // normalized eigenvectors rotate object for eigen direction 0
+      const double eigenvectorMatrix[16] = { xv[0], yv[0], zv[0], 0.0, //
+                                             xv[1], yv[1], zv[1], 0.0, //
+                                             xv[2], yv[2], zv[2], 0.0, //
+                                             0.0,   0.0,   0.0,   1.0 };
+
+      // Now do the real work for each "direction"
+      // This is a loop over each eigenvector allowing
+      // a separate glyph for each (or two loops per eigenvector
+      // allowing two symmetric glyphs for each)
+      const vtkIdType glyphPtOffset = glyphIndex * numDirs * numSourcePts;
+      for (int dir = 0; dir < numDirs; dir++)
+      {
+        const int eigen_dir = dir % (this->ThreeGlyphs ? 3 : 1);
+        const int symmetric_dir = dir / (this->ThreeGlyphs ? 3 : 1);
+        const vtkIdType ptOffset = glyphPtOffset + dir * numSourcePts;
+
+        trans->Identity();
+        trans->Translate(x2[0], x2[1], x2[2]);
+        // If we have a user-specified matrix rotating each tensor
+        if (this->UseTensorRotation)
+        {
+          trans->Concatenate(this->TensorRotation);
+        }
+        trans->Concatenate(eigenvectorMatrix);
+        if (eigen_dir == 1)
+        {
+          trans->RotateZ(90.0);
+        }
+        if (eigen_dir == 2)
+        {
+          trans->RotateY(-90.0);
+        }
+        if (this->ThreeGlyphs)
+        {
+          trans->Scale(w[eigen_dir], this->ScaleFactor, this->ScaleFactor);
+        }
+        else
+        {
+          trans->Scale(w[0], w[1], w[2]);
+        }
+        // Mirror second set to the symmetric position
+        if (symmetric_dir == 1)
+        {
+          trans->Scale(-1., 1., 1.);
+        }
+        // if the eigenvalue is negative, shift to reverse direction.
+        // The && is there to ensure that we do not change the
+        // old behavior of vtkTensorGlyphs (which only used one dir),
+        // in case there is an oriented glyph, e.g. an arrow.
+        if (w[eigen_dir] < 0 && numDirs > 1)
+        {
+          trans->Translate(-this->Length, 0., 0.);
+        }
+        vtkMatrix4x4::DeepCopy(matrix, trans->GetMatrix());
+
+        // multiply points (and normals if available) by resulting matrix
+        float* outPoint = this->OutPoints + 3 * ptOffset;
+        const double* sourcePoint = this->SourcePoints;
+        for (vtkIdType i = 0; i < numSourcePts; i++, outPoint += 3, sourcePoint += 3)
+        {
+          for (int k = 0; k < 3; k++)
+          {
+            outPoint[k] = static_cast<float>(matrix[4 * k] * sourcePoint[0] + matrix[4 * k + 1] * sourcePoint[1] + matrix[4 * k + 2] * sourcePoint[2] + matrix[4 * k + 3]);
+          }
+        }
+        if (this->OutNormals)
+        {
+          // normals are transformed by the inverse transpose of the matrix
+          vtkMatrix4x4::Invert(matrix, inverseMatrix);
+          const double normalSign = (this->FlipNormals ? -1.0 : 1.0);
+          float* outNormal = this->OutNormals + 3 * ptOffset;
+          const double* sourceNormal = this->SourceNormals;
+          double normal[3];
+          for (vtkIdType i = 0; i < numSourcePts; i++, outNormal += 3, sourceNormal += 3)
+          {
+            for (int k = 0; k < 3; k++)
+            {
+              normal[k] = inverseMatrix[k] * sourceNormal[0] + inverseMatrix[4 + k] * sourceNormal[1] + inverseMatrix[8 + k] * sourceNormal[2];
+            }
+            vtkMath::Normalize(normal);
+            for (int k = 0; k < 3; k++)
+            {
+              outNormal[k] = static_cast<float>(normalSign * normal[k]);
+            }
+          }
+        }
+        // Actually output the scalar invariant calculated above
+        if (this->OutScalars)
+        {
+          std::fill(this->OutScalars + ptOffset, this->OutScalars + ptOffset + numSourcePts, static_cast<float>(s));
+        }
+      } // end for number of dirs
+
+      // copy topology of output glyph for this point
+      for (size_t cellArrayIndex = 0; cellArrayIndex < this->SourceCells->size(); ++cellArrayIndex)
+      {
+        const SourceCellArray& sourceCells = (*this->SourceCells)[cellArrayIndex];
+        const vtkIdType numSourceCells = sourceCells.GetNumberOfCells();
+        vtkIdType* outOffsets = this->OutCellOffsets[cellArrayIndex] + glyphIndex * numDirs * numSourceCells;
+        vtkIdType connectivityIndex = glyphIndex * numDirs * sourceCells.GetConnectivitySize();
+        vtkIdType* outConnectivity = this->OutCellConnectivity[cellArrayIndex];
+        for (vtkIdType cellId = 0; cellId < numSourceCells; cellId++)
+        {
+          for (int dir = 0; dir < numDirs; dir++)
+          {
+            *(outOffsets++) = connectivityIndex;
+            const vtkIdType ptOffset = glyphPtOffset + dir * numSourcePts;
+            for (vtkIdType i = sourceCells.Offsets[cellId]; i < sourceCells.Offsets[cellId + 1]; i++)
+            {
+              outConnectivity[connectivityIndex++] = sourceCells.Connectivity[i] + ptOffset;
+            }
+          }
+        }
+      }
+    } // end loop over glyphs
+  }
+
+  double ComputeScalarInvariant(double w[3], const double majorEigenvector[3])
+  {
+    switch (this->ScalarInvariant)
+    {
+      case vtkDiffusionTensorMathematics::VTK_TENS_LINEAR_MEASURE: return vtkDiffusionTensorMathematics::LinearMeasure(w);
+      case vtkDiffusionTensorMathematics::VTK_TENS_PLANAR_MEASURE: return vtkDiffusionTensorMathematics::PlanarMeasure(w);
+      case vtkDiffusionTensorMathematics::VTK_TENS_SPHERICAL_MEASURE: return vtkDiffusionTensorMathematics::SphericalMeasure(w);
+      case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE: return w[0];
+      case vtkDiffusionTensorMathematics::VTK_TENS_MID_EIGENVALUE: return w[1];
+      case vtkDiffusionTensorMathematics::VTK_TENS_MIN_EIGENVALUE: return w[2];
+      case vtkDiffusionTensorMathematics::VTK_TENS_PARALLEL_DIFFUSIVITY: return w[0];
+      case vtkDiffusionTensorMathematics::VTK_TENS_PERPENDICULAR_DIFFUSIVITY: return 0.5 * (w[1] + w[2]);
+      case vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION:
+      {
+        double v_maj[3] = { majorEigenvector[0], majorEigenvector[1], majorEigenvector[2] };
+        if (this->UseTensorRotation)
+        {
+          // rotation only, translation of the matrix is ignored
+          for (int i = 0; i < 3; i++)
+          {
+            v_maj[i] = this->TensorRotation[4 * i] * majorEigenvector[0] + this->TensorRotation[4 * i + 1] * majorEigenvector[1] + this->TensorRotation[4 * i + 2] * majorEigenvector[2];
+          }
+        }
+        // TO DO: here output as RGB. Need to allocate 3-component scalars first.
+        double s = 0;
+        vtkDiffusionTensorMathematics::RGBToIndex(fabs(v_maj[0]), fabs(v_maj[1]), fabs(v_maj[2]), s);
+        return s;
+      }
+      case vtkDiffusionTensorMathematics::VTK_TENS_RELATIVE_ANISOTROPY: return vtkDiffusionTensorMathematics::RelativeAnisotropy(w);
+      case vtkDiffusionTensorMathematics::VTK_TENS_FRACTIONAL_ANISOTROPY: return vtkDiffusionTensorMathematics::FractionalAnisotropy(w);
+      case vtkDiffusionTensorMathematics::VTK_TENS_TRACE: return vtkDiffusionTensorMathematics::Trace(w);
+      default: return 0;
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+template <typename T>
+void AppendValueToKey(std::string& key, const T& value)
+{
+  key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+//----------------------------------------------------------------------------
+// Append a data array to the cache key. The array is identified by its address and modification time:
+// modification times are unique, so an array that is modified or that is allocated at the address
+// of a deleted array gets a different key. The content of the array is not accessed.
+void AppendArrayToKey(std::string& key, vtkDataArray* array)
+{
+  AppendValueToKey(key, reinterpret_cast<uintptr_t>(array));
+  AppendValueToKey(key, array ? array->GetMTime() : vtkMTimeType(0));
+}
+
+//----------------------------------------------------------------------------
+void AppendMatrixToKey(std::string& key, vtkMatrix4x4* matrix)
+{
+  AppendValueToKey(key, matrix != nullptr);
+  if (matrix)
+  {
+    key.append(reinterpret_cast<const char*>(matrix->GetData()), 16 * sizeof(double));
+  }
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+class vtkDiffusionTensorGlyph::vtkInternal
+{
+public:
+  struct CacheEntry
+  {
+    std::string Key;
+    vtkSmartPointer<vtkPolyData> Output;
+  };
+
+  /// Cached glyph geometries, most recently used first
+  std::list<CacheEntry> Cache;
+  int NumberOfCacheHits{ 0 };
+
+  //----------------------------------------------------------------------------
+  void TrimCache(int maximumSize)
+  {
+    while (this->Cache.size() > static_cast<size_t>(std::max(maximumSize, 0)))
+    {
+      this->Cache.pop_back();
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  /// Compute the key that identifies the output for the current input and parameters.
+  /// Returns false if the output cannot be cached.
+  bool ComputeCacheKey(vtkDiffusionTensorGlyph* self, vtkDataSet* input, vtkPolyData* source, std::string& key)
+  {
+    key.clear();
+
+    // Glyph parameters (matrices are compared by value, as a new matrix object is set at each slice update)
+    AppendValueToKey(key, source->GetMTime());
+    AppendValueToKey(key, self->ColorGlyphs);
+    AppendValueToKey(key, self->ColorMode);
+    AppendValueToKey(key, self->ScalarInvariant);
+    AppendValueToKey(key, self->ExtractEigenvalues);
+    AppendValueToKey(key, self->ScaleFactor);
+    AppendValueToKey(key, self->ClampScaling);
+    AppendValueToKey(key, self->MaxScaleFactor);
+    AppendValueToKey(key, self->ThreeGlyphs);
+    AppendValueToKey(key, self->Symmetric);
+    AppendValueToKey(key, self->Length);
+    AppendValueToKey(key, self->Resolution);
+    AppendValueToKey(key, self->DimensionResolution[0]);
+    AppendValueToKey(key, self->DimensionResolution[1]);
+    AppendValueToKey(key, self->MaskGlyphs);
+    AppendMatrixToKey(key, self->VolumePositionMatrix);
+    AppendMatrixToKey(key, self->TensorRotationMatrix);
+
+    // Input point positions
+    if (vtkImageData* imageData = vtkImageData::SafeDownCast(input))
+    {
+      key.append(reinterpret_cast<const char*>(imageData->GetExtent()), 6 * sizeof(int));
+      key.append(reinterpret_cast<const char*>(imageData->GetOrigin()), 3 * sizeof(double));
+      key.append(reinterpret_cast<const char*>(imageData->GetSpacing()), 3 * sizeof(double));
+      key.append(reinterpret_cast<const char*>(imageData->GetDirectionMatrix()->GetData()), 9 * sizeof(double));
+    }
+    else if (vtkPointSet* pointSet = vtkPointSet::SafeDownCast(input))
+    {
+      if (!pointSet->GetPoints())
+      {
+        return false;
+      }
+      AppendArrayToKey(key, pointSet->GetPoints()->GetData());
+    }
+    else
+    {
+      return false;
+    }
+
+    // Input arrays
+    vtkPointData* pd = input->GetPointData();
+    AppendArrayToKey(key, pd->GetTensors());
+    if (self->ColorGlyphs && self->ColorMode == vtkTensorGlyph::COLOR_BY_SCALARS)
+    {
+      AppendArrayToKey(key, pd->GetScalars());
+    }
+    if (self->MaskGlyphs && self->Mask)
+    {
+      AppendArrayToKey(key, self->Mask->GetPointData()->GetScalars());
+    }
+    return true;
+  }
+};
+
+//----------------------------------------------------------------------------
 // Construct object with default values for diffusion tensor data.
 vtkDiffusionTensorGlyph::vtkDiffusionTensorGlyph()
 {
@@ -56,6 +581,9 @@ vtkDiffusionTensorGlyph::vtkDiffusionTensorGlyph()
   this->DimensionResolution[0] = 20;
   this->DimensionResolution[1] = 20;
 
+  this->GlyphCacheSize = 4;
+  this->Internal = new vtkInternal;
+
   // Default large scalar factor for diffusion data.
   // Display small magnitude eigenvalues in mm space.
   this->ScaleFactor = 1000;
@@ -80,6 +608,8 @@ vtkDiffusionTensorGlyph::~vtkDiffusionTensorGlyph()
   {
     this->Mask->Delete();
   }
+
+  delete this->Internal;
 }
 
 void vtkDiffusionTensorGlyph::ColorGlyphsByLinearMeasure()
@@ -152,7 +682,6 @@ void vtkDiffusionTensorGlyph::ColorGlyphsBy(int invariant)
 }
 
 // TO DO: make input mask a point data object or scalars
-
 int vtkDiffusionTensorGlyph::RequestData(vtkInformation* vtkNotUsed(request), vtkInformationVector** inputVector, vtkInformationVector* outputVector)
 {
   // get the info objects
@@ -165,87 +694,50 @@ int vtkDiffusionTensorGlyph::RequestData(vtkInformation* vtkNotUsed(request), vt
   vtkPolyData* source = vtkPolyData::SafeDownCast(sourceInfo->Get(vtkDataObject::DATA_OBJECT()));
   vtkPolyData* output = vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  vtkDataArray* inTensors;
-  vtkDataArray* inScalars;
-  vtkIdType numPts, numSourcePts, numSourceCells, inPtId, i;
-  int j;
-  vtkPoints* sourcePts;
-  vtkDataArray* sourceNormals;
-  vtkCellArray *sourceCells, *cells;
-  vtkPoints* newPts;
-  vtkFloatArray* newScalars = nullptr;
-  vtkFloatArray* newNormals = nullptr;
-  double x[3], x2[3], s;
-  vtkTransform* trans;
-  vtkCell* cell;
-  vtkIdList* cellPts;
-  int npts;
-  vtkIdType* pts;
-  vtkIdType cellId;
-  vtkIdType subIncr;
-  int numDirs, dir, eigen_dir, symmetric_dir;
-  vtkMatrix4x4* matrix;
-  double *m[3], w[3], *v[3];
-  double m0[3], m1[3], m2[3];
-  double v0[3], v1[3], v2[3];
-  double xv[3], yv[3], zv[3];
-  double maxScale;
-  vtkPointData *pd, *outPD;
-
-  // Keeps track of the number of points added to the output polydata so far.
-  // this replaces variable ptIncr in superclass vtkTensorGlyph.
-  vtkIdType ptOffset = 0;
-
-  // coordinate systems for DTI
-  vtkTransform* userVolumeTransform = nullptr;
-  // masking of glyphs
-  vtkDataArray* inMask;
   // glyph timing
 #ifndef NDEBUG
   clock_t tStart = clock();
 #endif
 
-  // use simpler 3x3 array, not 9D as in vtkTensorGlyph class
-  double tensor[3][3];
-
-  // the number of eigenvectors to glyph * if there are two glyphs per vector
-  numDirs = (this->ThreeGlyphs ? 3 : 1) * (this->Symmetric + 1);
-
-  pts = new vtkIdType[source->GetMaxCellSize()];
-  trans = vtkTransform::New();
-  matrix = vtkMatrix4x4::New();
-
-  // set up working matrices
-  m[0] = m0;
-  m[1] = m1;
-  m[2] = m2;
-  v[0] = v0;
-  v[1] = v1;
-  v[2] = v2;
-
   vtkDebugMacro(<< "Generating tensor glyphs");
 
-  pd = input->GetPointData();
-  outPD = output->GetPointData();
-  inTensors = pd->GetTensors();
-  inScalars = pd->GetScalars();
-  numPts = input->GetNumberOfPoints();
+  vtkPointData* pd = input->GetPointData();
+  vtkPointData* outPD = output->GetPointData();
+  vtkDataArray* inTensors = pd->GetTensors();
+  vtkDataArray* inScalars = pd->GetScalars();
+  vtkIdType numPts = input->GetNumberOfPoints();
   if (!inTensors || numPts < 1)
   {
     vtkErrorMacro(<< "No data to glyph!");
-    trans->Delete();
-    matrix->Delete();
     return 1;
   }
 
+  // Return glyphs from the cache if they have been already generated
+  // for this input (e.g., same slice position)
+  std::string cacheKey;
+  bool useCache = (this->GlyphCacheSize > 0 && this->Internal->ComputeCacheKey(this, input, source, cacheKey));
+  if (useCache)
+  {
+    for (auto cacheIt = this->Internal->Cache.begin(); cacheIt != this->Internal->Cache.end(); ++cacheIt)
+    {
+      if (cacheIt->Key == cacheKey)
+      {
+        this->Internal->Cache.splice(this->Internal->Cache.begin(), this->Internal->Cache, cacheIt);
+        output->ShallowCopy(this->Internal->Cache.front().Output);
+        this->Internal->NumberOfCacheHits++;
+        vtkDebugMacro("Tensor glyphs found in cache");
+        return 1;
+      }
+    }
+  }
+
+  // the number of eigenvectors to glyph * if there are two glyphs per vector
+  const int numDirs = (this->ThreeGlyphs ? 3 : 1) * (this->Symmetric + 1);
+
   // Compute steps along dimensions
-  // and real number of input points
-  int numInputPts = numPts;
-  int skipRows = 0;
-  int skipCols = this->Resolution;
-  int rowLength = numPts;
-  int row = 0;
-  int col = 0;
+  vtkIdType skipRows = 0;
+  vtkIdType skipCols = this->Resolution;
+  vtkIdType rowLength = numPts;
   // TODO: use UpdateExtent not WholeExtent
   int inWholeExtent[6];
   inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), inWholeExtent);
@@ -255,492 +747,257 @@ int vtkDiffusionTensorGlyph::RequestData(vtkInformation* vtkNotUsed(request), vt
   dimensions[2] = inWholeExtent[5] - inWholeExtent[4] + 1;
   if (dimensions[0] > 1 && dimensions[1] > 1)
   {
-    skipRows = DimensionResolution[1];
-    skipCols = DimensionResolution[0];
+    skipRows = std::max(this->DimensionResolution[1], 1);
+    skipCols = std::max(this->DimensionResolution[0], 1);
     rowLength = dimensions[0];
-    if (skipCols)
-    {
-      numInputPts = (numInputPts + 1) / skipCols;
-    }
-    if (skipRows)
+  }
+
+  // Collect the input points that are not skipped because of the resolution
+  std::vector<vtkIdType> sampledPointIds;
+  sampledPointIds.reserve(numPts / skipCols / std::max(skipRows, vtkIdType(1)) + rowLength / skipCols + 1);
+  vtkIdType row = 0;
+  vtkIdType col = 0;
+  for (vtkIdType inPtId = 0; inPtId < numPts; inPtId += skipCols)
+  {
+    if (col >= rowLength)
     {
-      numInputPts = (numInputPts + 1) / skipRows;
+      row += skipRows;
+      inPtId = row * rowLength;
+      col = 0;
+      if (inPtId >= numPts)
+      {
+        break;
+      }
     }
+    col += skipCols;
+    sampledPointIds.push_back(inPtId);
   }
 
-  //
-  // Allocate storage for output PolyData
-  //
-  sourcePts = source->GetPoints();
-  numSourcePts = sourcePts->GetNumberOfPoints();
-  numSourceCells = source->GetNumberOfCells();
-
-  newPts = vtkPoints::New();
-  // Allocate as if we will glyph every point
-  // If some are masked/skipped for Resolution this will be fixed later with Squeeze
-  // TO DO allocate less for lower resolution
-  newPts->Allocate(numDirs * numInputPts * numSourcePts);
-
-  // Setting up for calls to PolyData::InsertNextCell()
-  if ((sourceCells = source->GetVerts())->GetNumberOfCells() > 0)
+  // Figure out if we are masking some of the glyphs
+  vtkDataArray* inMask = nullptr;
+  if (this->MaskGlyphs)
   {
-    cells = vtkCellArray::New();
-    cells->Allocate(numDirs * numInputPts * sourceCells->GetSize());
-    output->SetVerts(cells);
-    cells->Delete();
+    if (this->Mask != nullptr)
+    {
+      inMask = this->Mask->GetPointData()->GetScalars();
+    }
+    else
+    {
+      vtkErrorMacro("User has not set input mask, but has requested MaskGlyphs");
+    }
   }
-  if ((sourceCells = this->GetSource()->GetLines())->GetNumberOfCells() > 0)
+
+  //
+  // First pass: find the points to glyph (not masked and with positive trace)
+  // to know the exact size of the output.
+  //
+  vtkDebugMacro(<< "Generating tensor glyphs: SELECT POINTS");
+  std::vector<unsigned char> selected(sampledPointIds.size());
+  GlyphSelectionFunctor selectionFunctor;
+  selectionFunctor.Tensors = inTensors;
+  selectionFunctor.Mask = inMask;
+  selectionFunctor.MaskGlyphs = (this->MaskGlyphs != 0);
+  selectionFunctor.SampledPointIds = sampledPointIds.data();
+  selectionFunctor.Selected = selected.data();
+  vtkSMPTools::For(0, static_cast<vtkIdType>(sampledPointIds.size()), selectionFunctor);
+
+  std::vector<vtkIdType> glyphPointIds;
+  glyphPointIds.reserve(sampledPointIds.size());
+  for (size_t sampleIndex = 0; sampleIndex < sampledPointIds.size(); ++sampleIndex)
   {
-    cells = vtkCellArray::New();
-    cells->Allocate(numDirs * numInputPts * sourceCells->GetSize());
-    output->SetLines(cells);
-    cells->Delete();
+    if (selected[sampleIndex])
+    {
+      glyphPointIds.push_back(sampledPointIds[sampleIndex]);
+    }
   }
-  if ((sourceCells = this->GetSource()->GetPolys())->GetNumberOfCells() > 0)
+  const vtkIdType numGlyphs = static_cast<vtkIdType>(glyphPointIds.size());
+  this->UpdateProgress(0.1);
+  if (this->GetAbortExecute())
   {
-    cells = vtkCellArray::New();
-    cells->Allocate(numDirs * numInputPts * sourceCells->GetSize());
-    output->SetPolys(cells);
-    cells->Delete();
+    return 1;
   }
-  if ((sourceCells = this->GetSource()->GetStrips())->GetNumberOfCells() > 0)
+
+  //
+  // Allocate storage for output PolyData
+  //
+  vtkPoints* sourcePts = source->GetPoints();
+  const vtkIdType numSourcePts = sourcePts->GetNumberOfPoints();
+  const vtkIdType numOutPts = numGlyphs * numDirs * numSourcePts;
+  std::vector<double> sourcePoints(3 * numSourcePts);
+  for (vtkIdType i = 0; i < numSourcePts; i++)
   {
-    cells = vtkCellArray::New();
-    cells->Allocate(numDirs * numInputPts * sourceCells->GetSize());
-    output->SetStrips(cells);
-    cells->Delete();
+    sourcePts->GetPoint(i, &sourcePoints[3 * i]);
   }
 
+  vtkNew<vtkPoints> newPts;
+  newPts->SetDataTypeToFloat();
+  newPts->SetNumberOfPoints(numOutPts);
+
   // Get point data, decide how to allocate scalars
-  pd = this->GetSource()->GetPointData();
+  vtkPointData* sourcePD = source->GetPointData();
 
   // generate scalars if eigenvalues are chosen or if scalars exist.
+  vtkSmartPointer<vtkFloatArray> newScalars;
   if (this->ColorGlyphs &&                          //
       ((this->ColorMode == COLOR_BY_EIGENVALUES) || //
        (inScalars && (this->ColorMode == COLOR_BY_SCALARS))))
   {
-    newScalars = vtkFloatArray::New();
-    newScalars->Allocate(numDirs * numInputPts * numSourcePts);
+    newScalars = vtkSmartPointer<vtkFloatArray>::New();
+    newScalars->SetNumberOfTuples(numOutPts);
   }
-  else
-  {
-    // only copy scalar data through
-    // (superclass does this but why? if user has not asked for ColorGlyphs)
-    outPD->CopyAllOff();
-    outPD->CopyScalarsOn();
-    outPD->CopyAllocate(pd, numDirs * numInputPts * numSourcePts);
-  }
-  if ((sourceNormals = pd->GetNormals()))
+
+  vtkSmartPointer<vtkFloatArray> newNormals;
+  vtkDataArray* sourceNormals = sourcePD->GetNormals();
+  std::vector<double> sourceNormalValues;
+  if (sourceNormals)
   {
-    newNormals = vtkFloatArray::New();
+    newNormals = vtkSmartPointer<vtkFloatArray>::New();
     newNormals->SetNumberOfComponents(3);
-    newNormals->Allocate(numDirs * 3 * numInputPts * numSourcePts);
+    newNormals->SetNumberOfTuples(numOutPts);
+    sourceNormalValues.resize(3 * numSourcePts);
+    for (vtkIdType i = 0; i < numSourcePts; i++)
+    {
+      sourceNormals->GetTuple(i, &sourceNormalValues[3 * i]);
+    }
   }
 
-  // Don't copy all topology here as in superclass because
-  // we are not necessarily outputting a glyph for every point.
-
-  // Figure out if we are masking some of the glyphs
-  inMask = nullptr;
-
-  if (this->MaskGlyphs)
+  // Each source cell array is replicated numDirs times for each glyph
+  vtkCellArray* sourceCellArrays[4] = { source->GetVerts(), source->GetLines(), source->GetPolys(), source->GetStrips() };
+  std::vector<SourceCellArray> sourceCells;
+  std::vector<vtkSmartPointer<vtkIdTypeArray>> outCellOffsets;
+  std::vector<vtkSmartPointer<vtkIdTypeArray>> outCellConnectivity;
+  vtkNew<vtkIdList> cellPts;
+  for (int cellArrayType = 0; cellArrayType < 4; ++cellArrayType)
   {
-    if (this->Mask != nullptr)
+    vtkCellArray* sourceCellArray = sourceCellArrays[cellArrayType];
+    if (!sourceCellArray || sourceCellArray->GetNumberOfCells() == 0)
     {
-      inMask = this->Mask->GetPointData()->GetScalars();
+      continue;
     }
-    else
+    SourceCellArray cells;
+    cells.Type = cellArrayType;
+    cells.Offsets.push_back(0);
+    for (vtkIdType cellId = 0; cellId < sourceCellArray->GetNumberOfCells(); ++cellId)
     {
-      vtkErrorMacro("User has not set input mask, but has requested MaskGlyphs");
+      sourceCellArray->GetCellAtId(cellId, cellPts);
+      for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+      {
+        cells.Connectivity.push_back(cellPts->GetId(i));
+      }
+      cells.Offsets.push_back(static_cast<vtkIdType>(cells.Connectivity.size()));
     }
-  }
-
-  // Figure out if we are transforming output point locations
-  if (this->VolumePositionMatrix)
-  {
-    // user transform to move points
-    userVolumeTransform = vtkTransform::New();
-
-    userVolumeTransform->SetMatrix(this->VolumePositionMatrix);
-    userVolumeTransform->PreMultiply();
+    vtkNew<vtkIdTypeArray> offsets;
+    offsets->SetNumberOfValues(numGlyphs * numDirs * cells.GetNumberOfCells() + 1);
+    offsets->SetValue(offsets->GetNumberOfValues() - 1, numGlyphs * numDirs * cells.GetConnectivitySize());
+    vtkNew<vtkIdTypeArray> connectivity;
+    connectivity->SetNumberOfValues(numGlyphs * numDirs * cells.GetConnectivitySize());
+    sourceCells.push_back(cells);
+    outCellOffsets.emplace_back(offsets.GetPointer());
+    outCellConnectivity.emplace_back(connectivity.GetPointer());
   }
 
   vtkDebugMacro(<< "Generating tensor glyphs: TRAVERSE POINTS");
-
   vtkDebugMacro("Scalar coloring (" << this->ColorMode << ")  [" << vtkTensorGlyph::COLOR_BY_EIGENVALUES << "] is evals. Scalar Invariant (" << this->ScalarInvariant << ")");
 
   //
-  // Traverse all Input points, transforming glyph in this->Source by tensor,
-  // and outputting it at each point.  (Input points are not all used, only
-  // those not masked and included by this->Resolution.)
+  // Second pass: transform glyph in this->Source by tensor at each selected
+  // input point, and write it at its precomputed location of the output.
   //
-  trans->PreMultiply();
-
-  for (inPtId = 0; inPtId < numPts; inPtId += skipCols)
+  GlyphGeometryFunctor geometryFunctor;
+  geometryFunctor.Input = input;
+  geometryFunctor.Tensors = inTensors;
+  geometryFunctor.InScalars = inScalars;
+  geometryFunctor.GlyphPointIds = glyphPointIds.data();
+  geometryFunctor.ExtractEigenvalues = (this->ExtractEigenvalues != 0);
+  geometryFunctor.ColorByScalars = (inScalars && this->ColorGlyphs && this->ColorMode == vtkTensorGlyph::COLOR_BY_SCALARS);
+  geometryFunctor.ColorByEigenvalues = (this->ColorGlyphs && this->ColorMode == vtkTensorGlyph::COLOR_BY_EIGENVALUES);
+  geometryFunctor.ScalarInvariant = this->ScalarInvariant;
+  geometryFunctor.ScaleFactor = this->ScaleFactor;
+  geometryFunctor.ClampScaling = (this->ClampScaling != 0);
+  geometryFunctor.MaxScaleFactor = this->MaxScaleFactor;
+  geometryFunctor.ThreeGlyphs = (this->ThreeGlyphs != 0);
+  geometryFunctor.NumberOfDirections = numDirs;
+  geometryFunctor.Length = this->Length;
+  geometryFunctor.FlipNormals = (this->TensorRotationMatrix && this->TensorRotationMatrix->Determinant() < 0);
+  geometryFunctor.UseVolumePosition = (this->VolumePositionMatrix != nullptr);
+  if (this->VolumePositionMatrix)
   {
-    if (col >= rowLength)
-    {
-      row += skipRows;
-      inPtId = row * rowLength;
-      col = 0;
-      if (inPtId >= numPts)
-      {
-        break;
-      }
-    }
-    col += skipCols;
-    // progress notification
-    if (!(inPtId % 10000))
-    {
-      this->UpdateProgress((double)inPtId / numPts);
-
-      vtkDebugMacro(<< "Generating diffusion tensor glyphs: PROGRESS" << (double)inPtId / numPts);
-      if (this->GetAbortExecute())
-      {
-        break;
-      }
-    }
-
-    inTensors->GetTuple(inPtId, (double*)tensor);
-
-    // Decide whether this tensor will be glyphed:
-    // Threshold by trace ( must be > 0)
-    double trace = vtkDiffusionTensorMathematics::Trace(tensor);
-
-    // Only display this glyph if either:
-    // a) we are masking and the mask is 1 at this location.
-    // b) the trace is positive and we are not masking (default).
-    if (((inMask != nullptr) && inMask->GetTuple1(inPtId)) || (!this->MaskGlyphs && trace > 0))
-    {
-      // copy topology of output glyph for this point
-      for (cellId = 0; cellId < numSourceCells; cellId++)
-      {
-        cell = this->GetSource()->GetCell(cellId);
-        cellPts = cell->GetPointIds();
-        npts = cellPts->GetNumberOfIds();
-        for (dir = 0; dir < numDirs; dir++)
-        {
-          // This variable may be removed, but that
-          // will not improve readability
-          // subIncr = ptIncr + dir*numSourcePts;
-
-          // Add offset calculated from all non-masked points added to output so far
-          subIncr = ptOffset + dir * numSourcePts;
-
-          for (i = 0; i < npts; i++)
-          {
-            pts[i] = cellPts->GetId(i) + subIncr;
-          }
-          output->InsertNextCell(cell->GetCellType(), npts, pts);
-        }
-      }
-
-      // compute orientation vectors and scale factors from tensor
-      if (this->ExtractEigenvalues) // extract appropriate eigenfunctions
-      {
-        for (j = 0; j < 3; j++)
-        {
-          for (i = 0; i < 3; i++)
-          {
-            // this line from vtkTensorGlyph actually transposes
-            // m[i][j] = tensor[i+3*j];
-            // simpler code with 3x3 array:
-            m[i][j] = tensor[j][i];
-          }
-        }
-
-        // vtkMath::Jacobi(m, w, v);
-        //  Use superior eigensolve from teem.
-        vtkDiffusionTensorMathematics::TeemEigenSolver(m, w, v);
-
-        // copy eigenvectors
-        xv[0] = v[0][0];
-        xv[1] = v[1][0];
-        xv[2] = v[2][0];
-        yv[0] = v[0][1];
-        yv[1] = v[1][1];
-        yv[2] = v[2][1];
-        zv[0] = v[0][2];
-        zv[1] = v[1][2];
-        zv[2] = v[2][2];
-      }
-      else // use tensor columns as eigenvectors
-      {
-        for (i = 0; i < 3; i++)
-        {
-          // xv[i] = tensor[i]; // from vtkTensorGlyph
-          // yv[i] = tensor[i+3];
-          // zv[i] = tensor[i+6];
-          xv[i] = tensor[0][i]; // with 3x3 matrix
-          yv[i] = tensor[1][i];
-          zv[i] = tensor[2][i];
-        }
-        w[0] = vtkMath::Normalize(xv);
-        w[1] = vtkMath::Normalize(yv);
-        w[2] = vtkMath::Normalize(zv);
-      }
-
-      // Calculate output scalars before computing glyph scale factors from eigenvalues.
-      // First, pass through input scalars if requested.
-      if (inScalars && this->ColorGlyphs && (this->ColorMode == vtkTensorGlyph::COLOR_BY_SCALARS))
-      {
-        // Copy point data from source
-        s = inScalars->GetComponent(inPtId, 0);
-      }
-
-      // Output scalar invariants if requested
-      else if (this->ColorGlyphs && (this->ColorMode == vtkTensorGlyph::COLOR_BY_EIGENVALUES))
-      {
-        // Correct for negative eigenvalues: use logic coded in vtkDiffusionTensorMathematics
-        vtkDiffusionTensorMathematics::FixNegativeEigenvaluesMethod(w);
-
-        switch (this->ScalarInvariant)
-        {
-          case vtkDiffusionTensorMathematics::VTK_TENS_LINEAR_MEASURE: s = vtkDiffusionTensorMathematics::LinearMeasure(w); break;
-          case vtkDiffusionTensorMathematics::VTK_TENS_PLANAR_MEASURE: s = vtkDiffusionTensorMathematics::PlanarMeasure(w); break;
-          case vtkDiffusionTensorMathematics::VTK_TENS_SPHERICAL_MEASURE: s = vtkDiffusionTensorMathematics::SphericalMeasure(w); break;
-          case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE: s = w[0]; break;
-          case vtkDiffusionTensorMathematics::VTK_TENS_MID_EIGENVALUE: s = w[1]; break;
-          case vtkDiffusionTensorMathematics::VTK_TENS_MIN_EIGENVALUE: s = w[2]; break;
-          case vtkDiffusionTensorMathematics::VTK_TENS_PARALLEL_DIFFUSIVITY: s = w[0]; break;
-          case vtkDiffusionTensorMathematics::VTK_TENS_PERPENDICULAR_DIFFUSIVITY: s = 0.5 * (w[1] + w[2]); break;
-          case vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION:
-            double v_maj[3];
-            v_maj[0] = v[0][0];
-            v_maj[1] = v[1][0];
-            v_maj[2] = v[2][0];
-            if (this->TensorRotationMatrix)
-            {
-              vtkNew<vtkTransform> rotate;
-              rotate->SetMatrix(this->TensorRotationMatrix);
-              rotate->TransformPoint(v_maj, v_maj);
-            }
-            // TO DO: here output as RGB. Need to allocate 3-component scalars first.
-            s = 0;
-            vtkDiffusionTensorMathematics::RGBToIndex(fabs(v_maj[0]), fabs(v_maj[1]), fabs(v_maj[2]), s);
-            break;
-          case vtkDiffusionTensorMathematics::VTK_TENS_RELATIVE_ANISOTROPY: s = vtkDiffusionTensorMathematics::RelativeAnisotropy(w); break;
-          case vtkDiffusionTensorMathematics::VTK_TENS_FRACTIONAL_ANISOTROPY: s = vtkDiffusionTensorMathematics::FractionalAnisotropy(w); break;
-          case vtkDiffusionTensorMathematics::VTK_TENS_TRACE: s = vtkDiffusionTensorMathematics::Trace(w); break;
-          default: s = 0; break;
-        }
-      }
-
-      // Use the square root of the eigenvalues for scaling
-      // for DTI
-      w[0] = sqrt(w[0]);
-      w[1] = sqrt(w[1]);
-      w[2] = sqrt(w[2]);
-
-      // compute scale factors (this modifies eigenvalues so
-      // scalar invariants were computed already above)
-      w[0] *= this->ScaleFactor;
-      w[1] *= this->ScaleFactor;
-      w[2] *= this->ScaleFactor;
-
-      if (this->ClampScaling)
-      {
-        for (maxScale = 0.0, i = 0; i < 3; i++)
-        {
-          if (maxScale < fabs(w[i]))
-          {
-            maxScale = fabs(w[i]);
-          }
-        }
-        if (maxScale > this->MaxScaleFactor)
-        {
-          maxScale = this->MaxScaleFactor / maxScale;
-          for (i = 0; i < 3; i++)
-          {
-            w[i] *= maxScale; // preserve overall shape of glyph
-          }
-        }
-      }
-
-      // normalization is postponed
-
-      // make sure scale is okay (non-zero) and scale data
-      // this scale checking is from superclass code
-      for (maxScale = 0.0, i = 0; i < 3; i++)
-      {
-        if (w[i] > maxScale)
-        {
-          maxScale = w[i];
-        }
-      }
-      if (maxScale == 0.0)
-      {
-        maxScale = 1.0;
-      }
-      for (i = 0; i < 3; i++)
-      {
-        if (w[i] == 0.0)
-        {
-          w[i] = maxScale * 1.0e-06;
-        }
-      }
-
-      // Now do the real work for each "direction"
-      // This is a loop over each eigenvector allowing
-      // a separate glyph for each (or two loops per eigenvector
-      // allowing two symmetric glyphs for each)
-
-      int flipNormals = 0;
-      if (this->TensorRotationMatrix && this->TensorRotationMatrix->Determinant() < 0)
-      {
-        flipNormals = 1;
-      }
-
-      for (dir = 0; dir < numDirs; dir++)
-      {
-        eigen_dir = dir % (this->ThreeGlyphs ? 3 : 1);
-        symmetric_dir = dir / (this->ThreeGlyphs ? 3 : 1);
-
-        // Remove previous scales ...
-        trans->Identity();
-
-        // Actually output the scalar invariant calculated above
-        if (newScalars != nullptr)
-        {
-          for (i = 0; i < numSourcePts; i++)
-          {
-            newScalars->InsertTuple(ptOffset + i, &s);
-          }
-        }
-        else
-        {
-          for (i = 0; i < numSourcePts; i++)
-          {
-            // TO DO: why does superclass have this if no scalar output?
-            // in this case it appears copy scalars is on (above in
-            // scalar allocation section).
-            outPD->CopyData(pd, i, ptOffset + i);
-          }
-        }
-
-        // translate Source to Input point
-        input->GetPoint(inPtId, x);
-
-        // If we have a user-specified matrix modifying the output point locations
-        if (userVolumeTransform != nullptr)
-        {
-          userVolumeTransform->TransformPoint(x, x2);
-          trans->Translate(x2[0], x2[1], x2[2]);
-        }
-        else
-        {
-          trans->Translate(x[0], x[1], x[2]);
-        }
-
-        // If we have a user-specified matrix rotating each tensor
-        if (this->TensorRotationMatrix)
-        {
-          trans->Concatenate(this->TensorRotationMatrix);
-        }
-
-        // normalized eigenvectors rotate object for eigen direction 0
-        matrix->Element[0][0] = xv[0];
-        matrix->Element[0][1] = yv[0];
-        matrix->Element[0][2] = zv[0];
-        matrix->Element[1][0] = xv[1];
-        matrix->Element[1][1] = yv[1];
-        matrix->Element[1][2] = zv[1];
-        matrix->Element[2][0] = xv[2];
-        matrix->Element[2][1] = yv[2];
-        matrix->Element[2][2] = zv[2];
-        trans->Concatenate(matrix);
-
-        if (eigen_dir == 1)
-        {
-          trans->RotateZ(90.0);
-        }
-
-        if (eigen_dir == 2)
-        {
-          trans->RotateY(-90.0);
-        }
-
-        if (this->ThreeGlyphs)
-        {
-          trans->Scale(w[eigen_dir], this->ScaleFactor, this->ScaleFactor);
-        }
-        else
-        {
-          trans->Scale(w[0], w[1], w[2]);
-        }
-
-        // Mirror second set to the symmetric position
-        if (symmetric_dir == 1)
-        {
-          trans->Scale(-1., 1., 1.);
-        }
-
-        // if the eigenvalue is negative, shift to reverse direction.
-        // The && is there to ensure that we do not change the
-        // old behavior of vtkTensorGlyphs (which only used one dir),
-        // in case there is an oriented glyph, e.g. an arrow.
-        if (w[eigen_dir] < 0 && numDirs > 1)
-        {
-          trans->Translate(-this->Length, 0., 0.);
-        }
-
-        // multiply points (and normals if available) by resulting
-        // matrix.
-        // This also appends them to the output "new" data.
-        trans->TransformPoints(sourcePts, newPts);
-
-        // Apply the transformation to a series of points,
-        // and append the results to outPts.
-        if (newNormals)
-        {
-          if (flipNormals)
-          {
-            trans->Scale(-1., -1., -1.);
-            trans->TransformNormals(sourceNormals, newNormals);
-            trans->Scale(-1., -1., -1.);
-          }
-          else
-          {
-            trans->TransformNormals(sourceNormals, newNormals);
-          }
-        }
-
-        // Keep track of the number of points output so far.
-        ptOffset += numSourcePts;
-      } // end for number of dirs
-    } // end if mask is 1 OR trace is ok (so tensor was glyphed)
-  } // end loop over input points
+    vtkMatrix4x4::DeepCopy(geometryFunctor.VolumePosition, this->VolumePositionMatrix);
+  }
+  geometryFunctor.UseTensorRotation = (this->TensorRotationMatrix != nullptr);
+  if (this->TensorRotationMatrix)
+  {
+    vtkMatrix4x4::DeepCopy(geometryFunctor.TensorRotation, this->TensorRotationMatrix);
+  }
+  geometryFunctor.SourcePoints = sourcePoints.data();
+  geometryFunctor.SourceNormals = sourceNormalValues.data();
+  geometryFunctor.NumberOfSourcePoints = numSourcePts;
+  geometryFunctor.SourceCells = &sourceCells;
+  geometryFunctor.OutPoints = static_cast<float*>(newPts->GetVoidPointer(0));
+  geometryFunctor.OutNormals = (newNormals ? newNormals->GetPointer(0) : nullptr);
+  geometryFunctor.OutScalars = (newScalars ? newScalars->GetPointer(0) : nullptr);
+  for (size_t cellArrayIndex = 0; cellArrayIndex < sourceCells.size(); ++cellArrayIndex)
+  {
+    geometryFunctor.OutCellOffsets.push_back(outCellOffsets[cellArrayIndex]->GetPointer(0));
+    geometryFunctor.OutCellConnectivity.push_back(outCellConnectivity[cellArrayIndex]->GetPointer(0));
+  }
+  if (numGlyphs > 0)
+  {
+    // blocks of glyphs are large enough for efficient batched eigensystem computation
+    vtkSMPTools::For(0, numGlyphs, 256, geometryFunctor);
+  }
+  this->UpdateProgress(0.9);
 
-  vtkDebugMacro(<< "Generated " << numInputPts << " tensor glyphs");
+  vtkDebugMacro(<< "Generated " << numGlyphs << " tensor glyphs");
 
   //
-  // Update output and release memory
+  // Update output
   //
-  delete[] pts;
-
   output->SetPoints(newPts);
-  newPts->Delete();
+  for (size_t cellArrayIndex = 0; cellArrayIndex < sourceCells.size(); ++cellArrayIndex)
+  {
+    vtkNew<vtkCellArray> cells;
+    cells->SetData(outCellOffsets[cellArrayIndex], outCellConnectivity[cellArrayIndex]);
+    switch (sourceCells[cellArrayIndex].Type)
+    {
+      case 0: output->SetVerts(cells); break;
+      case 1: output->SetLines(cells); break;
+      case 2: output->SetPolys(cells); break;
+      case 3: output->SetStrips(cells); break;
+    }
+  }
 
   if (newScalars)
   {
     int idx = outPD->AddArray(newScalars);
     outPD->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
-    newScalars->Delete();
+  }
+  else
+  {
+    // only copy scalar data through
+    // (superclass does this but why? if user has not asked for ColorGlyphs)
+    outPD->CopyAllOff();
+    outPD->CopyScalarsOn();
+    outPD->CopyAllocate(sourcePD, numOutPts);
+    for (vtkIdType outPtId = 0; outPtId < numOutPts; outPtId++)
+    {
+      outPD->CopyData(sourcePD, outPtId % numSourcePts, outPtId);
+    }
   }
 
   if (newNormals)
   {
     outPD->SetNormals(newNormals);
-    newNormals->Delete();
   }
 
-  output->Squeeze();
-  trans->Delete();
-  matrix->Delete();
-
-  if (userVolumeTransform)
+  if (useCache)
   {
-    userVolumeTransform->Delete();
+    vtkInternal::CacheEntry entry;
+    entry.Key = cacheKey;
+    entry.Output = vtkSmartPointer<vtkPolyData>::New();
+    entry.Output->ShallowCopy(output);
+    this->Internal->Cache.push_front(entry);
+    this->Internal->TrimCache(this->GlyphCacheSize);
   }
 
   vtkDebugMacro("glyph time: " << clock() - tStart);
@@ -748,6 +1005,33 @@ int vtkDiffusionTensorGlyph::RequestData(vtkInformation* vtkNotUsed(request), vt
   return 1;
 }
 
+//----------------------------------------------------------------------------
+void vtkDiffusionTensorGlyph::SetGlyphCacheSize(int size)
+{
+  // The cache does not change the output, therefore the filter is not modified
+  this->GlyphCacheSize = std::max(size, 0);
+  this->Internal->TrimCache(this->GlyphCacheSize);
+}
+
+//----------------------------------------------------------------------------
+void vtkDiffusionTensorGlyph::ClearGlyphCache()
+{
+  this->Internal->Cache.clear();
+  this->Internal->NumberOfCacheHits = 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkDiffusionTensorGlyph::GetNumberOfCachedGlyphGeometries()
+{
+  return static_cast<int>(this->Internal->Cache.size());
+}
+
+//----------------------------------------------------------------------------
+int vtkDiffusionTensorGlyph::GetNumberOfGlyphCacheHits()
+{
+  return this->Internal->NumberOfCacheHits;
+}
+
 void vtkDiffusionTensorGlyph::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
@@ -755,6 +1039,7 @@ void vtkDiffusionTensorGlyph::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Color Glyphs by Scalar Invariant: " << this->ScalarInvariant << "\n";
   os << indent << "Mask Glyphs: " << (this->MaskGlyphs ? "On\n" : "Off\n");
   os << indent << "Resolution: " << this->Resolution << endl;
+  os << indent << "GlyphCacheSize: " << this->GlyphCacheSize << endl;
 
   // print objects
   if (this->VolumePositionMatrix)
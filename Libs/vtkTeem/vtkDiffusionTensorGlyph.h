@@ -161,6 +161,33 @@ public:
   vtkGetVector2Macro(DimensionResolution, int);
   vtkSetVector2Macro(DimensionResolution, int);
 
+  ///
+  /// Maximum number of glyph geometries kept in the cache.
+  /// Output of each execution is cached, keyed by the input point positions,
+  /// the VolumePositionMatrix and TensorRotationMatrix values, the glyph
+  /// parameters and the tensor, scalar and mask arrays (identified by their
+  /// address and modification time).
+  /// When the filter is re-executed with the same key (for example when a slice
+  /// is moved back to a previously displayed position) the cached geometry is
+  /// returned instead of regenerating the glyphs.
+  /// 0 disables caching. Default is 4.
+  /// Changing the cache size does not modify the filter.
+  void SetGlyphCacheSize(int size);
+  vtkGetMacro(GlyphCacheSize, int);
+
+  ///
+  /// Remove all glyph geometries from the cache.
+  void ClearGlyphCache();
+
+  ///
+  /// Number of glyph geometries currently in the cache.
+  int GetNumberOfCachedGlyphGeometries();
+
+  ///
+  /// Number of executions that were served from the cache since
+  /// the cache was last cleared.
+  int GetNumberOfGlyphCacheHits();
+
   ///
   /// When determining the modified time of the filter,
   /// this checks the modified time of the mask input,
@@ -186,7 +213,12 @@ protected:
 
   vtkImageData* Mask; /// display glyphs at points where mask is nonzero
 
+  int GlyphCacheSize;
+
 private:
+  class vtkInternal;
+  vtkInternal* Internal;
+
   vtkDiffusionTensorGlyph(const vtkDiffusionTensorGlyph&) = delete;
   void operator=(const vtkDiffusionTensorGlyph&) = delete;
 };
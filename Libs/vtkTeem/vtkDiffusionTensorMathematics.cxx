@@ -24,7 +24,9 @@
 #include "vtkImageData.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkDiffusionTensorMathematics.h"
+#include "vtkFloatArray.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkTransform.h"
 #include "vtkPointData.h"
@@ -37,8 +39,11 @@ extern "C"
 #include "teem/ten.h"
 }
 
+#include <algorithm>
+#include <cmath>
 #include <ctime>
 #include <limits>
+#include <vector>
 
 #define VTK_EPS 1e-16
 #define MAX(a, b) (((a) > (b)) ? (a) : (b))
@@ -65,6 +70,7 @@ vtkDiffusionTensorMathematics::vtkDiffusionTensorMathematics()
   this->MaskWithScalars = 0;
   this->FixNegativeEigenvalues = 1;
   this->MaskLabelValue = 1;
+  this->UseTeemEigenSolver = false;
 }
 
 //----------------------------------------------------------------------------
@@ -101,12 +107,7 @@ int vtkDiffusionTensorMathematics::RequestInformation(vtkInformation* vtkNotUsed
                 ext[3] << " " << ext[4] << " " << ext[5]);
 
   // We always want to output float, unless it is color
-  if (this->Operation == VTK_TENS_COLOR_ORIENTATION)
-  {
-    // output color (RGBA)
-    vtkDataObject::SetPointDataActiveScalarInfo(outInfo, VTK_UNSIGNED_CHAR, 4);
-  }
-  else if (this->Operation == VTK_TENS_COLOR_MODE)
+  if (vtkDiffusionTensorMathematics::IsColorOperation(this->Operation))
   {
     // output color (RGBA)
     vtkDataObject::SetPointDataActiveScalarInfo(outInfo, VTK_UNSIGNED_CHAR, 4);
@@ -143,7 +144,7 @@ int vtkDiffusionTensorMathematics::RequestData(vtkInformation* request, vtkInfor
 }
 
 //----------------------------------------------------------------------------
-static void GetContinuousIncrements(vtkImageData* img, int extent[6], vtkIdType& incX, vtkIdType& incY, vtkIdType& incZ)
+static void GetContinuousIncrements(vtkImageData* img, vtkDataArray* array, int extent[6], vtkIdType& incX, vtkIdType& incY, vtkIdType& incZ)
 {
   int e0, e1, e2, e3;
 
@@ -173,7 +174,7 @@ static void GetContinuousIncrements(vtkImageData* img, int extent[6], vtkIdType&
 
   // Make sure the increments are up to date
   vtkIdType inc[3];
-  img->GetArrayIncrements(img->GetPointData()->GetTensors(), inc);
+  img->GetArrayIncrements(array, inc);
   // ComputeIncrements(img, inc);
 
   incY = inc[1] - (e1 - e0 + 1) * inc[0];
@@ -236,7 +237,7 @@ static void vtkDiffusionTensorMathematicsExecute1(vtkDiffusionTensorMathematics*
   // Get increments to march through output data
   outData->GetContinuousIncrements(outExt, outIncX, outIncY, outIncZ);
   // Call special version of GetContinuousIncrements that works for Tensors
-  GetContinuousIncrements(in1Data, outExt, inIncX, inIncY, inIncZ);
+  GetContinuousIncrements(in1Data, inTensors, outExt, inIncX, inIncY, inIncZ);
 
   // Initialize ptId to walk through tensor volume
   //  - these must be of type float - output type will be float or
@@ -343,10 +344,100 @@ inline Type tensor_math_clamp(const Type a, const Type b, const Type c)
   return (a) > (b) ? ((a) < (c) ? (a) : (c)) : (b);
 }
 
+//----------------------------------------------------------------------------
+// Returns true if the operation uses the eigenvectors (not just the eigenvalues).
+static bool vtkDiffusionTensorMathematicsUsesEigenvectors(int op)
+{
+  switch (op)
+  {
+    case vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION:
+    case vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION_MIDDLE_EIGENVECTOR:
+    case vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION_MIN_EIGENVECTOR:
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE_PROJX:
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE_PROJY:
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE_PROJZ:
+    case vtkDiffusionTensorMathematics::VTK_TENS_RAI_MAX_EIGENVEC_PROJX:
+    case vtkDiffusionTensorMathematics::VTK_TENS_RAI_MAX_EIGENVEC_PROJY:
+    case vtkDiffusionTensorMathematics::VTK_TENS_RAI_MAX_EIGENVEC_PROJZ:
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVEC_PROJX:
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVEC_PROJY:
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVEC_PROJZ: return true;
+    default: return false;
+  }
+}
+
+//----------------------------------------------------------------------------
+double vtkDiffusionTensorMathematics::ScalarOperationValue(int op, double tensor[3][3], double w[3], double** v)
+{
+  switch (op)
+  {
+    case vtkDiffusionTensorMathematics::VTK_TENS_D11: return tensor[0][0];
+    case vtkDiffusionTensorMathematics::VTK_TENS_D22: return tensor[1][1];
+    case vtkDiffusionTensorMathematics::VTK_TENS_D33: return tensor[2][2];
+    case vtkDiffusionTensorMathematics::VTK_TENS_TRACE: return vtkDiffusionTensorMathematics::Trace(tensor);
+    case vtkDiffusionTensorMathematics::VTK_TENS_DETERMINANT: return vtkDiffusionTensorMathematics::Determinant(tensor);
+    case vtkDiffusionTensorMathematics::VTK_TENS_RELATIVE_ANISOTROPY: return vtkDiffusionTensorMathematics::RelativeAnisotropy(w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_FRACTIONAL_ANISOTROPY: return vtkDiffusionTensorMathematics::FractionalAnisotropy(w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_LINEAR_MEASURE: return vtkDiffusionTensorMathematics::LinearMeasure(w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_PLANAR_MEASURE: return vtkDiffusionTensorMathematics::PlanarMeasure(w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_SPHERICAL_MEASURE: return vtkDiffusionTensorMathematics::SphericalMeasure(w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE: return w[0];
+    case vtkDiffusionTensorMathematics::VTK_TENS_MID_EIGENVALUE: return w[1];
+    case vtkDiffusionTensorMathematics::VTK_TENS_MIN_EIGENVALUE: return w[2];
+    case vtkDiffusionTensorMathematics::VTK_TENS_PARALLEL_DIFFUSIVITY: return vtkDiffusionTensorMathematics::ParallelDiffusivity(w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_PERPENDICULAR_DIFFUSIVITY: return vtkDiffusionTensorMathematics::PerpendicularDiffusivity(w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_MEAN_DIFFUSIVITY: return vtkDiffusionTensorMathematics::MeanDiffusivity(w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE_PROJX: return vtkDiffusionTensorMathematics::MaxEigenvalueProjectionX(v, w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE_PROJY: return vtkDiffusionTensorMathematics::MaxEigenvalueProjectionY(v, w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE_PROJZ: return vtkDiffusionTensorMathematics::MaxEigenvalueProjectionZ(v, w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_RAI_MAX_EIGENVEC_PROJX: return vtkDiffusionTensorMathematics::RAIMaxEigenvecX(v, w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_RAI_MAX_EIGENVEC_PROJY: return vtkDiffusionTensorMathematics::RAIMaxEigenvecY(v, w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_RAI_MAX_EIGENVEC_PROJZ: return vtkDiffusionTensorMathematics::RAIMaxEigenvecZ(v, w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVEC_PROJX: return vtkDiffusionTensorMathematics::MaxEigenvecX(v, w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVEC_PROJY: return vtkDiffusionTensorMathematics::MaxEigenvecY(v, w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVEC_PROJZ: return vtkDiffusionTensorMathematics::MaxEigenvecZ(v, w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_MODE: return vtkDiffusionTensorMathematics::Mode(w);
+    default: return 0.0;
+  }
+}
+
+//----------------------------------------------------------------------------
+// Writes the RGBA color of the selected eigenvector (column of v), weighted by
+// the linear measure.
+template <class T>
+static void vtkDiffusionTensorMathematicsColorByEigenvector(double** v,
+                                                            double w[3],
+                                                            int eigenvectorIndex,
+                                                            vtkTransform* trans,
+                                                            bool useTransform,
+                                                            double rgb_scale,
+                                                            T* outPtr)
+{
+  // If the user has set the rotation matrix
+  // then transform the eigensystem first
+  // This is used to rotate the vector into RAS space
+  // for consistent anatomical coloring.
+  double v_maj[3] = { v[0][eigenvectorIndex], v[1][eigenvectorIndex], v[2][eigenvectorIndex] };
+  if (useTransform)
+  {
+    trans->TransformPoint(v_maj, v_maj);
+  }
+  // Color R, G, B depending on the eigenvector
+  // scale maps 0..1 values into the range a char takes on
+  double cl = vtkDiffusionTensorMathematics::LinearMeasure(w);
+  for (int i = 0; i < 3; i++)
+  {
+    double rgb_temp = (rgb_scale * fabs(v_maj[i]) * cl);
+    outPtr[i] = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
+  }
+  outPtr[3] = (T)VTK_UNSIGNED_CHAR_MAX; // alpha
+}
+
 //----------------------------------------------------------------------------
 // This templated function executes the filter for any type of data.
 // Handles the one input operations.
-// Handles the ops where eigensystems are computed.
+// Handles the ops where eigensystems are computed and computes
+// additional operations in the same pass.
 template <class T>
 static void vtkDiffusionTensorMathematicsExecute1Eigen(vtkDiffusionTensorMathematics* self, vtkImageData* in1Data, vtkImageData* outData, T* outPtr, int outExt[6], int id)
 {
@@ -374,8 +465,9 @@ static void vtkDiffusionTensorMathematicsExecute1Eigen(vtkDiffusionTensorMathema
   // working matrices
   double *m[3], w[3], *v[3];
   double m0[3], m1[3], m2[3];
-  double v0[3], v1[3], v2[3];
-  double v_maj[3];
+  double v0[3] = { 1.0, 0.0, 0.0 };
+  double v1[3] = { 0.0, 1.0, 0.0 };
+  double v2[3] = { 0.0, 0.0, 1.0 };
   m[0] = m0;
   m[1] = m1;
   m[2] = m2;
@@ -385,7 +477,6 @@ static void vtkDiffusionTensorMathematicsExecute1Eigen(vtkDiffusionTensorMathema
   int i, j;
   double r, g, b;
   int extractEigenvalues;
-  double cl;
   // scaling
   double scaleFactor = self->GetScaleFactor();
 
@@ -420,7 +511,7 @@ static void vtkDiffusionTensorMathematicsExecute1Eigen(vtkDiffusionTensorMathema
   // Get increments to march through output data
   outData->GetContinuousIncrements(outExt, outIncX, outIncY, outIncZ);
   // Call special version of GetContinuousIncrements that works for Tensors
-  GetContinuousIncrements(in1Data, outExt, inIncX, inIncY, inIncZ);
+  GetContinuousIncrements(in1Data, inTensors, outExt, inIncX, inIncY, inIncZ);
 
   // Initialize ptId to walk through tensor volume
   //  - these must be of type float - output type will be float or
@@ -428,9 +519,44 @@ static void vtkDiffusionTensorMathematicsExecute1Eigen(vtkDiffusionTensorMathema
   //  See RequestInformation above.
   float* inPtr = reinterpret_cast<float*>(in1Data->GetArrayPointerForExtent(inTensors, outExt));
 
+  // Additional operations are written into float arrays allocated in PrepareImageData
+  const int numberOfAdditionalOperations = self->GetNumberOfAdditionalOperations();
+  std::vector<int> additionalOps(numberOfAdditionalOperations);
+  std::vector<float*> additionalOutPtrs(numberOfAdditionalOperations);
+  std::vector<vtkIdType> additionalOutIncY(numberOfAdditionalOperations);
+  std::vector<vtkIdType> additionalOutIncZ(numberOfAdditionalOperations);
+  bool needEigenvectors = vtkDiffusionTensorMathematicsUsesEigenvectors(op);
+  for (int opIndex = 0; opIndex < numberOfAdditionalOperations; ++opIndex)
+  {
+    additionalOps[opIndex] = self->GetNthAdditionalOperation(opIndex);
+    vtkDataArray* additionalArray = outData->GetPointData()->GetArray(vtkDiffusionTensorMathematics::GetOperationName(additionalOps[opIndex]));
+    if (!additionalArray || additionalArray->GetDataType() != VTK_FLOAT)
+    {
+      vtkGenericWarningMacro(<< "Output array is not allocated for operation " << additionalOps[opIndex]);
+      return;
+    }
+    additionalOutPtrs[opIndex] = reinterpret_cast<float*>(outData->GetArrayPointerForExtent(additionalArray, outExt));
+    vtkIdType additionalOutIncX = 0;
+    GetContinuousIncrements(outData, additionalArray, outExt, additionalOutIncX, additionalOutIncY[opIndex], additionalOutIncZ[opIndex]);
+    needEigenvectors |= vtkDiffusionTensorMathematicsUsesEigenvectors(additionalOps[opIndex]);
+  }
+
   // decide whether to extract eigenfunctions or just use input cols
   extractEigenvalues = self->GetExtractEigenvalues();
 
+  // Eigensystems of a whole row are computed at once by the batched solver
+  const bool useBatchEigenSolver = extractEigenvalues && !self->GetUseTeemEigenSolver();
+  std::vector<double> rowEigenvalues;
+  std::vector<double> rowEigenvectors;
+  if (useBatchEigenSolver)
+  {
+    rowEigenvalues.resize(3 * rowLength);
+    if (needEigenvectors)
+    {
+      rowEigenvectors.resize(9 * rowLength);
+    }
+  }
+
   // transformation of tensor orientations for coloring
   vtkTransform* trans = vtkTransform::New();
   int useTransform = 0;
@@ -472,14 +598,19 @@ static void vtkDiffusionTensorMathematicsExecute1Eigen(vtkDiffusionTensorMathema
         count++;
       }
 
+      if (useBatchEigenSolver)
+      {
+        // tensors of a row are contiguous in memory
+        vtkDiffusionTensorMathematics::BatchEigenSolver(inPtr, rowLength, rowEigenvalues.data(), needEigenvectors ? rowEigenvectors.data() : nullptr);
+      }
+
       for (idxR = 0; idxR < rowLength; idxR++)
       {
         if (doMasking && *inMaskPtr != self->GetMaskLabelValue())
         {
           *outPtr = 0;
 
-          if (op == vtkDiffusionTensorMathematics::VTK_TENS_COLOR_MODE //
-              || op == vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION)
+          if (vtkDiffusionTensorMathematics::IsColorOperation(op))
           {
             outPtr++;
             *outPtr = 0; // green
@@ -488,6 +619,10 @@ static void vtkDiffusionTensorMathematicsExecute1Eigen(vtkDiffusionTensorMathema
             outPtr++;
             *outPtr = VTK_UNSIGNED_CHAR_MAX; // alpha
           }
+          for (int opIndex = 0; opIndex < numberOfAdditionalOperations; ++opIndex)
+          {
+            *additionalOutPtrs[opIndex] = 0;
+          }
         }
         else
         {
@@ -504,7 +639,25 @@ static void vtkDiffusionTensorMathematicsExecute1Eigen(vtkDiffusionTensorMathema
           tensor[2][2] = static_cast<double>(inPtr[8]);
 
           // get eigenvalues and eigenvectors appropriately
-          if (extractEigenvalues)
+          if (useBatchEigenSolver)
+          {
+            const double* voxelEigenvalues = &rowEigenvalues[3 * idxR];
+            w[0] = voxelEigenvalues[0];
+            w[1] = voxelEigenvalues[1];
+            w[2] = voxelEigenvalues[2];
+            if (needEigenvectors)
+            {
+              const double* voxelEigenvectors = &rowEigenvectors[9 * idxR];
+              for (i = 0; i < 3; i++)
+              {
+                for (j = 0; j < 3; j++)
+                {
+                  v[i][j] = voxelEigenvectors[3 * i + j];
+                }
+              }
+            }
+          }
+          else if (extractEigenvalues)
           {
             for (j = 0; j < 3; j++)
             {
@@ -566,47 +719,6 @@ static void vtkDiffusionTensorMathematicsExecute1Eigen(vtkDiffusionTensorMathema
           // pixel operation
           switch (op)
           {
-            case vtkDiffusionTensorMathematics::VTK_TENS_RELATIVE_ANISOTROPY: *outPtr = static_cast<T>(vtkDiffusionTensorMathematics::RelativeAnisotropy(w)); break;
-            case vtkDiffusionTensorMathematics::VTK_TENS_FRACTIONAL_ANISOTROPY: *outPtr = static_cast<T>(vtkDiffusionTensorMathematics::FractionalAnisotropy(w)); break;
-
-            case vtkDiffusionTensorMathematics::VTK_TENS_LINEAR_MEASURE: *outPtr = static_cast<T>(vtkDiffusionTensorMathematics::LinearMeasure(w)); break;
-
-            case vtkDiffusionTensorMathematics::VTK_TENS_PLANAR_MEASURE: *outPtr = static_cast<T>(vtkDiffusionTensorMathematics::PlanarMeasure(w)); break;
-
-            case vtkDiffusionTensorMathematics::VTK_TENS_SPHERICAL_MEASURE: *outPtr = static_cast<T>(vtkDiffusionTensorMathematics::SphericalMeasure(w)); break;
-
-            case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE: *outPtr = (T)w[0]; break;
-
-            case vtkDiffusionTensorMathematics::VTK_TENS_MID_EIGENVALUE: *outPtr = (T)w[1]; break;
-
-            case vtkDiffusionTensorMathematics::VTK_TENS_MIN_EIGENVALUE: *outPtr = (T)w[2]; break;
-
-            case vtkDiffusionTensorMathematics::VTK_TENS_PARALLEL_DIFFUSIVITY: *outPtr = static_cast<T>(vtkDiffusionTensorMathematics::ParallelDiffusivity(w)); break;
-
-            case vtkDiffusionTensorMathematics::VTK_TENS_PERPENDICULAR_DIFFUSIVITY: *outPtr = static_cast<T>(vtkDiffusionTensorMathematics::PerpendicularDiffusivity(w)); break;
-
-            case vtkDiffusionTensorMathematics::VTK_TENS_MEAN_DIFFUSIVITY: *outPtr = static_cast<T>(vtkDiffusionTensorMathematics::MeanDiffusivity(w)); break;
-
-            case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE_PROJX: *outPtr = static_cast<T>(vtkDiffusionTensorMathematics::MaxEigenvalueProjectionX(v, w)); break;
-
-            case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE_PROJY: *outPtr = static_cast<T>(vtkDiffusionTensorMathematics::MaxEigenvalueProjectionY(v, w)); break;
-
-            case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE_PROJZ: *outPtr = static_cast<T>(vtkDiffusionTensorMathematics::MaxEigenvalueProjectionZ(v, w)); break;
-
-            case vtkDiffusionTensorMathematics::VTK_TENS_RAI_MAX_EIGENVEC_PROJX: *outPtr = static_cast<T>(vtkDiffusionTensorMathematics::RAIMaxEigenvecX(v, w)); break;
-
-            case vtkDiffusionTensorMathematics::VTK_TENS_RAI_MAX_EIGENVEC_PROJY: *outPtr = static_cast<T>(vtkDiffusionTensorMathematics::RAIMaxEigenvecY(v, w)); break;
-
-            case vtkDiffusionTensorMathematics::VTK_TENS_RAI_MAX_EIGENVEC_PROJZ: *outPtr = static_cast<T>(vtkDiffusionTensorMathematics::RAIMaxEigenvecZ(v, w)); break;
-
-            case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVEC_PROJX: *outPtr = static_cast<T>(vtkDiffusionTensorMathematics::MaxEigenvecX(v, w)); break;
-
-            case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVEC_PROJY: *outPtr = static_cast<T>(vtkDiffusionTensorMathematics::MaxEigenvecY(v, w)); break;
-
-            case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVEC_PROJZ: *outPtr = static_cast<T>(vtkDiffusionTensorMathematics::MaxEigenvecZ(v, w)); break;
-
-            case vtkDiffusionTensorMathematics::VTK_TENS_MODE: *outPtr = static_cast<T>(vtkDiffusionTensorMathematics::Mode(w)); break;
-
             case vtkDiffusionTensorMathematics::VTK_TENS_COLOR_MODE:
 
               vtkDiffusionTensorMathematics::ColorByMode(w, r, g, b);
@@ -625,109 +737,56 @@ static void vtkDiffusionTensorMathematicsExecute1Eigen(vtkDiffusionTensorMathema
               break;
 
             case vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION:
-              // If the user has set the rotation matrix
-              // then transform the eigensystem first
-              // This is used to rotate the vector into RAS space
-              // for consistent anatomical coloring.
-              v_maj[0] = v[0][0];
-              v_maj[1] = v[1][0];
-              v_maj[2] = v[2][0];
-              if (useTransform)
-              {
-                trans->TransformPoint(v_maj, v_maj);
-              }
-              // Color R, G, B depending on max eigenvector
-              // scale maps 0..1 values into the range a char takes on
-              cl = vtkDiffusionTensorMathematics::LinearMeasure(w);
-              rgb_temp = (rgb_scale * fabs(v_maj[0]) * cl);
-              *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
-              outPtr++;
-              rgb_temp = (rgb_scale * fabs(v_maj[1]) * cl);
-              *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
-              outPtr++;
-              rgb_temp = (rgb_scale * fabs(v_maj[2]) * cl);
-              *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
-              outPtr++;
-              *outPtr = (T)VTK_UNSIGNED_CHAR_MAX; // alpha
-
+              vtkDiffusionTensorMathematicsColorByEigenvector(v, w, 0, trans, useTransform, rgb_scale, outPtr);
+              outPtr += 3;
               break;
 
             case vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION_MIDDLE_EIGENVECTOR:
-              // If the user has set the rotation matrix
-              // then transform the eigensystem first
-              // This is used to rotate the vector into RAS space
-              // for consistent anatomical coloring.
-              v_maj[0] = v[0][1];
-              v_maj[1] = v[1][1];
-              v_maj[2] = v[2][1];
-              if (useTransform)
-              {
-                trans->TransformPoint(v_maj, v_maj);
-              }
-              // Color R, G, B depending on max eigenvector
-              // scale maps 0..1 values into the range a char takes on
-              cl = vtkDiffusionTensorMathematics::LinearMeasure(w);
-              rgb_temp = (rgb_scale * fabs(v_maj[0]) * cl);
-              *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
-              outPtr++;
-              rgb_temp = (rgb_scale * fabs(v_maj[1]) * cl);
-              *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
-              outPtr++;
-              rgb_temp = (rgb_scale * fabs(v_maj[2]) * cl);
-              *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
-              outPtr++;
-              *outPtr = (T)VTK_UNSIGNED_CHAR_MAX; // alpha
-
+              vtkDiffusionTensorMathematicsColorByEigenvector(v, w, 1, trans, useTransform, rgb_scale, outPtr);
+              outPtr += 3;
               break;
 
             case vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION_MIN_EIGENVECTOR:
-              // If the user has set the rotation matrix
-              // then transform the eigensystem first
-              // This is used to rotate the vector into RAS space
-              // for consistent anatomical coloring.
-              v_maj[0] = v[0][2];
-              v_maj[1] = v[1][2];
-              v_maj[2] = v[2][2];
-              if (useTransform)
-              {
-                trans->TransformPoint(v_maj, v_maj);
-              }
-              // Color R, G, B depending on max eigenvector
-              // scale maps 0..1 values into the range a char takes on
-              cl = vtkDiffusionTensorMathematics::LinearMeasure(w);
-              rgb_temp = (rgb_scale * fabs(v_maj[0]) * cl);
-              *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
-              outPtr++;
-              rgb_temp = (rgb_scale * fabs(v_maj[1]) * cl);
-              *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
-              outPtr++;
-              rgb_temp = (rgb_scale * fabs(v_maj[2]) * cl);
-              *outPtr = (T)tensor_math_clamp(rgb_temp, (double)VTK_UNSIGNED_CHAR_MIN, (double)VTK_UNSIGNED_CHAR_MAX);
-              outPtr++;
-              *outPtr = (T)VTK_UNSIGNED_CHAR_MAX; // alpha
+              vtkDiffusionTensorMathematicsColorByEigenvector(v, w, 2, trans, useTransform, rgb_scale, outPtr);
+              outPtr += 3;
+              break;
 
+            default:
+              // scale double if the user requested this
+              *outPtr = static_cast<T>(scaleFactor * vtkDiffusionTensorMathematics::ScalarOperationValue(op, tensor, w, v));
               break;
           }
 
-          // scale double if the user requested this
-          if (scaleFactor != 1 && op != vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION //
-              && op != vtkDiffusionTensorMathematics::VTK_TENS_COLOR_MODE)
+          // additional operations use the same eigensystem
+          for (int opIndex = 0; opIndex < numberOfAdditionalOperations; ++opIndex)
           {
-            *outPtr = (T)((*outPtr) * scaleFactor);
+            *additionalOutPtrs[opIndex] = static_cast<float>(scaleFactor * vtkDiffusionTensorMathematics::ScalarOperationValue(additionalOps[opIndex], tensor, w, v));
           }
         }
 
         outPtr++;
         inPtr += 9;
         inMaskPtr++;
+        for (int opIndex = 0; opIndex < numberOfAdditionalOperations; ++opIndex)
+        {
+          additionalOutPtrs[opIndex]++;
+        }
       }
       outPtr += outIncY;
       inPtr += inIncY;
       inMaskPtr += maskIncY;
+      for (int opIndex = 0; opIndex < numberOfAdditionalOperations; ++opIndex)
+      {
+        additionalOutPtrs[opIndex] += additionalOutIncY[opIndex];
+      }
     }
     outPtr += outIncZ;
     inPtr += inIncZ;
     inMaskPtr += maskIncZ;
+    for (int opIndex = 0; opIndex < numberOfAdditionalOperations; ++opIndex)
+    {
+      additionalOutPtrs[opIndex] += additionalOutIncZ[opIndex];
+    }
   }
   // Cleanup
   trans->Delete();
@@ -791,56 +850,167 @@ void vtkDiffusionTensorMathematics::ThreadedRequestData(vtkInformation* vtkNotUs
   // single input only for now
   vtkDebugMacro("In Threaded Execute. scalar type is " << inData[0][0]->GetScalarType() << "op is: " << this->Operation);
 
-  switch (this->GetOperation())
+  // Operations where eigenvalues are not computed.
+  // Additional operations are always computed in the eigensystem pass,
+  // which handles all non-color operations.
+  if (!vtkDiffusionTensorMathematics::IsEigenvalueOperation(this->GetOperation()) && this->AdditionalOperations.empty())
+  {
+    switch (outData[0]->GetScalarType())
+    {
+      // we set the output data scalar type depending on the op
+      // already.  And we only access the input tensors
+      // which are float.  So this switch statement on output
+      // scalar type is sufficient.
+      vtkTemplateMacro(vtkDiffusionTensorMathematicsExecute1(this, inData[0][0], outData[0], static_cast<VTK_TT*>(outPtr), outExt, id));
+      default: vtkErrorMacro(<< "Execute: Unknown ScalarType"); return;
+    }
+  }
+  // Operations where eigenvalues are computed
+  else
+  {
+    switch (outData[0]->GetScalarType())
+    {
+      vtkTemplateMacro(vtkDiffusionTensorMathematicsExecute1Eigen(this, inData[0][0], outData[0], static_cast<VTK_TT*>(outPtr), outExt, id));
+      default: vtkErrorMacro(<< "Execute: Unknown ScalarType"); return;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkDiffusionTensorMathematics::PrepareImageData(vtkInformationVector** inputVector,
+                                                     vtkInformationVector* outputVector,
+                                                     vtkImageData*** inDataObjects,
+                                                     vtkImageData** outDataObjects)
+{
+  this->Superclass::PrepareImageData(inputVector, outputVector, inDataObjects, outDataObjects);
+
+  vtkImageData* outData = vtkImageData::GetData(outputVector, 0);
+  if (!outData)
+  {
+    return;
+  }
+  vtkIdType numberOfPoints = outData->GetNumberOfPoints();
+  for (int op : this->AdditionalOperations)
+  {
+    vtkNew<vtkFloatArray> additionalArray;
+    additionalArray->SetName(vtkDiffusionTensorMathematics::GetOperationName(op));
+    additionalArray->SetNumberOfTuples(numberOfPoints);
+    outData->GetPointData()->AddArray(additionalArray);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkDiffusionTensorMathematics::AddAdditionalOperation(int op)
+{
+  if (op < VTK_TENS_TRACE || op > VTK_TENS_MEAN_DIFFUSIVITY)
+  {
+    vtkErrorMacro("AddAdditionalOperation: invalid operation " << op);
+    return;
+  }
+  if (vtkDiffusionTensorMathematics::IsColorOperation(op))
+  {
+    vtkErrorMacro("AddAdditionalOperation: color operation " << op << " cannot be used as additional operation");
+    return;
+  }
+  if (std::find(this->AdditionalOperations.begin(), this->AdditionalOperations.end(), op) != this->AdditionalOperations.end())
+  {
+    // already added
+    return;
+  }
+  this->AdditionalOperations.push_back(op);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkDiffusionTensorMathematics::RemoveAllAdditionalOperations()
+{
+  if (this->AdditionalOperations.empty())
+  {
+    return;
+  }
+  this->AdditionalOperations.clear();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkDiffusionTensorMathematics::GetNumberOfAdditionalOperations()
+{
+  return static_cast<int>(this->AdditionalOperations.size());
+}
+
+//----------------------------------------------------------------------------
+int vtkDiffusionTensorMathematics::GetNthAdditionalOperation(int n)
+{
+  if (n < 0 || n >= static_cast<int>(this->AdditionalOperations.size()))
   {
+    vtkErrorMacro("GetNthAdditionalOperation: index " << n << " is out of range");
+    return -1;
+  }
+  return this->AdditionalOperations[n];
+}
 
-      // Operations where eigenvalues are not computed
+//----------------------------------------------------------------------------
+const char* vtkDiffusionTensorMathematics::GetOperationName(int op)
+{
+  switch (op)
+  {
+    case VTK_TENS_TRACE: return "Trace";
+    case VTK_TENS_DETERMINANT: return "Determinant";
+    case VTK_TENS_RELATIVE_ANISOTROPY: return "RelativeAnisotropy";
+    case VTK_TENS_FRACTIONAL_ANISOTROPY: return "FractionalAnisotropy";
+    case VTK_TENS_MAX_EIGENVALUE: return "MaxEigenvalue";
+    case VTK_TENS_MID_EIGENVALUE: return "MidEigenvalue";
+    case VTK_TENS_MIN_EIGENVALUE: return "MinEigenvalue";
+    case VTK_TENS_LINEAR_MEASURE: return "LinearMeasure";
+    case VTK_TENS_PLANAR_MEASURE: return "PlanarMeasure";
+    case VTK_TENS_SPHERICAL_MEASURE: return "SphericalMeasure";
+    case VTK_TENS_COLOR_ORIENTATION: return "ColorOrientation";
+    case VTK_TENS_D11: return "D11";
+    case VTK_TENS_D22: return "D22";
+    case VTK_TENS_D33: return "D33";
+    case VTK_TENS_MODE: return "Mode";
+    case VTK_TENS_COLOR_MODE: return "ColorMode";
+    case VTK_TENS_MAX_EIGENVALUE_PROJX: return "MaxEigenvalueProjectionX";
+    case VTK_TENS_MAX_EIGENVALUE_PROJY: return "MaxEigenvalueProjectionY";
+    case VTK_TENS_MAX_EIGENVALUE_PROJZ: return "MaxEigenvalueProjectionZ";
+    case VTK_TENS_RAI_MAX_EIGENVEC_PROJX: return "RAIMaxEigenvecX";
+    case VTK_TENS_RAI_MAX_EIGENVEC_PROJY: return "RAIMaxEigenvecY";
+    case VTK_TENS_RAI_MAX_EIGENVEC_PROJZ: return "RAIMaxEigenvecZ";
+    case VTK_TENS_MAX_EIGENVEC_PROJX: return "MaxEigenvecX";
+    case VTK_TENS_MAX_EIGENVEC_PROJY: return "MaxEigenvecY";
+    case VTK_TENS_MAX_EIGENVEC_PROJZ: return "MaxEigenvecZ";
+    case VTK_TENS_PARALLEL_DIFFUSIVITY: return "ParallelDiffusivity";
+    case VTK_TENS_PERPENDICULAR_DIFFUSIVITY: return "PerpendicularDiffusivity";
+    case VTK_TENS_COLOR_ORIENTATION_MIDDLE_EIGENVECTOR: return "ColorOrientationMiddleEigenvector";
+    case VTK_TENS_COLOR_ORIENTATION_MIN_EIGENVECTOR: return "ColorOrientationMinEigenvector";
+    case VTK_TENS_MEAN_DIFFUSIVITY: return "MeanDiffusivity";
+    default: return "";
+  }
+}
+
+//----------------------------------------------------------------------------
+bool vtkDiffusionTensorMathematics::IsEigenvalueOperation(int op)
+{
+  switch (op)
+  {
     case VTK_TENS_D11:
     case VTK_TENS_D22:
     case VTK_TENS_D33:
     case VTK_TENS_TRACE:
-    case VTK_TENS_DETERMINANT:
-      switch (outData[0]->GetScalarType())
-      {
-        // we set the output data scalar type depending on the op
-        // already.  And we only access the input tensors
-        // which are float.  So this switch statement on output
-        // scalar type is sufficient.
-        vtkTemplateMacro(vtkDiffusionTensorMathematicsExecute1(this, inData[0][0], outData[0], static_cast<VTK_TT*>(outPtr), outExt, id));
-        default: vtkErrorMacro(<< "Execute: Unknown ScalarType"); return;
-      }
-      break;
-
-    // Operations where eigenvalues are computed
-    case VTK_TENS_RELATIVE_ANISOTROPY:
-    case VTK_TENS_FRACTIONAL_ANISOTROPY:
-    case VTK_TENS_LINEAR_MEASURE:
-    case VTK_TENS_PLANAR_MEASURE:
-    case VTK_TENS_SPHERICAL_MEASURE:
-    case VTK_TENS_MAX_EIGENVALUE:
-    case VTK_TENS_MID_EIGENVALUE:
-    case VTK_TENS_MIN_EIGENVALUE:
-    case VTK_TENS_MAX_EIGENVALUE_PROJX:
-    case VTK_TENS_MAX_EIGENVALUE_PROJY:
-    case VTK_TENS_MAX_EIGENVALUE_PROJZ:
-    case VTK_TENS_RAI_MAX_EIGENVEC_PROJX:
-    case VTK_TENS_RAI_MAX_EIGENVEC_PROJY:
-    case VTK_TENS_RAI_MAX_EIGENVEC_PROJZ:
-    case VTK_TENS_COLOR_ORIENTATION:
-    case VTK_TENS_MODE:
-    case VTK_TENS_COLOR_MODE:
-    case VTK_TENS_PARALLEL_DIFFUSIVITY:
-    case VTK_TENS_PERPENDICULAR_DIFFUSIVITY:
-    case VTK_TENS_MEAN_DIFFUSIVITY:
-      switch (outData[0]->GetScalarType())
-      {
-        vtkTemplateMacro(vtkDiffusionTensorMathematicsExecute1Eigen(this, inData[0][0], outData[0], static_cast<VTK_TT*>(outPtr), outExt, id));
-        default: vtkErrorMacro(<< "Execute: Unknown ScalarType"); return;
-      }
-      break;
+    case VTK_TENS_DETERMINANT: return false;
+    default: return true;
   }
 }
 
+//----------------------------------------------------------------------------
+bool vtkDiffusionTensorMathematics::IsColorOperation(int op)
+{
+  return (op == VTK_TENS_COLOR_ORIENTATION                       //
+          || op == VTK_TENS_COLOR_MODE                           //
+          || op == VTK_TENS_COLOR_ORIENTATION_MIDDLE_EIGENVECTOR //
+          || op == VTK_TENS_COLOR_ORIENTATION_MIN_EIGENVECTOR);
+}
+
 // Fix negative Eigen with a shift
 /*
 int  vtkDiffusionTensorMathematics::FixNegativeEigenvaluesMethod(double w[3])
@@ -1084,6 +1254,13 @@ void vtkDiffusionTensorMathematics::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
 
   os << indent << "Operation: " << this->Operation << "\n";
+  os << indent << "AdditionalOperations:";
+  for (int op : this->AdditionalOperations)
+  {
+    os << " " << op;
+  }
+  os << "\n";
+  os << indent << "UseTeemEigenSolver: " << this->UseTeemEigenSolver << "\n";
 }
 
 // Colormap: convert our mode value (-1..1) to RGB
@@ -1295,3 +1472,238 @@ int vtkDiffusionTensorMathematics::TeemEigenSolver(double** m, double* w, double
   w[eval_indices[2]] = eval[2];
   return res;
 }
+
+//----------------------------------------------------------------------------
+// Number of tensors that are processed together by BatchEigenSolver.
+// Block data is kept on the stack and in cache.
+static const int EIGEN_SOLVER_BLOCK_SIZE = 64;
+
+//----------------------------------------------------------------------------
+// Eigenvector of a symmetric matrix for an eigenvalue of multiplicity 1.
+// It is orthogonal to all rows of (A - eval*I), therefore it is computed as the
+// cross product of two rows, choosing the pair that gives the most accurate result.
+// The matrix is stored as (a00, a01, a02, a11, a12, a22).
+static void ComputeSingleEigenvector(const double a[6], double eval, double evec[3])
+{
+  double row0[3] = { a[0] - eval, a[1], a[2] };
+  double row1[3] = { a[1], a[3] - eval, a[4] };
+  double row2[3] = { a[2], a[4], a[5] - eval };
+  double r0xr1[3], r0xr2[3], r1xr2[3];
+  vtkMath::Cross(row0, row1, r0xr1);
+  vtkMath::Cross(row0, row2, r0xr2);
+  vtkMath::Cross(row1, row2, r1xr2);
+  double d0 = vtkMath::Dot(r0xr1, r0xr1);
+  double d1 = vtkMath::Dot(r0xr2, r0xr2);
+  double d2 = vtkMath::Dot(r1xr2, r1xr2);
+  const double* cross = r0xr1;
+  double dmax = d0;
+  if (d1 > dmax)
+  {
+    cross = r0xr2;
+    dmax = d1;
+  }
+  if (d2 > dmax)
+  {
+    cross = r1xr2;
+    dmax = d2;
+  }
+  if (dmax <= 0.0)
+  {
+    // all eigenvalues are the same, any vector is an eigenvector
+    evec[0] = 1.0;
+    evec[1] = 0.0;
+    evec[2] = 0.0;
+    return;
+  }
+  const double invLength = 1.0 / sqrt(dmax);
+  evec[0] = cross[0] * invLength;
+  evec[1] = cross[1] * invLength;
+  evec[2] = cross[2] * invLength;
+}
+
+//----------------------------------------------------------------------------
+// Eigenvector of a symmetric matrix that is orthogonal to an already known
+// eigenvector evec0. It is found in the plane orthogonal to evec0 by solving a 2x2 problem,
+// which is robust even if eval1 has multiplicity 2.
+// See D. Eberly, "A Robust Eigensolver for 3x3 Symmetric Matrices".
+static void ComputeOrthogonalEigenvector(const double a[6], const double evec0[3], double eval1, double evec1[3])
+{
+  // orthonormal basis (u, v) of the plane orthogonal to evec0
+  double u[3], v[3];
+  if (fabs(evec0[0]) > fabs(evec0[1]))
+  {
+    const double invLength = 1.0 / sqrt(evec0[0] * evec0[0] + evec0[2] * evec0[2]);
+    u[0] = -evec0[2] * invLength;
+    u[1] = 0.0;
+    u[2] = evec0[0] * invLength;
+  }
+  else
+  {
+    const double invLength = 1.0 / sqrt(evec0[1] * evec0[1] + evec0[2] * evec0[2]);
+    u[0] = 0.0;
+    u[1] = evec0[2] * invLength;
+    u[2] = -evec0[1] * invLength;
+  }
+  vtkMath::Cross(evec0, u, v);
+
+  double au[3] = { a[0] * u[0] + a[1] * u[1] + a[2] * u[2], //
+                   a[1] * u[0] + a[3] * u[1] + a[4] * u[2], //
+                   a[2] * u[0] + a[4] * u[1] + a[5] * u[2] };
+  double av[3] = { a[0] * v[0] + a[1] * v[1] + a[2] * v[2], //
+                   a[1] * v[0] + a[3] * v[1] + a[4] * v[2], //
+                   a[2] * v[0] + a[4] * v[1] + a[5] * v[2] };
+
+  // 2x2 matrix (A - eval1*I) in the (u, v) basis
+  double m00 = vtkMath::Dot(u, au) - eval1;
+  double m01 = vtkMath::Dot(u, av);
+  double m11 = vtkMath::Dot(v, av) - eval1;
+  const double absM00 = fabs(m00);
+  const double absM01 = fabs(m01);
+  const double absM11 = fabs(m11);
+  double coefU = 1.0;
+  double coefV = 0.0;
+  if (absM00 >= absM11)
+  {
+    if (std::max(absM00, absM01) > 0.0)
+    {
+      if (absM00 >= absM01)
+      {
+        m01 /= m00;
+        m00 = 1.0 / sqrt(1.0 + m01 * m01);
+        m01 *= m00;
+      }
+      else
+      {
+        m00 /= m01;
+        m01 = 1.0 / sqrt(1.0 + m00 * m00);
+        m00 *= m01;
+      }
+      coefU = m01;
+      coefV = -m00;
+    }
+  }
+  else
+  {
+    if (std::max(absM11, absM01) > 0.0)
+    {
+      if (absM11 >= absM01)
+      {
+        m01 /= m11;
+        m11 = 1.0 / sqrt(1.0 + m01 * m01);
+        m01 *= m11;
+      }
+      else
+      {
+        m11 /= m01;
+        m01 = 1.0 / sqrt(1.0 + m11 * m11);
+        m11 *= m01;
+      }
+      coefU = m11;
+      coefV = -m01;
+    }
+  }
+  for (int i = 0; i < 3; i++)
+  {
+    evec1[i] = coefU * u[i] + coefV * v[i];
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkDiffusionTensorMathematics::BatchEigenSolver(const float* tensors, vtkIdType numberOfTensors, double* w, double* v)
+{
+  // Tensor elements and eigenvalues of a block in structure-of-arrays layout
+  double a[6][EIGEN_SOLVER_BLOCK_SIZE];
+  double scale[EIGEN_SOLVER_BLOCK_SIZE];
+  double eval[3][EIGEN_SOLVER_BLOCK_SIZE];
+  const double twoThirdsPi = 2.0 * vtkMath::Pi() / 3.0;
+
+  for (vtkIdType blockStart = 0; blockStart < numberOfTensors; blockStart += EIGEN_SOLVER_BLOCK_SIZE)
+  {
+    const int blockSize = static_cast<int>(std::min<vtkIdType>(EIGEN_SOLVER_BLOCK_SIZE, numberOfTensors - blockStart));
+    const float* blockTensors = tensors + 9 * blockStart;
+
+    // Gather the upper triangle of the transposed tensor (as in TeemEigenSolver)
+    // and normalize by the largest element to avoid overflow and loss of precision.
+    for (int k = 0; k < blockSize; k++)
+    {
+      const float* t = blockTensors + 9 * k;
+      a[0][k] = t[0];
+      a[1][k] = t[3];
+      a[2][k] = t[6];
+      a[3][k] = t[4];
+      a[4][k] = t[7];
+      a[5][k] = t[8];
+      double maxAbs = std::max(std::max(std::max(fabs(a[0][k]), fabs(a[1][k])), std::max(fabs(a[2][k]), fabs(a[3][k]))), //
+                               std::max(fabs(a[4][k]), fabs(a[5][k])));
+      scale[k] = maxAbs;
+      const double invScale = (maxAbs > 0.0 ? 1.0 / maxAbs : 0.0);
+      for (int i = 0; i < 6; i++)
+      {
+        a[i][k] *= invScale;
+      }
+    }
+
+    // Closed-form eigenvalues in descending order (O. K. Smith, 1961).
+    // This loop has no data-dependent branches so that it can be vectorized.
+    for (int k = 0; k < blockSize; k++)
+    {
+      const double mean = (a[0][k] + a[3][k] + a[5][k]) / 3.0;
+      const double b00 = a[0][k] - mean;
+      const double b11 = a[3][k] - mean;
+      const double b22 = a[5][k] - mean;
+      const double offDiagonal2 = a[1][k] * a[1][k] + a[2][k] * a[2][k] + a[4][k] * a[4][k];
+      const double p = (b00 * b00 + b11 * b11 + b22 * b22 + 2.0 * offDiagonal2) / 6.0;
+      const double halfDet = 0.5
+                             * (b00 * (b11 * b22 - a[4][k] * a[4][k])      //
+                                - a[1][k] * (a[1][k] * b22 - a[4][k] * a[2][k]) //
+                                + a[2][k] * (a[1][k] * a[4][k] - b11 * a[2][k]));
+      const double sqrtP = sqrt(p);
+      double ratio = (p > 0.0 ? halfDet / (p * sqrtP) : 0.0);
+      ratio = (ratio < -1.0 ? -1.0 : (ratio > 1.0 ? 1.0 : ratio));
+      const double phi = acos(ratio) / 3.0;
+      eval[0][k] = mean + 2.0 * sqrtP * cos(phi);
+      eval[2][k] = mean + 2.0 * sqrtP * cos(phi + twoThirdsPi);
+      eval[1][k] = 3.0 * mean - eval[0][k] - eval[2][k];
+    }
+
+    // Eigenvectors: the eigenvector of the most distinct eigenvalue is computed first,
+    // the second one in the plane orthogonal to it, the third one is their cross product.
+    if (v)
+    {
+      for (int k = 0; k < blockSize; k++)
+      {
+        double ak[6] = { a[0][k], a[1][k], a[2][k], a[3][k], a[4][k], a[5][k] };
+        double evec[3][3];
+        if (eval[0][k] - eval[1][k] >= eval[1][k] - eval[2][k])
+        {
+          ComputeSingleEigenvector(ak, eval[0][k], evec[0]);
+          ComputeOrthogonalEigenvector(ak, evec[0], eval[1][k], evec[1]);
+          vtkMath::Cross(evec[0], evec[1], evec[2]);
+        }
+        else
+        {
+          ComputeSingleEigenvector(ak, eval[2][k], evec[2]);
+          ComputeOrthogonalEigenvector(ak, evec[2], eval[1][k], evec[1]);
+          vtkMath::Cross(evec[1], evec[2], evec[0]);
+        }
+        // eigenvectors are stored in columns
+        double* vk = v + 9 * (blockStart + k);
+        for (int i = 0; i < 3; i++)
+        {
+          for (int j = 0; j < 3; j++)
+          {
+            vk[3 * i + j] = evec[j][i];
+          }
+        }
+      }
+    }
+
+    for (int k = 0; k < blockSize; k++)
+    {
+      double* wk = w + 3 * (blockStart + k);
+      wk[0] = eval[0][k] * scale[k];
+      wk[1] = eval[1][k] * scale[k];
+      wk[2] = eval[2][k] * scale[k];
+    }
+  }
+}
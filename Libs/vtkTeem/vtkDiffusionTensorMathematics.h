@@ -31,6 +31,9 @@
 // VTK includes
 #include <vtkThreadedImageAlgorithm.h>
 
+// STD includes
+#include <vector>
+
 class vtkMatrix4x4;
 class vtkImageData;
 class VTK_Teem_EXPORT vtkDiffusionTensorMathematics : public vtkThreadedImageAlgorithm
@@ -144,6 +147,37 @@ public:
   /// Thanks to Gordon Lothar Kindlmann for this method.
   void SetOperationToColorByMode() { this->SetOperation(VTK_TENS_COLOR_MODE); };
 
+  ///
+  /// Additional operations that are computed in the same pass as Operation.
+  /// Computing several scalar maps this way requires a single traversal of the
+  /// tensors and a single eigensystem computation per voxel.
+  /// The result of each additional operation is stored in a float point data array
+  /// of the output, named by GetOperationName(). Color operations (RGBA output)
+  /// cannot be used as additional operations.
+  void AddAdditionalOperation(int op);
+  void RemoveAllAdditionalOperations();
+  int GetNumberOfAdditionalOperations();
+  int GetNthAdditionalOperation(int n);
+
+  ///
+  /// Name of the output point data array of an additional operation.
+  static const char* GetOperationName(int op);
+
+  ///
+  /// Returns true if the operation requires computation of eigenvalues.
+  static bool IsEigenvalueOperation(int op);
+
+  ///
+  /// Returns true if the operation outputs RGBA color.
+  static bool IsColorOperation(int op);
+
+  ///
+  /// Value of an operation that outputs a single scalar (not color) for one tensor.
+  /// w are the eigenvalues sorted in decreasing order and v the eigenvectors (in columns),
+  /// as computed by TeemEigenSolver. They are not used by non-eigenvalue operations.
+  /// Scale factor is not applied.
+  static double ScalarOperationValue(int op, double tensor[3][3], double w[3], double** v);
+
   ///
   /// Specify scale factor to scale output (float) scalars by.
   /// This is not used when the output is RGBA (char color data).
@@ -156,6 +190,13 @@ public:
   vtkBooleanMacro(ExtractEigenvalues, int);
   vtkGetMacro(ExtractEigenvalues, int);
 
+  ///
+  /// Use the teem eigensolver for each voxel instead of the batched closed-form
+  /// eigensolver (see BatchEigenSolver). Off by default.
+  vtkSetMacro(UseTeemEigenSolver, bool);
+  vtkBooleanMacro(UseTeemEigenSolver, bool);
+  vtkGetMacro(UseTeemEigenSolver, bool);
+
   /// Description
   /// This matrix is only used for ColorByOrientation.
   /// We transform the tensor orientation by this matrix
@@ -236,6 +277,17 @@ public:
   // Description
   // Wrap function to teem eigen solver
   static int TeemEigenSolver(double** m, double* w, double** v);
+
+  // Description
+  // Compute eigensystems of a series of symmetric tensors.
+  // Tensors are read as 9 consecutive floats each (3x3 matrix).
+  // Eigenvalues are written into w (3 values per tensor, in descending order).
+  // If v is not nullptr then eigenvectors are written into v (9 values per tensor,
+  // 3x3 row-major matrix with eigenvectors in the columns, as in TeemEigenSolver).
+  // Eigenvalues are computed in closed form on blocks of tensors stored in
+  // structure-of-arrays layout, which allows the compiler to vectorize the computation.
+  // Results match TeemEigenSolver within floating-point tolerance.
+  static void BatchEigenSolver(const float* tensors, vtkIdType numberOfTensors, double* w, double* v);
   void ComputeTensorIncrements(vtkImageData* imageData, vtkIdType incr[3]);
 
 protected:
@@ -253,6 +305,9 @@ protected:
   vtkMatrix4x4* TensorRotationMatrix;
   int FixNegativeEigenvalues;
 
+  bool UseTeemEigenSolver;
+  std::vector<int> AdditionalOperations;
+
   int RequestInformation(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
 
   void ThreadedRequestData(vtkInformation* request,
@@ -268,6 +323,12 @@ protected:
   // Reimplemented to delete the tensor array of the output.
   int RequestData(vtkInformation* request, vtkInformationVector** inputVector, vtkInformationVector* outputVector) override;
 
+  // Reimplemented to allocate output arrays of additional operations.
+  void PrepareImageData(vtkInformationVector** inputVector,
+                        vtkInformationVector* outputVector,
+                        vtkImageData*** inDataObjects = nullptr,
+                        vtkImageData** outDataObjects = nullptr) override;
+
 private:
   vtkDiffusionTensorMathematics(const vtkDiffusionTensorMathematics&) = delete;
   void operator=(const vtkDiffusionTensorMathematics&) = delete;
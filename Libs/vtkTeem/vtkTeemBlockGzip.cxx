@@ -0,0 +1,418 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkTeem includes
+#include "vtkTeemBlockGzip.h"
+
+// VTK includes
+#include <vtkSMPTools.h>
+#include <vtk_zlib.h>
+
+// STD includes
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+const size_t vtkTeemBlockGzip::DefaultBlockSize = 1 << 20;
+
+namespace
+{
+
+// Gzip extra subfield identifier of the block index
+const unsigned char BLOCK_INDEX_ID1 = 'S';
+const unsigned char BLOCK_INDEX_ID2 = 'l';
+const unsigned char BLOCK_INDEX_VERSION = 1;
+// version (1), block size (4), data size (8), number of blocks (4)
+const size_t BLOCK_INDEX_HEADER_SIZE = 17;
+// The extra field (including the 4-byte subfield header) must fit into 65535 bytes
+const size_t MAXIMUM_NUMBER_OF_BLOCKS = (65535 - 4 - BLOCK_INDEX_HEADER_SIZE) / 4;
+// Number of blocks that are compressed or decompressed at once, limits the memory used for compressed blocks
+const size_t NUMBER_OF_BLOCKS_PER_BATCH = 64;
+
+// Gzip header flags
+const unsigned char GZIP_FHCRC = 0x02;
+const unsigned char GZIP_FEXTRA = 0x04;
+const unsigned char GZIP_FNAME = 0x08;
+const unsigned char GZIP_FCOMMENT = 0x10;
+
+//----------------------------------------------------------------------------
+void AppendUInt(std::vector<unsigned char>& buffer, unsigned long long value, int numberOfBytes)
+{
+  for (int i = 0; i < numberOfBytes; ++i)
+  {
+    buffer.push_back(static_cast<unsigned char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+//----------------------------------------------------------------------------
+unsigned long long ParseUInt(const unsigned char* buffer, int numberOfBytes)
+{
+  unsigned long long value = 0;
+  for (int i = numberOfBytes - 1; i >= 0; --i)
+  {
+    value = (value << 8) | buffer[i];
+  }
+  return value;
+}
+
+//----------------------------------------------------------------------------
+struct Block
+{
+  const unsigned char* Input{ nullptr };
+  unsigned char* Output{ nullptr };
+  size_t InputSize{ 0 };
+  size_t OutputSize{ 0 };
+  std::vector<unsigned char> Compressed;
+  uLong Crc{ 0 };
+  bool Last{ false };
+  bool Success{ false };
+};
+
+//----------------------------------------------------------------------------
+// Compress a block into a raw deflate stream. All blocks except the last one end
+// with a full flush, so that the next block can be decompressed independently.
+void CompressBlock(Block& block, int compressionLevel)
+{
+  block.Success = false;
+  block.Crc = crc32(crc32(0L, Z_NULL, 0), block.Input, static_cast<uInt>(block.InputSize));
+
+  z_stream strm;
+  memset(&strm, 0, sizeof(strm));
+  if (deflateInit2(&strm, compressionLevel, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+  {
+    return;
+  }
+  // deflateBound does not include the bytes of the empty stored block of the full flush
+  block.Compressed.resize(deflateBound(&strm, static_cast<uLong>(block.InputSize)) + 16);
+  strm.next_in = const_cast<Bytef*>(block.Input);
+  strm.avail_in = static_cast<uInt>(block.InputSize);
+  strm.next_out = block.Compressed.data();
+  strm.avail_out = static_cast<uInt>(block.Compressed.size());
+  int result = deflate(&strm, block.Last ? Z_FINISH : Z_FULL_FLUSH);
+  if (block.Last)
+  {
+    block.Success = (result == Z_STREAM_END);
+  }
+  else
+  {
+    block.Success = (result == Z_OK && strm.avail_in == 0 && strm.avail_out > 0);
+  }
+  block.Compressed.resize(strm.total_out);
+  deflateEnd(&strm);
+}
+
+//----------------------------------------------------------------------------
+void DecompressBlock(Block& block)
+{
+  block.Success = false;
+
+  z_stream strm;
+  memset(&strm, 0, sizeof(strm));
+  if (inflateInit2(&strm, -MAX_WBITS) != Z_OK)
+  {
+    return;
+  }
+  strm.next_in = const_cast<Bytef*>(block.Input);
+  strm.avail_in = static_cast<uInt>(block.InputSize);
+  // inflate does not accept a null output buffer, even if the output is empty
+  unsigned char emptyOutput = 0;
+  strm.next_out = block.OutputSize > 0 ? block.Output : &emptyOutput;
+  strm.avail_out = static_cast<uInt>(block.OutputSize);
+  int result = inflate(&strm, Z_SYNC_FLUSH);
+  if (block.Last)
+  {
+    block.Success = (result == Z_STREAM_END);
+  }
+  else
+  {
+    block.Success = (result == Z_OK || result == Z_BUF_ERROR);
+  }
+  block.Success = block.Success && strm.avail_in == 0 && strm.avail_out == 0;
+  inflateEnd(&strm);
+
+  if (block.Success)
+  {
+    block.Crc = crc32(crc32(0L, Z_NULL, 0), block.Output, static_cast<uInt>(block.OutputSize));
+  }
+}
+
+//----------------------------------------------------------------------------
+bool SkipZeroTerminatedString(std::istream& stream)
+{
+  char c = 0;
+  while (stream.get(c))
+  {
+    if (c == 0)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+bool vtkTeemBlockGzip::Write(std::ostream& stream, const void* data, size_t dataSize, int compressionLevel, size_t blockSize)
+{
+  if (blockSize == 0)
+  {
+    blockSize = DefaultBlockSize;
+  }
+  if ((dataSize + blockSize - 1) / blockSize > MAXIMUM_NUMBER_OF_BLOCKS)
+  {
+    blockSize = (dataSize + MAXIMUM_NUMBER_OF_BLOCKS - 1) / MAXIMUM_NUMBER_OF_BLOCKS;
+  }
+  // an empty data set is written as a single empty block
+  const size_t numberOfBlocks = std::max<size_t>(1, (dataSize + blockSize - 1) / blockSize);
+
+  // Gzip header with the block index. Compressed block sizes are filled in
+  // after all blocks are written.
+  std::vector<unsigned char> header = { 0x1f, 0x8b, Z_DEFLATED, GZIP_FEXTRA, 0, 0, 0, 0, 0, 0xff };
+  const size_t blockIndexSize = BLOCK_INDEX_HEADER_SIZE + 4 * numberOfBlocks;
+  AppendUInt(header, 4 + blockIndexSize, 2);
+  header.push_back(BLOCK_INDEX_ID1);
+  header.push_back(BLOCK_INDEX_ID2);
+  AppendUInt(header, blockIndexSize, 2);
+  header.push_back(BLOCK_INDEX_VERSION);
+  AppendUInt(header, blockSize, 4);
+  AppendUInt(header, dataSize, 8);
+  AppendUInt(header, numberOfBlocks, 4);
+  const size_t compressedSizesOffset = header.size();
+  header.resize(header.size() + 4 * numberOfBlocks, 0);
+
+  const std::streampos headerPosition = stream.tellp();
+  stream.write(reinterpret_cast<const char*>(header.data()), header.size());
+
+  std::vector<unsigned char> compressedSizes;
+  uLong crc = crc32(0L, Z_NULL, 0);
+  const unsigned char* input = static_cast<const unsigned char*>(data);
+  std::vector<Block> blocks;
+  for (size_t firstBlockIndex = 0; firstBlockIndex < numberOfBlocks && stream.good(); firstBlockIndex += NUMBER_OF_BLOCKS_PER_BATCH)
+  {
+    size_t numberOfBatchBlocks = std::min(NUMBER_OF_BLOCKS_PER_BATCH, numberOfBlocks - firstBlockIndex);
+    blocks.clear();
+    blocks.resize(numberOfBatchBlocks);
+    for (size_t i = 0; i < numberOfBatchBlocks; ++i)
+    {
+      size_t blockIndex = firstBlockIndex + i;
+      blocks[i].Input = input + blockIndex * blockSize;
+      blocks[i].InputSize = std::min(blockSize, dataSize - blockIndex * blockSize);
+      blocks[i].Last = (blockIndex == numberOfBlocks - 1);
+    }
+
+    vtkSMPTools::For(0,
+                     static_cast<vtkIdType>(numberOfBatchBlocks),
+                     1,
+                     [&](vtkIdType begin, vtkIdType end)
+                     {
+                       for (vtkIdType i = begin; i < end; ++i)
+                       {
+                         CompressBlock(blocks[i], compressionLevel);
+                       }
+                     });
+
+    for (const Block& block : blocks)
+    {
+      if (!block.Success)
+      {
+        return false;
+      }
+      stream.write(reinterpret_cast<const char*>(block.Compressed.data()), block.Compressed.size());
+      AppendUInt(compressedSizes, block.Compressed.size(), 4);
+      crc = crc32_combine(crc, block.Crc, static_cast<z_off_t>(block.InputSize));
+    }
+  }
+
+  // Trailer: CRC32 and uncompressed size modulo 2^32
+  std::vector<unsigned char> trailer;
+  AppendUInt(trailer, crc, 4);
+  AppendUInt(trailer, dataSize & 0xffffffff, 4);
+  stream.write(reinterpret_cast<const char*>(trailer.data()), trailer.size());
+  const std::streampos endPosition = stream.tellp();
+
+  // Fill in the block index
+  stream.seekp(headerPosition + static_cast<std::streamoff>(compressedSizesOffset));
+  stream.write(reinterpret_cast<const char*>(compressedSizes.data()), compressedSizes.size());
+  stream.seekp(endPosition);
+
+  return stream.good();
+}
+
+//----------------------------------------------------------------------------
+vtkTeemBlockGzip::ReadResult vtkTeemBlockGzip::Read(std::istream& stream, void* data, size_t dataSize)
+{
+  unsigned char header[10] = { 0 };
+  if (!stream.read(reinterpret_cast<char*>(header), sizeof(header)))
+  {
+    return ReadNotIndexed;
+  }
+  const unsigned char flags = header[3];
+  if (header[0] != 0x1f || header[1] != 0x8b || header[2] != Z_DEFLATED || !(flags & GZIP_FEXTRA))
+  {
+    return ReadNotIndexed;
+  }
+
+  // Find the block index in the extra field
+  unsigned char extraLengthBuffer[2] = { 0 };
+  if (!stream.read(reinterpret_cast<char*>(extraLengthBuffer), 2))
+  {
+    return ReadNotIndexed;
+  }
+  std::vector<unsigned char> extra(ParseUInt(extraLengthBuffer, 2));
+  if (!stream.read(reinterpret_cast<char*>(extra.data()), extra.size()))
+  {
+    return ReadNotIndexed;
+  }
+  const unsigned char* blockIndex = nullptr;
+  size_t blockIndexSize = 0;
+  for (size_t pos = 0; pos + 4 <= extra.size();)
+  {
+    size_t subfieldSize = ParseUInt(&extra[pos + 2], 2);
+    if (pos + 4 + subfieldSize > extra.size())
+    {
+      break;
+    }
+    if (extra[pos] == BLOCK_INDEX_ID1 && extra[pos + 1] == BLOCK_INDEX_ID2)
+    {
+      blockIndex = &extra[pos + 4];
+      blockIndexSize = subfieldSize;
+      break;
+    }
+    pos += 4 + subfieldSize;
+  }
+  if (!blockIndex || blockIndexSize < BLOCK_INDEX_HEADER_SIZE || blockIndex[0] != BLOCK_INDEX_VERSION)
+  {
+    return ReadNotIndexed;
+  }
+  const size_t blockSize = ParseUInt(blockIndex + 1, 4);
+  const unsigned long long indexDataSize = ParseUInt(blockIndex + 5, 8);
+  const size_t numberOfBlocks = ParseUInt(blockIndex + 13, 4);
+  if (indexDataSize != dataSize || blockSize == 0 || numberOfBlocks != std::max<size_t>(1, (dataSize + blockSize - 1) / blockSize)
+      || blockIndexSize != BLOCK_INDEX_HEADER_SIZE + 4 * numberOfBlocks)
+  {
+    return ReadNotIndexed;
+  }
+
+  // Skip the remaining optional header fields
+  if ((flags & GZIP_FNAME) && !SkipZeroTerminatedString(stream))
+  {
+    return ReadError;
+  }
+  if ((flags & GZIP_FCOMMENT) && !SkipZeroTerminatedString(stream))
+  {
+    return ReadError;
+  }
+  if ((flags & GZIP_FHCRC) && !stream.ignore(2))
+  {
+    return ReadError;
+  }
+
+  std::vector<Block> blocks(numberOfBlocks);
+  for (size_t i = 0; i < numberOfBlocks; ++i)
+  {
+    blocks[i].InputSize = ParseUInt(blockIndex + BLOCK_INDEX_HEADER_SIZE + 4 * i, 4);
+    blocks[i].Output = static_cast<unsigned char*>(data) + i * blockSize;
+    blocks[i].OutputSize = std::min(blockSize, dataSize - i * blockSize);
+    blocks[i].Last = (i == numberOfBlocks - 1);
+  }
+
+  // Read the compressed blocks of a batch into the buffer
+  auto readBatch = [&stream, &blocks, numberOfBlocks](size_t firstBlockIndex, std::vector<unsigned char>& buffer)
+  {
+    const size_t endBlockIndex = std::min(numberOfBlocks, firstBlockIndex + NUMBER_OF_BLOCKS_PER_BATCH);
+    size_t batchCompressedSize = 0;
+    for (size_t i = firstBlockIndex; i < endBlockIndex; ++i)
+    {
+      batchCompressedSize += blocks[i].InputSize;
+    }
+    buffer.resize(batchCompressedSize);
+    if (!stream.read(reinterpret_cast<char*>(buffer.data()), buffer.size()))
+    {
+      return false;
+    }
+    const unsigned char* input = buffer.data();
+    for (size_t i = firstBlockIndex; i < endBlockIndex; ++i)
+    {
+      blocks[i].Input = input;
+      input += blocks[i].InputSize;
+    }
+    return true;
+  };
+
+  // Compressed data is read in batches, the next batch is read while the current batch is decompressed.
+  // Buffers are swapped, which keeps the input pointers of the blocks valid.
+  std::vector<unsigned char> compressed;
+  std::vector<unsigned char> nextCompressed;
+  if (!readBatch(0, compressed))
+  {
+    return ReadError;
+  }
+  for (size_t firstBlockIndex = 0; firstBlockIndex < numberOfBlocks; firstBlockIndex += NUMBER_OF_BLOCKS_PER_BATCH)
+  {
+    const size_t endBlockIndex = std::min(numberOfBlocks, firstBlockIndex + NUMBER_OF_BLOCKS_PER_BATCH);
+    bool nextBatchRead = true;
+    std::thread readThread;
+    if (endBlockIndex < numberOfBlocks)
+    {
+      readThread = std::thread([&] { nextBatchRead = readBatch(endBlockIndex, nextCompressed); });
+    }
+    vtkSMPTools::For(static_cast<vtkIdType>(firstBlockIndex),
+                     static_cast<vtkIdType>(endBlockIndex),
+                     1,
+                     [&](vtkIdType begin, vtkIdType end)
+                     {
+                       for (vtkIdType i = begin; i < end; ++i)
+                       {
+                         DecompressBlock(blocks[i]);
+                       }
+                     });
+    if (readThread.joinable())
+    {
+      readThread.join();
+    }
+    if (!nextBatchRead)
+    {
+      return ReadError;
+    }
+    compressed.swap(nextCompressed);
+  }
+
+  unsigned char trailer[8] = { 0 };
+  if (!stream.read(reinterpret_cast<char*>(trailer), sizeof(trailer)))
+  {
+    return ReadError;
+  }
+
+  uLong crc = crc32(0L, Z_NULL, 0);
+  for (const Block& block : blocks)
+  {
+    if (!block.Success)
+    {
+      return ReadError;
+    }
+    crc = crc32_combine(crc, block.Crc, static_cast<z_off_t>(block.OutputSize));
+  }
+  if (crc != ParseUInt(trailer, 4) || (dataSize & 0xffffffff) != ParseUInt(trailer + 4, 4))
+  {
+    return ReadError;
+  }
+  return ReadSuccess;
+}
@@ -0,0 +1,66 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkTeemBlockGzip_h
+#define __vtkTeemBlockGzip_h
+
+#include "vtkTeemConfigure.h"
+
+// STD includes
+#include <cstddef>
+#include <iosfwd>
+
+/// \brief Multithreaded gzip compression of raw NRRD data.
+///
+/// The data is split into blocks that are compressed independently on multiple threads
+/// (each block is a raw deflate stream that ends with a full flush, so it does not refer to
+/// the content of previous blocks). The blocks are concatenated into a single gzip member,
+/// therefore the output is a standard gzip stream that any gzip reader (teem, ITK, zlib,
+/// Python, etc.) can decompress.
+///
+/// The uncompressed block size and the compressed size of each block are stored in an
+/// "Sl" subfield of the gzip header extra field, which standard readers ignore.
+/// When this index is present, the blocks are decompressed in parallel.
+class VTK_Teem_EXPORT vtkTeemBlockGzip
+{
+public:
+  enum ReadResult
+  {
+    ReadSuccess,
+    ReadNotIndexed, ///< stream is not block-indexed gzip (or the size does not match), it must be read by a regular gzip reader
+    ReadError
+  };
+
+  /// Default uncompressed size of a block (1 MiB).
+  /// It is increased automatically if the block index would not fit into the gzip header.
+  static const size_t DefaultBlockSize;
+
+  /// Compress dataSize bytes of data and write it to the stream as a block-indexed gzip member.
+  /// compressionLevel is a zlib compression level (-1 = default, 0-9).
+  /// Returns false if compression or writing failed.
+  static bool Write(std::ostream& stream, const void* data, size_t dataSize, int compressionLevel, size_t blockSize = DefaultBlockSize);
+
+  /// Read a block-indexed gzip member from the current position of the stream and
+  /// decompress it into data, which must have dataSize bytes allocated.
+  /// Compressed blocks are read in batches while the previous batch is decompressed,
+  /// so that only a few batches of compressed data are kept in memory.
+  /// If the stream does not contain a block index (e.g., the file was written by another
+  /// application) then ReadNotIndexed is returned and the stream position is undefined.
+  static ReadResult Read(std::istream& stream, void* data, size_t dataSize);
+};
+
+#endif
@@ -27,6 +27,7 @@
 =========================================================================*/
 // vtkTeem includes
 #include "vtkTeemNRRDReader.h"
+#include "vtkTeemBlockGzip.h"
 
 // VTK includes
 #include "vtkBitArray.h"
@@ -47,6 +48,7 @@
 #include "vtkUnsignedShortArray.h"
 #include "vtkUnsignedIntArray.h"
 #include "vtkUnsignedLongArray.h"
+#include <vtksys/FStream.hxx>
 #include <vtksys/SystemTools.hxx>
 
 // Teem includes
@@ -61,6 +63,9 @@ vtkTeemNRRDReader::vtkTeemNRRDReader()
   this->NRRDWorldToRasMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
   this->MeasurementFrameMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
   this->nrrd = nrrdNew();
+  this->NrrdContainsHeaderOnly = false;
+  this->AttachedGzipData = false;
+  this->DataEndian = airEndianUnknown;
   this->UseNativeOrigin = true;
   this->ReadStatus = 0;
   this->PointDataType = -1;
@@ -363,6 +368,7 @@ void vtkTeemNRRDReader::ExecuteInformation()
 
   nrrdNuke(this->nrrd); // nuke and reallocate to reset the state
   this->nrrd = nrrdNew();
+  this->NrrdContainsHeaderOnly = false;
 
   NrrdIoState* nio = nrrdIoStateNew();
 
@@ -379,6 +385,8 @@ void vtkTeemNRRDReader::ExecuteInformation()
     this->ReadStatus = 1;
     return;
   }
+  this->SetDataEncodingInformation(nio);
+  this->NrrdContainsHeaderOnly = true;
 
   HeaderKeyValue.clear();
 
@@ -872,9 +880,10 @@ void vtkTeemNRRDReader::ExecuteDataWithInformation(vtkDataObject* output, vtkInf
     return;
   }
 
-  // Read in the this->nrrd.  Yes, this means that the header is being read
-  // twice: once by ExecuteInformation, and once here
-  if (nrrdLoad(this->nrrd, this->GetFileName(), nullptr) != 0)
+  // Read in the this->nrrd. Block-compressed data is read using the header that was read
+  // by ExecuteInformation, otherwise teem reads the header again along with the data.
+  if (!this->ReadBlockCompressedData() //
+      && nrrdLoad(this->nrrd, this->GetFileName(), nullptr) != 0)
   {
     char* err = biffGetDone(NRRD); // would be nice to free(err)
     vtkErrorMacro("Read: Error reading " << this->GetFileName() << ":\n" << err);
@@ -1052,6 +1061,80 @@ void vtkTeemNRRDReader::ExecuteDataWithInformation(vtkDataObject* output, vtkInf
 
   // release the memory while keeping the struct
   nrrdEmpty(this->nrrd);
+  this->NrrdContainsHeaderOnly = false;
+}
+
+//----------------------------------------------------------------------------
+void vtkTeemNRRDReader::SetDataEncodingInformation(NrrdIoState* nio)
+{
+  // Data file names are only set if the header is detached
+  this->AttachedGzipData = (nio->encoding == nrrdEncodingGzip && nio->lineSkip == 0 && nio->byteSkip == 0 //
+                            && nio->dataFNArr->len == 0 && !nio->dataFNFormat);
+  this->DataEndian = nio->endian;
+}
+
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDReader::ReadBlockCompressedData()
+{
+  if (!this->NrrdContainsHeaderOnly)
+  {
+    // The header has been modified by a previous read of the same file
+    NrrdIoState* nio = nrrdIoStateNew();
+    nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+    if (nrrdLoad(this->nrrd, this->GetFileName(), nio) != 0)
+    {
+      char* err = biffGetDone(NRRD);
+      free(err);
+      nio = nrrdIoStateNix(nio);
+      return false;
+    }
+    this->SetDataEncodingInformation(nio);
+    nio = nrrdIoStateNix(nio);
+  }
+  this->NrrdContainsHeaderOnly = false;
+  if (!this->AttachedGzipData)
+  {
+    return false;
+  }
+
+  // Attached data starts after the first empty line.
+  // If the data is detached then the gzip header is not found there.
+  vtksys::ifstream stream(this->GetFileName(), std::ios::in | std::ios::binary);
+  std::string line;
+  while (std::getline(stream, line) && !line.empty() && line != "\r")
+  {
+  }
+  if (!stream.good())
+  {
+    return false;
+  }
+
+  size_t axisSizes[NRRD_DIM_MAX] = { 0 };
+  nrrdAxisInfoGet_nva(this->nrrd, nrrdAxisInfoSize, axisSizes);
+  if (nrrdMaybeAlloc_nva(this->nrrd, this->nrrd->type, this->nrrd->dim, axisSizes) != 0)
+  {
+    char* err = biffGetDone(NRRD);
+    vtkErrorMacro("Read: Error allocating memory for " << this->GetFileName() << ":\n" << err);
+    free(err);
+    return false;
+  }
+  size_t dataSize = nrrdElementNumber(this->nrrd) * nrrdElementSize(this->nrrd);
+  vtkTeemBlockGzip::ReadResult result = vtkTeemBlockGzip::Read(stream, this->nrrd->data, dataSize);
+  if (result != vtkTeemBlockGzip::ReadSuccess)
+  {
+    if (result == vtkTeemBlockGzip::ReadError)
+    {
+      vtkWarningMacro("Read: Failed to decompress blocks of " << this->GetFileName() << ", trying to read it as regular gzip stream");
+    }
+    nrrdEmpty(this->nrrd);
+    return false;
+  }
+
+  if (this->DataEndian != airEndianUnknown && this->DataEndian != airMyEndian())
+  {
+    nrrdSwapEndian(this->nrrd);
+  }
+  return true;
 }
 
 //----------------------------------------------------------------------------
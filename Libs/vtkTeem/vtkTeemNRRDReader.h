@@ -210,6 +210,14 @@ protected:
 
   Nrrd* nrrd;
 
+  /// True if this->nrrd contains only the header of the current file,
+  /// as read by ExecuteInformation (data reading modifies it)
+  bool NrrdContainsHeaderOnly;
+  /// Data is gzip-compressed and stored in the header file without line or byte skip
+  bool AttachedGzipData;
+  /// Endianness of the data in the file
+  int DataEndian;
+
   int ReadStatus;
 
   int PointDataType;
@@ -227,6 +235,15 @@ protected:
   void ExecuteInformation() override;
   void ExecuteDataWithInformation(vtkDataObject* output, vtkInformation* outInfo) override;
 
+  /// Store data encoding information of the header that was just read.
+  void SetDataEncodingInformation(NrrdIoState* nio);
+
+  /// Read data that was compressed in independent blocks (see vtkTeemBlockGzip)
+  /// using multiple threads. The header that was read in ExecuteInformation is reused.
+  /// Returns false if the file does not contain block-compressed data
+  /// or reading fails, in this case the data has to be read by teem.
+  bool ReadBlockCompressedData();
+
   int tenSpaceDirectionReduce(Nrrd* nout, const Nrrd* nin, double SD[9]);
 
 private:
@@ -1,12 +1,14 @@
 #include <map>
 
 #include "vtkTeemNRRDWriter.h"
+#include "vtkTeemBlockGzip.h"
 
 #include "vtkImageData.h"
 #include "vtkPointData.h"
 #include "vtkObjectFactory.h"
 #include "vtkInformation.h"
 #include <vtkVersion.h>
+#include <vtksys/FStream.hxx>
 
 #include <itkMath.h>
 #include <vnl/vnl_double_3.h>
@@ -33,6 +35,7 @@ vtkTeemNRRDWriter::vtkTeemNRRDWriter()
   this->UseCompression = 1;
   // use default CompressionLevel
   this->CompressionLevel = -1;
+  this->UseParallelCompression = true;
   this->DiffusionWeightedData = 0;
   this->FileType = VTK_BINARY;
   this->WriteErrorOff();
@@ -409,7 +412,16 @@ void vtkTeemNRRDWriter::WriteData()
   nio->endian = airEndianUnknown;
 
   // Write the nrrd to file.
-  if (nrrdSave(this->GetFileName(), nrrd, nio))
+  // Attached gzip-compressed data is compressed on multiple threads, anything else is written by teem.
+  if (nio->encoding == nrrdEncodingGzip && this->UseParallelCompression //
+      && nrrdFormatNRRD->nameLooksLike(this->GetFileName()) && !airEndsWith(this->GetFileName(), NRRD_EXT_NHDR))
+  {
+    if (!this->WriteBlockCompressedNRRD(nrrd, nio))
+    {
+      this->WriteErrorOn();
+    }
+  }
+  else if (nrrdSave(this->GetFileName(), nrrd, nio))
   {
     char* err = biffGetDone(NRRD); // would be nice to free(err)
     vtkErrorMacro("Write: Error writing " << this->GetFileName() << ":\n" << err);
@@ -420,10 +432,55 @@ void vtkTeemNRRDWriter::WriteData()
   nio = nrrdIoStateNix(nio);
 }
 
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDWriter::WriteBlockCompressedNRRD(Nrrd* nrrd, NrrdIoState* nio)
+{
+  // Let teem generate the header (including the "encoding: gzip" field) but not the data
+  nio->format = nrrdFormatNRRD;
+  nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+  char* headerString = nullptr;
+  if (nrrdStringWrite(&headerString, nrrd, nio))
+  {
+    char* err = biffGetDone(NRRD);
+    vtkErrorMacro("Write: Error writing header of " << this->GetFileName() << ":\n" << err);
+    free(err);
+    return false;
+  }
+  std::string header = headerString;
+  free(headerString);
+  // attached data starts after the first empty line
+  header.erase(header.find_last_not_of('\n') + 1);
+  header += "\n\n";
+
+  vtksys::ofstream stream(this->GetFileName(), std::ios::out | std::ios::binary);
+  if (!stream.is_open())
+  {
+    vtkErrorMacro("Write: Error opening " << this->GetFileName() << " for writing");
+    return false;
+  }
+  stream.write(header.c_str(), header.size());
+  size_t dataSize = nrrdElementNumber(nrrd) * nrrdElementSize(nrrd);
+  if (!vtkTeemBlockGzip::Write(stream, nrrd->data, dataSize, this->CompressionLevel))
+  {
+    vtkErrorMacro("Write: Error writing compressed data to " << this->GetFileName());
+    return false;
+  }
+  stream.close();
+  if (stream.fail())
+  {
+    vtkErrorMacro("Write: Error closing " << this->GetFileName());
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
 void vtkTeemNRRDWriter::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
 
+  os << indent << "UseParallelCompression: " << this->UseParallelCompression << "\n";
+
   os << indent << "RAS to IJK Matrix: ";
   this->IJKToRASMatrix->PrintSelf(os, indent);
   os << indent << "Measurement frame: ";
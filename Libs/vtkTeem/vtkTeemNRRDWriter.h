@@ -57,6 +57,15 @@ public:
   vtkSetClampMacro(CompressionLevel, int, 0, 9);
   vtkGetMacro(CompressionLevel, int);
 
+  /// Compress the data in independent blocks on multiple threads (enabled by default).
+  /// Only used for gzip-compressed NRRD files with attached data (.nrrd extension).
+  /// The output is a standard gzip stream that any NRRD reader can read, but
+  /// vtkTeemNRRDReader can also decompress it on multiple threads.
+  /// \sa vtkTeemBlockGzip
+  vtkSetMacro(UseParallelCompression, bool);
+  vtkGetMacro(UseParallelCompression, bool);
+  vtkBooleanMacro(UseParallelCompression, bool);
+
   vtkSetClampMacro(FileType, int, VTK_ASCII, VTK_BINARY);
   vtkGetMacro(FileType, int);
   void SetFileTypeToASCII() { this->SetFileType(VTK_ASCII); };
@@ -114,6 +123,10 @@ protected:
   /// Write method. It is called by vtkWriter::Write();
   void WriteData() override;
 
+  /// Write the header using teem and the data using multithreaded block compression.
+  /// Returns false on error.
+  bool WriteBlockCompressedNRRD(Nrrd* nrrd, NrrdIoState* nio);
+
   ///
   /// Flag to set to on when a write error occurred
   int WriteError;
@@ -128,6 +141,7 @@ protected:
 
   int UseCompression;
   int CompressionLevel;
+  bool UseParallelCompression;
   int FileType;
 
   AttributeMapType* Attributes;
@@ -0,0 +1,29 @@
+/*=========================================================================
+
+  Program:   Extract Skeleton
+  Language:  C++
+
+  Copyright (c) Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See License.txt or http://www.slicer.org/copyright/copyright.txt for details.
+
+==========================================================================*/
+// ExtractSkeletonExport
+//
+// Exports the thinning implementation from the ExtractSkeleton library
+// so that it can be tested directly.
+
+#ifndef __ExtractSkeletonExport_h
+#define __ExtractSkeletonExport_h
+
+#if defined(_WIN32) && !defined(ExtractSkeleton_STATIC)
+# if defined(ExtractSkeletonLib_EXPORTS)
+#  define ExtractSkeleton_EXPORT __declspec(dllexport)
+# else
+#  define ExtractSkeleton_EXPORT __declspec(dllimport)
+# endif
+#else
+# define ExtractSkeleton_EXPORT
+#endif
+
+#endif
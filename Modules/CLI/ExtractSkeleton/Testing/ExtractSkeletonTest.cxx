@@ -7,8 +7,10 @@
 #endif
 
 extern "C" MODULE_IMPORT int ModuleEntryPoint(int, char*[]);
+int TilgIso3DTest(int, char*[]);
 
 void RegisterTests()
 {
   StringToTestFunctionMap["ModuleEntryPoint"] = ModuleEntryPoint;
+  StringToTestFunctionMap["TilgIso3DTest"] = TilgIso3DTest;
 }
@@ -0,0 +1,201 @@
+/*=========================================================================
+
+  Program:   Extract Skeleton
+  Language:  C++
+
+  Copyright (c) Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See License.txt or http://www.slicer.org/copyright/copyright.txt for details.
+
+==========================================================================*/
+
+#include "tilg_iso_3D.h"
+
+// STD includes
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+int BitCount(int i)
+{
+  int c = 0;
+  while (i != 0)
+  {
+    c++;
+    i &= i - 1;
+  }
+  return c;
+}
+
+//----------------------------------------------------------------------------
+// Thinning as it was implemented before TilgIso3D: all object voxels of the image
+// are scanned in each parallel sub-iteration and in each sequential pass.
+void ReferenceTilgIso3D(int dim[3], const unsigned char* data, unsigned char* result, int type)
+{
+  const int nx = dim[0];
+  const int nzz = dim[0] * dim[1];
+  const int numberOfVoxels = nzz * dim[2];
+  for (int z = 0; z < dim[2]; z++)
+  {
+    for (int y = 0; y < dim[1]; y++)
+    {
+      for (int x = 0; x < dim[0]; x++)
+      {
+        const int i = x + nx * y + nzz * z;
+        const bool onImageBoundary = (x == 0 || y == 0 || z == 0 || x == dim[0] - 1 || y == dim[1] - 1 || z == dim[2] - 1);
+        result[i] = (data[i] >= 1 && !onImageBoundary) ? OBJ : BG;
+      }
+    }
+  }
+
+  auto envCode = [&](int i)
+  {
+    int loc[3] = { i % nx, (i / nx) % dim[1], i / nzz };
+    return Env_Code_3_img(loc, result, dim);
+  };
+
+  const int end = numberOfVoxels - nzz - nx - 1;
+  std::vector<int> list;
+  int cnt = 1;
+  while (cnt)
+  {
+    cnt = 0;
+    for (int dir = 0; dir < 18; dir++)
+    {
+      list.clear();
+      for (int i = nzz + nx + 1; i < end; i++)
+      {
+        if (result[i] != OBJ)
+        {
+          continue;
+        }
+        int nc = envCode(i);
+        if (((~nc) & dir_tab[dir]) == dir_tab[dir] && BitCount(nc) > 2 && Tilg_Test_3(nc, dir, type) == BG)
+        {
+          list.push_back(i);
+        }
+      }
+      for (int i : list)
+      {
+        result[i] = BG;
+      }
+      cnt += static_cast<int>(list.size());
+    }
+  }
+
+  cnt = 1;
+  while (cnt)
+  {
+    cnt = 0;
+    for (int i = nzz + nx + 1; i < end; i++)
+    {
+      if (result[i] != OBJ)
+      {
+        continue;
+      }
+      int nc = envCode(i);
+      if (BitCount(nc) > 2 && Tilg_Test_3(nc, 18, type) == BG)
+      {
+        result[i] = BG;
+        cnt++;
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+// Union of random ellipsoids and random noise, so that the image contains
+// both thick blobs and thin, irregular structures.
+void CreateTestImage(int dim[3], unsigned int seed, std::vector<unsigned char>& image)
+{
+  std::mt19937 randomGenerator(seed);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  image.assign(dim[0] * dim[1] * dim[2], 0);
+  for (int ellipsoid = 0; ellipsoid < 6; ellipsoid++)
+  {
+    double center[3];
+    double radius[3];
+    for (int axis = 0; axis < 3; axis++)
+    {
+      center[axis] = uniform(randomGenerator) * dim[axis];
+      radius[axis] = 3.0 + uniform(randomGenerator) * dim[axis] / 4.0;
+    }
+    for (int z = 0; z < dim[2]; z++)
+    {
+      for (int y = 0; y < dim[1]; y++)
+      {
+        for (int x = 0; x < dim[0]; x++)
+        {
+          const double dx = (x - center[0]) / radius[0];
+          const double dy = (y - center[1]) / radius[1];
+          const double dz = (z - center[2]) / radius[2];
+          if (dx * dx + dy * dy + dz * dz <= 1.0)
+          {
+            image[x + dim[0] * (y + dim[1] * z)] = 255;
+          }
+        }
+      }
+    }
+  }
+  for (unsigned char& voxel : image)
+  {
+    if (uniform(randomGenerator) < 0.05)
+    {
+      voxel = (voxel ? 0 : 255);
+    }
+  }
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+// Verify that TilgIso3D gives exactly the same result as the original
+// full-scan implementation, with any number of threads.
+int TilgIso3DTest(int, char*[])
+{
+  int dim[3] = { 72, 64, 56 };
+  std::vector<unsigned char> image;
+  std::vector<unsigned char> expectedResult(dim[0] * dim[1] * dim[2]);
+  std::vector<unsigned char> result(dim[0] * dim[1] * dim[2]);
+  for (unsigned int seed = 1; seed <= 3; seed++)
+  {
+    CreateTestImage(dim, seed, image);
+    for (int type = 0; type <= 1; type++)
+    {
+      ReferenceTilgIso3D(dim, image.data(), expectedResult.data(), type);
+      for (int numberOfThreads : { 1, 4, 0 })
+      {
+        TilgIso3D tilg;
+        tilg.SetNumberOfThreads(numberOfThreads);
+        tilg.Execute(dim[0], dim[1], dim[2], image.data(), result.data(), type);
+        if (result != expectedResult)
+        {
+          std::cerr << "Line " << __LINE__ << " - Thinning result differs from the reference implementation" //
+                    << " (seed: " << seed << ", type: " << type << ", numberOfThreads: " << numberOfThreads << ")" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+
+  // Very small images have no voxels inside the boundary
+  int smallDim[3] = { 2, 5, 5 };
+  std::vector<unsigned char> smallImage(2 * 5 * 5, 255);
+  std::vector<unsigned char> smallResult(2 * 5 * 5, 255);
+  tilg_iso_3D(smallDim[0], smallDim[1], smallDim[2], smallImage.data(), smallResult.data(), 0);
+  for (unsigned char voxel : smallResult)
+  {
+    if (voxel != BG)
+    {
+      std::cerr << "Line " << __LINE__ << " - Image smaller than 3 voxels must be empty after thinning" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
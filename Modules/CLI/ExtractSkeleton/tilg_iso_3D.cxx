@@ -21,26 +21,74 @@
 // adapted to C++: Martin Styner 20.July.2000
 // integrated into slicer: Stephen Aylward, 20, Aug, 2007
 /*****************************************************************************/
-#include <cstdio>
-#include <cstdlib>
+#include "tilg_iso_3D.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <thread>
 
 /********************************  Konstanten  *******************************/
 #define LIM 1 /* Voxelwert >= LIM => Objekt (Input-Bild) */
-#define OBJ 1 /* Objektwert  (Output-Bild)               */
-#define BG 0  /* Hintergrund (Output-Bild)               */
+
+/* Markierung der Randvoxel im Ergebnisbild (zusaetzlich zu OBJ) */
+#define BORDER_FLAG 2
+
+/* Minimale Anzahl Randvoxel pro Thread in den parallelen Subzyklen */
+#define MIN_VOXELS_PER_THREAD 4096
 
 /*********************************  Makros  **********************************/
 #define Q(i, v) ((pos[(i)] == OBJ) ? (v) : 0)
-#define P(n, x, y, z) n[(x) + nx * ((y) + (z) * ny)]
-
-/**************************** globale Variablen  *****************************/
-static int nx, ny, nz, nzz;
-static unsigned char *workbuf, *result;
-static int f_tab[26];
-static unsigned char p[5][5][5];
+#define QR(i, v) ((pos[(i)] & OBJ) ? (v) : 0)
+#define P(n, x, y, z) n[(x) + DimX * ((y) + (z) * DimY)]
+
+/**************************** Tabellen  **************************************/
+/* Richtungstabelle: Nachbarn, die fuer den Subzyklus Hintergrund sein muessen */
+const int dir_tab[18] = {
+  1024,    /* 10 */
+  65536,   /* 16 */
+  16384,   /* 14 */
+  4096,    /* 12 */
+  4194304, /* 22 */
+  16,      /*  4 */
+  4198400, /* 12 22 */
+  16400,   /*  4 14 */
+  4210688, /* 14 22 */
+  4112,    /*  4 12 */
+  65552,   /*  4 16 */
+  4195328, /* 10 22 */
+  1040,    /*  4 10 */
+  4259840, /* 16 22 */
+  69632,   /* 12 16 */
+  17408,   /* 10 14 */
+  5120,    /* 10 12 */
+  81920    /* 14 16 */
+};
+
+/* Zusatztest bei paralleler Tilgung */
+static const int f_tab[26] = {
+  65536,    /* 16 */
+  1024,     /* 10 */
+  4096,     /* 12 */
+  16384,    /* 14 */
+  16,       /*  4 */
+  4194304,  /* 22 */
+  32,       /*  5 */
+  2097152,  /* 21 */
+  8,        /*  3 */
+  8388608,  /* 23 */
+  524288,   /* 19 */
+  128,      /*  7 */
+  33554432, /* 25 */
+  2,        /*  1 */
+  2048,     /* 11 */
+  32768,    /* 15 */
+  131072,   /* 17 */
+  512       /*  9 */
+};
 
 /*******************************  Hilfsprozeduren ****************************/
-int bitcount(int i)
+static int bitcount(int i)
 /* gibt die Anzahl 1-en in i zurueck */
 {
   int c = 0;
@@ -56,24 +104,7 @@ int bitcount(int i)
   return c;
 }
 
-void init_data()
-/* initialisiert p */
-{
-  int x, y, z;
-
-  for (z = 0; z < 5; z++)
-  {
-    for (y = 0; y < 5; y++)
-    {
-      for (x = 0; x < 5; x++)
-      {
-        p[x][y][z] = BG;
-      }
-    }
-  }
-}
-
-void mark(int x, int y, int z)
+static void mark(unsigned char p[5][5][5], int x, int y, int z)
 /* markiert alles was von x,y,z aus erreichbar ist */
 /* einfache rekursive Version                      */
 {
@@ -90,18 +121,20 @@ void mark(int x, int y, int z)
       {
         if (p[i][j][k] == OBJ)
         {
-          mark(i, j, k);
+          mark(p, i, j, k);
         }
       }
     }
   }
 }
 
-int count_components(int nc)
+static int count_components(int nc)
 /* zaehlt die Komponenten im 26-Sinn des nc's */
 /* einfache rekursive Version                 */
+/* p ist lokal, damit die Funktion von mehreren Threads aufgerufen werden kann */
 {
   int x, y, z, count;
+  unsigned char p[5][5][5] = {};
 
   for (z = 1; z < 4; z++)
   {
@@ -124,7 +157,7 @@ int count_components(int nc)
         if (p[x][y][z] != BG)
         {
           count++;
-          mark(x, y, z);
+          mark(p, x, y, z);
         }
       }
     }
@@ -154,25 +187,6 @@ int Env_Code_3_img(int loc[3], unsigned char* img, int dim[3])
   return nc;
 }
 
-int Env_Code_3(int i)
-/* berechnet den Nachbarschaftscode der 3x3x3-Umgebung von P{i} */
-{
-  int nc;
-  unsigned char* pos;
-
-  pos = &result[i - nzz];
-  nc = Q(-1 - nx, 1) + Q(-nx, 2) + Q(1 - nx, 4) + Q(-1, 8) + Q(0, 16) //
-       + Q(1, 32) + Q(-1 + nx, 64) + Q(nx, 128) + Q(1 + nx, 256);
-  pos += nzz;
-  nc += Q(-1 - nx, 512) + Q(-nx, 1024) + Q(1 - nx, 2048) + Q(-1, 4096) + Q(0, 8192) //
-        + Q(1, 16384) + Q(-1 + nx, 32768) + Q(nx, 65536) + Q(1 + nx, 131072);
-  pos += nzz;
-  nc += Q(-1 - nx, 262144) + Q(-nx, 524288) + Q(1 - nx, 1048576) + Q(-1, 2097152) //
-        + Q(0, 4194304) + Q(1, 8388608) + Q(-1 + nx, 16777216) + Q(nx, 33554432)  //
-        + Q(1 + nx, 67108864);
-  return nc;
-}
-
 /*************************** ENDE  Hilfsprozeduren **************************/
 
 /******************************  Hauptprozedur ******************************/
@@ -609,139 +623,266 @@ int Tilg_Test_3(int c, int d, int type)
   return OBJ;
 }
 
-void tilg_iso_3D(int dx, int dy, int dz, unsigned char* data, unsigned char* res, int type)
-// dx,dy,dz  are the dimensions of the input (data) and output (res) image
-// output image has to be allocated
-// if type == 1 -> sheet preserving tilg
-// if type == 0 -> full tilg
+//----------------------------------------------------------------------------
+TilgIso3D::TilgIso3D()
+  : NumberOfThreads(0)
+  , DimX(0)
+  , DimY(0)
+  , DimZ(0)
+  , SliceSize(0)
+  , Result(nullptr)
 {
+}
 
-  int cnt = 0, cnt1 = 0;
-  int nc, x, y, z;
-  int end, i, dir, dir_mask;
-  // int free_mask;
-  int* list;
-  int dir_tab[26];
+//----------------------------------------------------------------------------
+int TilgIso3D::EnvCode(int i) const
+/* berechnet den Nachbarschaftscode der 3x3x3-Umgebung von P{i} */
+/* (die Randmarkierung BORDER_FLAG wird ignoriert)              */
+{
+  int nc;
+  const unsigned char* pos;
+
+  pos = &Result[i - SliceSize];
+  nc = QR(-1 - DimX, 1) + QR(-DimX, 2) + QR(1 - DimX, 4) + QR(-1, 8) + QR(0, 16) //
+       + QR(1, 32) + QR(-1 + DimX, 64) + QR(DimX, 128) + QR(1 + DimX, 256);
+  pos += SliceSize;
+  nc += QR(-1 - DimX, 512) + QR(-DimX, 1024) + QR(1 - DimX, 2048) + QR(-1, 4096) + QR(0, 8192) //
+        + QR(1, 16384) + QR(-1 + DimX, 32768) + QR(DimX, 65536) + QR(1 + DimX, 131072);
+  pos += SliceSize;
+  nc += QR(-1 - DimX, 262144) + QR(-DimX, 524288) + QR(1 - DimX, 1048576) + QR(-1, 2097152) //
+        + QR(0, 4194304) + QR(1, 8388608) + QR(-1 + DimX, 16777216) + QR(DimX, 33554432)    //
+        + QR(1 + DimX, 67108864);
+  return nc;
+}
 
-  // int b[3][3][3];
+//----------------------------------------------------------------------------
+void TilgIso3D::InitializeBorderVoxels()
+{
+  this->BorderVoxels.clear();
+  const int end = SliceSize * DimZ - SliceSize - DimX - 1;
+  for (int i = SliceSize + DimX + 1; i < end; i++)
+  {
+    if (Result[i] != OBJ)
+    {
+      continue;
+    }
+    if (Result[i - 1] == BG || Result[i + 1] == BG          //
+        || Result[i - DimX] == BG || Result[i + DimX] == BG //
+        || Result[i - SliceSize] == BG || Result[i + SliceSize] == BG)
+    {
+      Result[i] |= BORDER_FLAG;
+      this->BorderVoxels.push_back(i);
+    }
+  }
+}
 
-  nx = dx;
-  ny = dy;
-  nz = dz;
-  init_data();
-  /* Speicher allozieren */
-  result = res;
+//----------------------------------------------------------------------------
+void TilgIso3D::AddNewBorderNeighbors(int i, std::vector<int>& newBorderVoxels)
+{
+  const int neighborOffsets[6] = { -1, 1, -DimX, DimX, -SliceSize, SliceSize };
+  for (int offset : neighborOffsets)
+  {
+    const int j = i + offset;
+    if (Result[j] == OBJ)
+    {
+      // object voxel without border flag, it just became a border voxel
+      Result[j] |= BORDER_FLAG;
+      newBorderVoxels.push_back(j);
+    }
+  }
+}
 
-  workbuf = data;
-  nzz = nx * ny;
-  /* Speicher allozieren */
-  if ((list = (int*)malloc(nzz * nz * sizeof(int) / 4)) == nullptr)
+//----------------------------------------------------------------------------
+int TilgIso3D::ParallelSubIteration(int dirMask, int dir, int type)
+{
+  const int numberOfCandidates = static_cast<int>(this->BorderVoxels.size());
+  // Removal of a voxel only depends on the image before the sub-iteration,
+  // therefore the candidates can be checked independently, in any order.
+  std::vector<unsigned char> removable(numberOfCandidates, 0);
+  auto checkCandidates = [this, &removable, dirMask, dir, type](int first, int last)
   {
-    printf("out of memory\n");
-    return;
+    for (int k = first; k < last; k++)
+    {
+      int nc = this->EnvCode(this->BorderVoxels[k]);
+      if (((~nc) & dirMask) == dirMask && bitcount(nc) > 2 && Tilg_Test_3(nc, dir, type) == BG)
+      {
+        removable[k] = 1;
+      }
+    }
+  };
+
+  int numberOfThreads = this->NumberOfThreads;
+  if (numberOfThreads <= 0)
+  {
+    numberOfThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  }
+  numberOfThreads = std::max(1, std::min(numberOfThreads, numberOfCandidates / MIN_VOXELS_PER_THREAD));
+  if (numberOfThreads == 1)
+  {
+    checkCandidates(0, numberOfCandidates);
+  }
+  else
+  {
+    std::vector<std::thread> threads;
+    const int chunkSize = (numberOfCandidates + numberOfThreads - 1) / numberOfThreads;
+    for (int first = 0; first < numberOfCandidates; first += chunkSize)
+    {
+      threads.emplace_back(checkCandidates, first, std::min(first + chunkSize, numberOfCandidates));
+    }
+    for (std::thread& thread : threads)
+    {
+      thread.join();
+    }
+  }
+
+  /* Voxel der Liste loeschen */
+  int cnt = 0;
+  for (int k = 0; k < numberOfCandidates; k++)
+  {
+    if (removable[k])
+    {
+      Result[this->BorderVoxels[k]] = BG;
+      cnt++;
+    }
   }
+  if (cnt == 0)
+  {
+    return 0;
+  }
+
+  // Update the border list: remove deleted voxels and add their object neighbors
+  std::vector<int> newBorderVoxels;
+  int numberOfRemainingVoxels = 0;
+  for (int k = 0; k < numberOfCandidates; k++)
+  {
+    const int i = this->BorderVoxels[k];
+    if (removable[k])
+    {
+      this->AddNewBorderNeighbors(i, newBorderVoxels);
+    }
+    else
+    {
+      this->BorderVoxels[numberOfRemainingVoxels++] = i;
+    }
+  }
+  this->BorderVoxels.resize(numberOfRemainingVoxels);
+  this->BorderVoxels.insert(this->BorderVoxels.end(), newBorderVoxels.begin(), newBorderVoxels.end());
+  return cnt;
+}
+
+//----------------------------------------------------------------------------
+int TilgIso3D::SequentialPass(int type)
+{
+  // Voxels are removed immediately, therefore the result depends on the order of
+  // visiting voxels. The same (raster) order is used as scanning the whole image:
+  // border voxels are visited in increasing index order, and voxels that become
+  // border voxels during the pass are visited in this pass if their index is larger
+  // than the current index (otherwise they are visited in the next pass).
+  std::vector<int> candidates;
+  candidates.swap(this->BorderVoxels);
+  std::sort(candidates.begin(), candidates.end());
+  std::priority_queue<int, std::vector<int>, std::greater<int>> laterCandidates;
+  std::vector<int> newBorderVoxels;
+
+  int cnt = 0;
+  size_t k = 0;
+  while (k < candidates.size() || !laterCandidates.empty())
+  {
+    int i;
+    if (laterCandidates.empty() || (k < candidates.size() && candidates[k] < laterCandidates.top()))
+    {
+      i = candidates[k++];
+    }
+    else
+    {
+      i = laterCandidates.top();
+      laterCandidates.pop();
+    }
+
+    int nc = this->EnvCode(i);
+    if (bitcount(nc) > 2 && Tilg_Test_3(nc, 18, type) == BG)
+    {
+      cnt++;
+      Result[i] = BG;
+      newBorderVoxels.clear();
+      this->AddNewBorderNeighbors(i, newBorderVoxels);
+      for (int j : newBorderVoxels)
+      {
+        if (j > i)
+        {
+          laterCandidates.push(j);
+        }
+        else
+        {
+          this->BorderVoxels.push_back(j);
+        }
+      }
+    }
+    else
+    {
+      this->BorderVoxels.push_back(i);
+    }
+  }
+  return cnt;
+}
+
+//----------------------------------------------------------------------------
+void TilgIso3D::Execute(int dx, int dy, int dz, const unsigned char* data, unsigned char* res, int type)
+{
+  int cnt = 0;
+  int x, y, z;
+  int end, i, dir;
+
+  DimX = dx;
+  DimY = dy;
+  DimZ = dz;
+  Result = res;
+  SliceSize = DimX * DimY;
+
   /* Arbeitskopie des Bildes erstellen und binaerisieren */
-  end = nx * ny * nz;
+  end = DimX * DimY * DimZ;
   for (i = 0; i < end; i++)
   {
-    result[i] = ((workbuf[i] >= LIM) ? OBJ : BG);
+    Result[i] = ((data[i] >= LIM) ? OBJ : BG);
   }
   /* Rand von 1-Voxel-Breite auf 0 setzen */
-  for (y = 0; y < ny; y++)
+  for (y = 0; y < DimY; y++)
   {
-    for (x = 0; x < nx; x++)
+    for (x = 0; x < DimX; x++)
     {
-      P(result, x, y, 0) = (P(result, x, y, nz - 1) = BG);
+      P(Result, x, y, 0) = (P(Result, x, y, DimZ - 1) = BG);
     }
   }
-  for (y = 0; y < ny; y++)
+  for (y = 0; y < DimY; y++)
   {
-    for (z = 0; z < nz; z++)
+    for (z = 0; z < DimZ; z++)
     {
-      P(result, 0, y, z) = (P(result, nx - 1, y, z) = BG);
+      P(Result, 0, y, z) = (P(Result, DimX - 1, y, z) = BG);
     }
   }
-  for (z = 0; z < nz; z++)
+  for (z = 0; z < DimZ; z++)
   {
-    for (x = 0; x < nx; x++)
+    for (x = 0; x < DimX; x++)
     {
-      P(result, x, 0, z) = (P(result, x, ny - 1, z) = BG);
+      P(Result, x, 0, z) = (P(Result, x, DimY - 1, z) = BG);
     }
   }
-  /* Richtungstabelle initialisieren */
-  dir_tab[0] = 1024;    /* 10 */
-  dir_tab[1] = 65536;   /* 16 */
-  dir_tab[2] = 16384;   /* 14 */
-  dir_tab[3] = 4096;    /* 12 */
-  dir_tab[4] = 4194304; /* 22 */
-  dir_tab[5] = 16;      /*  4 */
-
-  f_tab[0] = dir_tab[1];
-  f_tab[1] = dir_tab[0];
-  f_tab[2] = dir_tab[3];
-  f_tab[3] = dir_tab[2];
-  f_tab[4] = dir_tab[5];
-  f_tab[5] = dir_tab[4];
-
-  dir_tab[6] = 4198400;  /* 12 22 */
-  dir_tab[7] = 16400;    /*  4 14 */
-  dir_tab[8] = 4210688;  /* 14 22 */
-  dir_tab[9] = 4112;     /*  4 12 */
-  dir_tab[10] = 65552;   /*  4 16 */
-  dir_tab[11] = 4195328; /* 10 22 */
-  dir_tab[12] = 1040;    /*  4 10 */
-  dir_tab[13] = 4259840; /* 16 22 */
-  dir_tab[14] = 69632;   /* 12 16 */
-  dir_tab[15] = 17408;   /* 10 14 */
-  dir_tab[16] = 5120;    /* 10 12 */
-  dir_tab[17] = 81920;   /* 14 16 */
-
-  f_tab[6] = 32;        /*  5 */
-  f_tab[7] = 2097152;   /* 21 */
-  f_tab[8] = 8;         /*  3 */
-  f_tab[9] = 8388608;   /* 23 */
-  f_tab[10] = 524288;   /* 19 */
-  f_tab[11] = 128;      /*  7 */
-  f_tab[12] = 33554432; /* 25 */
-  f_tab[13] = 2;        /*  1 */
-  f_tab[14] = 2048;     /* 11 */
-  f_tab[15] = 32768;    /* 15 */
-  f_tab[16] = 131072;   /* 17 */
-  f_tab[17] = 512;      /*  9 */
+  if (DimX < 3 || DimY < 3 || DimZ < 3)
+  {
+    // no voxels inside the border
+    return;
+  }
+
+  this->InitializeBorderVoxels();
 
   /* eigentliches Bildparsing */
-  end = end - nzz - nx - 1;
   cnt = 1;
   while (cnt)
   {
     cnt = 0;
     for (dir = 0; dir < 18; dir++)
     {
-      cnt1 = 0;
-      dir_mask = dir_tab[dir];
-      for (i = nzz + nx + 1; i < end; i++)
-      {
-        if (result[i] == OBJ)
-        {
-          nc = Env_Code_3(i);
-          if (((~nc) & dir_mask) == dir_mask)
-          {
-            if (bitcount(nc) > 2)
-            {
-              if (Tilg_Test_3(nc, dir, type) == BG)
-              {
-                list[cnt1++] = i;
-              }
-            }
-          }
-        }
-      }
-      /* Voxel der Liste loeschen */
-      for (i = 0; i < cnt1; i++)
-      {
-        result[list[i]] = BG;
-      }
-      cnt += cnt1;
+      cnt += this->ParallelSubIteration(dir_tab[dir], dir, type);
     }
   }
 
@@ -749,23 +890,25 @@ void tilg_iso_3D(int dx, int dy, int dz, unsigned char* data, unsigned char* res
   cnt = 1;
   while (cnt)
   {
-    cnt = 0;
-    for (i = nzz + nx + 1; i < end; i++)
-    {
-      if (result[i] == OBJ)
-      {
-        nc = Env_Code_3(i);
-        if (bitcount(nc) > 2)
-        {
-          if (Tilg_Test_3(nc, 18, type) == BG)
-          {
-            cnt++;
-            result[i] = BG;
-          }
-        }
-      }
-    }
+    cnt = this->SequentialPass(type);
   }
 
-  free(list);
+  /* Randmarkierung entfernen */
+  for (int borderVoxel : this->BorderVoxels)
+  {
+    Result[borderVoxel] = OBJ;
+  }
+  this->BorderVoxels.clear();
+  Result = nullptr;
+}
+
+//----------------------------------------------------------------------------
+void tilg_iso_3D(int dx, int dy, int dz, unsigned char* data, unsigned char* res, int type)
+// dx,dy,dz  are the dimensions of the input (data) and output (res) image
+// output image has to be allocated
+// if type == 1 -> sheet preserving tilg
+// if type == 0 -> full tilg
+{
+  TilgIso3D tilg;
+  tilg.Execute(dx, dy, dz, data, res, type);
 }
@@ -14,13 +14,21 @@
 #ifndef _TILG_ISO_3D_H_
 #define _TILG_ISO_3D_H_
 
+#include "ExtractSkeletonExport.h"
+
+#include <vector>
+
 #define OBJ 1
 #define BG 0
 
-int Env_Code_3_img(int loc[3], unsigned char* img, int dim[3]);
+// Neighbors that have to be background for removing a voxel in each of the
+// 18 parallel sub-iterations (bit masks of the neighbor code)
+extern ExtractSkeleton_EXPORT const int dir_tab[18];
+
+ExtractSkeleton_EXPORT int Env_Code_3_img(int loc[3], unsigned char* img, int dim[3]);
 // returns the neighbor code including the center at position loc
 
-int Tilg_Test_3(int c, int d, int type);
+ExtractSkeleton_EXPORT int Tilg_Test_3(int c, int d, int type);
 
 /* Calculation of Tilg-criterion, c is the Neighbor-code of */
 /* 3x3x3-Region, including the center                      */
@@ -29,7 +37,62 @@ int Tilg_Test_3(int c, int d, int type);
 // if type == 0 -> full tilg
 // d = for parallel tilg -> 0,1,2,3,4,5   N,S,E,W,T,D
 
-void tilg_iso_3D(int dx, int dy, int dz, unsigned char* data, unsigned char* res, int type);
+// 3D isotropic tilg-procedure that does a 3D thinning.
+//
+// All state is stored in the object, therefore multiple images can be thinned
+// concurrently using separate TilgIso3D objects.
+//
+// Only border voxels (object voxels that have a background face neighbor) can be
+// removed, therefore instead of scanning the whole image in each pass, only a list
+// of border voxels is checked. The list is updated as voxels are removed.
+// Border voxels are flagged in the result image, therefore no additional
+// full-size buffer is allocated.
+// In the parallel sub-iterations the removal of each border voxel only depends on the
+// image before the sub-iteration, so border voxels are checked on multiple threads.
+// The final sequential thinning visits border voxels in the same (raster) order as a
+// full image scan would, so the result is identical to the original algorithm.
+class ExtractSkeleton_EXPORT TilgIso3D
+{
+public:
+  TilgIso3D();
+
+  // Number of threads used for the parallel sub-iterations.
+  // If 0 (default) then the number of hardware threads is used.
+  void SetNumberOfThreads(int numberOfThreads) { this->NumberOfThreads = numberOfThreads; }
+  int GetNumberOfThreads() const { return this->NumberOfThreads; }
+
+  // dx,dy,dz  are the dimensions of the input (data) and output (res) image
+  // output image has to be allocated
+  // if type == 1 -> sheet preserving tilg
+  // if type == 0 -> full tilg
+  void Execute(int dx, int dy, int dz, const unsigned char* data, unsigned char* res, int type);
+
+protected:
+  // neighbor code of the 3x3x3 region around voxel index i in the result image
+  int EnvCode(int i) const;
+
+  // find all object voxels that have a background face neighbor
+  void InitializeBorderVoxels();
+
+  // add object face neighbors of a removed voxel to the border list
+  void AddNewBorderNeighbors(int i, std::vector<int>& newBorderVoxels);
+
+  // parallel sub-iterations, returns the number of removed voxels
+  int ParallelSubIteration(int dirMask, int dir, int type);
+
+  // one pass of sequential thinning, returns the number of removed voxels
+  int SequentialPass(int type);
+
+  int NumberOfThreads;
+
+  // image dimensions, SliceSize = DimX * DimY
+  int DimX, DimY, DimZ, SliceSize;
+  unsigned char* Result;
+
+  std::vector<int> BorderVoxels;
+};
+
+ExtractSkeleton_EXPORT void tilg_iso_3D(int dx, int dy, int dz, unsigned char* data, unsigned char* res, int type);
 
 // 3D isotropic tilg-procedure that does a 3D thinning
 // dx,dy,dz  are the dimensions of the input (data) and output (res) image
@@ -38,14 +38,17 @@ Version:   $Revision$
 #include <vtkGeometryFilter.h>
 #include <vtkImageAccumulate.h>
 #include <vtkImageChangeInformation.h>
+#include <vtkImageClip.h>
 #include <vtkImageConstantPad.h>
 #include <vtkImageData.h>
 #include <vtkImageThreshold.h>
 #include <vtkImageToStructuredPoints.h>
 #include <vtkInformation.h>
 #include <vtkLookupTable.h>
+#include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
+#include <vtkPolyData.h>
 #include <vtkPolyDataNormals.h>
 #include <vtkPolyDataWriter.h>
 #include <vtkReverseSense.h>
@@ -62,6 +65,395 @@ Version:   $Revision$
 // VTKsys includes
 #include <vtksys/SystemTools.hxx>
 
+// STD includes
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+
+typedef std::array<int, 6> ExtentType;
+
+//----------------------------------------------------------------------------
+/// Parameters shared by all the labels when models are generated in parallel.
+struct ModelParameters
+{
+  bool JointSmoothing{ false };
+  bool SincSmoothing{ true };
+  int Smooth{ 10 };
+  double Decimate{ 0.25 };
+  bool PointNormals{ true };
+  bool SplitNormals{ true };
+  vtkSmartPointer<vtkMatrix4x4> IJKToLPSMatrix;
+  std::string FileHeader;
+};
+
+//----------------------------------------------------------------------------
+/// One model to generate in parallel mode.
+struct ModelJob
+{
+  int Label{ 0 };
+  std::string LabelName;
+  std::string FileName;
+  /// Shallow copy of the (padded) label image or the jointly smoothed surface
+  vtkSmartPointer<vtkDataObject> Input;
+  /// Region of the label image that contains the label (not used for joint smoothing)
+  ExtentType Extent{ { 0, -1, 0, -1, 0, -1 } };
+  bool Success{ false };
+  bool Empty{ false };
+  double ElapsedTimeSec{ 0.0 };
+};
+
+//----------------------------------------------------------------------------
+template <class T>
+void ComputeLabelExtentsTemplate(vtkImageData* image, T* scalars, std::map<int, ExtentType>& labelExtents)
+{
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  image->GetExtent(extent);
+  vtkIdType increments[3] = { 0, 0, 0 };
+  image->GetIncrements(increments);
+  for (int k = extent[4]; k <= extent[5]; ++k)
+  {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+    {
+      T* rowPtr = scalars + (k - extent[4]) * increments[2] + (j - extent[2]) * increments[1];
+      int runStart = extent[0];
+      while (runStart <= extent[1])
+      {
+        // find the end of the run of voxels with the same value
+        T value = rowPtr[(runStart - extent[0]) * increments[0]];
+        int runEnd = runStart;
+        while (runEnd + 1 <= extent[1] && rowPtr[(runEnd + 1 - extent[0]) * increments[0]] == value)
+        {
+          ++runEnd;
+        }
+        int label = static_cast<int>(value);
+        auto labelExtentIt = labelExtents.find(label);
+        if (labelExtentIt == labelExtents.end())
+        {
+          labelExtents[label] = { { runStart, runEnd, j, j, k, k } };
+        }
+        else
+        {
+          ExtentType& labelExtent = labelExtentIt->second;
+          labelExtent[0] = std::min(labelExtent[0], runStart);
+          labelExtent[1] = std::max(labelExtent[1], runEnd);
+          labelExtent[2] = std::min(labelExtent[2], j);
+          labelExtent[3] = std::max(labelExtent[3], j);
+          labelExtent[4] = std::min(labelExtent[4], k);
+          labelExtent[5] = std::max(labelExtent[5], k);
+        }
+        runStart = runEnd + 1;
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Get bounding box of all label values in a single pass over the image.
+void ComputeLabelExtents(vtkImageData* image, std::map<int, ExtentType>& labelExtents)
+{
+  labelExtents.clear();
+  switch (image->GetScalarType())
+  {
+    vtkTemplateMacro(ComputeLabelExtentsTemplate<VTK_TT>(image, static_cast<VTK_TT*>(image->GetScalarPointer()), labelExtents));
+    default: std::cerr << "ERROR: unsupported label image scalar type " << image->GetScalarTypeAsString() << std::endl; break;
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Report progress the same way as vtkPluginFilterWatcher does.
+void ReportProgress(ModuleProcessInformation* processInformation, const std::string& comment, double progress)
+{
+  if (processInformation)
+  {
+    strncpy(processInformation->ProgressMessage, comment.c_str(), 1023);
+    processInformation->Progress = progress;
+    processInformation->StageProgress = 0;
+    if (processInformation->ProgressCallbackFunction //
+        && processInformation->ProgressCallbackClientData)
+    {
+      (*(processInformation->ProgressCallbackFunction))(processInformation->ProgressCallbackClientData);
+    }
+  }
+  else
+  {
+    std::cout << "<filter-comment>" << " \"" << comment << "\" " << "</filter-comment>" << std::endl;
+    std::cout << "<filter-progress>" << progress << "</filter-progress>" << std::endl;
+    std::cout << std::flush;
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Move a label from the list of made models to the list of skipped models
+/// (used when no model could be created from the label).
+void MarkModelSkipped(int label, std::vector<int>& madeModels, std::vector<int>& skippedModels)
+{
+  madeModels.erase(std::remove(madeModels.begin(), madeModels.end(), label), madeModels.end());
+  skippedModels.push_back(label);
+}
+
+//----------------------------------------------------------------------------
+/// Generate and write the model of a single label.
+/// The processing steps and parameters are the same as in the sequential mode, therefore
+/// the output is identical. The function only uses objects that are owned by the job,
+/// so it can be called concurrently for different jobs.
+void MakeModel(ModelJob& job, const ModelParameters& parameters)
+{
+  auto startTime = std::chrono::steady_clock::now();
+
+  vtkSmartPointer<vtkPolyData> surface;
+  if (!parameters.JointSmoothing)
+  {
+    // Only process the region that contains the label. The threshold output is 0 outside this
+    // region, so the extracted surface is the same as the one generated from the full image.
+    vtkImageData* labelImage = vtkImageData::SafeDownCast(job.Input);
+    int* wholeExtent = labelImage->GetExtent();
+    vtkNew<vtkImageClip> clipper;
+    clipper->SetInputData(labelImage);
+    clipper->SetOutputWholeExtent(std::max(job.Extent[0] - 1, wholeExtent[0]),
+                                  std::min(job.Extent[1] + 1, wholeExtent[1]),
+                                  std::max(job.Extent[2] - 1, wholeExtent[2]),
+                                  std::min(job.Extent[3] + 1, wholeExtent[3]),
+                                  std::max(job.Extent[4] - 1, wholeExtent[4]),
+                                  std::min(job.Extent[5] + 1, wholeExtent[5]));
+    clipper->ClipDataOn();
+
+    vtkNew<vtkImageThreshold> imageThreshold;
+    imageThreshold->SetInputConnection(clipper->GetOutputPort());
+    imageThreshold->SetReplaceIn(1);
+    imageThreshold->SetReplaceOut(1);
+    imageThreshold->SetInValue(200);
+    imageThreshold->SetOutValue(0);
+    imageThreshold->ThresholdBetween(job.Label, job.Label);
+
+    vtkNew<vtkFlyingEdges3D> mcubes;
+    mcubes->SetInputConnection(imageThreshold->GetOutputPort());
+    mcubes->SetValue(0, 100.5);
+    mcubes->ComputeScalarsOff();
+    mcubes->ComputeGradientsOff();
+    mcubes->ComputeNormalsOff();
+    mcubes->Update();
+    surface = mcubes->GetOutput();
+    if (surface->GetNumberOfPolys() == 0)
+    {
+      job.Empty = true;
+      job.Success = true;
+      return;
+    }
+  }
+  else
+  {
+    vtkNew<vtkThreshold> threshold;
+    threshold->SetInputData(job.Input);
+    threshold->SetLowerThreshold(job.Label);
+    threshold->SetUpperThreshold(job.Label);
+    threshold->SetThresholdFunction(vtkThreshold::THRESHOLD_BETWEEN);
+    vtkNew<vtkGeometryFilter> geometryFilter;
+    geometryFilter->SetInputConnection(threshold->GetOutputPort());
+    geometryFilter->Update();
+    surface = geometryFilter->GetOutput();
+  }
+
+  vtkNew<vtkDecimatePro> decimator;
+  decimator->SetInputData(surface);
+  decimator->SetFeatureAngle(60);
+  decimator->SplittingOff();
+  decimator->PreserveTopologyOn();
+  decimator->SetMaximumError(1);
+  decimator->SetTargetReduction(parameters.Decimate);
+  decimator->Update();
+  surface = decimator->GetOutput();
+
+  if (parameters.IJKToLPSMatrix->Determinant() < 0)
+  {
+    vtkNew<vtkReverseSense> reverser;
+    reverser->SetInputData(surface);
+    reverser->ReverseNormalsOn();
+    reverser->Update();
+    surface = reverser->GetOutput();
+  }
+
+  if (!parameters.JointSmoothing)
+  {
+    if (parameters.SincSmoothing)
+    {
+      vtkNew<vtkWindowedSincPolyDataFilter> smootherSinc;
+      smootherSinc->SetInputData(surface);
+      smootherSinc->SetPassBand(0.1);
+      smootherSinc->SetNumberOfIterations(parameters.Smooth);
+      smootherSinc->FeatureEdgeSmoothingOff();
+      smootherSinc->BoundarySmoothingOff();
+      smootherSinc->Update();
+      surface = smootherSinc->GetOutput();
+    }
+    else
+    {
+      vtkNew<vtkSmoothPolyDataFilter> smootherPoly;
+      smootherPoly->SetInputData(surface);
+      smootherPoly->SetRelaxationFactor(0.33);
+      smootherPoly->SetFeatureAngle(60);
+      smootherPoly->SetConvergence(0);
+      smootherPoly->SetNumberOfIterations(parameters.Smooth);
+      smootherPoly->FeatureEdgeSmoothingOff();
+      smootherPoly->BoundarySmoothingOff();
+      smootherPoly->Update();
+      surface = smootherPoly->GetOutput();
+    }
+  }
+
+  // each job uses its own transform object, as transforms are not safe to share between threads
+  vtkNew<vtkTransform> transformIJKtoLPS;
+  transformIJKtoLPS->SetMatrix(parameters.IJKToLPSMatrix);
+  vtkNew<vtkTransformPolyDataFilter> transformer;
+  transformer->SetInputData(surface);
+  transformer->SetTransform(transformIJKtoLPS);
+
+  vtkNew<vtkPolyDataNormals> normals;
+  normals->SetComputePointNormals(parameters.PointNormals);
+  normals->SetInputConnection(transformer->GetOutputPort());
+  normals->SetFeatureAngle(60);
+  normals->SetSplitting(parameters.SplitNormals);
+
+  vtkNew<vtkStripper> stripper;
+  stripper->SetInputConnection(normals->GetOutputPort());
+
+  vtkNew<vtkPolyDataWriter> writer;
+  writer->SetInputConnection(stripper->GetOutputPort());
+  writer->SetHeader(parameters.FileHeader.c_str());
+  writer->SetFileType(2);
+  writer->SetFileName(job.FileName.c_str());
+  job.Success = (writer->Write() != 0);
+
+  job.ElapsedTimeSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+//----------------------------------------------------------------------------
+/// Add model node, storage node, display node and hierarchy node for a generated model file.
+void AddModelToScene(vtkMRMLScene* modelScene,
+                     int label,
+                     const std::string& labelName,
+                     const std::string& fileName,
+                     vtkMRMLColorTableNode* colorNode,
+                     vtkMRMLModelHierarchyNode* topColorHierarchyNode,
+                     vtkMRMLNode* rnd,
+                     bool debug)
+{
+  if (debug)
+  {
+    std::cout << "Adding model " << labelName << " to the output scene, with filename " << fileName.c_str() << endl;
+  }
+  // each model needs a mrml node, a storage node and a display node
+  vtkNew<vtkMRMLModelNode> mnode;
+  mnode->SetScene(modelScene);
+  mnode->SetName(labelName.c_str());
+
+  vtkNew<vtkMRMLModelStorageNode> snode;
+  snode->SetFileName(fileName.c_str());
+  if (modelScene->AddNode(snode.GetPointer()) == nullptr)
+  {
+    std::cerr << "ERROR: unable to add the storage node to the model scene" << endl;
+  }
+  vtkNew<vtkMRMLModelDisplayNode> dnode;
+  dnode->SetColor(0.5, 0.5, 0.5);
+  double* rgba;
+  if (colorNode != nullptr)
+  {
+    rgba = colorNode->GetLookupTable()->GetTableValue(label);
+    if (rgba != nullptr)
+    {
+      if (debug)
+      {
+        std::cout << "Got color: " << rgba[0] << " " << rgba[1] << " " << rgba[2] << " " << rgba[3] << endl;
+      }
+      dnode->SetColor(rgba[0], rgba[1], rgba[2]);
+    }
+    else
+    {
+      std::cerr << "Couldn't get look up table value for " << label << ", display node color is not set (grey)" << endl;
+    }
+  }
+
+  dnode->SetVisibility(1);
+  modelScene->AddNode(dnode.GetPointer());
+  if (debug)
+  {
+    std::cout << "Added display node: id = " << (dnode->GetID() == nullptr ? "(null)" : dnode->GetID()) << endl;
+    std::cout << "Setting model's storage node: id = " << (snode->GetID() == nullptr ? "(null)" : snode->GetID()) << endl;
+  }
+  mnode->SetAndObserveStorageNodeID(snode->GetID());
+  mnode->SetAndObserveDisplayNodeID(dnode->GetID());
+  modelScene->AddNode(mnode.GetPointer());
+
+  // put it in the hierarchy, either the flat one by default or
+  // try to find the matching color hierarchy node to make this an
+  // associated node
+  std::string colorName;
+  if (colorNode != nullptr)
+  {
+    colorName = std::string(colorNode->GetColorNameAsFileName(label));
+  }
+  else
+  {
+    // might be in a testing case where the hierarchy nodes are
+    // numbered (made from the generic colors)
+    std::stringstream ss;
+    ss << label;
+    colorName = ss.str();
+    if (debug)
+    {
+      std::cout << "No color node, guessing at color name being same as label number " << colorName.c_str() << std::endl;
+    }
+  }
+  vtkMRMLNode* mrmlNode = nullptr;
+  if (colorName.compare("") != 0)
+  {
+    mrmlNode = modelScene->GetFirstNodeByName(colorName.c_str());
+  }
+  // if there's no color hierarchy, or no color name or the mrml node
+  // named for the color isn't a model hierarchy node, use a flat hierarchy
+  if (topColorHierarchyNode == nullptr || //
+      colorName.compare("") == 0 ||       //
+      mrmlNode == nullptr ||              //
+      strcmp(mrmlNode->GetClassName(), "vtkMRMLModelHierarchyNode") != 0)
+  {
+    vtkNew<vtkMRMLModelHierarchyNode> mhnd;
+    mhnd->SetHideFromEditors(1);
+    modelScene->AddNode(mhnd.GetPointer());
+    mhnd->SetParentNodeID(rnd->GetID());
+    mhnd->SetModelNodeID(mnode->GetID());
+  }
+  else
+  {
+    // use the template color hierarchy
+    vtkMRMLModelHierarchyNode* colorHierarchyNode = vtkMRMLModelHierarchyNode::SafeDownCast(mrmlNode);
+    if (colorHierarchyNode)
+    {
+      colorHierarchyNode->SetAssociatedNodeID(mnode->GetID());
+      // and hide it so that it doesn't clutter up the tree
+      colorHierarchyNode->SetHideFromEditors(1);
+      if (debug)
+      {
+        std::cout << "Found a color hierarchy node with name " << colorHierarchyNode->GetName() << ", set it's associated node to this model id: " << mnode->GetID()
+                  << std::endl;
+      }
+    }
+  }
+  if (debug)
+  {
+    std::cout << "...done adding model to output scene" << endl;
+  }
+}
+
+} // namespace
+
 int main(int argc, char* argv[])
 {
   PARSE_ARGS;
@@ -86,6 +478,7 @@ int main(int argc, char* argv[])
     std::cout << "Split normals? " << SplitNormals << std::endl;
     std::cout << "Calculate point normals? " << PointNormals << std::endl;
     std::cout << "Pad? " << Pad << std::endl;
+    std::cout << "Number of threads: " << NumberOfThreads << std::endl;
     std::cout << "Filter type: " << FilterType << std::endl;
     std::cout << "Input color hierarchy scene file: " << (ModelHierarchyFile.size() > 0 ? ModelHierarchyFile.c_str() : "None") << std::endl;
     std::cout << "Output model scene file: " << (ModelSceneFile.size() > 0 ? ModelSceneFile[0].c_str() : "None") << std::endl;
@@ -663,14 +1056,18 @@ int main(int argc, char* argv[])
       }
       cubes->GenerateValues((labelsMax - labelsMin + 1), labelsMin, labelsMax);
     }
-    try
+    // the surface of all labels is only needed for joint smoothing and for saving intermediate models
+    if (JointSmoothing || SaveIntermediateModels)
     {
-      cubes->Update();
-    }
-    catch (...)
-    {
-      std::cerr << "ERROR while updating marching cubes filter." << std::endl;
-      return EXIT_FAILURE;
+      try
+      {
+        cubes->Update();
+      }
+      catch (...)
+      {
+        std::cerr << "ERROR while updating marching cubes filter." << std::endl;
+        return EXIT_FAILURE;
+      }
     }
     if (JointSmoothing)
     {
@@ -819,6 +1216,42 @@ int main(int argc, char* argv[])
   transformIJKtoLPS->Scale(-1.0, -1.0, 1.0); // RAS to LPS
   transformIJKtoLPS->Concatenate(ijkToRasMatrix);
 
+  // In parallel mode the loop over the labels only collects the models to generate,
+  // the models are then generated on a thread pool.
+  bool parallelMode = (makeMultiple && NumberOfThreads != 1);
+  if (parallelMode && SaveIntermediateModels)
+  {
+    std::cout << "Saving intermediate models is not supported when using multiple threads, models are generated sequentially." << std::endl;
+    parallelMode = false;
+  }
+  std::vector<ModelJob> modelJobs;
+  std::map<int, ExtentType> labelExtents;
+  vtkSmartPointer<vtkDataObject> parallelModeInput;
+  if (parallelMode)
+  {
+    if (JointSmoothing)
+    {
+      vtkPolyData* smoothedSurface = smoother->GetOutput();
+      // build cells now so that the shallow copies used by the threads do not need to modify it
+      smoothedSurface->BuildCells();
+      parallelModeInput = smoothedSurface;
+    }
+    else
+    {
+      vtkImageData* labelImage = image;
+      if (Pad)
+      {
+        padder->Update();
+        labelImage = padder->GetOutput();
+      }
+      // find the region of each label in one pass, so that each label is only extracted from its own region
+      auto startTime = std::chrono::steady_clock::now();
+      ComputeLabelExtents(labelImage, labelExtents);
+      std::cout << "Computed label regions in " << std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count() << " s" << std::endl;
+      parallelModeInput = labelImage;
+    }
+  }
+
   //
   // Loop through all the labels
   //
@@ -947,6 +1380,37 @@ int main(int argc, char* argv[])
       */
     }
 
+    if (parallelMode)
+    {
+      ModelJob job;
+      job.Label = i;
+      job.LabelName = labelName;
+      if (rootDir != "")
+      {
+        job.FileName = rootDir + std::string("/") + labelName + std::string(".vtk");
+      }
+      else
+      {
+        std::cout << "WARNING: output directory is an empty string..." << endl;
+        job.FileName = labelName + std::string(".vtk");
+      }
+      if (!JointSmoothing)
+      {
+        auto labelExtentIt = labelExtents.find(i);
+        if (labelExtentIt == labelExtents.end())
+        {
+          std::cout << "Cannot create a model from label " << i << "\nNo polygons can be created,\nthere may be no voxels with this label in the volume." << endl;
+          MarkModelSkipped(i, madeModels, skippedModels);
+          continue;
+        }
+        job.Extent = labelExtentIt->second;
+      }
+      job.Input = vtkSmartPointer<vtkDataObject>::Take(parallelModeInput->NewInstance());
+      job.Input->ShallowCopy(parallelModeInput);
+      modelJobs.push_back(job);
+      continue;
+    }
+
     // threshold
     if (JointSmoothing == 0)
     {
@@ -1079,6 +1543,7 @@ int main(int argc, char* argv[])
       if ((mcubes->GetOutput())->GetNumberOfPolys() == 0)
       {
         std::cout << "Cannot create a model from label " << i << "\nNo polygons can be created,\nthere may be no voxels with this label in the volume." << endl;
+        MarkModelSkipped(i, madeModels, skippedModels);
         if (transformIJKtoLPS)
         {
           transformIJKtoLPS = nullptr;
@@ -1524,118 +1989,128 @@ int main(int argc, char* argv[])
       writer = nullptr;
       if (modelScene.GetPointer() != nullptr)
       {
-        if (debug)
-        {
-          std::cout << "Adding model " << labelName << " to the output scene, with filename " << fileName.c_str() << endl;
-        }
-        // each model needs a mrml node, a storage node and a display node
-        vtkNew<vtkMRMLModelNode> mnode;
-        mnode->SetScene(modelScene.GetPointer());
-        mnode->SetName(labelName.c_str());
-
-        vtkNew<vtkMRMLModelStorageNode> snode;
-        snode->SetFileName(fileName.c_str());
-        if (modelScene->AddNode(snode.GetPointer()) == nullptr)
-        {
-          std::cerr << "ERROR: unable to add the storage node to the model scene" << endl;
-        }
-        vtkNew<vtkMRMLModelDisplayNode> dnode;
-        dnode->SetColor(0.5, 0.5, 0.5);
-        double* rgba;
-        if (colorNode != nullptr)
+        AddModelToScene(modelScene, i, labelName, fileName, colorNode, topColorHierarchyNode, rnd, debug);
+      }
+    } // end of skipping an empty label
+  } // end of loop over labels
+
+  if (parallelMode && !modelJobs.empty())
+  {
+    ModelParameters parameters;
+    parameters.JointSmoothing = JointSmoothing;
+    parameters.SincSmoothing = (strcmp(FilterType.c_str(), "Sinc") == 0);
+    if (parameters.SincSmoothing && Smooth == 1)
+    {
+      std::cerr << "Warning: Smoothing iterations of 1 not allowed for Sinc filter, using 2" << endl;
+      Smooth = 2;
+    }
+    parameters.Smooth = Smooth;
+    parameters.Decimate = Decimate;
+    parameters.PointNormals = PointNormals;
+    parameters.SplitNormals = SplitNormals;
+    parameters.IJKToLPSMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
+    parameters.IJKToLPSMatrix->DeepCopy(transformIJKtoLPS->GetMatrix());
+    parameters.FileHeader = modelFileHeader;
+
+    unsigned int numberOfThreads = NumberOfThreads;
+    if (NumberOfThreads <= 0)
+    {
+      numberOfThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    numberOfThreads = std::min(numberOfThreads, static_cast<unsigned int>(modelJobs.size()));
+    std::cout << "Generating " << modelJobs.size() << " models using " << numberOfThreads << " threads" << std::endl;
+    auto startTime = std::chrono::steady_clock::now();
+
+    std::atomic<::size_t> nextJobIndex(0);
+    std::atomic<bool> aborted(false);
+    std::mutex completedJobsMutex;
+    std::condition_variable completedJobsCondition;
+    std::deque<::size_t> completedJobs;
+    std::vector<std::thread> workers;
+    for (unsigned int threadIndex = 0; threadIndex < numberOfThreads; ++threadIndex)
+    {
+      workers.emplace_back(
+        [&]()
         {
-          rgba = colorNode->GetLookupTable()->GetTableValue(i);
-          if (rgba != nullptr)
+          ::size_t jobIndex = 0;
+          while ((jobIndex = nextJobIndex++) < modelJobs.size())
           {
-            if (debug)
+            if (CLPProcessInformation && CLPProcessInformation->Abort)
             {
-              std::cout << "Got color: " << rgba[0] << " " << rgba[1] << " " << rgba[2] << " " << rgba[3] << endl;
+              aborted = true;
             }
-            dnode->SetColor(rgba[0], rgba[1], rgba[2]);
-          }
-          else
-          {
-            std::cerr << "Couldn't get look up table value for " << i << ", display node color is not set (grey)" << endl;
-          }
-        }
-
-        dnode->SetVisibility(1);
-        modelScene->AddNode(dnode.GetPointer());
-        if (debug)
-        {
-          std::cout << "Added display node: id = " << (dnode->GetID() == nullptr ? "(null)" : dnode->GetID()) << endl;
-          std::cout << "Setting model's storage node: id = " << (snode->GetID() == nullptr ? "(null)" : snode->GetID()) << endl;
-        }
-        mnode->SetAndObserveStorageNodeID(snode->GetID());
-        mnode->SetAndObserveDisplayNodeID(dnode->GetID());
-        modelScene->AddNode(mnode.GetPointer());
-
-        // put it in the hierarchy, either the flat one by default or
-        // try to find the matching color hierarchy node to make this an
-        // associated node
-        std::string colorName;
-        if (colorNode != nullptr)
-        {
-          colorName = std::string(colorNode->GetColorNameAsFileName(i));
-        }
-        else
-        {
-          // might be in a testing case where the hierarchy nodes are
-          // numbered (made from the generic colors)
-          std::stringstream ss;
-          ss << i;
-          colorName = ss.str();
-          if (debug)
-          {
-            std::cout << "No color node, guessing at color name being same as label number " << colorName.c_str() << std::endl;
-          }
-        }
-        vtkMRMLNode* mrmlNode = nullptr;
-        if (colorName.compare("") != 0)
-        {
-          mrmlNode = modelScene->GetFirstNodeByName(colorName.c_str());
-        }
-        // if there's no color hierarchy, or no color name or the mrml node
-        // named for the color isn't a model hierarchy node, use a flat hierarchy
-        if (topColorHierarchyNode == nullptr || //
-            colorName.compare("") == 0 ||       //
-            mrmlNode == nullptr ||              //
-            strcmp(mrmlNode->GetClassName(), "vtkMRMLModelHierarchyNode") != 0)
-        {
-          vtkNew<vtkMRMLModelHierarchyNode> mhnd;
-          mhnd->SetHideFromEditors(1);
-          modelScene->AddNode(mhnd.GetPointer());
-          mhnd->SetParentNodeID(rnd->GetID());
-          mhnd->SetModelNodeID(mnode->GetID());
-        }
-        else
-        {
-          // use the template color hierarchy
-          vtkMRMLModelHierarchyNode* colorHierarchyNode = vtkMRMLModelHierarchyNode::SafeDownCast(mrmlNode);
-          if (colorHierarchyNode)
-          {
-            colorHierarchyNode->SetAssociatedNodeID(mnode->GetID());
-            // and hide it so that it doesn't clutter up the tree
-            colorHierarchyNode->SetHideFromEditors(1);
-            if (debug)
+            if (!aborted)
             {
-              std::cout << "Found a color hierarchy node with name " << colorHierarchyNode->GetName() << ", set it's associated node to this model id: " << mnode->GetID()
-                        << std::endl;
+              MakeModel(modelJobs[jobIndex], parameters);
             }
+            {
+              std::lock_guard<std::mutex> lock(completedJobsMutex);
+              completedJobs.push_back(jobIndex);
+            }
+            completedJobsCondition.notify_one();
           }
-        }
-        if (debug)
-        {
-          std::cout << "...done adding model to output scene" << endl;
-        }
+        });
+    }
+
+    // Report progress and timing from the main thread as models are completed
+    ::size_t numberOfCompletedJobs = 0;
+    while (numberOfCompletedJobs < modelJobs.size())
+    {
+      std::unique_lock<std::mutex> lock(completedJobsMutex);
+      completedJobsCondition.wait(lock, [&]() { return !completedJobs.empty(); });
+      ::size_t jobIndex = completedJobs.front();
+      completedJobs.pop_front();
+      lock.unlock();
+      numberOfCompletedJobs++;
+      if (aborted)
+      {
+        continue;
       }
-    } // end of skipping an empty label
-  } // end of loop over labels
+      const ModelJob& job = modelJobs[jobIndex];
+      std::stringstream comment;
+      comment << "Made model " << job.LabelName << " in " << job.ElapsedTimeSec << " s (" << numberOfCompletedJobs << " of " << modelJobs.size() << ")";
+      ReportProgress(CLPProcessInformation, comment.str(), (currentFilterOffset + numberOfCompletedJobs * numRepeatedFilterSteps) / numFilterSteps);
+    }
+    for (std::thread& worker : workers)
+    {
+      worker.join();
+    }
+    if (aborted)
+    {
+      std::cerr << "ERROR: model generation was aborted" << std::endl;
+      return EXIT_FAILURE;
+    }
+    std::cout << "Generated " << modelJobs.size() << " models in " << std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count() << " s" << std::endl;
+
+    // Add the models to the scene in label order, the same way as in sequential mode
+    for (const ModelJob& job : modelJobs)
+    {
+      if (job.Empty)
+      {
+        std::cout << "Cannot create a model from label " << job.Label << "\nNo polygons can be created,\nthere may be no voxels with this label in the volume." << endl;
+        MarkModelSkipped(job.Label, madeModels, skippedModels);
+        continue;
+      }
+      if (!job.Success)
+      {
+        std::cerr << "ERROR: Failed to write model file " << job.FileName.c_str() << std::endl;
+      }
+      if (modelScene.GetPointer() != nullptr)
+      {
+        AddModelToScene(modelScene, job.Label, job.LabelName, job.FileName, colorNode, topColorHierarchyNode, rnd, debug);
+      }
+    }
+    modelJobs.clear();
+  }
+
   if (debug)
   {
     std::cout << "End of looping over labels" << endl;
   }
-  // Report what was done
+  // Report what was done. Labels are sorted, because in parallel mode labels that
+  // turn out to be empty are only moved to the skipped list after all models are generated.
+  std::sort(madeModels.begin(), madeModels.end());
+  std::sort(skippedModels.begin(), skippedModels.end());
   if (madeModels.size() > 0)
   {
     std::cout << "Made models from labels:";
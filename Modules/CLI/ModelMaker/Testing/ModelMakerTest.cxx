@@ -7,8 +7,10 @@
 #endif
 
 extern "C" MODULE_IMPORT int ModuleEntryPoint(int, char*[]);
+int ModelMakerThreadsTest(int, char*[]);
 
 void RegisterTests()
 {
   StringToTestFunctionMap["ModuleEntryPoint"] = ModuleEntryPoint;
+  StringToTestFunctionMap["ModelMakerThreadsTest"] = ModelMakerThreadsTest;
 }
@@ -0,0 +1,176 @@
+// VTK includes
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataReader.h>
+
+// VTKsys includes
+#include <vtksys/Directory.hxx>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+# define MODULE_IMPORT __declspec(dllimport)
+#else
+# define MODULE_IMPORT
+#endif
+
+extern "C" MODULE_IMPORT int ModuleEntryPoint(int, char*[]);
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Run the module and return the lines of its output that report the made and skipped labels.
+bool RunModelMaker(const std::vector<std::string>& arguments, std::string& report)
+{
+  std::vector<char*> argv;
+  std::string programName = "ModelMaker";
+  argv.push_back(&programName[0]);
+  std::vector<std::string> argumentsCopy = arguments;
+  for (std::string& argument : argumentsCopy)
+  {
+    argv.push_back(&argument[0]);
+  }
+
+  std::stringstream output;
+  std::streambuf* coutBuffer = std::cout.rdbuf(output.rdbuf());
+  int result = ModuleEntryPoint(static_cast<int>(argv.size()), argv.data());
+  std::cout.rdbuf(coutBuffer);
+
+  report.clear();
+  std::string line;
+  while (std::getline(output, line))
+  {
+    if (line.find("Made models from labels:") == 0 || line.find("Skipped making models from labels:") == 0)
+    {
+      report += line + "\n";
+    }
+  }
+  if (result != EXIT_SUCCESS)
+  {
+    std::cerr << "ModelMaker failed. Output:\n" << output.str() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Check that the model files in the two directories are identical.
+bool CompareModelDirectories(const std::string& expectedDirectory, const std::string& directory)
+{
+  vtksys::Directory expectedFiles;
+  expectedFiles.Load(expectedDirectory);
+  int numberOfModels = 0;
+  for (unsigned long fileIndex = 0; fileIndex < expectedFiles.GetNumberOfFiles(); ++fileIndex)
+  {
+    std::string fileName = expectedFiles.GetFile(fileIndex);
+    if (vtksys::SystemTools::GetFilenameLastExtension(fileName) != ".vtk")
+    {
+      continue;
+    }
+    numberOfModels++;
+    std::string filePath = directory + "/" + fileName;
+    if (!vtksys::SystemTools::FileExists(filePath))
+    {
+      std::cerr << "Model file is missing: " << filePath << std::endl;
+      return false;
+    }
+    vtkNew<vtkPolyDataReader> expectedReader;
+    expectedReader->SetFileName((expectedDirectory + "/" + fileName).c_str());
+    expectedReader->Update();
+    vtkPolyData* expectedModel = expectedReader->GetOutput();
+    vtkNew<vtkPolyDataReader> reader;
+    reader->SetFileName(filePath.c_str());
+    reader->Update();
+    vtkPolyData* model = reader->GetOutput();
+    if (model->GetNumberOfPoints() != expectedModel->GetNumberOfPoints()   //
+        || model->GetNumberOfStrips() != expectedModel->GetNumberOfStrips() //
+        || model->GetNumberOfPolys() != expectedModel->GetNumberOfPolys())
+    {
+      std::cerr << "Model " << fileName << " differs: number of points " << model->GetNumberOfPoints() << " (expected " << expectedModel->GetNumberOfPoints() << ")"
+                << ", strips " << model->GetNumberOfStrips() << " (expected " << expectedModel->GetNumberOfStrips() << ")"
+                << ", polys " << model->GetNumberOfPolys() << " (expected " << expectedModel->GetNumberOfPolys() << ")" << std::endl;
+      return false;
+    }
+    for (vtkIdType pointId = 0; pointId < model->GetNumberOfPoints(); ++pointId)
+    {
+      double expectedPoint[3] = { 0.0, 0.0, 0.0 };
+      expectedModel->GetPoint(pointId, expectedPoint);
+      double point[3] = { 0.0, 0.0, 0.0 };
+      model->GetPoint(pointId, point);
+      if (point[0] != expectedPoint[0] || point[1] != expectedPoint[1] || point[2] != expectedPoint[2])
+      {
+        std::cerr << "Model " << fileName << " differs at point " << pointId << std::endl;
+        return false;
+      }
+    }
+  }
+  if (numberOfModels == 0)
+  {
+    std::cerr << "No models were generated in " << expectedDirectory << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+// Generate models from all labels of the input labelmap sequentially and using multiple
+// threads, and check that the model files and the reported made/skipped labels are the same.
+// Usage: ModelMakerThreadsTest inputLabelmap temporaryDirectory [additional ModelMaker arguments]
+int ModelMakerThreadsTest(int argc, char* argv[])
+{
+  if (argc < 3)
+  {
+    std::cerr << "Usage: ModelMakerThreadsTest inputLabelmap temporaryDirectory [additional ModelMaker arguments]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::string inputLabelmap = argv[1];
+  std::string outputDirectory = argv[2];
+  std::vector<std::string> additionalArguments(argv + 3, argv + argc);
+
+  std::string sequentialDirectory = outputDirectory + "/Sequential";
+  std::string parallelDirectory = outputDirectory + "/Parallel";
+  vtksys::SystemTools::RemoveADirectory(outputDirectory);
+  if (!vtksys::SystemTools::MakeDirectory(sequentialDirectory) || !vtksys::SystemTools::MakeDirectory(parallelDirectory))
+  {
+    std::cerr << "Failed to create output directory " << outputDirectory << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::vector<std::string> arguments = { "--generateAll", "--numberOfThreads", "1", "--modelSceneFile", sequentialDirectory + "/Models.mrml#vtkMRMLModelHierarchyNode1" };
+  arguments.insert(arguments.end(), additionalArguments.begin(), additionalArguments.end());
+  arguments.push_back(inputLabelmap);
+  std::string sequentialReport;
+  if (!RunModelMaker(arguments, sequentialReport))
+  {
+    return EXIT_FAILURE;
+  }
+
+  arguments[2] = "3";
+  arguments[4] = parallelDirectory + "/Models.mrml#vtkMRMLModelHierarchyNode1";
+  std::string parallelReport;
+  if (!RunModelMaker(arguments, parallelReport))
+  {
+    return EXIT_FAILURE;
+  }
+
+  if (sequentialReport.empty() || parallelReport != sequentialReport)
+  {
+    std::cerr << "Made and skipped labels are different in parallel mode.\nSequential:\n" << sequentialReport << "Parallel:\n" << parallelReport << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (!CompareModelDirectories(sequentialDirectory, parallelDirectory))
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,403 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Measures latency of processing mouse move events over markups with many control points
+// and checks that the control point under the mouse is found, in slice and 3D views.
+
+// MRML Markups nodes includes
+#include "vtkMRMLMarkupsDisplayNode.h"
+#include "vtkMRMLMarkupsFiducialNode.h"
+
+// VTK Widgets Markups includes
+#include "vtkMarkupsControlPointLocator.h"
+#include "vtkSlicerPointsWidget.h"
+#include "vtkSlicerMarkupsWidgetRepresentation.h"
+
+// MRML includes
+#include <vtkMRMLCoreTestingMacros.h>
+#include <vtkMRMLInteractionEventData.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLSliceNode.h>
+#include <vtkMRMLViewNode.h>
+
+// VTK includes
+#include <vtkCamera.h>
+#include <vtkCommand.h>
+#include <vtkIdList.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+const int VIEW_SIZE_PIXEL = 512;
+// Control points are placed on a grid, far enough from each other so that there is always
+// at most one control point within picking distance (glyph size is 5 pixels, picking tolerance is 30 pixels).
+const double GRID_SPACING_MM = 100.0;
+const int NUMBER_OF_MOUSE_MOVE_EVENTS = 2000;
+
+//----------------------------------------------------------------------------
+int TestLocator()
+{
+  vtkNew<vtkMarkupsControlPointLocator> locator;
+  vtkNew<vtkIdList> foundIndices;
+  double origin[3] = { 0.0, 0.0, 0.0 };
+
+  // Empty locator
+  locator->FindPointsWithinRadius(10.0, origin, foundIndices);
+  CHECK_INT(foundIndices->GetNumberOfIds(), 0);
+  locator->FindSegmentsWithinRadius(10.0, origin, foundIndices);
+  CHECK_INT(foundIndices->GetNumberOfIds(), 0);
+
+  // Points along the x axis, connected by segments
+  double previousPosition[3] = { 0.0, 0.0, 0.0 };
+  for (int i = 0; i < 100; ++i)
+  {
+    double position[3] = { i * 10.0, 0.0, 0.0 };
+    locator->AddPoint(i, position);
+    if (i > 0)
+    {
+      locator->AddSegment(i - 1, previousPosition, position);
+    }
+    std::copy(position, position + 3, previousPosition);
+  }
+  CHECK_INT(locator->GetNumberOfPoints(), 100);
+  CHECK_INT(locator->GetNumberOfSegments(), 99);
+
+  double position[3] = { 201.0, 1.0, 0.0 };
+  locator->FindPointsWithinRadius(3.0, position, foundIndices);
+  CHECK_INT(foundIndices->GetNumberOfIds(), 1);
+  CHECK_INT(foundIndices->GetId(0), 20);
+  locator->FindPointsWithinRadius(12.0, position, foundIndices);
+  CHECK_INT(foundIndices->GetNumberOfIds(), 3);
+  CHECK_INT(foundIndices->GetId(0), 19);
+  CHECK_INT(foundIndices->GetId(2), 21);
+
+  // Segment is found at its middle, far from its endpoints
+  double segmentPosition[3] = { 255.0, 2.0, 0.0 };
+  locator->FindPointsWithinRadius(3.0, segmentPosition, foundIndices);
+  CHECK_INT(foundIndices->GetNumberOfIds(), 0);
+  locator->FindSegmentsWithinRadius(3.0, segmentPosition, foundIndices);
+  CHECK_BOOL(foundIndices->IsId(25) >= 0, true);
+  double farPosition[3] = { 255.0, 50.0, 0.0 };
+  locator->FindSegmentsWithinRadius(3.0, farPosition, foundIndices);
+  CHECK_INT(foundIndices->GetNumberOfIds(), 0);
+
+  // Points near a line that is perpendicular to the x axis, between two points
+  double bounds[6] = { 0.0, -1.0, 0.0, -1.0, 0.0, -1.0 };
+  locator->GetPointBounds(bounds);
+  CHECK_DOUBLE(bounds[0], 0.0);
+  CHECK_DOUBLE(bounds[1], 990.0);
+  double linePoint1[3] = { 205.0, 5.0, -100.0 };
+  double linePoint2[3] = { 205.0, 5.0, 100.0 };
+  locator->FindPointsWithinRadiusOfLine(6.0, linePoint1, linePoint2, foundIndices);
+  CHECK_INT(foundIndices->GetNumberOfIds(), 0);
+  locator->FindPointsWithinRadiusOfLine(8.0, linePoint1, linePoint2, foundIndices);
+  CHECK_INT(foundIndices->GetNumberOfIds(), 2);
+  CHECK_INT(foundIndices->GetId(0), 20);
+  CHECK_INT(foundIndices->GetId(1), 21);
+  // Line segment that ends before reaching the points
+  linePoint2[2] = -20.0;
+  locator->FindPointsWithinRadiusOfLine(8.0, linePoint1, linePoint2, foundIndices);
+  CHECK_INT(foundIndices->GetNumberOfIds(), 0);
+  // Line along the points
+  double alongLinePoint1[3] = { -1000.0, 1.0, 0.0 };
+  double alongLinePoint2[3] = { 2000.0, 1.0, 0.0 };
+  locator->FindPointsWithinRadiusOfLine(2.0, alongLinePoint1, alongLinePoint2, foundIndices);
+  CHECK_INT(foundIndices->GetNumberOfIds(), 100);
+
+  // Locator is rebuilt after initialization
+  locator->Initialize();
+  CHECK_INT(locator->GetNumberOfPoints(), 0);
+  locator->AddPoint(7, origin);
+  locator->FindPointsWithinRadius(1.0, origin, foundIndices);
+  CHECK_INT(foundIndices->GetNumberOfIds(), 1);
+  CHECK_INT(foundIndices->GetId(0), 7);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+void SetMousePosition(vtkMRMLInteractionEventData* eventData, vtkMRMLSliceNode* sliceNode, const double displayPosition[2])
+{
+  int displayPositionInt[2] = { static_cast<int>(std::round(displayPosition[0])), static_cast<int>(std::round(displayPosition[1])) };
+  eventData->SetDisplayPosition(displayPositionInt);
+  double xyz[4] = { static_cast<double>(displayPositionInt[0]), static_cast<double>(displayPositionInt[1]), 0.0, 1.0 };
+  double ras[4] = { 0.0, 0.0, 0.0, 1.0 };
+  sliceNode->GetXYToRAS()->MultiplyPoint(xyz, ras);
+  eventData->SetWorldPosition(ras);
+}
+
+//----------------------------------------------------------------------------
+int TestMouseMove(int numberOfControlPoints, double& meanLatencySec, double& maxLatencySec)
+{
+  vtkNew<vtkMRMLScene> scene;
+
+  vtkNew<vtkMRMLSliceNode> sliceNode;
+  sliceNode->SetLayoutName("Red");
+  scene->AddNode(sliceNode);
+  sliceNode->SetDimensions(VIEW_SIZE_PIXEL, VIEW_SIZE_PIXEL, 1);
+  sliceNode->SetFieldOfView(VIEW_SIZE_PIXEL, VIEW_SIZE_PIXEL, 1.0); // 1 mm per pixel
+
+  // Control points on the slice plane, most of them are outside the view
+  vtkNew<vtkMRMLMarkupsFiducialNode> markupsNode;
+  scene->AddNode(markupsNode);
+  markupsNode->CreateDefaultDisplayNodes();
+  vtkMRMLMarkupsDisplayNode* displayNode = vtkMRMLMarkupsDisplayNode::SafeDownCast(markupsNode->GetDisplayNode());
+  CHECK_NOT_NULL(displayNode);
+  displayNode->SetUseGlyphScale(false);
+  displayNode->SetGlyphSize(5.0);
+  int gridSize = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(numberOfControlPoints))));
+  vtkNew<vtkPoints> points;
+  for (int i = 0; i < numberOfControlPoints; ++i)
+  {
+    points->InsertNextPoint((i % gridSize - gridSize / 2) * GRID_SPACING_MM, (i / gridSize - gridSize / 2) * GRID_SPACING_MM, 0.0);
+  }
+  markupsNode->SetControlPointPositionsWorld(points);
+  CHECK_INT(markupsNode->GetNumberOfControlPoints(), numberOfControlPoints);
+
+  vtkNew<vtkRenderer> renderer;
+  vtkNew<vtkRenderWindow> renderWindow;
+  renderWindow->SetSize(VIEW_SIZE_PIXEL, VIEW_SIZE_PIXEL);
+  renderWindow->AddRenderer(renderer);
+
+  vtkNew<vtkSlicerPointsWidget> widget;
+  widget->CreateDefaultRepresentation(displayNode, sliceNode, renderer);
+  vtkSlicerMarkupsWidgetRepresentation* rep = vtkSlicerMarkupsWidgetRepresentation::SafeDownCast(widget->GetRepresentation());
+  CHECK_NOT_NULL(rep);
+
+  vtkNew<vtkMRMLInteractionEventData> eventData;
+  eventData->SetType(vtkCommand::MouseMoveEvent);
+  eventData->SetRenderer(renderer);
+  eventData->SetViewNode(sliceNode);
+
+  // Mouse is moved over each control point that is in the view and then to a position between control points
+  int numberOfTestedControlPoints = 0;
+  for (int i = 0; i < numberOfControlPoints; ++i)
+  {
+    double controlPointDisplayPosition[2] = { 0.0, 0.0 };
+    rep->GetNthControlPointDisplayPosition(i, controlPointDisplayPosition);
+    if (controlPointDisplayPosition[0] < 0 || controlPointDisplayPosition[0] >= VIEW_SIZE_PIXEL //
+        || controlPointDisplayPosition[1] < 0 || controlPointDisplayPosition[1] >= VIEW_SIZE_PIXEL)
+    {
+      continue;
+    }
+    numberOfTestedControlPoints++;
+    double distance2 = 0.0;
+    SetMousePosition(eventData, sliceNode, controlPointDisplayPosition);
+    CHECK_BOOL(widget->CanProcessInteractionEvent(eventData, distance2), true);
+    CHECK_BOOL(widget->ProcessInteractionEvent(eventData), true);
+    CHECK_INT(displayNode->GetActiveComponentType(), vtkMRMLMarkupsDisplayNode::ComponentControlPoint);
+    CHECK_INT(displayNode->GetActiveComponentIndex(), i);
+
+    double betweenControlPointsDisplayPosition[2] = { controlPointDisplayPosition[0] + GRID_SPACING_MM / 2.0, controlPointDisplayPosition[1] + GRID_SPACING_MM / 2.0 };
+    SetMousePosition(eventData, sliceNode, betweenControlPointsDisplayPosition);
+    CHECK_BOOL(widget->CanProcessInteractionEvent(eventData, distance2), false);
+  }
+  CHECK_BOOL(numberOfTestedControlPoints > 0, true);
+
+  // Measure latency of mouse move events that sweep through the view
+  vtkNew<vtkTimerLog> timer;
+  double totalLatencySec = 0.0;
+  maxLatencySec = 0.0;
+  for (int eventIndex = 0; eventIndex < NUMBER_OF_MOUSE_MOVE_EVENTS; ++eventIndex)
+  {
+    double t = static_cast<double>(eventIndex) / NUMBER_OF_MOUSE_MOVE_EVENTS;
+    double mouseDisplayPosition[2] = { t * VIEW_SIZE_PIXEL, (0.5 + 0.4 * std::sin(t * 20.0)) * VIEW_SIZE_PIXEL };
+    SetMousePosition(eventData, sliceNode, mouseDisplayPosition);
+    timer->StartTimer();
+    double distance2 = 0.0;
+    if (widget->CanProcessInteractionEvent(eventData, distance2))
+    {
+      widget->ProcessInteractionEvent(eventData);
+    }
+    timer->StopTimer();
+    totalLatencySec += timer->GetElapsedTime();
+    maxLatencySec = std::max(maxLatencySec, timer->GetElapsedTime());
+  }
+  meanLatencySec = totalLatencySec / NUMBER_OF_MOUSE_MOVE_EVENTS;
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+void SetMousePosition3D(vtkMRMLInteractionEventData* eventData, vtkRenderer* renderer, const double displayPosition[2])
+{
+  int displayPositionInt[2] = { static_cast<int>(std::round(displayPosition[0])), static_cast<int>(std::round(displayPosition[1])) };
+  eventData->SetDisplayPosition(displayPositionInt);
+  // World position at the depth of the focal point
+  double focalPoint[4] = { 0.0, 0.0, 0.0, 1.0 };
+  renderer->GetActiveCamera()->GetFocalPoint(focalPoint);
+  renderer->SetWorldPoint(focalPoint);
+  renderer->WorldToDisplay();
+  double focalPointDisplay[3] = { 0.0, 0.0, 0.0 };
+  renderer->GetDisplayPoint(focalPointDisplay);
+  renderer->SetDisplayPoint(displayPositionInt[0], displayPositionInt[1], focalPointDisplay[2]);
+  renderer->DisplayToWorld();
+  eventData->SetWorldPosition(renderer->GetWorldPoint());
+}
+
+//----------------------------------------------------------------------------
+// Move the mouse over each control point that is in the 3D view and then to a position between control points.
+int TestPickingInView3D(vtkSlicerPointsWidget* widget,
+                        vtkMRMLInteractionEventData* eventData,
+                        vtkRenderer* renderer,
+                        vtkMRMLMarkupsDisplayNode* displayNode,
+                        int numberOfControlPoints,
+                        double pixelsPerGridSpacing)
+{
+  vtkSlicerMarkupsWidgetRepresentation* rep = vtkSlicerMarkupsWidgetRepresentation::SafeDownCast(widget->GetRepresentation());
+  int numberOfTestedControlPoints = 0;
+  for (int i = 0; i < numberOfControlPoints; ++i)
+  {
+    double controlPointDisplayPosition[2] = { 0.0, 0.0 };
+    rep->GetNthControlPointDisplayPosition(i, controlPointDisplayPosition);
+    if (controlPointDisplayPosition[0] < 0 || controlPointDisplayPosition[0] >= VIEW_SIZE_PIXEL //
+        || controlPointDisplayPosition[1] < 0 || controlPointDisplayPosition[1] >= VIEW_SIZE_PIXEL)
+    {
+      continue;
+    }
+    numberOfTestedControlPoints++;
+    double distance2 = 0.0;
+    SetMousePosition3D(eventData, renderer, controlPointDisplayPosition);
+    CHECK_BOOL(widget->CanProcessInteractionEvent(eventData, distance2), true);
+    CHECK_BOOL(widget->ProcessInteractionEvent(eventData), true);
+    CHECK_INT(displayNode->GetActiveComponentType(), vtkMRMLMarkupsDisplayNode::ComponentControlPoint);
+    CHECK_INT(displayNode->GetActiveComponentIndex(), i);
+
+    double betweenControlPointsDisplayPosition[2] = { controlPointDisplayPosition[0] + pixelsPerGridSpacing / 2.0, controlPointDisplayPosition[1] + pixelsPerGridSpacing / 2.0 };
+    SetMousePosition3D(eventData, renderer, betweenControlPointsDisplayPosition);
+    CHECK_BOOL(widget->CanProcessInteractionEvent(eventData, distance2), false);
+  }
+  CHECK_BOOL(numberOfTestedControlPoints > 0, true);
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestMouseMove3D(int numberOfControlPoints, double& meanLatencySec, double& maxLatencySec)
+{
+  vtkNew<vtkMRMLScene> scene;
+
+  vtkNew<vtkMRMLViewNode> viewNode;
+  viewNode->SetLayoutName("1");
+  scene->AddNode(viewNode);
+
+  // Control points on the z = 0 plane, most of them are outside the view
+  vtkNew<vtkMRMLMarkupsFiducialNode> markupsNode;
+  scene->AddNode(markupsNode);
+  markupsNode->CreateDefaultDisplayNodes();
+  vtkMRMLMarkupsDisplayNode* displayNode = vtkMRMLMarkupsDisplayNode::SafeDownCast(markupsNode->GetDisplayNode());
+  CHECK_NOT_NULL(displayNode);
+  displayNode->SetUseGlyphScale(false);
+  displayNode->SetGlyphSize(5.0);
+  // Occluded points are pickable, therefore the test does not depend on the rendered z buffer
+  displayNode->SetOccludedVisibility(true);
+  displayNode->SetOccludedOpacity(1.0);
+  int gridSize = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(numberOfControlPoints))));
+  vtkNew<vtkPoints> points;
+  for (int i = 0; i < numberOfControlPoints; ++i)
+  {
+    points->InsertNextPoint((i % gridSize - gridSize / 2) * GRID_SPACING_MM, (i / gridSize - gridSize / 2) * GRID_SPACING_MM, 0.0);
+  }
+  markupsNode->SetControlPointPositionsWorld(points);
+  CHECK_INT(markupsNode->GetNumberOfControlPoints(), numberOfControlPoints);
+
+  vtkNew<vtkRenderer> renderer;
+  vtkNew<vtkRenderWindow> renderWindow;
+  renderWindow->SetSize(VIEW_SIZE_PIXEL, VIEW_SIZE_PIXEL);
+  renderWindow->AddRenderer(renderer);
+
+  // Perspective camera looking at the z = 0 plane, 1 mm per pixel at the focal point
+  vtkCamera* camera = renderer->GetActiveCamera();
+  camera->SetViewAngle(30.0);
+  double cameraDistance = VIEW_SIZE_PIXEL / 2.0 / std::tan(vtkMath::RadiansFromDegrees(15.0));
+  camera->SetFocalPoint(0.0, 0.0, 0.0);
+  camera->SetPosition(0.0, 0.0, cameraDistance);
+  camera->SetViewUp(0.0, 1.0, 0.0);
+  camera->SetClippingRange(cameraDistance / 10.0, cameraDistance * 10.0);
+
+  vtkNew<vtkSlicerPointsWidget> widget;
+  widget->CreateDefaultRepresentation(displayNode, viewNode, renderer);
+  CHECK_NOT_NULL(vtkSlicerMarkupsWidgetRepresentation::SafeDownCast(widget->GetRepresentation()));
+
+  vtkNew<vtkMRMLInteractionEventData> eventData;
+  eventData->SetType(vtkCommand::MouseMoveEvent);
+  eventData->SetRenderer(renderer);
+  eventData->SetViewNode(viewNode);
+
+  CHECK_EXIT_SUCCESS(TestPickingInView3D(widget, eventData, renderer, displayNode, numberOfControlPoints, GRID_SPACING_MM));
+
+  // Control points are still found after the camera is moved, and when they are farther from the camera
+  camera->SetFocalPoint(GRID_SPACING_MM * 1.5, GRID_SPACING_MM * 0.5, 0.0);
+  camera->SetPosition(GRID_SPACING_MM * 1.5, GRID_SPACING_MM * 0.5, cameraDistance * 2.0);
+  CHECK_EXIT_SUCCESS(TestPickingInView3D(widget, eventData, renderer, displayNode, numberOfControlPoints, GRID_SPACING_MM / 2.0));
+
+  // Measure latency of mouse move events that sweep through the view while the camera is rotating
+  vtkNew<vtkTimerLog> timer;
+  double totalLatencySec = 0.0;
+  maxLatencySec = 0.0;
+  for (int eventIndex = 0; eventIndex < NUMBER_OF_MOUSE_MOVE_EVENTS; ++eventIndex)
+  {
+    camera->Azimuth(0.01);
+    double t = static_cast<double>(eventIndex) / NUMBER_OF_MOUSE_MOVE_EVENTS;
+    double mouseDisplayPosition[2] = { t * VIEW_SIZE_PIXEL, (0.5 + 0.4 * std::sin(t * 20.0)) * VIEW_SIZE_PIXEL };
+    SetMousePosition3D(eventData, renderer, mouseDisplayPosition);
+    timer->StartTimer();
+    double distance2 = 0.0;
+    if (widget->CanProcessInteractionEvent(eventData, distance2))
+    {
+      widget->ProcessInteractionEvent(eventData);
+    }
+    timer->StopTimer();
+    totalLatencySec += timer->GetElapsedTime();
+    maxLatencySec = std::max(maxLatencySec, timer->GetElapsedTime());
+  }
+  meanLatencySec = totalLatencySec / NUMBER_OF_MOUSE_MOVE_EVENTS;
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkSlicerMarkupsWidgetPickingTest1(int, char*[])
+{
+  CHECK_EXIT_SUCCESS(TestLocator());
+
+  const int numberOfControlPoints[] = { 1000, 10000, 100000 };
+  for (int n : numberOfControlPoints)
+  {
+    double meanLatencySec = 0.0;
+    double maxLatencySec = 0.0;
+    CHECK_EXIT_SUCCESS(TestMouseMove(n, meanLatencySec, maxLatencySec));
+    std::cout << n << " control points: mean mouse move latency = " << meanLatencySec * 1000.0 << " ms"
+              << ", max mouse move latency = " << maxLatencySec * 1000.0 << " ms" << std::endl;
+
+    CHECK_EXIT_SUCCESS(TestMouseMove3D(n, meanLatencySec, maxLatencySec));
+    std::cout << n << " control points in 3D view: mean mouse move latency = " << meanLatencySec * 1000.0 << " ms"
+              << ", max mouse move latency = " << maxLatencySec * 1000.0 << " ms" << std::endl;
+  }
+
+  return EXIT_SUCCESS;
+}
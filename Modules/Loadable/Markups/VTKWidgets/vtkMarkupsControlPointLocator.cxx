@@ -0,0 +1,260 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "vtkMarkupsControlPointLocator.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
+#include <vtkLine.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkStaticCellLocator.h>
+#include <vtkStaticPointLocator.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+vtkStandardNewMacro(vtkMarkupsControlPointLocator);
+
+//----------------------------------------------------------------------
+vtkMarkupsControlPointLocator::vtkMarkupsControlPointLocator()
+{
+  this->Points = vtkSmartPointer<vtkPolyData>::New();
+  this->PointIndices = vtkSmartPointer<vtkIdTypeArray>::New();
+  this->PointLocator = vtkSmartPointer<vtkStaticPointLocator>::New();
+  this->PointLocator->SetDataSet(this->Points);
+
+  this->Segments = vtkSmartPointer<vtkPolyData>::New();
+  this->SegmentIndices = vtkSmartPointer<vtkIdTypeArray>::New();
+  this->SegmentLocator = vtkSmartPointer<vtkStaticCellLocator>::New();
+  this->SegmentLocator->SetDataSet(this->Segments);
+
+  this->Initialize();
+}
+
+//----------------------------------------------------------------------
+vtkMarkupsControlPointLocator::~vtkMarkupsControlPointLocator() = default;
+
+//----------------------------------------------------------------------
+void vtkMarkupsControlPointLocator::Initialize()
+{
+  this->Points->Initialize();
+  vtkNew<vtkPoints> points;
+  this->Points->SetPoints(points);
+  this->PointIndices->Initialize();
+
+  this->Segments->Initialize();
+  vtkNew<vtkPoints> segmentPoints;
+  this->Segments->SetPoints(segmentPoints);
+  vtkNew<vtkCellArray> lines;
+  this->Segments->SetLines(lines);
+  this->SegmentIndices->Initialize();
+
+  this->Modified();
+}
+
+//----------------------------------------------------------------------
+void vtkMarkupsControlPointLocator::AddPoint(vtkIdType controlPointIndex, const double position[3])
+{
+  this->Points->GetPoints()->InsertNextPoint(position);
+  this->Points->Modified();
+  this->PointIndices->InsertNextValue(controlPointIndex);
+}
+
+//----------------------------------------------------------------------
+void vtkMarkupsControlPointLocator::AddSegment(vtkIdType segmentIndex, const double position1[3], const double position2[3])
+{
+  vtkPoints* points = this->Segments->GetPoints();
+  vtkIdType pointIds[2] = { points->InsertNextPoint(position1), points->InsertNextPoint(position2) };
+  this->Segments->GetLines()->InsertNextCell(2, pointIds);
+  // cell links must be rebuilt before the locator can access the new cell
+  this->Segments->DeleteCells();
+  this->Segments->Modified();
+  this->SegmentIndices->InsertNextValue(segmentIndex);
+}
+
+//----------------------------------------------------------------------
+vtkIdType vtkMarkupsControlPointLocator::GetNumberOfPoints()
+{
+  return this->PointIndices->GetNumberOfValues();
+}
+
+//----------------------------------------------------------------------
+vtkIdType vtkMarkupsControlPointLocator::GetNumberOfSegments()
+{
+  return this->SegmentIndices->GetNumberOfValues();
+}
+
+//----------------------------------------------------------------------
+void vtkMarkupsControlPointLocator::FindPointsWithinRadius(double radius, const double position[3], vtkIdList* controlPointIndices)
+{
+  if (!controlPointIndices)
+  {
+    return;
+  }
+  controlPointIndices->Reset();
+  if (this->GetNumberOfPoints() < 1)
+  {
+    return;
+  }
+  // The locator is only rebuilt if the points have changed since the last build
+  this->PointLocator->Update();
+  this->PointLocator->FindPointsWithinRadius(radius, position, controlPointIndices);
+  vtkIdType numberOfFoundPoints = controlPointIndices->GetNumberOfIds();
+  for (vtkIdType i = 0; i < numberOfFoundPoints; ++i)
+  {
+    controlPointIndices->SetId(i, this->PointIndices->GetValue(controlPointIndices->GetId(i)));
+  }
+  controlPointIndices->Sort();
+}
+
+//----------------------------------------------------------------------
+void vtkMarkupsControlPointLocator::GetPointBounds(double bounds[6])
+{
+  if (this->GetNumberOfPoints() < 1)
+  {
+    vtkMath::UninitializeBounds(bounds);
+    return;
+  }
+  // vtkPoints only recomputes the bounds if the points have changed
+  this->Points->GetPoints()->GetBounds(bounds);
+}
+
+//----------------------------------------------------------------------
+void vtkMarkupsControlPointLocator::FindPointsWithinRadiusOfLine(double radius, const double linePoint1[3], const double linePoint2[3], vtkIdList* controlPointIndices)
+{
+  if (!controlPointIndices)
+  {
+    return;
+  }
+  controlPointIndices->Reset();
+  if (this->GetNumberOfPoints() < 1)
+  {
+    return;
+  }
+
+  // Clip the line to the bounding box of the points, expanded by the radius
+  double bounds[6] = { 0.0, -1.0, 0.0, -1.0, 0.0, -1.0 };
+  this->GetPointBounds(bounds);
+  double lineDirection[3] = { linePoint2[0] - linePoint1[0], linePoint2[1] - linePoint1[1], linePoint2[2] - linePoint1[2] };
+  double tMin = 0.0;
+  double tMax = 1.0;
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    double boundMin = bounds[axis * 2] - radius;
+    double boundMax = bounds[axis * 2 + 1] + radius;
+    if (lineDirection[axis] == 0.0)
+    {
+      if (linePoint1[axis] < boundMin || linePoint1[axis] > boundMax)
+      {
+        return;
+      }
+      continue;
+    }
+    double t1 = (boundMin - linePoint1[axis]) / lineDirection[axis];
+    double t2 = (boundMax - linePoint1[axis]) / lineDirection[axis];
+    tMin = std::max(tMin, std::min(t1, t2));
+    tMax = std::min(tMax, std::max(t1, t2));
+    if (tMin > tMax)
+    {
+      return;
+    }
+  }
+
+  // Points are found by querying spheres along the clipped line. The number of queries is limited,
+  // therefore the spheres may be larger than the radius, but the farther points are removed
+  // by the exact distance check below.
+  const int maximumNumberOfSteps = 100;
+  double clippedLineLength = (tMax - tMin) * vtkMath::Norm(lineDirection);
+  int numberOfSteps = maximumNumberOfSteps;
+  if (radius > 0.0 && clippedLineLength / radius < maximumNumberOfSteps)
+  {
+    numberOfSteps = std::max(1, static_cast<int>(std::ceil(clippedLineLength / radius)));
+  }
+  double stepLength = clippedLineLength / numberOfSteps;
+
+  // The locator is only rebuilt if the points have changed since the last build
+  this->PointLocator->Update();
+  std::vector<vtkIdType> foundPointIds;
+  vtkNew<vtkIdList> stepPointIds;
+  for (int step = 0; step < numberOfSteps; ++step)
+  {
+    double t = tMin + (tMax - tMin) * (step + 0.5) / numberOfSteps;
+    double stepCenter[3] = { linePoint1[0] + t * lineDirection[0], linePoint1[1] + t * lineDirection[1], linePoint1[2] + t * lineDirection[2] };
+    this->PointLocator->FindPointsWithinRadius(radius + stepLength / 2.0, stepCenter, stepPointIds);
+    foundPointIds.insert(foundPointIds.end(), stepPointIds->begin(), stepPointIds->end());
+  }
+  std::sort(foundPointIds.begin(), foundPointIds.end());
+  foundPointIds.erase(std::unique(foundPointIds.begin(), foundPointIds.end()), foundPointIds.end());
+
+  double radius2 = radius * radius;
+  for (vtkIdType pointId : foundPointIds)
+  {
+    double position[3] = { 0.0, 0.0, 0.0 };
+    this->Points->GetPoint(pointId, position);
+    double t = 0.0;
+    double closestPoint[3] = { 0.0, 0.0, 0.0 };
+    if (vtkLine::DistanceToLine(position, linePoint1, linePoint2, t, closestPoint) <= radius2)
+    {
+      controlPointIndices->InsertNextId(this->PointIndices->GetValue(pointId));
+    }
+  }
+  controlPointIndices->Sort();
+}
+
+//----------------------------------------------------------------------
+void vtkMarkupsControlPointLocator::FindSegmentsWithinRadius(double radius, const double position[3], vtkIdList* segmentIndices)
+{
+  if (!segmentIndices)
+  {
+    return;
+  }
+  segmentIndices->Reset();
+  if (this->GetNumberOfSegments() < 1)
+  {
+    return;
+  }
+  // The locator is only rebuilt if the segments have changed since the last build
+  this->SegmentLocator->Update();
+  double bounds[6] = {
+    position[0] - radius, position[0] + radius, //
+    position[1] - radius, position[1] + radius, //
+    position[2] - radius, position[2] + radius  //
+  };
+  this->SegmentLocator->FindCellsWithinBounds(bounds, segmentIndices);
+  vtkIdType numberOfFoundSegments = segmentIndices->GetNumberOfIds();
+  for (vtkIdType i = 0; i < numberOfFoundSegments; ++i)
+  {
+    segmentIndices->SetId(i, this->SegmentIndices->GetValue(segmentIndices->GetId(i)));
+  }
+  segmentIndices->Sort();
+}
+
+//----------------------------------------------------------------------
+void vtkMarkupsControlPointLocator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfPoints: " << this->GetNumberOfPoints() << "\n";
+  os << indent << "NumberOfSegments: " << this->GetNumberOfSegments() << "\n";
+}
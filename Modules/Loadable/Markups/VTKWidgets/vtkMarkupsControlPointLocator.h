@@ -0,0 +1,103 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+/**
+ * @class   vtkMarkupsControlPointLocator
+ * @brief   Spatial index of markups control points and line segments for fast picking.
+ *
+ * Markups widget representations use this class to find the control points and line
+ * segments that are near the mouse position without iterating through all of them.
+ * Positions are stored in the coordinate system where the picking distance is computed
+ * (display coordinates in slice views, display or world coordinates in 3D views).
+ *
+ * Queries only return candidates (all items that are within the specified radius),
+ * the caller is responsible for computing exact distances and applying additional
+ * criteria (visibility, per-point tolerance, etc.) on them.
+ * The uniform-grid locators are built lazily, on the first query after positions are changed.
+ */
+
+#ifndef vtkMarkupsControlPointLocator_h
+#define vtkMarkupsControlPointLocator_h
+
+#include "vtkSlicerMarkupsModuleVTKWidgetsExport.h"
+
+// VTK includes
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+
+class vtkIdList;
+class vtkIdTypeArray;
+class vtkPolyData;
+class vtkStaticCellLocator;
+class vtkStaticPointLocator;
+
+class VTK_SLICER_MARKUPS_MODULE_VTKWIDGETS_EXPORT vtkMarkupsControlPointLocator : public vtkObject
+{
+public:
+  static vtkMarkupsControlPointLocator* New();
+  vtkTypeMacro(vtkMarkupsControlPointLocator, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Remove all points and segments.
+  void Initialize();
+
+  /// Add a point. The control point index is returned by FindPointsWithinRadius.
+  void AddPoint(vtkIdType controlPointIndex, const double position[3]);
+
+  /// Add a line segment. The segment index (typically the index of the first control point
+  /// of the segment) is returned by FindSegmentsWithinRadius.
+  void AddSegment(vtkIdType segmentIndex, const double position1[3], const double position2[3]);
+
+  vtkIdType GetNumberOfPoints();
+  vtkIdType GetNumberOfSegments();
+
+  /// Get bounding box of all points. Bounds are invalid (min > max) if there are no points.
+  void GetPointBounds(double bounds[6]);
+
+  /// Get indices of all points that are within the specified distance from the position.
+  /// Indices are sorted in ascending order.
+  void FindPointsWithinRadius(double radius, const double position[3], vtkIdList* controlPointIndices);
+
+  /// Get indices of all points that are within the specified distance from the line segment.
+  /// It can be used for finding points near a picking ray in 3D views, without the need
+  /// to rebuild the locator when the camera is changed.
+  /// Indices are sorted in ascending order.
+  void FindPointsWithinRadiusOfLine(double radius, const double linePoint1[3], const double linePoint2[3], vtkIdList* controlPointIndices);
+
+  /// Get indices of line segments that may be within the specified distance from the position.
+  /// All segments that are within the radius are returned, but some farther segments may be returned as well.
+  /// Indices are sorted in ascending order.
+  void FindSegmentsWithinRadius(double radius, const double position[3], vtkIdList* segmentIndices);
+
+protected:
+  vtkMarkupsControlPointLocator();
+  ~vtkMarkupsControlPointLocator() override;
+
+  vtkSmartPointer<vtkPolyData> Points;
+  vtkSmartPointer<vtkIdTypeArray> PointIndices;
+  vtkSmartPointer<vtkStaticPointLocator> PointLocator;
+
+  vtkSmartPointer<vtkPolyData> Segments;
+  vtkSmartPointer<vtkIdTypeArray> SegmentIndices;
+  vtkSmartPointer<vtkStaticCellLocator> SegmentLocator;
+
+private:
+  vtkMarkupsControlPointLocator(const vtkMarkupsControlPointLocator&) = delete;
+  void operator=(const vtkMarkupsControlPointLocator&) = delete;
+};
+
+#endif
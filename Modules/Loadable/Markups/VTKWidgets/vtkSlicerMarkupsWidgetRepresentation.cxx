@@ -396,6 +396,10 @@ vtkMRMLMarkupsNode* vtkSlicerMarkupsWidgetRepresentation::GetMarkupsNode()
 //----------------------------------------------------------------------
 void vtkSlicerMarkupsWidgetRepresentation::SetMarkupsNode(vtkMRMLMarkupsNode* markupsNode)
 {
+  if (this->MarkupsNode != markupsNode)
+  {
+    this->ControlPointsModifiedTime.Modified();
+  }
   this->MarkupsNode = markupsNode;
 }
 
@@ -501,6 +505,14 @@ void vtkSlicerMarkupsWidgetRepresentation::UpdateFromMRML(vtkMRMLNode* caller, u
 //----------------------------------------------------------------------
 void vtkSlicerMarkupsWidgetRepresentation::UpdateFromMRMLInternal(vtkMRMLNode* vtkNotUsed(caller), unsigned long event, void* vtkNotUsed(callData))
 {
+  if (!event || event == vtkMRMLTransformableNode::TransformModifiedEvent //
+      || event == vtkMRMLMarkupsNode::PointModifiedEvent                   //
+      || event == vtkMRMLMarkupsNode::PointAddedEvent                      //
+      || event == vtkMRMLMarkupsNode::PointRemovedEvent)
+  {
+    this->ControlPointsModifiedTime.Modified();
+  }
+
   if (!event || event == vtkMRMLTransformableNode::TransformModifiedEvent)
   {
     this->MarkupsTransformModifiedTime.Modified();
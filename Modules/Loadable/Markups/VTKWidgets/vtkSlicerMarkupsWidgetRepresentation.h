@@ -53,6 +53,7 @@
 #include "vtkArrowSource.h"
 #include "vtkGlyph3D.h"
 #include "vtkLookupTable.h"
+#include "vtkMarkupsControlPointLocator.h"
 #include "vtkMarkupsGlyphSource2D.h"
 #include "vtkPointPlacer.h"
 #include "vtkPointSetToLabelHierarchy.h"
@@ -217,6 +218,10 @@ protected:
 
   vtkTimeStamp MarkupsTransformModifiedTime;
 
+  // Time of the last change of control point positions (or transform of the markups node).
+  // Picking locators that are older than this are rebuilt before they are used.
+  vtkTimeStamp ControlPointsModifiedTime;
+
   double* GetWidgetColor(int controlPointType) VTK_SIZEHINT(3);
 
   ControlPointsPipeline* ControlPoints[NumberOfControlPointTypes]; // Unselected, Selected, Active, Project, ProjectBehind
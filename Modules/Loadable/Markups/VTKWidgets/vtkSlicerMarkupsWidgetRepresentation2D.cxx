@@ -21,6 +21,7 @@
 #include "vtkCellLocator.h"
 #include "vtkDiscretizableColorTransferFunction.h"
 #include "vtkGlyph2D.h"
+#include "vtkIdList.h"
 #include "vtkLabelPlacementMapper.h"
 #include "vtkLine.h"
 #include "vtkMarkupsGlyphSource2D.h"
@@ -48,6 +49,9 @@
 #include <vtkMRMLFolderDisplayNode.h>
 #include <vtkMRMLInteractionEventData.h>
 
+// STD includes
+#include <algorithm>
+
 vtkSlicerMarkupsWidgetRepresentation2D::ControlPointsPipeline2D::ControlPointsPipeline2D()
 {
   this->Glypher = vtkSmartPointer<vtkGlyph2D>::New();
@@ -126,6 +130,8 @@ vtkSlicerMarkupsWidgetRepresentation2D::vtkSlicerMarkupsWidgetRepresentation2D()
 
   this->SlicePlane = vtkSmartPointer<vtkPlane>::New();
   this->WorldToSliceTransform = vtkSmartPointer<vtkTransform>::New();
+
+  this->PickingLocator = vtkSmartPointer<vtkMarkupsControlPointLocator>::New();
 }
 
 //----------------------------------------------------------------------
@@ -536,15 +542,19 @@ void vtkSlicerMarkupsWidgetRepresentation2D::CanInteract(vtkMRMLInteractionEvent
     }
   }
 
-  vtkIdType numberOfPoints = markupsNode->GetNumberOfControlPoints();
+  // Only control points that are near the display position are checked
+  this->UpdatePickingLocator();
+  vtkNew<vtkIdList> candidatePointIndices;
+  this->PickingLocator->FindPointsWithinRadius(sqrt(maxPickingDistanceFromControlPoint2), displayPosition3, candidatePointIndices);
 
   double pointDisplayPos[4] = { 0.0, 0.0, 0.0, 1.0 };
   double pointWorldPos[4] = { 0.0, 0.0, 0.0, 1.0 };
 
   vtkNew<vtkMatrix4x4> rasToxyMatrix;
   sliceNode->GetXYToRAS()->Invert(sliceNode->GetXYToRAS(), rasToxyMatrix.GetPointer());
-  for (int i = 0; i < numberOfPoints; i++)
+  for (vtkIdType candidateIndex = 0; candidateIndex < candidatePointIndices->GetNumberOfIds(); candidateIndex++)
   {
+    int i = static_cast<int>(candidatePointIndices->GetId(candidateIndex));
     if (!this->GetNthControlPointViewVisibility(i))
     {
       continue;
@@ -585,7 +595,10 @@ void vtkSlicerMarkupsWidgetRepresentation2D::CanInteractWithLine(vtkMRMLInteract
   double displayPosition3[3] = { static_cast<double>(displayPosition[0]), static_cast<double>(displayPosition[1]), 0.0 };
   double maxPickingDistanceFromControlPoint2 = this->GetMaximumControlPointPickingDistance2();
 
-  vtkIdType numberOfPoints = markupsNode->GetNumberOfControlPoints();
+  // Only line segments that are near the display position are checked
+  this->UpdatePickingLocator();
+  vtkNew<vtkIdList> candidateSegmentIndices;
+  this->PickingLocator->FindSegmentsWithinRadius(sqrt(maxPickingDistanceFromControlPoint2), displayPosition3, candidateSegmentIndices);
 
   double pointDisplayPos1[4] = { 0.0, 0.0, 0.0, 1.0 };
   double pointWorldPos1[4] = { 0.0, 0.0, 0.0, 1.0 };
@@ -594,15 +607,11 @@ void vtkSlicerMarkupsWidgetRepresentation2D::CanInteractWithLine(vtkMRMLInteract
 
   vtkNew<vtkMatrix4x4> rasToxyMatrix;
   sliceNode->GetXYToRAS()->Invert(sliceNode->GetXYToRAS(), rasToxyMatrix.GetPointer());
-  for (int i = 0; i < numberOfPoints - 1; i++)
+  for (vtkIdType candidateIndex = 0; candidateIndex < candidateSegmentIndices->GetNumberOfIds(); candidateIndex++)
   {
-    if (!this->PointsVisibilityOnSlice->GetValue(i))
-    {
-      continue;
-    }
-    if (!this->PointsVisibilityOnSlice->GetValue(i + 1))
+    int i = static_cast<int>(candidateSegmentIndices->GetId(candidateIndex));
+    if (!this->PointsVisibilityOnSlice->GetValue(i) || !this->PointsVisibilityOnSlice->GetValue(i + 1))
     {
-      i++; // skip one more, as the next iteration would use (i+1)-th point
       continue;
     }
     markupsNode->GetNthControlPointPositionWorld(i, pointWorldPos1);
@@ -621,6 +630,50 @@ void vtkSlicerMarkupsWidgetRepresentation2D::CanInteractWithLine(vtkMRMLInteract
   }
 }
 
+//----------------------------------------------------------------------
+void vtkSlicerMarkupsWidgetRepresentation2D::UpdatePickingLocator()
+{
+  vtkMRMLSliceNode* sliceNode = this->GetSliceNode();
+  vtkMRMLMarkupsNode* markupsNode = this->GetMarkupsNode();
+  if (!sliceNode || !markupsNode || !this->MarkupsDisplayNode)
+  {
+    return;
+  }
+  bool sliceProjection = this->MarkupsDisplayNode->GetSliceProjection();
+  vtkMTimeType locatorTime = this->PickingLocator->GetMTime();
+  if (locatorTime > this->ControlPointsModifiedTime.GetMTime() && locatorTime > sliceNode->GetXYToRAS()->GetMTime() //
+      && sliceProjection == this->PickingLocatorSliceProjection)
+  {
+    // control points and slice view have not changed since the last update
+    return;
+  }
+
+  this->PickingLocator->Initialize();
+  this->PickingLocatorSliceProjection = sliceProjection;
+  vtkNew<vtkMatrix4x4> rasToxyMatrix;
+  sliceNode->GetXYToRAS()->Invert(sliceNode->GetXYToRAS(), rasToxyMatrix.GetPointer());
+  double pointWorldPos[4] = { 0.0, 0.0, 0.0, 1.0 };
+  double pointDisplayPos[4] = { 0.0, 0.0, 0.0, 1.0 };
+  double previousPointDisplayPos[4] = { 0.0, 0.0, 0.0, 1.0 };
+  int numberOfPoints = markupsNode->GetNumberOfControlPoints();
+  for (int i = 0; i < numberOfPoints; i++)
+  {
+    markupsNode->GetNthControlPointPositionWorld(i, pointWorldPos);
+    rasToxyMatrix->MultiplyPoint(pointWorldPos, pointDisplayPos);
+    if (i > 0)
+    {
+      this->PickingLocator->AddSegment(i - 1, previousPointDisplayPos, pointDisplayPos);
+    }
+    std::copy(pointDisplayPos, pointDisplayPos + 4, previousPointDisplayPos);
+    if (sliceProjection)
+    {
+      // projected control points can be picked at any distance from the slice (display position is at z = 0)
+      pointDisplayPos[2] = 0.0;
+    }
+    this->PickingLocator->AddPoint(i, pointDisplayPos);
+  }
+}
+
 //----------------------------------------------------------------------
 void vtkSlicerMarkupsWidgetRepresentation2D::GetActors(vtkPropCollection* pc)
 {
@@ -161,6 +161,15 @@ protected:
 
   double GetWidgetOpacity(int controlPointType);
 
+  /// Rebuild PickingLocator if control points or the slice view have changed since the last update.
+  void UpdatePickingLocator();
+
+  /// Control point and line segment positions in slice display coordinates,
+  /// used for quickly finding the components that are near the mouse position.
+  vtkSmartPointer<vtkMarkupsControlPointLocator> PickingLocator;
+  /// Slice projection mode when PickingLocator was last updated.
+  bool PickingLocatorSliceProjection{ false };
+
 private:
   vtkSlicerMarkupsWidgetRepresentation2D(const vtkSlicerMarkupsWidgetRepresentation2D&) = delete;
   void operator=(const vtkSlicerMarkupsWidgetRepresentation2D&) = delete;
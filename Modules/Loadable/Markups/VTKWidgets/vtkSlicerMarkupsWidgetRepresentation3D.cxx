@@ -24,6 +24,7 @@
 #include "vtkLine.h"
 #include "vtkFloatArray.h"
 #include "vtkGlyph3DMapper.h"
+#include "vtkIdList.h"
 #include "vtkMarkupsGlyphSource2D.h"
 #include "vtkMath.h"
 #include "vtkMatrix4x4.h"
@@ -50,6 +51,9 @@
 #include <vtkMRMLInteractionEventData.h>
 #include <vtkMRMLViewNode.h>
 
+// STD includes
+#include <algorithm>
+
 std::map<vtkRenderer*, vtkSmartPointer<vtkFloatArray>> vtkSlicerMarkupsWidgetRepresentation3D::CachedZBuffers;
 
 vtkSlicerMarkupsWidgetRepresentation3D::ControlPointsPipeline3D::ControlPointsPipeline3D()
@@ -212,6 +216,8 @@ vtkSlicerMarkupsWidgetRepresentation3D::vtkSlicerMarkupsWidgetRepresentation3D()
   this->RenderCompletedCallback = vtkSmartPointer<vtkCallbackCommand>::New();
   this->RenderCompletedCallback->SetClientData(this);
   this->RenderCompletedCallback->SetCallback(vtkSlicerMarkupsWidgetRepresentation3D::OnRenderCompleted);
+
+  this->WorldPickingLocator = vtkSmartPointer<vtkMarkupsControlPointLocator>::New();
 }
 
 //----------------------------------------------------------------------
@@ -415,9 +421,22 @@ void vtkSlicerMarkupsWidgetRepresentation3D::CanInteract(vtkMRMLInteractionEvent
     }
   }
 
-  vtkIdType numberOfPoints = markupsNode->GetNumberOfControlPoints();
-  for (int i = 0; i < numberOfPoints; i++)
+  // Only control points that are near the interaction position are checked
+  vtkNew<vtkIdList> candidatePointIndices;
+  this->UpdateWorldPickingLocator();
+  if (interactionEventData->IsDisplayPositionValid())
+  {
+    this->FindControlPointsNearDisplayPosition(displayPosition3, interactionEventData, candidatePointIndices);
+  }
+  else
   {
+    double worldTolerance = this->ControlPointSize / 2.0 + this->PickingTolerance / interactionEventData->GetWorldToPhysicalScale();
+    this->WorldPickingLocator->FindPointsWithinRadius(worldTolerance, interactionEventData->GetWorldPosition(), candidatePointIndices);
+  }
+
+  for (vtkIdType candidateIndex = 0; candidateIndex < candidatePointIndices->GetNumberOfIds(); candidateIndex++)
+  {
+    int i = static_cast<int>(candidatePointIndices->GetId(candidateIndex));
     if (!(markupsNode->GetNthControlPointPositionVisibility(i) && markupsNode->GetNthControlPointVisibility(i)))
     {
       continue;
@@ -493,22 +512,6 @@ void vtkSlicerMarkupsWidgetRepresentation3D::CanInteract(vtkMRMLInteractionEvent
       }
     }
   }
-
-  /* This would probably faster for many points:
-
-  this->BuildLocator();
-
-  double closestDistance2 = VTK_DOUBLE_MAX;
-  int closestNode = static_cast<int> (this->Locator->FindClosestPointWithinRadius(
-    this->PixelTolerance, displayPos, closestDistance2));
-
-  if (closestNode != this->GetActiveNode())
-    {
-    this->SetActiveNode(closestNode);
-    this->NeedToRender = 1;
-    }
-  return (this->GetActiveNode() >= 0);
-  */
 }
 
 //----------------------------------------------------------------------
@@ -525,15 +528,19 @@ void vtkSlicerMarkupsWidgetRepresentation3D::CanInteractWithLine(vtkMRMLInteract
     return;
   }
 
-  vtkIdType numberOfPoints = markupsNode->GetNumberOfControlPoints();
-
   double pointWorldPos1[4] = { 0.0, 0.0, 0.0, 1.0 };
   double pointWorldPos2[4] = { 0.0, 0.0, 0.0, 1.0 };
 
   double toleranceWorld = this->ControlPointSize * this->ControlPointSize;
 
-  for (int i = 0; i < numberOfPoints - 1; i++)
+  // Only line segments that are near the interaction position are checked
+  this->UpdateWorldPickingLocator();
+  vtkNew<vtkIdList> candidateSegmentIndices;
+  this->WorldPickingLocator->FindSegmentsWithinRadius(this->ControlPointSize, interactionEventData->GetWorldPosition(), candidateSegmentIndices);
+
+  for (vtkIdType candidateIndex = 0; candidateIndex < candidateSegmentIndices->GetNumberOfIds(); candidateIndex++)
   {
+    int i = static_cast<int>(candidateSegmentIndices->GetId(candidateIndex));
     markupsNode->GetNthControlPointPositionWorld(i, pointWorldPos1);
     markupsNode->GetNthControlPointPositionWorld(i + 1, pointWorldPos2);
 
@@ -549,6 +556,80 @@ void vtkSlicerMarkupsWidgetRepresentation3D::CanInteractWithLine(vtkMRMLInteract
   }
 }
 
+//----------------------------------------------------------------------
+void vtkSlicerMarkupsWidgetRepresentation3D::FindControlPointsNearDisplayPosition(const double displayPosition[2],
+                                                                                  vtkMRMLInteractionEventData* interactionEventData,
+                                                                                  vtkIdList* controlPointIndices)
+{
+  controlPointIndices->Reset();
+  if (!this->Renderer || !this->Renderer->GetActiveCamera() || this->WorldPickingLocator->GetNumberOfPoints() < 1)
+  {
+    return;
+  }
+
+  // Picking ray between the near and far clipping planes
+  double rayWorld[2][3] = { { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 } };
+  for (int rayEnd = 0; rayEnd < 2; ++rayEnd)
+  {
+    this->Renderer->SetDisplayPoint(displayPosition[0], displayPosition[1], static_cast<double>(rayEnd));
+    this->Renderer->DisplayToWorld();
+    double* rayEndWorld = this->Renderer->GetWorldPoint();
+    if (rayEndWorld[3] == 0.0)
+    {
+      return;
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+      rayWorld[rayEnd][i] = rayEndWorld[i] / rayEndWorld[3];
+    }
+  }
+
+  // A control point is picked if its display distance from the mouse position is less than the glyph radius plus the picking tolerance.
+  // In world coordinates, this is a distance from the ray of half control point size plus the picking tolerance scaled by
+  // the view scale factor at the control point. The view scale factor is the largest at the farthest corner of the bounding box.
+  double boundsWorld[6] = { 0.0, -1.0, 0.0, -1.0, 0.0, -1.0 };
+  this->WorldPickingLocator->GetPointBounds(boundsWorld);
+  double maximumViewScaleFactorMmPerPixel = 0.0;
+  for (int corner = 0; corner < 8; ++corner)
+  {
+    double cornerWorld[3] = { boundsWorld[corner & 1], boundsWorld[2 + ((corner >> 1) & 1)], boundsWorld[4 + ((corner >> 2) & 1)] };
+    maximumViewScaleFactorMmPerPixel =
+      std::max(maximumViewScaleFactorMmPerPixel, vtkMRMLAbstractThreeDViewDisplayableManager::GetViewScaleFactorAtPosition(this->Renderer, cornerWorld, interactionEventData));
+  }
+  double maximumToleranceWorld = this->ControlPointSize / 2.0 + this->PickingTolerance * this->GetScreenScaleFactor() * maximumViewScaleFactorMmPerPixel;
+  this->WorldPickingLocator->FindPointsWithinRadiusOfLine(maximumToleranceWorld, rayWorld[0], rayWorld[1], controlPointIndices);
+}
+
+//----------------------------------------------------------------------
+void vtkSlicerMarkupsWidgetRepresentation3D::UpdateWorldPickingLocator()
+{
+  vtkMRMLMarkupsNode* markupsNode = this->GetMarkupsNode();
+  if (!markupsNode)
+  {
+    return;
+  }
+  if (this->WorldPickingLocator->GetMTime() > this->ControlPointsModifiedTime.GetMTime())
+  {
+    // control points have not changed since the last update
+    return;
+  }
+
+  this->WorldPickingLocator->Initialize();
+  double pointWorldPos[3] = { 0.0, 0.0, 0.0 };
+  double previousPointWorldPos[3] = { 0.0, 0.0, 0.0 };
+  int numberOfPoints = markupsNode->GetNumberOfControlPoints();
+  for (int i = 0; i < numberOfPoints; i++)
+  {
+    markupsNode->GetNthControlPointPositionWorld(i, pointWorldPos);
+    this->WorldPickingLocator->AddPoint(i, pointWorldPos);
+    if (i > 0)
+    {
+      this->WorldPickingLocator->AddSegment(i - 1, previousPointWorldPos, pointWorldPos);
+    }
+    std::copy(pointWorldPos, pointWorldPos + 3, previousPointWorldPos);
+  }
+}
+
 //----------------------------------------------------------------------
 void vtkSlicerMarkupsWidgetRepresentation3D::UpdateFromMRMLInternal(vtkMRMLNode* caller, unsigned long event, void* callData /*=nullptr*/)
 {
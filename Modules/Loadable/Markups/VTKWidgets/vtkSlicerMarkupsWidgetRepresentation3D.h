@@ -37,6 +37,7 @@ class vtkActor2D;
 class vtkCellPicker;
 class vtkFastSelectVisiblePoints;
 class vtkGlyph3DMapper;
+class vtkIdList;
 class vtkLabelPlacementMapper;
 class vtkPolyDataMapper;
 class vtkProperty;
@@ -160,6 +161,17 @@ protected:
   static void OnRenderCompleted(vtkObject* caller, unsigned long event, void* clientData, void* callData);
   static vtkFloatArray* GetCachedZBuffer(vtkRenderer* renderer);
 
+  /// Rebuild WorldPickingLocator if control points have changed since the last update.
+  void UpdateWorldPickingLocator();
+  /// Get indices of control points that may be picked at the display position: points that are near
+  /// the picking ray. WorldPickingLocator must be up-to-date.
+  void FindControlPointsNearDisplayPosition(const double displayPosition[2], vtkMRMLInteractionEventData* interactionEventData, vtkIdList* controlPointIndices);
+
+  /// Control point and line segment positions in world coordinates, used for quickly finding
+  /// the components that are near the picking ray or a 3D position (e.g., in virtual reality).
+  /// Positions do not depend on the camera, therefore the locator is only rebuilt when control points change.
+  vtkSmartPointer<vtkMarkupsControlPointLocator> WorldPickingLocator;
+
 private:
   vtkSlicerMarkupsWidgetRepresentation3D(const vtkSlicerMarkupsWidgetRepresentation3D&) = delete;
   void operator=(const vtkSlicerMarkupsWidgetRepresentation3D&) = delete;
@@ -1,4 +1,7 @@
+import logging
+
 import qt
+import vtk
 
 import slicer
 
@@ -111,3 +114,47 @@ class AbstractScriptedSegmentEditorEffect:
         spinbox.singleStep = stepSize
         # number of decimals is set to be able to show the step size (e.g., stepSize = 0.01 => decimals = 2)
         spinbox.decimals = max(int(-math.floor(math.log10(stepSize))), 0)
+
+    #
+    # Utility functions for modifying multiple segments at once
+    #
+    def isEditMaskForAllSegmentsSupported(self):
+        # When editing is allowed only outside segments, each edited segment is exempt from the mask,
+        # therefore the mask is different for each segment.
+        maskMode = self.scriptedEffect.parameterSetNode().GetMaskMode()
+        return maskMode not in (slicer.vtkMRMLSegmentationNode.EditAllowedOutsideAllSegments,
+                                slicer.vtkMRMLSegmentationNode.EditAllowedOutsideVisibleSegments)
+
+    def applyMarginToAllSegments(self, segmentIDs, innerMarginMM, outerMarginMM):
+        # Grow, shrink, or hollow the segments at once, using a single distance transform.
+        # The edit mask is generated once for all segments. Returns True on success.
+        parameterSetNode = self.scriptedEffect.parameterSetNode()
+        segmentationNode = parameterSetNode.GetSegmentationNode()
+        maskMode = parameterSetNode.GetMaskMode()
+        intensityMask = parameterSetNode.GetSourceVolumeIntensityMask()
+        editMask = None
+        if maskMode != slicer.vtkMRMLSegmentationNode.EditAllowedEverywhere or intensityMask:
+            # non-zero where editing is not allowed
+            editMask = slicer.vtkOrientedImageData()
+            if not segmentationNode.GenerateEditMask(
+                    editMask, maskMode, self.scriptedEffect.referenceGeometryImage(), "", parameterSetNode.GetMaskSegmentID() or "",
+                    self.scriptedEffect.sourceVolumeImageData() if intensityMask else None,
+                    parameterSetNode.GetSourceVolumeIntensityMaskRange() if intensityMask else None):
+                # segments must not be modified without the mask
+                logging.error("Failed to create edit mask")
+                return False
+        return slicer.vtkSlicerSegmentationsModuleLogic.ApplyMarginToSegments(
+            segmentationNode, segmentIDs, innerMarginMM, outerMarginMM, self.scriptedEffect.referenceGeometryImage(),
+            editMask, self.segmentIDsToOverwrite())
+
+    def segmentIDsToOverwrite(self):
+        # Returns segments that may be overwritten by modified segments, according to the overwrite mode
+        parameterSetNode = self.scriptedEffect.parameterSetNode()
+        segmentationNode = parameterSetNode.GetSegmentationNode()
+        segmentIDs = vtk.vtkStringArray()
+        overwriteMode = parameterSetNode.GetOverwriteMode()
+        if overwriteMode == slicer.vtkMRMLSegmentEditorNode.OverwriteAllSegments:
+            segmentationNode.GetSegmentation().GetSegmentIDs(segmentIDs)
+        elif overwriteMode == slicer.vtkMRMLSegmentEditorNode.OverwriteVisibleSegments:
+            segmentationNode.GetDisplayNode().GetVisibleSegmentIDs(segmentIDs)
+        return segmentIDs
@@ -178,6 +178,18 @@ class SegmentEditorHollowEffect(AbstractScriptedSegmentEditorEffect):
         slicer.util.showStatusMessage(msg, timeoutMsec)
         slicer.app.processEvents()
 
+    def getShellMarginsMM(self, spacing):
+        # Returns inner and outer margin of the shell, for processing a single segment or all segments at once
+        shellMode = self.scriptedEffect.parameter("ShellMode")
+        shellThicknessMM = abs(self.scriptedEffect.doubleParameter("ShellThicknessMm"))
+        voxelDiameter = min(spacing)
+        if shellMode == MEDIAL_SURFACE:
+            return -0.5 * shellThicknessMM + 0.5 * voxelDiameter, 0.5 * shellThicknessMM
+        elif shellMode == INSIDE_SURFACE:
+            return 0.0 + 0.1 * voxelDiameter, shellThicknessMM + 0.1 * voxelDiameter  # Don't include the original border (0.0)
+        else:  # OUTSIDE_SURFACE
+            return -shellThicknessMM + voxelDiameter, 0.0
+
     def processHollowing(self):
         # Get modifier labelmap and parameters
         modifierLabelmap = self.scriptedEffect.defaultModifierLabelmap()
@@ -192,26 +204,15 @@ class SegmentEditorHollowEffect(AbstractScriptedSegmentEditorEffect):
         thresh.SetOutValue(labelValue)
         thresh.SetOutputScalarType(selectedSegmentLabelmap.GetScalarType())
 
-        shellMode = self.scriptedEffect.parameter("ShellMode")
-        shellThicknessMM = abs(self.scriptedEffect.doubleParameter("ShellThicknessMm"))
-
         import vtkITK
 
         margin = vtkITK.vtkITKImageMargin()
         margin.SetInputConnection(thresh.GetOutputPort())
         margin.CalculateMarginInMMOn()
 
-        spacing = selectedSegmentLabelmap.GetSpacing()
-        voxelDiameter = min(selectedSegmentLabelmap.GetSpacing())
-        if shellMode == MEDIAL_SURFACE:
-            margin.SetOuterMarginMM(0.5 * shellThicknessMM)
-            margin.SetInnerMarginMM(-0.5 * shellThicknessMM + 0.5 * voxelDiameter)
-        elif shellMode == INSIDE_SURFACE:
-            margin.SetOuterMarginMM(shellThicknessMM + 0.1 * voxelDiameter)
-            margin.SetInnerMarginMM(0.0 + 0.1 * voxelDiameter)  # Don't include the original border (0.0)
-        elif shellMode == OUTSIDE_SURFACE:
-            margin.SetOuterMarginMM(0.0)
-            margin.SetInnerMarginMM(-shellThicknessMM + voxelDiameter)
+        innerMarginMM, outerMarginMM = self.getShellMarginsMM(selectedSegmentLabelmap.GetSpacing())
+        margin.SetInnerMarginMM(innerMarginMM)
+        margin.SetOuterMarginMM(outerMarginMM)
 
         modifierLabelmap.DeepCopy(margin.GetOutput())
 
@@ -244,6 +245,12 @@ class SegmentEditorHollowEffect(AbstractScriptedSegmentEditorEffect):
                 if inputSegmentIDs.GetNumberOfValues() == 0:
                     logging.info("Hollow operation skipped: there are no visible segments.")
                     return
+                if self.isEditMaskForAllSegmentsSupported():
+                    # Process all segments at once, using a single distance transform
+                    innerMarginMM, outerMarginMM = self.getShellMarginsMM(self.scriptedEffect.referenceGeometryImage().GetSpacing())
+                    if not self.applyMarginToAllSegments(inputSegmentIDs, innerMarginMM, outerMarginMM):
+                        logging.error("Failed to apply hollowing")
+                    return
                 # select input segments one by one, process
                 for index in range(inputSegmentIDs.GetNumberOfValues()):
                     segmentID = inputSegmentIDs.GetValue(index)
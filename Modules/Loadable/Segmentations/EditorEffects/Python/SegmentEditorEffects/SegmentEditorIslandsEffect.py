@@ -141,6 +141,22 @@ about each operation, hover the mouse over the option and wait for the tooltip t
 
         self.scriptedEffect.saveStateForUndo()
 
+        parameterSetNode = self.scriptedEffect.parameterSetNode()
+        if (parameterSetNode.GetMaskMode() == slicer.vtkMRMLSegmentationNode.EditAllowedEverywhere
+                and not parameterSetNode.GetSourceVolumeIntensityMask()):
+            # Label all islands in a single pass and write them into the shared labelmap layer of the segment
+            createdSegmentIDs = vtk.vtkStringArray()
+            slicer.vtkSlicerSegmentationsModuleLogic.SplitSegmentIntoIslands(
+                parameterSetNode.GetSegmentationNode(), parameterSetNode.GetSelectedSegmentID(),
+                minimumSize, maxNumberOfSegments, split, False, self.segmentIDsToOverwrite(), createdSegmentIDs)
+            logging.debug("%d segments created from islands" % createdSegmentIDs.GetNumberOfValues())
+        else:
+            # Masking settings must be applied to each modification, which requires modifying islands one by one
+            self.splitSegmentsMasked(minimumSize, maxNumberOfSegments, split)
+
+        qt.QApplication.restoreOverrideCursor()
+
+    def splitSegmentsMasked(self, minimumSize, maxNumberOfSegments, split):
         # Get modifier labelmap
         selectedSegmentLabelmap = self.scriptedEffect.selectedSegmentLabelmap()
 
@@ -247,8 +263,6 @@ about each operation, hover the mouse over the option and wait for the tooltip t
                     # all islands lumped into one segment, so we are done
                     break
 
-        qt.QApplication.restoreOverrideCursor()
-
     def processInteractionEvents(self, callerInteractor, eventId, viewWidget):
         import vtkSegmentationCorePython as vtkSegmentationCore
 
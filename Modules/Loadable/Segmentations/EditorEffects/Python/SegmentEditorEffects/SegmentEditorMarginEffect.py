@@ -235,6 +235,12 @@ class SegmentEditorMarginEffect(AbstractScriptedSegmentEditorEffect):
                 if inputSegmentIDs.GetNumberOfValues() == 0:
                     logging.info("Margin operation skipped: there are no visible segments.")
                     return
+                if self.isEditMaskForAllSegmentsSupported():
+                    # Process all segments at once, using a single distance transform
+                    marginSizeMM = self.scriptedEffect.doubleParameter("MarginSizeMm")
+                    if not self.applyMarginToAllSegments(inputSegmentIDs, -math.inf, marginSizeMM):
+                        logging.error("Failed to apply margin")
+                    return
                 # select input segments one by one, process
                 for index in range(inputSegmentIDs.GetNumberOfValues()):
                     segmentID = inputSegmentIDs.GetValue(index)
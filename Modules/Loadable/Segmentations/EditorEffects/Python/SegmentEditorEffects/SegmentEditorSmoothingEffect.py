@@ -378,6 +378,16 @@ If segments overlap, segment higher in the segments table will have priority. <b
             logging.info("Smoothing operation skipped: there are no visible segments")
             return
 
+        parameterSetNode = self.scriptedEffect.parameterSetNode()
+        if (parameterSetNode.GetMaskMode() == slicer.vtkMRMLSegmentationNode.EditAllowedEverywhere
+                and not parameterSetNode.GetSourceVolumeIntensityMask()):
+            # Rasterize all smoothed surfaces in a single pass and write them into one shared labelmap layer
+            smoothingFactor = self.scriptedEffect.doubleParameter("JointTaubinSmoothingFactor")
+            if not slicer.vtkSlicerSegmentationsModuleLogic.JointSmoothSegments(segmentationNode, visibleSegmentIds, smoothingFactor):
+                logging.error("Failed to apply smoothing")
+            return
+
+        # Masking settings must be applied to each modification, which requires modifying segments one by one
         mergedImage = slicer.vtkOrientedImageData()
         if not segmentationNode.GenerateMergedLabelmapForAllSegments(mergedImage,
                                                                      vtkSegmentationCore.vtkSegmentation.EXTENT_UNION_OF_SEGMENTS_PADDED,
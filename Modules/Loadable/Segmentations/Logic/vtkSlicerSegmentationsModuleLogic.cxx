@@ -39,24 +39,32 @@
 #include <vtkActor.h>
 #include <vtkAppendPolyData.h>
 #include <vtkCallbackCommand.h>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
 #include <vtkDataObject.h>
+#include <vtkDiscreteMarchingCubes.h>
 #include <vtkGeneralTransform.h>
 #include <vtkGeometryFilter.h>
 #include <vtkImageAccumulate.h>
 #include <vtkImageConstantPad.h>
 #include <vtkImageMathematics.h>
+#include <vtkIdList.h>
 #include <vtkImageThreshold.h>
+#include <vtkIntArray.h>
 #include <vtkLookupTable.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkOBJExporter.h>
 #include <vtkPointData.h>
+#include <vtkPoints.h>
 #include <vtkPolyData.h>
 #include <vtkPolyDataMapper.h>
 #include <vtkProperty.h>
 #include <vtkRenderer.h>
 #include <vtkRenderWindow.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
 #include <vtkSTLWriter.h>
 #include <vtkStringArray.h>
 #include <vtkTransform.h>
@@ -64,6 +72,7 @@
 #include <vtkTriangleFilter.h>
 #include <vtkTrivialProducer.h>
 #include <vtkUnstructuredGrid.h>
+#include <vtkWindowedSincPolyDataFilter.h>
 #include <vtksys/SystemTools.hxx>
 #include <vtksys/RegularExpression.hxx>
 
@@ -89,6 +98,11 @@
 #include <vtkMRMLTransformNode.h>
 
 // STD includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <set>
 #include <sstream>
 #include <string>
 
@@ -2899,6 +2913,1272 @@ bool vtkSlicerSegmentationsModuleLogic::ClearSegment(vtkMRMLSegmentationNode* se
   return true;
 }
 
+namespace
+{
+
+//-----------------------------------------------------------------------------
+/// Erase voxels that have any of the specified label values.
+/// If mask is specified then only voxels where the mask is non-zero are erased.
+template <class T>
+void EraseLabelValues(T* voxels, vtkIdType numberOfVoxels, const std::set<int>& labelValues, const unsigned char* mask = nullptr)
+{
+  vtkSMPTools::For(0,
+                   numberOfVoxels,
+                   [&](vtkIdType begin, vtkIdType end)
+                   {
+                     for (vtkIdType voxelIndex = begin; voxelIndex < end; ++voxelIndex)
+                     {
+                       if (voxels[voxelIndex] != 0 && (!mask || mask[voxelIndex]) && labelValues.count(static_cast<int>(voxels[voxelIndex])))
+                       {
+                         voxels[voxelIndex] = 0;
+                       }
+                     }
+                   });
+}
+
+//-----------------------------------------------------------------------------
+/// Remove segments to overwrite from voxels where the mask is non-zero, except the excluded segments.
+/// Segments that are modified are appended to modifiedSegmentIDs.
+void EraseOverwrittenSegments(vtkSegmentation* segmentation,
+                              vtkStringArray* segmentIDsToOverwrite,
+                              const std::vector<std::string>& excludedSegmentIDs,
+                              vtkOrientedImageData* maskImage,
+                              std::vector<std::string>& modifiedSegmentIDs)
+{
+  std::map<vtkOrientedImageData*, std::set<int>> overwrittenLabelValuesInLayers;
+  for (vtkIdType index = 0; segmentIDsToOverwrite && index < segmentIDsToOverwrite->GetNumberOfValues(); ++index)
+  {
+    std::string segmentID = segmentIDsToOverwrite->GetValue(index);
+    vtkSegment* segment = segmentation->GetSegment(segmentID);
+    if (!segment || std::find(excludedSegmentIDs.begin(), excludedSegmentIDs.end(), segmentID) != excludedSegmentIDs.end())
+    {
+      continue;
+    }
+    vtkOrientedImageData* layer = vtkOrientedImageData::SafeDownCast(segment->GetRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName()));
+    if (!layer || !layer->GetScalarPointer())
+    {
+      continue;
+    }
+    overwrittenLabelValuesInLayers[layer].insert(segment->GetLabelValue());
+    modifiedSegmentIDs.push_back(segmentID);
+  }
+  for (const auto& layerLabelValues : overwrittenLabelValuesInLayers)
+  {
+    vtkOrientedImageData* layer = layerLabelValues.first;
+    vtkNew<vtkOrientedImageData> alignedMask;
+    if (vtkOrientedImageDataResample::DoGeometriesMatch(maskImage, layer))
+    {
+      vtkOrientedImageDataResample::CopyImage(maskImage, alignedMask, layer->GetExtent());
+    }
+    else
+    {
+      vtkOrientedImageDataResample::ResampleOrientedImageToReferenceOrientedImage(maskImage, layer, alignedMask);
+    }
+    if (alignedMask->GetNumberOfPoints() != layer->GetNumberOfPoints())
+    {
+      continue;
+    }
+    switch (layer->GetScalarType())
+    {
+      vtkTemplateMacro(EraseLabelValues(static_cast<VTK_TT*>(layer->GetScalarPointer()),
+                                        layer->GetNumberOfPoints(),
+                                        layerLabelValues.second,
+                                        static_cast<unsigned char*>(alignedMask->GetScalarPointer())));
+    }
+    layer->Modified();
+  }
+}
+
+//-----------------------------------------------------------------------------
+/// Run of consecutive voxels of a row that belong to the segment
+struct IslandRun
+{
+  int Y;
+  int XBegin;
+  int XEnd;
+};
+
+//-----------------------------------------------------------------------------
+/// Runs of a slice. Runs of row y are RowBegin[y]..RowBegin[y+1]-1.
+struct IslandSliceRuns
+{
+  std::vector<IslandRun> Runs;
+  std::vector<vtkIdType> RowBegin;
+};
+
+//-----------------------------------------------------------------------------
+vtkIdType FindIslandRoot(std::vector<vtkIdType>& parents, vtkIdType runIndex)
+{
+  while (parents[runIndex] != runIndex)
+  {
+    parents[runIndex] = parents[parents[runIndex]];
+    runIndex = parents[runIndex];
+  }
+  return runIndex;
+}
+
+//-----------------------------------------------------------------------------
+/// The root of an island is always its first run in scan order
+void MergeIslands(std::vector<vtkIdType>& parents, vtkIdType runIndex1, vtkIdType runIndex2)
+{
+  runIndex1 = FindIslandRoot(parents, runIndex1);
+  runIndex2 = FindIslandRoot(parents, runIndex2);
+  if (runIndex1 < runIndex2)
+  {
+    parents[runIndex2] = runIndex1;
+  }
+  else if (runIndex2 < runIndex1)
+  {
+    parents[runIndex1] = runIndex2;
+  }
+}
+
+//-----------------------------------------------------------------------------
+/// Merge islands of overlapping runs of two rows. Runs are sorted by X.
+/// If margin is 1 then runs that touch diagonally are merged, too.
+void MergeOverlappingRuns(std::vector<vtkIdType>& parents,
+                          const std::vector<IslandRun>& runs1,
+                          vtkIdType begin1,
+                          vtkIdType end1,
+                          vtkIdType offset1,
+                          const std::vector<IslandRun>& runs2,
+                          vtkIdType begin2,
+                          vtkIdType end2,
+                          vtkIdType offset2,
+                          int margin)
+{
+  vtkIdType index1 = begin1;
+  vtkIdType index2 = begin2;
+  while (index1 < end1 && index2 < end2)
+  {
+    const IslandRun& run1 = runs1[index1];
+    const IslandRun& run2 = runs2[index2];
+    if (run1.XBegin <= run2.XEnd + margin && run2.XBegin <= run1.XEnd + margin)
+    {
+      MergeIslands(parents, offset1 + index1, offset2 + index2);
+    }
+    if (run1.XEnd < run2.XEnd)
+    {
+      ++index1;
+    }
+    else
+    {
+      ++index2;
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+template <class T>
+void ExtractIslandRuns(const T* row, int rowLength, int y, T labelValue, std::vector<IslandRun>& runs)
+{
+  int x = 0;
+  while (x < rowLength)
+  {
+    if (row[x] != labelValue)
+    {
+      ++x;
+      continue;
+    }
+    IslandRun run;
+    run.Y = y;
+    run.XBegin = x;
+    while (x < rowLength && row[x] == labelValue)
+    {
+      ++x;
+    }
+    run.XEnd = x - 1;
+    runs.push_back(run);
+  }
+}
+
+//-----------------------------------------------------------------------------
+template <class T>
+void WriteIslandRun(T* row, const IslandRun& run, int labelValue)
+{
+  std::fill(row + run.XBegin, row + run.XEnd + 1, static_cast<T>(labelValue));
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+bool vtkSlicerSegmentationsModuleLogic::SplitSegmentIntoIslands(vtkMRMLSegmentationNode* segmentationNode,
+                                                                std::string segmentID,
+                                                                int minimumSize /*=0*/,
+                                                                int maxNumberOfSegments /*=0*/,
+                                                                bool split /*=true*/,
+                                                                bool fullyConnected /*=false*/,
+                                                                vtkStringArray* segmentIDsToOverwrite /*=nullptr*/,
+                                                                vtkStringArray* createdSegmentIDs /*=nullptr*/)
+{
+  if (!segmentationNode || !segmentationNode->GetSegmentation())
+  {
+    vtkErrorWithObjectMacro(nullptr, "SplitSegmentIntoIslands: Invalid segmentation node");
+    return false;
+  }
+  vtkSegmentation* segmentation = segmentationNode->GetSegmentation();
+  vtkSegment* segment = segmentation->GetSegment(segmentID);
+  if (!segment)
+  {
+    vtkErrorWithObjectMacro(nullptr, "SplitSegmentIntoIslands: Invalid segment " << segmentID);
+    return false;
+  }
+  vtkOrientedImageData* labelmap =
+    vtkOrientedImageData::SafeDownCast(segment->GetRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName()));
+  if (!labelmap)
+  {
+    vtkErrorWithObjectMacro(nullptr, "SplitSegmentIntoIslands: Segment " << segmentID << " does not have binary labelmap representation");
+    return false;
+  }
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  labelmap->GetExtent(extent);
+  if (!labelmap->GetPointData() || !labelmap->GetPointData()->GetScalars() || extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5])
+  {
+    // empty segment, nothing to split
+    return true;
+  }
+
+  const int rowLength = extent[1] - extent[0] + 1;
+  const int numberOfRows = extent[3] - extent[2] + 1;
+  const int numberOfSlices = extent[5] - extent[4] + 1;
+  const int segmentLabelValue = segment->GetLabelValue();
+
+  // Find runs of segment voxels and connect them within each slice
+  std::vector<IslandSliceRuns> slices(numberOfSlices);
+  vtkSMPTools::For(0, numberOfSlices,
+                   [&](vtkIdType beginSlice, vtkIdType endSlice)
+                   {
+                     for (vtkIdType sliceIndex = beginSlice; sliceIndex < endSlice; ++sliceIndex)
+                     {
+                       IslandSliceRuns& slice = slices[sliceIndex];
+                       slice.RowBegin.resize(numberOfRows + 1);
+                       for (int rowIndex = 0; rowIndex < numberOfRows; ++rowIndex)
+                       {
+                         slice.RowBegin[rowIndex] = static_cast<vtkIdType>(slice.Runs.size());
+                         void* row = labelmap->GetScalarPointer(extent[0], extent[2] + rowIndex, extent[4] + static_cast<int>(sliceIndex));
+                         switch (labelmap->GetScalarType())
+                         {
+                           vtkTemplateMacro(ExtractIslandRuns(static_cast<VTK_TT*>(row), rowLength, rowIndex, static_cast<VTK_TT>(segmentLabelValue), slice.Runs));
+                         }
+                       }
+                       slice.RowBegin[numberOfRows] = static_cast<vtkIdType>(slice.Runs.size());
+                     }
+                   });
+  std::vector<vtkIdType> sliceOffsets(numberOfSlices + 1, 0);
+  for (int sliceIndex = 0; sliceIndex < numberOfSlices; ++sliceIndex)
+  {
+    sliceOffsets[sliceIndex + 1] = sliceOffsets[sliceIndex] + static_cast<vtkIdType>(slices[sliceIndex].Runs.size());
+  }
+  const vtkIdType numberOfRuns = sliceOffsets[numberOfSlices];
+  std::vector<vtkIdType> parents(numberOfRuns);
+  for (vtkIdType runIndex = 0; runIndex < numberOfRuns; ++runIndex)
+  {
+    parents[runIndex] = runIndex;
+  }
+  const int margin = (fullyConnected ? 1 : 0);
+  // Islands within a slice only refer to runs of the same slice, therefore slices can be processed in parallel
+  vtkSMPTools::For(0, numberOfSlices,
+                   [&](vtkIdType beginSlice, vtkIdType endSlice)
+                   {
+                     for (vtkIdType sliceIndex = beginSlice; sliceIndex < endSlice; ++sliceIndex)
+                     {
+                       const IslandSliceRuns& slice = slices[sliceIndex];
+                       const vtkIdType offset = sliceOffsets[sliceIndex];
+                       for (int rowIndex = 1; rowIndex < numberOfRows; ++rowIndex)
+                       {
+                         MergeOverlappingRuns(parents,
+                                              slice.Runs,
+                                              slice.RowBegin[rowIndex - 1],
+                                              slice.RowBegin[rowIndex],
+                                              offset,
+                                              slice.Runs,
+                                              slice.RowBegin[rowIndex],
+                                              slice.RowBegin[rowIndex + 1],
+                                              offset,
+                                              margin);
+                       }
+                     }
+                   });
+
+  // Connect islands of neighbor slices
+  for (int sliceIndex = 1; sliceIndex < numberOfSlices; ++sliceIndex)
+  {
+    const IslandSliceRuns& previousSlice = slices[sliceIndex - 1];
+    const IslandSliceRuns& slice = slices[sliceIndex];
+    if (previousSlice.Runs.empty() || slice.Runs.empty())
+    {
+      continue;
+    }
+    for (int rowIndex = 0; rowIndex < numberOfRows; ++rowIndex)
+    {
+      for (int previousRowIndex = std::max(rowIndex - margin, 0); previousRowIndex <= std::min(rowIndex + margin, numberOfRows - 1); ++previousRowIndex)
+      {
+        MergeOverlappingRuns(parents,
+                             previousSlice.Runs,
+                             previousSlice.RowBegin[previousRowIndex],
+                             previousSlice.RowBegin[previousRowIndex + 1],
+                             sliceOffsets[sliceIndex - 1],
+                             slice.Runs,
+                             slice.RowBegin[rowIndex],
+                             slice.RowBegin[rowIndex + 1],
+                             sliceOffsets[sliceIndex],
+                             margin);
+      }
+    }
+  }
+
+  // Island sizes
+  std::vector<vtkIdType> islandSizes(numberOfRuns, 0);
+  for (int sliceIndex = 0; sliceIndex < numberOfSlices; ++sliceIndex)
+  {
+    const std::vector<IslandRun>& runs = slices[sliceIndex].Runs;
+    for (vtkIdType runIndex = 0; runIndex < static_cast<vtkIdType>(runs.size()); ++runIndex)
+    {
+      vtkIdType root = FindIslandRoot(parents, sliceOffsets[sliceIndex] + runIndex);
+      parents[sliceOffsets[sliceIndex] + runIndex] = root;
+      islandSizes[root] += runs[runIndex].XEnd - runs[runIndex].XBegin + 1;
+    }
+  }
+
+  // Kept islands in decreasing size (islands of equal size in scan order)
+  std::vector<vtkIdType> islandRoots;
+  for (vtkIdType runIndex = 0; runIndex < numberOfRuns; ++runIndex)
+  {
+    if (parents[runIndex] == runIndex && islandSizes[runIndex] >= minimumSize)
+    {
+      islandRoots.push_back(runIndex);
+    }
+  }
+  std::stable_sort(islandRoots.begin(), islandRoots.end(), [&islandSizes](vtkIdType root1, vtkIdType root2) { return islandSizes[root1] > islandSizes[root2]; });
+  if (maxNumberOfSegments > 0 && static_cast<int>(islandRoots.size()) > maxNumberOfSegments)
+  {
+    islandRoots.resize(maxNumberOfSegments);
+  }
+
+  // Label value of each island: removed islands are erased, islands other than the largest get new label values
+  std::vector<int> islandLabelValues(numberOfRuns, 0);
+  std::vector<int> newLabelValues;
+  if (split && islandRoots.size() > 1)
+  {
+    std::vector<std::string> sharedSegmentIDs;
+    segmentation->GetSegmentIDsSharingBinaryLabelmapRepresentation(segmentID, sharedSegmentIDs, true);
+    std::set<int> usedLabelValues;
+    for (const std::string& sharedSegmentID : sharedSegmentIDs)
+    {
+      usedLabelValues.insert(segmentation->GetSegment(sharedSegmentID)->GetLabelValue());
+    }
+    int labelValue = 1;
+    while (newLabelValues.size() < islandRoots.size() - 1)
+    {
+      if (usedLabelValues.find(labelValue) == usedLabelValues.end())
+      {
+        newLabelValues.push_back(labelValue);
+      }
+      ++labelValue;
+    }
+  }
+  for (size_t islandIndex = 0; islandIndex < islandRoots.size(); ++islandIndex)
+  {
+    islandLabelValues[islandRoots[islandIndex]] = (islandIndex == 0 || newLabelValues.empty() ? segmentLabelValue : newLabelValues[islandIndex - 1]);
+  }
+
+  MRMLNodeModifyBlocker blocker(segmentationNode);
+  bool wasSourceRepresentationModifiedEnabled = segmentation->SetSourceRepresentationModifiedEnabled(false);
+
+  // Write all islands into the labelmap in a single pass
+  if (!newLabelValues.empty())
+  {
+    vtkOrientedImageDataResample::CastImageForValue(labelmap, newLabelValues.back());
+  }
+  vtkSMPTools::For(0, numberOfSlices,
+                   [&](vtkIdType beginSlice, vtkIdType endSlice)
+                   {
+                     for (vtkIdType sliceIndex = beginSlice; sliceIndex < endSlice; ++sliceIndex)
+                     {
+                       const std::vector<IslandRun>& runs = slices[sliceIndex].Runs;
+                       for (vtkIdType runIndex = 0; runIndex < static_cast<vtkIdType>(runs.size()); ++runIndex)
+                       {
+                         const IslandRun& run = runs[runIndex];
+                         int labelValue = islandLabelValues[parents[sliceOffsets[sliceIndex] + runIndex]];
+                         if (labelValue == segmentLabelValue)
+                         {
+                           continue;
+                         }
+                         void* row = labelmap->GetScalarPointer(extent[0], extent[2] + run.Y, extent[4] + static_cast<int>(sliceIndex));
+                         switch (labelmap->GetScalarType())
+                         {
+                           vtkTemplateMacro(WriteIslandRun(static_cast<VTK_TT*>(row), run, labelValue));
+                         }
+                       }
+                     }
+                   });
+  labelmap->Modified();
+
+  // Create segments for the new islands in the same labelmap layer.
+  // Segments are added empty and the labelmap layer is set afterwards, so that other representations
+  // are not converted for each added segment but for all modified segments at once at the end.
+  std::string baseSegmentName = (segment->GetName() && strlen(segment->GetName()) > 0 ? segment->GetName() : "Label");
+  std::vector<std::string> modifiedSegmentIDs;
+  modifiedSegmentIDs.push_back(segmentID);
+  for (size_t islandIndex = 1; islandIndex < islandRoots.size() && !newLabelValues.empty(); ++islandIndex)
+  {
+    vtkNew<vtkSegment> islandSegment;
+    islandSegment->SetName((baseSegmentName + "_" + std::to_string(islandIndex + 1)).c_str());
+    islandSegment->SetLabelValue(newLabelValues[islandIndex - 1]);
+    if (!segmentation->AddSegment(islandSegment))
+    {
+      vtkErrorWithObjectMacro(nullptr, "SplitSegmentIntoIslands: Failed to add segment for island " << islandIndex + 1);
+      continue;
+    }
+    islandSegment->AddRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName(), labelmap);
+    std::string islandSegmentID = segmentation->GetSegmentIdBySegment(islandSegment);
+    modifiedSegmentIDs.push_back(islandSegmentID);
+    if (createdSegmentIDs)
+    {
+      createdSegmentIDs->InsertNextValue(islandSegmentID);
+    }
+  }
+
+  // Remove kept islands from segments that may be overwritten.
+  // Segments in the same labelmap layer cannot overlap the islands.
+  if (segmentIDsToOverwrite && segmentIDsToOverwrite->GetNumberOfValues() > 0 && !islandRoots.empty())
+  {
+    vtkNew<vtkOrientedImageData> keptIslandsImage;
+    keptIslandsImage->SetExtent(extent);
+    keptIslandsImage->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+    vtkNew<vtkMatrix4x4> imageToWorldMatrix;
+    labelmap->GetImageToWorldMatrix(imageToWorldMatrix);
+    keptIslandsImage->SetGeometryFromImageToWorldMatrix(imageToWorldMatrix);
+    unsigned char* keptIslandVoxels = static_cast<unsigned char*>(keptIslandsImage->GetScalarPointer());
+    std::fill(keptIslandVoxels, keptIslandVoxels + keptIslandsImage->GetNumberOfPoints(), 0);
+    vtkSMPTools::For(0,
+                     numberOfSlices,
+                     [&](vtkIdType beginSlice, vtkIdType endSlice)
+                     {
+                       for (vtkIdType sliceIndex = beginSlice; sliceIndex < endSlice; ++sliceIndex)
+                       {
+                         const std::vector<IslandRun>& runs = slices[sliceIndex].Runs;
+                         for (vtkIdType runIndex = 0; runIndex < static_cast<vtkIdType>(runs.size()); ++runIndex)
+                         {
+                           const IslandRun& run = runs[runIndex];
+                           if (islandLabelValues[parents[sliceOffsets[sliceIndex] + runIndex]] == 0)
+                           {
+                             continue;
+                           }
+                           unsigned char* row = static_cast<unsigned char*>(keptIslandsImage->GetScalarPointer(extent[0], extent[2] + run.Y, extent[4] + static_cast<int>(sliceIndex)));
+                           WriteIslandRun(row, run, 1);
+                         }
+                       }
+                     });
+    std::vector<std::string> sharedSegmentIDs;
+    segmentation->GetSegmentIDsSharingBinaryLabelmapRepresentation(segmentID, sharedSegmentIDs, true);
+    EraseOverwrittenSegments(segmentation, segmentIDsToOverwrite, sharedSegmentIDs, keptIslandsImage, modifiedSegmentIDs);
+  }
+
+  segmentation->SetSourceRepresentationModifiedEnabled(wasSourceRepresentationModifiedEnabled);
+  vtkSlicerSegmentationsModuleLogic::ReconvertAllRepresentations(segmentationNode, modifiedSegmentIDs);
+  segmentation->InvokeEvent(vtkSegmentation::SourceRepresentationModified, (void*)segmentID.c_str());
+  segmentation->InvokeEvent(vtkSegmentation::RepresentationModified, (void*)segmentID.c_str());
+  return true;
+}
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+/// Crossing of a label surface with a labelmap row
+struct LabelSurfaceCrossing
+{
+  int LabelIndex;
+  double X;
+  bool operator<(const LabelSurfaceCrossing& other) const { return LabelIndex < other.LabelIndex || (LabelIndex == other.LabelIndex && X < other.X); }
+};
+
+//-----------------------------------------------------------------------------
+template <class T>
+void FillLabelRow(T* row, int xBegin, int xEnd, int labelValue)
+{
+  std::fill(row + xBegin, row + xEnd, static_cast<T>(labelValue));
+}
+
+//-----------------------------------------------------------------------------
+/// Rasterize closed surfaces of all labels into a multi-label image in a single pass.
+/// Surface points are in IJK coordinates of the labelmap. Cell scalars contain the label value of each triangle.
+/// Voxels are filled in increasing order of label values, therefore where surfaces overlap, the higher label value is kept.
+void RasterizeLabelSurfaces(vtkPolyData* surfaces, vtkImageData* labelmap)
+{
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  labelmap->GetExtent(extent);
+  vtkDataArray* cellLabels = surfaces->GetCellData()->GetScalars();
+  vtkCellArray* polys = surfaces->GetPolys();
+  if (!cellLabels || !polys || !surfaces->GetPoints() || extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5])
+  {
+    return;
+  }
+  const int numberOfRows = extent[3] - extent[2] + 1;
+  const int numberOfSlices = extent[5] - extent[4] + 1;
+
+  // Triangles, indexed by the slices that they cross
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  points->DeepCopy(surfaces->GetPoints());
+  const double* pointCoordinates = static_cast<double*>(points->GetVoidPointer(0));
+  std::vector<vtkIdType> triangles;
+  std::vector<int> triangleLabels;
+  triangles.reserve(polys->GetNumberOfCells() * 3);
+  triangleLabels.reserve(polys->GetNumberOfCells());
+  std::vector<vtkIdType> sliceTriangleCounts(numberOfSlices + 1, 0);
+  vtkNew<vtkIdList> cellPointIds;
+  vtkIdType cellIndex = surfaces->GetNumberOfVerts() + surfaces->GetNumberOfLines();
+  for (polys->InitTraversal(); polys->GetNextCell(cellPointIds); ++cellIndex)
+  {
+    if (cellPointIds->GetNumberOfIds() != 3)
+    {
+      continue;
+    }
+    double zMin = VTK_DOUBLE_MAX;
+    double zMax = VTK_DOUBLE_MIN;
+    for (int i = 0; i < 3; ++i)
+    {
+      vtkIdType pointId = cellPointIds->GetId(i);
+      triangles.push_back(pointId);
+      zMin = std::min(zMin, pointCoordinates[pointId * 3 + 2]);
+      zMax = std::max(zMax, pointCoordinates[pointId * 3 + 2]);
+    }
+    triangleLabels.push_back(static_cast<int>(cellLabels->GetTuple1(cellIndex)));
+    // slices z where (z >= zMin) and (z < zMax)
+    int firstSlice = std::max(static_cast<int>(std::ceil(zMin)), extent[4]) - extent[4];
+    int lastSlice = std::min(static_cast<int>(std::ceil(zMax)) - 1, extent[5]) - extent[4];
+    for (int sliceIndex = firstSlice; sliceIndex <= lastSlice; ++sliceIndex)
+    {
+      sliceTriangleCounts[sliceIndex + 1]++;
+    }
+  }
+  std::vector<vtkIdType> sliceTriangleBegin(numberOfSlices + 1, 0);
+  for (int sliceIndex = 0; sliceIndex < numberOfSlices; ++sliceIndex)
+  {
+    sliceTriangleBegin[sliceIndex + 1] = sliceTriangleBegin[sliceIndex] + sliceTriangleCounts[sliceIndex + 1];
+  }
+  std::vector<vtkIdType> sliceTriangles(sliceTriangleBegin[numberOfSlices]);
+  std::vector<vtkIdType> sliceTriangleEnd(sliceTriangleBegin.begin(), sliceTriangleBegin.end() - 1);
+  const vtkIdType numberOfTriangles = static_cast<vtkIdType>(triangleLabels.size());
+  for (vtkIdType triangleIndex = 0; triangleIndex < numberOfTriangles; ++triangleIndex)
+  {
+    const vtkIdType* pointIds = &triangles[triangleIndex * 3];
+    double zMin = std::min(pointCoordinates[pointIds[0] * 3 + 2], std::min(pointCoordinates[pointIds[1] * 3 + 2], pointCoordinates[pointIds[2] * 3 + 2]));
+    double zMax = std::max(pointCoordinates[pointIds[0] * 3 + 2], std::max(pointCoordinates[pointIds[1] * 3 + 2], pointCoordinates[pointIds[2] * 3 + 2]));
+    int firstSlice = std::max(static_cast<int>(std::ceil(zMin)), extent[4]) - extent[4];
+    int lastSlice = std::min(static_cast<int>(std::ceil(zMax)) - 1, extent[5]) - extent[4];
+    for (int sliceIndex = firstSlice; sliceIndex <= lastSlice; ++sliceIndex)
+    {
+      sliceTriangles[sliceTriangleEnd[sliceIndex]++] = triangleIndex;
+    }
+  }
+
+  // Label values in increasing order, so that crossings sorted by label index fill voxels in increasing label value order
+  std::vector<int> labelValues(triangleLabels.begin(), triangleLabels.end());
+  std::sort(labelValues.begin(), labelValues.end());
+  labelValues.erase(std::unique(labelValues.begin(), labelValues.end()), labelValues.end());
+  std::vector<int> triangleLabelIndices(numberOfTriangles);
+  for (vtkIdType triangleIndex = 0; triangleIndex < numberOfTriangles; ++triangleIndex)
+  {
+    triangleLabelIndices[triangleIndex] = static_cast<int>(std::lower_bound(labelValues.begin(), labelValues.end(), triangleLabels[triangleIndex]) - labelValues.begin());
+  }
+
+  // Fill each slice: intersect its triangles with the slice plane, then fill between crossings of each row
+  vtkSMPThreadLocal<std::vector<std::vector<LabelSurfaceCrossing>>> rowCrossingsThreadLocal;
+  vtkSMPTools::For(0,
+                   numberOfSlices,
+                   [&](vtkIdType beginSlice, vtkIdType endSlice)
+                   {
+                     std::vector<std::vector<LabelSurfaceCrossing>>& rowCrossings = rowCrossingsThreadLocal.Local();
+                     rowCrossings.resize(numberOfRows);
+                     for (vtkIdType sliceIndex = beginSlice; sliceIndex < endSlice; ++sliceIndex)
+                     {
+                       const double z = extent[4] + sliceIndex;
+                       for (std::vector<LabelSurfaceCrossing>& crossings : rowCrossings)
+                       {
+                         crossings.clear();
+                       }
+                       for (vtkIdType index = sliceTriangleBegin[sliceIndex]; index < sliceTriangleBegin[sliceIndex + 1]; ++index)
+                       {
+                         const vtkIdType triangleIndex = sliceTriangles[index];
+                         const vtkIdType* pointIds = &triangles[triangleIndex * 3];
+                         // Intersection of the triangle with the slice plane (exactly two edges cross the plane)
+                         double segment[2][2];
+                         int numberOfSegmentPoints = 0;
+                         for (int edge = 0; edge < 3 && numberOfSegmentPoints < 2; ++edge)
+                         {
+                           const double* p0 = pointCoordinates + pointIds[edge] * 3;
+                           const double* p1 = pointCoordinates + pointIds[(edge + 1) % 3] * 3;
+                           if ((p0[2] <= z) == (p1[2] <= z))
+                           {
+                             continue;
+                           }
+                           const double t = (z - p0[2]) / (p1[2] - p0[2]);
+                           segment[numberOfSegmentPoints][0] = p0[0] + t * (p1[0] - p0[0]);
+                           segment[numberOfSegmentPoints][1] = p0[1] + t * (p1[1] - p0[1]);
+                           ++numberOfSegmentPoints;
+                         }
+                         if (numberOfSegmentPoints < 2 || segment[0][1] == segment[1][1])
+                         {
+                           continue;
+                         }
+                         // Crossings of the segment with rows y where (y >= yMin) and (y < yMax)
+                         const double yMin = std::min(segment[0][1], segment[1][1]);
+                         const double yMax = std::max(segment[0][1], segment[1][1]);
+                         const int firstRow = std::max(static_cast<int>(std::ceil(yMin)), extent[2]);
+                         const int lastRow = std::min(static_cast<int>(std::ceil(yMax)) - 1, extent[3]);
+                         for (int y = firstRow; y <= lastRow; ++y)
+                         {
+                           LabelSurfaceCrossing crossing;
+                           crossing.LabelIndex = triangleLabelIndices[triangleIndex];
+                           crossing.X = segment[0][0] + (y - segment[0][1]) * (segment[1][0] - segment[0][0]) / (segment[1][1] - segment[0][1]);
+                           rowCrossings[y - extent[2]].push_back(crossing);
+                         }
+                       }
+
+                       for (int rowIndex = 0; rowIndex < numberOfRows; ++rowIndex)
+                       {
+                         std::vector<LabelSurfaceCrossing>& crossings = rowCrossings[rowIndex];
+                         if (crossings.empty())
+                         {
+                           continue;
+                         }
+                         std::sort(crossings.begin(), crossings.end());
+                         void* row = labelmap->GetScalarPointer(extent[0], extent[2] + rowIndex, extent[4] + static_cast<int>(sliceIndex));
+                         size_t crossingIndex = 0;
+                         while (crossingIndex + 1 < crossings.size())
+                         {
+                           const LabelSurfaceCrossing& entering = crossings[crossingIndex];
+                           const LabelSurfaceCrossing& leaving = crossings[crossingIndex + 1];
+                           if (entering.LabelIndex != leaving.LabelIndex)
+                           {
+                             // odd number of crossings of a label (surface is not closed), skip the unpaired crossing
+                             ++crossingIndex;
+                             continue;
+                           }
+                           crossingIndex += 2;
+                           // voxels x where (x >= entering) and (x < leaving)
+                           int xBegin = std::max(static_cast<int>(std::ceil(entering.X)), extent[0]) - extent[0];
+                           int xEnd = std::min(static_cast<int>(std::ceil(leaving.X)), extent[1] + 1) - extent[0];
+                           if (xBegin >= xEnd)
+                           {
+                             continue;
+                           }
+                           switch (labelmap->GetScalarType())
+                           {
+                             vtkTemplateMacro(FillLabelRow(static_cast<VTK_TT*>(row), xBegin, xEnd, labelValues[entering.LabelIndex]));
+                           }
+                         }
+                       }
+                     }
+                   });
+}
+
+//-----------------------------------------------------------------------------
+/// Set a multi-label image as the binary labelmap of the specified segments, in one shared layer.
+/// Label value of each segment is its index in segmentIDs + 1.
+/// A layer that only contains the specified segments is reused, the specified segments are erased from other layers.
+/// \return The shared layer
+vtkOrientedImageData* SetSegmentsToSharedLabelmap(vtkSegmentation* segmentation, const std::vector<std::string>& segmentIDs, vtkOrientedImageData* labelmap)
+{
+  std::set<std::string> segmentIDSet(segmentIDs.begin(), segmentIDs.end());
+  std::set<vtkOrientedImageData*> processedLayers;
+  vtkSmartPointer<vtkOrientedImageData> targetLayer;
+  for (const std::string& segmentID : segmentIDs)
+  {
+    vtkOrientedImageData* layer =
+      vtkOrientedImageData::SafeDownCast(segmentation->GetSegment(segmentID)->GetRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName()));
+    if (!layer || !processedLayers.insert(layer).second)
+    {
+      continue;
+    }
+    std::vector<std::string> sharedSegmentIDs;
+    segmentation->GetSegmentIDsSharingBinaryLabelmapRepresentation(segmentID, sharedSegmentIDs, true);
+    std::set<int> labelValues;
+    bool onlySpecifiedSegments = true;
+    for (const std::string& sharedSegmentID : sharedSegmentIDs)
+    {
+      if (segmentIDSet.count(sharedSegmentID))
+      {
+        labelValues.insert(segmentation->GetSegment(sharedSegmentID)->GetLabelValue());
+      }
+      else
+      {
+        onlySpecifiedSegments = false;
+      }
+    }
+    if (onlySpecifiedSegments)
+    {
+      if (!targetLayer)
+      {
+        targetLayer = layer;
+      }
+      continue;
+    }
+    if (layer->GetPointData() && layer->GetPointData()->GetScalars())
+    {
+      switch (layer->GetScalarType())
+      {
+        vtkTemplateMacro(EraseLabelValues(static_cast<VTK_TT*>(layer->GetScalarPointer()), layer->GetNumberOfPoints(), labelValues));
+      }
+      layer->Modified();
+    }
+  }
+  if (!targetLayer)
+  {
+    targetLayer = vtkSmartPointer<vtkOrientedImageData>::New();
+  }
+  targetLayer->ShallowCopy(labelmap);
+  for (size_t segmentIndex = 0; segmentIndex < segmentIDs.size(); ++segmentIndex)
+  {
+    vtkSegment* segment = segmentation->GetSegment(segmentIDs[segmentIndex]);
+    segment->SetLabelValue(static_cast<int>(segmentIndex) + 1);
+    segment->AddRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName(), targetLayer);
+  }
+  return targetLayer;
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+bool vtkSlicerSegmentationsModuleLogic::JointSmoothSegments(vtkMRMLSegmentationNode* segmentationNode, vtkStringArray* segmentIDs, double smoothingFactor)
+{
+  if (!segmentationNode || !segmentationNode->GetSegmentation())
+  {
+    vtkErrorWithObjectMacro(nullptr, "JointSmoothSegments: Invalid segmentation node");
+    return false;
+  }
+  vtkSegmentation* segmentation = segmentationNode->GetSegmentation();
+  std::vector<std::string> segmentIDsToSmooth;
+  if (segmentIDs && segmentIDs->GetNumberOfValues() > 0)
+  {
+    for (vtkIdType index = 0; index < segmentIDs->GetNumberOfValues(); ++index)
+    {
+      segmentIDsToSmooth.push_back(segmentIDs->GetValue(index));
+    }
+  }
+  else
+  {
+    segmentation->GetSegmentIDs(segmentIDsToSmooth);
+  }
+  if (segmentIDsToSmooth.empty())
+  {
+    return true;
+  }
+  vtkNew<vtkStringArray> mergedSegmentIDs;
+  vtkNew<vtkIntArray> mergedLabelValues;
+  for (size_t segmentIndex = 0; segmentIndex < segmentIDsToSmooth.size(); ++segmentIndex)
+  {
+    if (!segmentation->GetSegment(segmentIDsToSmooth[segmentIndex]))
+    {
+      vtkErrorWithObjectMacro(nullptr, "JointSmoothSegments: Invalid segment " << segmentIDsToSmooth[segmentIndex]);
+      return false;
+    }
+    mergedSegmentIDs->InsertNextValue(segmentIDsToSmooth[segmentIndex]);
+    mergedLabelValues->InsertNextValue(static_cast<int>(segmentIndex) + 1);
+  }
+
+  // Merged labelmap of all segments, label value of each segment is its index + 1
+  vtkNew<vtkOrientedImageData> mergedImage;
+  if (!segmentationNode->GenerateMergedLabelmapForAllSegments(mergedImage, vtkSegmentation::EXTENT_UNION_OF_SEGMENTS_PADDED, nullptr, mergedSegmentIDs, mergedLabelValues))
+  {
+    vtkErrorWithObjectMacro(nullptr, "JointSmoothSegments: Failed to generate merged labelmap");
+    return false;
+  }
+
+  // Extract and smooth surfaces of all segments together in voxel coordinates.
+  // vtkDiscreteFlyingEdges3D cannot be used here, as in the output of that filter,
+  // each labeled region is completely disconnected from neighboring regions, and
+  // for joint smoothing it is essential for the points to move together.
+  vtkNew<vtkImageData> voxelImage;
+  voxelImage->SetExtent(mergedImage->GetExtent());
+  voxelImage->GetPointData()->SetScalars(mergedImage->GetPointData()->GetScalars());
+  vtkNew<vtkDiscreteMarchingCubes> convertToPolyData;
+  convertToPolyData->SetInputData(voxelImage);
+  convertToPolyData->SetNumberOfContours(static_cast<int>(segmentIDsToSmooth.size()));
+  for (int contourIndex = 0; contourIndex < static_cast<int>(segmentIDsToSmooth.size()); ++contourIndex)
+  {
+    convertToPolyData->SetValue(contourIndex, contourIndex + 1);
+  }
+
+  // Low-pass filtering using Taubin's method
+  vtkNew<vtkWindowedSincPolyDataFilter> smoother;
+  smoother->SetInputConnection(convertToPolyData->GetOutputPort());
+  // according to VTK documentation 10-20 iterations could be enough but we use a higher value to reduce chance of shrinking
+  smoother->SetNumberOfIterations(100);
+  smoother->BoundarySmoothingOff();
+  smoother->FeatureEdgeSmoothingOff();
+  smoother->SetFeatureAngle(90.0);
+  // gives a nice range of 1-0.0001 from a user input of 0-1
+  smoother->SetPassBand(pow(10.0, -4.0 * smoothingFactor));
+  smoother->NonManifoldSmoothingOn();
+  smoother->NormalizeCoordinatesOn();
+  smoother->Update();
+
+  // Rasterize all smoothed surfaces into a multi-label image
+  vtkSmartPointer<vtkOrientedImageData> smoothedImage = vtkSmartPointer<vtkOrientedImageData>::New();
+  smoothedImage->SetExtent(mergedImage->GetExtent());
+  smoothedImage->AllocateScalars(segmentIDsToSmooth.size() <= VTK_UNSIGNED_CHAR_MAX ? VTK_UNSIGNED_CHAR : VTK_UNSIGNED_SHORT, 1);
+  smoothedImage->GetPointData()->GetScalars()->Fill(0);
+  RasterizeLabelSurfaces(smoother->GetOutput(), smoothedImage);
+  vtkNew<vtkMatrix4x4> imageToWorldMatrix;
+  mergedImage->GetImageToWorldMatrix(imageToWorldMatrix);
+  smoothedImage->SetGeometryFromImageToWorldMatrix(imageToWorldMatrix);
+
+  // Write all segments into one shared labelmap layer in a single modification.
+  MRMLNodeModifyBlocker blocker(segmentationNode);
+  bool wasSourceRepresentationModifiedEnabled = segmentation->SetSourceRepresentationModifiedEnabled(false);
+  vtkOrientedImageData* targetLayer = SetSegmentsToSharedLabelmap(segmentation, segmentIDsToSmooth, smoothedImage);
+  segmentation->SetSourceRepresentationModifiedEnabled(wasSourceRepresentationModifiedEnabled);
+
+  vtkSlicerSegmentationsModuleLogic::ReconvertAllRepresentations(segmentationNode, segmentIDsToSmooth);
+  segmentation->InvokeEvent(vtkSegmentation::SourceRepresentationModified, targetLayer);
+  segmentation->InvokeEvent(vtkSegmentation::RepresentationModified, nullptr);
+  return true;
+}
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+/// Working buffers for computing the distance transform along a line of voxels
+struct DistanceTransformLineBuffers
+{
+  std::vector<unsigned short> Labels;
+  std::vector<double> SquaredDistances;
+  std::vector<unsigned short> NearestLabels;
+  // Lower envelope of parabolas
+  std::vector<int> EnvelopePositions;
+  std::vector<double> EnvelopeValues;
+  std::vector<unsigned short> EnvelopeLabels;
+  std::vector<double> EnvelopeBoundaries;
+
+  void Resize(int length)
+  {
+    this->Labels.resize(length);
+    this->SquaredDistances.resize(length);
+    this->NearestLabels.resize(length);
+    this->EnvelopePositions.resize(length + 2);
+    this->EnvelopeValues.resize(length + 2);
+    this->EnvelopeLabels.resize(length + 2);
+    this->EnvelopeBoundaries.resize(length + 3);
+  }
+};
+
+//-----------------------------------------------------------------------------
+/// Compute the distance transform along a line of voxels, for each run of voxels that have the same label.
+/// Features of a run are the voxels of the run (with squared distances computed along previous axes)
+/// and the voxels just before and after the run, which have different label (with zero distance).
+/// Voxels beyond those are not considered, because they cannot be closer than the voxels just outside the run.
+/// If insideDistanceToBoundary is set then runs of non-zero labels use only the voxels of the run as features:
+/// the first and last voxels of the run are boundary voxels, which cannot be farther than any voxel outside the run.
+void TransformLine(DistanceTransformLineBuffers& buffers, int length, double squaredSpacing, bool insideDistanceToBoundary)
+{
+  const double infinity = std::numeric_limits<double>::infinity();
+  int runBegin = 0;
+  while (runBegin < length)
+  {
+    const unsigned short runLabel = buffers.Labels[runBegin];
+    int runEnd = runBegin + 1;
+    while (runEnd < length && buffers.Labels[runEnd] == runLabel)
+    {
+      ++runEnd;
+    }
+
+    // Lower envelope of the parabolas of all features of the run (Felzenszwalb and Huttenlocher)
+    int envelopeSize = 0;
+    const bool runFeaturesOnly = (insideDistanceToBoundary && runLabel != 0);
+    const int firstFeature = runFeaturesOnly ? runBegin : std::max(runBegin - 1, 0);
+    const int lastFeature = runFeaturesOnly ? runEnd - 1 : std::min(runEnd, length - 1);
+    for (int q = firstFeature; q <= lastFeature; ++q)
+    {
+      const bool insideRun = (q >= runBegin && q < runEnd);
+      const double value = insideRun ? buffers.SquaredDistances[q] : 0.0;
+      if (value == infinity)
+      {
+        continue;
+      }
+      const unsigned short label = insideRun ? buffers.NearestLabels[q] : buffers.Labels[q];
+      double boundary = -infinity;
+      while (envelopeSize > 0)
+      {
+        const int p = buffers.EnvelopePositions[envelopeSize - 1];
+        boundary = ((value + squaredSpacing * q * q) - (buffers.EnvelopeValues[envelopeSize - 1] + squaredSpacing * p * p)) / (2.0 * squaredSpacing * (q - p));
+        if (boundary > buffers.EnvelopeBoundaries[envelopeSize - 1])
+        {
+          break;
+        }
+        --envelopeSize;
+        boundary = -infinity;
+      }
+      buffers.EnvelopePositions[envelopeSize] = q;
+      buffers.EnvelopeValues[envelopeSize] = value;
+      buffers.EnvelopeLabels[envelopeSize] = label;
+      buffers.EnvelopeBoundaries[envelopeSize] = boundary;
+      ++envelopeSize;
+    }
+
+    // Sample the lower envelope at the voxels of the run
+    int envelopeIndex = 0;
+    for (int position = runBegin; position < runEnd; ++position)
+    {
+      if (envelopeSize == 0)
+      {
+        buffers.SquaredDistances[position] = infinity;
+        buffers.NearestLabels[position] = 0;
+        continue;
+      }
+      while (envelopeIndex + 1 < envelopeSize && buffers.EnvelopeBoundaries[envelopeIndex + 1] < position)
+      {
+        ++envelopeIndex;
+      }
+      const int offset = position - buffers.EnvelopePositions[envelopeIndex];
+      buffers.SquaredDistances[position] = squaredSpacing * offset * offset + buffers.EnvelopeValues[envelopeIndex];
+      buffers.NearestLabels[position] = buffers.EnvelopeLabels[envelopeIndex];
+    }
+    runBegin = runEnd;
+  }
+}
+
+//-----------------------------------------------------------------------------
+/// Set zero distance for boundary voxels: voxels of non-zero labels that have a neighbor (including diagonal neighbors)
+/// with a different label. This is the same boundary as used by itk::SignedMaurerDistanceMapImageFilter for a single label.
+void InitializeBoundaryDistances(const std::vector<unsigned short>& labels, const int dimensions[3], std::vector<float>& squaredDistances)
+{
+  const vtkIdType increments[3] = { 1, dimensions[0], static_cast<vtkIdType>(dimensions[0]) * dimensions[1] };
+  vtkSMPTools::For(0,
+                   dimensions[2],
+                   [&](vtkIdType beginZ, vtkIdType endZ)
+                   {
+                     for (int z = static_cast<int>(beginZ); z < static_cast<int>(endZ); ++z)
+                     {
+                       for (int y = 0; y < dimensions[1]; ++y)
+                       {
+                         for (int x = 0; x < dimensions[0]; ++x)
+                         {
+                           const vtkIdType voxelIndex = x * increments[0] + y * increments[1] + z * increments[2];
+                           const unsigned short label = labels[voxelIndex];
+                           if (label == 0)
+                           {
+                             continue;
+                           }
+                           bool boundary = false;
+                           for (int dz = std::max(z - 1, 0); dz <= std::min(z + 1, dimensions[2] - 1) && !boundary; ++dz)
+                           {
+                             for (int dy = std::max(y - 1, 0); dy <= std::min(y + 1, dimensions[1] - 1) && !boundary; ++dy)
+                             {
+                               for (int dx = std::max(x - 1, 0); dx <= std::min(x + 1, dimensions[0] - 1) && !boundary; ++dx)
+                               {
+                                 boundary = (labels[dx * increments[0] + dy * increments[1] + dz * increments[2]] != label);
+                               }
+                             }
+                           }
+                           if (boundary)
+                           {
+                             squaredDistances[voxelIndex] = 0.0f;
+                           }
+                         }
+                       }
+                     }
+                   });
+}
+
+//-----------------------------------------------------------------------------
+/// Compute the Euclidean distance of each voxel of a multi-label image from the nearest voxel that has a different label,
+/// and the label of that nearest voxel. All labels are processed at once, using separable exact distance transform
+/// along each axis. Voxels outside of the image are not considered.
+/// \param labels Label of each voxel
+/// \param insideDistanceToBoundary If set then the distance of voxels of non-zero labels is computed from the nearest
+///   boundary voxel of the same label instead (see InitializeBoundaryDistances), which is zero for boundary voxels.
+/// \param squaredDistances Squared distance of each voxel from the nearest voxel with a different label, in physical units.
+///   Infinity if all voxels have the same label.
+/// \param nearestLabels Label of the nearest voxel with a different label
+void ComputeMultiLabelDistanceTransform(const std::vector<unsigned short>& labels,
+                                        const int dimensions[3],
+                                        const double spacing[3],
+                                        bool insideDistanceToBoundary,
+                                        std::vector<float>& squaredDistances,
+                                        std::vector<unsigned short>& nearestLabels)
+{
+  const vtkIdType numberOfVoxels = static_cast<vtkIdType>(labels.size());
+  squaredDistances.assign(numberOfVoxels, std::numeric_limits<float>::infinity());
+  nearestLabels.assign(numberOfVoxels, 0);
+  if (insideDistanceToBoundary)
+  {
+    InitializeBoundaryDistances(labels, dimensions, squaredDistances);
+  }
+  const vtkIdType increments[3] = { 1, dimensions[0], static_cast<vtkIdType>(dimensions[0]) * dimensions[1] };
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    const int length = dimensions[axis];
+    if (length == 0)
+    {
+      return;
+    }
+    const vtkIdType stride = increments[axis];
+    const vtkIdType numberOfLines = numberOfVoxels / length;
+    const double squaredSpacing = spacing[axis] * spacing[axis];
+    vtkSMPThreadLocal<DistanceTransformLineBuffers> lineBuffers;
+    vtkSMPTools::For(0,
+                     numberOfLines,
+                     [&](vtkIdType beginLine, vtkIdType endLine)
+                     {
+                       DistanceTransformLineBuffers& buffers = lineBuffers.Local();
+                       buffers.Resize(length);
+                       for (vtkIdType lineIndex = beginLine; lineIndex < endLine; ++lineIndex)
+                       {
+                         // Index of the first voxel of the line: lines are ordered by the remaining axes
+                         const vtkIdType lineStart = (lineIndex / stride) * stride * length + lineIndex % stride;
+                         for (int position = 0; position < length; ++position)
+                         {
+                           const vtkIdType voxelIndex = lineStart + position * stride;
+                           buffers.Labels[position] = labels[voxelIndex];
+                           buffers.SquaredDistances[position] = squaredDistances[voxelIndex];
+                           buffers.NearestLabels[position] = nearestLabels[voxelIndex];
+                         }
+                         TransformLine(buffers, length, squaredSpacing, insideDistanceToBoundary);
+                         for (int position = 0; position < length; ++position)
+                         {
+                           const vtkIdType voxelIndex = lineStart + position * stride;
+                           squaredDistances[voxelIndex] = static_cast<float>(buffers.SquaredDistances[position]);
+                           nearestLabels[voxelIndex] = buffers.NearestLabels[position];
+                         }
+                       }
+                     });
+  }
+}
+
+//-----------------------------------------------------------------------------
+template <class T>
+void GetLabels(const T* voxels, vtkIdType numberOfVoxels, std::vector<unsigned short>& labels)
+{
+  labels.resize(numberOfVoxels);
+  vtkSMPTools::For(0,
+                   numberOfVoxels,
+                   [&](vtkIdType begin, vtkIdType end)
+                   {
+                     for (vtkIdType voxelIndex = begin; voxelIndex < end; ++voxelIndex)
+                     {
+                       labels[voxelIndex] = static_cast<unsigned short>(voxels[voxelIndex]);
+                     }
+                   });
+}
+
+//-----------------------------------------------------------------------------
+template <class T>
+void GetNonZeroVoxels(const T* voxels, vtkIdType numberOfVoxels, std::vector<unsigned char>& nonZero)
+{
+  nonZero.resize(numberOfVoxels);
+  vtkSMPTools::For(0,
+                   numberOfVoxels,
+                   [&](vtkIdType begin, vtkIdType end)
+                   {
+                     for (vtkIdType voxelIndex = begin; voxelIndex < end; ++voxelIndex)
+                     {
+                       nonZero[voxelIndex] = (voxels[voxelIndex] != 0);
+                     }
+                   });
+}
+
+//-----------------------------------------------------------------------------
+template <class T>
+void SetLabels(const std::vector<unsigned short>& labels, T* voxels)
+{
+  std::copy(labels.begin(), labels.end(), voxels);
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+bool vtkSlicerSegmentationsModuleLogic::ApplyMarginToSegments(vtkMRMLSegmentationNode* segmentationNode,
+                                                              vtkStringArray* segmentIDs,
+                                                              double innerMarginMm,
+                                                              double outerMarginMm,
+                                                              vtkOrientedImageData* referenceGeometry /*=nullptr*/,
+                                                              vtkOrientedImageData* editMask /*=nullptr*/,
+                                                              vtkStringArray* segmentIDsToOverwrite /*=nullptr*/)
+{
+  if (!segmentationNode || !segmentationNode->GetSegmentation())
+  {
+    vtkErrorWithObjectMacro(nullptr, "ApplyMarginToSegments: Invalid segmentation node");
+    return false;
+  }
+  if (innerMarginMm > outerMarginMm)
+  {
+    vtkErrorWithObjectMacro(nullptr, "ApplyMarginToSegments: Outer margin must be greater than inner margin");
+    return false;
+  }
+  vtkSegmentation* segmentation = segmentationNode->GetSegmentation();
+  std::vector<std::string> processedSegmentIDs;
+  if (segmentIDs && segmentIDs->GetNumberOfValues() > 0)
+  {
+    for (vtkIdType index = 0; index < segmentIDs->GetNumberOfValues(); ++index)
+    {
+      processedSegmentIDs.push_back(segmentIDs->GetValue(index));
+    }
+  }
+  else
+  {
+    segmentation->GetSegmentIDs(processedSegmentIDs);
+  }
+  if (processedSegmentIDs.empty())
+  {
+    return true;
+  }
+  if (processedSegmentIDs.size() > VTK_UNSIGNED_SHORT_MAX)
+  {
+    vtkErrorWithObjectMacro(nullptr, "ApplyMarginToSegments: Too many segments");
+    return false;
+  }
+  vtkNew<vtkStringArray> mergedSegmentIDs;
+  vtkNew<vtkIntArray> mergedLabelValues;
+  for (size_t segmentIndex = 0; segmentIndex < processedSegmentIDs.size(); ++segmentIndex)
+  {
+    if (!segmentation->GetSegment(processedSegmentIDs[segmentIndex]))
+    {
+      vtkErrorWithObjectMacro(nullptr, "ApplyMarginToSegments: Invalid segment " << processedSegmentIDs[segmentIndex]);
+      return false;
+    }
+    mergedSegmentIDs->InsertNextValue(processedSegmentIDs[segmentIndex]);
+    mergedLabelValues->InsertNextValue(static_cast<int>(segmentIndex) + 1);
+  }
+
+  // Merged labelmap of all segments in the reference geometry, label value of each segment is its index + 1
+  vtkNew<vtkOrientedImageData> mergedImage;
+  if (!segmentationNode->GenerateMergedLabelmapForAllSegments(mergedImage, vtkSegmentation::EXTENT_REFERENCE_GEOMETRY, referenceGeometry, mergedSegmentIDs, mergedLabelValues))
+  {
+    vtkErrorWithObjectMacro(nullptr, "ApplyMarginToSegments: Failed to generate merged labelmap");
+    return false;
+  }
+  const vtkIdType numberOfVoxels = mergedImage->GetNumberOfPoints();
+  if (numberOfVoxels == 0 || !mergedImage->GetScalarPointer())
+  {
+    return true;
+  }
+  std::vector<unsigned short> labels;
+  switch (mergedImage->GetScalarType())
+  {
+    vtkTemplateMacro(GetLabels(static_cast<VTK_TT*>(mergedImage->GetScalarPointer()), numberOfVoxels, labels));
+    default: vtkErrorWithObjectMacro(nullptr, "ApplyMarginToSegments: Unknown scalar type"); return false;
+  }
+
+  // Voxels where editing is not allowed
+  std::vector<unsigned char> lockedVoxels;
+  if (editMask && editMask->GetScalarPointer())
+  {
+    vtkNew<vtkOrientedImageData> alignedEditMask;
+    if (vtkOrientedImageDataResample::DoGeometriesMatch(editMask, mergedImage))
+    {
+      vtkOrientedImageDataResample::CopyImage(editMask, alignedEditMask, mergedImage->GetExtent());
+    }
+    else
+    {
+      vtkOrientedImageDataResample::ResampleOrientedImageToReferenceOrientedImage(editMask, mergedImage, alignedEditMask);
+    }
+    if (alignedEditMask->GetNumberOfPoints() != numberOfVoxels)
+    {
+      vtkErrorWithObjectMacro(nullptr, "ApplyMarginToSegments: Failed to align edit mask with the reference geometry");
+      return false;
+    }
+    switch (alignedEditMask->GetScalarType())
+    {
+      vtkTemplateMacro(GetNonZeroVoxels(static_cast<VTK_TT*>(alignedEditMask->GetScalarPointer()), numberOfVoxels, lockedVoxels));
+    }
+  }
+
+  // Distance of all voxels from the nearest voxel that has a different label, computed in one pass for all segments.
+  // The result is the same as of vtkITKImageMargin applied to each segment separately (as the Margin and Hollow effects
+  // do it for a single segment), except where segments would grow into each other.
+  // - Growing or shrinking (inner margin is negative infinity): segment voxels are kept if they are farther from
+  //   the nearest voxel outside the segment than the shrinking margin. This is how shrinking is computed in the
+  //   Margin effect, by growing the inverted segment.
+  // - Otherwise: the signed distance of segment voxels is the negative distance from the nearest boundary voxel of
+  //   the segment, as in itk::SignedMaurerDistanceMapImageFilter.
+  // Voxels that are not in any of the segments are added to the nearest segment if their distance is within the margins.
+  const bool shrinkOrGrow = !(innerMarginMm > -std::numeric_limits<double>::infinity());
+  std::vector<float> squaredDistances;
+  std::vector<unsigned short> nearestLabels;
+  ComputeMultiLabelDistanceTransform(labels, mergedImage->GetDimensions(), mergedImage->GetSpacing(), !shrinkOrGrow, squaredDistances, nearestLabels);
+
+  // Margins are compared to signed squared distances, as in vtkITKImageMargin. Voxels that are exactly at the margin distance
+  // are considered to be within the margin: tolerance is used so that this does not depend on rounding errors.
+  const double tolerance = 1e-5 * std::max(shrinkOrGrow ? 0.0 : std::abs(innerMarginMm), std::abs(outerMarginMm));
+  const double innerMargin = innerMarginMm - tolerance;
+  const double outerMargin = outerMarginMm + tolerance;
+  const double innerMarginSquared = innerMargin * std::abs(innerMargin);
+  const double outerMarginSquared = outerMargin * std::abs(outerMargin);
+  // shrinking is growing the inverted segment
+  const double shrinkMargin = -outerMarginMm + tolerance;
+  std::vector<unsigned char> addedVoxels(numberOfVoxels, 0);
+  vtkSMPTools::For(0,
+                   numberOfVoxels,
+                   [&](vtkIdType begin, vtkIdType end)
+                   {
+                     for (vtkIdType voxelIndex = begin; voxelIndex < end; ++voxelIndex)
+                     {
+                       if (!lockedVoxels.empty() && lockedVoxels[voxelIndex])
+                       {
+                         continue;
+                       }
+                       const double squaredDistance = squaredDistances[voxelIndex];
+                       if (labels[voxelIndex] != 0)
+                       {
+                         const bool keep = shrinkOrGrow ? (outerMarginMm >= 0.0 || squaredDistance > shrinkMargin * shrinkMargin) //
+                                                        : (-squaredDistance >= innerMarginSquared && -squaredDistance <= outerMarginSquared);
+                         if (!keep)
+                         {
+                           labels[voxelIndex] = 0;
+                         }
+                       }
+                       else if (nearestLabels[voxelIndex] != 0 && squaredDistance >= innerMarginSquared && squaredDistance <= outerMarginSquared)
+                       {
+                         labels[voxelIndex] = nearestLabels[voxelIndex];
+                         addedVoxels[voxelIndex] = 1;
+                       }
+                     }
+                   });
+  squaredDistances.clear();
+  squaredDistances.shrink_to_fit();
+  nearestLabels.clear();
+  nearestLabels.shrink_to_fit();
+
+  vtkSmartPointer<vtkOrientedImageData> resultImage = vtkSmartPointer<vtkOrientedImageData>::New();
+  resultImage->SetExtent(mergedImage->GetExtent());
+  resultImage->AllocateScalars(processedSegmentIDs.size() <= VTK_UNSIGNED_CHAR_MAX ? VTK_UNSIGNED_CHAR : VTK_UNSIGNED_SHORT, 1);
+  switch (resultImage->GetScalarType())
+  {
+    vtkTemplateMacro(SetLabels(labels, static_cast<VTK_TT*>(resultImage->GetScalarPointer())));
+  }
+  vtkNew<vtkMatrix4x4> imageToWorldMatrix;
+  mergedImage->GetImageToWorldMatrix(imageToWorldMatrix);
+  resultImage->SetGeometryFromImageToWorldMatrix(imageToWorldMatrix);
+
+  MRMLNodeModifyBlocker blocker(segmentationNode);
+  bool wasSourceRepresentationModifiedEnabled = segmentation->SetSourceRepresentationModifiedEnabled(false);
+
+  // Remove added voxels from segments that may be overwritten
+  std::vector<std::string> modifiedSegmentIDs = processedSegmentIDs;
+  if (segmentIDsToOverwrite && segmentIDsToOverwrite->GetNumberOfValues() > 0)
+  {
+    vtkNew<vtkOrientedImageData> addedVoxelsImage;
+    addedVoxelsImage->SetExtent(mergedImage->GetExtent());
+    addedVoxelsImage->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+    std::copy(addedVoxels.begin(), addedVoxels.end(), static_cast<unsigned char*>(addedVoxelsImage->GetScalarPointer()));
+    addedVoxelsImage->SetGeometryFromImageToWorldMatrix(imageToWorldMatrix);
+    EraseOverwrittenSegments(segmentation, segmentIDsToOverwrite, processedSegmentIDs, addedVoxelsImage, modifiedSegmentIDs);
+  }
+
+  vtkOrientedImageData* targetLayer = SetSegmentsToSharedLabelmap(segmentation, processedSegmentIDs, resultImage);
+  segmentation->SetSourceRepresentationModifiedEnabled(wasSourceRepresentationModifiedEnabled);
+
+  vtkSlicerSegmentationsModuleLogic::ReconvertAllRepresentations(segmentationNode, modifiedSegmentIDs);
+  segmentation->InvokeEvent(vtkSegmentation::SourceRepresentationModified, targetLayer);
+  segmentation->InvokeEvent(vtkSegmentation::RepresentationModified, nullptr);
+  return true;
+}
+
 //-----------------------------------------------------------------------------
 bool vtkSlicerSegmentationsModuleLogic::GetSharedSegmentIDsInMask(vtkMRMLSegmentationNode* segmentationNode,
                                                                   std::string sharedSegmentID,
@@ -482,6 +482,64 @@ public:
   /// Clear the contents of a single segment
   static bool ClearSegment(vtkMRMLSegmentationNode* segmentationNode, std::string segmentID);
 
+  /// Split a segment into its connected components (islands).
+  /// All islands are labeled in a single pass over the binary labelmap and written directly into the shared labelmap layer
+  /// of the segment, with a single source representation modified event for the whole operation.
+  /// Islands are ordered by decreasing size. The largest island is kept in the original segment.
+  /// \param segmentationNode Node containing the segmentation
+  /// \param segmentID Segment to split
+  /// \param minimumSize Islands smaller than this number of voxels are removed. If 0 then all islands are kept.
+  /// \param maxNumberOfSegments Only this many of the largest islands are kept. If 0 then all islands are kept.
+  /// \param split If true then each island except the largest is moved to a new segment in the same labelmap layer,
+  ///   named after the original segment. If false then all kept islands remain in the original segment.
+  /// \param fullyConnected If true then voxels that share only an edge or corner are connected, too.
+  /// \param segmentIDsToOverwrite Segments in other labelmap layers that are removed from voxels of the kept islands.
+  /// \param createdSegmentIDs Optional output list of IDs of the created segments.
+  /// \return True on success, False otherwise
+  static bool SplitSegmentIntoIslands(vtkMRMLSegmentationNode* segmentationNode,
+                                      std::string segmentID,
+                                      int minimumSize = 0,
+                                      int maxNumberOfSegments = 0,
+                                      bool split = true,
+                                      bool fullyConnected = false,
+                                      vtkStringArray* segmentIDsToOverwrite = nullptr,
+                                      vtkStringArray* createdSegmentIDs = nullptr);
+
+  /// Smooth multiple segments jointly, so that no gaps or overlaps appear between neighboring segments.
+  /// Surfaces of all segments are extracted from a single merged labelmap and smoothed together, then all smoothed
+  /// surfaces are rasterized in a single pass into one labelmap layer that all the smoothed segments share afterwards.
+  /// Smoothed segments are removed from their previous layers; other segments in those layers are not changed.
+  /// Masking settings of the segment editor are not applied.
+  /// \param segmentationNode Node containing the segmentation
+  /// \param segmentIDs Segments to smooth. If empty then all segments are smoothed.
+  /// \param smoothingFactor Strength of smoothing, between 0 (weakest) and 1 (strongest).
+  /// \return True on success, False otherwise
+  static bool JointSmoothSegments(vtkMRMLSegmentationNode* segmentationNode, vtkStringArray* segmentIDs, double smoothingFactor);
+
+  /// Apply margin to multiple segments at once (grow, shrink, or hollow).
+  /// Signed distance of each voxel from each segment is computed for all segments in a single distance transform.
+  /// The result is the same as applying vtkITKImageMargin to each segment separately, as the Margin and Hollow
+  /// effects do for a single segment, except that empty voxels that are within the margins of several segments
+  /// are added to the nearest segment.
+  /// Processed segments are stored in one labelmap layer that they share afterwards.
+  /// \param segmentationNode Node containing the segmentation
+  /// \param segmentIDs Segments to process. If empty then all segments are processed.
+  /// \param innerMarginMm Inner margin. Use negative infinity to grow or shrink segments. Otherwise voxels are kept where
+  ///   the signed distance is between the inner and outer margins (negative inside segments, zero at their boundary voxels).
+  /// \param outerMarginMm Outer margin. Positive value grows segments. Negative value shrinks segments (if the inner margin
+  ///   is negative infinity): voxels are removed that are not farther from the outside of the segment than the margin.
+  /// \param referenceGeometry Geometry of the processed labelmap. If not specified then the reference geometry of the segmentation is used.
+  /// \param editMask Voxels where the mask is non-zero are not modified.
+  /// \param segmentIDsToOverwrite Segments that are removed from voxels that are added to processed segments.
+  /// \return True on success, False otherwise
+  static bool ApplyMarginToSegments(vtkMRMLSegmentationNode* segmentationNode,
+                                    vtkStringArray* segmentIDs,
+                                    double innerMarginMm,
+                                    double outerMarginMm,
+                                    vtkOrientedImageData* referenceGeometry = nullptr,
+                                    vtkOrientedImageData* editMask = nullptr,
+                                    vtkStringArray* segmentIDsToOverwrite = nullptr);
+
   /// Get the list of segment IDs in the same shared labelmap that are contained within the mask
   /// \param segmentationNode Node containing the segmentation
   /// \param sharedSegmentID Segment ID of the segment that contains the shared labelmap to be checked
@@ -40,7 +40,10 @@ class SegmentationsModuleTest2(unittest.TestCase):
         self.TestSection_SetupScene()
         self.TestSection_SharedLabelmapMultipleLayerEditing()
         self.TestSection_IslandEffects()
+        self.TestSection_SplitSegmentIntoIslands()
         self.TestSection_MarginEffects()
+        self.TestSection_ApplyMarginToSegments()
+        self.TestSection_JointSmoothSegments()
         self.TestSection_MaskingSettings()
         self.TestSection_GrowFromSeedsEffect()
         logging.info("Test finished")
@@ -253,6 +256,126 @@ class SegmentationsModuleTest2(unittest.TestCase):
         labelmap.AllocateScalars(vtk.VTK_UNSIGNED_CHAR, 1)
         labelmap.GetPointData().GetScalars().Fill(value)
 
+    # ------------------------------------------------------------------------------
+    def TestSection_SplitSegmentIntoIslands(self):
+        """Check that splitting a segment into islands gives the same islands as vtkITKIslandMath."""
+        logging.info("Running test on splitting segment into islands")
+        import numpy as np
+
+        volumeNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLScalarVolumeNode")
+        slicer.util.updateVolumeFromArray(volumeNode, np.zeros([20, 30, 40], np.uint8))
+        volumeNode.SetSpacing(1.0, 1.5, 2.0)
+
+        # Islands of different sizes, so that their order is well defined.
+        # Box C touches box B only at a corner, therefore they are one island only if fully connected.
+        # Arms of the U shape are connected only through the next slice.
+        segmentArray = np.zeros([20, 30, 40], np.uint8)
+        segmentArray[2:6, 2:8, 2:10] = 1  # A: 192 voxels
+        segmentArray[2:5, 2:7, 12:18] = 1  # B: 90 voxels
+        segmentArray[5:7, 7:10, 18:22] = 1  # C: 24 voxels
+        segmentArray[10, 15:17, 25:28] = 1  # D: 6 voxels
+        segmentArray[15, 25, 35] = 1  # E: 1 voxel
+        segmentArray[12, 20, 5:15] = 1  # L shape with a column: 22 voxels
+        segmentArray[12, 21:28, 5] = 1
+        segmentArray[13:18, 20, 14] = 1
+        segmentArray[2, 2:9, 30] = 1  # U shape: 21 voxels
+        segmentArray[2, 2:9, 36] = 1
+        segmentArray[3, 8, 30:37] = 1
+
+        for fullyConnected in [False, True]:
+            # Split islands to segments
+            self.checkSplitSegmentIntoIslands(segmentArray, volumeNode, fullyConnected, minimumSize=5, maxNumberOfSegments=0, split=True)
+            # Keep largest island
+            self.checkSplitSegmentIntoIslands(segmentArray, volumeNode, fullyConnected, minimumSize=0, maxNumberOfSegments=1, split=True)
+            # Remove small islands
+            self.checkSplitSegmentIntoIslands(segmentArray, volumeNode, fullyConnected, minimumSize=20, maxNumberOfSegments=0, split=False)
+
+        # Kept islands are removed from segments to overwrite in other layers, removed islands are not
+        overlapArray = np.zeros([20, 30, 40], np.uint8)
+        overlapArray[4:8, 6:10, 6:12] = 1  # overlaps island A
+        overlapArray[15, 24:27, 34:37] = 1  # overlaps island E
+        splitSegmentID, overlapSegmentID = self.addSegmentsInSeparateLayers([segmentArray, overlapArray], volumeNode)
+        self.assertEqual(self.segmentation.GetNumberOfLayers(), 2)
+        segmentIDsToOverwrite = vtk.vtkStringArray()
+        segmentIDsToOverwrite.InsertNextValue(splitSegmentID)
+        segmentIDsToOverwrite.InsertNextValue(overlapSegmentID)
+        self.assertTrue(slicer.vtkSlicerSegmentationsModuleLogic.SplitSegmentIntoIslands(
+            self.segmentationNode, splitSegmentID, 5, 0, True, False, segmentIDsToOverwrite))
+        keptIslandsArray = self.islandMathArray(segmentArray, volumeNode, False, 5) != 0
+        expectedOverlapArray = (overlapArray != 0) & ~keptIslandsArray
+        overlapResultArray = slicer.util.arrayFromSegmentBinaryLabelmap(self.segmentationNode, overlapSegmentID, volumeNode) != 0
+        self.assertEqual(np.count_nonzero(overlapResultArray != expectedOverlapArray), 0)
+        self.assertTrue(overlapResultArray[15, 25, 35])
+
+        self.segmentation.RemoveAllSegments()
+        slicer.mrmlScene.RemoveNode(volumeNode)
+
+    # ------------------------------------------------------------------------------
+    def checkSplitSegmentIntoIslands(self, segmentArray, volumeNode, fullyConnected, minimumSize, maxNumberOfSegments, split):
+        import numpy as np
+
+        # Islands are labeled in decreasing order of size
+        islandArray = self.islandMathArray(segmentArray, volumeNode, fullyConnected, minimumSize)
+        numberOfIslands = islandArray.max()
+        if maxNumberOfSegments > 0:
+            numberOfIslands = min(numberOfIslands, maxNumberOfSegments)
+        if split:
+            expectedArrays = [islandArray == label for label in range(1, numberOfIslands + 1)]
+        else:
+            expectedArrays = [(islandArray > 0) & (islandArray <= numberOfIslands)]
+
+        (segmentID,) = self.addSegmentsInSeparateLayers([segmentArray], volumeNode)
+        createdSegmentIDs = vtk.vtkStringArray()
+        self.assertTrue(slicer.vtkSlicerSegmentationsModuleLogic.SplitSegmentIntoIslands(
+            self.segmentationNode, segmentID, minimumSize, maxNumberOfSegments, split, fullyConnected, None, createdSegmentIDs))
+        self.assertEqual(createdSegmentIDs.GetNumberOfValues(), len(expectedArrays) - 1)
+        self.assertEqual(self.segmentation.GetNumberOfLayers(), 1)
+
+        resultSegmentIDs = [segmentID] + [createdSegmentIDs.GetValue(index) for index in range(createdSegmentIDs.GetNumberOfValues())]
+        for islandIndex, resultSegmentID in enumerate(resultSegmentIDs):
+            resultArray = slicer.util.arrayFromSegmentBinaryLabelmap(self.segmentationNode, resultSegmentID, volumeNode) != 0
+            differentVoxelCount = np.count_nonzero(resultArray != expectedArrays[islandIndex])
+            self.assertEqual(differentVoxelCount, 0,
+                             f"Island {islandIndex + 1} differs in {differentVoxelCount} voxels "
+                             f"(fully connected: {fullyConnected}, minimum size: {minimumSize}, "
+                             f"maximum number of segments: {maxNumberOfSegments}, split: {split})")
+
+    # ------------------------------------------------------------------------------
+    def islandMathArray(self, segmentArray, volumeNode, fullyConnected, minimumSize):
+        import vtkITK
+        from vtk.util import numpy_support
+
+        image = vtk.vtkImageData()
+        image.SetDimensions(segmentArray.shape[2], segmentArray.shape[1], segmentArray.shape[0])
+        image.SetSpacing(volumeNode.GetSpacing())
+        image.GetPointData().SetScalars(numpy_support.numpy_to_vtk(segmentArray.ravel(), deep=True))
+        castIn = vtk.vtkImageCast()
+        castIn.SetInputData(image)
+        castIn.SetOutputScalarTypeToUnsignedInt()
+        islandMath = vtkITK.vtkITKIslandMath()
+        islandMath.SetInputConnection(castIn.GetOutputPort())
+        islandMath.SetFullyConnected(fullyConnected)
+        islandMath.SetMinimumSize(minimumSize)
+        islandMath.Update()
+        return numpy_support.vtk_to_numpy(islandMath.GetOutput().GetPointData().GetScalars()).reshape(segmentArray.shape)
+
+    # ------------------------------------------------------------------------------
+    def addSegmentsInSeparateLayers(self, segmentArrays, volumeNode):
+        # Replace all segments by segments that each have their own labelmap layer
+        self.segmentation.RemoveAllSegments()
+        labelmapVolumeNode = slicer.modules.volumes.logic().CreateAndAddLabelVolume(volumeNode, "__temp__")
+        segmentIDs = []
+        for segmentIndex, segmentArray in enumerate(segmentArrays):
+            slicer.util.updateVolumeFromArray(labelmapVolumeNode, segmentArray)
+            labelmap = slicer.vtkSlicerSegmentationsModuleLogic.CreateOrientedImageDataFromVolumeNode(labelmapVolumeNode)
+            segment = slicer.vtkSegment()
+            segment.SetName(f"Segment_{segmentIndex + 1}")
+            segment.AddRepresentation(self.binaryLabelmapReprName, labelmap)
+            self.segmentation.AddSegment(segment)
+            segmentIDs.append(self.segmentation.GetSegmentIdBySegment(segment))
+        slicer.mrmlScene.RemoveNode(labelmapVolumeNode)
+        return segmentIDs
+
     # ------------------------------------------------------------------------------
     def TestSection_MarginEffects(self):
         logging.info("Running test on margin effect")
@@ -364,6 +487,197 @@ class SegmentationsModuleTest2(unittest.TestCase):
 
         self.segmentEditorNode.SetOverwriteMode(oldOverwriteMode)
 
+    # ------------------------------------------------------------------------------
+    def TestSection_ApplyMarginToSegments(self):
+        """Check that processing multiple segments at once gives the same result as processing them one by one."""
+        logging.info("Running test on applying margin to multiple segments")
+        import numpy as np
+
+        # Anisotropic spacing. Margins are chosen so that no voxel is exactly at the margin distance.
+        spacing = [1.0, 1.5, 2.0]
+        volumeNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLScalarVolumeNode")
+        slicer.util.updateVolumeFromArray(volumeNode, np.zeros([25, 30, 40], np.uint8))
+        volumeNode.SetSpacing(spacing)
+        referenceGeometry = slicer.vtkSlicerSegmentationsModuleLogic.CreateOrientedImageDataFromVolumeNode(volumeNode)
+
+        # Segments are far enough from each other and from the image boundary so that their margins do not overlap
+        k, j, i = np.indices([25, 30, 40])
+        segmentArrays = [
+            (((i - 10) / 6.0) ** 2 + ((j - 10) / 4.0) ** 2 + ((k - 8) / 3.0) ** 2 <= 1.0).astype(np.uint8),
+            ((i >= 24) & (i <= 33) & (j >= 4) & (j <= 12) & (k >= 4) & (k <= 12)).astype(np.uint8),
+        ]
+        self.segmentation.RemoveAllSegments()
+        segmentIDs = vtk.vtkStringArray()
+        for segmentIndex in range(len(segmentArrays)):
+            segmentIDs.InsertNextValue(self.segmentation.AddEmptySegment(f"Segment_{segmentIndex + 1}"))
+
+        for marginSizeMM in [1.35, 2.45, -1.35, -1.85]:
+            self.checkApplyMarginToSegments(segmentArrays, segmentIDs, volumeNode, referenceGeometry, None, marginSizeMM, marginSizeMM < 0)
+
+        hollowEffect = slicer.modules.segmenteditor.widgetRepresentation().self().editor.effectByName("Hollow")
+        for shellMode in ["INSIDE_SURFACE", "MEDIAL_SURFACE", "OUTSIDE_SURFACE"]:
+            for shellThicknessMM in [1.35, 1.85, 2.45]:
+                hollowEffect.setParameter("ShellMode", shellMode)
+                hollowEffect.setParameter("ShellThicknessMm", shellThicknessMM)
+                innerMarginMM, outerMarginMM = hollowEffect.self().getShellMarginsMM(spacing)
+                self.checkApplyMarginToSegments(segmentArrays, segmentIDs, volumeNode, referenceGeometry, innerMarginMM, outerMarginMM, False)
+
+        # Touching segments do not interact when they are shrunk
+        segmentArrays.append(((i >= 24) & (i <= 33) & (j >= 13) & (j <= 22) & (k >= 4) & (k <= 12)).astype(np.uint8))
+        segmentIDs.InsertNextValue(self.segmentation.AddEmptySegment(f"Segment_{len(segmentArrays)}"))
+        for marginSizeMM in [-1.35, -2.45]:
+            self.checkApplyMarginToSegments(segmentArrays, segmentIDs, volumeNode, referenceGeometry, None, marginSizeMM, True)
+
+        self.segmentation.RemoveAllSegments()
+        slicer.mrmlScene.RemoveNode(volumeNode)
+
+    # ------------------------------------------------------------------------------
+    def checkApplyMarginToSegments(self, segmentArrays, segmentIDs, volumeNode, referenceGeometry, innerMarginMM, outerMarginMM, shrink):
+        import numpy as np
+        import vtkITK
+        from vtk.util import numpy_support
+
+        # Compute the expected result for each segment, the same way as the Margin and Hollow effects do
+        expectedArrays = []
+        for segmentArray in segmentArrays:
+            image = vtk.vtkImageData()
+            image.SetDimensions(segmentArray.shape[2], segmentArray.shape[1], segmentArray.shape[0])
+            image.SetSpacing(volumeNode.GetSpacing())
+            inputArray = (segmentArray == 0) if shrink else (segmentArray != 0)
+            image.GetPointData().SetScalars(numpy_support.numpy_to_vtk(inputArray.astype(np.uint8).ravel(), deep=True))
+            margin = vtkITK.vtkITKImageMargin()
+            margin.SetInputData(image)
+            margin.CalculateMarginInMMOn()
+            if innerMarginMM is not None:
+                margin.SetInnerMarginMM(innerMarginMM)
+            margin.SetOuterMarginMM(abs(outerMarginMM) if shrink else outerMarginMM)
+            margin.Update()
+            resultArray = numpy_support.vtk_to_numpy(margin.GetOutput().GetPointData().GetScalars()).reshape(segmentArray.shape) != 0
+            expectedArrays.append(~resultArray if shrink else resultArray)
+
+        for segmentIndex in range(len(segmentArrays)):
+            slicer.util.updateSegmentBinaryLabelmapFromArray(segmentArrays[segmentIndex], self.segmentationNode, segmentIDs.GetValue(segmentIndex), volumeNode)
+        self.assertTrue(slicer.vtkSlicerSegmentationsModuleLogic.ApplyMarginToSegments(
+            self.segmentationNode, segmentIDs, -np.inf if innerMarginMM is None else innerMarginMM, outerMarginMM, referenceGeometry))
+
+        for segmentIndex in range(len(segmentArrays)):
+            resultArray = slicer.util.arrayFromSegmentBinaryLabelmap(self.segmentationNode, segmentIDs.GetValue(segmentIndex), volumeNode) != 0
+            self.assertTrue(expectedArrays[segmentIndex].any())
+            differentVoxelCount = np.count_nonzero(resultArray != expectedArrays[segmentIndex])
+            self.assertEqual(differentVoxelCount, 0,
+                             f"Segment {segmentIndex + 1} differs in {differentVoxelCount} voxels (margins: {innerMarginMM}, {outerMarginMM})")
+
+    # ------------------------------------------------------------------------------
+    def TestSection_JointSmoothSegments(self):
+        """Check that joint smoothing gives the same result as rasterizing each smoothed surface with a stencil."""
+        logging.info("Running test on joint smoothing of segments")
+        import numpy as np
+        from vtk.util import numpy_support
+
+        volumeNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLScalarVolumeNode")
+        slicer.util.updateVolumeFromArray(volumeNode, np.zeros([25, 30, 40], np.uint8))
+        volumeNode.SetSpacing(1.0, 1.5, 2.0)
+
+        # Touching boxes share a boundary that is smoothed jointly
+        k, j, i = np.indices([25, 30, 40])
+        segmentArrays = [
+            (((i - 12) / 7.0) ** 2 + ((j - 12) / 5.0) ** 2 + ((k - 10) / 4.0) ** 2 <= 1.0).astype(np.uint8),
+            ((i >= 24) & (i <= 33) & (j >= 4) & (j <= 12) & (k >= 4) & (k <= 14)).astype(np.uint8),
+            ((i >= 24) & (i <= 33) & (j >= 13) & (j <= 22) & (k >= 4) & (k <= 14)).astype(np.uint8),
+        ]
+        self.segmentation.RemoveAllSegments()
+        segmentIDs = vtk.vtkStringArray()
+        for segmentIndex, segmentArray in enumerate(segmentArrays):
+            segmentID = self.segmentation.AddEmptySegment(f"Segment_{segmentIndex + 1}")
+            slicer.util.updateSegmentBinaryLabelmapFromArray(segmentArray, self.segmentationNode, segmentID, volumeNode)
+            segmentIDs.InsertNextValue(segmentID)
+
+        for smoothingFactor in [0.2, 0.5]:
+            mergedImage = slicer.vtkOrientedImageData()
+            self.assertTrue(self.segmentationNode.GenerateMergedLabelmapForAllSegments(
+                mergedImage, vtkSegmentationCore.vtkSegmentation.EXTENT_UNION_OF_SEGMENTS_PADDED, None, segmentIDs))
+            expectedArray = self.jointSmoothingStencilArray(mergedImage, segmentIDs.GetNumberOfValues(), smoothingFactor)
+
+            self.assertTrue(slicer.vtkSlicerSegmentationsModuleLogic.JointSmoothSegments(self.segmentationNode, segmentIDs, smoothingFactor))
+            self.assertEqual(self.segmentation.GetNumberOfLayers(), 1)
+
+            for segmentIndex in range(segmentIDs.GetNumberOfValues()):
+                segment = self.segmentation.GetSegment(segmentIDs.GetValue(segmentIndex))
+                resultImage = slicer.vtkOrientedImageData()
+                vtkSegmentationCore.vtkOrientedImageDataResample.ResampleOrientedImageToReferenceOrientedImage(
+                    segment.GetRepresentation(self.binaryLabelmapReprName), mergedImage, resultImage)
+                resultArray = numpy_support.vtk_to_numpy(resultImage.GetPointData().GetScalars()).reshape(expectedArray.shape) == segment.GetLabelValue()
+                expectedSegmentArray = expectedArray == segmentIndex + 1
+                self.assertTrue(expectedSegmentArray.any())
+                # Rasterization rules differ only for voxel centers that are exactly on the surface
+                differentVoxelCount = np.count_nonzero(resultArray != expectedSegmentArray)
+                self.assertLessEqual(differentVoxelCount, np.count_nonzero(expectedSegmentArray) // 200,
+                                     f"Segment {segmentIndex + 1} differs in {differentVoxelCount} voxels (smoothing factor: {smoothingFactor})")
+
+        self.segmentation.RemoveAllSegments()
+        slicer.mrmlScene.RemoveNode(volumeNode)
+
+    # ------------------------------------------------------------------------------
+    def jointSmoothingStencilArray(self, mergedImage, numberOfSegments, smoothingFactor):
+        """Smooth the merged labelmap and rasterize each smoothed surface with a stencil, as the Smoothing effect did
+        before the single-pass rasterization. Where surfaces overlap, the segment that is processed later is kept.
+        """
+        from vtk.util import numpy_support
+
+        ici = vtk.vtkImageChangeInformation()
+        ici.SetInputData(mergedImage)
+        ici.SetOutputSpacing(1, 1, 1)
+        ici.SetOutputOrigin(0, 0, 0)
+
+        convertToPolyData = vtk.vtkDiscreteMarchingCubes()
+        convertToPolyData.SetInputConnection(ici.GetOutputPort())
+        convertToPolyData.SetNumberOfContours(numberOfSegments)
+        for contourIndex in range(numberOfSegments):
+            convertToPolyData.SetValue(contourIndex, contourIndex + 1)
+
+        smoother = vtk.vtkWindowedSincPolyDataFilter()
+        smoother.SetInputConnection(convertToPolyData.GetOutputPort())
+        smoother.SetNumberOfIterations(100)
+        smoother.BoundarySmoothingOff()
+        smoother.FeatureEdgeSmoothingOff()
+        smoother.SetFeatureAngle(90.0)
+        smoother.SetPassBand(pow(10.0, -4.0 * smoothingFactor))
+        smoother.NonManifoldSmoothingOn()
+        smoother.NormalizeCoordinatesOn()
+
+        threshold = vtk.vtkThreshold()
+        threshold.SetInputConnection(smoother.GetOutputPort())
+        geometryFilter = vtk.vtkGeometryFilter()
+        geometryFilter.SetInputConnection(threshold.GetOutputPort())
+
+        polyDataToImageStencil = vtk.vtkPolyDataToImageStencil()
+        polyDataToImageStencil.SetInputConnection(geometryFilter.GetOutputPort())
+        polyDataToImageStencil.SetOutputSpacing(1, 1, 1)
+        polyDataToImageStencil.SetOutputOrigin(0, 0, 0)
+        polyDataToImageStencil.SetOutputWholeExtent(mergedImage.GetExtent())
+
+        stencil = vtk.vtkImageStencil()
+        emptyBinaryLabelMap = vtk.vtkImageData()
+        emptyBinaryLabelMap.SetExtent(mergedImage.GetExtent())
+        emptyBinaryLabelMap.AllocateScalars(vtk.VTK_UNSIGNED_CHAR, 1)
+        vtkSegmentationCore.vtkOrientedImageDataResample.FillImage(emptyBinaryLabelMap, 0)
+        stencil.SetInputData(emptyBinaryLabelMap)
+        stencil.SetStencilConnection(polyDataToImageStencil.GetOutputPort())
+        stencil.ReverseStencilOn()
+        stencil.SetBackgroundValue(1)
+
+        dimensions = mergedImage.GetDimensions()
+        shape = (dimensions[2], dimensions[1], dimensions[0])
+        labelArray = numpy_support.vtk_to_numpy(emptyBinaryLabelMap.GetPointData().GetScalars()).reshape(shape).copy()
+        for labelValue in range(1, numberOfSegments + 1):
+            threshold.SetLowerThreshold(labelValue)
+            threshold.SetUpperThreshold(labelValue)
+            threshold.SetThresholdFunction(vtk.vtkThreshold.THRESHOLD_BETWEEN)
+            stencil.Update()
+            stencilArray = numpy_support.vtk_to_numpy(stencil.GetOutput().GetPointData().GetScalars()).reshape(shape)
+            labelArray[stencilArray != 0] = labelValue
+        return labelArray
+
     # ------------------------------------------------------------------------------
     def TestSection_MaskingSettings(self):
         self.segmentation.RemoveAllSegments()
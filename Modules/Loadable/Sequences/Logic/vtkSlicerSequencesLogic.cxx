@@ -37,6 +37,8 @@
 #include "vtkMRMLModelNode.h"
 #include "vtkMRMLScalarVolumeNode.h"
 #include "vtkMRMLScene.h"
+#include "vtkMRMLStreamingVolumeDecodeCache.h"
+#include "vtkMRMLStreamingVolumeNode.h"
 #include "vtkMRMLTransformNode.h"
 #ifdef ENABLE_PERFORMANCE_PROFILING
 # include "vtkTimerLog.h"
@@ -62,7 +64,12 @@ vtkStandardNewMacro(vtkSlicerSequencesLogic);
 vtkSlicerSequencesLogic::vtkSlicerSequencesLogic() = default;
 
 //----------------------------------------------------------------------------
-vtkSlicerSequencesLogic::~vtkSlicerSequencesLogic() = default;
+vtkSlicerSequencesLogic::~vtkSlicerSequencesLogic()
+{
+  // Join prefetch worker threads now instead of when the cache singleton is destroyed at exit
+  vtkMRMLStreamingVolumeDecodeCache::GetInstance()->Clear();
+  vtkMRMLStreamingVolumeDecodeCache::GetInstance()->StopWorkerThreads();
+}
 
 //----------------------------------------------------------------------------
 void vtkSlicerSequencesLogic::PrintSelf(ostream& os, vtkIndent indent)
@@ -77,6 +84,7 @@ void vtkSlicerSequencesLogic::SetMRMLSceneInternal(vtkMRMLScene* newScene)
   events->InsertNextValue(vtkMRMLScene::NodeAddedEvent);
   events->InsertNextValue(vtkMRMLScene::NodeRemovedEvent);
   events->InsertNextValue(vtkMRMLScene::EndBatchProcessEvent);
+  events->InsertNextValue(vtkMRMLScene::EndCloseEvent);
   this->SetAndObserveMRMLSceneEventsInternal(newScene, events.GetPointer());
 }
 
@@ -134,9 +142,39 @@ void vtkSlicerSequencesLogic::OnMRMLSceneNodeRemoved(vtkMRMLNode* node)
   {
     vtkDebugMacro("OnMRMLSceneNodeRemoved: Have a vtkMRMLSequenceBrowserNode node");
     vtkUnObserveMRMLNodeMacro(node);
+    this->LastProxyUpdateItemNumber.erase(vtkMRMLSequenceBrowserNode::SafeDownCast(node));
+  }
+  // Release decoded images of the frames of the removed node, decoded images of other nodes are kept
+  vtkMRMLStreamingVolumeDecodeCache* decodeCache = vtkMRMLStreamingVolumeDecodeCache::GetInstance();
+  vtkMRMLStreamingVolumeNode* streamingVolumeNode = vtkMRMLStreamingVolumeNode::SafeDownCast(node);
+  if (streamingVolumeNode)
+  {
+    decodeCache->RemoveFrame(streamingVolumeNode->GetFrame());
+  }
+  vtkMRMLSequenceNode* sequenceNode = vtkMRMLSequenceNode::SafeDownCast(node);
+  if (sequenceNode)
+  {
+    int numberOfDataNodes = sequenceNode->GetNumberOfDataNodes();
+    for (int dataNodeIndex = 0; dataNodeIndex < numberOfDataNodes; ++dataNodeIndex)
+    {
+      streamingVolumeNode = vtkMRMLStreamingVolumeNode::SafeDownCast(sequenceNode->GetNthDataNode(dataNodeIndex));
+      if (streamingVolumeNode)
+      {
+        decodeCache->RemoveFrame(streamingVolumeNode->GetFrame());
+      }
+    }
   }
 }
 
+//---------------------------------------------------------------------------
+void vtkSlicerSequencesLogic::OnMRMLSceneEndClose()
+{
+  this->LastProxyUpdateItemNumber.clear();
+  vtkMRMLStreamingVolumeDecodeCache* decodeCache = vtkMRMLStreamingVolumeDecodeCache::GetInstance();
+  decodeCache->Clear();
+  decodeCache->StopWorkerThreads();
+}
+
 //----------------------------------------------------------------------------
 vtkMRMLSequenceNode* vtkSlicerSequencesLogic::AddSequence(const char* filename, vtkMRMLMessageCollection* userMessages /*=nullptr*/)
 {
@@ -250,6 +288,11 @@ void vtkSlicerSequencesLogic::UpdateAllProxyNodes()
       vtkErrorMacro("Browser node is invalid");
       continue;
     }
+    if (browserNode->GetNumberOfBufferedRecordedFrames() > 0)
+    {
+      // Add frames that were recorded since the last update to the sequences
+      browserNode->CommitRecordedFrames();
+    }
     if (!browserNode->GetPlaybackActive())
     {
       this->LastSequenceBrowserUpdateTimeSec.erase(browserNode);
@@ -561,6 +604,12 @@ void vtkSlicerSequencesLogic::UpdateProxyNodesFromSequences(vtkMRMLSequenceBrows
 
   this->UpdateProxyNodesFromSequencesInProgress.erase(browserNode);
 
+  if (browserNode->GetPlaybackActive())
+  {
+    this->PrefetchStreamingVolumeFrames(browserNode, selectedItemNumber);
+  }
+  this->LastProxyUpdateItemNumber[browserNode] = selectedItemNumber;
+
 #ifdef ENABLE_PERFORMANCE_PROFILING
   timer->StopTimer();
   vtkInfoMacro("UpdateProxyNodesFromSequences: " << timer->GetElapsedTime() << "sec\n");
@@ -573,6 +622,61 @@ void vtkSlicerSequencesLogic::UpdateProxyNodesFromSequences(vtkMRMLSequenceBrows
   }
 }
 
+//---------------------------------------------------------------------------
+void vtkSlicerSequencesLogic::PrefetchStreamingVolumeFrames(vtkMRMLSequenceBrowserNode* browserNode, int selectedItemNumber)
+{
+  vtkMRMLStreamingVolumeDecodeCache* decodeCache = vtkMRMLStreamingVolumeDecodeCache::GetInstance();
+  int numberOfItems = browserNode->GetNumberOfItems();
+  if (decodeCache->GetNumberOfPrefetchFrames() <= 0 || selectedItemNumber < 0 || selectedItemNumber >= numberOfItems)
+  {
+    return;
+  }
+
+  // Playback direction is determined from the last item change (items may be browsed backward)
+  int direction = 1;
+  std::map<vtkMRMLSequenceBrowserNode*, int>::iterator lastItemNumberIt = this->LastProxyUpdateItemNumber.find(browserNode);
+  if (lastItemNumberIt != this->LastProxyUpdateItemNumber.end() && lastItemNumberIt->second != selectedItemNumber)
+  {
+    int itemNumberChange = selectedItemNumber - lastItemNumberIt->second;
+    if (browserNode->GetPlaybackLooped() && abs(itemNumberChange) > numberOfItems / 2)
+    {
+      // jumped over the end of the sequence
+      itemNumberChange = -itemNumberChange;
+    }
+    direction = (itemNumberChange < 0 ? -1 : 1);
+  }
+
+  vtkMRMLSequenceNode* masterSequenceNode = browserNode->GetMasterSequenceNode();
+  std::vector<vtkMRMLSequenceNode*> synchronizedSequenceNodes;
+  browserNode->GetSynchronizedSequenceNodes(synchronizedSequenceNodes, true);
+  int numberOfPrefetchFrames = std::min(decodeCache->GetNumberOfPrefetchFrames(), numberOfItems - 1);
+  for (int offset = 1; offset <= numberOfPrefetchFrames; ++offset)
+  {
+    int itemNumber = selectedItemNumber + direction * offset;
+    if (browserNode->GetPlaybackLooped())
+    {
+      itemNumber = (itemNumber % numberOfItems + numberOfItems) % numberOfItems;
+    }
+    else if (itemNumber < 0 || itemNumber >= numberOfItems)
+    {
+      break;
+    }
+    std::string indexValue = masterSequenceNode->GetNthIndexValue(itemNumber);
+    for (vtkMRMLSequenceNode* sequenceNode : synchronizedSequenceNodes)
+    {
+      if (!sequenceNode || !browserNode->GetPlayback(sequenceNode))
+      {
+        continue;
+      }
+      vtkMRMLStreamingVolumeNode* streamingVolumeNode = vtkMRMLStreamingVolumeNode::SafeDownCast(sequenceNode->GetDataNodeAtValue(indexValue, false));
+      if (streamingVolumeNode && streamingVolumeNode->GetFrame())
+      {
+        decodeCache->PrefetchFrame(streamingVolumeNode->GetFrame());
+      }
+    }
+  }
+}
+
 //---------------------------------------------------------------------------
 void vtkSlicerSequencesLogic::UpdateSequencesFromProxyNodes(vtkMRMLSequenceBrowserNode* browserNode, vtkMRMLNode* proxyNode)
 {
@@ -110,13 +110,22 @@ protected:
   void UpdateFromMRMLScene() override;
   void OnMRMLSceneNodeAdded(vtkMRMLNode* node) override;
   void OnMRMLSceneNodeRemoved(vtkMRMLNode* node) override;
+  void OnMRMLSceneEndClose() override;
   void ProcessMRMLNodesEvents(vtkObject* caller, unsigned long event, void* callData) override;
 
   bool IsDataConnectorNode(vtkMRMLNode*);
 
+  /// Queue decoding of streaming volume frames of the items that follow the selected item in the playback direction,
+  /// so that they are already decoded by the time they are displayed.
+  /// \sa vtkMRMLStreamingVolumeDecodeCache
+  void PrefetchStreamingVolumeFrames(vtkMRMLSequenceBrowserNode* browserNode, int selectedItemNumber);
+
   // Time of the last update of each browser node (in universal time)
   std::map<vtkMRMLSequenceBrowserNode*, double> LastSequenceBrowserUpdateTimeSec;
 
+  // Item number that proxy nodes were last updated to (used for determining playback direction)
+  std::map<vtkMRMLSequenceBrowserNode*, int> LastProxyUpdateItemNumber;
+
 private:
   std::set<vtkMRMLSequenceBrowserNode*> UpdateProxyNodesFromSequencesInProgress;
   std::set<vtkMRMLSequenceBrowserNode*> UpdateSequencesFromProxyNodesInProgress;
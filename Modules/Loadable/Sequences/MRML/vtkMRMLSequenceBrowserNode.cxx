@@ -34,8 +34,14 @@
 #include <vtkCommand.h>
 #include <vtkCollection.h>
 #include <vtkCollectionIterator.h>
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkFieldData.h>
+#include <vtkImageData.h>
 #include <vtkObjectFactory.h>
+#include <vtkPointData.h>
 #include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
 #include <vtksys/RegularExpression.hxx>
 #include <vtkTimerLog.h>
 #include <vtkVariant.h>
@@ -43,6 +49,7 @@
 // STD includes
 #include <sstream>
 #include <algorithm> // for std::find
+#include <cstring>
 #if defined(_WIN32) && !defined(__CYGWIN__)
 # define SNPRINTF _snprintf
 #else
@@ -60,6 +67,77 @@ const char* PROXY_NODE_REFERENCE_ROLE_BASE = "dataNodeRef";
 const char* PROXY_NODE_COPY_ATTRIBUTE_NAME = "proxyNodeCopy";
 
 const int INVALID_ITEM_NUMBER = -1;
+
+//----------------------------------------------------------------------------
+// Copy the content of the source node into the target node the same way as vtkMRMLSequenceNode::CreateDataNodeCopy,
+// but reuse the image memory that is already allocated in the target volume node.
+// Returns false if the memory cannot be reused, in this case full content copy is needed.
+bool CopyRecordedContent(vtkMRMLNode* target, vtkMRMLNode* source)
+{
+  if (strcmp(target->GetClassName(), source->GetClassName()) != 0)
+  {
+    return false;
+  }
+  vtkMRMLVolumeNode* sourceVolume = vtkMRMLVolumeNode::SafeDownCast(source);
+  vtkMRMLVolumeNode* targetVolume = vtkMRMLVolumeNode::SafeDownCast(target);
+  // Streaming volumes store their content in compressed frames, not in the image data
+  if (!sourceVolume || !targetVolume || source->IsA("vtkMRMLStreamingVolumeNode"))
+  {
+    return false;
+  }
+  vtkImageData* sourceImage = sourceVolume->GetImageData();
+  vtkSmartPointer<vtkImageData> targetImage = targetVolume->GetImageData();
+  if (!sourceImage || !targetImage || strcmp(sourceImage->GetClassName(), targetImage->GetClassName()) != 0)
+  {
+    return false;
+  }
+  // Only the voxel array is copied into the reused memory, therefore the image must not have other arrays
+  if (sourceImage->GetPointData()->GetNumberOfArrays() != 1 || sourceImage->GetCellData()->GetNumberOfArrays() != 0 //
+      || sourceImage->GetFieldData()->GetNumberOfArrays() != 0)
+  {
+    return false;
+  }
+  vtkDataArray* sourceScalars = sourceImage->GetPointData()->GetScalars();
+  vtkDataArray* targetScalars = targetImage->GetPointData()->GetScalars();
+  int* sourceExtent = sourceImage->GetExtent();
+  int* targetExtent = targetImage->GetExtent();
+  if (!sourceScalars || !targetScalars || !std::equal(sourceExtent, sourceExtent + 6, targetExtent) //
+      || sourceScalars->GetDataType() != targetScalars->GetDataType()                              //
+      || sourceScalars->GetNumberOfComponents() != targetScalars->GetNumberOfComponents()          //
+      || sourceScalars->GetNumberOfTuples() != targetScalars->GetNumberOfTuples())
+  {
+    return false;
+  }
+  memcpy(targetScalars->GetVoidPointer(0), sourceScalars->GetVoidPointer(0), sourceScalars->GetDataSize() * sourceScalars->GetDataTypeSize());
+  targetScalars->SetName(sourceScalars->GetName());
+  targetScalars->Modified();
+  targetImage->CopyStructure(sourceImage);
+
+  // Copy everything else (attributes, geometry, etc.) then replace the shared image data by the copied voxels
+  vtkMRMLSequenceNode::CopyDataNodeContent(target, source, false);
+  targetVolume->SetAndObserveImageData(targetImage);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Create a node that the next frames can be recorded into. For volumes, image memory is allocated
+// with the same size as in the specified node, but voxels are not copied.
+vtkSmartPointer<vtkMRMLNode> CreateRecordingBufferNode(vtkMRMLNode* node)
+{
+  vtkSmartPointer<vtkMRMLNode> bufferNode = vtkSmartPointer<vtkMRMLNode>::Take(node->CreateNodeInstance());
+  vtkMRMLVolumeNode* volumeNode = vtkMRMLVolumeNode::SafeDownCast(node);
+  vtkImageData* image = volumeNode ? volumeNode->GetImageData() : nullptr;
+  if (!image || !image->GetPointData()->GetScalars() || node->IsA("vtkMRMLStreamingVolumeNode"))
+  {
+    return bufferNode;
+  }
+  vtkSmartPointer<vtkImageData> bufferImage = vtkSmartPointer<vtkImageData>::Take(image->NewInstance());
+  bufferImage->SetExtent(image->GetExtent());
+  bufferImage->AllocateScalars(image->GetScalarType(), image->GetNumberOfScalarComponents());
+  vtkMRMLVolumeNode::SafeDownCast(bufferNode)->SetAndObserveImageData(bufferImage);
+  return bufferNode;
+}
+
 } // namespace
 
 // Declare the Synchronization Properties struct
@@ -130,6 +208,43 @@ std::string vtkMRMLSequenceBrowserNode::SynchronizationProperties::ToString()
   return ss.str();
 }
 
+// Buffer of recorded frames that are not added to the sequence nodes yet.
+// Each frame contains a data node for each recorded sequence. Data nodes are not in any scene,
+// they are preallocated and while recording only the content of proxy nodes is copied into them.
+// The data nodes are reused for all recorded frames, sequence nodes get copies of them.
+struct vtkMRMLSequenceBrowserNode::RecordingBuffer
+{
+  struct FrameItem
+  {
+    vtkWeakPointer<vtkMRMLSequenceNode> SequenceNode;
+    vtkSmartPointer<vtkMRMLNode> DataNode;
+    bool Recorded{ false };
+  };
+
+  struct Frame
+  {
+    double IndexValue{ 0.0 };
+    std::vector<FrameItem> Items;
+
+    FrameItem& GetItem(vtkMRMLSequenceNode* sequenceNode)
+    {
+      for (FrameItem& item : this->Items)
+      {
+        if (item.SequenceNode == sequenceNode)
+        {
+          return item;
+        }
+      }
+      this->Items.emplace_back();
+      this->Items.back().SequenceNode = sequenceNode;
+      return this->Items.back();
+    }
+  };
+
+  std::vector<Frame> Frames;
+  int NumberOfBufferedFrames{ 0 };
+};
+
 //------------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLSequenceBrowserNode);
 
@@ -140,10 +255,15 @@ vtkMRMLSequenceBrowserNode::vtkMRMLSequenceBrowserNode()
   this->SetHideFromEditors(false);
   this->RecordingTimeOffsetSec = vtkTimerLog::GetUniversalTime();
   this->LastSaveProxyNodesStateTimeSec = vtkTimerLog::GetUniversalTime();
+  this->RecordedFrames = new RecordingBuffer;
 }
 
 //----------------------------------------------------------------------------
-vtkMRMLSequenceBrowserNode::~vtkMRMLSequenceBrowserNode() = default;
+vtkMRMLSequenceBrowserNode::~vtkMRMLSequenceBrowserNode()
+{
+  delete this->RecordedFrames;
+  this->RecordedFrames = nullptr;
+}
 
 //----------------------------------------------------------------------------
 void vtkMRMLSequenceBrowserNode::WriteXML(ostream& of, int nIndent)
@@ -159,6 +279,7 @@ void vtkMRMLSequenceBrowserNode::WriteXML(ostream& of, int nIndent)
   of << indent << " selectedItemNumber=\"" << this->SelectedItemNumber << "\"";
   of << indent << " recordingActive=\"" << (this->RecordingActive ? "true" : "false") << "\"";
   of << indent << " recordOnMasterModifiedOnly=\"" << (this->RecordMasterOnly ? "true" : "false") << "\"";
+  of << indent << " recordingBufferSize=\"" << this->RecordingBufferSize << "\"";
 
   std::string recordingSamplingModeString = this->GetRecordingSamplingModeAsString();
   if (!recordingSamplingModeString.empty())
@@ -281,6 +402,14 @@ void vtkMRMLSequenceBrowserNode::ReadXMLAttributes(const char** atts)
         this->SetRecordMasterOnly(0);
       }
     }
+    else if (!strcmp(attName, "recordingBufferSize"))
+    {
+      std::stringstream ss;
+      ss << attValue;
+      int recordingBufferSize = 0;
+      ss >> recordingBufferSize;
+      this->SetRecordingBufferSize(recordingBufferSize);
+    }
     else if (!strcmp(attName, "recordingSamplingMode"))
     {
       int recordingSamplingMode = this->GetRecordingSamplingModeFromString(attValue);
@@ -383,6 +512,7 @@ void vtkMRMLSequenceBrowserNode::CopyContent(vtkMRMLNode* anode, bool deepCopy /
   vtkMRMLCopyBooleanMacro(PlaybackItemSkippingEnabled);
   vtkMRMLCopyBooleanMacro(PlaybackLooped);
   vtkMRMLCopyBooleanMacro(RecordMasterOnly);
+  vtkMRMLCopyIntMacro(RecordingBufferSize);
   vtkMRMLCopyIntMacro(RecordingSamplingMode);
   vtkMRMLCopyIntMacro(IndexDisplayMode);
   vtkMRMLCopyStringMacro(IndexDisplayFormat);
@@ -404,6 +534,8 @@ void vtkMRMLSequenceBrowserNode::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << " Selected item number: " << this->SelectedItemNumber << '\n';
   os << indent << " Recording active: " << (this->RecordingActive ? "true" : "false") << '\n';
   os << indent << " Recording on master modified only: " << (this->RecordMasterOnly ? "true" : "false") << '\n';
+  os << indent << " Recording buffer size: " << this->RecordingBufferSize << '\n';
+  os << indent << " Buffered recorded frames: " << this->RecordedFrames->NumberOfBufferedFrames << '\n';
   os << indent << " Recording sampling mode: " << this->GetRecordingSamplingModeAsString() << "\n";
   os << indent << " Index display mode: " << this->GetIndexDisplayModeAsString() << "\n";
   os << indent << " Index display format: " << this->GetIndexDisplayFormat() << "\n";
@@ -955,6 +1087,8 @@ void vtkMRMLSequenceBrowserNode::GetSynchronizedSequenceNodes(vtkCollection* syn
 //---------------------------------------------------------------------------
 void vtkMRMLSequenceBrowserNode::SetRecordingActive(bool recording)
 {
+  // Add all previously recorded frames so that the last recorded time is up-to-date
+  this->CommitRecordedFrames();
   // Before activating the recording, set the initial timestamp to be correct
   this->RecordingTimeOffsetSec = vtkTimerLog::GetUniversalTime();
   int numberOfItems = this->GetNumberOfItems();
@@ -967,6 +1101,10 @@ void vtkMRMLSequenceBrowserNode::SetRecordingActive(bool recording)
     timeString >> timeValue;
     this->RecordingTimeOffsetSec -= timeValue;
   }
+  if (recording && this->RecordingBufferSize > 0)
+  {
+    this->AllocateRecordingBuffer();
+  }
   if (this->RecordingActive != recording)
   {
     this->RecordingActive = recording;
@@ -1131,11 +1269,19 @@ void vtkMRMLSequenceBrowserNode::SaveProxyNodesState()
       }
     }
     this->LastSaveProxyNodesStateTimeSec = currentTime;
+    if (this->RecordingBufferSize > 0)
+    {
+      // Only copy the proxy node content now, frames are added to the sequences later
+      this->BufferProxyNodesState(currentTime - this->RecordingTimeOffsetSec);
+      return;
+    }
     currTime << (currentTime - this->RecordingTimeOffsetSec);
   }
   else
   {
     // Recording a single snapshot
+    // Previously recorded frames must be added first to get the correct last item time
+    this->CommitRecordedFrames();
     // TODO: add support for non-numeric index type
     double lastItemTime = 0;
     int numberOfItems = this->GetNumberOfItems();
@@ -1170,6 +1316,165 @@ void vtkMRMLSequenceBrowserNode::SaveProxyNodesState()
   }
 }
 
+//---------------------------------------------------------------------------
+void vtkMRMLSequenceBrowserNode::SetRecordingBufferSize(int size)
+{
+  size = std::max(size, 0);
+  if (this->RecordingBufferSize == size)
+  {
+    return;
+  }
+  this->CommitRecordedFrames();
+  this->RecordingBufferSize = size;
+  this->RecordedFrames->Frames.clear();
+  this->RecordedFrames->Frames.resize(size);
+  if (this->RecordingActive && size > 0)
+  {
+    this->AllocateRecordingBuffer();
+  }
+  this->Modified();
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLSequenceBrowserNode::AllocateRecordingBuffer()
+{
+  if (static_cast<int>(this->RecordedFrames->Frames.size()) != this->RecordingBufferSize)
+  {
+    this->RecordedFrames->Frames.resize(this->RecordingBufferSize);
+  }
+  std::vector<vtkMRMLSequenceNode*> sequenceNodes;
+  this->GetSynchronizedSequenceNodes(sequenceNodes, true);
+  for (vtkMRMLSequenceNode* sequenceNode : sequenceNodes)
+  {
+    if (!this->GetRecording(sequenceNode))
+    {
+      continue;
+    }
+    vtkMRMLNode* proxyNode = this->GetProxyNode(sequenceNode);
+    if (!proxyNode)
+    {
+      continue;
+    }
+    for (RecordingBuffer::Frame& frame : this->RecordedFrames->Frames)
+    {
+      RecordingBuffer::FrameItem& item = frame.GetItem(sequenceNode);
+      if (!item.DataNode || strcmp(item.DataNode->GetClassName(), proxyNode->GetClassName()) != 0)
+      {
+        item.DataNode = CreateRecordingBufferNode(proxyNode);
+      }
+    }
+  }
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLSequenceBrowserNode::BufferProxyNodesState(double indexValue)
+{
+  if (this->RecordedFrames->NumberOfBufferedFrames >= this->RecordingBufferSize)
+  {
+    // All buffers are in use
+    this->CommitRecordedFrames();
+  }
+  if (static_cast<int>(this->RecordedFrames->Frames.size()) != this->RecordingBufferSize)
+  {
+    this->RecordedFrames->Frames.resize(this->RecordingBufferSize);
+  }
+  RecordingBuffer::Frame& frame = this->RecordedFrames->Frames[this->RecordedFrames->NumberOfBufferedFrames];
+  frame.IndexValue = indexValue;
+  for (RecordingBuffer::FrameItem& item : frame.Items)
+  {
+    item.Recorded = false;
+  }
+
+  std::vector<vtkMRMLSequenceNode*> sequenceNodes;
+  this->GetSynchronizedSequenceNodes(sequenceNodes, true);
+  bool frameRecorded = false;
+  for (vtkMRMLSequenceNode* sequenceNode : sequenceNodes)
+  {
+    if (!this->GetRecording(sequenceNode))
+    {
+      continue;
+    }
+    vtkMRMLNode* proxyNode = this->GetProxyNode(sequenceNode);
+    if (!proxyNode)
+    {
+      continue;
+    }
+    RecordingBuffer::FrameItem& item = frame.GetItem(sequenceNode);
+    if (!item.DataNode || !CopyRecordedContent(item.DataNode, proxyNode))
+    {
+      if (item.DataNode && strcmp(item.DataNode->GetClassName(), proxyNode->GetClassName()) == 0)
+      {
+        vtkMRMLSequenceNode::CopyDataNodeContent(item.DataNode, proxyNode, true);
+      }
+      else
+      {
+        item.DataNode = vtkSmartPointer<vtkMRMLNode>::Take(vtkMRMLSequenceNode::CreateDataNodeCopy(proxyNode));
+      }
+    }
+    item.Recorded = true;
+    frameRecorded = true;
+  }
+  if (frameRecorded)
+  {
+    this->RecordedFrames->NumberOfBufferedFrames++;
+  }
+}
+
+//---------------------------------------------------------------------------
+int vtkMRMLSequenceBrowserNode::CommitRecordedFrames()
+{
+  int numberOfFrames = this->RecordedFrames->NumberOfBufferedFrames;
+  if (numberOfFrames == 0)
+  {
+    return 0;
+  }
+  MRMLNodeModifyBlocker blocker(this);
+
+  // Copy the buffered data nodes for each sequence, in recording order
+  std::vector<vtkMRMLSequenceNode*> sequenceNodes;
+  std::vector<std::vector<vtkSmartPointer<vtkMRMLNode>>> dataNodes;
+  std::vector<std::vector<std::string>> indexValues;
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+  {
+    RecordingBuffer::Frame& frame = this->RecordedFrames->Frames[frameIndex];
+    std::stringstream indexValue;
+    indexValue << frame.IndexValue;
+    for (RecordingBuffer::FrameItem& item : frame.Items)
+    {
+      if (!item.Recorded || !item.SequenceNode || !item.DataNode)
+      {
+        continue;
+      }
+      size_t sequenceIndex = std::find(sequenceNodes.begin(), sequenceNodes.end(), item.SequenceNode.GetPointer()) - sequenceNodes.begin();
+      if (sequenceIndex == sequenceNodes.size())
+      {
+        sequenceNodes.push_back(item.SequenceNode);
+        dataNodes.emplace_back();
+        indexValues.emplace_back();
+      }
+      dataNodes[sequenceIndex].push_back(vtkSmartPointer<vtkMRMLNode>::Take(vtkMRMLSequenceNode::CreateDataNodeCopy(item.DataNode)));
+      indexValues[sequenceIndex].push_back(indexValue.str());
+      item.Recorded = false;
+    }
+  }
+  for (size_t sequenceIndex = 0; sequenceIndex < sequenceNodes.size(); ++sequenceIndex)
+  {
+    std::vector<vtkMRMLNode*> sequenceDataNodes(dataNodes[sequenceIndex].begin(), dataNodes[sequenceIndex].end());
+    sequenceNodes[sequenceIndex]->AddDataNodesAtValues(sequenceDataNodes, indexValues[sequenceIndex]);
+  }
+  this->RecordedFrames->NumberOfBufferedFrames = 0;
+
+  this->Modified();
+  this->SelectLastItem();
+  return numberOfFrames;
+}
+
+//---------------------------------------------------------------------------
+int vtkMRMLSequenceBrowserNode::GetNumberOfBufferedRecordedFrames()
+{
+  return this->RecordedFrames->NumberOfBufferedFrames;
+}
+
 //---------------------------------------------------------------------------
 void vtkMRMLSequenceBrowserNode::OnNodeReferenceAdded(vtkMRMLNodeReference* nodeReference)
 {
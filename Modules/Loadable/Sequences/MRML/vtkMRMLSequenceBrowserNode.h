@@ -190,6 +190,28 @@ public:
   vtkBooleanMacro(RecordMasterOnly, bool);
   //@}
 
+  //@{
+  /// Number of recorded frames that can be buffered before they are added to the sequence nodes.
+  /// If 0 (default) then each recorded frame is added to the sequence nodes immediately, which
+  /// requires a full copy of each proxy node into the sequence scenes during recording.
+  /// If larger than 0 then continuous recording copies the content of proxy nodes into a fixed pool of data nodes
+  /// that are not in any scene (image voxels are copied into preallocated memory) and the recorded frames are
+  /// added to the sequence nodes in batches by CommitRecordedFrames(). Sequence nodes get copies of the
+  /// buffered data nodes, the pool is reused for the next frames.
+  /// Frames are committed regularly by the sequences module logic, when recording is stopped, and when
+  /// all buffers are in use.
+  void SetRecordingBufferSize(int size);
+  vtkGetMacro(RecordingBufferSize, int);
+  //@}
+
+  /// Add all buffered recorded frames to the sequence nodes.
+  /// Returns the number of frames that were added.
+  /// \sa SetRecordingBufferSize
+  int CommitRecordedFrames();
+
+  /// Returns the number of recorded frames that have not been added to the sequence nodes yet.
+  int GetNumberOfBufferedRecordedFrames();
+
   //@{
   /// Get/set the recording sampling mode
   vtkSetMacro(RecordingSamplingMode, int);
@@ -381,6 +403,13 @@ protected:
   /// Called whenever a node reference is removed
   void OnNodeReferenceRemoved(vtkMRMLNodeReference* nodeReference) override;
 
+  /// Copy the current state of recorded proxy nodes into the next frame of the recording buffer.
+  void BufferProxyNodesState(double indexValue);
+
+  /// Create data nodes for all frames of the recording buffer, so that no nodes have
+  /// to be created while recording.
+  void AllocateRecordingBuffer();
+
   std::string GenerateSynchronizationPostfix();
   std::string GetSynchronizationPostfixFromSequence(vtkMRMLSequenceNode* sequenceNode);
   std::string GetSynchronizationPostfixFromSequenceID(const char* sequenceNodeID);
@@ -403,6 +432,7 @@ protected:
   vtkGetMacro(LastSaveProxyNodesStateTimeSec, double);
 
   bool RecordMasterOnly{ false };
+  int RecordingBufferSize{ 0 };
   int RecordingSamplingMode{ vtkMRMLSequenceBrowserNode::SamplingLimitedToPlaybackFrameRate };
   int IndexDisplayMode{ vtkMRMLSequenceBrowserNode::IndexDisplayAsIndexValue };
   std::string IndexDisplayFormat;
@@ -421,6 +451,9 @@ private:
   std::map<std::string, SynchronizationProperties*> SynchronizationPropertiesMap;
   SynchronizationProperties* GetSynchronizationPropertiesForSequence(vtkMRMLSequenceNode* sequenceNode);
   SynchronizationProperties* GetSynchronizationPropertiesForPostfix(const std::string& rolePostfix);
+
+  struct RecordingBuffer;
+  RecordingBuffer* RecordedFrames;
 };
 
 #endif
@@ -0,0 +1,215 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c)
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLLinearTransformNode.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLSequenceBrowserNode.h"
+#include "vtkMRMLSequenceNode.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const int NUMBER_OF_FRAMES = 60;
+const int NUMBER_OF_TRANSFORMS = 4;
+// Time available for recording a frame at 60 frames per second
+const double FRAME_TIME_BUDGET_SEC = 1.0 / 60.0;
+
+//----------------------------------------------------------------------------
+struct RecordingResult
+{
+  double MeanFrameTimeSec{ 0.0 };
+  double MaxFrameTimeSec{ 0.0 };
+  double CommitTimeSec{ 0.0 };
+  int NumberOfDroppedFrames{ 0 };
+};
+
+//----------------------------------------------------------------------------
+void UpdateProxyNodes(int frameIndex, vtkMRMLScalarVolumeNode* volumeNode, const std::vector<vtkMRMLLinearTransformNode*>& transformNodes)
+{
+  unsigned char* voxels = static_cast<unsigned char*>(volumeNode->GetImageData()->GetScalarPointer());
+  vtkIdType numberOfVoxels = volumeNode->GetImageData()->GetNumberOfPoints();
+  for (vtkIdType i = 0; i < numberOfVoxels; ++i)
+  {
+    voxels[i] = static_cast<unsigned char>(i + frameIndex);
+  }
+  volumeNode->GetImageData()->Modified();
+  // Node attributes and geometry must be recorded as well
+  volumeNode->SetAttribute("FrameIndex", std::to_string(frameIndex).c_str());
+  volumeNode->SetOrigin(frameIndex, 0.0, 0.0);
+  for (size_t transformIndex = 0; transformIndex < transformNodes.size(); ++transformIndex)
+  {
+    vtkNew<vtkMatrix4x4> matrix;
+    matrix->SetElement(0, 3, frameIndex);
+    matrix->SetElement(1, 3, transformIndex);
+    transformNodes[transformIndex]->SetMatrixTransformToParent(matrix);
+    transformNodes[transformIndex]->SetAttribute("FrameIndex", std::to_string(frameIndex).c_str());
+  }
+}
+
+//----------------------------------------------------------------------------
+int RecordSequences(int recordingBufferSize, RecordingResult& result)
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLSequenceBrowserNode> browserNode;
+  scene->AddNode(browserNode);
+  browserNode->SetRecordingSamplingMode(vtkMRMLSequenceBrowserNode::SamplingAll);
+  browserNode->SetRecordingBufferSize(recordingBufferSize);
+  CHECK_INT(browserNode->GetRecordingBufferSize(), recordingBufferSize);
+
+  // Ultrasound-like image stream
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(640, 480, 1);
+  imageData->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  volumeNode->SetAndObserveImageData(imageData);
+  volumeNode->SetName("Image");
+  scene->AddNode(volumeNode);
+  vtkNew<vtkMRMLSequenceNode> volumeSequenceNode;
+  scene->AddNode(volumeSequenceNode);
+  browserNode->SetAndObserveMasterSequenceNodeID(volumeSequenceNode->GetID());
+  browserNode->AddProxyNode(volumeNode, volumeSequenceNode, false);
+  browserNode->SetRecording(volumeSequenceNode, true);
+
+  // Tracked tools
+  std::vector<vtkSmartPointer<vtkMRMLLinearTransformNode>> transformNodes;
+  std::vector<vtkMRMLLinearTransformNode*> transformNodePointers;
+  std::vector<vtkSmartPointer<vtkMRMLSequenceNode>> transformSequenceNodes;
+  for (int i = 0; i < NUMBER_OF_TRANSFORMS; ++i)
+  {
+    vtkNew<vtkMRMLLinearTransformNode> transformNode;
+    scene->AddNode(transformNode);
+    vtkNew<vtkMRMLSequenceNode> transformSequenceNode;
+    scene->AddNode(transformSequenceNode);
+    browserNode->AddSynchronizedSequenceNodeID(transformSequenceNode->GetID());
+    browserNode->AddProxyNode(transformNode, transformSequenceNode, false);
+    browserNode->SetRecording(transformSequenceNode, true);
+    transformNodes.emplace_back(transformNode.GetPointer());
+    transformNodePointers.push_back(transformNode);
+    transformSequenceNodes.emplace_back(transformSequenceNode.GetPointer());
+  }
+
+  browserNode->SetRecordingActive(true);
+  vtkNew<vtkTimerLog> timer;
+  double totalFrameTimeSec = 0.0;
+  for (int frameIndex = 0; frameIndex < NUMBER_OF_FRAMES; ++frameIndex)
+  {
+    UpdateProxyNodes(frameIndex, volumeNode, transformNodePointers);
+    timer->StartTimer();
+    browserNode->SaveProxyNodesState();
+    timer->StopTimer();
+    double frameTimeSec = timer->GetElapsedTime();
+    totalFrameTimeSec += frameTimeSec;
+    result.MaxFrameTimeSec = std::max(result.MaxFrameTimeSec, frameTimeSec);
+    if (frameTimeSec > FRAME_TIME_BUDGET_SEC)
+    {
+      result.NumberOfDroppedFrames++;
+    }
+  }
+  result.MeanFrameTimeSec = totalFrameTimeSec / NUMBER_OF_FRAMES;
+
+  timer->StartTimer();
+  browserNode->CommitRecordedFrames();
+  timer->StopTimer();
+  result.CommitTimeSec = timer->GetElapsedTime();
+  CHECK_INT(browserNode->GetNumberOfBufferedRecordedFrames(), 0);
+  browserNode->SetRecordingActive(false);
+
+  // Verify recorded content
+  CHECK_INT(volumeSequenceNode->GetNumberOfDataNodes(), NUMBER_OF_FRAMES);
+  CHECK_INT(browserNode->GetNumberOfItems(), NUMBER_OF_FRAMES);
+  CHECK_INT(browserNode->GetSelectedItemNumber(), NUMBER_OF_FRAMES - 1);
+  double previousIndexValue = -1.0;
+  for (int frameIndex = 0; frameIndex < NUMBER_OF_FRAMES; ++frameIndex)
+  {
+    double indexValue = atof(volumeSequenceNode->GetNthIndexValue(frameIndex).c_str());
+    CHECK_BOOL(indexValue > previousIndexValue, true);
+    previousIndexValue = indexValue;
+    vtkMRMLScalarVolumeNode* recordedVolumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(volumeSequenceNode->GetNthDataNode(frameIndex));
+    CHECK_NOT_NULL(recordedVolumeNode);
+    CHECK_NOT_NULL(recordedVolumeNode->GetImageData());
+    unsigned char* voxels = static_cast<unsigned char*>(recordedVolumeNode->GetImageData()->GetScalarPointer());
+    CHECK_INT(voxels[0], static_cast<unsigned char>(frameIndex));
+    CHECK_INT(voxels[1000], static_cast<unsigned char>(1000 + frameIndex));
+    CHECK_STRING(recordedVolumeNode->GetName(), "Image");
+    CHECK_STRING(recordedVolumeNode->GetAttribute("FrameIndex"), std::to_string(frameIndex).c_str());
+    CHECK_DOUBLE(recordedVolumeNode->GetOrigin()[0], frameIndex);
+  }
+  for (int transformIndex = 0; transformIndex < NUMBER_OF_TRANSFORMS; ++transformIndex)
+  {
+    vtkMRMLSequenceNode* transformSequenceNode = transformSequenceNodes[transformIndex];
+    CHECK_INT(transformSequenceNode->GetNumberOfDataNodes(), NUMBER_OF_FRAMES);
+    for (int frameIndex = 0; frameIndex < NUMBER_OF_FRAMES; ++frameIndex)
+    {
+      CHECK_STD_STRING(transformSequenceNode->GetNthIndexValue(frameIndex), volumeSequenceNode->GetNthIndexValue(frameIndex));
+      vtkMRMLLinearTransformNode* recordedTransformNode = vtkMRMLLinearTransformNode::SafeDownCast(transformSequenceNode->GetNthDataNode(frameIndex));
+      CHECK_NOT_NULL(recordedTransformNode);
+      vtkNew<vtkMatrix4x4> matrix;
+      recordedTransformNode->GetMatrixTransformToParent(matrix);
+      CHECK_DOUBLE(matrix->GetElement(0, 3), frameIndex);
+      CHECK_DOUBLE(matrix->GetElement(1, 3), transformIndex);
+      CHECK_STRING(recordedTransformNode->GetAttribute("FrameIndex"), std::to_string(frameIndex).c_str());
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+void PrintResult(const char* name, const RecordingResult& result)
+{
+  std::cout << name << ": mean frame time = " << result.MeanFrameTimeSec * 1000.0 << " ms"
+            << ", max frame time = " << result.MaxFrameTimeSec * 1000.0 << " ms"
+            << ", commit time = " << result.CommitTimeSec * 1000.0 << " ms"
+            << ", frames over 60 fps budget = " << result.NumberOfDroppedFrames << "/" << NUMBER_OF_FRAMES << std::endl;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLSequenceBrowserNodeRecordingTest1(int, char*[])
+{
+  // Each frame is added to the sequences immediately
+  RecordingResult directResult;
+  CHECK_EXIT_SUCCESS(RecordSequences(0, directResult));
+  PrintResult("Direct recording", directResult);
+
+  // Frames are buffered and added to the sequences in batches (the buffer fills up twice)
+  RecordingResult bufferedResult;
+  CHECK_EXIT_SUCCESS(RecordSequences(NUMBER_OF_FRAMES / 2, bufferedResult));
+  PrintResult("Buffered recording", bufferedResult);
+
+  // Buffer size cannot be negative
+  vtkNew<vtkMRMLSequenceBrowserNode> browserNode;
+  browserNode->SetRecordingBufferSize(-5);
+  CHECK_INT(browserNode->GetRecordingBufferSize(), 0);
+  CHECK_INT(browserNode->CommitRecordedFrames(), 0);
+
+  return EXIT_SUCCESS;
+}
@@ -70,6 +70,7 @@ class SequencesSelfTestTest(ScriptedLoadableModuleTest):
         self.section_ReplaySavedSequence()
         self.section_SaveVolumeSequence("scalar")
         self.section_SaveVolumeSequence("label")
+        self.section_SaveLoadLosslessDeltaVolumeSequence()
         self.delayDisplay("Test passed")
 
     # ------------------------------------------------------------------------------
@@ -221,3 +222,47 @@ class SequencesSelfTestTest(ScriptedLoadableModuleTest):
             self.assertEqual(volumeNode.GetClassName(), "vtkMRMLLabelMapVolumeNode")
 
         self.delayDisplay("Test passed for volume type " + volumeType)
+
+    # ------------------------------------------------------------------------------
+    def section_SaveLoadLosslessDeltaVolumeSequence(self):
+
+        import numpy as np
+        randomGenerator = np.random.default_rng(12345)
+
+        self.delayDisplay("Test saving and loading of lossless delta compressed volume sequence")
+        slicer.mrmlScene.Clear(0)
+
+        # Create a sequence of slowly changing volumes
+        numberOfItems = 4
+        sequenceNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLSequenceNode", "sldc example")
+        voxelArray = randomGenerator.integers(low=0, high=1000, size=(12, 15, 18), dtype=np.int16)
+        voxelArrays = []
+        for i in range(numberOfItems):
+            voxelArray = voxelArray.copy()
+            voxelArray[i, :, :] += 10
+            voxelArrays.append(voxelArray)
+            volumeNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLScalarVolumeNode", f"volume_{i}")
+            slicer.util.updateVolumeFromArray(volumeNode, voxelArray)
+            sequenceNode.SetDataNodeAtValue(volumeNode, str(i))
+
+        # Save using the file extension that is offered in the save dialog
+        filePath = os.path.join(self.sequencesSelfTestDir, "SequencesSelfTest.seq.sldc")
+        if os.path.exists(filePath):
+            os.remove(filePath)
+        self.assertTrue(slicer.util.saveNode(sequenceNode, filePath))
+        self.assertTrue(os.path.exists(filePath))
+
+        # The file is recognized as a sequence, as in Add Data dialog and drag-and-drop
+        self.assertEqual(slicer.app.coreIOManager().fileType(filePath), "SequenceFile")
+
+        # Load through the sequence reader
+        slicer.mrmlScene.Clear(0)
+        loadedSequenceNode = slicer.util.loadNodeFromFile(filePath, "SequenceFile")
+        self.assertIsNotNone(loadedSequenceNode)
+        self.assertEqual(loadedSequenceNode.GetNumberOfDataNodes(), numberOfItems)
+        for i in range(numberOfItems):
+            self.assertEqual(loadedSequenceNode.GetNthIndexValue(i), str(i))
+            loadedVoxelArray = slicer.util.arrayFromVolume(loadedSequenceNode.GetNthDataNode(i))
+            np.testing.assert_array_equal(loadedVoxelArray, voxelArrays[i])
+
+        os.remove(filePath)
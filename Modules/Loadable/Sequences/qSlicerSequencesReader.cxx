@@ -92,7 +92,8 @@ qSlicerIO::IOFileType qSlicerSequencesReader::fileType() const
 QStringList qSlicerSequencesReader::extensions() const
 {
   return QStringList() //
-         << tr("Sequence") + " (*.seq.mrb *.mrb)" << tr("Volume Sequence") + " (*.seq.nrrd *.seq.nhdr)" << tr("Volume Sequence") + " (*.nrrd *.nhdr)";
+         << tr("Sequence") + " (*.seq.mrb *.mrb)" << tr("Volume Sequence") + " (*.seq.nrrd *.seq.nhdr)" << tr("Volume Sequence") + " (*.nrrd *.nhdr)" //
+         << tr("Volume Sequence (lossless delta)") + " (*.seq.sldc)";
 }
 
 //----------------------------------------------------------------------------
@@ -104,6 +105,8 @@ double qSlicerSequencesReader::canLoadFileConfidence(const QString& fileName) co
   // for composite file extensions (.seq.nhdr) it would be 0.59.
   // Therefore, confidence below 0.56 means that we got a generic file extension
   // that we need to inspect further.
+  // Lossless delta compressed files (.seq.sldc) always contain a volume sequence,
+  // the confidence of the composite file extension (0.59) is used for them.
   if (confidence > 0 && confidence < 0.56)
   {
     // Not a composite file extension, inspect the content
@@ -0,0 +1,136 @@
+import logging
+import unittest
+
+import slicer
+
+
+class SubjectHierarchyModelFetchTest1(unittest.TestCase):
+    def setUp(self):
+        """Do whatever is needed to reset the state - typically a scene clear will be enough."""
+        slicer.mrmlScene.Clear(0)
+
+    def runTest(self):
+        """Run as few or as many tests as needed here."""
+        self.setUp()
+        self.test_SubjectHierarchyModelFetchTest1()
+
+    # ------------------------------------------------------------------------------
+    def test_SubjectHierarchyModelFetchTest1(self):
+        # Check for modules
+        self.assertIsNotNone(slicer.modules.subjecthierarchy)
+
+        self.TestSection_InitializeTest()
+        self.TestSection_LazyFetch()
+        self.TestSection_DeepItemLookup()
+        self.TestSection_Filtering()
+
+        logging.info("Test finished")
+
+    # ------------------------------------------------------------------------------
+    def TestSection_InitializeTest(self):
+        logging.info("Test section: Initialize test")
+
+        self.shNode = slicer.vtkMRMLSubjectHierarchyNode.GetSubjectHierarchyNode(slicer.mrmlScene)
+        self.assertIsNotNone(self.shNode)
+        sceneItemID = self.shNode.GetSceneItemID()
+
+        # Two collapsed branches, each containing a collapsed folder with a few models
+        self.outerFolderItemIDs = []
+        self.innerFolderItemIDs = []
+        self.deepItemIDs = []
+        for branchIndex in range(2):
+            outerFolderItemID = self.shNode.CreateFolderItem(sceneItemID, f"OuterFolder_{branchIndex}")
+            innerFolderItemID = self.shNode.CreateFolderItem(outerFolderItemID, f"InnerFolder_{branchIndex}")
+            for modelIndex in range(3):
+                modelNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLModelNode", f"DeepModel_{branchIndex}_{modelIndex}")
+                modelItemID = self.shNode.GetItemByDataNode(modelNode)
+                self.shNode.SetItemParent(modelItemID, innerFolderItemID)
+                self.deepItemIDs.append(modelItemID)
+            self.shNode.SetItemExpanded(innerFolderItemID, False)
+            self.shNode.SetItemExpanded(outerFolderItemID, False)
+            self.outerFolderItemIDs.append(outerFolderItemID)
+            self.innerFolderItemIDs.append(innerFolderItemID)
+
+        # Models are created after the hierarchy so that the collapsed branches are not populated
+        self.model = slicer.qMRMLSubjectHierarchyModel()
+        self.proxyModel = slicer.qMRMLSortFilterSubjectHierarchyProxyModel()
+        self.proxyModel.setSourceModel(self.model)
+        self.model.setMRMLScene(slicer.mrmlScene)
+        self.assertTrue(self.model.fetchOnDemand)
+
+    # ------------------------------------------------------------------------------
+    def TestSection_LazyFetch(self):
+        logging.info("Test section: Lazy fetch")
+
+        for outerFolderItemID in self.outerFolderItemIDs:
+            outerFolderIndex = self.proxyModel.indexFromSubjectHierarchyItem(outerFolderItemID)
+            self.assertTrue(outerFolderIndex.isValid())
+            # Children are reported but not added to the model until requested
+            self.assertTrue(self.proxyModel.hasChildren(outerFolderIndex))
+            self.assertTrue(self.proxyModel.canFetchMore(outerFolderIndex))
+            self.assertEqual(self.proxyModel.rowCount(outerFolderIndex), 0)
+        for innerFolderItemID in self.innerFolderItemIDs:
+            self.assertFalse(self.proxyModel.fetchedIndexFromSubjectHierarchyItem(innerFolderItemID).isValid())
+        for deepItemID in self.deepItemIDs:
+            self.assertFalse(self.proxyModel.fetchedIndexFromSubjectHierarchyItem(deepItemID).isValid())
+
+        # Fetching a collapsed folder adds its direct children only
+        outerFolderIndex = self.proxyModel.indexFromSubjectHierarchyItem(self.outerFolderItemIDs[1])
+        self.proxyModel.fetchMore(outerFolderIndex)
+        self.assertEqual(self.proxyModel.rowCount(outerFolderIndex), 1)
+        innerFolderIndex = self.proxyModel.indexFromSubjectHierarchyItem(self.innerFolderItemIDs[1])
+        self.assertTrue(innerFolderIndex.isValid())
+        self.assertTrue(self.proxyModel.canFetchMore(innerFolderIndex))
+        self.assertFalse(self.proxyModel.fetchedIndexFromSubjectHierarchyItem(self.deepItemIDs[3]).isValid())
+
+    # ------------------------------------------------------------------------------
+    def TestSection_DeepItemLookup(self):
+        logging.info("Test section: Deep item lookup")
+
+        # Lookup fetches the whole branch above the requested item
+        deepItemID = self.deepItemIDs[1]
+        deepItemIndex = self.proxyModel.indexFromSubjectHierarchyItem(deepItemID)
+        self.assertTrue(deepItemIndex.isValid())
+        self.assertEqual(self.proxyModel.subjectHierarchyItemFromIndex(deepItemIndex), deepItemID)
+
+        # After the fetch the item and its siblings can be looked up without fetching
+        for siblingItemID in self.deepItemIDs[0:3]:
+            siblingIndex = self.proxyModel.fetchedIndexFromSubjectHierarchyItem(siblingItemID)
+            self.assertTrue(siblingIndex.isValid())
+            self.assertEqual(self.proxyModel.subjectHierarchyItemFromIndex(siblingIndex), siblingItemID)
+        innerFolderIndex = self.proxyModel.fetchedIndexFromSubjectHierarchyItem(self.innerFolderItemIDs[0])
+        self.assertEqual(self.proxyModel.rowCount(innerFolderIndex), 3)
+
+        # Fetching one branch does not fetch the other branch
+        self.assertFalse(self.proxyModel.fetchedIndexFromSubjectHierarchyItem(self.deepItemIDs[4]).isValid())
+
+        # Looking up an already fetched item returns the same index
+        self.assertEqual(self.proxyModel.indexFromSubjectHierarchyItem(deepItemID), deepItemIndex)
+
+    # ------------------------------------------------------------------------------
+    def TestSection_Filtering(self):
+        logging.info("Test section: Filtering")
+
+        # Matches inside unfetched branches must be shown while the filter is active
+        unfetchedItemID = self.deepItemIDs[5]
+        self.assertFalse(self.proxyModel.fetchedIndexFromSubjectHierarchyItem(unfetchedItemID).isValid())
+        self.proxyModel.setNameFilter("DeepModel_1_2")
+        self.assertFalse(self.model.fetchOnDemand)
+        matchIndex = self.proxyModel.indexFromSubjectHierarchyItem(unfetchedItemID)
+        self.assertTrue(matchIndex.isValid())
+        self.assertEqual(self.proxyModel.subjectHierarchyItemFromIndex(matchIndex), unfetchedItemID)
+        # Parents of the match are shown, non-matching siblings are not
+        self.assertTrue(self.proxyModel.indexFromSubjectHierarchyItem(self.innerFolderItemIDs[1]).isValid())
+        self.assertFalse(self.proxyModel.indexFromSubjectHierarchyItem(self.deepItemIDs[4]).isValid())
+
+        # Items added to a collapsed branch while filtering are shown too
+        modelNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLModelNode", "DeepModel_1_2_added")
+        addedItemID = self.shNode.GetItemByDataNode(modelNode)
+        self.shNode.SetItemParent(addedItemID, self.innerFolderItemIDs[1])
+        self.assertTrue(self.proxyModel.indexFromSubjectHierarchyItem(addedItemID).isValid())
+
+        # Clearing the filter shows all items and restores fetching on demand
+        self.proxyModel.setNameFilter("")
+        self.assertTrue(self.model.fetchOnDemand)
+        for deepItemID in self.deepItemIDs:
+            self.assertTrue(self.proxyModel.indexFromSubjectHierarchyItem(deepItemID).isValid())
@@ -86,6 +86,8 @@ public:
   QList<int> findNodeAttributeFilters(QString attributeName, bool include);
   /// Remove include or exclude filters from a given filter list
   void removeFiltersByIncludeFlag(QList<AttributeFilter>& filterList, bool include);
+  /// Returns true if any filter is set that may show items only if they match the filter
+  bool isFilterActive() const;
 
 private:
   /// Find attribute filter in given filter list
@@ -198,6 +200,14 @@ void qMRMLSortFilterSubjectHierarchyProxyModelPrivate::removeFiltersByIncludeFla
   }
 }
 
+// -----------------------------------------------------------------------------
+bool qMRMLSortFilterSubjectHierarchyProxyModelPrivate::isFilterActive() const
+{
+  return !this->NameFilter.isEmpty() || !this->LevelFilter.isEmpty() || !this->NodeTypes.isEmpty()       //
+         || this->HideItemsUnaffiliatedWithItemID != vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID //
+         || !this->ItemAttributeFilters.isEmpty() || !this->NodeAttributeFilters.isEmpty();
+}
+
 // -----------------------------------------------------------------------------
 // qMRMLSortFilterSubjectHierarchyProxyModel
 
@@ -246,6 +256,26 @@ vtkMRMLSubjectHierarchyNode* qMRMLSortFilterSubjectHierarchyProxyModel::subjectH
   return model->subjectHierarchyNode();
 }
 
+//-----------------------------------------------------------------------------
+void qMRMLSortFilterSubjectHierarchyProxyModel::setSourceModel(QAbstractItemModel* sourceModel)
+{
+  this->Superclass::setSourceModel(sourceModel);
+  this->updateFilter();
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLSortFilterSubjectHierarchyProxyModel::updateFilter()
+{
+  Q_D(qMRMLSortFilterSubjectHierarchyProxyModel);
+  // Items that match the filter must be in the source model even if they are in a collapsed branch
+  qMRMLSubjectHierarchyModel* model = qobject_cast<qMRMLSubjectHierarchyModel*>(this->sourceModel());
+  if (model)
+  {
+    model->setFetchOnDemand(!d->isFilterActive());
+  }
+  this->invalidateFilter();
+}
+
 //-----------------------------------------------------------------------------
 void qMRMLSortFilterSubjectHierarchyProxyModel::setNameFilter(QString filter)
 {
@@ -255,7 +285,7 @@ void qMRMLSortFilterSubjectHierarchyProxyModel::setNameFilter(QString filter)
     return;
   }
   d->NameFilter = filter;
-  this->invalidateFilter();
+  this->updateFilter();
 }
 
 //-----------------------------------------------------------------------------
@@ -269,7 +299,7 @@ void qMRMLSortFilterSubjectHierarchyProxyModel::addItemAttributeFilter(QString a
 
   qMRMLSortFilterSubjectHierarchyProxyModelPrivate::AttributeFilter newFilter(attributeName, attributeValue, include);
   d->ItemAttributeFilters << newFilter;
-  this->invalidateFilter();
+  this->updateFilter();
 }
 
 //-----------------------------------------------------------------------------
@@ -284,7 +314,7 @@ void qMRMLSortFilterSubjectHierarchyProxyModel::removeItemAttributeFilter(QStrin
   }
 
   d->ItemAttributeFilters.removeAt(foundIndex);
-  this->invalidateFilter();
+  this->updateFilter();
 }
 
 //-----------------------------------------------------------------------------
@@ -304,7 +334,7 @@ void qMRMLSortFilterSubjectHierarchyProxyModel::removeItemAttributeFilter(QStrin
     int lastIndex = foundIndices.takeLast();
     d->ItemAttributeFilters.removeAt(lastIndex);
   }
-  this->invalidateFilter();
+  this->updateFilter();
 }
 
 //-----------------------------------------------------------------------------
@@ -321,7 +351,7 @@ void qMRMLSortFilterSubjectHierarchyProxyModel::addNodeAttributeFilter(QString a
 
   qMRMLSortFilterSubjectHierarchyProxyModelPrivate::AttributeFilter newFilter(attributeName, attributeValue, include, className);
   d->NodeAttributeFilters << newFilter;
-  this->invalidateFilter();
+  this->updateFilter();
 }
 
 //-----------------------------------------------------------------------------
@@ -336,7 +366,7 @@ void qMRMLSortFilterSubjectHierarchyProxyModel::removeNodeAttributeFilter(QStrin
   }
 
   d->NodeAttributeFilters.removeAt(foundIndex);
-  this->invalidateFilter();
+  this->updateFilter();
 }
 
 //-----------------------------------------------------------------------------
@@ -356,7 +386,7 @@ void qMRMLSortFilterSubjectHierarchyProxyModel::removeNodeAttributeFilter(QStrin
     int lastIndex = foundIndices.takeLast();
     d->NodeAttributeFilters.removeAt(lastIndex);
   }
-  this->invalidateFilter();
+  this->updateFilter();
 }
 
 //-----------------------------------------------------------------------------
@@ -369,7 +399,7 @@ void qMRMLSortFilterSubjectHierarchyProxyModel::setIncludeItemAttributeNamesFilt
   {
     this->addItemAttributeFilter(filter);
   }
-  this->invalidateFilter();
+  this->updateFilter();
 }
 
 //-----------------------------------------------------------------------------
@@ -399,7 +429,7 @@ void qMRMLSortFilterSubjectHierarchyProxyModel::setIncludeNodeAttributeNamesFilt
   {
     this->addNodeAttributeFilter(filter);
   }
-  this->invalidateFilter();
+  this->updateFilter();
 }
 
 //-----------------------------------------------------------------------------
@@ -429,7 +459,7 @@ void qMRMLSortFilterSubjectHierarchyProxyModel::setExcludeItemAttributeNamesFilt
   {
     this->addItemAttributeFilter(filter, QString(), false);
   }
-  this->invalidateFilter();
+  this->updateFilter();
 }
 
 //-----------------------------------------------------------------------------
@@ -459,7 +489,7 @@ void qMRMLSortFilterSubjectHierarchyProxyModel::setExcludeNodeAttributeNamesFilt
   {
     this->addNodeAttributeFilter(filter, QString(), false);
   }
-  this->invalidateFilter();
+  this->updateFilter();
 }
 
 //-----------------------------------------------------------------------------
@@ -488,7 +518,7 @@ void qMRMLSortFilterSubjectHierarchyProxyModel::setAttributeNameFilter(QString f
   {
     this->addItemAttributeFilter(filter);
   }
-  this->invalidateFilter();
+  this->updateFilter();
   qWarning() << "qMRMLSortFilterSubjectHierarchyProxyModel::setAttributeNameFilter is deprecated, "
                 "use addItemAttributeFilter or removeItemAttributeFilter instead";
 }
@@ -515,7 +545,7 @@ void qMRMLSortFilterSubjectHierarchyProxyModel::setAttributeValueFilter(QString
   }
 
   d->ItemAttributeFilters[0].AttributeValue = filter;
-  this->invalidateFilter();
+  this->updateFilter();
   qWarning() << "qMRMLSortFilterSubjectHierarchyProxyModel::setAttributeValueFilter is deprecated,"
                 " use addItemAttributeFilter or removeItemAttributeFilter instead";
 }
@@ -540,7 +570,7 @@ void qMRMLSortFilterSubjectHierarchyProxyModel::setLevelFilter(QStringList filte
     return;
   }
   d->LevelFilter = filter;
-  this->invalidateFilter();
+  this->updateFilter();
 }
 
 // --------------------------------------------------------------------------
@@ -552,7 +582,7 @@ void qMRMLSortFilterSubjectHierarchyProxyModel::setNodeTypes(const QStringList&
     return;
   }
   d->NodeTypes = types;
-  this->invalidateFilter();
+  this->updateFilter();
 }
 
 //-----------------------------------------------------------------------------
@@ -564,7 +594,7 @@ void qMRMLSortFilterSubjectHierarchyProxyModel::setHideChildNodeTypes(const QStr
     return;
   }
   d->HideChildNodeTypes = types;
-  this->invalidateFilter();
+  this->updateFilter();
 }
 
 //-----------------------------------------------------------------------------
@@ -583,7 +613,7 @@ void qMRMLSortFilterSubjectHierarchyProxyModel::setHideItemsUnaffiliatedWithItem
     return;
   }
   d->HideItemsUnaffiliatedWithItemID = itemID;
-  this->invalidateFilter();
+  this->updateFilter();
 }
 
 //-----------------------------------------------------------------------------
@@ -602,7 +632,7 @@ void qMRMLSortFilterSubjectHierarchyProxyModel::setShowEmptyHierarchyItems(bool
     return;
   }
   d->ShowEmptyHierarchyItems = show;
-  this->invalidateFilter();
+  this->updateFilter();
 }
 
 //-----------------------------------------------------------------------------
@@ -626,6 +656,13 @@ QModelIndex qMRMLSortFilterSubjectHierarchyProxyModel::indexFromSubjectHierarchy
   return this->mapFromSource(sceneModel->indexFromSubjectHierarchyItem(itemID, column));
 }
 
+//-----------------------------------------------------------------------------
+QModelIndex qMRMLSortFilterSubjectHierarchyProxyModel::fetchedIndexFromSubjectHierarchyItem(vtkIdType itemID, int column) const
+{
+  qMRMLSubjectHierarchyModel* sceneModel = qobject_cast<qMRMLSubjectHierarchyModel*>(this->sourceModel());
+  return this->mapFromSource(sceneModel->fetchedIndexFromSubjectHierarchyItem(itemID, column));
+}
+
 //------------------------------------------------------------------------------
 int qMRMLSortFilterSubjectHierarchyProxyModel::acceptedItemCount(vtkIdType rootItemID /*=0*/) const
 {
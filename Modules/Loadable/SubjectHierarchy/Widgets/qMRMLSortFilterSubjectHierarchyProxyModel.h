@@ -150,8 +150,12 @@ public:
   /// Retrieve the associated subject hierarchy item ID from a model index
   Q_INVOKABLE vtkIdType subjectHierarchyItemFromIndex(const QModelIndex& index) const;
 
-  /// Retrieve an index for a given a subject hierarchy item ID
+  /// Retrieve an index for a given a subject hierarchy item ID. If the item is not in the source model yet
+  /// because the children of a collapsed ancestor have not been fetched then they are fetched first.
   Q_INVOKABLE QModelIndex indexFromSubjectHierarchyItem(vtkIdType itemID, int column = 0) const;
+  /// Retrieve an index for a given a subject hierarchy item ID without fetching children of collapsed items.
+  /// Returns an invalid index if the item is not in the source model yet. \sa indexFromSubjectHierarchyItem
+  Q_INVOKABLE QModelIndex fetchedIndexFromSubjectHierarchyItem(vtkIdType itemID, int column = 0) const;
 
   /// Determine the number of accepted (shown) items
   /// \param rootItemID Ancestor item of branch in which the accepted items are counted.
@@ -165,6 +169,10 @@ public:
 
   Qt::ItemFlags flags(const QModelIndex& index) const override;
 
+  /// Fetching on demand is disabled in the source model while any filter is set
+  /// \sa qMRMLSubjectHierarchyModel::fetchOnDemand
+  void setSourceModel(QAbstractItemModel* sourceModel) override;
+
 public slots:
   void setNameFilter(QString filter);
   void setAttributeNameFilter(QString filter);
@@ -198,6 +206,11 @@ protected:
 
   QStandardItem* sourceItem(const QModelIndex& index) const;
 
+  /// Re-evaluate the filter after the filter settings changed.
+  /// If any filter is set then all items are added to the source model, so that items that match the filter
+  /// are shown even if they are in a collapsed branch.
+  void updateFilter();
+
 protected:
   QScopedPointer<qMRMLSortFilterSubjectHierarchyProxyModelPrivate> d_ptr;
 
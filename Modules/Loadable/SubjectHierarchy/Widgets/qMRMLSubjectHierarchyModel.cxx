@@ -73,6 +73,9 @@ qMRMLSubjectHierarchyModelPrivate::qMRMLSubjectHierarchyModelPrivate(qMRMLSubjec
   , MRMLScene(nullptr)
   , TerminologiesModuleLogic(nullptr)
   , IsDroppedInside(false)
+  , PopulatingItems(false)
+  , HasUnfetchedItems(false)
+  , FetchOnDemand(true)
 {
   this->CallBack = vtkSmartPointer<vtkCallbackCommand>::New();
   this->PendingItemModified = -1; // -1 means not updating
@@ -115,6 +118,10 @@ void qMRMLSubjectHierarchyModelPrivate::init()
   this->CallBack->SetCallback(qMRMLSubjectHierarchyModel::onEvent);
 
   QObject::connect(q, SIGNAL(itemChanged(QStandardItem*)), q, SLOT(onItemChanged(QStandardItem*)));
+  // Connected before any view or proxy model, so that the item map is up-to-date when they are notified
+  QObject::connect(q, SIGNAL(rowsInserted(QModelIndex, int, int)), q, SLOT(onRowsInserted(QModelIndex, int, int)));
+  QObject::connect(q, SIGNAL(rowsAboutToBeRemoved(QModelIndex, int, int)), q, SLOT(onRowsAboutToBeRemoved(QModelIndex, int, int)));
+  QObject::connect(q, SIGNAL(modelAboutToBeReset()), q, SLOT(onModelAboutToBeReset()));
 
   q->setNameColumn(0);
   q->setDescriptionColumn(1);
@@ -161,14 +168,19 @@ QString qMRMLSubjectHierarchyModelPrivate::subjectHierarchyItemName(vtkIdType it
 QStandardItem* qMRMLSubjectHierarchyModelPrivate::insertSubjectHierarchyItem(vtkIdType itemID, int index)
 {
   Q_Q(qMRMLSubjectHierarchyModel);
-  QStandardItem* item = q->itemFromSubjectHierarchyItem(itemID);
+  QStandardItem* item = this->findItem(itemID);
   if (item)
   {
     // It is possible that the item has been already added if it is the parent of a child item already inserted
     return item;
   }
+  if (this->isInUnfetchedBranch(itemID))
+  {
+    // The item will be added to the model when the children of its ancestor are fetched
+    return nullptr;
+  }
   vtkIdType parentItemID = q->parentSubjectHierarchyItem(itemID);
-  QStandardItem* parentItem = q->itemFromSubjectHierarchyItem(parentItemID);
+  QStandardItem* parentItem = this->findItem(parentItemID);
   if (!parentItem)
   {
     if (!parentItemID)
@@ -184,7 +196,7 @@ QStandardItem* qMRMLSubjectHierarchyModelPrivate::insertSubjectHierarchyItem(vtk
     }
   }
   item = q->insertSubjectHierarchyItem(itemID, parentItem, index);
-  if (q->itemFromSubjectHierarchyItem(itemID) != item)
+  if (this->findItem(itemID) != item)
   {
     qCritical() << Q_FUNC_INFO << ": Item mismatch when inserting subject hierarchy item with ID " << itemID;
     return nullptr;
@@ -192,6 +204,218 @@ QStandardItem* qMRMLSubjectHierarchyModelPrivate::insertSubjectHierarchyItem(vtk
   return item;
 }
 
+//------------------------------------------------------------------------------
+QStandardItem* qMRMLSubjectHierarchyModelPrivate::findItem(vtkIdType itemID) const
+{
+  return this->ItemMap.value(itemID, nullptr);
+}
+
+//------------------------------------------------------------------------------
+QStandardItem* qMRMLSubjectHierarchyModelPrivate::fetchItem(vtkIdType itemID)
+{
+  QStandardItem* item = this->findItem(itemID);
+  if (item || this->PopulatingItems || !this->HasUnfetchedItems //
+      || !this->SubjectHierarchyNode || !this->SubjectHierarchyNode->HasItem(itemID))
+  {
+    return item;
+  }
+
+  // Find the closest ancestor that is in the model
+  std::vector<vtkIdType> missingAncestorIDs;
+  vtkIdType ancestorID = this->SubjectHierarchyNode->GetItemParent(itemID);
+  QStandardItem* ancestorItem = nullptr;
+  for (; ancestorID != vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID; ancestorID = this->SubjectHierarchyNode->GetItemParent(ancestorID))
+  {
+    ancestorItem = this->findItem(ancestorID);
+    if (ancestorItem)
+    {
+      break;
+    }
+    missingAncestorIDs.push_back(ancestorID);
+  }
+  if (!ancestorItem)
+  {
+    return nullptr;
+  }
+
+  // Fetch children from the top to the requested item
+  while (true)
+  {
+    if (this->hasUnfetchedChildren(ancestorItem))
+    {
+      this->populateChildren(ancestorID, ancestorItem);
+    }
+    if (missingAncestorIDs.empty())
+    {
+      break;
+    }
+    ancestorID = missingAncestorIDs.back();
+    missingAncestorIDs.pop_back();
+    ancestorItem = this->findItem(ancestorID);
+    if (!ancestorItem)
+    {
+      return nullptr;
+    }
+  }
+  return this->findItem(itemID);
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyModelPrivate::fetchAllItems()
+{
+  if (!this->HasUnfetchedItems)
+  {
+    return;
+  }
+  // Fetching modifies the item map, therefore unfetched items are collected first
+  QList<QStandardItem*> unfetchedItems;
+  for (QStandardItem* item : this->ItemMap)
+  {
+    if (this->hasUnfetchedChildren(item))
+    {
+      unfetchedItems << item;
+    }
+  }
+  bool wasFetchOnDemand = this->FetchOnDemand;
+  this->FetchOnDemand = false;
+  for (QStandardItem* item : unfetchedItems)
+  {
+    this->populateChildren(item->data(qMRMLSubjectHierarchyModel::SubjectHierarchyItemIDRole).toLongLong(), item);
+  }
+  this->FetchOnDemand = wasFetchOnDemand;
+  this->HasUnfetchedItems = false;
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLSubjectHierarchyModelPrivate::isInUnfetchedBranch(vtkIdType itemID) const
+{
+  if (!this->HasUnfetchedItems || !this->SubjectHierarchyNode)
+  {
+    return false;
+  }
+  for (vtkIdType ancestorID = this->SubjectHierarchyNode->GetItemParent(itemID); ancestorID != vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID;
+       ancestorID = this->SubjectHierarchyNode->GetItemParent(ancestorID))
+  {
+    QStandardItem* ancestorItem = this->findItem(ancestorID);
+    if (ancestorItem)
+    {
+      return this->hasUnfetchedChildren(ancestorItem);
+    }
+  }
+  return false;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyModelPrivate::populateChildren(vtkIdType itemID, QStandardItem* parentItem)
+{
+  Q_Q(qMRMLSubjectHierarchyModel);
+  if (!this->SubjectHierarchyNode || !parentItem)
+  {
+    return;
+  }
+  bool wasPopulatingItems = this->PopulatingItems;
+  this->PopulatingItems = true;
+  this->setUnfetchedChildren(parentItem, false);
+
+  // Rows are built with all their descendants under this item, which is not in the model,
+  // and then moved to the parent item at once
+  QStandardItem rowBuilderItem;
+  QStandardItem* insertParentItem = (parentItem->model() ? &rowBuilderItem : parentItem);
+
+  std::vector<vtkIdType> childItemIDs;
+  this->SubjectHierarchyNode->GetItemChildren(itemID, childItemIDs);
+  for (vtkIdType childItemID : childItemIDs)
+  {
+    QStandardItem* childItem = q->insertSubjectHierarchyItem(childItemID, insertParentItem);
+    if (!childItem)
+    {
+      continue;
+    }
+    if (this->SubjectHierarchyNode->GetNumberOfItemChildren(childItemID) > 0)
+    {
+      if (this->SubjectHierarchyNode->GetItemExpanded(childItemID) || !this->FetchOnDemand)
+      {
+        this->populateChildren(childItemID, childItem);
+      }
+      else
+      {
+        this->setUnfetchedChildren(childItem, true);
+      }
+    }
+    if (insertParentItem == &rowBuilderItem)
+    {
+      parentItem->appendRow(rowBuilderItem.takeRow(0));
+    }
+  }
+
+  this->PopulatingItems = wasPopulatingItems;
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLSubjectHierarchyModelPrivate::hasUnfetchedChildren(QStandardItem* item) const
+{
+  return item && item->data(qMRMLSubjectHierarchyModel::UnfetchedChildrenRole).toBool();
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyModelPrivate::setUnfetchedChildren(QStandardItem* item, bool unfetched)
+{
+  Q_Q(qMRMLSubjectHierarchyModel);
+  if (!item || this->hasUnfetchedChildren(item) == unfetched)
+  {
+    return;
+  }
+  // The flag is only used internally, no need to notify views
+  bool blocked = q->blockSignals(true);
+  item->setData(unfetched ? QVariant(true) : QVariant(), qMRMLSubjectHierarchyModel::UnfetchedChildrenRole);
+  q->blockSignals(blocked);
+  if (unfetched)
+  {
+    this->HasUnfetchedItems = true;
+  }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyModelPrivate::addToItemMap(QStandardItem* item)
+{
+  if (!item)
+  {
+    return;
+  }
+  QVariant itemID = item->data(qMRMLSubjectHierarchyModel::SubjectHierarchyItemIDRole);
+  if (itemID.isValid())
+  {
+    this->ItemMap[itemID.toLongLong()] = item;
+  }
+  for (int row = 0; row < item->rowCount(); ++row)
+  {
+    this->addToItemMap(item->child(row, 0));
+  }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyModelPrivate::removeFromItemMap(QStandardItem* item)
+{
+  if (!item)
+  {
+    return;
+  }
+  QVariant itemID = item->data(qMRMLSubjectHierarchyModel::SubjectHierarchyItemIDRole);
+  if (itemID.isValid())
+  {
+    // During drag-and-drop the new item is inserted before the original item is removed
+    QHash<vtkIdType, QStandardItem*>::iterator itemIt = this->ItemMap.find(itemID.toLongLong());
+    if (itemIt != this->ItemMap.end() && itemIt.value() == item)
+    {
+      this->ItemMap.erase(itemIt);
+    }
+  }
+  for (int row = 0; row < item->rowCount(); ++row)
+  {
+    this->removeFromItemMap(item->child(row, 0));
+  }
+}
+
 //------------------------------------------------------------------------------
 vtkSlicerTerminologiesModuleLogic* qMRMLSubjectHierarchyModelPrivate::terminologiesModuleLogic()
 {
@@ -466,74 +690,56 @@ QStandardItem* qMRMLSubjectHierarchyModel::itemFromSubjectHierarchyItem(vtkIdTyp
 QModelIndex qMRMLSubjectHierarchyModel::indexFromSubjectHierarchyItem(vtkIdType itemID, int column /*=0*/) const
 {
   Q_D(const qMRMLSubjectHierarchyModel);
-
-  QModelIndex itemIndex;
   if (!itemID)
   {
-    return itemIndex;
+    return QModelIndex();
   }
+  // Children of collapsed items may not be in the model yet. Fetching them does not change
+  // the content of the model as seen by the caller, only its population state.
+  const_cast<qMRMLSubjectHierarchyModelPrivate*>(d)->fetchItem(itemID);
+  return this->fetchedIndexFromSubjectHierarchyItem(itemID, column);
+}
 
-  // Try to find the nodeIndex in the cache first
-  QMap<vtkIdType, QPersistentModelIndex>::iterator rowCacheIt = d->RowCache.find(itemID);
-  if (rowCacheIt == d->RowCache.end())
-  {
-    // Not found in cache, therefore it cannot be in the model
-    return itemIndex;
-  }
-  if (rowCacheIt.value().isValid())
+//------------------------------------------------------------------------------
+QModelIndex qMRMLSubjectHierarchyModel::fetchedIndexFromSubjectHierarchyItem(vtkIdType itemID, int column /*=0*/) const
+{
+  Q_D(const qMRMLSubjectHierarchyModel);
+  if (!itemID)
   {
-    // An entry found in the cache. If the item at the cached index matches the requested item ID then we use it.
-    QStandardItem* item = this->itemFromIndex(rowCacheIt.value());
-    if (item && item->data(qMRMLSubjectHierarchyModel::SubjectHierarchyItemIDRole).toLongLong() == itemID)
-    {
-      // ID matched
-      itemIndex = rowCacheIt.value();
-    }
+    return QModelIndex();
   }
 
-  // The cache was not up-to-date. Do a slow linear search.
-  if (!itemIndex.isValid())
+  QStandardItem* item = d->findItem(itemID);
+  if (!item)
   {
-    // QAbstractItemModel::match doesn't browse through columns, we need to do it manually
-    QModelIndexList itemIndexes = this->match(this->subjectHierarchySceneIndex(), SubjectHierarchyItemIDRole, itemID, 1, Qt::MatchExactly | Qt::MatchRecursive);
-    if (itemIndexes.size() == 0)
-    {
-      d->RowCache.remove(itemID);
-      return QModelIndex();
-    }
-    itemIndex = itemIndexes[0];
-    d->RowCache[itemID] = itemIndex;
+    return QModelIndex();
   }
+  QModelIndex itemIndex = item->index();
   if (column == 0)
   {
-    // QAbstractItemModel::match only search through the first column
     return itemIndex;
   }
-  // Add the QModelIndexes from the other columns
-  const int row = itemIndex.row();
+  // Get the QModelIndex from the other columns
   QModelIndex nodeParentIndex = itemIndex.parent();
   if (column >= this->columnCount(nodeParentIndex))
   {
     qCritical() << Q_FUNC_INFO << ": Invalid column " << column;
     return QModelIndex();
   }
-  return ctk::modelChildIndex(const_cast<qMRMLSubjectHierarchyModel*>(this), nodeParentIndex, row, column);
+  return ctk::modelChildIndex(const_cast<qMRMLSubjectHierarchyModel*>(this), nodeParentIndex, itemIndex.row(), column);
 }
 
 //------------------------------------------------------------------------------
 QModelIndexList qMRMLSubjectHierarchyModel::indexes(vtkIdType itemID) const
 {
-  QModelIndex scene = this->subjectHierarchySceneIndex();
-  if (scene == QModelIndex())
-  {
-    return QModelIndexList();
-  }
-  // QAbstractItemModel::match doesn't browse through columns, we need to do it manually
-  QModelIndexList shItemIndexes = this->match(scene, qMRMLSubjectHierarchyModel::SubjectHierarchyItemIDRole, QVariant(qlonglong(itemID)), 1, Qt::MatchExactly | Qt::MatchRecursive);
-  if (shItemIndexes.size() != 1)
+  Q_D(const qMRMLSubjectHierarchyModel);
+  QModelIndexList shItemIndexes;
+  QStandardItem* item = d->findItem(itemID);
+  if (!item)
   {
-    return QModelIndexList(); // If 0 it's empty, if >1 it's invalid (one item for each UID)
+    return shItemIndexes;
   }
+  shItemIndexes << item->index();
   // Add the QModelIndexes from the other columns
   const int row = shItemIndexes[0].row();
   QModelIndex shItemParentIndex = shItemIndexes[0].parent();
@@ -773,57 +979,37 @@ void qMRMLSubjectHierarchyModel::rebuildFromSubjectHierarchy()
 {
   Q_D(qMRMLSubjectHierarchyModel);
 
-  d->RowCache.clear();
-
   // Enabled so it can be interacted with
   this->invisibleRootItem()->setFlags(Qt::ItemIsEnabled);
 
+  // Remove all items
+  const int oldColumnCount = this->columnCount();
+  this->removeRows(0, this->rowCount());
+  this->setColumnCount(oldColumnCount);
+  d->ItemMap.clear();
+  d->HasUnfetchedItems = false;
+
   if (!d->SubjectHierarchyNode)
   {
-    // Remove all items
-    const int oldColumnCount = this->columnCount();
-    this->removeRows(0, this->rowCount());
-    this->setColumnCount(oldColumnCount);
     return;
   }
-  else if (!this->subjectHierarchySceneItem())
-  {
-    // No subject hierarchy root item has been created yet, but the subject hierarchy
-    // node is valid, so we need to create a scene item
-    vtkIdType sceneItemID = d->SubjectHierarchyNode->GetSceneItemID();
-    QList<QStandardItem*> sceneItems;
-    QStandardItem* sceneItem = new QStandardItem();
-    sceneItem->setFlags(Qt::ItemIsDropEnabled | Qt::ItemIsEnabled);
-    sceneItem->setText("Scene");
-    sceneItem->setData(sceneItemID, qMRMLSubjectHierarchyModel::SubjectHierarchyItemIDRole);
-    sceneItems << sceneItem;
-    for (int i = 1; i < this->columnCount(); ++i)
-    {
-      QStandardItem* sceneOtherColumn = new QStandardItem();
-      sceneOtherColumn->setFlags(Qt::NoItemFlags);
-      sceneItems << sceneOtherColumn;
-    }
-    sceneItem->setColumnCount(this->columnCount());
 
-    d->RowCache[sceneItemID] = QModelIndex(); // Insert invalid item in cache to indicate that item is in the model but its index is unknown
-    this->insertRow(0, sceneItems);
-    d->RowCache[sceneItemID] = sceneItem->index();
-  }
-  else
+  // Create the scene item. It is populated before it is added to the model,
+  // so that views are only notified about one inserted row.
+  vtkIdType sceneItemID = d->SubjectHierarchyNode->GetSceneItemID();
+  QList<QStandardItem*> sceneItems;
+  QStandardItem* sceneItem = new QStandardItem();
+  sceneItem->setFlags(Qt::ItemIsDropEnabled | Qt::ItemIsEnabled);
+  sceneItem->setText("Scene");
+  sceneItem->setData(sceneItemID, qMRMLSubjectHierarchyModel::SubjectHierarchyItemIDRole);
+  sceneItems << sceneItem;
+  for (int i = 1; i < this->columnCount(); ++i)
   {
-    // Update the scene item index in case subject hierarchy node has changed
-    this->subjectHierarchySceneItem()->setData(QVariant::fromValue(d->SubjectHierarchyNode->GetSceneItemID()), qMRMLSubjectHierarchyModel::SubjectHierarchyItemIDRole);
-    d->RowCache[d->SubjectHierarchyNode->GetSceneItemID()] = this->subjectHierarchySceneItem()->index();
+    QStandardItem* sceneOtherColumn = new QStandardItem();
+    sceneOtherColumn->setFlags(Qt::NoItemFlags);
+    sceneItems << sceneOtherColumn;
   }
-
-  if (!this->subjectHierarchySceneItem())
-  {
-    qCritical() << Q_FUNC_INFO << ": Failed to create subject hierarchy scene item";
-    return;
-  }
-
-  // Remove rows before populating
-  this->subjectHierarchySceneItem()->removeRows(0, this->subjectHierarchySceneItem()->rowCount());
+  sceneItem->setColumnCount(this->columnCount());
 
   // Insert None item on top if enabled
   if (d->NoneEnabled)
@@ -845,24 +1031,31 @@ void qMRMLSubjectHierarchyModel::rebuildFromSubjectHierarchy()
       }
       items.append(newItem);
     }
-    this->subjectHierarchySceneItem()->insertRow(0, items);
+    sceneItem->insertRow(0, items);
   }
 
-  // Populate subject hierarchy with the items
-  std::vector<vtkIdType> allItemIDs;
-  d->SubjectHierarchyNode->GetItemChildren(d->SubjectHierarchyNode->GetSceneItemID(), allItemIDs, true);
-  for (std::vector<vtkIdType>::iterator itemIt = allItemIDs.begin(); itemIt != allItemIDs.end(); ++itemIt)
+  // Populate subject hierarchy with the items. Children of collapsed items are added when they are fetched.
+  d->populateChildren(sceneItemID, sceneItem);
+
+  this->insertRow(0, sceneItems);
+  if (!this->subjectHierarchySceneItem())
   {
-    vtkIdType itemID = (*itemIt);
-    int index = this->subjectHierarchyItemIndex(itemID);
-    d->insertSubjectHierarchyItem(itemID, index);
+    qCritical() << Q_FUNC_INFO << ": Failed to create subject hierarchy scene item";
+    return;
   }
 
   // Update expanded states (during inserting the update calls did not find valid indices, so
   // expand and collapse statuses were not set in the tree view)
+  std::vector<vtkIdType> allItemIDs;
+  d->SubjectHierarchyNode->GetItemChildren(sceneItemID, allItemIDs, true);
   for (std::vector<vtkIdType>::iterator itemIt = allItemIDs.begin(); itemIt != allItemIDs.end(); ++itemIt)
   {
     vtkIdType itemID = (*itemIt);
+    if (!d->findItem(itemID))
+    {
+      // Not fetched yet
+      continue;
+    }
     // Expanded states are handled with the name column
     QStandardItem* item = this->itemFromSubjectHierarchyItem(itemID, this->nameColumn());
     this->updateItemDataFromSubjectHierarchyItem(item, itemID, this->nameColumn());
@@ -889,7 +1082,7 @@ QStandardItem* qMRMLSubjectHierarchyModel::insertSubjectHierarchyItem(vtkIdType
     if (previousItemID != vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID)
     {
       // Get the index of the previous item in the model
-      QStandardItem* previousItem = this->itemFromSubjectHierarchyItem(previousItemID);
+      QStandardItem* previousItem = d->findItem(previousItemID);
       if (previousItem)
       {
         // Get the index of the previous item in the model and increment it by one to get the insertion position
@@ -904,8 +1097,6 @@ QStandardItem* qMRMLSubjectHierarchyModel::insertSubjectHierarchyItem(vtkIdType
 //------------------------------------------------------------------------------
 QStandardItem* qMRMLSubjectHierarchyModel::insertSubjectHierarchyItem(vtkIdType itemID, QStandardItem* parent, int row /*=-1*/)
 {
-  Q_D(qMRMLSubjectHierarchyModel);
-
   if (!parent)
   {
     // The scene is inserted individually, and the other items must always have a valid parent (if not other then the scene)
@@ -921,10 +1112,8 @@ QStandardItem* qMRMLSubjectHierarchyModel::insertSubjectHierarchyItem(vtkIdType
     items.append(newItem);
   }
 
-  // Insert an invalid item in the cache to indicate that the subject hierarchy item is in the
-  // model but we don't know its index yet. This is needed because a custom widget may be notified
-  // about row insertion before insertRow() returns (and the RowCache entry is added).
-  d->RowCache[itemID] = QModelIndex();
+  // The item map is updated in onRowsInserted, before views and proxy models are notified
+  // about the row insertion (a custom widget may look up the item before insertRow() returns).
   if (row >= 0)
   {
     parent->insertRow(row, items);
@@ -933,7 +1122,6 @@ QStandardItem* qMRMLSubjectHierarchyModel::insertSubjectHierarchyItem(vtkIdType
   {
     parent->appendRow(items);
   }
-  d->RowCache[itemID] = items[0]->index();
 
   return items[0];
 }
@@ -1011,7 +1199,7 @@ void qMRMLSubjectHierarchyModel::updateItemFromSubjectHierarchyItem(QStandardIte
   if (this->canBeAChild(shItemID))
   {
     QStandardItem* parentItem = item->parent();
-    QStandardItem* newParentItem = this->itemFromSubjectHierarchyItem(this->parentSubjectHierarchyItem(shItemID));
+    QStandardItem* newParentItem = d->findItem(this->parentSubjectHierarchyItem(shItemID));
     if (!newParentItem)
     {
       newParentItem = this->subjectHierarchySceneItem();
@@ -1472,7 +1660,16 @@ void qMRMLSubjectHierarchyModel::updateModelItems(vtkIdType itemID)
   if (!itemIndexes.count())
   {
     // Can happen while the item is added, the plugin handler sets the owner plugin, which triggers
-    // item modified before it can be inserted to the model
+    // item modified before it can be inserted to the model.
+    // Also happens if the item is under a collapsed item that has not been fetched yet.
+    return;
+  }
+  if (d->isInUnfetchedBranch(itemID))
+  {
+    // The item has been moved under an item whose children have not been fetched yet.
+    // Remove it from the model, it is added again when the children of its new parent are fetched.
+    QModelIndex itemIndex = itemIndexes[0];
+    this->removeRow(itemIndex.row(), itemIndex.parent());
     return;
   }
 
@@ -1553,6 +1750,12 @@ void qMRMLSubjectHierarchyModel::onEvent(vtkObject* caller, unsigned long event,
 //------------------------------------------------------------------------------
 void qMRMLSubjectHierarchyModel::onSubjectHierarchyItemAdded(vtkIdType itemID)
 {
+  Q_D(qMRMLSubjectHierarchyModel);
+  if (d->MRMLScene && d->MRMLScene->IsBatchProcessing())
+  {
+    // The model is rebuilt in one pass when batch processing ends
+    return;
+  }
   this->insertSubjectHierarchyItem(itemID);
 }
 
@@ -1565,10 +1768,9 @@ void qMRMLSubjectHierarchyModel::onSubjectHierarchyItemAboutToBeRemoved(vtkIdTyp
     return;
   }
 
-  QModelIndexList itemIndexes = this->match(this->subjectHierarchySceneIndex(), SubjectHierarchyItemIDRole, itemID, 1, Qt::MatchExactly | Qt::MatchRecursive);
-  if (itemIndexes.count() > 0)
+  QStandardItem* item = d->findItem(itemID);
+  if (item)
   {
-    QStandardItem* item = this->itemFromIndex(itemIndexes[0].sibling(itemIndexes[0].row(), 0));
     // The children may be lost if not reparented, we ensure they got reparented.
     while (item->rowCount())
     {
@@ -1583,7 +1785,8 @@ void qMRMLSubjectHierarchyModel::onSubjectHierarchyItemAboutToBeRemoved(vtkIdTyp
         d->Orphans.removeAll(orphans);
       }
     }
-    this->removeRow(itemIndexes[0].row(), itemIndexes[0].parent());
+    QModelIndex itemIndex = item->index();
+    this->removeRow(itemIndex.row(), itemIndex.parent());
   }
 }
 
@@ -1607,8 +1810,14 @@ void qMRMLSubjectHierarchyModel::onSubjectHierarchyItemRemoved(vtkIdType removed
       continue;
     }
     vtkIdType itemID = this->subjectHierarchyItemFromItem(orphan);
+    if (d->isInUnfetchedBranch(itemID))
+    {
+      // The orphan will be added again when the children of its new parent are fetched
+      qDeleteAll(orphans);
+      continue;
+    }
     int newIndex = this->subjectHierarchyItemIndex(itemID);
-    QStandardItem* newParentItem = this->itemFromSubjectHierarchyItem(this->parentSubjectHierarchyItem(itemID));
+    QStandardItem* newParentItem = d->findItem(this->parentSubjectHierarchyItem(itemID));
     if (!newParentItem)
     {
       newParentItem = this->subjectHierarchySceneItem();
@@ -1636,10 +1845,18 @@ void qMRMLSubjectHierarchyModel::onSubjectHierarchyItemChildrenReordered(vtkIdTy
     return;
   }
 
-  QStandardItem* newParentItem = this->itemFromSubjectHierarchyItem(parentItemID);
+  QStandardItem* newParentItem = d->findItem(parentItemID);
   if (!newParentItem)
   {
-    qWarning() << Q_FUNC_INFO << ": parent item not found by ID" << parentItemID;
+    if (!d->isInUnfetchedBranch(parentItemID))
+    {
+      qWarning() << Q_FUNC_INFO << ": parent item not found by ID" << parentItemID;
+    }
+    return;
+  }
+  if (d->hasUnfetchedChildren(newParentItem))
+  {
+    // Children will be added in the correct order when they are fetched
     return;
   }
 
@@ -1649,7 +1866,7 @@ void qMRMLSubjectHierarchyModel::onSubjectHierarchyItemChildrenReordered(vtkIdTy
   {
     vtkIdType childItemID = childrenItemIDs[positionInShNode];
 
-    QStandardItem* childItem = this->itemFromSubjectHierarchyItem(childItemID);
+    QStandardItem* childItem = d->findItem(childItemID);
     if (!childItem)
     {
       qWarning() << Q_FUNC_INFO << ": child item not found by ID" << childItemID;
@@ -1662,7 +1879,7 @@ void qMRMLSubjectHierarchyModel::onSubjectHierarchyItemChildrenReordered(vtkIdTy
       continue;
     }
 
-    int formerChildPosition = this->indexFromSubjectHierarchyItem(childItemID).row();
+    int formerChildPosition = childItem->row();
     if (newParentItem != formerParentItem || positionInShNode != formerChildPosition)
     {
       // Reparent/reorder item in model
@@ -1912,6 +2129,70 @@ void qMRMLSubjectHierarchyModel::delayedItemChanged()
   d->IsDroppedInside = false;
 }
 
+//------------------------------------------------------------------------------
+bool qMRMLSubjectHierarchyModel::hasChildren(const QModelIndex& parent /*=QModelIndex()*/) const
+{
+  Q_D(const qMRMLSubjectHierarchyModel);
+  if (parent.isValid() && d->hasUnfetchedChildren(this->itemFromIndex(parent)))
+  {
+    return true;
+  }
+  return this->Superclass::hasChildren(parent);
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLSubjectHierarchyModel::canFetchMore(const QModelIndex& parent) const
+{
+  Q_D(const qMRMLSubjectHierarchyModel);
+  if (parent.isValid() && d->hasUnfetchedChildren(this->itemFromIndex(parent)))
+  {
+    return true;
+  }
+  return this->Superclass::canFetchMore(parent);
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyModel::fetchMore(const QModelIndex& parent)
+{
+  Q_D(qMRMLSubjectHierarchyModel);
+  QStandardItem* parentItem = (parent.isValid() ? this->itemFromIndex(parent) : nullptr);
+  if (!d->hasUnfetchedChildren(parentItem))
+  {
+    this->Superclass::fetchMore(parent);
+    return;
+  }
+  d->populateChildren(this->subjectHierarchyItemFromItem(parentItem), parentItem);
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyModel::onRowsInserted(const QModelIndex& parent, int first, int last)
+{
+  Q_D(qMRMLSubjectHierarchyModel);
+  QStandardItem* parentItem = (parent.isValid() ? this->itemFromIndex(parent) : this->invisibleRootItem());
+  for (int row = first; row <= last; ++row)
+  {
+    d->addToItemMap(parentItem->child(row, 0));
+  }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyModel::onRowsAboutToBeRemoved(const QModelIndex& parent, int first, int last)
+{
+  Q_D(qMRMLSubjectHierarchyModel);
+  QStandardItem* parentItem = (parent.isValid() ? this->itemFromIndex(parent) : this->invisibleRootItem());
+  for (int row = first; row <= last; ++row)
+  {
+    d->removeFromItemMap(parentItem->child(row, 0));
+  }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyModel::onModelAboutToBeReset()
+{
+  Q_D(qMRMLSubjectHierarchyModel);
+  d->ItemMap.clear();
+}
+
 //------------------------------------------------------------------------------
 Qt::DropActions qMRMLSubjectHierarchyModel::supportedDropActions() const
 {
@@ -2050,6 +2331,28 @@ QString qMRMLSubjectHierarchyModel::noneDisplay() const
   return d->NoneDisplay;
 }
 
+//--------------------------------------------------------------------------
+bool qMRMLSubjectHierarchyModel::fetchOnDemand() const
+{
+  Q_D(const qMRMLSubjectHierarchyModel);
+  return d->FetchOnDemand;
+}
+
+//--------------------------------------------------------------------------
+void qMRMLSubjectHierarchyModel::setFetchOnDemand(bool enable)
+{
+  Q_D(qMRMLSubjectHierarchyModel);
+  if (d->FetchOnDemand == enable)
+  {
+    return;
+  }
+  d->FetchOnDemand = enable;
+  if (!enable)
+  {
+    d->fetchAllItems();
+  }
+}
+
 //------------------------------------------------------------------------------
 void qMRMLSubjectHierarchyModel::updateColumnCount()
 {
@@ -46,6 +46,12 @@ class vtkMRMLScene;
 /// but only the individual items are updated when per-item events are invoked (such as
 /// vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemModifiedEvent)
 ///
+/// Model items are populated lazily: children of collapsed subject hierarchy items are only added to
+/// the model when they are fetched (see canFetchMore() and fetchMore()), which happens when the item
+/// is expanded in a view or when the item or its descendants are requested by indexFromSubjectHierarchyItem().
+/// Items are added and removed in one pass when the scene batch processing ends.
+/// \sa fetchOnDemand
+///
 class Q_SLICER_MODULE_SUBJECTHIERARCHY_WIDGETS_EXPORT qMRMLSubjectHierarchyModel : public QStandardItemModel
 {
   Q_OBJECT
@@ -83,6 +89,11 @@ class Q_SLICER_MODULE_SUBJECTHIERARCHY_WIDGETS_EXPORT qMRMLSubjectHierarchyModel
   /// "None" by default.
   /// \sa noneItemEnabled
   Q_PROPERTY(QString noneDisplay READ noneDisplay WRITE setNoneDisplay)
+  /// This property controls whether children of collapsed subject hierarchy items are only added to the model
+  /// when they are fetched. If disabled then all items are added to the model.
+  /// qMRMLSortFilterSubjectHierarchyProxyModel disables it while a filter is set, so that all matching items are in the model.
+  /// Enabled by default.
+  Q_PROPERTY(bool fetchOnDemand READ fetchOnDemand WRITE setFetchOnDemand)
 
 public:
   typedef QStandardItemModel Superclass;
@@ -98,6 +109,8 @@ public:
     VisibilityRole,
     /// MRML node ID of the parent transform
     TransformIDRole,
+    /// Boolean that is true if the item has children in the subject hierarchy that have not been added to the model yet
+    UnfetchedChildrenRole,
     /// Must stay the last enum in the list.
     LastRole
   };
@@ -126,6 +139,13 @@ public:
   QString noneDisplay() const;
   void setNoneDisplay(const QString& displayName);
 
+  bool fetchOnDemand() const;
+  void setFetchOnDemand(bool enable);
+
+  bool hasChildren(const QModelIndex& parent = QModelIndex()) const override;
+  bool canFetchMore(const QModelIndex& parent) const override;
+  void fetchMore(const QModelIndex& parent) override;
+
   Qt::DropActions supportedDropActions() const override;
   QMimeData* mimeData(const QModelIndexList& indexes) const override;
   bool dropMimeData(const QMimeData* data, Qt::DropAction action, int row, int column, const QModelIndex& parent) override;
@@ -144,10 +164,17 @@ public:
 
   vtkIdType subjectHierarchyItemFromIndex(const QModelIndex& index) const;
   vtkIdType subjectHierarchyItemFromItem(QStandardItem* item) const;
+  /// Get the index of a subject hierarchy item. If the item is not in the model yet because the children
+  /// of a collapsed ancestor have not been fetched, then the children of its ancestors are fetched first.
+  /// \sa fetchedIndexFromSubjectHierarchyItem
   QModelIndex indexFromSubjectHierarchyItem(vtkIdType itemID, int column = 0) const;
   QStandardItem* itemFromSubjectHierarchyItem(vtkIdType itemID, int column = 0) const;
+  /// Get the index of a subject hierarchy item without fetching the children of its ancestors.
+  /// Returns an invalid index if the item is not in the model yet. \sa indexFromSubjectHierarchyItem
+  Q_INVOKABLE QModelIndex fetchedIndexFromSubjectHierarchyItem(vtkIdType itemID, int column = 0) const;
 
-  /// Return all the QModelIndexes (all the columns) for a given subject hierarchy item
+  /// Return all the QModelIndexes (all the columns) for a given subject hierarchy item.
+  /// Returns an empty list if the item is not in the model yet. \sa fetchedIndexFromSubjectHierarchyItem
   QModelIndexList indexes(vtkIdType itemID) const;
 
   Q_INVOKABLE virtual vtkIdType parentSubjectHierarchyItem(vtkIdType itemID) const;
@@ -206,6 +233,11 @@ protected slots:
   virtual void onItemChanged(QStandardItem* item);
   virtual void delayedItemChanged();
 
+  /// Keep the item ID to model item map up-to-date when model rows are added or removed
+  void onRowsInserted(const QModelIndex& parent, int first, int last);
+  void onRowsAboutToBeRemoved(const QModelIndex& parent, int first, int last);
+  void onModelAboutToBeReset();
+
   /// Recompute the number of columns in the model. Called when a [some]Column property is set.
   /// Needs maxColumnId() to be reimplemented in subclasses
   void updateColumnCount();
@@ -36,6 +36,7 @@
 
 // Qt includes
 #include <QFlags>
+#include <QHash>
 #include <QMap>
 
 // SubjectHierarchy includes
@@ -75,6 +76,37 @@ public:
   /// happening in qMRMLSubjectHierarchyModel::subjectHierarchyItemIndex(vtkIdType).
   virtual QStandardItem* insertSubjectHierarchyItem(vtkIdType itemID, int index);
 
+  /// Get the model item (first column) of a subject hierarchy item. Returns nullptr if the item is not in the model,
+  /// for example because the children of one of its ancestors have not been fetched yet.
+  QStandardItem* findItem(vtkIdType itemID) const;
+
+  /// Get the model item (first column) of a subject hierarchy item. If the item is not in the model yet because
+  /// the children of an ancestor have not been fetched, then children of the ancestors are fetched.
+  QStandardItem* fetchItem(vtkIdType itemID);
+
+  /// Add all items whose children have not been fetched yet to the model
+  void fetchAllItems();
+
+  /// Add model items for all children of a subject hierarchy item to the parent model item.
+  /// Children of collapsed items are not added if FetchOnDemand is enabled, only marked with UnfetchedChildrenRole.
+  /// Each child row is created with all its descendants before it is added to the parent, so that
+  /// only one row insertion is notified for each child of an item that is already in the model.
+  void populateChildren(vtkIdType itemID, QStandardItem* parentItem);
+
+  /// Returns true if the closest ancestor of the item that is in the model has children that are not fetched yet,
+  /// i.e. the item is expected to be missing from the model.
+  bool isInUnfetchedBranch(vtkIdType itemID) const;
+
+  /// Returns true if the item has children in the subject hierarchy that are not in the model yet
+  bool hasUnfetchedChildren(QStandardItem* item) const;
+  /// Set or clear the flag indicating that the children of the item are not in the model yet
+  void setUnfetchedChildren(QStandardItem* item, bool unfetched);
+
+  /// Add the item and all its descendants to the item map
+  void addToItemMap(QStandardItem* item);
+  /// Remove the item and all its descendants from the item map
+  void removeFromItemMap(QStandardItem* item);
+
   /// Convenience function to get name for subject hierarchy item
   QString subjectHierarchyItemName(vtkIdType itemID);
 
@@ -144,11 +176,19 @@ public:
   // unreachable when browsing the model
   QList<QList<QStandardItem*>> Orphans;
 
-  // Map from subject hierarchy item to row.
-  // It just stores the result of the latest lookup by \sa indexFromSubjectHierarchyItem,
-  // not guaranteed to contain up-to-date information, should be just used as a search hint.
-  // If the item cannot be found at the given index then we need to browse through all model items.
-  mutable QMap<vtkIdType, QPersistentModelIndex> RowCache;
+  // Map from subject hierarchy item to the model item in the first column.
+  // It is updated when rows are inserted to or removed from the model, therefore it always contains
+  // exactly the items that are in the model (moved rows are removed and then added again).
+  QHash<vtkIdType, QStandardItem*> ItemMap;
+
+  /// Set while model items are being created. Items are not fetched on demand during this time,
+  /// because the item lookups come from the items that are being created.
+  bool PopulatingItems;
+  /// Set when any item is added with unfetched children. If not set then items that are not
+  /// in the model do not need to be looked up in the subject hierarchy.
+  bool HasUnfetchedItems;
+  /// If disabled then children of collapsed items are added to the model as well
+  bool FetchOnDemand;
 };
 
 #endif
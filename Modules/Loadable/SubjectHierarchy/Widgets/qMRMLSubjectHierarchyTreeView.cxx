@@ -1672,7 +1672,8 @@ void qMRMLSubjectHierarchyTreeView::collapseItem(vtkIdType itemID)
   Q_D(qMRMLSubjectHierarchyTreeView);
   if (itemID)
   {
-    QModelIndex itemIndex = d->SortFilterModel->indexFromSubjectHierarchyItem(itemID);
+    // Items that are not in the model yet are already collapsed
+    QModelIndex itemIndex = d->SortFilterModel->fetchedIndexFromSubjectHierarchyItem(itemID);
     if (itemIndex.isValid())
     {
       this->collapse(itemIndex);
@@ -2573,36 +2574,26 @@ vtkMRMLNode* qMRMLSubjectHierarchyTreeView::findFirstNodeByClass(const QString&
 {
   Q_D(const qMRMLSubjectHierarchyTreeView);
   qMRMLSortFilterSubjectHierarchyProxyModel* model = this->sortFilterProxyModel();
-  const QModelIndex& rootIndex = model->indexFromSubjectHierarchyItem(this->rootItem());
-
-  QList<QModelIndex> indexes;
-  indexes << rootIndex;
-  while (!indexes.isEmpty())
+  vtkIdType rootItemID = this->rootItem();
+  if (!d->SubjectHierarchyNode || !model || !rootItemID)
   {
-    QModelIndex index = indexes.takeFirst();
-    if (!index.isValid())
-    {
-      continue;
-    }
+    return nullptr;
+  }
 
-    // Return if this is a node that is of the requested class
-    vtkIdType itemID = model->subjectHierarchyItemFromIndex(index);
+  // Items are looked up in the subject hierarchy, because children of collapsed items may not be in the model yet
+  std::vector<vtkIdType> itemIDs;
+  d->SubjectHierarchyNode->GetItemChildren(rootItemID, itemIDs, true);
+  itemIDs.insert(itemIDs.begin(), rootItemID);
+  for (vtkIdType itemID : itemIDs)
+  {
+    // Return if this is a node that is shown and is of the requested class
     vtkMRMLNode* dataNode = d->SubjectHierarchyNode->GetItemDataNode(itemID);
-    if (dataNode && dataNode->IsA(className.toStdString().c_str()))
+    if (dataNode && dataNode->IsA(className.toStdString().c_str()) //
+        && model->filterAcceptsItem(itemID) != qMRMLSortFilterSubjectHierarchyProxyModel::Reject)
     {
       // found a suitable data node
       return dataNode;
     }
-
-    // Add item children to the list
-    if (model->hasChildren(index) && !(index.flags() & Qt::ItemNeverHasChildren))
-    {
-      // depth-first search (children are added to the front of the list)
-      for (int i = model->rowCount() - 1; i >= 0; --i)
-      {
-        indexes.push_front(model->index(i, 0, index));
-      }
-    }
   }
 
   // not found a suitable data node
@@ -90,15 +90,13 @@ class DataProbeInfoWidget:
         self.showImage = False
 
         # Used in _createMagnifiedPixmap()
-        self.imageCrop = vtk.vtkExtractVOI()
-        self.canvas = vtk.vtkImageCanvasSource2D()
+        self.magnifiedImage = vtk.vtkImageData()
         self.painter = qt.QPainter()
-        self.pen = qt.QPen()
 
         self._createSmall()
 
-        # Helper class to calculate and display tensor scalars
-        self.calculateTensorScalars = CalculateTensorScalars()
+        # Helper class to calculate tensor scalars in getPixelString, created when first needed
+        self.calculateTensorScalars = None
 
         # Observe the crosshair node to get the current cursor position
         self.CrosshairNode = slicer.mrmlScene.GetFirstNodeByClass("vtkMRMLCrosshairNode")
@@ -123,12 +121,46 @@ class DataProbeInfoWidget:
             self.CrosshairNode.RemoveObserver(self.CrosshairNodeObserverTag)
         self.CrosshairNodeObserverTag = None
 
+    # TODO: the volume nodes should have a way to generate
+    # these strings in a generic way
+
+    @staticmethod
+    def formatLabelString(labelName, labelIndex):
+        """Format the description of a label map voxel."""
+        if not labelName:
+            labelName = _("Unknown")
+        return "%s (%d)" % (labelName, labelIndex)
+
+    @staticmethod
+    def formatTensorString(invariantName, value):
+        """Format the description of a tensor voxel from its scalar invariant."""
+        if value is None:
+            return invariantName
+        valueString = ("%f" % value).rstrip("0").rstrip(".")
+        return f"{invariantName} {valueString}"
+
+    @staticmethod
+    def formatComponentsString(numberOfComponents, getComponent):
+        """Format the scalar components of a voxel as a comma separated list.
+        getComponent(c) returns the value of component c.
+        """
+        if numberOfComponents > 4:
+            return _("{numberOfComponents} components").format(numberOfComponents=numberOfComponents)
+        componentStrings = []
+        for c in range(numberOfComponents):
+            component = getComponent(c)
+            if component.is_integer():
+                component = int(component)
+            # format string according to suggestion here:
+            # https://stackoverflow.com/questions/2440692/formatting-floats-in-python-without-superfluous-zeros
+            # also set the default field width for each coordinate
+            componentStrings.append(("%4f" % component).rstrip("0").rstrip("."))
+        return ", ".join(componentStrings)
+
     def getPixelString(self, volumeNode, ijk):
         """Given a volume node, create a human readable
         string describing the contents
         """
-        # TODO: the volume nodes should have a way to generate
-        # these strings in a generic way
         if not volumeNode:
             return _("No volume")
         imageData = volumeNode.GetImageData()
@@ -138,16 +170,15 @@ class DataProbeInfoWidget:
         for ele in range(3):
             if ijk[ele] < 0 or ijk[ele] >= dims[ele]:
                 return _("Out of Frame")
-        pixel = ""
         if volumeNode.IsA("vtkMRMLLabelMapVolumeNode"):
             labelIndex = int(imageData.GetScalarComponentAsDouble(ijk[0], ijk[1], ijk[2], 0))
-            labelValue = _("Unknown")
+            labelValue = None
             displayNode = volumeNode.GetDisplayNode()
             if displayNode:
                 colorNode = displayNode.GetColorNode()
                 if colorNode:
                     labelValue = colorNode.GetColorName(labelIndex)
-            return "%s (%d)" % (labelValue, labelIndex)
+            return self.formatLabelString(labelValue, labelIndex)
 
         if volumeNode.IsA("vtkMRMLDiffusionTensorVolumeNode"):
             point_idx = imageData.FindPoint(ijk[0], ijk[1], ijk[2])
@@ -169,27 +200,46 @@ class DataProbeInfoWidget:
             else:
                 operation = None
 
+            if self.calculateTensorScalars is None:
+                self.calculateTensorScalars = CalculateTensorScalars()
             value = self.calculateTensorScalars(tensor, operation=operation)
-            if value is not None:
-                valueString = ("%f" % value).rstrip("0").rstrip(".")
-                return f"{scalarVolumeDisplayNode.GetScalarInvariantAsString()} {valueString}"
-            else:
-                return scalarVolumeDisplayNode.GetScalarInvariantAsString()
+            return self.formatTensorString(scalarVolumeDisplayNode.GetScalarInvariantAsString(), value)
 
         # default - non label scalar volume
-        numberOfComponents = imageData.GetNumberOfScalarComponents()
-        if numberOfComponents > 4:
-            return _("{numberOfComponents} components").format(numberOfComponents=numberOfComponents)
-        for c in range(numberOfComponents):
-            component = imageData.GetScalarComponentAsDouble(ijk[0], ijk[1], ijk[2], c)
-            if component.is_integer():
-                component = int(component)
-            # format string according to suggestion here:
-            # https://stackoverflow.com/questions/2440692/formatting-floats-in-python-without-superfluous-zeros
-            # also set the default field width for each coordinate
-            componentString = ("%4f" % component).rstrip("0").rstrip(".")
-            pixel += "%s, " % componentString
-        return pixel[:-2]
+        return self.formatComponentsString(
+            imageData.GetNumberOfScalarComponents(),
+            lambda c: imageData.GetScalarComponentAsDouble(ijk[0], ijk[1], ijk[2], c))
+
+    def getProbedPixelString(self, sliceLayerLogic):
+        """Given a slice layer logic that has just probed its volume
+        (see vtkMRMLSliceLayerLogic::ProbeAtXY), create a human readable
+        string describing the contents. Same as getPixelString but the
+        voxel values are not read from Python.
+        """
+        volumeNode = sliceLayerLogic.GetVolumeNode()
+        probeStatus = sliceLayerLogic.GetProbeStatus()
+        if probeStatus == slicer.vtkMRMLSliceLayerLogic.ProbeNoVolume:
+            return _("No volume")
+        if probeStatus == slicer.vtkMRMLSliceLayerLogic.ProbeNoImage:
+            return _("No Image")
+        if probeStatus == slicer.vtkMRMLSliceLayerLogic.ProbeOutOfFrame:
+            return _("Out of Frame")
+        if probeStatus == slicer.vtkMRMLSliceLayerLogic.ProbeNoTensorData:
+            return _("No Tensor Data")
+
+        if volumeNode.IsA("vtkMRMLLabelMapVolumeNode"):
+            labelIndex = int(sliceLayerLogic.GetProbeValues().GetValue(0))
+            return self.formatLabelString(sliceLayerLogic.GetProbeLabelName(), labelIndex)
+
+        if volumeNode.IsA("vtkMRMLDiffusionTensorVolumeNode"):
+            scalarVolumeDisplayNode = volumeNode.GetScalarVolumeDisplayNode()
+            invariantName = scalarVolumeDisplayNode.GetScalarInvariantAsString() if scalarVolumeDisplayNode else ""
+            value = sliceLayerLogic.GetProbeTensorInvariant() if sliceLayerLogic.GetProbeTensorInvariantValid() else None
+            return self.formatTensorString(invariantName, value)
+
+        # default - non label scalar volume
+        probeValues = sliceLayerLogic.GetProbeValues()
+        return self.formatComponentsString(sliceLayerLogic.GetProbeNumberOfComponents(), probeValues.GetValue)
 
     def processEvent(self, observee, event):
         # TODO: use a timer to delay calculation and compress events
@@ -237,25 +287,17 @@ class DataProbeInfoWidget:
 
         self.viewInfo.text = self.generateViewDescription(xyz, ras, sliceNode, sliceLogic)
 
-        def _roundInt(value):
-            try:
-                return round(value)
-            except ValueError:
-                return 0
-
-        hasVolume = False
+        # Probe all layers and magnify the slice view around the position in a single call
+        showMagnifiedImage = (not slicer.mrmlScene.IsBatchProcessing()) and self.showImage
+        imageLabelSize = self.imageLabel.size
+        hasVolume = sliceLogic.ProbeLayersAtXY(
+            xyz, self.magnifiedImage if showMagnifiedImage else None, min(imageLabelSize.width(), imageLabelSize.height()), 10.0)
         layerLogicCalls = (("L", sliceLogic.GetLabelLayer),
                            ("F", sliceLogic.GetForegroundLayer),
                            ("B", sliceLogic.GetBackgroundLayer))
         for layer, logicCall in layerLogicCalls:
             layerLogic = logicCall()
-            volumeNode = layerLogic.GetVolumeNode()
-            ijk = [0, 0, 0]
-            if volumeNode:
-                hasVolume = True
-                xyToIJK = layerLogic.GetXYToIJKTransform()
-                ijkFloat = xyToIJK.TransformDoublePoint(xyz)
-                ijk = [_roundInt(value) for value in ijkFloat]
+            ijk = layerLogic.GetProbeIJK() if layerLogic.GetVolumeNode() else [0, 0, 0]
             self.layerNames[layer].setText(self.generateLayerName(layerLogic))
             self.layerIJKs[layer].setText(self.generateIJKPixelDescription(ijk, layerLogic))
             self.layerValues[layer].setText(self.generateIJKPixelValueDescription(ijk, layerLogic))
@@ -281,9 +323,8 @@ class DataProbeInfoWidget:
             self.displayableManagerInfo.hide()
 
         # set image
-        if (not slicer.mrmlScene.IsBatchProcessing()) and sliceLogic and hasVolume and self.showImage:
-            pixmap = self._createMagnifiedPixmap(
-                xyz, sliceLogic.GetBlend().GetOutputPort(), self.imageLabel.size, color)
+        if showMagnifiedImage and hasVolume:
+            pixmap = self._createMagnifiedPixmap(self.magnifiedImage, color)
             if pixmap:
                 self.imageLabel.setPixmap(pixmap)
                 self.onShowImage(self.showImage)
@@ -347,70 +388,31 @@ class DataProbeInfoWidget:
 
     def generateIJKPixelValueDescription(self, ijk, slicerLayerLogic):
         volumeNode = slicerLayerLogic.GetVolumeNode()
-        return "<b>%s</b>" % self.getPixelString(volumeNode, ijk) if volumeNode else ""
+        if not volumeNode:
+            return ""
+        if (slicerLayerLogic.GetProbeStatus() != slicer.vtkMRMLSliceLayerLogic.ProbeNoVolume
+                and list(slicerLayerLogic.GetProbeIJK()) == list(ijk)):
+            # The layer logic has already probed the volume at this position
+            return "<b>%s</b>" % self.getProbedPixelString(slicerLayerLogic)
+        return "<b>%s</b>" % self.getPixelString(volumeNode, ijk)
+
+    def _createMagnifiedPixmap(self, magnifiedImage, crosshairColor):
+        if magnifiedImage.GetNumberOfPoints() == 0:
+            return None
+        qImage = qt.QImage()
+        slicer.qMRMLUtils().vtkImageDataToQImage(magnifiedImage, qImage)
+        imagePixmap = qt.QPixmap.fromImage(qImage)
 
-    def _createMagnifiedPixmap(self, xyz, inputImageDataConnection, outputSize, crosshairColor, imageZoom=10):
-        # Use existing instance of objects to avoid instantiating one at each event.
-        imageCrop = self.imageCrop
+        # draw crosshair
         painter = self.painter
-        pen = self.pen
-
-        def _roundInt(value):
-            try:
-                return round(value)
-            except ValueError:
-                return 0
-
-        imageCrop.SetInputConnection(inputImageDataConnection)
-        xyzInt = [0, 0, 0]
-        xyzInt = [_roundInt(value) for value in xyz]
-        producer = inputImageDataConnection.GetProducer()
-        dims = producer.GetOutput().GetDimensions()
-        minDim = min(dims[0], dims[1])
-        imageSize = _roundInt(minDim / imageZoom / 2.0)
-        imin = xyzInt[0] - imageSize
-        imax = xyzInt[0] + imageSize
-        jmin = xyzInt[1] - imageSize
-        jmax = xyzInt[1] + imageSize
-        imin_trunc = max(0, imin)
-        imax_trunc = min(dims[0] - 1, imax)
-        jmin_trunc = max(0, jmin)
-        jmax_trunc = min(dims[1] - 1, jmax)
-        # The extra complexity of the canvas is used here to maintain a fixed size
-        # output due to the imageCrop returning a smaller image if the limits are
-        # outside the input image bounds. Specially useful when zooming at the borders.
-        canvas = self.canvas
-        canvas.SetScalarType(producer.GetOutput().GetScalarType())
-        canvas.SetNumberOfScalarComponents(producer.GetOutput().GetNumberOfScalarComponents())
-        canvas.SetExtent(imin, imax, jmin, jmax, 0, 0)
-        canvas.FillBox(imin, imax, jmin, jmax)
-        canvas.Update()
-        if (imin_trunc <= imax_trunc) and (jmin_trunc <= jmax_trunc):
-            imageCrop.SetVOI(imin_trunc, imax_trunc, jmin_trunc, jmax_trunc, 0, 0)
-            imageCrop.Update()
-            vtkImageCropped = imageCrop.GetOutput()
-            xyzBounds = [0] * 6
-            vtkImageCropped.GetBounds(xyzBounds)
-            xyzBounds = [_roundInt(value) for value in xyzBounds]
-            canvas.DrawImage(xyzBounds[0], xyzBounds[2], vtkImageCropped)
-            canvas.Update()
-            vtkImageFromCanvas = canvas.GetOutput()
-            if vtkImageFromCanvas:
-                qImage = qt.QImage()
-                slicer.qMRMLUtils().vtkImageDataToQImage(vtkImageFromCanvas, qImage)
-                imagePixmap = qt.QPixmap.fromImage(qImage)
-                imagePixmap = imagePixmap.scaled(outputSize, qt.Qt.KeepAspectRatio, qt.Qt.FastTransformation)
-
-                # draw crosshair
-                painter.begin(imagePixmap)
-                pen = qt.QPen()
-                pen.setColor(crosshairColor)
-                painter.setPen(pen)
-                painter.drawLine(0, int(imagePixmap.height() / 2), imagePixmap.width(), int(imagePixmap.height() / 2))
-                painter.drawLine(int(imagePixmap.width() / 2), 0, int(imagePixmap.width() / 2), imagePixmap.height())
-                painter.end()
-                return imagePixmap
-        return None
+        painter.begin(imagePixmap)
+        pen = qt.QPen()
+        pen.setColor(crosshairColor)
+        painter.setPen(pen)
+        painter.drawLine(0, int(imagePixmap.height() / 2), imagePixmap.width(), int(imagePixmap.height() / 2))
+        painter.drawLine(int(imagePixmap.width() / 2), 0, int(imagePixmap.width() / 2), imagePixmap.height())
+        painter.end()
+        return imagePixmap
 
     def _createSmall(self):
         """Make the internals of the widget to display in the
@@ -31,7 +31,7 @@ Requires segment labelmap representation.
 Scalar volume statistics (SV): voxel count, volume mm3, volume cm3 (where segments overlap scalar volume),
 min, max, mean, stdev (intensity statistics).
 Requires segment labelmap representation and selection of a scalar volume
-Closed surface statistics (CS): surface mm2, volume mm3, volume cm3 (computed from closed surface).
+Closed surface statistics (CS): surface mm2, volume mm3, volume cm3 (computed from closed surface), computation time.
 Requires segment closed surface representation.
 """)
         self.parent.helpText += parent.defaultDocumentationLink
@@ -456,11 +456,18 @@ class SegmentStatisticsLogic(ScriptedLoadableModuleLogic):
             if visibleSegmentIds.GetNumberOfValues() == 0:
                 logging.debug("computeStatistics will not return any results: there are no visible segments")
 
+            # compute measurements of all segments at once where plugins support it
+            segmentIDs = [visibleSegmentIds.GetValue(segmentIndex) for segmentIndex in range(visibleSegmentIds.GetNumberOfValues())]
+            for plugin in self.plugins:
+                if self.getParameterNode().GetParameter(plugin.__class__.__name__ + ".enabled") == "True":
+                    plugin.prepareStatistics(segmentIDs)
+
             # update statistics for all segment IDs
-            for segmentIndex in range(visibleSegmentIds.GetNumberOfValues()):
-                segmentID = visibleSegmentIds.GetValue(segmentIndex)
+            for segmentID in segmentIDs:
                 self.updateStatisticsForSegment(segmentID)
         finally:
+            for plugin in self.plugins:
+                plugin.prepareStatistics([])
             if transformedSegmentationNode is not None:
                 # We made a copy and hardened the segmentation transform
                 self.getParameterNode().SetParameter("Segmentation", segmentationNode.GetID())
@@ -815,6 +822,25 @@ class SegmentStatisticsTest(ScriptedLoadableModuleTest):
         self.assertEqual(segStatLogic.getStatistics()["Test_2", "LabelmapSegmentStatisticsPlugin.voxel_count"], 9807)
         self.assertEqual(segStatLogic.getStatistics()["Test_4", "ScalarVolumeSegmentStatisticsPlugin.voxel_count"], 380)
 
+        self.delayDisplay("Check median")
+        # Median is interpolated from the segment histogram by default
+        scalarVolumePlugin = [plugin for plugin in segStatLogic.plugins if plugin.__class__.__name__ == "ScalarVolumeSegmentStatisticsPlugin"][0]
+        stencil = scalarVolumePlugin.getStencilForVolume(segmentationNode, "Test_4", sourceVolumeNode)
+        histogram = vtk.vtkImageHistogramStatistics()
+        histogram.SetInputData(sourceVolumeNode.GetImageData())
+        histogram.SetStencilData(stencil.GetOutput())
+        histogram.Update()
+        self.assertAlmostEqual(segStatLogic.getStatistics()["Test_4", "ScalarVolumeSegmentStatisticsPlugin.median"], histogram.GetMedian())
+        # Nearest-rank median is one of the voxel values of the segment
+        segStatLogic.getParameterNode().SetParameter("ScalarVolumeSegmentStatisticsPlugin.nearestRankPercentiles", str(True))
+        segStatLogic.computeStatistics()
+        nearestRankMedian = segStatLogic.getStatistics()["Test_4", "ScalarVolumeSegmentStatisticsPlugin.median"]
+        self.assertEqual(nearestRankMedian, round(nearestRankMedian))
+        self.assertTrue(segStatLogic.getStatistics()["Test_4", "ScalarVolumeSegmentStatisticsPlugin.min"] <= nearestRankMedian
+                        <= segStatLogic.getStatistics()["Test_4", "ScalarVolumeSegmentStatisticsPlugin.max"])
+        segStatLogic.getParameterNode().SetParameter("ScalarVolumeSegmentStatisticsPlugin.nearestRankPercentiles", str(False))
+        segStatLogic.computeStatistics()
+
         self.delayDisplay("Export results to table")
         resultsTableNode = slicer.vtkMRMLTableNode()
         slicer.mrmlScene.AddNode(resultsTableNode)
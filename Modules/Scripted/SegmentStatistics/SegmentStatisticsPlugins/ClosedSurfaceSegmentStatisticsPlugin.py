@@ -1,4 +1,3 @@
-import vtk
 import slicer
 from slicer.i18n import tr as _
 from SegmentStatisticsPlugins import SegmentStatisticsPluginBase
@@ -11,9 +10,35 @@ class ClosedSurfaceSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         super().__init__()
         self.name = "Closed Surface"
         self.title = _("Closed Surface")
-        self.keys = ["surface_mm2", "volume_mm3", "volume_cm3"]
-        self.defaultKeys = self.keys  # calculate all measurements by default
+        self.defaultKeys = ["surface_mm2", "volume_mm3", "volume_cm3"]
+        self.keys = self.defaultKeys + ["computation_time_s"]
         # ... developer may add extra options to configure other parameters
+        # Statistics are kept between computations so that unchanged surfaces are not processed again
+        self.surfaceStatistics = None
+        self.surfaceStatisticsSegmentationNodeID = None
+        self.surfaceStatisticsComputed = False
+
+    def prepareStatistics(self, segmentIDs):
+        """Compute surface area and volume of all segments at once, on multiple threads"""
+        self.surfaceStatisticsComputed = False
+        if not segmentIDs:
+            return
+        segmentationNode = slicer.mrmlScene.GetNodeByID(self.getParameterNode().GetParameter("Segmentation"))
+        if segmentationNode:
+            self.computeSurfaceStatistics(segmentationNode, segmentIDs)
+            self.surfaceStatisticsComputed = True
+
+    def computeSurfaceStatistics(self, segmentationNode, segmentIDs):
+        import vtkSegmentationCorePython as vtkSegmentationCore
+
+        if self.surfaceStatistics is None or self.surfaceStatisticsSegmentationNodeID != segmentationNode.GetID():
+            self.surfaceStatistics = vtkSegmentationCore.vtkSegmentationSurfaceStatistics()
+            self.surfaceStatisticsSegmentationNodeID = segmentationNode.GetID()
+        self.surfaceStatistics.SetSegmentation(segmentationNode.GetSegmentation())
+        self.surfaceStatistics.RemoveAllSegmentIDs()
+        for segmentID in segmentIDs:
+            self.surfaceStatistics.AddSegmentID(segmentID)
+        self.surfaceStatistics.Compute()
 
     def computeStatistics(self, segmentID):
         import vtkSegmentationCorePython as vtkSegmentationCore
@@ -30,22 +55,22 @@ class ClosedSurfaceSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         if not containsClosedSurfaceRepresentation:
             return {}
 
-        segmentClosedSurface = vtk.vtkPolyData()
-        segmentationNode.GetClosedSurfaceRepresentation(segmentID, segmentClosedSurface)
-
-        # Compute statistics
-        massProperties = vtk.vtkMassProperties()
-        massProperties.SetInputData(segmentClosedSurface)
+        if not self.surfaceStatisticsComputed or not self.surfaceStatistics.HasSurfaceStatistics(segmentID):
+            self.computeSurfaceStatistics(segmentationNode, [segmentID])
+        if not self.surfaceStatistics.HasSurfaceStatistics(segmentID):
+            return {}
 
         # Add data to statistics list
         ccPerCubicMM = 0.001
         stats = {}
         if "surface_mm2" in requestedKeys:
-            stats["surface_mm2"] = massProperties.GetSurfaceArea()
+            stats["surface_mm2"] = self.surfaceStatistics.GetSurfaceAreaMm2(segmentID)
         if "volume_mm3" in requestedKeys:
-            stats["volume_mm3"] = massProperties.GetVolume()
+            stats["volume_mm3"] = self.surfaceStatistics.GetVolumeMm3(segmentID)
         if "volume_cm3" in requestedKeys:
-            stats["volume_cm3"] = massProperties.GetVolume() * ccPerCubicMM
+            stats["volume_cm3"] = self.surfaceStatistics.GetVolumeMm3(segmentID) * ccPerCubicMM
+        if "computation_time_s" in requestedKeys:
+            stats["computation_time_s"] = self.surfaceStatistics.GetComputationTimeSec(segmentID)
         return stats
 
     def getMeasurementInfo(self, key):
@@ -77,4 +102,11 @@ class ClosedSurfaceSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
                                        quantityDicomCode=self.createCodedEntry("118565006", "SCT", "Volume", True),
                                        unitsDicomCode=self.createCodedEntry("cm3", "UCUM", "cubic centimeter", True))
 
+        elif key == "computation_time_s":
+            return self.createMeasurementInfo(name="Computation time s",
+                                       title=_("Computation time"),
+                                       description=_("Time spent on computing surface statistics of the segment. Zero if the surface has not changed since the last computation."),
+                                       units=_("s"),
+                                       unitsDicomCode=self.createCodedEntry("s", "UCUM", "second", True))
+
         return None
@@ -4,7 +4,6 @@ from slicer.i18n import tr as _
 import vtkITK
 import logging
 from SegmentStatisticsPlugins import SegmentStatisticsPluginBase
-from functools import reduce
 
 
 class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
@@ -43,6 +42,26 @@ class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
             "principal_axis_z": "PrincipalAxisZ",
         }
         # ... developer may add extra options to configure other parameters
+        self.segmentationStatistics = None
+
+    def prepareStatistics(self, segmentIDs):
+        """Compute voxel count and volume of all segments in a single pass over each labelmap layer"""
+        self.segmentationStatistics = None
+        if not segmentIDs:
+            return
+        segmentationNode = slicer.mrmlScene.GetNodeByID(self.getParameterNode().GetParameter("Segmentation"))
+        if segmentationNode:
+            self.segmentationStatistics = self.computeSegmentationStatistics(segmentationNode, segmentIDs)
+
+    def computeSegmentationStatistics(self, segmentationNode, segmentIDs):
+        import vtkSegmentationCorePython as vtkSegmentationCore
+
+        segmentationStatistics = vtkSegmentationCore.vtkSegmentationStatistics()
+        segmentationStatistics.SetSegmentation(segmentationNode.GetSegmentation())
+        for segmentID in segmentIDs:
+            segmentationStatistics.AddSegmentID(segmentID)
+        segmentationStatistics.Compute()
+        return segmentationStatistics
 
     def computeStatistics(self, segmentID):
         import vtkSegmentationCorePython as vtkSegmentationCore
@@ -59,46 +78,22 @@ class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         if not containsLabelmapRepresentation:
             return {}
 
-        segmentLabelmap = slicer.vtkOrientedImageData()
-        segmentationNode.GetBinaryLabelmapRepresentation(segmentID, segmentLabelmap)
-        if (not segmentLabelmap
-            or not segmentLabelmap.GetPointData()
-                or not segmentLabelmap.GetPointData().GetScalars()):
+        segmentationStatistics = self.segmentationStatistics
+        if segmentationStatistics is None or not segmentationStatistics.HasLabelmapStatistics(segmentID):
+            segmentationStatistics = self.computeSegmentationStatistics(segmentationNode, [segmentID])
+        if not segmentationStatistics.HasLabelmapStatistics(segmentID):
             # No input label data
             return {}
 
-        # We need to know exactly the value of the segment voxels, apply threshold to make force the selected label value
-        labelValue = 1
-        backgroundValue = 0
-        thresh = vtk.vtkImageThreshold()
-        thresh.SetInputData(segmentLabelmap)
-        thresh.ThresholdByLower(0)
-        thresh.SetInValue(backgroundValue)
-        thresh.SetOutValue(labelValue)
-        thresh.SetOutputScalarType(vtk.VTK_UNSIGNED_CHAR)
-        thresh.Update()
-
-        #  Use binary labelmap as a stencil
-        stencil = vtk.vtkImageToImageStencil()
-        stencil.SetInputData(thresh.GetOutput())
-        stencil.ThresholdByUpper(labelValue)
-        stencil.Update()
-
-        stat = vtk.vtkImageAccumulate()
-        stat.SetInputData(thresh.GetOutput())
-        stat.SetStencilData(stencil.GetOutput())
-        stat.Update()
-
         # Add data to statistics list
-        cubicMMPerVoxel = reduce(lambda x, y: x * y, segmentLabelmap.GetSpacing())
         ccPerCubicMM = 0.001
         stats = {}
         if "voxel_count" in requestedKeys:
-            stats["voxel_count"] = stat.GetVoxelCount()
+            stats["voxel_count"] = segmentationStatistics.GetVoxelCount(segmentID)
         if "volume_mm3" in requestedKeys:
-            stats["volume_mm3"] = stat.GetVoxelCount() * cubicMMPerVoxel
+            stats["volume_mm3"] = segmentationStatistics.GetVolumeMm3(segmentID)
         if "volume_cm3" in requestedKeys:
-            stats["volume_cm3"] = stat.GetVoxelCount() * cubicMMPerVoxel * ccPerCubicMM
+            stats["volume_cm3"] = segmentationStatistics.GetVolumeMm3(segmentID) * ccPerCubicMM
 
         calculateShapeStats = False
         for shapeKey in self.shapeKeys:
@@ -107,6 +102,24 @@ class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
                 break
 
         if calculateShapeStats:
+            segmentLabelmap = slicer.vtkOrientedImageData()
+            segmentationNode.GetBinaryLabelmapRepresentation(segmentID, segmentLabelmap)
+            if (not segmentLabelmap
+                or not segmentLabelmap.GetPointData()
+                    or not segmentLabelmap.GetPointData().GetScalars()):
+                return stats
+
+            # We need to know exactly the value of the segment voxels, apply threshold to make force the selected label value
+            labelValue = 1
+            backgroundValue = 0
+            thresh = vtk.vtkImageThreshold()
+            thresh.SetInputData(segmentLabelmap)
+            thresh.ThresholdByLower(0)
+            thresh.SetInValue(backgroundValue)
+            thresh.SetOutValue(labelValue)
+            thresh.SetOutputScalarType(vtk.VTK_UNSIGNED_CHAR)
+            thresh.Update()
+
             directions = vtk.vtkMatrix4x4()
             segmentLabelmap.GetDirectionMatrix(directions)
 
@@ -1,7 +1,6 @@
 import vtk, slicer
 from slicer.i18n import tr as _
 from SegmentStatisticsPlugins import SegmentStatisticsPluginBase
-from functools import reduce
 
 
 class ScalarVolumeSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
@@ -21,6 +20,74 @@ class ScalarVolumeSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
             "percentile_05", "percentile_95", "median",
         ]
         # ... developer may add extra options to configure other parameters
+        self.segmentationStatistics = None
+
+    def setDefaultParameters(self, parameterNode, overwriteExisting=False):
+        super().setDefaultParameters(parameterNode, overwriteExisting)
+        # Median and percentiles are interpolated from the histogram of each segment by default.
+        # If nearestRankPercentiles is enabled then they are computed for all segments at once, as the
+        # smallest voxel value that is greater than or equal to the requested percent of voxel values,
+        # which is faster for many segments but may differ from the interpolated values.
+        parameter = self.__class__.__name__ + ".nearestRankPercentiles"
+        if not parameterNode.GetParameter(parameter) or overwriteExisting:
+            parameterNode.SetParameter(parameter, str(False))
+
+    def useNearestRankPercentiles(self):
+        parameterNode = self.getParameterNode()
+        return parameterNode is not None and parameterNode.GetParameter(self.__class__.__name__ + ".nearestRankPercentiles") == "True"
+
+    def prepareStatistics(self, segmentIDs):
+        """Compute voxel value statistics of all segments in a single pass over the scalar volume"""
+        self.segmentationStatistics = None
+        if not segmentIDs:
+            return
+        segmentationNode = slicer.mrmlScene.GetNodeByID(self.getParameterNode().GetParameter("Segmentation"))
+        grayscaleNode = slicer.mrmlScene.GetNodeByID(self.getParameterNode().GetParameter("ScalarVolume"))
+        self.segmentationStatistics = self.computeSegmentationStatistics(segmentationNode, segmentIDs, grayscaleNode)
+
+    def computeSegmentationStatistics(self, segmentationNode, segmentIDs, grayscaleNode):
+        import vtkSegmentationCorePython as vtkSegmentationCore
+
+        if not segmentationNode:
+            return None
+
+        containsLabelmapRepresentation = segmentationNode.GetSegmentation().ContainsRepresentation(
+            vtkSegmentationCore.vtkSegmentationConverter.GetSegmentationBinaryLabelmapRepresentationName())
+        if not containsLabelmapRepresentation:
+            return None
+
+        if (not grayscaleNode
+            or not grayscaleNode.GetImageData()
+            or not grayscaleNode.GetImageData().GetPointData()
+            or not grayscaleNode.GetImageData().GetPointData().GetScalars()):
+            # Input grayscale node does not contain valid image data
+            return None
+
+        # Grayscale volume as oriented image data in reference node coordinate system
+        grayscaleImage_Reference = vtkSegmentationCore.vtkOrientedImageData()
+        grayscaleImage_Reference.ShallowCopy(grayscaleNode.GetImageData())
+        ijkToRasMatrix = vtk.vtkMatrix4x4()
+        grayscaleNode.GetIJKToRASMatrix(ijkToRasMatrix)
+        grayscaleImage_Reference.SetGeometryFromImageToWorldMatrix(ijkToRasMatrix)
+
+        # Get transform between grayscale volume and segmentation
+        segmentationToReferenceGeometryTransform = None
+        if segmentationNode.GetParentTransformNode() != grayscaleNode.GetParentTransformNode():
+            segmentationToReferenceGeometryTransform = vtk.vtkGeneralTransform()
+            slicer.vtkMRMLTransformNode.GetTransformBetweenNodes(segmentationNode.GetParentTransformNode(),
+                                                                 grayscaleNode.GetParentTransformNode(), segmentationToReferenceGeometryTransform)
+
+        requestedKeys = self.getRequestedKeys()
+        segmentationStatistics = vtkSegmentationCore.vtkSegmentationStatistics()
+        segmentationStatistics.SetSegmentation(segmentationNode.GetSegmentation())
+        for segmentID in segmentIDs:
+            segmentationStatistics.AddSegmentID(segmentID)
+        segmentationStatistics.SetScalarVolume(grayscaleImage_Reference)
+        segmentationStatistics.SetSegmentationToScalarVolumeTransform(segmentationToReferenceGeometryTransform)
+        segmentationStatistics.SetComputeScalarPercentiles(self.useNearestRankPercentiles() and (
+            "median" in requestedKeys or any(key.startswith("percentile_") for key in requestedKeys)))
+        segmentationStatistics.Compute()
+        return segmentationStatistics
 
     def computeStatistics(self, segmentID):
         requestedKeys = self.getRequestedKeys()
@@ -31,57 +98,75 @@ class ScalarVolumeSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         if len(requestedKeys) == 0:
             return {}
 
-        stencil = self.getStencilForVolume(segmentationNode, segmentID, grayscaleNode)
-        if not stencil:
+        segmentationStatistics = self.segmentationStatistics
+        if segmentationStatistics is None or not segmentationStatistics.HasScalarStatistics(segmentID):
+            segmentationStatistics = self.computeSegmentationStatistics(segmentationNode, [segmentID], grayscaleNode)
+        if segmentationStatistics is None or not segmentationStatistics.HasScalarStatistics(segmentID):
             return {}
 
-        cubicMMPerVoxel = reduce(lambda x, y: x * y, grayscaleNode.GetSpacing())
+        voxelCount = segmentationStatistics.GetScalarVoxelCount(segmentID)
         ccPerCubicMM = 0.001
 
-        stat = vtk.vtkImageAccumulate()
-        stat.SetInputData(grayscaleNode.GetImageData())
-        stat.SetStencilData(stencil.GetOutput())
-        stat.Update()
-
-        histogram = vtk.vtkImageHistogramStatistics()
-        histogram.SetInputData(grayscaleNode.GetImageData())
-        histogram.SetStencilData(stencil.GetOutput())
-        histogram.SetAutoRangePercentiles(5, 95)
-        histogram.SetAutoRangeExpansionFactors(0, 0)  # compute exact percentiles (do not add margin)
-        histogram.Update()
-
         # create statistics list
         stats = {}
         if "voxel_count" in requestedKeys:
-            stats["voxel_count"] = stat.GetVoxelCount()
+            stats["voxel_count"] = voxelCount
         if "volume_mm3" in requestedKeys:
-            stats["volume_mm3"] = stat.GetVoxelCount() * cubicMMPerVoxel
+            stats["volume_mm3"] = segmentationStatistics.GetScalarVolumeMm3(segmentID)
         if "volume_cm3" in requestedKeys:
-            stats["volume_cm3"] = stat.GetVoxelCount() * cubicMMPerVoxel * ccPerCubicMM
-        if stat.GetVoxelCount() > 0:
+            stats["volume_cm3"] = segmentationStatistics.GetScalarVolumeMm3(segmentID) * ccPerCubicMM
+        if voxelCount > 0:
             if "min" in requestedKeys:
-                stats["min"] = stat.GetMin()[0]
+                stats["min"] = segmentationStatistics.GetScalarMinimum(segmentID)
             if "max" in requestedKeys:
-                stats["max"] = stat.GetMax()[0]
+                stats["max"] = segmentationStatistics.GetScalarMaximum(segmentID)
             if "mean" in requestedKeys:
-                stats["mean"] = stat.GetMean()[0]
+                stats["mean"] = segmentationStatistics.GetScalarMean(segmentID)
             if "stdev" in requestedKeys:
-                stats["stdev"] = stat.GetStandardDeviation()[0]
-            if "median" in requestedKeys:
-                stats["median"] = histogram.GetMedian()
-            if "percentile_05" or "percentile_95" in requestedKeys:
-                # percentiles for 5 and 95 are already computed
-                if "percentile_05" in requestedKeys:
-                    stats["percentile_05"] = histogram.GetAutoRange()[0]
-                if "percentile_95" in requestedKeys:
-                    stats["percentile_95"] = histogram.GetAutoRange()[1]
-            if "percentile_10" or "percentile_90" in requestedKeys:
-                histogram.SetAutoRangePercentiles(10, 90)
-                histogram.Update()
-                if "percentile_10" in requestedKeys:
-                    stats["percentile_10"] = histogram.GetAutoRange()[0]
-                if "percentile_90" in requestedKeys:
-                    stats["percentile_90"] = histogram.GetAutoRange()[1]
+                stats["stdev"] = segmentationStatistics.GetScalarStandardDeviation(segmentID)
+            if self.useNearestRankPercentiles():
+                if "median" in requestedKeys:
+                    stats["median"] = segmentationStatistics.GetScalarMedian(segmentID)
+                for percent in [5, 10, 90, 95]:
+                    key = "percentile_%02d" % percent
+                    if key in requestedKeys:
+                        stats[key] = segmentationStatistics.GetScalarPercentile(segmentID, percent)
+            else:
+                stats.update(self.computeHistogramPercentiles(segmentationNode, segmentID, grayscaleNode, requestedKeys))
+        return stats
+
+    def computeHistogramPercentiles(self, segmentationNode, segmentID, grayscaleNode, requestedKeys):
+        """Compute median and percentiles of a segment, interpolated from its histogram"""
+        percentileKeys = [key for key in ["median", "percentile_05", "percentile_10", "percentile_90", "percentile_95"] if key in requestedKeys]
+        if not percentileKeys:
+            return {}
+
+        stencil = self.getStencilForVolume(segmentationNode, segmentID, grayscaleNode)
+        if not stencil:
+            return {}
+
+        histogram = vtk.vtkImageHistogramStatistics()
+        histogram.SetInputData(grayscaleNode.GetImageData())
+        histogram.SetStencilData(stencil.GetOutput())
+        histogram.SetAutoRangePercentiles(5, 95)
+        histogram.SetAutoRangeExpansionFactors(0, 0)  # compute exact percentiles (do not add margin)
+        histogram.Update()
+
+        stats = {}
+        if "median" in percentileKeys:
+            stats["median"] = histogram.GetMedian()
+        # percentiles for 5 and 95 are already computed
+        if "percentile_05" in percentileKeys:
+            stats["percentile_05"] = histogram.GetAutoRange()[0]
+        if "percentile_95" in percentileKeys:
+            stats["percentile_95"] = histogram.GetAutoRange()[1]
+        if "percentile_10" in percentileKeys or "percentile_90" in percentileKeys:
+            histogram.SetAutoRangePercentiles(10, 90)
+            histogram.Update()
+            if "percentile_10" in percentileKeys:
+                stats["percentile_10"] = histogram.GetAutoRange()[0]
+            if "percentile_90" in percentileKeys:
+                stats["percentile_90"] = histogram.GetAutoRange()[1]
         return stats
 
     def getStencilForVolume(self, segmentationNode, segmentID, grayscaleNode):
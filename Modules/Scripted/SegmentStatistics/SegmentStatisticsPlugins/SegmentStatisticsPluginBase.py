@@ -67,6 +67,13 @@ class SegmentStatisticsPluginBase:
         if self.parameterNode and self.parameterNodeObserver:
             self.parameterNode.RemoveObserver(self.parameterNodeObserver)
 
+    def prepareStatistics(self, segmentIDs):
+        """Called before computeStatistics() is called for each of the given segments.
+        Plugins may compute measurements of all segments at once here and return them from computeStatistics().
+        Called with an empty list when the computation is completed.
+        """
+        pass
+
     def computeStatistics(self, segmentID):
         """Compute measurements for requested keys on the given segment and return
         as dictionary mapping key's to measurement results